@@ -2842,15 +2842,12 @@ def normalise_img_pxl_vals_py(
                 "stch_cuml_upp must be greater than 0 and less than 1."
             )
 
-        low_band_percent = calc_band_percentile(
-            input_img, stch_cuml_low, no_data_val=in_no_data_val
-        )
-        upp_band_percent = calc_band_percentile(
-            input_img, stch_cuml_upp, no_data_val=in_no_data_val
+        band_percents = calc_band_percentile(
+            input_img, [stch_cuml_low, stch_cuml_upp], no_data_val=in_no_data_val
         )
 
         stch_min_max_vals = list()
-        for b_low, b_upp in zip(low_band_percent, upp_band_percent):
+        for b_low, b_upp in band_percents:
             stch_min_max_vals.append({"min": b_low, "max": b_upp})
 
     elif norm_type == rsgislib.IMG_STRETCH_LINEAR:
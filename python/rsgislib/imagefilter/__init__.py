@@ -23,6 +23,7 @@ class FilterParameters:
         stddev_x=None,
         stddev_y=None,
         angle=None,
+        percentile=None,
     ):
         self.filter_type = filter_type
         self.file_ending = file_ending
@@ -33,6 +34,7 @@ class FilterParameters:
         self.stddev_x = stddev_x
         self.stddev_y = stddev_y
         self.angle = angle
+        self.percentile = percentile
 
 
 def apply_median_filter(input_img, output_img, filter_size, gdalformat, datatype):
@@ -66,6 +68,47 @@ def apply_median_filter(input_img, output_img, filter_size, gdalformat, datatype
     apply_filters(input_img, outputImageBase, filters, gdalformat, outExt, datatype)
 
 
+def apply_percentile_filter(
+    input_img, output_img, filter_size, percentile, gdalformat, datatype
+):
+    """
+    Apply a percentile filter to the specified input image. The nearest-rank
+    percentile of the valid values within the window is outputted, so a
+    percentile of 50 is the same as the median filter.
+
+    :param input_img: string specifying the input image to be filtered.
+    :param output_img: string specifying the output image file..
+    :param filter_size: int specifying the size of the image filter
+                        (must be an odd number, i.e., 3, 5, 7, etc).
+    :param percentile: float specifying the percentile (0-100) to be calculated.
+    :param gdalformat: string specifying the output image format (e.g., KEA).
+    :param datatype: Specifying the output image pixel data type
+                     (e.g., rsgislib.TYPE_32FLOAT).
+
+    .. code:: python
+
+        import rsgislib
+        from rsgislib import imagefilter
+        input_img = 'jers1palsar_stack.kea'
+        outImgFile = 'jers1palsar_stack_pct90_5.kea'
+        imagefilter.apply_percentile_filter(input_img, outImgFile, 5, 90, "KEA",
+                                          rsgislib.TYPE_32FLOAT)
+
+    """
+    outputImageBase, outExt = os.path.splitext(output_img)
+    outExt = outExt.replace(".", "").strip()
+    filters = []
+    filters.append(
+        FilterParameters(
+            filter_type="Percentile",
+            file_ending="",
+            size=filter_size,
+            percentile=percentile,
+        )
+    )
+    apply_filters(input_img, outputImageBase, filters, gdalformat, outExt, datatype)
+
+
 def apply_mean_filter(input_img, output_img, filter_size, gdalformat, datatype):
     """
     Apply a mean filter to the specified input image.
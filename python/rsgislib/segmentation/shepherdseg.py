@@ -84,6 +84,7 @@ def run_shepherd_segmentation(
     img_stretch_stats="",
     kmeans_centres="",
     img_stats_json_file="",
+    n_threads=1,
 ):
     """
     Utility function to call the segmentation algorithm of Shepherd et al. (2019).
@@ -132,6 +133,8 @@ def run_shepherd_segmentation(
                                 file storing the image spatial extent and
                                 img_stretch_stats and kmeans_centres file paths
                                 for use by other commands (Output).
+    :param n_threads: the number of threads used for the KMeans clustering
+                      (default = 1).
 
     .. code:: python
 
@@ -264,6 +267,7 @@ def run_shepherd_segmentation(
         True,
         0.0025,
         rsgislib.imagecalc.INITCLUSTER_DIAGONAL_FULL_ATTACH,
+        n_threads=n_threads,
     )
 
     # Apply KMEANS
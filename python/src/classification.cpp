@@ -75,6 +75,7 @@ static PyObject *Classification_CollapseClasses(PyObject *self, PyObject *args,
     
     try
     {
+        RSGISPyReleaseGIL releaseGIL;
         rsgis::cmds::executeCollapseRAT2Class(std::string(pszInputImage), std::string(pszOutputFile),
                                               std::string(pszGDALFormat), std::string(pszClassesColumn),
                                               classIntColStr, classIntColPresent);
@@ -100,6 +101,7 @@ static PyObject *Classification_Colour3Bands(PyObject *self, PyObject *args, PyO
     
     try
     {
+        RSGISPyReleaseGIL releaseGIL;
         rsgis::cmds::executeGenerate3BandFromColourTable(std::string(pszInputImage), std::string(pszOutputFile),
                                                          std::string(pszGDALFormat));
     }
@@ -133,6 +135,7 @@ static PyObject *Classification_GenRandomAccuracyPts(PyObject *self, PyObject *a
     
     try
     {
+        RSGISPyReleaseGIL releaseGIL;
         rsgis::cmds::executeGenerateRandomAccuracyPts(std::string(pszInputImage), std::string(pszOutputVecFile),
                                                       std::string(pszOutputVecLyr), std::string(pszFormat),
                                                       std::string(pszClassImgCol), std::string(pszClassImgVecCol),
@@ -154,27 +157,29 @@ static PyObject *Classification_GenStratifiedRandomAccuracyPts(PyObject *self, P
                              RSGIS_PY_C_TEXT("rat_class_col"), RSGIS_PY_C_TEXT("vec_class_col"),
                              RSGIS_PY_C_TEXT("vec_ref_col"), RSGIS_PY_C_TEXT("num_pts"),
                              RSGIS_PY_C_TEXT("seed"), RSGIS_PY_C_TEXT("del_exist_vec"),
-                             RSGIS_PY_C_TEXT("use_pxl_lst"), nullptr};
+                             RSGIS_PY_C_TEXT("use_pxl_lst"), RSGIS_PY_C_TEXT("n_threads"), nullptr};
     const char *pszInputImage, *pszOutputVecFile, *pszOutputVecLyr, *pszFormat, *pszClassImgCol, *pszClassImgVecCol, *pszClassRefVecCol;
     int numPts;
     int del_exist_vec = false;
     int seed = 10;
     int usePxlLst = false;
+    unsigned int numThreads = 1;
     
-    if( !PyArg_ParseTupleAndKeywords(args, keywds, "sssssssi|iii:generate_stratified_random_accuracy_pts", kwlist, &pszInputImage,
+    if( !PyArg_ParseTupleAndKeywords(args, keywds, "sssssssi|iiiI:generate_stratified_random_accuracy_pts", kwlist, &pszInputImage,
                                      &pszOutputVecFile, &pszOutputVecLyr, &pszFormat, &pszClassImgCol, &pszClassImgVecCol,
-                                     &pszClassRefVecCol, &numPts, &seed, &del_exist_vec, &usePxlLst))
+                                     &pszClassRefVecCol, &numPts, &seed, &del_exist_vec, &usePxlLst, &numThreads))
     {
         return nullptr;
     }
     
     try
     {
+        RSGISPyReleaseGIL releaseGIL;
         rsgis::cmds::executeGenerateStratifiedRandomAccuracyPts(std::string(pszInputImage), std::string(pszOutputVecFile),
                                                                 std::string(pszOutputVecLyr), std::string(pszFormat),
                                                                 std::string(pszClassImgCol), std::string(pszClassImgVecCol),
                                                                 std::string(pszClassRefVecCol), numPts, seed, del_exist_vec,
-                                                                usePxlLst);
+                                                                usePxlLst, numThreads);
     }
     catch(rsgis::cmds::RSGISCmdException &e)
     {
@@ -192,26 +197,29 @@ static PyObject *Classification_GenStratifiedPropRandomAccuracyPts(PyObject *sel
                              RSGIS_PY_C_TEXT("rat_class_col"), RSGIS_PY_C_TEXT("vec_class_col"),
                              RSGIS_PY_C_TEXT("vec_ref_col"), RSGIS_PY_C_TEXT("num_pts"),
                              RSGIS_PY_C_TEXT("min_num_pts"),
-                             RSGIS_PY_C_TEXT("seed"), RSGIS_PY_C_TEXT("del_exist_vec"), nullptr};
+                             RSGIS_PY_C_TEXT("seed"), RSGIS_PY_C_TEXT("del_exist_vec"),
+                             RSGIS_PY_C_TEXT("n_threads"), nullptr};
     const char *pszInputImage, *pszOutputVecFile, *pszOutputVecLyr, *pszFormat, *pszClassImgCol, *pszClassImgVecCol, *pszClassRefVecCol;
     int numPts, minNumPts;
     int del_exist_vec = false;
     int seed = 10;
+    unsigned int numThreads = 1;
 
-    if( !PyArg_ParseTupleAndKeywords(args, keywds, "sssssssii|ii:generate_stratified_prop_random_accuracy_pts", kwlist, &pszInputImage,
+    if( !PyArg_ParseTupleAndKeywords(args, keywds, "sssssssii|iiI:generate_stratified_prop_random_accuracy_pts", kwlist, &pszInputImage,
                                      &pszOutputVecFile, &pszOutputVecLyr, &pszFormat, &pszClassImgCol, &pszClassImgVecCol,
-                                     &pszClassRefVecCol, &numPts, &minNumPts, &seed, &del_exist_vec))
+                                     &pszClassRefVecCol, &numPts, &minNumPts, &seed, &del_exist_vec, &numThreads))
     {
         return nullptr;
     }
 
     try
     {
+        RSGISPyReleaseGIL releaseGIL;
         rsgis::cmds::executeGenerateStratifiedPropRandomAccuracyPts(std::string(pszInputImage), std::string(pszOutputVecFile),
                                                                 std::string(pszOutputVecLyr), std::string(pszFormat),
                                                                 std::string(pszClassImgCol), std::string(pszClassImgVecCol),
                                                                 std::string(pszClassRefVecCol), numPts, minNumPts,
-                                                                seed, del_exist_vec);
+                                                                seed, del_exist_vec, numThreads);
     }
     catch(rsgis::cmds::RSGISCmdException &e)
     {
@@ -257,6 +265,7 @@ static PyObject *Classification_PopClassInfoAccuracyPts(PyObject *self, PyObject
     
     try
     {
+        RSGISPyReleaseGIL releaseGIL;
         rsgis::cmds::executePopClassInfoAccuracyPts(std::string(pszInputImage), std::string(pszVecFile),
                                                     std::string(pszVecLyr), std::string(pszClassImgCol),
                                                     std::string(pszClassImgVecCol),
@@ -313,7 +322,7 @@ static PyMethodDef ClassificationMethods[] = {
 },
 
 {"generate_stratified_random_accuracy_pts", (PyCFunction)Classification_GenStratifiedRandomAccuracyPts, METH_VARARGS | METH_KEYWORDS,
-"rsgislib.classification.generate_stratified_random_accuracy_pts(input_img:str, out_vec_file:str, out_vec_lyr:str, out_format:str, rat_class_col:str, vec_class_col:str, vec_ref_col:str, num_pts:int, seed:int, del_exist_vec:bool, use_pxl_lst:bool)\n"
+"rsgislib.classification.generate_stratified_random_accuracy_pts(input_img:str, out_vec_file:str, out_vec_lyr:str, out_format:str, rat_class_col:str, vec_class_col:str, vec_ref_col:str, num_pts:int, seed:int, del_exist_vec:bool, use_pxl_lst:bool, n_threads:int)\n"
 "Generates a set of stratified random points for accuracy assessment.\n"
 "\n"
 ":param input_img: is a string containing the name and path of the input image with attribute table.\n"
@@ -326,11 +335,12 @@ static PyMethodDef ClassificationMethods[] = {
 ":param num_pts: is an int specifying the number of points for each class which should be created.\n"
 ":param seed: is an int specifying the seed for the random number generator. (Optional: Default 10)\n"
 ":param del_exist_vec: is a bool, specifying whether to force removal of the output vector if it exists. (Optional: Default False)\n"
-":param use_pxl_lst: is a bool, if there are only a small number of pixels then creating a list of all the pixel locations will speed up processing. (Optional: Default False)\n"
+":param use_pxl_lst: is a bool, if True the points are sampled in a single pass through the image, keeping a random sample of num_pts pixels for each class, rather than by testing random pixel locations. This is much faster when some classes only cover a small part of the image. (Optional: Default False)\n"
+":param n_threads: is the number of threads used to sample the image when use_pxl_lst is True. The points only depend on the seed, not the number of threads. (Optional: Default 1)\n"
 },
 
 {"generate_stratified_prop_random_accuracy_pts", (PyCFunction)Classification_GenStratifiedPropRandomAccuracyPts, METH_VARARGS | METH_KEYWORDS,
-"rsgislib.classification.generate_stratified_prop_random_accuracy_pts(input_img:str, out_vec_file:str, out_vec_lyr:str, out_format:str, rat_class_col:str, vec_class_col:str, vec_ref_col:str, num_pts:int, min_num_pts:int, seed:int, del_exist_vec:bool)\n"
+"rsgislib.classification.generate_stratified_prop_random_accuracy_pts(input_img:str, out_vec_file:str, out_vec_lyr:str, out_format:str, rat_class_col:str, vec_class_col:str, vec_ref_col:str, num_pts:int, min_num_pts:int, seed:int, del_exist_vec:bool, n_threads:int)\n"
 "Generates a set of stratified random points for accuracy assessment with the number of\n"
 " point per class proportional to the area mapped."
 "\n"
@@ -345,7 +355,7 @@ static PyMethodDef ClassificationMethods[] = {
 ":param min_num_pts: is the minimum number of points to be created for each class.\n"
 ":param seed: is an int specifying the seed for the random number generator. (Optional: Default 10)\n"
 ":param del_exist_vec: is a bool, specifying whether to force removal of the output vector if it exists. (Optional: Default False)\n"
-":param use_pxl_lst: is a bool, if there are only a small number of pixels then creating a list of all the pixel locations will speed up processing. (Optional: Default False)\n"
+":param n_threads: is the number of threads used to sample the image. The points only depend on the seed, not the number of threads. (Optional: Default 1)\n"
 },
     
 {"pop_class_info_accuracy_pts", (PyCFunction)Classification_PopClassInfoAccuracyPts, METH_VARARGS | METH_KEYWORDS,
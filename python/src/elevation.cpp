@@ -50,6 +50,7 @@ static PyObject *Elevation_calcSlope(PyObject *self, PyObject *args, PyObject *k
 
     try
     {
+        RSGISPyReleaseGIL releaseGIL;
         rsgis::cmds::RSGISAngleMeasure outAngleUnit;
         std::string angUnit = std::string(pszOutUnit);
         if(angUnit == "degrees")
@@ -89,6 +90,7 @@ static PyObject *Elevation_calcSlopePxlResImg(PyObject *self, PyObject *args, Py
 
     try
     {
+        RSGISPyReleaseGIL releaseGIL;
         rsgis::cmds::RSGISAngleMeasure outAngleUnit;
         std::string angUnit = std::string(pszOutUnit);
         if(angUnit == "degrees")
@@ -125,6 +127,7 @@ static PyObject *Elevation_calcAspect(PyObject *self, PyObject *args, PyObject *
     
     try
     {
+        RSGISPyReleaseGIL releaseGIL;
         rsgis::cmds::executeCalcAspect(std::string(pszInputImage), std::string(pszOutputFile), std::string(pszGDALFormat));
     }
     catch(rsgis::cmds::RSGISCmdException &e)
@@ -146,6 +149,7 @@ static PyObject *Elevation_calcAspectPxlResImg(PyObject *self, PyObject *args, P
 
     try
     {
+        RSGISPyReleaseGIL releaseGIL;
         rsgis::cmds::executeCalcAspectImgPxlRes(std::string(pszInDEMImage), std::string(pszInPxlResImage), std::string(pszOutputFile), std::string(pszGDALFormat));
     }
     catch(rsgis::cmds::RSGISCmdException &e)
@@ -167,6 +171,7 @@ static PyObject *Elevation_catAspect(PyObject *self, PyObject *args, PyObject *k
     
     try
     {
+        RSGISPyReleaseGIL releaseGIL;
         rsgis::cmds::executeCatagoriseAspect(std::string(pszInputImage), std::string(pszOutputFile), std::string(pszGDALFormat));
     }
     catch(rsgis::cmds::RSGISCmdException &e)
@@ -190,6 +195,7 @@ static PyObject *Elevation_calcHillshade(PyObject *self, PyObject *args, PyObjec
     
     try
     {
+        RSGISPyReleaseGIL releaseGIL;
         rsgis::cmds::executeCalcHillshade(std::string(pszInputImage), std::string(pszOutputFile), azimuth, zenith, std::string(pszGDALFormat));
     }
     catch(rsgis::cmds::RSGISCmdException &e)
@@ -213,6 +219,7 @@ static PyObject *Elevation_calcHillshadePxlResImg(PyObject *self, PyObject *args
 
     try
     {
+        RSGISPyReleaseGIL releaseGIL;
         rsgis::cmds::executeCalcHillshadeImgPxlRes(std::string(pszInDEMImage), std::string(pszInPxlResImage), std::string(pszOutputFile), azimuth, zenith, std::string(pszGDALFormat));
     }
     catch(rsgis::cmds::RSGISCmdException &e)
@@ -236,6 +243,7 @@ static PyObject *Elevation_calcShadowMask(PyObject *self, PyObject *args, PyObje
     
     try
     {
+        RSGISPyReleaseGIL releaseGIL;
         rsgis::cmds::executeCalcShadowMask(std::string(pszInputImage), std::string(pszOutputFile), azimuth, zenith, maxHeight, std::string(pszGDALFormat));
     }
     catch(rsgis::cmds::RSGISCmdException &e)
@@ -259,6 +267,7 @@ static PyObject *Elevation_calcLocalIncidenceAngle(PyObject *self, PyObject *arg
     
     try
     {
+        RSGISPyReleaseGIL releaseGIL;
         rsgis::cmds::executeCalcLocalIncidenceAngle(std::string(pszInputImage), std::string(pszOutputFile), azimuth, zenith, std::string(pszGDALFormat));
     }
     catch(rsgis::cmds::RSGISCmdException &e)
@@ -282,6 +291,7 @@ static PyObject *Elevation_calcLocalExistanceAngle(PyObject *self, PyObject *arg
     
     try
     {
+        RSGISPyReleaseGIL releaseGIL;
         rsgis::cmds::executeCalcLocalExitanceAngle(std::string(pszInputImage), std::string(pszOutputFile), azimuth, zenith, std::string(pszGDALFormat));
     }
     catch(rsgis::cmds::RSGISCmdException &e)
@@ -306,6 +316,7 @@ static PyObject *Elevation_dtmAspectMedianFilter(PyObject *self, PyObject *args,
     
     try
     {
+        RSGISPyReleaseGIL releaseGIL;
         rsgis::cmds::executeDTMAspectMedianFilter(std::string(pszInputDTMImage), std::string(pszInputAspectImage), std::string(pszOutputFile), aspectRange, winHSize, std::string(pszGDALFormat));
     }
     catch(rsgis::cmds::RSGISCmdException &e)
@@ -328,6 +339,7 @@ static PyObject *Elevation_fillDEMSoilleGratin1994(PyObject *self, PyObject *arg
     
     try
     {
+        RSGISPyReleaseGIL releaseGIL;
         rsgis::cmds::executeDEMFillSoilleGratin1994(std::string(pszInputDTMImage), std::string(pszValidMaskImage), std::string(pszOutputFile), std::string(pszGDALFormat));
     }
     catch(rsgis::cmds::RSGISCmdException &e)
@@ -339,6 +351,44 @@ static PyObject *Elevation_fillDEMSoilleGratin1994(PyObject *self, PyObject *arg
     Py_RETURN_NONE;
 }
 
+static PyObject *Elevation_fillDEMPriorityFlood(PyObject *self, PyObject *args, PyObject *keywds)
+{
+    static char *kwlist[] = {RSGIS_PY_C_TEXT("in_dem_img"), RSGIS_PY_C_TEXT("output_img"),
+                             RSGIS_PY_C_TEXT("gdalformat"), RSGIS_PY_C_TEXT("in_vld_img"),
+                             RSGIS_PY_C_TEXT("epsilon"), RSGIS_PY_C_TEXT("tile_size"), nullptr};
+    const char *pszInputDTMImage, *pszOutputFile, *pszGDALFormat;
+    PyObject *pValidMaskImageObj = Py_None;
+    int epsilon = false;
+    unsigned int tileSize = 0;
+
+    if( !PyArg_ParseTupleAndKeywords(args, keywds, "sss|OiI:fill_dem_priority_flood", kwlist, &pszInputDTMImage, &pszOutputFile, &pszGDALFormat, &pValidMaskImageObj, &epsilon, &tileSize))
+        return nullptr;
+    
+    std::string validMaskImage = "";
+    if(pValidMaskImageObj != Py_None)
+    {
+        if(!RSGISPY_CHECK_STRING(pValidMaskImageObj))
+        {
+            PyErr_SetString(GETSTATE(self)->error, "in_vld_img must be a string or None.");
+            return nullptr;
+        }
+        validMaskImage = RSGISPY_STRING_EXTRACT(pValidMaskImageObj);
+    }
+    
+    try
+    {
+        RSGISPyReleaseGIL releaseGIL;
+        rsgis::cmds::executeDEMFillPriorityFlood(std::string(pszInputDTMImage), validMaskImage, std::string(pszOutputFile), std::string(pszGDALFormat), epsilon, tileSize);
+    }
+    catch(rsgis::cmds::RSGISCmdException &e)
+    {
+        PyErr_SetString(GETSTATE(self)->error, e.what());
+        return nullptr;
+    }
+    
+    Py_RETURN_NONE;
+}
+
 static PyObject *Elevation_planeFitDetreadDEM(PyObject *self, PyObject *args, PyObject *keywds)
 {
     static char *kwlist[] = {RSGIS_PY_C_TEXT("input_img"), RSGIS_PY_C_TEXT("output_img"),
@@ -351,6 +401,7 @@ static PyObject *Elevation_planeFitDetreadDEM(PyObject *self, PyObject *args, Py
     
     try
     {
+        RSGISPyReleaseGIL releaseGIL;
         rsgis::cmds::executePlaneFitDetreadDEM(std::string(pszInputDEMImage), std::string(pszOutputFile), std::string(pszGDALFormat), winSize);
     }
     catch(rsgis::cmds::RSGISCmdException &e)
@@ -511,6 +562,34 @@ static PyMethodDef ElevationMethods[] = {
 "\n"
 },
     
+{"fill_dem_priority_flood", (PyCFunction)Elevation_fillDEMPriorityFlood, METH_VARARGS | METH_KEYWORDS,
+"rsgislib.elevation.fill_dem_priority_flood(in_dem_img, output_img, gdalformat, in_vld_img=None, epsilon=False, tile_size=0)\n"
+"Fill the local minima (depressions) in a DEM using the Priority-Flood algorithm so every\n"
+"pixel drains to the edge of the image or to an invalid (no data or masked) pixel. This is\n"
+"faster than fill_dem_soille_gratin_1994, supports floating point DEMs and, using tile_size,\n"
+"DEMs which are too large to be held in memory.\n\n"
+"Barnes, R., Lehman, C., and Mulla, D. (2014). Priority-flood: An optimal depression-filling\n"
+"and watershed-labeling algorithm for digital elevation models. Computers & Geosciences. 62. 117-127.\n\n"
+"Barnes, R. (2016). Parallel priority-flood depression filling for trillion cell digital elevation\n"
+"models on desktops or clusters. Computers & Geosciences. 96. 56-68.\n"
+"\n"
+":param in_dem_img: is a string containing the name and path of the input DEM file.\n"
+":param output_img: is a string containing the name and path of the output file (Float32).\n"
+":param gdalformat: is a string with the output image format for the GDAL driver.\n"
+":param in_vld_img: is an optional string containing the name and path to a binary image specifying the valid data region (1 == valid). Pixels which are no data in the DEM are always invalid.\n"
+":param epsilon: if True the filled areas are given a small gradient (the smallest float increment per pixel) so they drain, otherwise they are flat. Only available when the whole DEM is processed in memory (tile_size=0).\n"
+":param tile_size: if 0 (default) the whole DEM is processed in memory, otherwise the DEM is processed in tiles of tile_size x tile_size pixels. The result is identical.\n"
+"\n"
+".. code:: python\n"
+"\n"
+"   import rsgislib.elevation\n"
+"   inputDEMImage = 'DEM.kea'\n"
+"   validMaskImage = 'ValidRegionMask.kea'\n"
+"   outFilledImage = 'DEM_filled.kea'\n"
+"   rsgislib.elevation.fill_dem_priority_flood(inputDEMImage, outFilledImage, 'KEA', in_vld_img=validMaskImage)\n"
+"\n"
+},
+    
 {"plane_fit_detreat_dem", (PyCFunction)Elevation_planeFitDetreadDEM, METH_VARARGS | METH_KEYWORDS,
 "rsgislib.elevation.plane_fit_detreat_dem(input_img, output_img, gdalformat, win_size)\n"
 "An algorithm to detread a DEM using local plane fitting. The winSize will define the scale\n"
@@ -42,13 +42,16 @@ static PyObject *ImageCalc_BandMath(PyObject *self, PyObject *args, PyObject *ke
 {
     static char *kwlist[] = {RSGIS_PY_C_TEXT("output_img"), RSGIS_PY_C_TEXT("exp"), RSGIS_PY_C_TEXT("gdalformat"),
                              RSGIS_PY_C_TEXT("datatype"), RSGIS_PY_C_TEXT("band_defs"), RSGIS_PY_C_TEXT("exp_band_name"),
-                             RSGIS_PY_C_TEXT("output_exists"), nullptr};
+                             RSGIS_PY_C_TEXT("output_exists"), RSGIS_PY_C_TEXT("n_threads"),
+                             RSGIS_PY_C_TEXT("bulk_eval"), nullptr};
     const char *pszOutputFile, *pszExpression, *pszGDALFormat;
     int nDataType;
     int bExpBandName = 0;
     int bOutputImgExists = 0;
+    unsigned int nThreads = 1;
+    int bBulkEval = 1;
     PyObject *pBandDefnObj;
-    if( !PyArg_ParseTupleAndKeywords(args, keywds, "sssiO|ii:band_math", kwlist, &pszOutputFile, &pszExpression, &pszGDALFormat, &nDataType, &pBandDefnObj, &bExpBandName, &bOutputImgExists))
+    if( !PyArg_ParseTupleAndKeywords(args, keywds, "sssiO|iiIi:band_math", kwlist, &pszOutputFile, &pszExpression, &pszGDALFormat, &nDataType, &pBandDefnObj, &bExpBandName, &bOutputImgExists, &nThreads, &bBulkEval))
     {
         return nullptr;
     }
@@ -111,10 +114,12 @@ static PyObject *ImageCalc_BandMath(PyObject *self, PyObject *args, PyObject *ke
 
     try
     {
+        RSGISPyReleaseGIL releaseGIL;
         rsgis::RSGISLibDataType type = (rsgis::RSGISLibDataType)nDataType;
         bool useExpAsbandName = (bool)bExpBandName;
         bool outputImgExists = (bool)bOutputImgExists;
-        rsgis::cmds::executeBandMaths(pRSGISStruct, nBandDefns, pszOutputFile, pszExpression, pszGDALFormat, type, useExpAsbandName, outputImgExists);
+        bool useBulkEval = (bool)bBulkEval;
+        rsgis::cmds::executeBandMaths(pRSGISStruct, nBandDefns, pszOutputFile, pszExpression, pszGDALFormat, type, useExpAsbandName, outputImgExists, nThreads, useBulkEval);
     }
     catch(rsgis::cmds::RSGISCmdException &e)
     {
@@ -131,22 +136,24 @@ static PyObject *ImageCalc_ImageMath(PyObject *self, PyObject *args, PyObject *k
 {
     static char *kwlist[] = {RSGIS_PY_C_TEXT("input_img"), RSGIS_PY_C_TEXT("output_img"), RSGIS_PY_C_TEXT("exp"),
                              RSGIS_PY_C_TEXT("gdalformat"), RSGIS_PY_C_TEXT("datatype"), RSGIS_PY_C_TEXT("exp_band_name"),
-                             RSGIS_PY_C_TEXT("output_exists"), nullptr};
+                             RSGIS_PY_C_TEXT("output_exists"), RSGIS_PY_C_TEXT("n_threads"), nullptr};
     const char *pszInputImage, *pszOutputFile, *pszExpression, *pszGDALFormat;
     int nDataType;
     int bExpBandName = 0;
     int bOutputImgExists = 0;
-    if( !PyArg_ParseTupleAndKeywords(args, keywds, "ssssi|ii:image_math", kwlist, &pszInputImage, &pszOutputFile, &pszExpression, &pszGDALFormat, &nDataType, &bExpBandName, &bOutputImgExists))
+    unsigned int nThreads = 1;
+    if( !PyArg_ParseTupleAndKeywords(args, keywds, "ssssi|iiI:image_math", kwlist, &pszInputImage, &pszOutputFile, &pszExpression, &pszGDALFormat, &nDataType, &bExpBandName, &bOutputImgExists, &nThreads))
     {
         return nullptr;
     }
     
     try
     {
+        RSGISPyReleaseGIL releaseGIL;
         rsgis::RSGISLibDataType type = (rsgis::RSGISLibDataType)nDataType;
         bool useExpAsbandName = (bool)bExpBandName;
         bool outputImgExists = (bool)bOutputImgExists;
-        rsgis::cmds::executeImageMaths(pszInputImage, pszOutputFile, pszExpression, pszGDALFormat, type, useExpAsbandName, outputImgExists);
+        rsgis::cmds::executeImageMaths(pszInputImage, pszOutputFile, pszExpression, pszGDALFormat, type, useExpAsbandName, outputImgExists, nThreads);
     }
     catch(rsgis::cmds::RSGISCmdException &e)
     {
@@ -161,22 +168,25 @@ static PyObject *ImageCalc_ImageBandMath(PyObject *self, PyObject *args, PyObjec
 {
     static char *kwlist[] = {RSGIS_PY_C_TEXT("input_img"), RSGIS_PY_C_TEXT("output_img"), RSGIS_PY_C_TEXT("exp"),
                              RSGIS_PY_C_TEXT("gdalformat"), RSGIS_PY_C_TEXT("datatype"),
-                             RSGIS_PY_C_TEXT("exp_band_name"), RSGIS_PY_C_TEXT("output_exists"), nullptr};
+                             RSGIS_PY_C_TEXT("exp_band_name"), RSGIS_PY_C_TEXT("output_exists"),
+                             RSGIS_PY_C_TEXT("n_threads"), nullptr};
     const char *pszInputImage, *pszOutputFile, *pszExpression, *pszGDALFormat;
     int nDataType;
     int bExpBandName = 0;
     int bOutputImgExists = 0;
-    if( !PyArg_ParseTupleAndKeywords(args, keywds, "ssssi|ii:image_band_math", kwlist, &pszInputImage, &pszOutputFile, &pszExpression, &pszGDALFormat, &nDataType, &bExpBandName, &bOutputImgExists))
+    unsigned int nThreads = 1;
+    if( !PyArg_ParseTupleAndKeywords(args, keywds, "ssssi|iiI:image_band_math", kwlist, &pszInputImage, &pszOutputFile, &pszExpression, &pszGDALFormat, &nDataType, &bExpBandName, &bOutputImgExists, &nThreads))
     {
         return nullptr;
     }
     
     try
     {
+        RSGISPyReleaseGIL releaseGIL;
         rsgis::RSGISLibDataType type = (rsgis::RSGISLibDataType)nDataType;
         bool useExpAsbandName = (bool)bExpBandName;
         bool outputImgExists = (bool)bOutputImgExists;
-        rsgis::cmds::executeImageBandMaths(pszInputImage, pszOutputFile, pszExpression, pszGDALFormat, type, useExpAsbandName, outputImgExists);
+        rsgis::cmds::executeImageBandMaths(pszInputImage, pszOutputFile, pszExpression, pszGDALFormat, type, useExpAsbandName, outputImgExists, nThreads);
     }
     catch(rsgis::cmds::RSGISCmdException &e)
     {
@@ -192,23 +202,26 @@ static PyObject *ImageCalc_KMeansClustering(PyObject *self, PyObject *args, PyOb
     static char *kwlist[] = {RSGIS_PY_C_TEXT("input_img"), RSGIS_PY_C_TEXT("out_file"),
                              RSGIS_PY_C_TEXT("n_clusters"), RSGIS_PY_C_TEXT("max_n_iters"),
                              RSGIS_PY_C_TEXT("sub_sample"), RSGIS_PY_C_TEXT("ignore_zeros"),
-                             RSGIS_PY_C_TEXT("degree_change"), RSGIS_PY_C_TEXT("init_cluster_method"), nullptr};
+                             RSGIS_PY_C_TEXT("degree_change"), RSGIS_PY_C_TEXT("init_cluster_method"),
+                             RSGIS_PY_C_TEXT("n_threads"), nullptr};
 
     const char *pszInputImage, *pszOutputFile;
     unsigned int nNumClusters, nMaxNumIterations, nSubSample;
     int nIgnoreZeros; // passed as a bool - seems the only way to pass into C
     float fDegreeOfChange;
     int nClusterMethod;
-    if( !PyArg_ParseTupleAndKeywords(args, keywds, "ssIIIifi:kmeans_clustering", kwlist, &pszInputImage, &pszOutputFile, &nNumClusters,
-                                &nMaxNumIterations, &nSubSample, &nIgnoreZeros, &fDegreeOfChange, &nClusterMethod ))
+    unsigned int numThreads = 1;
+    if( !PyArg_ParseTupleAndKeywords(args, keywds, "ssIIIifi|I:kmeans_clustering", kwlist, &pszInputImage, &pszOutputFile, &nNumClusters,
+                                &nMaxNumIterations, &nSubSample, &nIgnoreZeros, &fDegreeOfChange, &nClusterMethod, &numThreads ))
     {
         return nullptr;
     }
     
     try
     {
+        RSGISPyReleaseGIL releaseGIL;
         rsgis::cmds::executeKMeansClustering(pszInputImage, pszOutputFile, nNumClusters, nMaxNumIterations,
-                            nSubSample, nIgnoreZeros, fDegreeOfChange, (rsgis::cmds::RSGISInitClustererMethods)nClusterMethod);
+                            nSubSample, nIgnoreZeros, fDegreeOfChange, (rsgis::cmds::RSGISInitClustererMethods)nClusterMethod, numThreads);
         
     }
     catch(rsgis::cmds::RSGISCmdException &e)
@@ -228,26 +241,29 @@ static PyObject *ImageCalc_ISODataClustering(PyObject *self, PyObject *args, PyO
                              RSGIS_PY_C_TEXT("degree_change"), RSGIS_PY_C_TEXT("init_cluster_method"),
                              RSGIS_PY_C_TEXT("min_dist_clusters"), RSGIS_PY_C_TEXT("min_n_feats"),
                              RSGIS_PY_C_TEXT("max_std_dev"), RSGIS_PY_C_TEXT("min_n_clusters"),
-                             RSGIS_PY_C_TEXT("start_iter"), RSGIS_PY_C_TEXT("end_iter"), nullptr};
+                             RSGIS_PY_C_TEXT("start_iter"), RSGIS_PY_C_TEXT("end_iter"),
+                             RSGIS_PY_C_TEXT("n_threads"), nullptr};
     const char *pszInputImage, *pszOutputFile;
     unsigned int nNumClusters, nMaxNumIterations, nSubSample, minNumFeatures, minNumClusters;
     unsigned int startIteration, endIteration;
     int nIgnoreZeros; // passed as a bool - seems the only way to pass into C
     float fDegreeOfChange, fMinDistBetweenClusters, maxStdDev;
     int nClusterMethod;
-    if( !PyArg_ParseTupleAndKeywords(args, keywds, "ssIIIififIfIII:isodata_clustering", kwlist, &pszInputImage, &pszOutputFile, &nNumClusters,
+    unsigned int numThreads = 1;
+    if( !PyArg_ParseTupleAndKeywords(args, keywds, "ssIIIififIfIII|I:isodata_clustering", kwlist, &pszInputImage, &pszOutputFile, &nNumClusters,
                                 &nMaxNumIterations, &nSubSample, &nIgnoreZeros, &fDegreeOfChange, &nClusterMethod,
                                 &fMinDistBetweenClusters, &minNumFeatures, &maxStdDev, &minNumClusters,
-                                &startIteration, &endIteration ))
+                                &startIteration, &endIteration, &numThreads ))
     {
         return nullptr;
     }
 
     try
     {
+        RSGISPyReleaseGIL releaseGIL;
         rsgis::cmds::executeISODataClustering(pszInputImage, pszOutputFile, nNumClusters, nMaxNumIterations,
                             nSubSample, nIgnoreZeros, fDegreeOfChange, (rsgis::cmds::RSGISInitClustererMethods)nClusterMethod, fMinDistBetweenClusters,
-                            minNumFeatures, maxStdDev, minNumClusters, startIteration, endIteration);
+                            minNumFeatures, maxStdDev, minNumClusters, startIteration, endIteration, numThreads);
     }
     catch(rsgis::cmds::RSGISCmdException &e)
     {
@@ -276,6 +292,7 @@ static PyObject *ImageCalc_MahalanobisDistFilter(PyObject *self, PyObject *args,
 
     try
     {
+        RSGISPyReleaseGIL releaseGIL;
         rsgis::cmds::executeMahalanobisDistFilter(inputImage, outputImage, winSize, gdalFormat, type);
     }
     catch(rsgis::cmds::RSGISCmdException &e)
@@ -305,6 +322,7 @@ static PyObject *ImageCalc_MahalanobisDist2ImgFilter(PyObject *self, PyObject *a
 
     try
     {
+        RSGISPyReleaseGIL releaseGIL;
         rsgis::cmds::executeMahalanobisDist2ImgFilter(inputImage, outputImage, winSize, gdalFormat, type);
     }
     catch(rsgis::cmds::RSGISCmdException &e)
@@ -321,15 +339,16 @@ static PyObject *ImageCalc_ImagePixelColumnSummary(PyObject *self, PyObject *arg
     static char *kwlist[] = {RSGIS_PY_C_TEXT("input_img"), RSGIS_PY_C_TEXT("output_img"),
                              RSGIS_PY_C_TEXT("sum_stats"), RSGIS_PY_C_TEXT("gdalformat"),
                              RSGIS_PY_C_TEXT("datatype"), RSGIS_PY_C_TEXT("no_data_val"),
-                             RSGIS_PY_C_TEXT("use_no_data"), nullptr};
+                             RSGIS_PY_C_TEXT("use_no_data"), RSGIS_PY_C_TEXT("n_threads"), nullptr};
 
     const char *inputImage, *outputImage, *gdalFormat;
     unsigned int datatype;
     int useNoDataValue;
     float noDataValue;
     PyObject *summaryStats;
+    unsigned int numThreads = 1;
     
-    if(!PyArg_ParseTupleAndKeywords(args, keywds, "ssOsIfi:image_pixel_column_summary", kwlist, &inputImage, &outputImage, &summaryStats, &gdalFormat, &datatype, &noDataValue, &useNoDataValue))
+    if(!PyArg_ParseTupleAndKeywords(args, keywds, "ssOsIfi|I:image_pixel_column_summary", kwlist, &inputImage, &outputImage, &summaryStats, &gdalFormat, &datatype, &noDataValue, &useNoDataValue, &numThreads))
     {
         return nullptr;
     }
@@ -561,7 +580,8 @@ static PyObject *ImageCalc_ImagePixelColumnSummary(PyObject *self, PyObject *arg
 
     try
     {
-        rsgis::cmds::executeImagePixelColumnSummary(inputImage, outputImage, summary, gdalFormat, type, noDataValue, useNoDataValue);
+        RSGISPyReleaseGIL releaseGIL;
+        rsgis::cmds::executeImagePixelColumnSummary(inputImage, outputImage, summary, gdalFormat, type, noDataValue, useNoDataValue, numThreads);
     }
     catch (rsgis::cmds::RSGISCmdException &e)
     {
@@ -615,6 +635,7 @@ static PyObject *ImageCalc_ImagePixelLinearFit(PyObject *self, PyObject *args, P
 
     try
     {
+        RSGISPyReleaseGIL releaseGIL;
         rsgis::cmds::executeImagePixelLinearFit(inputImage, outputImage, gdalFormat, bandValues, noDataValue, useNoDataValue);
     }
     catch (rsgis::cmds::RSGISCmdException &e)
@@ -643,6 +664,7 @@ static PyObject *ImageCalc_PCA(PyObject *self, PyObject *args, PyObject *keywds)
     
     try
     {
+        RSGISPyReleaseGIL releaseGIL;
         rsgis::RSGISLibDataType type = (rsgis::RSGISLibDataType)datatype;
         rsgis::cmds::executePCA(std::string(inputImage), std::string(eigenVectors), std::string(outputImage), numComponents, std::string(gdalFormat), type);
     }
@@ -672,7 +694,11 @@ static PyObject *ImageCalc_CalculateRMSE(PyObject *self, PyObject *args, PyObjec
     PyObject *outVal = PyTuple_New(1);
     try
     {
-        double rmseVal = rsgis::cmds::executeCalculateRMSE(inputImageA, bandA, inputImageB, bandB);
+        double rmseVal = 0;
+        {
+            RSGISPyReleaseGIL releaseGIL;
+            rmseVal = rsgis::cmds::executeCalculateRMSE(inputImageA, bandA, inputImageB, bandB);
+        }
         if(PyTuple_SetItem(outVal, 0, Py_BuildValue("d", rmseVal)) == -1)
         {
             throw rsgis::cmds::RSGISCmdException("Failed to add \'RMSE\' value to the list...");
@@ -707,6 +733,7 @@ static PyObject *ImageCalc_AllBandsEqualTo(PyObject *self, PyObject *args, PyObj
 
     try
     {
+        RSGISPyReleaseGIL releaseGIL;
         rsgis::cmds::executeAllBandsEqualTo(inputImage, imgValue, outputTrueVal, outputFalseVal, outputImage, imageFormat, type);
     }
     catch (rsgis::cmds::RSGISCmdException &e)
@@ -738,6 +765,7 @@ static PyObject *ImageCalc_Histogram(PyObject *self, PyObject *args, PyObject *k
 
     try
     {
+        RSGISPyReleaseGIL releaseGIL;
         rsgis::cmds::executeHistogram(inputImage, imageMask, outputFile, imgBand, imgValue, binWidth, calcInMinMax, inMin, inMax);
     } catch (rsgis::cmds::RSGISCmdException &e) {
         PyErr_SetString(GETSTATE(self)->error, e.what());
@@ -770,7 +798,11 @@ static PyObject *ImageCalc_GetHistogram(PyObject *self, PyObject *args, PyObject
         unsigned int nBins = 0;
         double inMinVal = inMin;
         double inMaxVal = inMax;
-        unsigned int *bins = rsgis::cmds::executeGetHistogram(inputImage, imgBand, binWidth, &nBins, calcInMinMax, &inMinVal, &inMaxVal);
+        unsigned int *bins = nullptr;
+        {
+            RSGISPyReleaseGIL releaseGIL;
+            bins = rsgis::cmds::executeGetHistogram(inputImage, imgBand, binWidth, &nBins, calcInMinMax, &inMinVal, &inMaxVal);
+        }
         
         Py_ssize_t listLen = nBins;
         
@@ -819,35 +851,115 @@ static PyObject *ImageCalc_BandPercentile(PyObject *self, PyObject *args, PyObje
     static char *kwlist[] = {RSGIS_PY_C_TEXT("input_img"), RSGIS_PY_C_TEXT("percentile"),
                              RSGIS_PY_C_TEXT("no_data_val"), nullptr};
     const char *inputImage;
-    float percentile;
+    PyObject *percentileObj;
     PyObject *noDataValueObj;
 
-    if(!PyArg_ParseTupleAndKeywords(args, keywds, "sfO:calc_band_percentile", kwlist, &inputImage, &percentile, &noDataValueObj))
+    if(!PyArg_ParseTupleAndKeywords(args, keywds, "sOO:calc_band_percentile", kwlist, &inputImage, &percentileObj, &noDataValueObj))
     {
         return nullptr;
     }
     
+    // Any object which can be converted to a float is accepted as a
+    // percentile (e.g., numpy.float32) not just Python floats and ints.
+    bool percentileList = false;
+    std::vector<float> percentiles;
+    Py_ssize_t nPercentiles = -1;
+    if(PySequence_Check(percentileObj) && !PyUnicode_Check(percentileObj))
+    {
+        // A zero dimensional numpy array is a sequence without a length so
+        // is treated as a single value.
+        nPercentiles = PySequence_Size(percentileObj);
+        if(nPercentiles < 0)
+        {
+            PyErr_Clear();
+        }
+    }
+
+    if(nPercentiles < 0)
+    {
+        PyObject *pFloatPercentile = nullptr;
+        if(!PyUnicode_Check(percentileObj))
+        {
+            pFloatPercentile = PyNumber_Float(percentileObj);
+        }
+        if(pFloatPercentile == nullptr)
+        {
+            PyErr_Clear();
+            PyErr_SetString(GETSTATE(self)->error, "percentile must be a float or a list of floats.");
+            return nullptr;
+        }
+        percentiles.push_back(PyFloat_AsDouble(pFloatPercentile));
+        Py_DECREF(pFloatPercentile);
+    }
+    else
+    {
+        percentileList = true;
+        for(Py_ssize_t n = 0; n < nPercentiles; n++)
+        {
+            PyObject *o = PySequence_GetItem(percentileObj, n);
+            PyObject *pFloatVal = nullptr;
+            if((o != nullptr) && !PyUnicode_Check(o))
+            {
+                pFloatVal = PyNumber_Float(o);
+            }
+            Py_XDECREF(o);
+            if(pFloatVal == nullptr)
+            {
+                PyErr_Clear();
+                PyErr_SetString(GETSTATE(self)->error, "A percentile value was not a float.");
+                return nullptr;
+            }
+            percentiles.push_back(PyFloat_AsDouble(pFloatVal));
+            Py_DECREF(pFloatVal);
+        }
+    }
+    
     bool haveNoDataValue = false;
     float noDataValue = 0.0;
     if(noDataValueObj != Py_None)
     {
-        if(RSGISPY_CHECK_FLOAT(noDataValueObj) | RSGISPY_CHECK_INT(noDataValueObj))
+        PyObject *pFloatNoData = PyNumber_Float(noDataValueObj);
+        if(pFloatNoData == nullptr)
         {
-            noDataValue = RSGISPY_FLOAT_EXTRACT(noDataValueObj);
-            haveNoDataValue = true;
+            PyErr_Clear();
+            PyErr_SetString(GETSTATE(self)->error, "no_data_val must be None or a valid number.");
+            return nullptr;
         }
+        noDataValue = PyFloat_AsDouble(pFloatNoData);
+        haveNoDataValue = true;
+        Py_DECREF(pFloatNoData);
     }
     
     PyObject *outVals = nullptr;
     try
     {
-        std::vector<double> outPercentileVals = rsgis::cmds::executeBandPercentile(inputImage, percentile, noDataValue, haveNoDataValue);
+        std::vector< std::vector<double> > outPercentileVals;
+        {
+            RSGISPyReleaseGIL releaseGIL;
+            outPercentileVals = rsgis::cmds::executeBandPercentiles(inputImage, percentiles, noDataValue, haveNoDataValue);
+        }
         
         Py_ssize_t listLen = outPercentileVals.size();
         outVals = PyTuple_New(listLen);
         for(unsigned int i = 0; i < outPercentileVals.size(); ++i)
         {
-            if(PyTuple_SetItem(outVals, i, Py_BuildValue("d", outPercentileVals.at(i))) == -1)
+            PyObject *bandVal = nullptr;
+            if(percentileList)
+            {
+                bandVal = PyTuple_New(outPercentileVals.at(i).size());
+                for(unsigned int j = 0; j < outPercentileVals.at(i).size(); ++j)
+                {
+                    if(PyTuple_SetItem(bandVal, j, Py_BuildValue("d", outPercentileVals.at(i).at(j))) == -1)
+                    {
+                        throw rsgis::cmds::RSGISCmdException("Failed to add \'percentile\' value to the list...");
+                    }
+                }
+            }
+            else
+            {
+                bandVal = Py_BuildValue("d", outPercentileVals.at(i).at(0));
+            }
+            if(PyTuple_SetItem(outVals, i, bandVal) == -1)
             {
                 throw rsgis::cmds::RSGISCmdException("Failed to add \'percentile\' value to the list...");
             }
@@ -880,6 +992,7 @@ static PyObject *ImageCalc_CorrelationWindow(PyObject *self, PyObject *args, PyO
     rsgis::RSGISLibDataType type = (rsgis::RSGISLibDataType)datatype;
     try 
     {
+    RSGISPyReleaseGIL releaseGIL;
     rsgis::cmds::executeCorrelationWindow(pszInputImage, pszOutputImage, windowSize, bandA, bandB, pszGDALFormat, type);
     }
     catch (rsgis::cmds::RSGISCmdException &e)
@@ -931,7 +1044,10 @@ static PyObject *ImageCalc_GetImageStatsInEnv(PyObject *self, PyObject *args, Py
         stats->stddev = 0;
         stats->sum = 0;
         
-        rsgis::cmds::executeImageBandStatsEnv(std::string(inputImage), stats, imgBand, noDataValueSpecified, noDataValue, longMin, longMax, latMin, latMax);
+        {
+            RSGISPyReleaseGIL releaseGIL;
+            rsgis::cmds::executeImageBandStatsEnv(std::string(inputImage), stats, imgBand, noDataValueSpecified, noDataValue, longMin, longMax, latMin, latMax);
+        }
         
         
         if(PyTuple_SetItem(outValsList, 0, Py_BuildValue("d", stats->min)) == -1)
@@ -999,7 +1115,11 @@ static PyObject *ImageCalc_GetImageBandModeInEnv(PyObject *self, PyObject *args,
     PyObject *outVal = PyTuple_New(1);
     try
     {
-        float modeVal = rsgis::cmds::executeImageBandModeEnv(std::string(inputImage), binWidth, imgBand, noDataValueSpecified, noDataValue, longMin, longMax, latMin, latMax);
+        float modeVal = 0;
+        {
+            RSGISPyReleaseGIL releaseGIL;
+            modeVal = rsgis::cmds::executeImageBandModeEnv(std::string(inputImage), binWidth, imgBand, noDataValueSpecified, noDataValue, longMin, longMax, latMin, latMax);
+        }
         
         if(PyTuple_SetItem(outVal, 0, Py_BuildValue("f", modeVal)) == -1)
         {
@@ -1052,8 +1172,12 @@ static PyObject *ImageCalc_Get2DImageHistogram(PyObject *self, PyObject *args, P
         double binWidthImg1 = 0.0;
         double binWidthImg2 = 0.0;
         
-        double rSq = rsgis::cmds::executeImageComparison2dHisto(std::string(inputImage1), std::string(inputImage2), std::string(outputImage), std::string(gdalFormat), img1Band, img2Band, numBins, &binWidthImg1, &binWidthImg2, img1Min, img1Max, img2Min, img2Max, img1Scale, img2Scale, img1Off, img2Off, ((bool)normOutput));
-                
+        double rSq = 0;
+        {
+            RSGISPyReleaseGIL releaseGIL;
+            rSq = rsgis::cmds::executeImageComparison2dHisto(std::string(inputImage1), std::string(inputImage2), std::string(outputImage), std::string(gdalFormat), img1Band, img2Band, numBins, &binWidthImg1, &binWidthImg2, img1Min, img1Max, img2Min, img2Max, img1Scale, img2Scale, img1Off, img2Off, ((bool)normOutput));
+        }
+        
         if(PyTuple_SetItem(outVal, 0, Py_BuildValue("d", binWidthImg1)) == -1)
         {
             throw rsgis::cmds::RSGISCmdException("Failed to add \'binWidthImg1\' value to the list...");
@@ -1151,6 +1275,7 @@ static PyObject *ImageCalc_CalcMaskImgPxlValProb(PyObject *self, PyObject *args,
     
     try
     {
+        RSGISPyReleaseGIL releaseGIL;
         rsgis::cmds::executeCalcMaskImgPxlValProb(std::string(pszInputImage), inImgBandIdxs, std::string(pszMaskImage), maskImgVal, std::string(pszOutputImage), std::string(pszGDALFormat), histBinWidths, calcHistBinWidth, useImgNoData, rescaleProbs);
     }
     catch (rsgis::cmds::RSGISCmdException &e)
@@ -1244,6 +1369,7 @@ static PyObject *ImageCalc_CalcPropTrueExp(PyObject *self, PyObject *args, PyObj
     float prop = 0.0;
     try
     {
+        RSGISPyReleaseGIL releaseGIL;
         prop = rsgis::cmds::executeCalcPropTrueExp(pRSGISStruct, nBandDefns, std::string(pszExpression), inValidImage, useValidImg);
     }
     catch(rsgis::cmds::RSGISCmdException &e)
@@ -1347,6 +1473,7 @@ static PyObject *ImageCalc_calcMultiImgBandStats(PyObject *self, PyObject *args,
     
     try
     {
+        RSGISPyReleaseGIL releaseGIL;
         rsgis::cmds::calcMultiImgBandsStats(inputImages, std::string(outputImage), summaryStats, std::string(gdalFormat), (rsgis::RSGISLibDataType)datatype, (bool)useNoDataVal, noDataVal);
     }
     catch (rsgis::cmds::RSGISCmdException &e)
@@ -1375,6 +1502,7 @@ static PyObject *ImageCalc_CalcImageDifference(PyObject *self, PyObject *args, P
     
     try
     {
+        RSGISPyReleaseGIL releaseGIL;
         rsgis::RSGISLibDataType type = (rsgis::RSGISLibDataType)datatype;
         rsgis::cmds::calcImageDifference(std::string(inputImage1), std::string(inputImage2), std::string(outputImage), std::string(gdalFormat), type);
     }
@@ -1404,7 +1532,11 @@ static PyObject *ImageCalc_GetImageBandMinMax(PyObject *self, PyObject *args, Py
     PyObject *outList = PyTuple_New(2);
     try
     {
-        std::pair<double, double> outVals = rsgis::cmds::getImageBandMinMax(std::string(inputImage), imgBand, (bool)useNoDataVal, noDataVal);
+        std::pair<double, double> outVals;
+        {
+            RSGISPyReleaseGIL releaseGIL;
+            outVals = rsgis::cmds::getImageBandMinMax(std::string(inputImage), imgBand, (bool)useNoDataVal, noDataVal);
+        }
         
         if(PyTuple_SetItem(outList, 0, Py_BuildValue("d", outVals.first)) == -1)
         {
@@ -1472,6 +1604,7 @@ static PyObject *ImageCalc_CalcImageRescale(PyObject *self, PyObject *args, PyOb
     
     try
     {
+        RSGISPyReleaseGIL releaseGIL;
         rsgis::RSGISLibDataType type = (rsgis::RSGISLibDataType)datatype;
         rsgis::cmds::executeRescaleImages(input_imgs, std::string(outputImage), std::string(gdalFormat), type, cNoDataVal, cOffset, cGain, nNoDataVal, nOffset, nGain);
     }
@@ -1488,15 +1621,16 @@ static PyObject *ImageCalc_GetImgIdxForStat(PyObject *self, PyObject *args, PyOb
 {
     static char *kwlist[] = {RSGIS_PY_C_TEXT("input_imgs"), RSGIS_PY_C_TEXT("output_img"),
                              RSGIS_PY_C_TEXT("gdalformat"), RSGIS_PY_C_TEXT("no_data_val"),
-                             RSGIS_PY_C_TEXT("stat"), nullptr};
+                             RSGIS_PY_C_TEXT("stat"), RSGIS_PY_C_TEXT("n_threads"), nullptr};
     PyObject *pInputImages;
     const char *pszOutputImage = "";
     const char *pszGDALFormat = "";
     float noDataVal = 0.0;
     int statType;
+    unsigned int numThreads = 1;
 
     
-    if( !PyArg_ParseTupleAndKeywords(args, keywds, "Ossfi:get_img_idx_for_stat", kwlist, &pInputImages, &pszOutputImage, &pszGDALFormat, &noDataVal, &statType))
+    if( !PyArg_ParseTupleAndKeywords(args, keywds, "Ossfi|I:get_img_idx_for_stat", kwlist, &pInputImages, &pszOutputImage, &pszGDALFormat, &noDataVal, &statType, &numThreads))
     {
         return nullptr;
     }
@@ -1545,7 +1679,8 @@ static PyObject *ImageCalc_GetImgIdxForStat(PyObject *self, PyObject *args, PyOb
     
     try
     {
-        rsgis::cmds::executeGetImgIdxForStat(inputImages, std::string(pszOutputImage), std::string(pszGDALFormat), noDataVal, summaryStats);
+        RSGISPyReleaseGIL releaseGIL;
+        rsgis::cmds::executeGetImgIdxForStat(inputImages, std::string(pszOutputImage), std::string(pszGDALFormat), noDataVal, summaryStats, numThreads);
     }
     catch(rsgis::cmds::RSGISCmdException &e)
     {
@@ -1649,6 +1784,7 @@ static PyObject *ImageCalc_GetImgSumStatsInPxl(PyObject *self, PyObject *args, P
     
     try
     {
+        RSGISPyReleaseGIL releaseGIL;
         bool useNoData = (bool) useImgDataVal;
         rsgis::RSGISLibDataType type = (rsgis::RSGISLibDataType)datatype;
         rsgis::cmds::executeGetWithinPxlImgStatSummaries(std::string(pInputRefImage), std::string(pInputStatsImage), statsImgBand, std::string(pszOutputImage), std::string(pszGDALFormat), type, useNoData, cmdSumStats, xIOGrid, yIOGrid);
@@ -1718,6 +1854,7 @@ static PyObject *ImageCalc_IdentifyMinPxlValueInWin(PyObject *self, PyObject *ar
     
     try
     {
+        RSGISPyReleaseGIL releaseGIL;
         bool useNoData = (bool) useNoDataValue;
         rsgis::cmds::executeIdentifyMinPxlValueInWin(std::string(pInputImage), std::string(pszOutputImage), std::string(pszOutputRefImage), bandsVec, winSize, std::string(pszGDALFormat), noDataValue, useNoData);
     }
@@ -1781,6 +1918,7 @@ static PyObject *ImageCalc_CalcImgMeanInMask(PyObject *self, PyObject *args, PyO
     float meanVal = 0.0;
     try
     {
+        RSGISPyReleaseGIL releaseGIL;
         bool useNoData = (bool) useNoDataValue;
         meanVal = rsgis::cmds::executeCalcImgMeanInMask(std::string(pInputImage), std::string(pInputImageMsk), mskValue, bandsVec, noDataValue, useNoData);
     }
@@ -1797,7 +1935,7 @@ static PyObject *ImageCalc_CalcImgMeanInMask(PyObject *self, PyObject *args, PyO
 // Our list of functions in this module
 static PyMethodDef ImageCalcMethods[] = {
     {"band_math", (PyCFunction)ImageCalc_BandMath, METH_VARARGS | METH_KEYWORDS,
-"rsgislib.imagecalc.band_math(output_img:str, exp:str, gdalformat:str, datatype:int, band_defs:list, exp_band_name:bool, output_exists:bool)\n"
+"rsgislib.imagecalc.band_math(output_img:str, exp:str, gdalformat:str, datatype:int, band_defs:list, exp_band_name:bool, output_exists:bool, n_threads:int, bulk_eval:bool)\n"
 "Performs band math calculation.\n"
 "The syntax for the expression is from the `muparser library <https://beltoforion.de/en/muparser>`_ "
 "`see here for available operations and syntax <https://beltoforion.de/en/muparser/features.php>`_"
@@ -1808,7 +1946,9 @@ static PyMethodDef ImageCalcMethods[] = {
 ":param datatype: is an containing one of the values from rsgislib.TYPE_*\n"
 ":param band_defs: is a sequence of rsgislib.imagecalc.BandDefn objects that define the inputs\n"
 ":param exp_band_name: is an optional bool specifying whether the band name should be the expression (Default = False).\n"
-":param output_exists: is an optional bool specifying whether the output image already exists and it should be edited rather than overwritten (Default=False)."
+":param output_exists: is an optional bool specifying whether the output image already exists and it should be edited rather than overwritten (Default=False).\n"
+":param n_threads: is an optional int specifying the number of threads used to evaluate the expression (Default=1).\n"
+":param bulk_eval: is an optional bool specifying whether the expression is evaluated for a block of pixels with a single call to muparser rather than once per pixel, which is faster but can be disabled if the muparser library does not support bulk evaluation (Default=True)."
 "\n"
 "\n"
 ".. code:: python\n"
@@ -1831,7 +1971,7 @@ static PyMethodDef ImageCalcMethods[] = {
 "\n\n"},
 
 {"image_math", (PyCFunction)ImageCalc_ImageMath, METH_VARARGS | METH_KEYWORDS,
-"rsgislib.imagecalc.image_math(input_img, output_img, exp, gdalformat, datatype, exp_band_name, output_exists)\n"
+"rsgislib.imagecalc.image_math(input_img, output_img, exp, gdalformat, datatype, exp_band_name, output_exists, n_threads)\n"
 "Performs image math calculations. Produces an output image file with the same number of bands as the input image.\n"
 "This function applies the same calculation to each image band (i.e., b1 is the only variable).\n"
 "The syntax for the expression is from the `muparser library <https://beltoforion.de/en/muparser>`_ "
@@ -1843,7 +1983,8 @@ static PyMethodDef ImageCalcMethods[] = {
 ":param gdalformat: is a string containing the GDAL format for the output file - eg 'KEA'\n"
 ":param datatype: is an containing one of the values from rsgislib.TYPE_*\n"
 ":param exp_band_name: is an optional bool specifying whether the band name should be the expression (Default = False).\n"
-":param output_exists: is an optional bool specifying whether the output image already exists and it should be edited rather than overwritten (Default=False)."
+":param output_exists: is an optional bool specifying whether the output image already exists and it should be edited rather than overwritten (Default=False).\n"
+":param n_threads: is an optional int specifying the number of threads used to evaluate the expression (Default=1)."
 "\n"
 "\n"
 ".. code:: python\n"
@@ -1858,7 +1999,7 @@ static PyMethodDef ImageCalcMethods[] = {
 "\n"},
 
 {"image_band_math", (PyCFunction)ImageCalc_ImageBandMath, METH_VARARGS | METH_KEYWORDS,
-"rsgislib.imagecalc.image_band_math(input_img, output_img, exp, gdalformat, datatype, exp_band_name, output_exists)\n"
+"rsgislib.imagecalc.image_band_math(input_img, output_img, exp, gdalformat, datatype, exp_band_name, output_exists, n_threads)\n"
 "Performs image band math calculations. Produces a single output file with a single image band.\n"
 "The image bands can be referred to individually using b1, b2 ... bn. where n is the number of image bands, starting at 1.\n"
 "The syntax for the expression is from the `muparser library <https://beltoforion.de/en/muparser>`_ "
@@ -1870,7 +2011,8 @@ static PyMethodDef ImageCalcMethods[] = {
 ":param gdalformat: is a string containing the GDAL format for the output file - eg 'KEA'\n"
 ":param datatype: is an containing one of the values from rsgislib.TYPE_*\n"
 ":param exp_band_name: is an optional bool specifying whether the band name should be the expression (Default = False).\n"
-":param output_exists: is an optional bool specifying whether the output image already exists and it should be editted rather than overwritten (Default=False)."
+":param output_exists: is an optional bool specifying whether the output image already exists and it should be editted rather than overwritten (Default=False).\n"
+":param n_threads: is an optional int specifying the number of threads used to evaluate the expression (Default=1)."
 "\n"
 "\n"
 ".. code:: python\n"
@@ -1887,7 +2029,7 @@ static PyMethodDef ImageCalcMethods[] = {
 "\n"},
 
 {"kmeans_clustering", (PyCFunction)ImageCalc_KMeansClustering, METH_VARARGS | METH_KEYWORDS,
-"rsgislib.imagecalc.kmeans_clustering(input_img, out_file, n_clusters, max_n_iters, sub_sample, ignore_zeros, degree_change, init_cluster_method)\n"
+"rsgislib.imagecalc.kmeans_clustering(input_img, out_file, n_clusters, max_n_iters, sub_sample, ignore_zeros, degree_change, init_cluster_method, n_threads=1)\n"
 "Performs K Means Clustering and saves cluster centres to a text file.\n"
 "\n"
 ":param input_img: is a string providing the input image\n"
@@ -1898,6 +2040,7 @@ static PyMethodDef ImageCalcMethods[] = {
 ":param ignore_zeros: is a bool specifying if zeros in the image should be treated as no data.\n"
 ":param degree_change: is a float providing the minimum change between iterations before terminating.\n"
 ":param init_cluster_method: the method for initialising the clusters and is one of INITCLUSTER_* values\n"
+":param n_threads: is the number of threads used to assign the pixels to clusters and update the cluster centres (default = 1).\n"
 "\n"
 ".. code:: python\n"
 "\n"
@@ -1914,7 +2057,7 @@ static PyMethodDef ImageCalcMethods[] = {
 "\n"},
 
 {"isodata_clustering", (PyCFunction)ImageCalc_ISODataClustering, METH_VARARGS | METH_KEYWORDS,
-"rsgislib.imagecalc.isodata_clustering(input_img, out_file, n_clusters, max_n_iters, sub_sample, ignore_zeros, degree_change, init_cluster_method, min_dist_clusters, min_n_feats, max_std_dev, min_n_clusters, start_iter, end_iter)\n"
+"rsgislib.imagecalc.isodata_clustering(input_img, out_file, n_clusters, max_n_iters, sub_sample, ignore_zeros, degree_change, init_cluster_method, min_dist_clusters, min_n_feats, max_std_dev, min_n_clusters, start_iter, end_iter, n_threads=1)\n"
 "Performs ISO Data Clustering and saves cluster centres to a text file.\n"
 "\n"
 ":param input_img: is a string providing the input image\n"
@@ -1931,6 +2074,7 @@ static PyMethodDef ImageCalcMethods[] = {
 ":param min_n_clusters: is an int\n"
 ":param start_iter: is an int\n"
 ":param end_iter: is an int\n"
+":param n_threads: is the number of threads used to assign the pixels to clusters and update the cluster centres (default = 1).\n"
 "\n"
 ".. code:: python\n"
 "\n"
@@ -1966,7 +2110,7 @@ static PyMethodDef ImageCalcMethods[] = {
 },
 
 {"image_pixel_column_summary", (PyCFunction)ImageCalc_ImagePixelColumnSummary, METH_VARARGS | METH_KEYWORDS,
-"rsgislib.imagecalc.image_pixel_column_summary(input_img, output_img, sum_stats, gdalformat, datatype, no_data_val, use_no_data)\n"
+"rsgislib.imagecalc.image_pixel_column_summary(input_img, output_img, sum_stats, gdalformat, datatype, no_data_val, use_no_data, n_threads)\n"
 "Calculates summary statistics for a column of pixels.\n"
 "\n"
 ":param input_img: is a string containing the name of the input file\n"
@@ -1977,6 +2121,7 @@ static PyMethodDef ImageCalcMethods[] = {
 ":param datatype: is an int containing one of the values from rsgislib.TYPE_*\n"
 ":param no_data_val: is a float specifying what value is used to signify no data\n"
 ":param use_no_data: is a boolean specifying whether the noDataValue should be used\n"
+":param n_threads: is an optional int specifying the number of threads used to calculate the summaries (Default=1).\n"
 "\n"
 },
 
@@ -2087,13 +2232,16 @@ static PyMethodDef ImageCalcMethods[] = {
 
 {"calc_band_percentile", (PyCFunction)ImageCalc_BandPercentile, METH_VARARGS | METH_KEYWORDS,
 "rsgislib.imagecalc.calc_band_percentile(input_img, percentile, no_data_val)\n"
-"Calculates image band percentiles for the input image and results a list of values\n"
+"Calculates image band percentiles for the input image and results a list of values.\n"
+"The percentiles are calculated exactly from two passes through the image, without\n"
+"reading the whole band into memory, and all the bands and percentiles are calculated\n"
+"from the same two passes.\n"
 "\n"
 ":param input_img: is a string containing the name of the input image file\n"
-":param percentile: is a float between 0 -- 1 specifying the percentile to be calculated.\n"
+":param percentile: is a float between 0 -- 1 specifying the percentile to be calculated or a list of floats to calculate multiple percentiles. Any value which can be converted to a float (e.g., numpy.float32) is accepted.\n"
 ":param no_data_val: is a float specifying the value used to represent no data (used None when no value is to be specified).\n"
 "\n"
-":return: list of floats\n"
+":return: list of floats (one per band) or, if a list of percentiles was provided, a list (one per band) of lists of floats (one per percentile).\n"
 "\n"
 },
 
@@ -2329,7 +2477,7 @@ static PyMethodDef ImageCalcMethods[] = {
     
     
 {"get_img_idx_for_stat", (PyCFunction)ImageCalc_GetImgIdxForStat, METH_VARARGS | METH_KEYWORDS,
-"rsgislib.imagecalc.get_img_idx_for_stat(input_imgs=list, output_img=string, gdalformat=string, no_data_val=float, stat=rsgislib.SUMTYPE_)\n"
+"rsgislib.imagecalc.get_img_idx_for_stat(input_imgs=list, output_img=string, gdalformat=string, no_data_val=float, stat=rsgislib.SUMTYPE_, n_threads=int)\n"
 "A function which calculates the index (starting at 1) of the image in the list of input images which has the stat selected. \n"
 "The output image can be used within the rsgislib.imageutils.createMaxNDVICompositeImg function."
 "\n"
@@ -2338,6 +2486,7 @@ static PyMethodDef ImageCalcMethods[] = {
 ":param gdalformat: is a string with the GDAL output file format.\n"
 ":param no_data_val: is the no data value in the input images (all images have the same no data value).\n"
 ":param stat: is of type rsgislib.SUMTYPE_* and specifies how the index is calculated. Available options are: rsgislib.SUMTYPE_MEDIAN, rsgislib.SUMTYPE_MIN, rsgislib.SUMTYPE_MAX.\n"
+":param n_threads: is an optional int specifying the number of threads used to calculate the indexes (Default=1).\n"
 "\n"
 ".. code:: python\n"
 "\n"
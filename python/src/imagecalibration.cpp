@@ -171,6 +171,7 @@ static PyObject *ImageCalibration_landsat2Radiance(PyObject *self, PyObject *arg
     
     try
     {
+        RSGISPyReleaseGIL releaseGIL;
         rsgis::cmds::executeConvertLandsat2Radiance(pszOutputFile, pszGDALFormat, landsatRadGainOffs);
     }
     catch(rsgis::cmds::RSGISCmdException &e)
@@ -281,6 +282,7 @@ static PyObject *ImageCalibration_landsat2RadianceMultiAdd(PyObject *self, PyObj
     
     try
     {
+        RSGISPyReleaseGIL releaseGIL;
         rsgis::cmds::executeConvertLandsat2RadianceMultiAdd(pszOutputFile, pszGDALFormat, landsatRadGainOffs);
     }
     catch(rsgis::cmds::RSGISCmdException &e)
@@ -339,6 +341,7 @@ static PyObject *ImageCalibration_Radiance2TOARefl(PyObject *self, PyObject *arg
     
     try
     {
+        RSGISPyReleaseGIL releaseGIL;
         rsgis::RSGISLibDataType type = (rsgis::RSGISLibDataType)nDataType;
         rsgis::cmds::executeConvertRadiance2TOARefl(pszInputFile, pszOutputFile, pszGDALFormat, type, scaleFactor, 0, false, year, month, day, (solarZenith*(M_PI/180)), solarIrradiance, numSolarIrrVals);
     }
@@ -430,6 +433,7 @@ static PyObject *ImageCalibration_TOARefl2Radiance(PyObject *self, PyObject *arg
     
     try
     {
+        RSGISPyReleaseGIL releaseGIL;
         rsgis::RSGISLibDataType type = (rsgis::RSGISLibDataType)nDataType;
         rsgis::cmds::executeConvertTOARefl2Radiance(inputImgFiles, pszOutputFile, pszGDALFormat, type, scaleFactor, solarDistance, (solarZenith*(M_PI/180)), solarIrradiance, numSolarIrrVals);
     }
@@ -532,6 +536,7 @@ static PyObject *ImageCalibration_Apply6SCoefficentsSingleParam(PyObject *self,
     
     try
     {
+        RSGISPyReleaseGIL releaseGIL;
         rsgis::RSGISLibDataType type = (rsgis::RSGISLibDataType)nDataType;
         rsgis::cmds::executeRad2SREFSingle6sParams(pszInputFile, pszOutputFile, pszGDALFormat, type, scaleFactor, imageBands, aX, bX, cX, numValues, noDataVal, useNoDataVal);
     }
@@ -670,6 +675,7 @@ static PyObject *ImageCalibration_Apply6SCoefficentsElevLUTParam(PyObject *self,
         
     try
     {
+        RSGISPyReleaseGIL releaseGIL;
         rsgis::RSGISLibDataType type = (rsgis::RSGISLibDataType)nDataType;
         rsgis::cmds::executeRad2SREFElevLUT6sParams(std::string(pszInputRadFile), std::string(pszInputDEMFile), std::string(pszOutputFile), std::string(pszGDALFormat), type, scaleFactor, elevLUT, noDataVal, useNoDataVal);
     }
@@ -856,6 +862,7 @@ static PyObject *ImageCalibration_Apply6SCoefficentsElevAOTLUTParam(PyObject *se
     
     try
     {
+        RSGISPyReleaseGIL releaseGIL;
         rsgis::RSGISLibDataType type = (rsgis::RSGISLibDataType)nDataType;
         rsgis::cmds::executeRad2SREFElevAOTLUT6sParams(std::string(pszInputRadFile), std::string(pszInputDEMFile), std::string(pszInputAOTFile), std::string(pszOutputFile), std::string(pszGDALFormat), type, scaleFactor, elevAOTLUT, noDataVal, useNoDataVal);
     }
@@ -898,6 +905,7 @@ static PyObject *ImageCalibration_ApplySubtractOffsets(PyObject *self, PyObject
     
     try
     {
+        RSGISPyReleaseGIL releaseGIL;
         rsgis::RSGISLibDataType type = (rsgis::RSGISLibDataType)nDataType;
         rsgis::cmds::executeApplySubtractOffsets(std::string(pszInputFile), std::string(pszOutputFile), std::string(pszInputOffsetsFile), (bool)nonNegativeInt, std::string(pszGDALFormat), type, noDataVal, (bool)useNoDataValInt, darkObjReflVal);
     }
@@ -959,6 +967,7 @@ static PyObject *ImageCalibration_ApplySubtractSingleOffsets(PyObject *self, PyO
     
     try
     {
+        RSGISPyReleaseGIL releaseGIL;
         rsgis::RSGISLibDataType type = (rsgis::RSGISLibDataType)nDataType;
         rsgis::cmds::executeApplySubtractSingleOffsets(std::string(pszInputFile), std::string(pszOutputFile), imageOffsVals, (bool)nonNegativeInt, std::string(pszGDALFormat), type, noDataVal, (bool)useNoDataValInt, darkObjReflVal);
     }
@@ -1054,6 +1063,7 @@ static PyObject *ImageCalibration_SaturatedPixelsMask(PyObject *self, PyObject *
     
     try
     {
+        RSGISPyReleaseGIL releaseGIL;
         rsgis::cmds::executeGenerateSaturationMask(pszOutputFile, pszGDALFormat, satBandPxlInfo);
     }
     catch(rsgis::cmds::RSGISCmdException &e)
@@ -1152,6 +1162,7 @@ static PyObject *ImageCalibration_landsatThermalRad2Brightness(PyObject *self, P
     
     try
     {
+        RSGISPyReleaseGIL releaseGIL;
         rsgis::RSGISLibDataType type = (rsgis::RSGISLibDataType)nDataType;
         rsgis::cmds::executeLandsatThermalRad2ThermalBrightness(std::string(pszInputFile), std::string(pszOutputFile), std::string(pszGDALFormat), type, scaleFactor, thermBandPxlInfo);
     }
@@ -1249,6 +1260,7 @@ static PyObject *ImageCalibration_worldview2ToRadiance(PyObject *self, PyObject
     
     try
     {
+        RSGISPyReleaseGIL releaseGIL;
         rsgis::cmds::executeConvertWorldView2ToRadiance(std::string(pszInputFile), std::string(pszOutputFile), std::string(pszGDALFormat), wv2RadGainOffs);
     }
     catch(rsgis::cmds::RSGISCmdException &e)
@@ -1345,6 +1357,7 @@ static PyObject *ImageCalibration_spot5ToRadiance(PyObject *self, PyObject *args
     
     try
     {
+        RSGISPyReleaseGIL releaseGIL;
         rsgis::cmds::executeConvertSPOT5ToRadiance(std::string(pszInputFile), std::string(pszOutputFile), std::string(pszGDALFormat), spot5RadGainOffs);
     }
     catch(rsgis::cmds::RSGISCmdException &e)
@@ -1375,6 +1388,7 @@ static PyObject *ImageCalibration_calcNadirImgViewAngle(PyObject *self, PyObject
     
     try
     {
+        RSGISPyReleaseGIL releaseGIL;
         rsgis::cmds::executeCalcNadirImageViewAngle(std::string(pszImgFootprint), std::string(pszOutViewAngleImg), std::string(pszGDALFormat), sateAltitude, std::string(pszMinXXCol), std::string(pszMinXYCol), std::string(pszMaxXXCol), std::string(pszMaxXYCol), std::string(pszMinYXCol), std::string(pszMinYYCol), std::string(pszMaxYXCol), std::string(pszMaxYYCol));
     }
     catch(rsgis::cmds::RSGISCmdException &e)
@@ -1517,6 +1531,7 @@ static PyObject *ImageCalibration_CalcIrradianceElevLUT(PyObject *self, PyObject
     
     try
     {
+        RSGISPyReleaseGIL releaseGIL;
         rsgis::cmds::executeCalcIrradianceElevLUT(std::string(pszInputDataMaskImg), std::string(pszInputDEMFile), std::string(pszInputIncidenceAngleImg), std::string(pszInputSlopeImg), std::string(pszShadowMaskImg), std::string(pszSrefInputImage), std::string(pszOutputFile), std::string(pszGDALFormat), solarZenith, reflScaleFactor, elevLUT);
     }
     catch(rsgis::cmds::RSGISCmdException &e)
@@ -1563,6 +1578,7 @@ static PyObject *ImageCalibration_CalcStandardisedReflectanceSD2010(PyObject *se
     
     try
     {
+        RSGISPyReleaseGIL releaseGIL;
         rsgis::cmds::executeCalcStandardisedReflectanceSD2010(std::string(pszInputDataMaskImg), std::string(pszSrefInputImage), std::string(pszInputSolarIrradiance), std::string(pszInputIncidenceAngleImg), std::string(pszInputExitanceAngleImg), std::string(pszOutputFile), std::string(pszGDALFormat), brdfBeta, outIncidenceAngle, outExitanceAngle, reflScaleFactor);
     }
     catch(rsgis::cmds::RSGISCmdException &e)
@@ -1587,6 +1603,7 @@ static PyObject *ImageCalibration_GetJulianDay(PyObject *self, PyObject *args, P
     unsigned int julianDay = 0;
     try
     {
+        RSGISPyReleaseGIL releaseGIL;
         julianDay = rsgis::cmds::executeGetJulianDay(year, month, day);
     }
     catch(rsgis::cmds::RSGISCmdException &e)
@@ -1610,6 +1627,7 @@ static PyObject *ImageCalibration_CalcSolarDistance(PyObject *self, PyObject *ar
     float solarDistance = 0;
     try
     {
+        RSGISPyReleaseGIL releaseGIL;
         solarDistance = rsgis::cmds::executeGetEarthSunDistance(julianDay);
     }
     catch(rsgis::cmds::RSGISCmdException &e)
@@ -74,7 +74,7 @@ static PyObject *ImageFilter_Filter(PyObject *self, PyObject *args, PyObject *ke
         rsgis::cmds::RSGISFilterParameters *cmdObj = new rsgis::cmds::RSGISFilterParameters();   // the c++ object we need to pass pointers of
 
         // declare and initialise pointers for all the attributes of the struct
-        PyObject *pFilterType, *pFileEnding, *pSize, *pOption, *pNLooks, *pStdDev, *pStdDevX , *pStdDevY, *pAngle = nullptr;
+        PyObject *pFilterType, *pFileEnding, *pSize, *pOption, *pNLooks, *pStdDev, *pStdDevX , *pStdDevY, *pAngle, *pPercentile = nullptr;
 
         std::vector<PyObject*> extractedAttributes;     // store a list of extracted pyobjects to dereference
         extractedAttributes.push_back(o);
@@ -182,6 +182,30 @@ static PyObject *ImageFilter_Filter(PyObject *self, PyObject *args, PyObject *ke
             cmdObj->angle = RSGISPY_FLOAT_EXTRACT(pAngle);
             std::cout << "angle = " << cmdObj->angle << " ";
         }
+
+        cmdObj->percentile = 50;
+        pPercentile = PyObject_GetAttrString(o, "percentile");
+        if( pPercentile == nullptr )
+        {
+            PyErr_Clear();
+        }
+        extractedAttributes.push_back(pPercentile);
+        if( (pPercentile != nullptr) && (RSGISPY_CHECK_FLOAT(pPercentile) || RSGISPY_CHECK_INT(pPercentile)) )
+        {
+            cmdObj->percentile = RSGISPY_FLOAT_EXTRACT(pPercentile);
+            std::cout << "percentile = " << cmdObj->percentile << " ";
+        }
+        else if( cmdObj->type == "Percentile" )
+        {
+            PyErr_SetString(GETSTATE(self)->error, "Need to provide filter 'percentile'" );
+            FreePythonObjects(extractedAttributes);
+            for(auto iter = filterParameters->begin(); iter != filterParameters->end(); ++iter)
+            {
+                delete *iter;
+            }
+            delete cmdObj;
+            return nullptr;
+        }
         std::cout << std::endl;
 
         FreePythonObjects(extractedAttributes);
@@ -190,6 +214,7 @@ static PyObject *ImageFilter_Filter(PyObject *self, PyObject *args, PyObject *ke
   
     try
     {
+        RSGISPyReleaseGIL releaseGIL;
         rsgis::RSGISLibDataType type = (rsgis::RSGISLibDataType) dataType;
         rsgis::cmds::executeFilter(pszInputImage, filterParameters, pszOutputImageBase, pszImageFormat, pszImageExt, type);
 
@@ -226,6 +251,7 @@ static PyObject *ImageFilter_LeungMalikFilterBank(PyObject *self, PyObject *args
 
     try
     {
+        RSGISPyReleaseGIL releaseGIL;
         // Set up filter Band
         std::vector<rsgis::cmds::RSGISFilterParameters*> *filterParameters = nullptr;
         
@@ -290,6 +316,7 @@ static PyMethodDef ImageFilterMethods[] = {
 "   filters.append(imagefilter.FilterParameters(filterType = 'Mean', fileEnding = 'mean', size=3) )\n"
 "   filters.append(imagefilter.FilterParameters(filterType = 'Median', fileEnding = 'median', size=3) )\n"
 "   filters.append(imagefilter.FilterParameters(filterType = 'Mode', fileEnding = 'mode', size=3) )\n"
+"   filters.append(imagefilter.FilterParameters(filterType = 'Percentile', fileEnding = 'pct90', size=3, percentile = 90) )\n"
 "   filters.append(imagefilter.FilterParameters(filterType = 'StdDev', fileEnding = 'stddev', size=3) )\n"
 "   filters.append(imagefilter.FilterParameters(filterType = 'Range', fileEnding = 'range', size=3) )\n"
 "   filters.append(imagefilter.FilterParameters(filterType = 'CoeffOfVar', fileEnding = 'coeffofvar', size=3) )\n"
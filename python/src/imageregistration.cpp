@@ -86,11 +86,15 @@ static PyObject *ImageRegistration_FindImageOffset(PyObject *self, PyObject *arg
     PyObject *outVal = PyTuple_New(2);
     try
     {
-        std::pair<double, double> offsets = rsgis::cmds::excecuteFindImageOffset(std::string(pszInputRefImage),
-                                                                                 std::string(pszInputFloatImage),
-                                                                                 refImageBands, fltImageBands,
-                                                                                 xImgSearch, yImgSearch,
-                                                                                 metricType, subPixelResolution);
+        std::pair<double, double> offsets;
+        {
+            RSGISPyReleaseGIL releaseGIL;
+            offsets = rsgis::cmds::excecuteFindImageOffset(std::string(pszInputRefImage),
+                                                           std::string(pszInputFloatImage),
+                                                           refImageBands, fltImageBands,
+                                                           xImgSearch, yImgSearch,
+                                                           metricType, subPixelResolution);
+        }
 
         if(PyTuple_SetItem(outVal, 0, Py_BuildValue("d", offsets.first)) == -1)
         {
@@ -119,24 +123,27 @@ static PyObject *ImageRegistration_BasicRegistration(PyObject *self, PyObject *a
                              RSGIS_PY_C_TEXT("threshold"), RSGIS_PY_C_TEXT("win_size"),
                              RSGIS_PY_C_TEXT("search_area"), RSGIS_PY_C_TEXT("sd_ref_thres"),
                              RSGIS_PY_C_TEXT("sd_flt_thres"), RSGIS_PY_C_TEXT("sub_pxl_res"),
-                             RSGIS_PY_C_TEXT("metric_type"), RSGIS_PY_C_TEXT("output_type"),  nullptr};
+                             RSGIS_PY_C_TEXT("metric_type"), RSGIS_PY_C_TEXT("output_type"),
+                             RSGIS_PY_C_TEXT("n_threads"), nullptr};
     const char *pszInputReferenceImage, *pszInputFloatingmage, *pszOutputGCPFile;
     int pixelGap, windowSize, searchArea, subPixelResolution, metricType, outputType;
     float threshold, stdDevRefThreshold, stdDevFloatThreshold;
+    unsigned int numThreads = 1;
     
-    if( !PyArg_ParseTupleAndKeywords(args, keywds, "sssifiiffiii:basic_registration", kwlist, &pszInputReferenceImage, &pszInputFloatingmage,
+    if( !PyArg_ParseTupleAndKeywords(args, keywds, "sssifiiffiii|I:basic_registration", kwlist, &pszInputReferenceImage, &pszInputFloatingmage,
                                      &pszOutputGCPFile, &pixelGap, &threshold, &windowSize, &searchArea, &stdDevRefThreshold,
-                                     &stdDevFloatThreshold, &subPixelResolution, &metricType, &outputType))
+                                     &stdDevFloatThreshold, &subPixelResolution, &metricType, &outputType, &numThreads))
     {
         return nullptr;
     }
 
     try
     {
+        RSGISPyReleaseGIL releaseGIL;
         rsgis::cmds:: excecuteBasicRegistration(pszInputReferenceImage, pszInputFloatingmage, pixelGap,
                                     threshold, windowSize, searchArea, stdDevRefThreshold,
                                     stdDevFloatThreshold, subPixelResolution, metricType,
-                                    outputType, pszOutputGCPFile);
+                                    outputType, pszOutputGCPFile, numThreads);
     }
     catch(rsgis::cmds::RSGISCmdException &e)
     {
@@ -147,6 +154,49 @@ static PyObject *ImageRegistration_BasicRegistration(PyObject *self, PyObject *a
     Py_RETURN_NONE;
 }
 
+static PyObject *ImageRegistration_CalcTiePtSimilaritySurface(PyObject *self, PyObject *args, PyObject *keywds)
+{
+    static char *kwlist[] = {RSGIS_PY_C_TEXT("in_ref_img"), RSGIS_PY_C_TEXT("in_float_img"),
+                             RSGIS_PY_C_TEXT("eastings"), RSGIS_PY_C_TEXT("northings"),
+                             RSGIS_PY_C_TEXT("win_size"), RSGIS_PY_C_TEXT("search_area"),
+                             RSGIS_PY_C_TEXT("metric_type"), nullptr};
+    const char *pszInputReferenceImage, *pszInputFloatingmage;
+    double eastings, northings;
+    int windowSize, searchArea, metricType;
+
+    if( !PyArg_ParseTupleAndKeywords(args, keywds, "ssddiii:calc_tie_pt_similarity_surface", kwlist, &pszInputReferenceImage,
+                                     &pszInputFloatingmage, &eastings, &northings, &windowSize, &searchArea, &metricType))
+    {
+        return nullptr;
+    }
+
+    std::vector<std::vector<float> > surface;
+    try
+    {
+        RSGISPyReleaseGIL releaseGIL;
+        surface = rsgis::cmds::executeCalcTiePointSimilaritySurface(pszInputReferenceImage, pszInputFloatingmage, eastings,
+                                                                    northings, windowSize, searchArea, metricType);
+    }
+    catch(rsgis::cmds::RSGISCmdException &e)
+    {
+        PyErr_SetString(GETSTATE(self)->error, e.what());
+        return nullptr;
+    }
+
+    PyObject *pSurface = PyList_New(surface.size());
+    for(size_t i = 0; i < surface.size(); ++i)
+    {
+        PyObject *pRow = PyList_New(surface[i].size());
+        for(size_t j = 0; j < surface[i].size(); ++j)
+        {
+            PyList_SetItem(pRow, j, PyFloat_FromDouble(surface[i][j]));
+        }
+        PyList_SetItem(pSurface, i, pRow);
+    }
+
+    return pSurface;
+}
+
 static PyObject *ImageRegistration_SingleLayerRegistration(PyObject *self, PyObject *args, PyObject *keywds)
 {
     static char *kwlist[] = {RSGIS_PY_C_TEXT("in_ref_img"), RSGIS_PY_C_TEXT("in_float_img"),
@@ -156,28 +206,31 @@ static PyObject *ImageRegistration_SingleLayerRegistration(PyObject *self, PyObj
                              RSGIS_PY_C_TEXT("sd_flt_thres"), RSGIS_PY_C_TEXT("sub_pxl_res"),
                              RSGIS_PY_C_TEXT("dist_threshold"), RSGIS_PY_C_TEXT("max_n_iters"),
                              RSGIS_PY_C_TEXT("move_chng_thres"), RSGIS_PY_C_TEXT("p_smooth"),
-                             RSGIS_PY_C_TEXT("metric_type"), RSGIS_PY_C_TEXT("output_type"),  nullptr};
+                             RSGIS_PY_C_TEXT("metric_type"), RSGIS_PY_C_TEXT("output_type"),
+                             RSGIS_PY_C_TEXT("n_threads"), nullptr};
     const char *pszInputReferenceImage, *pszInputFloatingmage, *pszOutputGCPFile;
     int pixelGap, windowSize, searchArea, subPixelResolution, metricType, 
         outputType, maxNumIterations, distanceThreshold;
     float threshold, stdDevRefThreshold, stdDevFloatThreshold, moveChangeThreshold,
         pSmoothness;
+    unsigned int numThreads = 1;
     
-    if( !PyArg_ParseTupleAndKeywords(args, keywds, "sssifiiffiiiffii:single_layer_registration", kwlist, &pszInputReferenceImage,
+    if( !PyArg_ParseTupleAndKeywords(args, keywds, "sssifiiffiiiffii|I:single_layer_registration", kwlist, &pszInputReferenceImage,
                                      &pszInputFloatingmage, &pszOutputGCPFile, &pixelGap, &threshold, &windowSize, &searchArea,
                                      &stdDevRefThreshold, &stdDevFloatThreshold, &subPixelResolution, &distanceThreshold,
-                                     &maxNumIterations, &moveChangeThreshold, &pSmoothness, &metricType, &outputType))
+                                     &maxNumIterations, &moveChangeThreshold, &pSmoothness, &metricType, &outputType, &numThreads))
     {
         return nullptr;
     }
 
     try
     {
+        RSGISPyReleaseGIL releaseGIL;
         rsgis::cmds:: excecuteSingleLayerConnectedRegistration(pszInputReferenceImage, pszInputFloatingmage, pixelGap,
                                     threshold, windowSize, searchArea, stdDevRefThreshold,
                                     stdDevFloatThreshold, subPixelResolution, distanceThreshold,
                                     maxNumIterations, moveChangeThreshold, pSmoothness, metricType,
-                                    outputType, pszOutputGCPFile);
+                                    outputType, pszOutputGCPFile, numThreads);
     }
     catch(rsgis::cmds::RSGISCmdException &e)
     {
@@ -203,6 +256,7 @@ static PyObject *ImageRegistration_GCP2GDAL(PyObject *self, PyObject *args, PyOb
 
     try
     {
+        RSGISPyReleaseGIL releaseGIL;
         rsgis::cmds::excecuteAddGCPsGDAL(pszInputImage, pszInputGCPFile, pszOutputFile, pszGDALFormat, (rsgis::RSGISLibDataType) nOutDataType);
     }
     catch(rsgis::cmds::RSGISCmdException &e)
@@ -229,6 +283,7 @@ static PyObject *ImageRegistration_ApplyOffset2Image(PyObject *self, PyObject *a
     
     try
     {
+        RSGISPyReleaseGIL releaseGIL;
         rsgis::cmds::executeApplyOffset2Image(std::string(pszInputImage), std::string(pszOutputImage), std::string(pszGDALFormat), (rsgis::RSGISLibDataType) nOutDataType, xOff, yOff);
     }
     catch(rsgis::cmds::RSGISCmdException &e)
@@ -262,7 +317,7 @@ static PyMethodDef ImageRegistrationMethods[] = {
 },
 
 {"basic_registration", (PyCFunction)ImageRegistration_BasicRegistration, METH_VARARGS | METH_KEYWORDS,
-"imageregistration.basic_registration(in_ref_img:str, in_float_img:str, out_gcp_file:str, pixel_gap:int, threshold:float, win_size:int, search_area:int, sd_ref_thres:float, sd_flt_thres:float, sub_pxl_res:float, metric_type:int, output_type:int)\n"
+"imageregistration.basic_registration(in_ref_img:str, in_float_img:str, out_gcp_file:str, pixel_gap:int, threshold:float, win_size:int, search_area:int, sd_ref_thres:float, sd_flt_thres:float, sub_pxl_res:float, metric_type:int, output_type:int, n_threads:int=1)\n"
 "Generate tie points between floating and reference image using basic algorithm.\n"
 "\n"
 ":param in_ref_img: is a string providing reference image which to which the floating image is to be registered.n"
@@ -277,6 +332,7 @@ static PyMethodDef ImageRegistrationMethods[] = {
 ":param sub_pxl_res: is an int specifying the sub-pixel resolution to which the pixel shifts are estimated. Note that the values are positive integers such that a value of 2 will result in a sub pixel resolution of 0.5 of a pixel and a value 4 will be 0.25 of a pixel. \n"
 ":param metric_type: is an the similarity metric used to compare images of type rsgislib.imageregistration.METRIC_* \n"
 ":param output_type: is an the format of the output file of type rsgislib.imageregistration.TYPE_* \n"
+":param n_threads: is an int specifying the number of threads used to find the tie point locations (Default: 1). Each thread opens its own copy of the input images.\n"
 "\n"
 ".. code:: python\n"
 "\n"
@@ -294,10 +350,28 @@ static PyMethodDef ImageRegistrationMethods[] = {
 "   output = './TestOutputs/injune_p142_casi_sub_utm_tie_points.txt'\n"
 "   imageregistration.basic_registration(reference, floating, pixelGap, threshold, window, search, stddevRef, stddevFloat, subpixelresolution, metric, outputType, output)\n"
 "\n"
+},
+
+{"calc_tie_pt_similarity_surface", (PyCFunction)ImageRegistration_CalcTiePtSimilaritySurface, METH_VARARGS | METH_KEYWORDS,
+"imageregistration.calc_tie_pt_similarity_surface(in_ref_img:str, in_float_img:str, eastings:float, northings:float, win_size:int, search_area:int, metric_type:int)\n"
+"Calculate the image similarity for every whole pixel shift of the floating image within the search area\n"
+"for the window around a tie point, as used by the registration functions to locate the tie point.\n"
+"\n"
+":param in_ref_img: is a string providing reference image which to which the floating image is to be registered.\n"
+":param in_float_img: is a string providing the floating image to be registered to the reference image\n"
+":param eastings: is the x coordinate of the tie point.\n"
+":param northings: is the y coordinate of the tie point.\n"
+":param win_size: is an int providing the size of the window (in pixels either side of the tie point) used for the matching.\n"
+":param search_area: is an int providing the distance (in pixels) from the tie point which will be searched.\n"
+":param metric_type: is an the similarity metric used to compare images of type rsgislib.imageregistration.METRIC_* \n"
+":return: a list of (search_area*2)+1 rows (y shifts from -search_area) each of (search_area*2)+1 values\n"
+"         (x shifts from -search_area). Shifts where the images do not overlap are NaN.\n"
+"\n"
+"\n"
 },
 
     {"single_layer_registration", (PyCFunction)ImageRegistration_SingleLayerRegistration, METH_VARARGS | METH_KEYWORDS,
-"imageregistration.single_layer_registration(in_ref_img:str, in_float_img:str, out_gcp_file:str, pixel_gap:int, threshold:float, win_size:int, search_area:int, sd_ref_thres:float, sd_flt_thres:float, sub_pxl_res:float, dist_threshold:float, max_n_iters:int, move_chng_thres:float, p_smooth:float, metric_type:int, output_type:int)\n"
+"imageregistration.single_layer_registration(in_ref_img:str, in_float_img:str, out_gcp_file:str, pixel_gap:int, threshold:float, win_size:int, search_area:int, sd_ref_thres:float, sd_flt_thres:float, sub_pxl_res:float, dist_threshold:float, max_n_iters:int, move_chng_thres:float, p_smooth:float, metric_type:int, output_type:int, n_threads:int=1)\n"
 "Generate tie points between floating and reference image using a single connected layer of tie points.\n"
 "\n"
 ":param in_ref_img: is a string providing reference image which to which the floating image is to be registered.n"
@@ -316,6 +390,7 @@ static PyMethodDef ImageRegistrationMethods[] = {
 ":param p_smooth: is a float providing the 'p' parameter for the inverse weighted distance calculation. A value of 2 should be used by default\n"
 ":param metric_type: is an the similarity metric used to compare images of type rsgislib.imageregistration.METRIC_* \n"
 ":param output_type: is an the format of the output file of type rsgislib.imageregistration.TYPE_* \n"
+":param n_threads: is an int specifying the number of threads used to find the tie point locations (Default: 1). Each thread opens its own copy of the input images.\n"
 "\n"
 ".. code:: python\n"
 "\n"
@@ -134,6 +134,7 @@ static PyObject *ImageUtils_StretchImage(PyObject *self, PyObject *args, PyObjec
 
     try
     {
+        RSGISPyReleaseGIL releaseGIL;
         rsgis::cmds::executeStretchImageNoData(pszInputImage, pszOutputFile, inNoData, saveOutStats,
                                                pszOutStatsFile, onePassSD, pszGDALFormat,
                                                (rsgis::RSGISLibDataType)nOutDataType, (rsgis::cmds::RSGISStretches)nStretchType, fStretchParam);
@@ -166,6 +167,7 @@ static PyObject *ImageUtils_StretchImageWithStats(PyObject *self, PyObject *args
 
     try
     {
+        RSGISPyReleaseGIL releaseGIL;
         rsgis::cmds::executeStretchImageWithStatsNoData(pszInputImage, pszOutputFile, pszInStatsFile,
                                                         pszGDALFormat, (rsgis::RSGISLibDataType)nOutDataType,
                                                         (rsgis::cmds::RSGISStretches)nStretchType, fStretchParam, nodataval);
@@ -201,6 +203,7 @@ static PyObject *ImageUtils_NormaliseImagePxlVals(PyObject *self, PyObject *args
     
     try
     {
+        RSGISPyReleaseGIL releaseGIL;
         rsgis::cmds::executeNormaliseImgPxlVals(std::string(pszInputImage), std::string(pszOutputFile),
                                                 std::string(pszGDALFormat), (rsgis::RSGISLibDataType)nOutDataType, inNoDataVal,
                                                 outNoDataVal, outMinVal, outMaxVal, (rsgis::cmds::RSGISStretches)nStretchType, fStretchParam);
@@ -264,6 +267,7 @@ static PyObject *ImageUtils_maskImage(PyObject *self, PyObject *args, PyObject *
     
     try
     {
+        RSGISPyReleaseGIL releaseGIL;
         rsgis::cmds::executeMaskImage(pszInputImage, pszImageMask, pszOutputImage, pszGDALFormat, (rsgis::RSGISLibDataType)nDataType, outValue, maskValues);
     }
     catch(rsgis::cmds::RSGISCmdException &e)
@@ -296,7 +300,10 @@ static PyObject *ImageUtils_createTiles(PyObject *self, PyObject *args, PyObject
     try
     {
         std::vector<std::string> outFileNames;
-        rsgis::cmds::executeCreateTiles(pszInputImage, pszImageBase, imgWidth, imgHeight, imgTileOverlap, offsetTiling, pszGDALFormat, (rsgis::RSGISLibDataType)nDataType, pszExt, &outFileNames);
+        {
+            RSGISPyReleaseGIL releaseGIL;
+            rsgis::cmds::executeCreateTiles(pszInputImage, pszImageBase, imgWidth, imgHeight, imgTileOverlap, offsetTiling, pszGDALFormat, (rsgis::RSGISLibDataType)nDataType, pszExt, &outFileNames);
+        }
         
         pOutList = PyList_New(outFileNames.size());
         Py_ssize_t nIndex = 0;
@@ -321,15 +328,17 @@ static PyObject *ImageUtils_createImageMosaic(PyObject *self, PyObject *args, Py
     static char *kwlist[] = {RSGIS_PY_C_TEXT("input_imgs"), RSGIS_PY_C_TEXT("output_img"),
                              RSGIS_PY_C_TEXT("background_val"), RSGIS_PY_C_TEXT("skip_val"),
                              RSGIS_PY_C_TEXT("skip_band"), RSGIS_PY_C_TEXT("overlap_behaviour"),
-                             RSGIS_PY_C_TEXT("gdalformat"), RSGIS_PY_C_TEXT("datatype"), nullptr};
+                             RSGIS_PY_C_TEXT("gdalformat"), RSGIS_PY_C_TEXT("datatype"),
+                             RSGIS_PY_C_TEXT("n_threads"), nullptr};
     const char *pszOutputImage, *pszGDALFormat;
     float backgroundVal, skipVal;
     int skipBand, nDataType, overlapBehaviour;
+    unsigned int numThreads = 1;
     PyObject *pInputImages; // List of input images
 
     // Check parameters are present and of correct type
-    if( !PyArg_ParseTupleAndKeywords(args, keywds, "Osffiisi:create_img_mosaic", kwlist, &pInputImages, &pszOutputImage,
-                                &backgroundVal, &skipVal, &skipBand, &overlapBehaviour,&pszGDALFormat, &nDataType))
+    if( !PyArg_ParseTupleAndKeywords(args, keywds, "Osffiisi|I:create_img_mosaic", kwlist, &pInputImages, &pszOutputImage,
+                                &backgroundVal, &skipVal, &skipBand, &overlapBehaviour,&pszGDALFormat, &nDataType, &numThreads))
     {
         return nullptr;
     }
@@ -352,8 +361,9 @@ static PyObject *ImageUtils_createImageMosaic(PyObject *self, PyObject *args, Py
     
     try
     {
+        RSGISPyReleaseGIL releaseGIL;
         rsgis::cmds::executeImageMosaic(inputImages, numImages, pszOutputImage, backgroundVal, 
-                    skipVal, skipBand-1, overlapBehaviour, pszGDALFormat, (rsgis::RSGISLibDataType)nDataType);
+                    skipVal, skipBand-1, overlapBehaviour, pszGDALFormat, (rsgis::RSGISLibDataType)nDataType, numThreads);
 
     }
     catch(rsgis::cmds::RSGISCmdException &e)
@@ -435,6 +445,7 @@ static PyObject *ImageUtils_IncludeImages(PyObject *self, PyObject *args, PyObje
     
     try
     {
+        RSGISPyReleaseGIL releaseGIL;
         rsgis::cmds::executeImageInclude(inputImages, numImages, pszBaseImage, bandsDefined, imgBands, skipVal, useSkipVal);
     }
     catch(rsgis::cmds::RSGISCmdException &e)
@@ -478,6 +489,7 @@ static PyObject *ImageUtils_IncludeImagesOverlap(PyObject *self, PyObject *args,
     
     try
     {
+        RSGISPyReleaseGIL releaseGIL;
         rsgis::cmds::executeImageIncludeOverlap(inputImages, numImages, pszBaseImage, pxlOverlap);
     }
     catch(rsgis::cmds::RSGISCmdException &e)
@@ -519,6 +531,7 @@ static PyObject *ImageUtils_IncludeImagesIndImgIntersect(PyObject *self, PyObjec
     
     try
     {
+        RSGISPyReleaseGIL releaseGIL;
         rsgis::cmds::executeImageIncludeIndImgIntersect(inputImages, numImages, pszBaseImage);
     }
     catch(rsgis::cmds::RSGISCmdException &e)
@@ -549,6 +562,7 @@ static PyObject *ImageUtils_PopImageStats(PyObject *self, PyObject *args, PyObje
     
     try
     {
+        RSGISPyReleaseGIL releaseGIL;
         rsgis::cmds::executePopulateImgStats(pszInputImage, useNoDataValue, noDataValue, buildPyramids, pyraScaleVals);
     }
     catch(rsgis::cmds::RSGISCmdException &e)
@@ -600,6 +614,7 @@ static PyObject *ImageUtils_AssignProj(PyObject *self, PyObject *args, PyObject
     
     try
     {
+        RSGISPyReleaseGIL releaseGIL;
         rsgis::cmds::executeAssignProj(pszInputImage, pszInputProj, readWKTFromFile, pszInputProjFile);
     }
     catch(rsgis::cmds::RSGISCmdException &e)
@@ -623,6 +638,7 @@ static PyObject *ImageUtils_CopyProjFromImage(PyObject *self, PyObject *args, Py
     
     try
     {
+        RSGISPyReleaseGIL releaseGIL;
         rsgis::cmds::executeCopyProj(pszInputImage, pszInputRefImage);
     }
     catch(rsgis::cmds::RSGISCmdException &e)
@@ -646,6 +662,7 @@ static PyObject *ImageUtils_CopySpatialAndProjFromImage(PyObject *self, PyObject
     
     try
     {
+        RSGISPyReleaseGIL releaseGIL;
         rsgis::cmds::executeCopyProjSpatial(pszInputImage, pszInputRefImage);
     }
     catch(rsgis::cmds::RSGISCmdException &e)
@@ -746,6 +763,7 @@ static PyObject *ImageUtils_AssignSpatialInfo(PyObject *self, PyObject *args, Py
     
     try
     {
+        RSGISPyReleaseGIL releaseGIL;
         rsgis::cmds::executeAssignSpatialInfo(pszInputImage, xTL, yTL, xRes, yRes, xRot, yRot, xTLDef, yTLDef, xResDef, yResDef, xRotDef, yRotDef);
     }
     catch(rsgis::cmds::RSGISCmdException &e)
@@ -800,6 +818,7 @@ static PyObject *ImageUtils_SelectImageBands(PyObject *self, PyObject *args, PyO
     
     try
     {
+        RSGISPyReleaseGIL releaseGIL;
         rsgis::cmds::executeSubsetImageBands(std::string(pszInputImage), std::string(pszOutputFile),
                                              imgBands, std::string(pszGDALFormat), (rsgis::RSGISLibDataType)nDataType);
     }
@@ -827,6 +846,7 @@ static PyObject *ImageUtils_Subset(PyObject *self, PyObject *args, PyObject *key
     
     try
     {
+        RSGISPyReleaseGIL releaseGIL;
         rsgis::cmds::executeSubset(std::string(pszInputImage), std::string(pszInputVectorFile),
                                    std::string(pszInputVectorLyr), std::string(pszOutputImage),
                                    std::string(pszGDALFormat), (rsgis::RSGISLibDataType)nOutDataType);
@@ -858,6 +878,7 @@ static PyObject *ImageUtils_SubsetBBox(PyObject *self, PyObject *args, PyObject
     
     try
     {
+        RSGISPyReleaseGIL releaseGIL;
         rsgis::cmds::executeSubsetBBox(pszInputImage, pszOutputImage, pszGDALFormat, (rsgis::RSGISLibDataType)nOutDataType, xMin, xMax, yMin, yMax);
     }
     catch(rsgis::cmds::RSGISCmdException &e)
@@ -882,6 +903,7 @@ static PyObject *ImageUtils_Subset2Img(PyObject *self, PyObject *args, PyObject
     
     try
     {
+        RSGISPyReleaseGIL releaseGIL;
         rsgis::cmds::executeSubset2Img(std::string(pszInputImage), std::string(pszInputROI),
                                        std::string(pszOutputImage), std::string(pszGDALFormat),
                                        (rsgis::RSGISLibDataType)nOutDataType);
@@ -965,6 +987,7 @@ static PyObject *ImageUtils_StackImageBands(PyObject *self, PyObject *args, PyOb
     
     try
     {
+        RSGISPyReleaseGIL releaseGIL;
         rsgis::cmds::executeStackImageBands(inputImages, imageBandNames, numImages, std::string(pszOutputFile),
                                             skipPixels, skipValue, noDataValue, std::string(pszGDALFormat),
                                             (rsgis::RSGISLibDataType)nDataType, replaceBandNames);
@@ -1004,6 +1027,7 @@ static PyObject *ImageUtils_CreateBlankImage(PyObject *self, PyObject *args, PyO
     
     try
     {
+        RSGISPyReleaseGIL releaseGIL;
         rsgis::cmds::executeCreateBlankImage(std::string(pszOutputImage), numBands, width, height, tlX, tlY,
                                              res_x, res_y, pxlVal, std::string(wktFile), std::string(wktString),
                                              std::string(pszGDALFormat), (rsgis::RSGISLibDataType)nOutDataType);
@@ -1036,6 +1060,7 @@ static PyObject *ImageUtils_CreateCopyImage(PyObject *self, PyObject *args, PyOb
     
     try
     {
+        RSGISPyReleaseGIL releaseGIL;
         rsgis::cmds::executeCreateCopyBlankImage(std::string(pszInputImage), std::string(pszOutputImage),
                                                  numBands, pxlVal, std::string(pszGDALFormat), (rsgis::RSGISLibDataType)nOutDataType);
     }
@@ -1072,6 +1097,7 @@ static PyObject *ImageUtils_CreateCopyImageDefExtent(PyObject *self, PyObject *a
     
     try
     {
+        RSGISPyReleaseGIL releaseGIL;
         rsgis::cmds::executeCreateCopyBlankDefExtImage(std::string(pszInputImage), std::string(pszOutputImage),
                                                  numBands, xMin, xMax, yMin, yMax, xRes, yRes, pxlVal,
                                                  std::string(pszGDALFormat), (rsgis::RSGISLibDataType)nOutDataType);
@@ -1105,6 +1131,7 @@ static PyObject *ImageUtils_CreateCopyImageVecExtent(PyObject *self, PyObject *a
     
     try
     {
+        RSGISPyReleaseGIL releaseGIL;
         rsgis::cmds::executeCreateCopyBlankImageVecExtent(std::string(pszInputImage), std::string(pszInputVectorFile),
                                                           std::string(pszInputVectorLyr), std::string(pszOutputImage),
                                                           numBands, pxlVal, std::string(pszGDALFormat),
@@ -1149,7 +1176,11 @@ static PyObject *ImageUtils_OrderImagesUsingPropValidData(PyObject *self, PyObje
     PyObject *outImagesList = nullptr;
     try
     {
-        std::vector<std::string> orderedInputImages = rsgis::cmds::executeOrderImageUsingValidDataProp(inputImages, noDataValue);
+        std::vector<std::string> orderedInputImages;
+        {
+            RSGISPyReleaseGIL releaseGIL;
+            orderedInputImages = rsgis::cmds::executeOrderImageUsingValidDataProp(inputImages, noDataValue);
+        }
         
         outImagesList = PyTuple_New(orderedInputImages.size());
         
@@ -1197,6 +1228,7 @@ static PyObject *ImageUtils_GenSamplingGrid(PyObject *self, PyObject *args, PyOb
     
     try
     {
+        RSGISPyReleaseGIL releaseGIL;
         rsgis::cmds::executeProduceRegularGridImage(std::string(pszInputImage), std::string(pszOutputImage),
                                                     std::string(pszGDALFormat), pxlRes, minVal, maxVal, (bool)singleLine);
     }
@@ -1225,6 +1257,7 @@ static PyObject *ImageUtils_GenFiniteMask(PyObject *self, PyObject *args, PyObje
     
     try
     {
+        RSGISPyReleaseGIL releaseGIL;
         rsgis::cmds::executeFiniteImageMask(std::string(pszInputImage), std::string(pszOutputImage), std::string(pszGDALFormat));
     }
     catch(rsgis::cmds::RSGISCmdException &e)
@@ -1281,6 +1314,7 @@ static PyObject *ImageUtils_GenValidMask(PyObject *self, PyObject *args, PyObjec
     
     try
     {
+        RSGISPyReleaseGIL releaseGIL;
         rsgis::cmds::executeValidImageMask(inputImages, std::string(pszOutputImage), std::string(pszGDALFormat), noDataVal);
     }
     catch(rsgis::cmds::RSGISCmdException &e)
@@ -1308,6 +1342,7 @@ static PyObject *ImageUtils_GenImageEdgeMask(PyObject *self, PyObject *args, PyO
 
     try
     {
+        RSGISPyReleaseGIL releaseGIL;
         rsgis::cmds::executeImageEdgeMask(std::string(pInputImage), std::string(pszOutputImage), std::string(pszGDALFormat), nEdgePixels);
     }
     catch(rsgis::cmds::RSGISCmdException &e)
@@ -1362,6 +1397,7 @@ static PyObject *ImageUtils_CombineImages2Band(PyObject *self, PyObject *args, P
     
     try
     {
+        RSGISPyReleaseGIL releaseGIL;
         rsgis::cmds::executeCombineImagesSingleBandIgnoreNoData(inputImages, std::string(pszOutputImage), noDataVal, std::string(pszGDALFormat), type);
     }
     catch(rsgis::cmds::RSGISCmdException &e)
@@ -1424,6 +1460,7 @@ static PyObject *ImageUtils_PerformRandomPxlSample(PyObject *self, PyObject *arg
     
     try
     {
+        RSGISPyReleaseGIL releaseGIL;
         rsgis::cmds::executePerformRandomPxlSample(std::string(pszInputImage), std::string(pszOutputImage), std::string(pszGDALFormat), maskVals, numSamples);
     }
     catch(rsgis::cmds::RSGISCmdException &e)
@@ -1487,6 +1524,7 @@ static PyObject *ImageUtils_PerformRandomPxlSampleSmallPxlCount(PyObject *self,
     
     try
     {
+        RSGISPyReleaseGIL releaseGIL;
         rsgis::cmds::executePerformRandomPxlSampleSmallPxlCount(std::string(pszInputImage), std::string(pszOutputImage), std::string(pszGDALFormat), maskVals, numSamples, rndSeed);
     }
     catch(rsgis::cmds::RSGISCmdException &e)
@@ -1519,6 +1557,7 @@ static PyObject *ImageUtils_PanSharpenHCS(PyObject *self, PyObject *args, PyObje
     
     try
     {
+        RSGISPyReleaseGIL releaseGIL;
         bool useNaiveMeth = (bool)useNaiveMethInt;
         rsgis::cmds::executePerformHCSPanSharpen(std::string(pszInputImage), std::string(pszOutputImage), std::string(pszGDALFormat), type, winSize, useNaiveMeth);
     }
@@ -1635,6 +1674,7 @@ static PyObject *ImageUtils_SharpenLowResImageBands(PyObject *self, PyObject *ar
     
     try
     {
+        RSGISPyReleaseGIL releaseGIL;
         rsgis::cmds::executeSharpenLowResImgBands(std::string(pszInputImage), std::string(pszOutputImage),
                                                   bandInfo, winSize, nodata, std::string(pszGDALFormat), type);
     }
@@ -1647,6 +1687,64 @@ static PyObject *ImageUtils_SharpenLowResImageBands(PyObject *self, PyObject *ar
     Py_RETURN_NONE;
 }
 
+static PyObject *ImageUtils_CreateMaxNDVICompositeImg(PyObject *self, PyObject *args, PyObject *keywds)
+{
+    static char *kwlist[] = {RSGIS_PY_C_TEXT("input_imgs"), RSGIS_PY_C_TEXT("output_img"),
+                             RSGIS_PY_C_TEXT("r_band"), RSGIS_PY_C_TEXT("n_band"),
+                             RSGIS_PY_C_TEXT("gdalformat"), RSGIS_PY_C_TEXT("datatype"), nullptr};
+    PyObject *pInputImages;
+    const char *pszOutputImage = "";
+    unsigned int redBand = 0;
+    unsigned int nirBand = 0;
+    const char *pszGDALFormat = "";
+    int nDataType;
+    
+    if( !PyArg_ParseTupleAndKeywords(args, keywds, "OsIIsi:create_max_ndvi_composite_img", kwlist, &pInputImages,
+                                     &pszOutputImage, &redBand, &nirBand, &pszGDALFormat, &nDataType))
+    {
+        return nullptr;
+    }
+    
+    rsgis::RSGISLibDataType type = (rsgis::RSGISLibDataType)nDataType;
+    
+    if( !PySequence_Check(pInputImages))
+    {
+        PyErr_SetString(GETSTATE(self)->error, "Input images must be a sequence");
+        return nullptr;
+    }
+    
+    Py_ssize_t nImages = PySequence_Size(pInputImages);
+    std::vector<std::string> inputImages;
+    inputImages.reserve(nImages);
+    for( Py_ssize_t n = 0; n < nImages; n++ )
+    {
+        PyObject *o = PySequence_GetItem(pInputImages, n);
+        
+        if(!RSGISPY_CHECK_STRING(o))
+        {
+            PyErr_SetString(GETSTATE(self)->error, "Input images must be strings");
+            Py_DECREF(o);
+            return nullptr;
+        }
+        
+        inputImages.push_back(RSGISPY_STRING_EXTRACT(o));
+    }
+    
+    try
+    {
+        RSGISPyReleaseGIL releaseGIL;
+        rsgis::cmds::executeCreateMaxNDVICompsiteImage(inputImages, std::string(pszOutputImage), redBand, nirBand,
+                                                       std::string(pszGDALFormat), type);
+    }
+    catch(rsgis::cmds::RSGISCmdException &e)
+    {
+        PyErr_SetString(GETSTATE(self)->error, e.what());
+        return nullptr;
+    }
+    
+    Py_RETURN_NONE;
+}
+
 static PyObject *ImageUtils_CreateRefImageCompositeImg(PyObject *self, PyObject *args, PyObject *keywds)
 {
     static char *kwlist[] = {RSGIS_PY_C_TEXT("input_imgs"), RSGIS_PY_C_TEXT("output_img"),
@@ -1692,6 +1790,7 @@ static PyObject *ImageUtils_CreateRefImageCompositeImg(PyObject *self, PyObject
     
     try
     {
+        RSGISPyReleaseGIL releaseGIL;
         rsgis::cmds::executeCreateRefImgCompsiteImage(inputImages, std::string(pszOutputImage),
                                                       std::string(pszRefImage), std::string(pszGDALFormat),
                                                       type, outNoData);
@@ -1805,6 +1904,7 @@ static PyObject *ImageUtils_GenTimeseriesFillCompositeImg(PyObject *self, PyObje
     
     try
     {
+        RSGISPyReleaseGIL releaseGIL;
         rsgis::RSGISLibDataType type = (rsgis::RSGISLibDataType)nDataType;
         rsgis::cmds::executeGenTimeseriesFillCompositeImg(inCompInfo, std::string(pszValidMaskImage),
                                                           std::string(pszOutRefFillImage), std::string(pszOutCompImage),
@@ -1838,6 +1938,7 @@ static PyObject *ImageUtils_ExportSingleMergedImgBand(PyObject *self, PyObject *
     
     try
     {
+        RSGISPyReleaseGIL releaseGIL;
         rsgis::RSGISLibDataType type = (rsgis::RSGISLibDataType)nDataType;
         rsgis::cmds::executeExportSingleMergedImgBand(std::string(pInputImg), std::string(pInputBandRefImg), std::string(pOutputImg), std::string(pszGDALFormat), type);
     }
@@ -1864,7 +1965,11 @@ static PyObject *ImageUtils_GetGDALImageCreationOpts(PyObject *self, PyObject *a
     PyObject *out_info_dict = nullptr;
     try
     {
-        std::map<std::string, std::string> gdalCreationOpts = rsgis::cmds::executeGetGDALImageCreationOpts(std::string(pGDALFormat));
+        std::map<std::string, std::string> gdalCreationOpts;
+        {
+            RSGISPyReleaseGIL releaseGIL;
+            gdalCreationOpts = rsgis::cmds::executeGetGDALImageCreationOpts(std::string(pGDALFormat));
+        }
         
         if(gdalCreationOpts.size() > 0)
         {
@@ -1910,6 +2015,7 @@ static PyObject *ImageUtils_UnPackPixelVals(PyObject *self, PyObject *args, PyOb
 
     try
     {
+        RSGISPyReleaseGIL releaseGIL;
         rsgis::cmds::executeUnpackPxlValues(std::string(pInputImage), pInputImageBand, std::string(pszOutputImage), std::string(pszGDALFormat));
     }
     catch(rsgis::cmds::RSGISCmdException &e)
@@ -1938,7 +2044,7 @@ static PyMethodDef ImageUtilsMethods[] = {
 ":param datatype: is a rsgislib.TYPE_* value providing the output data type.\n"
 ":param stretch_type: is a STRETCH_* value providing the type of stretch, options are:\n"
 "        * imageutils.STRETCH_LINEARMINMAX - Stretches between min and max.\n"
-"        * imageutils.STRETCH_LINEARPERCENT - Stretches between percentage of image range. Parameter defines percent.\n"
+"        * imageutils.STRETCH_LINEARPERCENT - Stretches between the percent and 100-percent percentiles of the image band. Parameter defines percent (0 - 50).\n"
 "        * imageutils.STRETCH_LINEARSTDDEV - Stretches between mean - sd to mean + sd. Parameter defines number of standard deviations.\n"
 "        * imageutils.STRETCH_EXPONENTIAL - Exponential stretch between mean - 2*sd to mean + 2*sd. No parameter.\n"
 "        * imageutils.STRETCH_LOGARITHMIC - Logarithmic stretch between mean - 2*sd to mean + 2*sd. No parameter.\n"
@@ -2007,7 +2113,7 @@ static PyMethodDef ImageUtilsMethods[] = {
 ":param out_max: is a float which specifies the output maximum pixel value (Default = 1)\n"
 ":param stretch_type: is a STRETCH_* value providing the type of stretch, options are:\n"
 "        * imageutils.STRETCH_LINEARMINMAX - Stretches between min and max.\n"
-"        * imageutils.STRETCH_LINEARPERCENT - Stretches between percentage of image range. Parameter defines percent.\n"
+"        * imageutils.STRETCH_LINEARPERCENT - Stretches between the percent and 100-percent percentiles of the image band. Parameter defines percent (0 - 50).\n"
 "        * imageutils.STRETCH_LINEARSTDDEV - Stretches between mean - sd to mean + sd. Parameter defines number of standard deviations.\n"
 "        * imageutils.STRETCH_EXPONENTIAL - Exponential stretch between mean - 2*sd to mean + 2*sd. No parameter.\n"
 "        * imageutils.STRETCH_LOGARITHMIC - Logarithmic stretch between mean - 2*sd to mean + 2*sd. No parameter.\n"
@@ -2093,8 +2199,9 @@ static PyMethodDef ImageUtilsMethods[] = {
 "\n"},
     
 {"create_img_mosaic", (PyCFunction)ImageUtils_createImageMosaic, METH_VARARGS | METH_KEYWORDS,
-"rsgislib.imageutils.create_img_mosaic(input_imgs, output_img, background_val, skip_val, skip_band, overlap_behaviour, gdalformat, datatype)\n"
-"Create mosaic from list of input images.\n"
+"rsgislib.imageutils.create_img_mosaic(input_imgs, output_img, background_val, skip_val, skip_band, overlap_behaviour, gdalformat, datatype, n_threads=1)\n"
+"Create mosaic from list of input images. The mosaic is created tile by tile, with each\n"
+"output tile read from the input images which overlap it and written once.\n"
 "\n"
 "Where\n"
 "\n"
@@ -2109,6 +2216,7 @@ static PyMethodDef ImageUtilsMethods[] = {
 "      * 2 - Overwrite if value of new pixel is higher (maximum)\n"
 ":param gdalformat: is a string providing the gdalformat of the output image (e.g., KEA).\n"
 ":param datatype: is a rsgislib.TYPE_* value providing the data type of the output image.\n"
+":param n_threads: is the number of threads used to create the output tiles (Default: 1).\n"
 "\n"
 ".. code:: python\n"
 "\n"
@@ -2648,6 +2756,21 @@ static PyMethodDef ImageUtilsMethods[] = {
 "\n"
 "\n"},
 
+{"create_max_ndvi_composite_img", (PyCFunction)ImageUtils_CreateMaxNDVICompositeImg, METH_VARARGS | METH_KEYWORDS,
+"rsgislib.imageutils.create_max_ndvi_composite_img(input_imgs=list, output_img=string, r_band=int, n_band=int, gdalformat=string, datatype=int)\n"
+"A function which creates a composite image where each output pixel is taken from the input image with\n"
+"the maximum NDVI. Only pixels where the red and NIR values are both non-zero are considered; where no\n"
+"image has a valid NDVI the pixel is taken from the first image.\n"
+"\n"
+":param input_imgs: is a list of input images, each image must have the same number of bands in the same order.\n"
+":param output_img: is a string with the name and path of the output image.\n"
+":param r_band: is the red image band within the input images (band indexing starts at 1).\n"
+":param n_band: is the NIR image band within the input images (band indexing starts at 1).\n"
+":param gdalformat: is a string with the GDAL output file format.\n"
+":param datatype: is an integer containing one of the values from rsgislib.TYPE_*\n"
+"\n"
+"\n"},
+
 {"create_ref_img_composite_img", (PyCFunction)ImageUtils_CreateRefImageCompositeImg, METH_VARARGS | METH_KEYWORDS,
 "rsgislib.imageutils.create_ref_img_composite_img(input_imgs=list, output_img=string, in_ref_img=string, gdalformat=string, datatype=int, out_no_data=float)\n"
 "A function which creates a composite image where the pixel values going into the output image by the\n"
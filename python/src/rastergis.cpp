@@ -92,6 +92,7 @@ static PyObject *RasterGIS_PopulateStats(PyObject *self, PyObject *args, PyObjec
 
     try
     {
+        RSGISPyReleaseGIL releaseGIL;
         rsgis::cmds::executePopulateStats(std::string(clumpsImage), addColourTable2Img, calcImgPyramids, ignoreZeroVal, ratBand);
     }
     catch (rsgis::cmds::RSGISCmdException &e)
@@ -115,6 +116,7 @@ static PyObject *RasterGIS_CopyRAT(PyObject *self, PyObject *args, PyObject *key
 
     try
     {
+        RSGISPyReleaseGIL releaseGIL;
         rsgis::cmds::executeCopyRAT(std::string(clumpsImage), std::string(inputImage),ratBand);
     }
     catch (rsgis::cmds::RSGISCmdException &e)
@@ -154,6 +156,7 @@ static PyObject *RasterGIS_CopyGDALATTColumns(PyObject *self, PyObject *args, Py
 
     try
     {
+        RSGISPyReleaseGIL releaseGIL;
         rsgis::cmds::executeCopyGDALATTColumns(std::string(inputImage), std::string(clumpsImage), fields, copyColours, copyHist, ratBand);
     }
     catch (rsgis::cmds::RSGISCmdException &e)
@@ -179,6 +182,7 @@ static PyObject *RasterGIS_SpatialLocation(PyObject *self, PyObject *args, PyObj
 
     try
     {
+        RSGISPyReleaseGIL releaseGIL;
         rsgis::cmds::executeSpatialLocation(std::string(inputImage), ratBand, std::string(eastingsField), std::string(northingsField));
     }
     catch (rsgis::cmds::RSGISCmdException &e)
@@ -206,6 +210,7 @@ static PyObject *RasterGIS_SpatialExtent(PyObject *self, PyObject *args, PyObjec
     
     try
     {
+        RSGISPyReleaseGIL releaseGIL;
         rsgis::cmds::executeSpatialLocationExtent(std::string(inputImage), ratBand, std::string(minXXCol), std::string(minXYCol), std::string(maxXXCol), std::string(maxXYCol), std::string(minYXCol), std::string(minYYCol), std::string(maxYXCol), std::string(maxYYCol));
     }
     catch (rsgis::cmds::RSGISCmdException &e)
@@ -222,10 +227,12 @@ static PyObject *RasterGIS_PopulateRATWithStats(PyObject *self, PyObject *args,
     const char *inputImage, *clumpsImage;
     PyObject *pBandAttStatsCmds;
     unsigned int ratBand = 1;
+    unsigned int nThreads = 1;
     static char *kwlist[] = {RSGIS_PY_C_TEXT("input_img"), RSGIS_PY_C_TEXT("clumps_img"),
-                             RSGIS_PY_C_TEXT("band_stats"), RSGIS_PY_C_TEXT("rat_band"), nullptr};
+                             RSGIS_PY_C_TEXT("band_stats"), RSGIS_PY_C_TEXT("rat_band"),
+                             RSGIS_PY_C_TEXT("n_threads"), nullptr};
 
-    if(!PyArg_ParseTupleAndKeywords(args, keywds, "ssO|I:populate_rat_with_stats", kwlist, &inputImage, &clumpsImage, &pBandAttStatsCmds, &ratBand))
+    if(!PyArg_ParseTupleAndKeywords(args, keywds, "ssO|II:populate_rat_with_stats", kwlist, &inputImage, &clumpsImage, &pBandAttStatsCmds, &ratBand, &nThreads))
     {
         return nullptr;
     }
@@ -317,7 +324,8 @@ static PyObject *RasterGIS_PopulateRATWithStats(PyObject *self, PyObject *args,
 
     try
     {
-        rsgis::cmds::executePopulateRATWithStats(std::string(inputImage), std::string(clumpsImage), &bandStatsCmds, ratBand);
+        RSGISPyReleaseGIL releaseGIL;
+        rsgis::cmds::executePopulateRATWithStats(std::string(inputImage), std::string(clumpsImage), &bandStatsCmds, ratBand, nThreads);
     }
     catch (rsgis::cmds::RSGISCmdException &e)
     {
@@ -415,6 +423,7 @@ static PyObject *RasterGIS_PopulateRATWithPercentiles(PyObject *self, PyObject *
 
     try
     {
+        RSGISPyReleaseGIL releaseGIL;
         rsgis::cmds::executePopulateRATWithPercentiles(std::string(inputImage), std::string(clumpsImage), band, &bandPercentilesCmds, ratBand, numHistBins);
     }
     catch (rsgis::cmds::RSGISCmdException &e)
@@ -459,6 +468,7 @@ static PyObject *RasterGIS_PopulateCategoryProportions(PyObject *self, PyObject
 
     try
     {
+        RSGISPyReleaseGIL releaseGIL;
         rsgis::cmds::executePopulateCategoryProportions(std::string(categoriesImage), std::string(clumpsImage), std::string(outColsName), std::string(majorityColName),
                                                         (copyClassNames != 0), std::string(majClassNameField), std::string(classNameField), ratBandClumps, ratBandCats);
     }
@@ -492,6 +502,7 @@ static PyObject *RasterGIS_PopulateRATWithMode(PyObject *self, PyObject *args, P
     
     try
     {
+        RSGISPyReleaseGIL releaseGIL;
         bool useNoDataBool = (bool) useNoDataVal;
         bool outNoDataBool = (bool) outNoDataVal;
         rsgis::cmds::executePopulateRATWithMode(std::string(inputImage), std::string(clumpsImage), std::string(outColsName), useNoDataBool, noDataVal, outNoDataBool, modeBand, ratBand);
@@ -524,6 +535,7 @@ static PyObject *RasterGIS_ExportCol2GDALImage(PyObject *self, PyObject *args, P
 
     try
     {
+        RSGISPyReleaseGIL releaseGIL;
         rsgis::cmds::executeExportCols2GDALImage(std::string(inputImage), std::string(outputFile), std::string(imageFormat), type, std::string(field), ratBand);
     }
     catch (rsgis::cmds::RSGISCmdException &e)
@@ -562,6 +574,7 @@ static PyObject *RasterGIS_Export2Ascii(PyObject *self, PyObject *args, PyObject
 
     try
     {
+        RSGISPyReleaseGIL releaseGIL;
         rsgis::cmds::executeExport2Ascii(std::string(inputImage), std::string(outputFile), fields, ratBand);
     }
     catch (rsgis::cmds::RSGISCmdException &e)
@@ -672,6 +685,7 @@ static PyObject *RasterGIS_ColourClasses(PyObject *self, PyObject *args, PyObjec
 
     try
     {
+        RSGISPyReleaseGIL releaseGIL;
         if(intKet)
         {
             rsgis::cmds::executeColourClasses(std::string(inputImage), std::string(classInField), classPairsInt, ratBand);
@@ -709,6 +723,7 @@ static PyObject *RasterGIS_StrClassMajority(PyObject *self, PyObject *args, PyOb
 
     try
     {
+        RSGISPyReleaseGIL releaseGIL;
         rsgis::cmds::executeStrClassMajority(std::string(baseSegment), std::string(infoSegment), std::string(baseClassCol), std::string(infoClassCol), infoRatBand, baseRatBand, infoRatBand);
     }
     catch (rsgis::cmds::RSGISCmdException &e)
@@ -725,17 +740,19 @@ static PyObject *RasterGIS_FindNeighbours(PyObject *self, PyObject *args, PyObje
 {
     const char *inputImage;
     unsigned int ratBand = 1;
+    unsigned int numThreads = 1;
 
-    static char *kwlist[] = {RSGIS_PY_C_TEXT("clumps_img"), RSGIS_PY_C_TEXT("rat_band"), nullptr};
+    static char *kwlist[] = {RSGIS_PY_C_TEXT("clumps_img"), RSGIS_PY_C_TEXT("rat_band"), RSGIS_PY_C_TEXT("n_threads"), nullptr};
 
-    if(!PyArg_ParseTupleAndKeywords(args, keywds, "s|I:find_neighbours", kwlist, &inputImage, &ratBand))
+    if(!PyArg_ParseTupleAndKeywords(args, keywds, "s|II:find_neighbours", kwlist, &inputImage, &ratBand, &numThreads))
     {
         return nullptr;
     }
 
     try
     {
-        rsgis::cmds::executeFindNeighbours(std::string(inputImage), ratBand);
+        RSGISPyReleaseGIL releaseGIL;
+        rsgis::cmds::executeFindNeighbours(std::string(inputImage), ratBand, numThreads);
     }
     catch (rsgis::cmds::RSGISCmdException &e)
     {
@@ -763,6 +780,7 @@ static PyObject *RasterGIS_FindBoundaryPixels(PyObject *self, PyObject *args, Py
 
     try
     {
+        RSGISPyReleaseGIL releaseGIL;
         rsgis::cmds::executeFindBoundaryPixels(std::string(inputImage), ratBand, std::string(outputFile), std::string(imageFormat));
     }
     catch (rsgis::cmds::RSGISCmdException &e)
@@ -789,6 +807,7 @@ static PyObject *RasterGIS_CalcBorderLength(PyObject *self, PyObject *args, PyOb
 
     try
     {
+        RSGISPyReleaseGIL releaseGIL;
         rsgis::cmds::executeCalcBorderLength(std::string(inputImage), (iIgnoreZeroEdges != 0), std::string(outColsName));
     }
     catch (rsgis::cmds::RSGISCmdException &e)
@@ -817,6 +836,7 @@ static PyObject *RasterGIS_CalcRelBorder(PyObject *self, PyObject *args, PyObjec
 
     try
     {
+        RSGISPyReleaseGIL releaseGIL;
         rsgis::cmds::executeCalcRelBorder(std::string(inputImage), std::string(outColsName), std::string(classNameField), std::string(className), (iIgnoreZeroEdges != 0));
     }
     catch (rsgis::cmds::RSGISCmdException &e)
@@ -845,6 +865,7 @@ static PyObject *RasterGIS_DefineClumpTilePositions(PyObject *self, PyObject *ar
 
     try
     {
+        RSGISPyReleaseGIL releaseGIL;
         rsgis::cmds::executeDefineClumpTilePositions(std::string(clumpsImage), std::string(tileImage), std::string(outColsName), tileOverlap, tileBoundary, tileBody);
     }
     catch (rsgis::cmds::RSGISCmdException &e)
@@ -870,6 +891,7 @@ static PyObject *RasterGIS_DefineBorderClumps(PyObject *self, PyObject *args, Py
 
     try
     {
+        RSGISPyReleaseGIL releaseGIL;
         rsgis::cmds::executeDefineBorderClumps(std::string(clumpsImage), std::string(outColsName));
     }
     catch (rsgis::cmds::RSGISCmdException &e)
@@ -940,6 +962,7 @@ static PyObject *RasterGIS_GetGlobalClassStats(PyObject *self, PyObject *args, P
 
     try
     {
+        RSGISPyReleaseGIL releaseGIL;
         rsgis::cmds::executeGetGlobalClassStats(std::string(clumpsImage), std::string(classField), attFields, classFields, ratBand);
     }
     catch (rsgis::cmds::RSGISCmdException &e)
@@ -970,6 +993,7 @@ static PyObject *RasterGIS_SelectClumpsOnGrid(PyObject *self, PyObject *args, Py
 
     try
     {
+        RSGISPyReleaseGIL releaseGIL;
         rsgis::cmds::executeIdentifyClumpExtremesOnGrid(std::string(clumpsImage), std::string(inSelectField), std::string(outSelectField), std::string(eastingsCol), std::string(northingsCol), std::string(methodStr), rows, cols, std::string(metricField));
     }
     catch (rsgis::cmds::RSGISCmdException &e)
@@ -1063,6 +1087,7 @@ static PyObject *RasterGIS_CalcRelDiffNeighbourStats(PyObject *self, PyObject *a
 
     try
     {
+        RSGISPyReleaseGIL releaseGIL;
         bool useAbsDiffBool = (bool)useAbsDiff;
         rsgis::cmds::executeCalcRelDiffNeighbourStats(std::string(clumpsImage), cmdObj, useAbsDiffBool, ratBand);
     }
@@ -1180,6 +1205,7 @@ static PyObject *RasterGIS_PopulateRATWithMeanLitStats(PyObject *self, PyObject
     
     try
     {
+        RSGISPyReleaseGIL releaseGIL;
         rsgis::cmds::executePopulateRATWithMeanLitStats(std::string(inputImage), std::string(clumpsImage), std::string(meanLitImage), meanlitBand, std::string(meanLitCol), std::string(pxlCountCol), &bandStatsCmds, ratBand);
     }
     catch (rsgis::cmds::RSGISCmdException &e)
@@ -1218,6 +1244,7 @@ static PyObject *RasterGIS_CollapseRAT(PyObject *self, PyObject *args, PyObject
     
     try
     {
+        RSGISPyReleaseGIL releaseGIL;
         rsgis::cmds::executeCollapseRAT(std::string(clumpsImage), ratBand, std::string(selectField), std::string(outputFile), std::string(imageFormat));
     }
     catch (rsgis::cmds::RSGISCmdException &e)
@@ -1262,6 +1289,7 @@ static PyObject *RasterGIS_ImportVecAtts(PyObject *self, PyObject *args, PyObjec
             }
         }
         
+        RSGISPyReleaseGIL releaseGIL;
         rsgis::cmds::executeImportVecAtts(std::string(clumpsImage), ratBand, std::string(vectorFile), std::string(vectorLyrName), std::string(fidColName), colNames);
     }
     catch (rsgis::cmds::RSGISCmdException &e)
@@ -1287,15 +1315,16 @@ static PyObject *RasterGIS_ApplyKNN(PyObject *self, PyObject *args, PyObject *ke
     float distThreshold = 100000;
     int distKNNInt = rsgis::cmds::rsgisKNNMahalanobis;
     int summeriseKNNInt = rsgis::cmds::rsgisKNNMean;
+    unsigned int nThreads = 1;
     
     static char *kwlist[] = {RSGIS_PY_C_TEXT("clumps_img"), RSGIS_PY_C_TEXT("in_extrap_col"),
                              RSGIS_PY_C_TEXT("out_extrap_col"), RSGIS_PY_C_TEXT("train_regions_col"),
                              RSGIS_PY_C_TEXT("apply_regions_col"), RSGIS_PY_C_TEXT("val_cols"),
                              RSGIS_PY_C_TEXT("k_feat"), RSGIS_PY_C_TEXT("dist_knn"),
                              RSGIS_PY_C_TEXT("summerise_knn"), RSGIS_PY_C_TEXT("dist_thres"),
-                             RSGIS_PY_C_TEXT("rat_band"), nullptr};
+                             RSGIS_PY_C_TEXT("rat_band"), RSGIS_PY_C_TEXT("n_threads"), nullptr};
     
-    if(!PyArg_ParseTupleAndKeywords(args, keywds, "ssssOO|IiifI:apply_rat_knn", kwlist, &inClumpsImage, &inExtrapField, &outExtrapField, &trainRegionsField, &applyRegionsFieldObj, &pFields, &kFeatures, &distKNNInt, &summeriseKNNInt, &distThreshold, &ratBand))
+    if(!PyArg_ParseTupleAndKeywords(args, keywds, "ssssOO|IiifII:apply_rat_knn", kwlist, &inClumpsImage, &inExtrapField, &outExtrapField, &trainRegionsField, &applyRegionsFieldObj, &pFields, &kFeatures, &distKNNInt, &summeriseKNNInt, &distThreshold, &ratBand, &nThreads))
     {
         return nullptr;
     }
@@ -1322,10 +1351,11 @@ static PyObject *RasterGIS_ApplyKNN(PyObject *self, PyObject *args, PyObject *ke
     
     try
     {
+        RSGISPyReleaseGIL releaseGIL;
         rsgis::cmds::rsgisKNNDistCmd distKNN = static_cast<rsgis::cmds::rsgisKNNDistCmd>(distKNNInt);
         rsgis::cmds::rsgisKNNSummeriseCmd summeriseKNN = static_cast<rsgis::cmds::rsgisKNNSummeriseCmd>(summeriseKNNInt);
         
-        rsgis::cmds::executeApplyKNN(std::string(inClumpsImage), ratBand, std::string(inExtrapField), std::string(outExtrapField), std::string(trainRegionsField), applyRegionsField, applyRegions, fields, kFeatures, distKNN, distThreshold, summeriseKNN);
+        rsgis::cmds::executeApplyKNN(std::string(inClumpsImage), ratBand, std::string(inExtrapField), std::string(outExtrapField), std::string(trainRegionsField), applyRegionsField, applyRegions, fields, kFeatures, distKNN, distThreshold, summeriseKNN, nThreads);
     }
     catch (rsgis::cmds::RSGISCmdException &e)
     {
@@ -1367,6 +1397,7 @@ static PyObject *RasterGIS_HistoSampling(PyObject *self, PyObject *args, PyObjec
     
     try
     {
+        RSGISPyReleaseGIL releaseGIL;
         rsgis::cmds::executeHistSampling(std::string(inClumpsImage), ratBand, std::string(varCol), std::string(outSelectCol), propOfSample, binWidth, classRestrict, classColumn, std::string(classVal));
     }
     catch (rsgis::cmds::RSGISCmdException &e)
@@ -1410,6 +1441,7 @@ static PyObject *RasterGIS_FitHistGausianMixtureModel(PyObject *self, PyObject *
     
     try
     {
+        RSGISPyReleaseGIL releaseGIL;
         rsgis::cmds::executeFitHistGausianMixtureModel(std::string(inClumpsImage), ratBand, std::string(outH5File), std::string(varCol), binWidth, std::string(classColumn), std::string(classVal), outputHist, outHistFile);
     }
     catch (rsgis::cmds::RSGISCmdException &e)
@@ -1444,6 +1476,7 @@ static PyObject *RasterGIS_ClassSplitFitHistGausianMixtureModel(PyObject *self,
     
     try
     {
+        RSGISPyReleaseGIL releaseGIL;
         rsgis::cmds::executeClassSplitFitHistGausianMixtureModel(std::string(inClumpsImage), ratBand, std::string(outColumn), std::string(varCol), binWidth, std::string(classColumn), std::string(classVal));
     }
     catch (rsgis::cmds::RSGISCmdException &e)
@@ -1473,6 +1506,7 @@ static PyObject *RasterGIS_PopulateRATWithPropValidPxls(PyObject *self, PyObject
     
     try
     {
+        RSGISPyReleaseGIL releaseGIL;
         rsgis::cmds::executeCalcPropOfValidPixelsInClump(std::string(inputImage), std::string(clumpsImage), ratBand, std::string(outColsName), noDataVal);
     }
     catch (rsgis::cmds::RSGISCmdException &e)
@@ -1504,7 +1538,11 @@ static PyObject *RasterGIS_Calc1DJMDistance(PyObject *self, PyObject *args, PyOb
     PyObject *outVal = PyTuple_New(1);
     try
     {
-        double dist = rsgis::cmds::executeCalc1DJMDistance(std::string(clumpsImage), std::string(varCol), binWidth, std::string(classCol), std::string(class1Val), std::string(class2Val), ratBand);
+        double dist = 0;
+        {
+            RSGISPyReleaseGIL releaseGIL;
+            dist = rsgis::cmds::executeCalc1DJMDistance(std::string(clumpsImage), std::string(varCol), binWidth, std::string(classCol), std::string(class1Val), std::string(class2Val), ratBand);
+        }
         
         if(PyTuple_SetItem(outVal, 0, Py_BuildValue("d", dist)) == -1)
         {
@@ -1541,7 +1579,11 @@ static PyObject *RasterGIS_Calc2DJMDistance(PyObject *self, PyObject *args, PyOb
     PyObject *outVal = PyTuple_New(1);
     try
     {
-        double dist = rsgis::cmds::executeCalc2DJMDistance(std::string(clumpsImage), std::string(var1Col), std::string(var2Col), var1BinWidth, var2BinWidth, std::string(classCol), std::string(class1Val), std::string(class2Val), ratBand);
+        double dist = 0;
+        {
+            RSGISPyReleaseGIL releaseGIL;
+            dist = rsgis::cmds::executeCalc2DJMDistance(std::string(clumpsImage), std::string(var1Col), std::string(var2Col), var1BinWidth, var2BinWidth, std::string(classCol), std::string(class1Val), std::string(class2Val), ratBand);
+        }
         
         if(PyTuple_SetItem(outVal, 0, Py_BuildValue("d", dist)) == -1)
         {
@@ -1574,7 +1616,11 @@ static PyObject *RasterGIS_CalcBhattacharyyaDistance(PyObject *self, PyObject *a
     PyObject *outVal = PyTuple_New(1);
     try
     {
-        double dist = rsgis::cmds::executeCalcBhattacharyyaDistance(std::string(clumpsImage), std::string(varCol), std::string(classCol), std::string(class1Val), std::string(class2Val), ratBand);
+        double dist = 0;
+        {
+            RSGISPyReleaseGIL releaseGIL;
+            dist = rsgis::cmds::executeCalcBhattacharyyaDistance(std::string(clumpsImage), std::string(varCol), std::string(classCol), std::string(class1Val), std::string(class2Val), ratBand);
+        }
         
         if(PyTuple_SetItem(outVal, 0, Py_BuildValue("d", dist)) == -1)
         {
@@ -1607,6 +1653,7 @@ static PyObject *RasterGIS_ExportClumps2Images(PyObject *self, PyObject *args, P
     
     try
     {
+        RSGISPyReleaseGIL releaseGIL;
         rsgis::cmds::executeExportClumps2Images(std::string(inputImage), std::string(outputBaseName), std::string(outFileExt), std::string(imageFormat), (bool)binaryOut, ratBand);
     }
     catch (rsgis::cmds::RSGISCmdException &e)
@@ -1739,7 +1786,7 @@ static PyMethodDef RasterGISMethods[] = {
 "\n"},
 
     {"populate_rat_with_stats", (PyCFunction)RasterGIS_PopulateRATWithStats, METH_VARARGS | METH_KEYWORDS,
-"rsgislib.rastergis.populate_rat_with_stats(input_img=string, clumps_img=string, band_stats=rsgislib.rastergis.BandAttStats, rat_band=int)\n"
+"rsgislib.rastergis.populate_rat_with_stats(input_img=string, clumps_img=string, band_stats=rsgislib.rastergis.BandAttStats, rat_band=int, n_threads=int)\n"
 "Populates an attribute table with statistics from an input values image.\n"
 "\n"
 ":param input_img: is a string containing the name of the input image file from which the clumps are to populated.\n"
@@ -1752,6 +1799,7 @@ static PyMethodDef RasterGISMethods[] = {
 "        * mean_field: string defining the name of the field for mean value\n"
 "        * std_dev_field: string defining the name of the field for standard deviation value\n"
 "* rat_band is an optional (default = 1) integer parameter specifying the image band to which the RAT is associated.\n"
+"* n_threads is an optional (default = 1) integer specifying the number of threads used to calculate the statistics. Each thread keeps its own copy of the per clump statistics (~32 bytes per clump per band), which are merged once the image has been read.\n"
 "\n"
 ".. code:: python\n"
 "\n"
@@ -1775,7 +1823,7 @@ static PyMethodDef RasterGISMethods[] = {
 ":param band_stats: is a sequence of objects that have attributes matching rsgislib.rastergis.BandAttPercentiles\n"
 "        * percentile: float defining the percentile to calculate (Valid range is 0 - 100)\n"
 "        * field_name: string defining the name of the field to use for this percentile\n"
-":param n_hist_bins: is an optional (default = 200) integer specifying the number of bins within the histogram (note this governs the accuracy to which percentile can be calculated).\n"
+":param n_hist_bins: is an optional (default = 200) integer specifying the number of bins within the histogram (note this governs the accuracy to which percentile can be calculated; the value returned is the centre of the bin so is within half a bin width of the percentile). The per clump histograms are stored sparsely, so memory use depends on the number of bins which contain values within each clump rather than n_hist_bins.\n"
 ":param rat_band: is an optional (default = 1) integer parameter specifying the image band to which the RAT is associated.\n"
 "\n"
 ".. code:: python\n"
@@ -1808,7 +1856,9 @@ static PyMethodDef RasterGISMethods[] = {
 {"populate_rat_with_mode", (PyCFunction)RasterGIS_PopulateRATWithMode, METH_VARARGS | METH_KEYWORDS,
 "rsgislib.rastergis.populate_rat_with_mode(input_img=string, clumps_img=string, out_cols_name=string, use_no_data=boolean, no_data_val=long, out_no_data=boolean, mode_band=uint, rat_band=uint)\n"
 "Populates the attribute table with the mode of from a single band in the input image.\n"
-"Note this only makes sense if the input pixel values are integers.\n"
+"Note this only makes sense if the input pixel values are integers (within the 32 bit integer range).\n"
+"The per clump histograms are stored sparsely so memory use depends on the number of distinct values within each clump\n"
+"rather than the range of the image values. Clumps without any valid pixels are given the no data value.\n"
 "\n"
 ":param input_img: is a string containing the name of the input image file from which the mode is calculated\n"
 ":param clumps_img: is a string containing the name of the input clump file to which the mode will be populated.\n"
@@ -1907,11 +1957,12 @@ static PyMethodDef RasterGISMethods[] = {
 "\n"},
 
     {"find_neighbours", (PyCFunction)RasterGIS_FindNeighbours, METH_VARARGS | METH_KEYWORDS,
-"rsgislib.rastergis.find_neighbours(clumps_img, rat_band)\n"
+"rsgislib.rastergis.find_neighbours(clumps_img, rat_band, n_threads)\n"
 "Finds the clump neighbours from an image\n"
 "\n"
 ":param clumps_img: is a string containing the name of the input image file\n"
 ":param rat_band: is an int containing band for which the neighbours are to be calculated for (Optional, Default = 1)\n"
+":param n_threads: is an optional int specifying the number of threads used to find and sort the neighbour pairs (Default=1).\n"
 "\n"},
 
     {"find_boundary_pixels", (PyCFunction)RasterGIS_FindBoundaryPixels, METH_VARARGS | METH_KEYWORDS,
@@ -2095,7 +2146,7 @@ static PyMethodDef RasterGISMethods[] = {
 "\n"},
 
 {"apply_rat_knn", (PyCFunction)RasterGIS_ApplyKNN, METH_VARARGS | METH_KEYWORDS,
-"rsgislib.rastergis.apply_rat_knn(clumps_img=string, in_extrap_col=string, out_extrap_col=string, train_regions_col=string, apply_regions_col=string, val_cols=list<string>, k_feat=uint, dist_knn=int, summerise_knn=int, dist_thres=float, rat_band=int)\n"
+"rsgislib.rastergis.apply_rat_knn(clumps_img=string, in_extrap_col=string, out_extrap_col=string, train_regions_col=string, apply_regions_col=string, val_cols=list<string>, k_feat=uint, dist_knn=int, summerise_knn=int, dist_thres=float, rat_band=int, n_threads=int)\n"
 "This function uses the KNN algorithm to allow data values to be extrapolated to segments.\n"
 "\n"
 ":param clumps_img: is a string containing the name of the input clumps image file\n"
@@ -2107,8 +2158,9 @@ static PyMethodDef RasterGISMethods[] = {
 ":param k_feat: is an unsigned integer specifying the number of nearest features (i.e., K) to be used (Default: 12) \n"
 ":param dist_knn: specifies how the distance to identify NN is calculated (rsgislib.DIST_EUCLIDEAN, rsgislib.DIST_MANHATTEN, rsgislib.DIST_MAHALANOBIS, rsgislib.DIST_MINKOWSKI, rsgislib.DIST_CHEBYSHEV; Default: rsgislib.DIST_MAHALANOBIS).\n"
 ":param summerise_knn: specifies how the extrapolation value is calculated (rsgislib.SUMTYPE_MODE, rsgislib.SUMTYPE_MEAN, rsgislib.SUMTYPE_MEDIAN, rsgislib.SUMTYPE_MIN, rsgislib.SUMTYPE_MAX, rsgislib.SUMTYPE_STDDEV; Default: rsgislib.SUMTYPE_MEDIAN). Mode is used for classification.\n"
-":param dist_thres: is a maximum distance threshold over which features will not be included within the \'k\'.\n"
+":param dist_thres: is a maximum distance threshold over which features will not be included within the \'k\'. Clumps without any training samples within the threshold are given NaN.\n"
 ":param rat_band: is an optional (default = 1) integer parameter specifying the image band to which the RAT is associated.\n"
+":param n_threads: is an optional (default = 1) integer specifying the number of threads used to search for the nearest neighbours. The Euclidean, Manhattan and Mahalanobis distances are searched using a kd-tree built over the training samples; the Minkowski and Chebyshev distances use a brute force search on a single thread.\n"
 "\n"
 ".. code:: python\n"
 "\n"
@@ -32,6 +32,28 @@
 
 #define RSGIS_PY_C_TEXT( text ) (const_cast<char*>(text))
 
+// Releases the GIL for the lifetime of the object so other Python threads can
+// run while a long C++ command executes (the equivalent of Py_BEGIN_ALLOW_THREADS
+// and Py_END_ALLOW_THREADS). The GIL is re-acquired when the object goes out of
+// scope, including when an exception is thrown, so it is held again before the
+// catch block sets the Python error. No Python API may be used while it is in scope.
+class RSGISPyReleaseGIL
+{
+public:
+    RSGISPyReleaseGIL()
+    {
+        this->threadState = PyEval_SaveThread();
+    };
+    ~RSGISPyReleaseGIL()
+    {
+        PyEval_RestoreThread(this->threadState);
+    };
+private:
+    RSGISPyReleaseGIL(const RSGISPyReleaseGIL&);
+    RSGISPyReleaseGIL& operator=(const RSGISPyReleaseGIL&);
+    PyThreadState *threadState;
+};
+
 // hides differences between Python2 and 3. 
 // PyString for Python2 - PyUnicode for Python3
 inline bool RSGISPY_CHECK_STRING(PyObject *o)
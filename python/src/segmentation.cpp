@@ -54,6 +54,7 @@ static PyObject *Segmentation_labelPixelsFromClusterCentres(PyObject *self, PyOb
 
     try
     {
+        RSGISPyReleaseGIL releaseGIL;
         rsgis::RSGISLibDataType type = (rsgis::RSGISLibDataType)nDataType;
         rsgis::cmds::executeLabelPixelsFromClusterCentres(std::string(pszInputImage), std::string(pszOutputImage),
                                                           std::string(pszClusterCentres),ignoreZeros,
@@ -85,6 +86,7 @@ static PyObject *Segmentation_eliminateSinglePixels(PyObject *self, PyObject *ar
 
     try
     {
+        RSGISPyReleaseGIL releaseGIL;
         rsgis::cmds::executeEliminateSinglePixels(std::string(pszInputImage), std::string(pszClumpsImage),
                                                   std::string(pszOutputImage), std::string(pszTempImage),
                                                   std::string(pszgdalformat), processInMemory, ignoreZeros);
@@ -103,14 +105,17 @@ static PyObject *Segmentation_clump(PyObject *self, PyObject *args, PyObject *ke
 {
     static char *kwlist[] = {RSGIS_PY_C_TEXT("input_img"), RSGIS_PY_C_TEXT("output_img"),
                              RSGIS_PY_C_TEXT("gdalformat"), RSGIS_PY_C_TEXT("in_memory"),
-                             RSGIS_PY_C_TEXT("no_data_val"), RSGIS_PY_C_TEXT("add_to_rat"),  nullptr};
+                             RSGIS_PY_C_TEXT("no_data_val"), RSGIS_PY_C_TEXT("add_to_rat"),
+                             RSGIS_PY_C_TEXT("use_8_conn"), RSGIS_PY_C_TEXT("n_threads"), nullptr};
     const char *pszInputImage, *pszOutputImage, *pszgdalformat;
     int processInMemory = false;
     bool nodataprovided;
     float fnodata;
     int addRatPxlVals = false;
+    int use8Conn = false;
+    unsigned int nThreads = 1;
     PyObject *pNoData = Py_None; //could be none or a number
-    if( !PyArg_ParseTupleAndKeywords(args, keywds, "sss|iOi:clump", kwlist, &pszInputImage, &pszOutputImage, &pszgdalformat, &processInMemory, &pNoData, &addRatPxlVals))
+    if( !PyArg_ParseTupleAndKeywords(args, keywds, "sss|iOiiI:clump", kwlist, &pszInputImage, &pszOutputImage, &pszgdalformat, &processInMemory, &pNoData, &addRatPxlVals, &use8Conn, &nThreads))
     {
         return nullptr;
     }
@@ -137,8 +142,9 @@ static PyObject *Segmentation_clump(PyObject *self, PyObject *args, PyObject *ke
 
     try
     {
+        RSGISPyReleaseGIL releaseGIL;
         rsgis::cmds::executeClump(std::string(pszInputImage), std::string(pszOutputImage), std::string(pszgdalformat),
-                                processInMemory, nodataprovided, fnodata, addRatPxlVals);
+                                processInMemory, nodataprovided, fnodata, addRatPxlVals, (bool)use8Conn, nThreads);
     }
     catch(rsgis::cmds::RSGISCmdException &e)
     {
@@ -169,6 +175,7 @@ static PyObject *Segmentation_RMSmallClumpsStepwise(PyObject *self, PyObject *ar
 
     try
     {
+        RSGISPyReleaseGIL releaseGIL;
         rsgis::cmds::executeRMSmallClumpsStepwise(std::string(pszInputImage), std::string(pszClumpsImage),
                                                   std::string(pszOutputImage), std::string(pszgdalformat),
                                                   stretchStatsAvail, pszStretchStatsFile, storeMean,
@@ -198,6 +205,7 @@ static PyObject *Segmentation_relabelClumps(PyObject *self, PyObject *args, PyOb
 
     try
     {
+        RSGISPyReleaseGIL releaseGIL;
         rsgis::cmds::executeRelabelClumps(std::string(pszInputImage), std::string(pszOutputImage),
                                           std::string(pszgdalformat), processInMemory);
     }
@@ -275,6 +283,7 @@ static PyObject *Segmentation_unionOfClumps(PyObject *self, PyObject *args, PyOb
 
     try
     {
+        RSGISPyReleaseGIL releaseGIL;
         rsgis::cmds::executeUnionOfClumps(inputImagePaths, std::string(pszOutputImage),
                                           std::string(pszgdalformat), nodataprovided, fnodata, addRatPxlVals);
     }
@@ -331,6 +340,7 @@ static PyObject *Segmentation_mergeSegmentationTiles(PyObject *self, PyObject *a
 
     try
     {
+        RSGISPyReleaseGIL releaseGIL;
         rsgis::cmds::executeMergeSegmentationTiles(std::string(pszOutputImage), std::string(pszBorderMaskImage),
                                                    inputImagePaths, tileBoundary, tileOverlap, tileBody, std::string(pszColsName));
     }
@@ -382,6 +392,7 @@ static PyObject *Segmentation_mergeClumpImages(PyObject *self, PyObject *args, P
 
     try
     {
+        RSGISPyReleaseGIL releaseGIL;
         rsgis::cmds::executeMergeClumpImages(inputImagePaths, std::string(pszOutputImage), mergeRATs);
     }
     catch(rsgis::cmds::RSGISCmdException &e)
@@ -436,6 +447,7 @@ static PyObject *Segmentation_findTileBordersMask(PyObject *self, PyObject *args
 
     try
     {
+        RSGISPyReleaseGIL releaseGIL;
 
         rsgis::cmds::executeFindTileBordersMask(inputImagePaths, std::string(pszBorderMaskImage),
                         tileBoundary, tileOverlap, tileBody, std::string(pszColsName));
@@ -464,6 +476,7 @@ static PyObject *Segmentation_rmSmallClumps(PyObject *self, PyObject *args, PyOb
 
     try
     {
+        RSGISPyReleaseGIL releaseGIL;
         rsgis::cmds::executeRMSmallClumps(std::string(pszInputClumps), std::string(pszOutputClumps), areaThreshold, std::string(pszgdalformat));
     }
     catch(rsgis::cmds::RSGISCmdException &e)
@@ -490,6 +503,7 @@ static PyObject *Segmentation_meanImage(PyObject *self, PyObject *args, PyObject
 
     try
     {
+        RSGISPyReleaseGIL releaseGIL;
         rsgis::RSGISLibDataType type = (rsgis::RSGISLibDataType)nDataType;
         rsgis::cmds::executeMeanImage(std::string(pszInputImage), std::string(pszInputClumps), std::string(pszOutputImage),
                                       std::string(pszgdalformat), type, false);
@@ -519,6 +533,7 @@ static PyObject *Segmentation_GenerateRegularGrid(PyObject *self, PyObject *args
 
     try
     {
+        RSGISPyReleaseGIL releaseGIL;
         rsgis::cmds::executeGenerateRegularGrid(std::string(pszInputImage), std::string(pszOutputImage),
                                                 std::string(pszgdalformat), numXPxls, numYPxls, (bool)offset);
     }
@@ -545,6 +560,7 @@ static PyObject *Segmentation_IncludeRegionsInClumps(PyObject *self, PyObject *a
 
     try
     {
+        RSGISPyReleaseGIL releaseGIL;
         rsgis::cmds::executeIncludeClumpedRegion(std::string(pszClumpsImage), std::string(pszRegionsImage),
                                                  std::string(pszOutputImage), std::string(pszgdalformat));
     }
@@ -571,6 +587,7 @@ static PyObject *Segmentation_mergeSegments2Neighbours(PyObject *self, PyObject
 
     try
     {
+        RSGISPyReleaseGIL releaseGIL;
         rsgis::cmds::executeMergeSelectClumps2Neighbour(std::string(pszInputSpecImage), std::string(pszInputClumpsImage),
                                                         std::string(pszOutputImage), std::string(pszgdalformat),
                                                         std::string(selectClumpsCol), std::string(noDataClumpsCol));
@@ -597,6 +614,7 @@ static PyObject *Segmentation_dropSelectedSegments(PyObject *self, PyObject *arg
 
     try
     {
+        RSGISPyReleaseGIL releaseGIL;
         rsgis::cmds::executeDropSelectedClumps(std::string(pszInputClumpsImage), std::string(pszOutputImage),
                                                std::string(pszgdalformat), std::string(selectClumpsCol));
     }
@@ -643,6 +661,7 @@ static PyObject *Segmentation_mergeEquivalentClumps(PyObject *self, PyObject *ar
 
     try
     {
+        RSGISPyReleaseGIL releaseGIL;
         rsgis::cmds::executeMergeClumpsEquivalentVal(std::string(pszInputClumpsImage), std::string(pszOutputImage),
                                                      std::string(pszgdalformat), cols);
     }
@@ -686,7 +705,7 @@ static PyMethodDef SegmentationMethods[] = {
 "\n"},
 
     {"clump", (PyCFunction)Segmentation_clump, METH_VARARGS | METH_KEYWORDS,
-"segmentation.clump(input_img, output_img, gdalformat, in_memory, no_data_val, add_to_rat)\n"
+"segmentation.clump(input_img, output_img, gdalformat, in_memory, no_data_val, add_to_rat, use_8_conn, n_threads)\n"
 "A function which clumps an input image (of int pixel data type) to identify connected independent sets of pixels.\n"
 "\n"
 ":param input_img: is a string containing the name of the input file\n"
@@ -695,6 +714,8 @@ static PyMethodDef SegmentationMethods[] = {
 ":param in_memory: is a bool specifying if processing should be carried out in memory (faster if sufficient RAM is available, set to False if unsure).\n"
 ":param no_data_val: is None or float\n"
 ":param add_to_rat: is a boolean specifying whether the pixel value (from input_img) should be added as a RAT (Column Name: PixelVal).\n"
+":param use_8_conn: is a boolean specifying whether diagonal neighbours are connected (8-connectivity) rather than only the 4 direct neighbours (Default=False).\n"
+":param n_threads: is an optional int specifying the number of threads used to label the image. If greater than 1 strips of the image are labelled in parallel and merged; the output is the same as for a single thread (Default=1).\n"
 "\n"},
 
     {"rm_small_clumps_stepwise", (PyCFunction)Segmentation_RMSmallClumpsStepwise, METH_VARARGS | METH_KEYWORDS,
@@ -62,6 +62,7 @@ static PyObject *SpecUnmix_ExhconLinearSpecUnmix(PyObject *self, PyObject *args,
 
     try
     {
+        RSGISPyReleaseGIL releaseGIL;
         rsgis::cmds::executeExhconLinearSpecUnmix(inputImage, imageFormat, type, lsumGain, lsumOffset, outputFile, endmembersFile, stepResolution);
     }
     catch (rsgis::cmds::RSGISCmdException &e)
@@ -87,6 +88,7 @@ static PyObject *SpecUnmix_ExtractAvgEndMembers(PyObject *self, PyObject *args,
 
     try
     {
+        RSGISPyReleaseGIL releaseGIL;
         rsgis::cmds::executeExtractAvgEndMembers(std::string(pszInputImage), std::string(pszInputVector),
                                                  std::string(pszInputVecLyr), std::string(pszOutputMatrix), pixelInPolyMethod);
     }
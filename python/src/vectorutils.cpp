@@ -129,6 +129,7 @@ static PyObject *VectorUtils_VectorMaths(PyObject *self, PyObject *args, PyObjec
 
     try
     {
+        RSGISPyReleaseGIL releaseGIL;
         rsgis::cmds::executeVectorMaths(std::string(pszInputVectorFile), std::string(pszInputVectorLyr),
                                         std::string(pszOutputVectorFile), std::string(pszOutputVectorLyr),
                                         std::string(pszOutFormat), std::string(pszOutColName),
@@ -163,6 +164,7 @@ static PyObject *VectorUtils_CreateLinesOfPoints(PyObject *self, PyObject *args,
     
     try
     {
+        RSGISPyReleaseGIL releaseGIL;
         rsgis::cmds::executeCreateLinesOfPoints(std::string(pszInputVectorFile), std::string(pszInputVectorLyr),
                                                 std::string(pszOutputVectorFile), std::string(pszOutputVectorLyr),
                                                 std::string(pszOutFormat), step, (bool)delExistVec);
@@ -194,6 +196,7 @@ static PyObject *VectorUtils_CheckValidateGeometries(PyObject *self, PyObject *a
 
     try
     {
+        RSGISPyReleaseGIL releaseGIL;
         bool printGeomErrs = (bool) printGeomErrsInt;
         rsgis::cmds::executeCheckValidateGeometries(std::string(pszInputVectorFile), std::string(pszInputVectorLyr),
                                                     std::string(pszOutputVectorFile), std::string(pszOutputVectorLyr),
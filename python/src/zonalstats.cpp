@@ -59,6 +59,7 @@ static PyObject *ZonalStats_ImageZoneToHDF(PyObject *self, PyObject *args, PyObj
         return nullptr;
     try
     {
+        RSGISPyReleaseGIL releaseGIL;
         rsgis::cmds::executeZonesImage2HDF5(std::string(pszInputImage), std::string(pszInputVector), std::string(pszInputVecLyr),
                                             std::string(pszOutputHDF), (bool)noProjWarning, pixelInPolyMethod);
     }
@@ -93,6 +94,7 @@ static PyObject *ZonalStats_ExtractZoneImageValues2HDF(PyObject *self, PyObject
 
     try
     {
+        RSGISPyReleaseGIL releaseGIL;
         rsgis::cmds::executeImageRasterZone2HDF(std::string(pszInputImage), std::string(pszInputMaskImage),
                                                 std::string(pszOutputFile), maskValue, type);
     }
@@ -191,6 +193,7 @@ static PyObject *ZonalStats_ExtractZoneImageBandValues2HDF(PyObject *self, PyObj
 
     try
     {
+        RSGISPyReleaseGIL releaseGIL;
         rsgis::cmds::executeImageBandRasterZone2HDF(imageFilesInfo, std::string(pszInputMaskImage),
                                                     std::string(pszOutputFile), maskValue, type);
     }
@@ -223,6 +226,7 @@ static PyObject *ZonalStats_RandomSampleHDF5File(PyObject *self, PyObject *args,
 
     try
     {
+        RSGISPyReleaseGIL releaseGIL;
         rsgis::cmds::executeRandomSampleH5File(std::string(pInputH5), std::string(pOutputH5), sampleSize, seed, type);
     }
     catch(rsgis::cmds::RSGISCmdException &e)
@@ -255,6 +259,7 @@ static PyObject *ZonalStats_SplitSampleHDF5File(PyObject *self, PyObject *args,
 
     try
     {
+        RSGISPyReleaseGIL releaseGIL;
         rsgis::cmds::executeSplitSampleH5File(std::string(pInputH5), std::string(pOutputP1H5), std::string(pOutputP2H5), sampleSize, seed, type);
     }
     catch(rsgis::cmds::RSGISCmdException &e)
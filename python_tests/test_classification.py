@@ -498,6 +498,112 @@ def test_generate_stratified_random_accuracy_pts_pxllst(tmp_path):
     assert os.path.exists(out_vec_file) and (n_pts > 0)
 
 
+def _read_acc_pts_cls_img_vals(input_img, rat_class_col, out_vec_file, out_vec_lyr):
+    # Returns the location and class of each point, along with the class of
+    # the image pixel the point falls within.
+    from osgeo import gdal
+    from osgeo import ogr
+
+    img_ds = gdal.Open(input_img)
+    img_band = img_ds.GetRasterBand(1)
+    img_arr = img_band.ReadAsArray()
+    rat = img_band.GetDefaultRAT()
+    cls_col_idx = [
+        rat.GetNameOfCol(i) for i in range(rat.GetColumnCount())
+    ].index(rat_class_col)
+    rat_cls_names = [
+        rat.GetValueAsString(i, cls_col_idx).strip() for i in range(rat.GetRowCount())
+    ]
+    tl_x, x_res, _, tl_y, _, y_res = img_ds.GetGeoTransform()
+    img_ds = None
+
+    pts = list()
+    vec_ds = ogr.Open(out_vec_file)
+    vec_lyr = vec_ds.GetLayerByName(out_vec_lyr)
+    for feat in vec_lyr:
+        geom = feat.GetGeometryRef()
+        x_pxl = int((geom.GetX() - tl_x) / x_res)
+        y_pxl = int((geom.GetY() - tl_y) / y_res)
+        img_cls = rat_cls_names[img_arr[y_pxl, x_pxl]]
+        pts.append((geom.GetX(), geom.GetY(), feat.GetField("gmw_v2_cls"), img_cls))
+    vec_ds = None
+    return pts
+
+
+@pytest.mark.skipif(ON_MACOS, reason="skipping MacOS due to KEA/HDF5 issues")
+def test_generate_stratified_random_accuracy_pts_pxllst_threads(tmp_path):
+    import collections
+    import rsgislib.classification
+
+    input_img = os.path.join(CLASSIFICATION_DATA_DIR, "gmw_acc_roi_1_cls.kea")
+
+    thread_pts = dict()
+    for n_threads in [1, 2, 4]:
+        out_vec_file = os.path.join(tmp_path, f"out_vecs_{n_threads}.gpkg")
+        out_vec_lyr = "out_vecs"
+        rsgislib.classification.generate_stratified_random_accuracy_pts(
+            input_img,
+            out_vec_file,
+            out_vec_lyr,
+            "GPKG",
+            "cls_name",
+            "gmw_v2_cls",
+            "ref_cls",
+            500,
+            42,
+            False,
+            True,
+            n_threads,
+        )
+        thread_pts[n_threads] = _read_acc_pts_cls_img_vals(
+            input_img, "cls_name", out_vec_file, out_vec_lyr
+        )
+
+    pts = thread_pts[1]
+    assert thread_pts[2] == pts
+    assert thread_pts[4] == pts
+    # Every class has the requested number of points, none repeated, and
+    # each point is within a pixel of its class.
+    cls_counts = collections.Counter([pt[2] for pt in pts])
+    assert len(cls_counts) > 1
+    assert all([cls_count == 500 for cls_count in cls_counts.values()])
+    assert len(set([(pt[0], pt[1]) for pt in pts])) == len(pts)
+    assert all([pt[2] == pt[3] for pt in pts])
+
+
+@pytest.mark.skipif(ON_MACOS, reason="skipping MacOS due to KEA/HDF5 issues")
+def test_generate_stratified_prop_random_accuracy_pts_threads(tmp_path):
+    import rsgislib.classification
+
+    input_img = os.path.join(CLASSIFICATION_DATA_DIR, "gmw_acc_roi_1_cls.kea")
+
+    thread_pts = dict()
+    for n_threads in [1, 3]:
+        out_vec_file = os.path.join(tmp_path, f"out_vecs_{n_threads}.gpkg")
+        out_vec_lyr = "out_vecs"
+        rsgislib.classification.generate_stratified_prop_random_accuracy_pts(
+            input_img,
+            out_vec_file,
+            out_vec_lyr,
+            "GPKG",
+            "cls_name",
+            "gmw_v2_cls",
+            "ref_cls",
+            100,
+            10,
+            42,
+            False,
+            n_threads,
+        )
+        thread_pts[n_threads] = _read_acc_pts_cls_img_vals(
+            input_img, "cls_name", out_vec_file, out_vec_lyr
+        )
+
+    assert len(thread_pts[1]) > 0
+    assert thread_pts[3] == thread_pts[1]
+    assert all([pt[2] == pt[3] for pt in thread_pts[1]])
+
+
 @pytest.mark.skipif(ON_MACOS, reason="skipping MacOS due to KEA/HDF5 issues")
 def test_generate_stratified_prop_random_accuracy_pts(tmp_path):
     import rsgislib.classification
@@ -1,4 +1,6 @@
 import os
+import math
+import pytest
 
 DATA_DIR = os.path.join(os.path.dirname(os.path.abspath(__file__)), "data", "elevation")
 
@@ -126,6 +128,138 @@ def test_fill_dem_soille_gratin_1994(tmp_path):
     assert img_eq
 
 
+def test_fill_dem_priority_flood_tiled(tmp_path):
+    import rsgislib.elevation
+    import rsgislib.imagecalc
+
+    input_img = os.path.join(DATA_DIR, "SRTM_aber.tif")
+    valid_mask_img = os.path.join(DATA_DIR, "SRTM_aber_valid_mask.tif")
+    output_img = os.path.join(tmp_path, "out_fill_priority_flood_tmpout.tif")
+    rsgislib.elevation.fill_dem_priority_flood(
+        input_img, output_img, "GTIFF", in_vld_img=valid_mask_img
+    )
+    output_tiled_img = os.path.join(
+        tmp_path, "out_fill_priority_flood_tiled_tmpout.tif"
+    )
+    rsgislib.elevation.fill_dem_priority_flood(
+        input_img, output_tiled_img, "GTIFF", in_vld_img=valid_mask_img, tile_size=50
+    )
+
+    img_eq, prop_match = rsgislib.imagecalc.are_imgs_equal(output_img, output_tiled_img)
+    assert img_eq
+
+
+def _read_elev_test_img(img_file):
+    import numpy
+    from osgeo import gdal
+
+    img_ds = gdal.Open(img_file)
+    img_band = img_ds.GetRasterBand(1)
+    img_arr = img_band.ReadAsArray().astype(numpy.float64)
+    no_data_val = img_band.GetNoDataValue()
+    img_ds = None
+    return img_arr, no_data_val
+
+
+def _create_elev_test_mask(ref_img, mask_file, mask_arr):
+    import numpy
+    from osgeo import gdal
+
+    ref_ds = gdal.Open(ref_img)
+    driver = gdal.GetDriverByName("GTiff")
+    mask_ds = driver.Create(
+        mask_file, ref_ds.RasterXSize, ref_ds.RasterYSize, 1, gdal.GDT_Byte
+    )
+    mask_ds.SetGeoTransform(ref_ds.GetGeoTransform())
+    mask_ds.SetProjection(ref_ds.GetProjection())
+    mask_ds.GetRasterBand(1).WriteArray(mask_arr.astype(numpy.uint8))
+    mask_ds = None
+    ref_ds = None
+
+
+def _get_elev_test_valid(dem_arr, dem_no_data, mask_arr):
+    import numpy
+
+    valid_arr = (mask_arr == 1) & numpy.isfinite(dem_arr)
+    if dem_no_data is not None:
+        valid_arr = valid_arr & (dem_arr != dem_no_data)
+    return valid_arr
+
+
+def test_fill_dem_priority_flood_soille_gratin(tmp_path):
+    import numpy
+    import rsgislib.elevation
+
+    input_img = os.path.join(DATA_DIR, "SRTM_aber.tif")
+    valid_mask_img = os.path.join(DATA_DIR, "SRTM_aber_valid_mask.tif")
+    dem_arr, dem_no_data = _read_elev_test_img(input_img)
+    mask_arr, _ = _read_elev_test_img(valid_mask_img)
+
+    # Soille-Gratin only drains to pixels outside the valid region, while
+    # Priority-Flood also drains to the image edge, so the valid region is
+    # kept away from the image edge and excludes the DEM no data pixels.
+    valid_arr = _get_elev_test_valid(dem_arr, dem_no_data, mask_arr)
+    valid_arr[0, :] = False
+    valid_arr[-1, :] = False
+    valid_arr[:, 0] = False
+    valid_arr[:, -1] = False
+    test_mask_img = os.path.join(tmp_path, "fill_valid_mask.tif")
+    _create_elev_test_mask(input_img, test_mask_img, valid_arr)
+
+    sg_out_img = os.path.join(tmp_path, "out_fill_soille_gratin_1994.tif")
+    rsgislib.elevation.fill_dem_soille_gratin_1994(
+        input_img, test_mask_img, sg_out_img, "GTIFF"
+    )
+    pf_out_img = os.path.join(tmp_path, "out_fill_priority_flood.tif")
+    rsgislib.elevation.fill_dem_priority_flood(
+        input_img, pf_out_img, "GTIFF", in_vld_img=test_mask_img
+    )
+
+    sg_out_arr, _ = _read_elev_test_img(sg_out_img)
+    pf_out_arr, _ = _read_elev_test_img(pf_out_img)
+    assert numpy.any(pf_out_arr[valid_arr] > dem_arr[valid_arr])
+    numpy.testing.assert_array_equal(pf_out_arr[valid_arr], sg_out_arr[valid_arr])
+
+
+def test_fill_dem_priority_flood_epsilon(tmp_path):
+    import numpy
+    import rsgislib.elevation
+
+    input_img = os.path.join(DATA_DIR, "SRTM_aber.tif")
+    valid_mask_img = os.path.join(DATA_DIR, "SRTM_aber_valid_mask.tif")
+    output_img = os.path.join(tmp_path, "out_fill_priority_flood_epsilon.tif")
+    rsgislib.elevation.fill_dem_priority_flood(
+        input_img, output_img, "GTIFF", in_vld_img=valid_mask_img, epsilon=True
+    )
+
+    dem_arr, dem_no_data = _read_elev_test_img(input_img)
+    mask_arr, _ = _read_elev_test_img(valid_mask_img)
+    out_arr, _ = _read_elev_test_img(output_img)
+    valid_arr = _get_elev_test_valid(dem_arr, dem_no_data, mask_arr)
+    assert numpy.all(out_arr[valid_arr] >= dem_arr[valid_arr])
+
+    # The drain pixels are the valid pixels on the image edge or next to an
+    # invalid pixel; every other valid pixel must have a strictly lower valid
+    # neighbour, so no flats (or pits) are left.
+    pad_valid_arr = numpy.pad(valid_arr, 1, mode="constant", constant_values=False)
+    pad_out_arr = numpy.pad(out_arr, 1, mode="constant", constant_values=numpy.inf)
+    pad_out_arr[~pad_valid_arr] = numpy.inf
+    n_rows, n_cols = out_arr.shape
+    drain_arr = numpy.zeros_like(valid_arr)
+    min_nbr_arr = numpy.full(out_arr.shape, numpy.inf)
+    for d_y in [-1, 0, 1]:
+        for d_x in [-1, 0, 1]:
+            if (d_y == 0) and (d_x == 0):
+                continue
+            nbr_rows = slice(1 + d_y, 1 + d_y + n_rows)
+            nbr_cols = slice(1 + d_x, 1 + d_x + n_cols)
+            drain_arr = drain_arr | ~pad_valid_arr[nbr_rows, nbr_cols]
+            min_nbr_arr = numpy.minimum(min_nbr_arr, pad_out_arr[nbr_rows, nbr_cols])
+    inner_arr = valid_arr & ~drain_arr
+    assert numpy.any(out_arr[inner_arr] > dem_arr[inner_arr])
+    assert numpy.all(min_nbr_arr[inner_arr] < out_arr[inner_arr])
+
+
 def test_plane_fit_detreat_dem(tmp_path):
     import rsgislib.elevation
     import rsgislib.imagecalc
@@ -167,6 +301,177 @@ def test_shadow_mask(tmp_path):
     assert img_eq
 
 
+def _create_shadow_test_dem(dem_file, dem_arr, tl_x, tl_y, res):
+    import numpy
+    from osgeo import gdal
+
+    driver = gdal.GetDriverByName("GTiff")
+    dem_ds = driver.Create(
+        dem_file, dem_arr.shape[1], dem_arr.shape[0], 1, gdal.GDT_Float32
+    )
+    dem_ds.SetGeoTransform((tl_x, res, 0.0, tl_y, 0.0, -res))
+    dem_band = dem_ds.GetRasterBand(1)
+    dem_band.WriteArray(dem_arr.astype(numpy.float32))
+    dem_band.SetNoDataValue(-9999)
+    dem_ds = None
+
+
+def _calc_ref_shadow_mask(
+    dem_arr, tl_x, tl_y, res, azimuth, zenith, max_height, float_trig
+):
+    import numpy
+
+    # The pixels facing away from the sun (from the slope and aspect of the
+    # window, zero padded beyond the image) and those where a ray traced
+    # towards the sun, one step at a time without the horizon sweep, passes
+    # below the DEM. The angles are float32 and float_trig selects whether
+    # the sin/cos of the ray steps are calculated as float32 or float64.
+    height, width = dem_arr.shape
+    dem_arr = dem_arr.astype(numpy.float32).astype(numpy.float64)
+    azimuth = float(numpy.float32(azimuth))
+    zenith = float(numpy.float32(zenith))
+    max_height = float(numpy.float32(max_height))
+    deg_to_rad = math.pi / 180.0
+
+    pad_arr = numpy.pad(dem_arr, 1, mode="constant", constant_values=0)
+
+    def _win(row, col):
+        return pad_arr[row : row + height, col : col + width]
+
+    left = _win(0, 0) + _win(1, 0) + _win(1, 0) + _win(2, 0)
+    right = _win(0, 2) + _win(1, 2) + _win(1, 2) + _win(2, 2)
+    top = _win(0, 0) + _win(0, 1) + _win(0, 1) + _win(0, 2)
+    bottom = _win(2, 0) + _win(2, 1) + _win(2, 1) + _win(2, 2)
+    dx_slope = (left - right) / res
+    dy_slope = (bottom - top) / res
+    slope = numpy.arctan(numpy.sqrt((dx_slope * dx_slope) + (dy_slope * dy_slope)) / 8)
+    dx_aspect = (right - left) / res
+    dy_aspect = (bottom - top) / res
+    aspect = numpy.arctan2(-dx_aspect, dy_aspect) * (180.0 / math.pi)
+    aspect[aspect < 0] += 360.0
+    aspect[aspect == 360.0] = 0.0
+    aspect = aspect * deg_to_rad
+    flat_arr = (dx_aspect == 0) & (dy_aspect == 0)
+    ic = (math.cos(zenith * deg_to_rad) * numpy.cos(slope)) + (
+        math.sin(zenith * deg_to_rad)
+        * numpy.sin(slope)
+        * numpy.cos((azimuth * deg_to_rad) - aspect)
+    )
+    mask_arr = (~flat_arr) & (ic < 0)
+
+    az_trans = (360 - azimuth) + 90
+    if az_trans > 360:
+        az_trans = az_trans - 360
+    az_rad = float(numpy.float32(az_trans * deg_to_rad))
+    zen_rad = float(numpy.float32(zenith * deg_to_rad))
+    trig_vals = [
+        math.sin(zen_rad),
+        math.cos(zen_rad),
+        math.sin(az_rad),
+        math.cos(az_rad),
+    ]
+    if float_trig:
+        trig_vals = [float(numpy.float32(val)) for val in trig_vals]
+    sin_zen, cos_zen, sin_az, cos_az = trig_vals
+    x_step = (res * sin_zen * cos_az) / 3
+    y_step = (res * sin_zen * sin_az) / 3
+    z_step = (res * cos_zen) / 3
+
+    x_min = tl_x
+    x_max = tl_x + width * res
+    y_max = tl_y
+    y_min = tl_y + height * -res
+
+    rows, cols = numpy.nonzero((~flat_arr) & (~mask_arr))
+    pxl_min_x = tl_x + cols * res
+    pxl_max_y = tl_y - rows * res
+    x_vals = pxl_min_x + ((pxl_min_x + res) - pxl_min_x) / 2
+    y_vals = (pxl_max_y - res) + (pxl_max_y - (pxl_max_y - res)) / 2
+    z_vals = dem_arr[rows, cols]
+    x_pxls_prev = ((x_vals - x_min) / res).astype(numpy.int64)
+    y_pxls_prev = ((y_max - y_vals) / res).astype(numpy.int64)
+    shadow = numpy.zeros(rows.shape[0], dtype=bool)
+    active = numpy.ones(rows.shape[0], dtype=bool)
+    while numpy.any(active):
+        idxs = numpy.nonzero(active)[0]
+        x_vals[idxs] += x_step
+        y_vals[idxs] += y_step
+        z_vals[idxs] += z_step
+        x = x_vals[idxs]
+        y = y_vals[idxs]
+        z = z_vals[idxs]
+        at_edge = (x < x_min) | (x > x_max) | (y > y_max) | (y < y_min)
+        active[idxs[at_edge]] = False
+        idxs = idxs[~at_edge]
+        x = x[~at_edge]
+        y = y[~at_edge]
+        z = z[~at_edge]
+        x_pxls = ((x - x_min) / res).astype(numpy.int64)
+        y_pxls = ((y_max - y) / res).astype(numpy.int64)
+        new_pxl = (x_pxls != x_pxls_prev[idxs]) | (y_pxls != y_pxls_prev[idxs])
+        in_img = new_pxl & (x_pxls < width) & (y_pxls < height)
+        blocked = numpy.zeros(idxs.shape[0], dtype=bool)
+        blocked[in_img] = z[in_img] < dem_arr[y_pxls[in_img], x_pxls[in_img]]
+        shadow[idxs[blocked]] = True
+        active[idxs[blocked]] = False
+        x_pxls_prev[idxs] = x_pxls
+        y_pxls_prev[idxs] = y_pxls
+        active[idxs[z > max_height]] = False
+    mask_arr[rows[shadow], cols[shadow]] = True
+    return mask_arr.astype(numpy.uint8)
+
+
+# The ray moves furthest along the rows for the azimuths 20, 160, 200 and 340,
+# and along the columns for 70, 110, 250 and 290, so the horizon sweep is row
+# and column major within each quadrant.
+@pytest.mark.parametrize("zenith", [55.0, 75.0])
+@pytest.mark.parametrize(
+    "azimuth", [20.0, 70.0, 110.0, 160.0, 200.0, 250.0, 290.0, 340.0]
+)
+def test_shadow_mask_ref_ray_trace(tmp_path, azimuth, zenith):
+    import numpy
+    import rsgislib.elevation
+
+    # Hills of different sizes and heights, with some noise.
+    rng = numpy.random.default_rng(42)
+    height, width = 45, 60
+    rows, cols = numpy.mgrid[0:height, 0:width]
+    dem_arr = numpy.full((height, width), 20.0)
+    for hill_row, hill_col, hill_height, hill_size in [
+        (10, 12, 350.0, 4.0),
+        (30, 40, 250.0, 7.0),
+        (35, 8, 150.0, 3.0),
+        (8, 50, 400.0, 2.5),
+        (22, 28, 120.0, 10.0),
+    ]:
+        dist_sq = ((rows - hill_row) ** 2) + ((cols - hill_col) ** 2)
+        dem_arr += hill_height * numpy.exp(-dist_sq / (2 * hill_size * hill_size))
+    dem_arr += rng.uniform(0.0, 5.0, dem_arr.shape)
+    dem_arr = dem_arr.astype(numpy.float32)
+
+    tl_x = 350000.0
+    tl_y = 280000.0
+    res = 30.0
+    max_height = 1000.0
+    dem_img = os.path.join(tmp_path, "dem.tif")
+    _create_shadow_test_dem(dem_img, dem_arr, tl_x, tl_y, res)
+
+    output_img = os.path.join(tmp_path, "shadow_mask.tif")
+    rsgislib.elevation.shadow_mask(
+        dem_img, output_img, azimuth, zenith, max_height, "GTIFF"
+    )
+    out_arr = _read_elev_test_img(output_img)[0]
+
+    ref_f32_arr = _calc_ref_shadow_mask(
+        dem_arr, tl_x, tl_y, res, azimuth, zenith, max_height, True
+    )
+    ref_f64_arr = _calc_ref_shadow_mask(
+        dem_arr, tl_x, tl_y, res, azimuth, zenith, max_height, False
+    )
+    assert numpy.sum(ref_f64_arr) > 0
+    assert numpy.all((out_arr == ref_f32_arr) | (out_arr == ref_f64_arr))
+
+
 def test_local_incidence_angle(tmp_path):
     import rsgislib.elevation
     import rsgislib.imagecalc
@@ -1,4 +1,5 @@
 import os
+import pytest
 
 DATA_DIR = os.path.join(
     os.path.dirname(os.path.abspath(__file__)), "data", "imagemorphology"
@@ -313,3 +314,101 @@ def test_image_white_top_hat(tmp_path):
     img_eq, prop_match = rsgislib.imagecalc.are_imgs_equal(ref_img, output_img)
     print(prop_match)
     assert img_eq
+
+
+def _create_morph_test_img(img_file, n_cols, n_rows):
+    import numpy
+    from osgeo import gdal
+
+    rng = numpy.random.default_rng(42)
+    img_arr = rng.integers(-4, 15, size=(n_rows, n_cols)).astype(numpy.float32)
+    driver = gdal.GetDriverByName("GTiff")
+    img_ds = driver.Create(img_file, n_cols, n_rows, 1, gdal.GDT_Float32)
+    img_ds.SetGeoTransform((0.0, 1.0, 0.0, float(n_rows), 0.0, -1.0))
+    img_ds.GetRasterBand(1).WriteArray(img_arr)
+    img_ds = None
+
+
+def _read_morph_test_img(img_file):
+    from osgeo import gdal
+
+    img_ds = gdal.Open(img_file)
+    img_arr = img_ds.GetRasterBand(1).ReadAsArray()
+    img_ds = None
+    return img_arr
+
+
+@pytest.mark.parametrize("op_size", [3, 7, 41])
+def test_image_morphology_vs_window_filters(tmp_path, op_size):
+    # A square operator is the same as a min/max window filter, which uses the
+    # same zero padding at the image edges. The 41 x 41 operator is larger than
+    # the image.
+    import numpy
+    import rsgislib
+    import rsgislib.imagemorphology
+    import rsgislib.imagefilter
+
+    input_img = os.path.join(tmp_path, "morph_test_img.tif")
+    _create_morph_test_img(input_img, 24, 17)
+    datatype = rsgislib.TYPE_32FLOAT
+
+    max_img = os.path.join(tmp_path, "max_filter.tif")
+    rsgislib.imagefilter.apply_max_filter(input_img, max_img, op_size, "GTIFF", datatype)
+    min_img = os.path.join(tmp_path, "min_filter.tif")
+    rsgislib.imagefilter.apply_min_filter(input_img, min_img, op_size, "GTIFF", datatype)
+    open_img = os.path.join(tmp_path, "open_filter.tif")
+    rsgislib.imagefilter.apply_max_filter(min_img, open_img, op_size, "GTIFF", datatype)
+    close_img = os.path.join(tmp_path, "close_filter.tif")
+    rsgislib.imagefilter.apply_min_filter(max_img, close_img, op_size, "GTIFF", datatype)
+    max_arr = _read_morph_test_img(max_img)
+    min_arr = _read_morph_test_img(min_img)
+
+    dilate_img = os.path.join(tmp_path, "dilate.tif")
+    rsgislib.imagemorphology.image_dilate(
+        input_img, dilate_img, "", False, op_size, "GTIFF", datatype
+    )
+    assert numpy.array_equal(_read_morph_test_img(dilate_img), max_arr)
+
+    erode_img = os.path.join(tmp_path, "erode.tif")
+    rsgislib.imagemorphology.image_erode(
+        input_img, erode_img, "", False, op_size, "GTIFF", datatype
+    )
+    assert numpy.array_equal(_read_morph_test_img(erode_img), min_arr)
+
+    gradient_img = os.path.join(tmp_path, "gradient.tif")
+    rsgislib.imagemorphology.image_gradiant(
+        input_img, gradient_img, "", False, op_size, "GTIFF", datatype
+    )
+    assert numpy.array_equal(_read_morph_test_img(gradient_img), max_arr - min_arr)
+
+    opening_img = os.path.join(tmp_path, "opening.tif")
+    rsgislib.imagemorphology.image_opening(
+        input_img,
+        opening_img,
+        os.path.join(tmp_path, "opening_tmp.tif"),
+        "",
+        False,
+        op_size,
+        "GTIFF",
+        datatype,
+        1,
+    )
+    assert numpy.array_equal(
+        _read_morph_test_img(opening_img), _read_morph_test_img(open_img)
+    )
+
+    closing_img = os.path.join(tmp_path, "closing.tif")
+    rsgislib.imagemorphology.image_closing(
+        input_img,
+        closing_img,
+        os.path.join(tmp_path, "closing_tmp.tif"),
+        "",
+        False,
+        op_size,
+        "GTIFF",
+        datatype,
+        1,
+    )
+    assert numpy.array_equal(
+        _read_morph_test_img(closing_img), _read_morph_test_img(close_img)
+    )
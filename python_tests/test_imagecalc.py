@@ -157,6 +157,99 @@ def test_band_maths_multi_band(tmp_path):
     assert img_eq
 
 
+def test_band_maths_multi_band_threads(tmp_path):
+    import rsgislib.imagecalc
+
+    input_img = os.path.join(DATA_DIR, "sen2_20210527_aber.tif")
+    ref_ndvi_img = os.path.join(IMGCALC_DATA_DIR, "sen2_20210527_aber_ndvi.tif")
+    band_def_seq = list()
+    band_def_seq.append(
+        rsgislib.imagecalc.BandDefn(band_name="red", input_img=input_img, img_band=3)
+    )
+    band_def_seq.append(
+        rsgislib.imagecalc.BandDefn(band_name="nir", input_img=input_img, img_band=8)
+    )
+    output_img = os.path.join(tmp_path, "ndvi_test_band_maths_threads.tif")
+    exp = "(nir-red)/(nir+red)"
+    rsgislib.imagecalc.band_math(
+        output_img,
+        exp,
+        "GTIFF",
+        rsgislib.TYPE_32FLOAT,
+        band_defs=band_def_seq,
+        n_threads=4,
+    )
+
+    img_eq, prop_match = rsgislib.imagecalc.are_img_bands_equal(
+        ref_ndvi_img, 1, output_img, 1
+    )
+    assert img_eq
+
+
+def test_band_maths_multi_band_python_threads(tmp_path):
+    import concurrent.futures
+    import rsgislib.imagecalc
+
+    input_img = os.path.join(DATA_DIR, "sen2_20210527_aber.tif")
+    ref_ndvi_img = os.path.join(IMGCALC_DATA_DIR, "sen2_20210527_aber_ndvi.tif")
+    band_def_seq = list()
+    band_def_seq.append(
+        rsgislib.imagecalc.BandDefn(band_name="red", input_img=input_img, img_band=3)
+    )
+    band_def_seq.append(
+        rsgislib.imagecalc.BandDefn(band_name="nir", input_img=input_img, img_band=8)
+    )
+    exp = "(nir-red)/(nir+red)"
+
+    def _calc_ndvi(output_img):
+        rsgislib.imagecalc.band_math(
+            output_img, exp, "GTIFF", rsgislib.TYPE_32FLOAT, band_defs=band_def_seq
+        )
+        return output_img
+
+    output_imgs = [
+        os.path.join(tmp_path, "ndvi_test_py_threads_{}.tif".format(i))
+        for i in range(4)
+    ]
+    with concurrent.futures.ThreadPoolExecutor(max_workers=4) as executor:
+        output_imgs = list(executor.map(_calc_ndvi, output_imgs))
+
+    for output_img in output_imgs:
+        img_eq, prop_match = rsgislib.imagecalc.are_img_bands_equal(
+            ref_ndvi_img, 1, output_img, 1
+        )
+        assert img_eq
+
+
+def test_band_maths_multi_band_no_bulk(tmp_path):
+    import rsgislib.imagecalc
+
+    input_img = os.path.join(DATA_DIR, "sen2_20210527_aber.tif")
+    ref_ndvi_img = os.path.join(IMGCALC_DATA_DIR, "sen2_20210527_aber_ndvi.tif")
+    band_def_seq = list()
+    band_def_seq.append(
+        rsgislib.imagecalc.BandDefn(band_name="red", input_img=input_img, img_band=3)
+    )
+    band_def_seq.append(
+        rsgislib.imagecalc.BandDefn(band_name="nir", input_img=input_img, img_band=8)
+    )
+    output_img = os.path.join(tmp_path, "ndvi_test_band_maths_no_bulk.tif")
+    exp = "(nir-red)/(nir+red)"
+    rsgislib.imagecalc.band_math(
+        output_img,
+        exp,
+        "GTIFF",
+        rsgislib.TYPE_32FLOAT,
+        band_defs=band_def_seq,
+        bulk_eval=False,
+    )
+
+    img_eq, prop_match = rsgislib.imagecalc.are_img_bands_equal(
+        ref_ndvi_img, 1, output_img, 1
+    )
+    assert img_eq
+
+
 def test_band_maths_binary_out(tmp_path):
     import rsgislib.imagecalc
 
@@ -525,6 +618,54 @@ def test_calc_band_percentile():
     assert ((percent_val[0] - 43) < 1) and ((percent_val[5] - 458) < 1)
 
 
+def test_calc_band_percentile_multi():
+    import numpy
+    from osgeo import gdal
+    import rsgislib.imagecalc
+
+    input_img = os.path.join(DATA_DIR, "sen2_20210527_aber.tif")
+
+    percent_vals = rsgislib.imagecalc.calc_band_percentile(input_img, [0.05, 0.5], 0)
+    low_vals = rsgislib.imagecalc.calc_band_percentile(input_img, 0.05, 0)
+    mid_vals = rsgislib.imagecalc.calc_band_percentile(input_img, 0.5, 0)
+
+    assert len(percent_vals) == len(mid_vals)
+    for band_vals, low_val, mid_val in zip(percent_vals, low_vals, mid_vals):
+        assert (band_vals[0] == low_val) and (band_vals[1] == mid_val)
+
+    # The percentiles are exact so match numpy's linear interpolation of
+    # the valid (not no data or NaN) values of each band.
+    img_ds = gdal.Open(input_img)
+    assert len(percent_vals) == img_ds.RasterCount
+    for n in range(img_ds.RasterCount):
+        band_arr = img_ds.GetRasterBand(n + 1).ReadAsArray().astype(numpy.float64)
+        band_arr = band_arr[(band_arr != 0) & numpy.isfinite(band_arr)]
+        ref_vals = numpy.percentile(band_arr, [5, 50])
+        numpy.testing.assert_allclose(percent_vals[n], ref_vals, rtol=1e-6)
+    img_ds = None
+
+
+def test_calc_band_percentile_numpy_vals():
+    import numpy
+    import rsgislib.imagecalc
+
+    input_img = os.path.join(DATA_DIR, "sen2_20210527_aber.tif")
+
+    ref_vals = rsgislib.imagecalc.calc_band_percentile(input_img, [0.05, 0.5], 0)
+    # numpy scalars (which are not Python floats) are accepted for the
+    # percentiles and the no data value.
+    np_sgl_vals = rsgislib.imagecalc.calc_band_percentile(
+        input_img, numpy.float32(0.5), numpy.int16(0)
+    )
+    np_multi_vals = rsgislib.imagecalc.calc_band_percentile(
+        input_img, numpy.array([0.05, 0.5], dtype=numpy.float32), 0
+    )
+
+    for band_vals, sgl_val, multi_vals in zip(ref_vals, np_sgl_vals, np_multi_vals):
+        assert sgl_val == band_vals[1]
+        assert (multi_vals[0] == band_vals[0]) and (multi_vals[1] == band_vals[1])
+
+
 def test_calc_img_rescale_sgl_img(tmp_path):
     import rsgislib.imagecalc
 
@@ -678,6 +819,92 @@ def test_kmeans_clustering(tmp_path):
     assert os.path.exists(out_ext_file)
 
 
+def _read_kmeans_centres(gmtxt_file):
+    import numpy
+
+    # The matrix has a row per band and a column per cluster.
+    with open(gmtxt_file) as f:
+        lines = f.read().split()
+    n_clusters = int(lines[0].split("=")[1])
+    n_bands = int(lines[1].split("=")[1])
+    vals = [float(val) for line in lines[2:] for val in line.split(",") if val]
+    return numpy.array(vals).reshape(n_bands, n_clusters).T
+
+
+def test_kmeans_clustering_threads(tmp_path):
+    import rsgislib.imagecalc
+
+    # A sub sample of 10 gives ~88k points, so the points are split into ~11
+    # blocks of 8192 which are shared between the threads.
+    input_img = os.path.join(DATA_DIR, "sen2_20210527_aber.tif")
+    out_files = []
+    for n_threads in [1, 3, 4]:
+        out_file = os.path.join(tmp_path, "out_file_{}".format(n_threads))
+        rsgislib.imagecalc.kmeans_clustering(
+            input_img,
+            out_file,
+            10,
+            20,
+            10,
+            True,
+            0.0025,
+            rsgislib.INITCLUSTER_DIAGONAL_FULL_ATTACH,
+            n_threads=n_threads,
+        )
+        out_files.append("{}.gmtxt".format(out_file))
+
+    with open(out_files[0]) as f1:
+        ref_centres = f1.read()
+    for out_file in out_files[1:]:
+        with open(out_file) as f2:
+            assert f2.read() == ref_centres
+
+
+def test_kmeans_clustering_brute_force(tmp_path):
+    import numpy
+    from osgeo import gdal
+    import rsgislib.imagecalc
+
+    # With a degree of change of 0 the clustering stops once no point changes
+    # cluster, so each centre is the mean of the points which are closest to
+    # it. This checks the bounded (Hamerly) assignment against a brute force
+    # nearest centre assignment, using every pixel (~110k points).
+    input_img = os.path.join(DATA_DIR, "sen2_20210527_aber_subset.tif")
+    out_file = os.path.join(tmp_path, "out_file")
+    rsgislib.imagecalc.kmeans_clustering(
+        input_img,
+        out_file,
+        10,
+        1000,
+        1,
+        True,
+        0.0,
+        rsgislib.INITCLUSTER_DIAGONAL_FULL_ATTACH,
+        n_threads=4,
+    )
+    centres = _read_kmeans_centres("{}.gmtxt".format(out_file))
+
+    img_ds = gdal.Open(input_img)
+    img_arr = img_ds.ReadAsArray().astype(numpy.float64)
+    img_ds = None
+    pxls = img_arr.reshape(img_arr.shape[0], -1).T
+    pxls = pxls[numpy.any(pxls != 0, axis=1)]
+
+    dists = numpy.zeros((pxls.shape[0], centres.shape[0]))
+    for k in range(centres.shape[0]):
+        dists[:, k] = numpy.sum((pxls - centres[k]) ** 2, axis=1)
+    pxl_clusters = numpy.argmin(dists, axis=1)
+
+    # The centres are written with 6 significant figures so points very close
+    # to being equidistant to two centres could be assigned either way.
+    for k in range(centres.shape[0]):
+        clust_pxls = pxls[pxl_clusters == k]
+        assert clust_pxls.shape[0] > 0
+        numpy.testing.assert_allclose(
+            numpy.mean(clust_pxls, axis=0), centres[k], rtol=1e-3, atol=1e-2
+        )
+
+
 def test_isodata_clustering(tmp_path):
     import rsgislib.imagecalc
 
@@ -722,6 +949,69 @@ def test_image_pixel_column_summary(tmp_path):
     assert os.path.exists(output_img)
 
 
+def test_image_pixel_column_summary_threads(tmp_path):
+    import numpy
+    from osgeo import gdal
+    import rsgislib.imagecalc
+
+    input_img = os.path.join(DATA_DIR, "sen2_20210527_aber_subset.tif")
+    stats_to_calc = rsgislib.imagecalc.StatsSummary()
+    stats_to_calc.calc_min = True
+    stats_to_calc.calc_max = True
+    stats_to_calc.calc_median = True
+    stats_to_calc.calc_mode = True
+    out_imgs = []
+    for n_threads in [1, 3]:
+        output_img = os.path.join(tmp_path, "out_img_{}.kea".format(n_threads))
+        rsgislib.imagecalc.image_pixel_column_summary(
+            input_img,
+            output_img,
+            stats_to_calc,
+            "KEA",
+            rsgislib.TYPE_32FLOAT,
+            0.0,
+            True,
+            n_threads=n_threads,
+        )
+        out_imgs.append(output_img)
+
+    for band in range(1, 5):
+        img_eq, prop_match = rsgislib.imagecalc.are_img_bands_equal(
+            out_imgs[0], band, out_imgs[1], band
+        )
+        assert img_eq
+
+    img_ds = gdal.Open(input_img)
+    in_arr = img_ds.ReadAsArray().astype(numpy.float64)
+    img_ds = None
+    img_ds = gdal.Open(out_imgs[1])
+    out_arr = img_ds.ReadAsArray()
+    img_ds = None
+
+    # The output bands are the min, max, median and mode (of the values rounded
+    # down, with ties going to the smallest value) excluding the no data value.
+    rng = numpy.random.default_rng(42)
+    pxl_ys = rng.integers(0, in_arr.shape[1], 25).tolist() + [0, in_arr.shape[1] - 1]
+    pxl_xs = rng.integers(0, in_arr.shape[2], 25).tolist() + [0, in_arr.shape[2] - 1]
+    for y, x in zip(pxl_ys, pxl_xs):
+        vals = in_arr[:, y, x]
+        vals = vals[vals != 0.0]
+        if vals.shape[0] == 0:
+            assert numpy.all(out_arr[:, y, x] == 0)
+            continue
+        mode_vals, mode_counts = numpy.unique(numpy.floor(vals), return_counts=True)
+        ref_vals = numpy.array(
+            [
+                numpy.min(vals),
+                numpy.max(vals),
+                numpy.median(vals),
+                mode_vals[numpy.argmax(mode_counts)],
+            ],
+            dtype=numpy.float32,
+        )
+        numpy.testing.assert_array_equal(out_arr[:, y, x], ref_vals)
+
+
 def test_get_img_band_stats_in_env():
     import rsgislib.imagecalc
 
@@ -442,6 +442,197 @@ def test_extract_avg_endmembers(tmp_path):
     assert specunmixing.are_endmembers_equal(endmembers_ref_file, test_endmembers_file)
 
 
+def _create_pxl_indicator_img(img_file, n_cols, n_rows, tl_x, tl_y, res):
+    # One band per pixel, band k is 1 for pixel k and 0 elsewhere so the pixels
+    # used for each polygon can be read back from the average endmembers.
+    import numpy
+    from osgeo import osr
+
+    n_pxls = n_cols * n_rows
+    driver = gdal.GetDriverByName("GTiff")
+    img_ds = driver.Create(img_file, n_cols, n_rows, n_pxls, gdal.GDT_Float32)
+    img_ds.SetGeoTransform((tl_x, res, 0, tl_y, 0, -res))
+    srs = osr.SpatialReference()
+    srs.ImportFromEPSG(27700)
+    img_ds.SetProjection(srs.ExportToWkt())
+    for k in range(n_pxls):
+        band_arr = numpy.zeros((n_rows, n_cols), dtype=numpy.float32)
+        band_arr[k // n_cols, k % n_cols] = 1
+        img_ds.GetRasterBand(k + 1).WriteArray(band_arr)
+    img_ds = None
+
+
+def _create_pxl_in_poly_test_vec(vec_file, vec_lyr, geoms_wkt):
+    from osgeo import ogr, osr
+
+    srs = osr.SpatialReference()
+    srs.ImportFromEPSG(27700)
+    driver = ogr.GetDriverByName("GPKG")
+    vec_ds = driver.CreateDataSource(vec_file)
+    lyr = vec_ds.CreateLayer(vec_lyr, srs, ogr.wkbUnknown)
+    for geom_wkt in geoms_wkt:
+        feat = ogr.Feature(lyr.GetLayerDefn())
+        feat.SetGeometry(ogr.CreateGeometryFromWkt(geom_wkt))
+        lyr.CreateFeature(feat)
+        feat = None
+    vec_ds = None
+
+
+def _pxl_poly_wkt(pts, tl_x, tl_y, res):
+    # pts are (col, row) in pixel coordinates.
+    return "({})".format(
+        ", ".join(
+            "{} {}".format(tl_x + (c * res), tl_y - (r * res)) for c, r in pts + [pts[0]]
+        )
+    )
+
+
+def _ref_pxls_in_poly(geom_wkt, method, n_cols, n_rows, tl_x, tl_y, res):
+    # Replicates the window from RSGISImageUtils::getImageOverlap used by
+    # RSGISCalcImage::calcImageWithinPolygonExtent and tests each pixel with
+    # the GEOS predicates used by RSGISPixelInPoly.
+    import math
+    from osgeo import ogr
+
+    geom = ogr.CreateGeometryFromWkt(geom_wkt)
+    min_x, max_x, min_y, max_y = geom.GetEnvelope()
+    if ((max_x - min_x) < res) or ((max_y - min_y) < res):
+        min_x -= res / 2
+        max_x += res / 2
+        min_y -= res / 2
+        max_y += res / 2
+    img_max_x = tl_x + (n_cols * res)
+    img_min_y = tl_y - (n_rows * res)
+    if (
+        (tl_x <= min_x)
+        and (img_min_y <= min_y)
+        and (img_max_x >= max_x)
+        and (tl_y >= max_y)
+    ):
+        win_min_x, win_max_x, win_min_y, win_max_y = min_x, max_x, min_y, max_y
+    else:
+        win_min_x, win_max_x, win_min_y, win_max_y = tl_x, img_max_x, img_min_y, tl_y
+    width = math.floor(((win_max_x - win_min_x) / res) + 0.5)
+    height = math.floor(((win_max_y - win_min_y) / res) + 0.5)
+    diff_x = win_min_x - tl_x
+    diff_y = tl_y - win_max_y
+    off_x = 0 if abs(diff_x) < 0.0001 else math.floor((diff_x / res) + 0.5)
+    off_y = 0 if abs(diff_y) < 0.0001 else math.floor((diff_y / res) + 0.5)
+    if (tl_x + ((off_x + width) * res)) > win_max_x:
+        width -= max(
+            math.floor(((tl_x + ((off_x + width) * res) - win_max_x) / res) + 0.5), 0
+        )
+    if (tl_y - ((off_y + height) * res)) < win_min_y:
+        height -= max(
+            math.floor(((win_min_y - (tl_y - ((off_y + height) * res))) / res) + 0.5),
+            0,
+        )
+
+    pxls = set()
+    for i in range(height):
+        for j in range(width):
+            pxl_min_x = win_min_x + (j * res)
+            pxl_max_y = win_max_y - (i * res)
+            ring = ogr.Geometry(ogr.wkbLinearRing)
+            ring.AddPoint_2D(pxl_min_x, pxl_max_y)
+            ring.AddPoint_2D(pxl_min_x + res, pxl_max_y)
+            ring.AddPoint_2D(pxl_min_x + res, pxl_max_y - res)
+            ring.AddPoint_2D(pxl_min_x, pxl_max_y - res)
+            ring.AddPoint_2D(pxl_min_x, pxl_max_y)
+            pxl_poly = ogr.Geometry(ogr.wkbPolygon)
+            pxl_poly.AddGeometry(ring)
+            if method == 0:
+                pxl_in = geom.Contains(pxl_poly)
+            elif method == 1:
+                pxl_centre = ogr.Geometry(ogr.wkbPoint)
+                pxl_centre.AddPoint_2D(pxl_min_x + (res / 2), pxl_max_y - (res / 2))
+                pxl_in = geom.Contains(pxl_centre)
+            elif method == 2:
+                pxl_in = geom.Overlaps(pxl_poly)
+            elif method == 3:
+                pxl_in = geom.Overlaps(pxl_poly) or geom.Contains(pxl_poly)
+            elif method == 4:
+                pxl_in = pxl_poly.Contains(geom)
+            elif method == 7:
+                pxl_in = True
+            else:
+                pxl_in = pxl_poly.Intersection(geom).GetArea() > 0
+            if pxl_in:
+                pxls.add(((off_y + i) * n_cols) + off_x + j)
+    return pxls
+
+
+@pytest.mark.parametrize("pxl_in_poly_method", [0, 1, 2, 3, 4, 7, 8])
+def test_extract_avg_endmembers_pxl_in_poly_methods(tmp_path, pxl_in_poly_method):
+    from rsgislib.imagecalc import specunmixing
+
+    n_cols = 12
+    n_rows = 10
+    tl_x = 1000.0
+    tl_y = 2000.0
+    res = 10.0
+    input_img = os.path.join(tmp_path, "pxl_indicator_img.tif")
+    _create_pxl_indicator_img(input_img, n_cols, n_rows, tl_x, tl_y, res)
+
+    def poly_wkt(*rings):
+        return "POLYGON ({})".format(
+            ", ".join(_pxl_poly_wkt(ring, tl_x, tl_y, res) for ring in rings)
+        )
+
+    def multi_poly_wkt(*polys):
+        return "MULTIPOLYGON ({})".format(
+            ", ".join(
+                "({})".format(", ".join(_pxl_poly_wkt(r, tl_x, tl_y, res) for r in p))
+                for p in polys
+            )
+        )
+
+    geoms_wkt = [
+        # Vertices and edges on pixel centres with a hole whose corners are on pixel centres.
+        poly_wkt(
+            [(1, 1), (8, 1), (8, 7), (5.5, 4.5), (1, 7)],
+            [(2.5, 2.5), (4.5, 2.5), (4.5, 4.5), (2.5, 4.5)],
+        ),
+        # The same polygon with the opposite ring orientations.
+        poly_wkt(
+            [(1, 7), (5.5, 4.5), (8, 7), (8, 1), (1, 1)],
+            [(2.5, 4.5), (4.5, 4.5), (4.5, 2.5), (2.5, 2.5)],
+        ),
+        # Multi-polygon touching the right edge of the image.
+        multi_poly_wkt(
+            [[(9, 1), (11, 1), (11, 3), (9, 3)]],
+            [[(9, 5), (12, 5), (9, 9)]],
+        ),
+        # Extends beyond the left and bottom of the image.
+        poly_wkt([(-2, 8), (3, 8), (3, 12), (-2, 12)]),
+        # Diamond with its vertices on pixel centres.
+        poly_wkt([(6.5, 8.5), (8.5, 6.5), (10.5, 8.5), (8.5, 9.5)]),
+        # Smaller than a pixel.
+        poly_wkt([(3.25, 2.25), (3.75, 2.25), (3.75, 2.75), (3.25, 2.75)]),
+    ]
+    vec_file = os.path.join(tmp_path, "pxl_in_poly_test.gpkg")
+    vec_lyr = "pxl_in_poly_test"
+    _create_pxl_in_poly_test_vec(vec_file, vec_lyr, geoms_wkt)
+
+    out_endmembers_file = os.path.join(tmp_path, "pxl_in_poly_endmembers")
+    specunmixing.extract_avg_endmembers(
+        input_img, vec_file, vec_lyr, out_endmembers_file, pxl_in_poly_method
+    )
+    n_feats, n_bands, endmembers_arr = specunmixing.read_endmembers_mtxt(
+        "{}.mtxt".format(out_endmembers_file)
+    )
+    assert n_feats == len(geoms_wkt)
+    assert n_bands == (n_cols * n_rows)
+
+    for i, geom_wkt in enumerate(geoms_wkt):
+        ref_pxls = _ref_pxls_in_poly(
+            geom_wkt, pxl_in_poly_method, n_cols, n_rows, tl_x, tl_y, res
+        )
+        # The average of the indicator bands is non-zero for the selected pixels.
+        sel_pxls = set(int(k) for k in (endmembers_arr[i] > 0).nonzero()[0])
+        assert sel_pxls == ref_pxls
+
+
 def test_exhcon_linear_spec_unmix(tmp_path):
     from rsgislib.imagecalc import specunmixing
     import rsgislib.imagecalc
@@ -0,0 +1,185 @@
+import os
+import collections
+import numpy
+import pytest
+
+import rsgislib
+
+LUT6SElevAOT = collections.namedtuple("LUT6SElevAOT", ["Elev", "Coeffs"])
+LUT6SAOT = collections.namedtuple("LUT6SAOT", ["AOT", "Coeffs"])
+LUT6SBandCoeffs = collections.namedtuple("LUT6SBandCoeffs", ["band", "aX", "bX", "cX"])
+
+
+def _create_calib_test_img(img_file, img_arr):
+    from osgeo import gdal
+
+    driver = gdal.GetDriverByName("GTiff")
+    img_ds = driver.Create(
+        img_file, img_arr.shape[2], img_arr.shape[1], img_arr.shape[0], gdal.GDT_Float32
+    )
+    img_ds.SetGeoTransform((100.0, 1.0, 0.0, 500.0, 0.0, -1.0))
+    for n in range(img_arr.shape[0]):
+        img_ds.GetRasterBand(n + 1).WriteArray(img_arr[n])
+    img_ds = None
+
+
+def _read_calib_test_img(img_file):
+    from osgeo import gdal
+
+    img_ds = gdal.Open(img_file)
+    img_arr = img_ds.ReadAsArray().astype(numpy.float64)
+    img_ds = None
+    if img_arr.ndim == 2:
+        img_arr = img_arr[numpy.newaxis]
+    return img_arr
+
+
+def _create_6s_elev_aot_lut(n_bands):
+    # The elevation levels are evenly spaced while the AOT levels differ
+    # between the elevations, and are only evenly spaced for the last.
+    lut_aots = {
+        0.0: [0.05, 0.1, 0.3, 0.5],
+        500.0: [0.05, 0.2, 0.5],
+        1000.0: [0.1, 0.2, 0.3, 0.4, 0.5],
+    }
+    lut = list()
+    for elev, aots in lut_aots.items():
+        aot_coeffs = list()
+        for aot in aots:
+            band_coeffs = list()
+            for n in range(n_bands):
+                band_coeffs.append(
+                    LUT6SBandCoeffs(
+                        band=n + 1,
+                        aX=0.002 + 0.0002 * n + 0.001 * aot + 1e-6 * elev,
+                        bX=0.05 + 0.1 * aot - 2e-5 * elev,
+                        cX=0.1 + 0.2 * aot + 1e-5 * elev,
+                    )
+                )
+            aot_coeffs.append(LUT6SAOT(AOT=aot, Coeffs=band_coeffs))
+        lut.append(LUT6SElevAOT(Elev=elev, Coeffs=aot_coeffs))
+    return lut
+
+
+def _find_6s_lut_axis_pos(levels, val):
+    # Values outside of the levels (and NaN) are clamped to the edge levels.
+    levels = numpy.array(levels, dtype=numpy.float32)
+    val = numpy.float32(val)
+    if (levels.shape[0] == 1) or not (val > levels[0]):
+        return 0, 0, 0.0
+    if val >= levels[-1]:
+        return levels.shape[0] - 1, levels.shape[0] - 1, 0.0
+    idx = numpy.searchsorted(levels, val, side="right") - 1
+    weight = (val - levels[idx]) / (levels[idx + 1] - levels[idx])
+    return idx, idx + 1, float(weight)
+
+
+def _calc_ref_6s_elev_aot(rad_arr, dem_arr, aot_arr, lut, scale_factor):
+    # Bilinear interpolation of the reflectance between the four LUT entries
+    # around the elevation and AOT of each pixel, with no data value of 0.
+    out_arr = numpy.zeros(rad_arr.shape, dtype=numpy.float64)
+    for y in range(rad_arr.shape[1]):
+        for x in range(rad_arr.shape[2]):
+            if numpy.all(rad_arr[:, y, x] == 0):
+                continue
+            elev_idx1, elev_idx2, elev_w = _find_6s_lut_axis_pos(
+                [elev_lut.Elev for elev_lut in lut], dem_arr[y, x]
+            )
+            lut_entries = list()
+            for elev_idx, w in ((elev_idx1, 1 - elev_w), (elev_idx2, elev_w)):
+                aot_luts = lut[elev_idx].Coeffs
+                aot_idx1, aot_idx2, aot_w = _find_6s_lut_axis_pos(
+                    [aot_lut.AOT for aot_lut in aot_luts], aot_arr[y, x]
+                )
+                lut_entries.append((aot_luts[aot_idx1], w * (1 - aot_w)))
+                lut_entries.append((aot_luts[aot_idx2], w * aot_w))
+            for n in range(rad_arr.shape[0]):
+                out_val = 0.0
+                for aot_lut, w in lut_entries:
+                    coeffs = aot_lut.Coeffs[n]
+                    tmp_val = coeffs.aX * rad_arr[n, y, x] - coeffs.bX
+                    out_val += (
+                        w * (tmp_val / (1.0 + coeffs.cX * tmp_val)) * scale_factor
+                    )
+                out_val = 1.0 if out_val < 1 else out_val + 1.0
+                out_arr[n, y, x] = min(out_val, scale_factor)
+    return out_arr
+
+
+def test_apply_6s_coeff_elev_aot_lut_param_interp(tmp_path):
+    import rsgislib.imagecalibration
+
+    n_bands = 3
+    img_shape = (n_bands, 30, 40)
+    rng = numpy.random.default_rng(42)
+    rad_arr = rng.uniform(20.0, 400.0, img_shape).astype(numpy.float32)
+    # Elevation and AOT values are both within and beyond the LUT levels.
+    dem_arr = rng.uniform(-200.0, 1300.0, img_shape[1:]).astype(numpy.float32)
+    aot_arr = rng.uniform(-0.1, 0.7, img_shape[1:]).astype(numpy.float32)
+    # Include values exactly on the LUT levels.
+    dem_arr[0, :] = 500.0
+    dem_arr[1, :] = 1000.0
+    aot_arr[:, 0] = 0.3
+    aot_arr[:, 1] = 0.05
+    # No data pixels, plus pixels where only a single band is 0.
+    rad_arr[:, 5, 5:15] = 0
+    rad_arr[1, 10, 5:15] = 0
+
+    rad_img = os.path.join(tmp_path, "rad_img.tif")
+    _create_calib_test_img(rad_img, rad_arr)
+    dem_img = os.path.join(tmp_path, "dem_img.tif")
+    _create_calib_test_img(dem_img, dem_arr[numpy.newaxis])
+    aot_img = os.path.join(tmp_path, "aot_img.tif")
+    _create_calib_test_img(aot_img, aot_arr[numpy.newaxis])
+
+    lut = _create_6s_elev_aot_lut(n_bands)
+    output_img = os.path.join(tmp_path, "sref_img.tif")
+    rsgislib.imagecalibration.apply_6s_coeff_elev_aot_lut_param(
+        rad_img,
+        dem_img,
+        aot_img,
+        output_img,
+        "GTIFF",
+        rsgislib.TYPE_32FLOAT,
+        1000.0,
+        0.0,
+        True,
+        lut,
+    )
+
+    out_arr = _read_calib_test_img(output_img)
+    ref_arr = _calc_ref_6s_elev_aot(
+        rad_arr.astype(numpy.float64), dem_arr, aot_arr, lut, 1000.0
+    )
+    numpy.testing.assert_allclose(out_arr, ref_arr, rtol=1e-4, atol=1e-3)
+    assert numpy.all(out_arr[:, 5, 5:15] == 0)
+    assert numpy.all(out_arr[:, 10, 5:15] > 0)
+
+
+@pytest.mark.parametrize("bad_band", [0, 4, 5])
+def test_apply_6s_coeff_single_param_band_not_in_img(tmp_path, bad_band):
+    import rsgislib.imagecalibration
+
+    rng = numpy.random.default_rng(42)
+    rad_arr = rng.uniform(20.0, 400.0, (3, 20, 30)).astype(numpy.float32)
+    rad_img = os.path.join(tmp_path, "rad_img.tif")
+    _create_calib_test_img(rad_img, rad_arr)
+
+    # The bands are numbered from 1, so 0 and those beyond the number of image
+    # bands are not within the image.
+    band_coeffs = list()
+    for band in [1, 2, bad_band]:
+        band_coeffs.append(LUT6SBandCoeffs(band=band, aX=0.002, bX=0.05, cX=0.1))
+
+    output_img = os.path.join(tmp_path, "sref_img.tif")
+    with pytest.raises(Exception):
+        rsgislib.imagecalibration.apply_6s_coeff_single_param(
+            rad_img,
+            output_img,
+            "GTIFF",
+            rsgislib.TYPE_32FLOAT,
+            1000.0,
+            0.0,
+            True,
+            band_coeffs,
+        )
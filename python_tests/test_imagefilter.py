@@ -1,6 +1,15 @@
 import os
+import math
+import numpy
+import pytest
 import rsgislib
 
+SCIPY_NOT_AVAIL = False
+try:
+    import scipy
+except ImportError:
+    SCIPY_NOT_AVAIL = True
+
 DATA_DIR = os.path.join(os.path.dirname(os.path.abspath(__file__)), "data")
 
 
@@ -64,6 +73,56 @@ def test_apply_mode_filter(tmp_path):
     assert os.path.exists(output_img)
 
 
+@pytest.mark.skipif(SCIPY_NOT_AVAIL, reason="scipy dependency not available")
+def test_apply_percentile_filter(tmp_path):
+    import scipy.ndimage
+    import rsgislib.imagefilter
+
+    input_img = os.path.join(DATA_DIR, "sen2_20210527_aber_subset_b123.tif")
+    output_img = os.path.join(tmp_path, "filter_output.tif")
+    rsgislib.imagefilter.apply_percentile_filter(
+        input_img, output_img, 5, 90, "GTIFF", rsgislib.TYPE_16UINT
+    )
+
+    # The image has no no data value so the windows are zero padded at the
+    # edges, and for a 5x5 window the nearest rank matches scipy's rank.
+    img_arr = _read_filter_test_img(input_img)
+    out_arr = _read_filter_test_img(output_img)
+    for n in range(img_arr.shape[0]):
+        ref_arr = scipy.ndimage.percentile_filter(
+            img_arr[n], 90, size=5, mode="constant", cval=0
+        )
+        assert numpy.array_equal(out_arr[n], ref_arr)
+
+
+@pytest.mark.parametrize("filter_size", [3, 5])
+@pytest.mark.parametrize("percentile", [0, 20, 50, 90, 100])
+def test_apply_percentile_filter_ref(tmp_path, filter_size, percentile):
+    import rsgislib.imagefilter
+
+    rng = numpy.random.default_rng(42)
+    img_arr = rng.uniform(10.0, 60.0, (1, 19, 23)).astype(numpy.float32)
+    img_arr[0, 5:9, 7:10] = 35.0
+    # No data pixels, including a block larger than the smallest window.
+    img_arr[0, 2, 3] = 0
+    img_arr[0, 14:17, 2:6] = 0
+    img_arr[0, 9, 10] = numpy.nan
+
+    input_img = os.path.join(tmp_path, "filter_input.tif")
+    _create_filter_test_img(input_img, img_arr, no_data_val=0)
+
+    output_img = os.path.join(tmp_path, "filter_output.tif")
+    rsgislib.imagefilter.apply_percentile_filter(
+        input_img, output_img, filter_size, percentile, "GTIFF", rsgislib.TYPE_32FLOAT
+    )
+
+    out_arr = _read_filter_test_img(output_img)
+    ref_arr = _calc_ref_window_filter(
+        img_arr, filter_size, _ref_percentile_filter(percentile, 0)
+    )
+    assert numpy.array_equal(out_arr, ref_arr)
+
+
 def test_apply_stddev_filter(tmp_path):
     import rsgislib.imagefilter
 
@@ -220,6 +279,196 @@ def test_apply_texture_var_filter(tmp_path):
     assert os.path.exists(output_img)
 
 
+def _create_filter_test_img(img_file, img_arr, no_data_val=None):
+    from osgeo import gdal
+
+    driver = gdal.GetDriverByName("GTiff")
+    img_ds = driver.Create(
+        img_file, img_arr.shape[2], img_arr.shape[1], img_arr.shape[0], gdal.GDT_Float32
+    )
+    img_ds.SetGeoTransform((100.0, 1.0, 0.0, 500.0, 0.0, -1.0))
+    for n in range(img_arr.shape[0]):
+        img_band = img_ds.GetRasterBand(n + 1)
+        img_band.WriteArray(img_arr[n])
+        if no_data_val is not None:
+            img_band.SetNoDataValue(no_data_val)
+    img_ds = None
+
+
+def _read_filter_test_img(img_file):
+    from osgeo import gdal
+
+    img_ds = gdal.Open(img_file)
+    img_arr = img_ds.ReadAsArray().astype(numpy.float64)
+    img_ds = None
+    if img_arr.ndim == 2:
+        img_arr = img_arr[numpy.newaxis]
+    return img_arr
+
+
+def _calc_ref_window_filter(img_arr, win_size, win_func):
+    # The windows are padded with zeros beyond the edge of the image, as
+    # when the filters were calculated a window at a time.
+    win_mid = win_size // 2
+    pad_arr = numpy.pad(
+        img_arr.astype(numpy.float64),
+        ((0, 0), (win_mid, win_mid), (win_mid, win_mid)),
+        mode="constant",
+        constant_values=0,
+    )
+    out_arr = numpy.zeros(img_arr.shape, dtype=numpy.float64)
+    for n in range(img_arr.shape[0]):
+        for y in range(img_arr.shape[1]):
+            for x in range(img_arr.shape[2]):
+                win_vals = pad_arr[n, y : y + win_size, x : x + win_size].flatten()
+                out_arr[n, y, x] = win_func(win_vals, img_arr[n, y, x])
+    return out_arr
+
+
+def _ref_stats_filter(stat_type, no_data_val):
+    def _win_func(win_vals, centre_val):
+        if no_data_val is not None:
+            win_vals = win_vals[win_vals != no_data_val]
+        if win_vals.shape[0] == 0:
+            return no_data_val
+        if stat_type == "mean":
+            return numpy.mean(win_vals)
+        elif stat_type == "stddev":
+            return numpy.std(win_vals)
+        elif stat_type == "coeff_of_var":
+            return numpy.std(win_vals) / numpy.mean(win_vals)
+        return numpy.sum(win_vals)
+
+    return _win_func
+
+
+def _ref_percentile_filter(percentile, no_data_val):
+    # The nearest rank of the valid values, with the percentile as a float32.
+    def _win_func(win_vals, centre_val):
+        win_vals = win_vals[(win_vals != no_data_val) & numpy.isfinite(win_vals)]
+        if win_vals.shape[0] == 0:
+            return no_data_val
+        n_vals = win_vals.shape[0]
+        rank = math.ceil((float(numpy.float32(percentile)) / 100.0) * n_vals)
+        rank = min(max(rank, 1), n_vals)
+        return numpy.sort(win_vals)[rank - 1]
+
+    return _win_func
+
+
+def _ref_sar_texture_filter(texture_type):
+    def _win_func(win_vals, centre_val):
+        if (centre_val == 0) or numpy.isnan(centre_val):
+            return 0
+        win_vals = win_vals[(win_vals != 0) & numpy.isfinite(win_vals)]
+        if win_vals.shape[0] <= 3:
+            return 0
+        if texture_type == "norm_var":
+            return (numpy.mean(win_vals**2) / numpy.mean(win_vals) ** 2) - 1
+        elif texture_type == "norm_var_sqrt":
+            return (numpy.mean(win_vals) / numpy.mean(numpy.sqrt(win_vals)) ** 2) - 1
+        elif texture_type == "norm_var_ln":
+            ln_vals = numpy.log(win_vals)
+            return (numpy.mean(ln_vals**2) / numpy.mean(ln_vals) ** 2) - 1
+        # The 1/n terms of the texture variance are integer divisions so are 0.
+        return (numpy.std(win_vals) / numpy.mean(win_vals)) ** 2
+
+    return _win_func
+
+
+@pytest.mark.parametrize("filter_size", [3, 7])
+@pytest.mark.parametrize(
+    "stat_type, atol",
+    [("mean", 1e-3), ("stddev", 1e-4), ("coeff_of_var", 1e-10), ("total", 1e-2)],
+)
+def test_apply_stats_window_sums_filters_ref(tmp_path, filter_size, stat_type, atol):
+    import rsgislib.imagefilter
+
+    # A large mean relative to the spread in the first band, which loses the
+    # precision of the variance if it is calculated as E[x^2] - E[x]^2.
+    rng = numpy.random.default_rng(42)
+    img_arr = numpy.zeros((2, 19, 23), dtype=numpy.float32)
+    img_arr[0] = 1.0e6 + rng.normal(0.0, 1.0, (19, 23))
+    img_arr[1] = rng.uniform(10.0, 60.0, (19, 23))
+    img_arr[1, 5:9, 7:10] = 35.0
+    # No data pixels, including a block larger than the smallest window.
+    img_arr[:, 2, 3] = 0
+    img_arr[:, 11, 15:18] = 0
+    img_arr[:, 14:17, 2:6] = 0
+
+    input_img = os.path.join(tmp_path, "filter_input.tif")
+    _create_filter_test_img(input_img, img_arr, no_data_val=0)
+
+    output_img = os.path.join(tmp_path, "filter_output.tif")
+    filter_func = getattr(rsgislib.imagefilter, "apply_{}_filter".format(stat_type))
+    filter_func(input_img, output_img, filter_size, "GTIFF", rsgislib.TYPE_32FLOAT)
+
+    out_arr = _read_filter_test_img(output_img)
+    ref_arr = _calc_ref_window_filter(
+        img_arr, filter_size, _ref_stats_filter(stat_type, 0)
+    )
+    numpy.testing.assert_allclose(out_arr, ref_arr, rtol=1e-5, atol=atol)
+
+
+@pytest.mark.parametrize("filter_size", [3, 7])
+@pytest.mark.parametrize("stat_type, atol", [("stddev", 1e-4), ("coeff_of_var", 1e-10)])
+def test_apply_stats_window_sums_filters_large_mean_no_data_ref(
+    tmp_path, filter_size, stat_type, atol
+):
+    import rsgislib.imagefilter
+
+    # No no data value, so the zero padding beyond the edges of the image is
+    # within the windows, but the variance should still keep its precision
+    # within the image where the mean is large relative to the spread.
+    rng = numpy.random.default_rng(42)
+    img_arr = (1.0e6 + rng.normal(0.0, 1.0, (1, 29, 37))).astype(numpy.float32)
+
+    input_img = os.path.join(tmp_path, "filter_input.tif")
+    _create_filter_test_img(input_img, img_arr)
+
+    output_img = os.path.join(tmp_path, "filter_output.tif")
+    filter_func = getattr(rsgislib.imagefilter, "apply_{}_filter".format(stat_type))
+    filter_func(input_img, output_img, filter_size, "GTIFF", rsgislib.TYPE_32FLOAT)
+
+    out_arr = _read_filter_test_img(output_img)
+    ref_arr = _calc_ref_window_filter(
+        img_arr, filter_size, _ref_stats_filter(stat_type, None)
+    )
+    numpy.testing.assert_allclose(out_arr, ref_arr, rtol=1e-5, atol=atol)
+
+
+@pytest.mark.parametrize("filter_size", [3, 5])
+@pytest.mark.parametrize(
+    "texture_type", ["norm_var", "norm_var_sqrt", "norm_var_ln", "texture_var"]
+)
+def test_apply_sar_texture_window_sums_filters_ref(tmp_path, filter_size, texture_type):
+    import rsgislib.imagefilter
+
+    rng = numpy.random.default_rng(42)
+    img_arr = rng.gamma(4.0, 0.02, (1, 19, 23)).astype(numpy.float32)
+    img_arr[0, 3:6, 4:7] = 0.05
+    # Zero and NaN pixels are not data; both are skipped from the windows
+    # and give 0 when they are at the centre of the window.
+    img_arr[0, 2, 3] = 0
+    img_arr[0, 9, 10:14] = 0
+    img_arr[0, 12, 18] = numpy.nan
+    img_arr[0, 15:18, 5] = numpy.nan
+    img_arr[0, 17:, 19:] = 0
+
+    input_img = os.path.join(tmp_path, "filter_input.tif")
+    _create_filter_test_img(input_img, img_arr)
+
+    output_img = os.path.join(tmp_path, "filter_output.tif")
+    filter_func = getattr(rsgislib.imagefilter, "apply_{}_filter".format(texture_type))
+    filter_func(input_img, output_img, filter_size, "GTIFF", rsgislib.TYPE_32FLOAT)
+
+    out_arr = _read_filter_test_img(output_img)
+    ref_arr = _calc_ref_window_filter(
+        img_arr, filter_size, _ref_sar_texture_filter(texture_type)
+    )
+    numpy.testing.assert_allclose(out_arr, ref_arr, rtol=1e-4, atol=1e-6)
+
+
 def test_apply_kuwahara_filter(tmp_path):
     import rsgislib.imagefilter
 
@@ -77,6 +77,37 @@ def test_basic_registration(tmp_path):
     assert os.path.exists(out_gcp_file)
 
 
+def test_basic_registration_threads(tmp_path):
+    import rsgislib.imageregistration
+
+    in_ref_img = os.path.join(DATA_DIR, "sen2_20210527_aber_subset_b123.tif")
+    in_float_img = os.path.join(
+        IMGREG_DATA_DIR, "sen2_20210527_aber_subset_b123_offset.tif"
+    )
+    out_gcp_files = []
+    for n_threads in [1, 3]:
+        out_gcp_file = os.path.join(tmp_path, "out_gcps_{}.txt".format(n_threads))
+        rsgislib.imageregistration.basic_registration(
+            in_ref_img,
+            in_float_img,
+            out_gcp_file,
+            50,
+            0.8,
+            50,
+            4,
+            2,
+            2,
+            4,
+            rsgislib.imageregistration.METRIC_CORELATION,
+            rsgislib.imageregistration.TYPE_RSGIS_IMG2MAP,
+            n_threads=n_threads,
+        )
+        out_gcp_files.append(out_gcp_file)
+
+    with open(out_gcp_files[0]) as f1, open(out_gcp_files[1]) as f2:
+        assert f1.read() == f2.read()
+
+
 def test_single_layer_registration(tmp_path):
     import rsgislib.imageregistration
 
@@ -106,6 +137,191 @@ def test_single_layer_registration(tmp_path):
     assert os.path.exists(out_gcp_file)
 
 
+
+def test_single_layer_registration_threads(tmp_path):
+    import rsgislib.imageregistration
+
+    in_ref_img = os.path.join(DATA_DIR, "sen2_20210527_aber_subset_b123.tif")
+    in_float_img = os.path.join(
+        IMGREG_DATA_DIR, "sen2_20210527_aber_subset_b123_offset.tif"
+    )
+    # The tie points of an iteration are located in parallel and the neighbour
+    # updates are applied afterwards, so the number of threads should not
+    # change the output.
+    out_gcp_files = []
+    for n_threads in [1, 3, 4]:
+        out_gcp_file = os.path.join(tmp_path, "out_gcps_{}.txt".format(n_threads))
+        rsgislib.imageregistration.single_layer_registration(
+            in_ref_img,
+            in_float_img,
+            out_gcp_file,
+            50,
+            0.8,
+            50,
+            4,
+            2,
+            2,
+            5,
+            6,
+            4,
+            0.5,
+            2,
+            rsgislib.imageregistration.METRIC_CORELATION,
+            rsgislib.imageregistration.TYPE_RSGIS_IMG2MAP,
+            n_threads=n_threads,
+        )
+        out_gcp_files.append(out_gcp_file)
+
+    with open(out_gcp_files[0]) as f:
+        ref_gcps = f.read()
+    assert len(ref_gcps) > 0
+    for out_gcp_file in out_gcp_files[1:]:
+        with open(out_gcp_file) as f:
+            assert f.read() == ref_gcps
+
+def _create_reg_test_img(img_file, img_arr):
+    from osgeo import gdal
+
+    driver = gdal.GetDriverByName("GTiff")
+    img_ds = driver.Create(
+        img_file, img_arr.shape[2], img_arr.shape[1], img_arr.shape[0], gdal.GDT_Float32
+    )
+    img_ds.SetGeoTransform((0.0, 1.0, 0.0, float(img_arr.shape[1]), 0.0, -1.0))
+    for n in range(img_arr.shape[0]):
+        img_ds.GetRasterBand(n + 1).WriteArray(img_arr[n])
+    img_ds = None
+
+
+def _calc_ref_similarity_surface(
+    ref_arr, flt_arr, win_col, win_row, win_size, search_area, metric_type
+):
+    """
+    Calculate the metric separately for each shift of the floating image, for
+    the window (win_size*2+1 pixels) with its top-left pixel at (win_col, win_row)
+    in the reference image. Both images have the same top-left corner.
+    """
+    import numpy
+
+    n_search = (search_area * 2) + 1
+    win_len = (win_size * 2) + 1
+    surface = numpy.full((n_search, n_search), numpy.nan)
+    for y_idx in range(n_search):
+        y_shift = y_idx - search_area
+        for x_idx in range(n_search):
+            x_shift = x_idx - search_area
+            # The window within both images once the floating image is shifted.
+            c0 = max(0, x_shift, win_col)
+            c1 = min(ref_arr.shape[2], x_shift + flt_arr.shape[2], win_col + win_len)
+            r0 = max(0, y_shift, win_row)
+            r1 = min(ref_arr.shape[1], y_shift + flt_arr.shape[1], win_row + win_len)
+            if (c1 <= c0) or (r1 <= r0):
+                continue
+            ref_vals = ref_arr[:, r0:r1, c0:c1].astype(numpy.float64)
+            flt_vals = flt_arr[
+                : ref_arr.shape[0],
+                r0 - y_shift : r1 - y_shift,
+                c0 - x_shift : c1 - x_shift,
+            ].astype(numpy.float64)
+            vld = ~(numpy.isnan(ref_vals) | numpy.isnan(flt_vals))
+            ref_vals = ref_vals[vld]
+            flt_vals = flt_vals[vld]
+            n = ref_vals.size
+            if metric_type == 1:
+                val = numpy.sqrt(numpy.sum((ref_vals - flt_vals) ** 2) / n)
+            elif metric_type == 2:
+                val = numpy.sum((ref_vals - flt_vals) ** 2) / n
+            elif metric_type == 3:
+                val = numpy.sum(numpy.abs(ref_vals - flt_vals)) / n
+            else:
+                val = abs(
+                    (
+                        (n * numpy.sum(ref_vals * flt_vals))
+                        - (numpy.sum(ref_vals) * numpy.sum(flt_vals))
+                    )
+                    / numpy.sqrt(
+                        (
+                            (n * numpy.sum(ref_vals**2))
+                            - (numpy.sum(ref_vals) ** 2)
+                        )
+                        * (
+                            (n * numpy.sum(flt_vals**2))
+                            - (numpy.sum(flt_vals) ** 2)
+                        )
+                    )
+                )
+            surface[y_idx, x_idx] = val
+    return surface
+
+
+@pytest.mark.parametrize(
+    "metric_type",
+    [
+        1,  # rsgislib.imageregistration.METRIC_EUCLIDEAN
+        2,  # rsgislib.imageregistration.METRIC_SQDIFF
+        3,  # rsgislib.imageregistration.METRIC_MANHATTEN
+        4,  # rsgislib.imageregistration.METRIC_CORELATION
+    ],
+)
+@pytest.mark.parametrize("win_case", ["interior", "ref_nan", "flt_nan", "edge"])
+def test_calc_tie_pt_similarity_surface(tmp_path, metric_type, win_case):
+    import numpy
+    import rsgislib.imageregistration
+
+    # The surface is calculated with the FFT and summed area tables for the
+    # Euclidean, squared difference and correlation metrics in the interior
+    # case, and separately for each shift where the windows contain NaNs or
+    # the reference window is trimmed by the edge of the floating image.
+    rng = numpy.random.default_rng(37)
+    n_rows = 26
+    n_cols = 30
+    win_size = 3
+    search_area = 2
+    ref_arr = (rng.random((3, n_rows, n_cols)) * 100 + 1000).astype(numpy.float32)
+    flt_arr = numpy.roll(ref_arr, (-2, 1), axis=(1, 2)) + rng.normal(
+        0, 5, size=ref_arr.shape
+    ).astype(numpy.float32)
+    flt_arr = flt_arr[:, : n_rows - 1, : n_cols - 2]
+
+    if win_case == "edge":
+        win_col = 0
+        win_row = 0
+    else:
+        win_col = 12
+        win_row = 9
+    if win_case == "ref_nan":
+        ref_arr[1, win_row + 2, win_col + 4] = numpy.nan
+    elif win_case == "flt_nan":
+        flt_arr[0, win_row + 1, win_col + 1] = numpy.nan
+
+    ref_img = os.path.join(tmp_path, "ref_img.tif")
+    _create_reg_test_img(ref_img, ref_arr)
+    flt_img = os.path.join(tmp_path, "flt_img.tif")
+    _create_reg_test_img(flt_img, flt_arr)
+
+    # The window covers from the tie point minus win_size to the tie point plus
+    # win_size plus one pixel (the y axis is up).
+    eastings = float(win_col + win_size)
+    northings = float(n_rows - win_row - win_size - 1)
+    surface = numpy.array(
+        rsgislib.imageregistration.calc_tie_pt_similarity_surface(
+            ref_img,
+            flt_img,
+            eastings,
+            northings,
+            win_size,
+            search_area,
+            metric_type,
+        )
+    )
+
+    ref_surface = _calc_ref_similarity_surface(
+        ref_arr, flt_arr, win_col, win_row, win_size, search_area, metric_type
+    )
+    assert surface.shape == ref_surface.shape
+    assert numpy.array_equal(numpy.isnan(surface), numpy.isnan(ref_surface))
+    numpy.testing.assert_allclose(surface, ref_surface, rtol=1e-4, atol=1e-4)
+
+
 def test_gcp_to_gdal(tmp_path):
     import rsgislib.imageregistration
     import rsgislib.imageutils
@@ -552,6 +552,105 @@ def test_create_img_mosaic(tmp_path):
 
     assert os.path.exists(output_img)
 
+
+def test_create_img_mosaic_threads(tmp_path):
+    import rsgislib
+    import rsgislib.imageutils
+    import rsgislib.imagecalc
+    import glob
+
+    imgs = glob.glob(os.path.join(IMGUTILS_DATA_DIR, "s2_tiles", "*.tif"))
+    output_img = os.path.join(tmp_path, "out_img.tif")
+    rsgislib.imageutils.create_img_mosaic(
+        imgs, output_img, 0, 0, 1, 2, "GTIFF", rsgislib.TYPE_16UINT
+    )
+    output_thrd_img = os.path.join(tmp_path, "out_thrd_img.tif")
+    rsgislib.imageutils.create_img_mosaic(
+        imgs, output_thrd_img, 0, 0, 1, 2, "GTIFF", rsgislib.TYPE_16UINT, n_threads=4
+    )
+
+    img_eq, prop_match = rsgislib.imagecalc.are_imgs_equal(output_img, output_thrd_img)
+    assert img_eq
+
+
+def _create_mosaic_test_imgs(tmp_path):
+    import numpy
+    from osgeo import gdal
+
+    rng = numpy.random.default_rng(11)
+    # (x offset, y offset, width, height) in pixels of the mosaic.
+    img_exts = [(0, 0, 20, 15), (7, 5, 18, 12), (14, 2, 10, 16)]
+    imgs = []
+    img_arrs = []
+    for i, (x_off, y_off, n_cols, n_rows) in enumerate(img_exts):
+        # The values are not integers so the overlap comparisons depend on whether
+        # they are made with the values stored in the integer output image.
+        skip_arr = rng.integers(0, 6, size=(n_rows, n_cols)) + rng.choice(
+            [0.3, 0.7], size=(n_rows, n_cols)
+        )
+        skip_arr[rng.random((n_rows, n_cols)) < 0.15] = 0
+        img_arr = numpy.stack(
+            [skip_arr, numpy.full((n_rows, n_cols), i + 1.0)]
+        ).astype(numpy.float32)
+        img_file = os.path.join(tmp_path, "mosaic_in_{}.tif".format(i))
+        driver = gdal.GetDriverByName("GTiff")
+        img_ds = driver.Create(img_file, n_cols, n_rows, 2, gdal.GDT_Float32)
+        img_ds.SetGeoTransform((100.0 + x_off, 1.0, 0.0, 500.0 - y_off, 0.0, -1.0))
+        for n in range(2):
+            img_ds.GetRasterBand(n + 1).WriteArray(img_arr[n])
+        img_ds = None
+        imgs.append(img_file)
+        img_arrs.append(img_arr)
+    return imgs, img_arrs, img_exts
+
+
+@pytest.mark.parametrize("overlap_behaviour", [0, 1, 2])
+@pytest.mark.parametrize("n_threads", [1, 4])
+def test_create_img_mosaic_overlap_ref(tmp_path, overlap_behaviour, n_threads):
+    import numpy
+    from osgeo import gdal
+    import rsgislib
+    import rsgislib.imageutils
+
+    imgs, img_arrs, img_exts = _create_mosaic_test_imgs(tmp_path)
+    output_img = os.path.join(tmp_path, "out_img.tif")
+    rsgislib.imageutils.create_img_mosaic(
+        imgs,
+        output_img,
+        0,
+        0,
+        1,
+        overlap_behaviour,
+        "GTIFF",
+        rsgislib.TYPE_16INT,
+        n_threads=n_threads,
+    )
+
+    # Reference: add each image in turn to the mosaic, comparing the new
+    # values with those stored in the (integer) output image.
+    out_n_cols = max(x_off + n_cols for x_off, y_off, n_cols, n_rows in img_exts)
+    out_n_rows = max(y_off + n_rows for x_off, y_off, n_cols, n_rows in img_exts)
+    ref_arr = numpy.zeros((2, out_n_rows, out_n_cols), dtype=numpy.float32)
+    for i, (img_arr, (x_off, y_off, n_cols, n_rows)) in enumerate(
+        zip(img_arrs, img_exts)
+    ):
+        out_win = ref_arr[:, y_off : y_off + n_rows, x_off : x_off + n_cols]
+        copy_pxls = img_arr[0] != 0
+        if (overlap_behaviour > 0) and (i > 0):
+            no_data_pxls = out_win[0] == 0
+            if overlap_behaviour == 1:
+                replace_pxls = img_arr[0] < out_win[0]
+            else:
+                replace_pxls = img_arr[0] > out_win[0]
+            copy_pxls = copy_pxls & (no_data_pxls | replace_pxls)
+        out_win[:, copy_pxls] = numpy.round(img_arr[:, copy_pxls])
+
+    out_ds = gdal.Open(output_img)
+    out_arr = out_ds.ReadAsArray()
+    out_ds = None
+    assert numpy.array_equal(out_arr, ref_arr)
+
+
 @pytest.mark.skipif(
     True,
     reason="Worked with KEA but not with GTIFF - rounding error or something?",
@@ -625,7 +724,128 @@ def test_combine_imgs_to_band(tmp_path):
     assert os.path.exists(output_img)
 
 
-# TODO rsgislib.imageutils.create_ref_img_composite_img
+def _create_composite_test_img(
+    img_file, img_arr, gdal_type, gdalformat="GTiff", rat_img_names=None
+):
+    from osgeo import gdal
+
+    # Strips of 4 rows so the composites are created over several blocks.
+    creation_opts = []
+    if gdalformat == "GTiff":
+        creation_opts = ["BLOCKYSIZE=4"]
+    driver = gdal.GetDriverByName(gdalformat)
+    img_ds = driver.Create(
+        img_file,
+        img_arr.shape[2],
+        img_arr.shape[1],
+        img_arr.shape[0],
+        gdal_type,
+        options=creation_opts,
+    )
+    img_ds.SetGeoTransform((100.0, 1.0, 0.0, 500.0, 0.0, -1.0))
+    for n in range(img_arr.shape[0]):
+        img_ds.GetRasterBand(n + 1).WriteArray(img_arr[n])
+    if rat_img_names is not None:
+        rat = gdal.RasterAttributeTable()
+        rat.CreateColumn("Image", gdal.GFT_String, gdal.GFU_Generic)
+        rat.SetRowCount(len(rat_img_names))
+        for i, img_name in enumerate(rat_img_names):
+            rat.SetValueAsString(i, 0, img_name)
+        img_ds.GetRasterBand(1).SetDefaultRAT(rat)
+    img_ds = None
+
+
+def test_create_max_ndvi_composite_img(tmp_path, monkeypatch):
+    import numpy
+    from osgeo import gdal
+    import rsgislib
+    import rsgislib.imageutils
+
+    monkeypatch.setenv("RSGISLIB_IMG_CRT_OPTS_GTIFF", "BLOCKYSIZE=4")
+    rng = numpy.random.default_rng(23)
+    n_rows = 19
+    n_cols = 23
+    img_arrs = rng.integers(1, 200, size=(3, 3, n_rows, n_cols)).astype(numpy.float32)
+    # Pixels without a valid NDVI in some of the scenes.
+    for i in range(3):
+        img_arrs[i, 1][rng.random((n_rows, n_cols)) < 0.2] = 0
+        img_arrs[i, 2][rng.random((n_rows, n_cols)) < 0.2] = 0
+    # Pixels without a valid NDVI in any scene.
+    img_arrs[:, 1, 10, 3:9] = 0
+    # A block where every pixel is from the second scene.
+    img_arrs[1, 1, 4:8] = 1
+    img_arrs[1, 2, 4:8] = 1000
+
+    imgs = []
+    for i in range(3):
+        img_file = os.path.join(tmp_path, "in_img_{}.tif".format(i))
+        _create_composite_test_img(img_file, img_arrs[i], gdal.GDT_Float32)
+        imgs.append(img_file)
+
+    output_img = os.path.join(tmp_path, "out_img.tif")
+    rsgislib.imageutils.create_max_ndvi_composite_img(
+        imgs, output_img, 2, 3, "GTIFF", rsgislib.TYPE_32FLOAT
+    )
+
+    red_arr = img_arrs[:, 1]
+    nir_arr = img_arrs[:, 2]
+    with numpy.errstate(divide="ignore", invalid="ignore"):
+        ndvi_arr = (nir_arr - red_arr) / (nir_arr + red_arr)
+    ndvi_arr[(red_arr == 0) | (nir_arr == 0)] = -numpy.inf
+    # argmax returns the first scene with the maximum, and the first scene
+    # where no scene has a valid NDVI.
+    scn_idx_arr = numpy.argmax(ndvi_arr, axis=0)
+    assert numpy.all(scn_idx_arr[4:8] == 1)
+    assert numpy.all(scn_idx_arr[10, 3:9] == 0)
+    ref_arr = numpy.take_along_axis(
+        img_arrs, scn_idx_arr[numpy.newaxis, numpy.newaxis], axis=0
+    )[0]
+
+    out_ds = gdal.Open(output_img)
+    out_arr = out_ds.ReadAsArray()
+    out_ds = None
+    assert numpy.array_equal(out_arr, ref_arr)
+
+
+def test_create_ref_img_composite_img(tmp_path, monkeypatch):
+    import numpy
+    from osgeo import gdal
+    import rsgislib
+    import rsgislib.imageutils
+
+    monkeypatch.setenv("RSGISLIB_IMG_CRT_OPTS_GTIFF", "BLOCKYSIZE=4")
+    rng = numpy.random.default_rng(29)
+    n_rows = 19
+    n_cols = 23
+    img_arrs = rng.random((3, 2, n_rows, n_cols)).astype(numpy.float32) * 100
+    imgs = []
+    for i in range(3):
+        img_file = os.path.join(tmp_path, "in_img_{}.tif".format(i))
+        _create_composite_test_img(img_file, img_arrs[i], gdal.GDT_Float32)
+        imgs.append(img_file)
+
+    # 0 is no data, otherwise the scene index starting at 1.
+    ref_img_arr = rng.integers(0, 4, size=(1, n_rows, n_cols)).astype(numpy.uint8)
+    # A block where every pixel is from the second scene.
+    ref_img_arr[0, 4:8] = 2
+    ref_img = os.path.join(tmp_path, "ref_img.tif")
+    _create_composite_test_img(ref_img, ref_img_arr, gdal.GDT_Byte)
+
+    output_img = os.path.join(tmp_path, "out_img.tif")
+    rsgislib.imageutils.create_ref_img_composite_img(
+        imgs, output_img, ref_img, "GTIFF", rsgislib.TYPE_32FLOAT, -1.0
+    )
+
+    scn_idx_arr = numpy.maximum(ref_img_arr[0].astype(int) - 1, 0)
+    ref_arr = numpy.take_along_axis(
+        img_arrs, scn_idx_arr[numpy.newaxis, numpy.newaxis], axis=0
+    )[0]
+    ref_arr[:, ref_img_arr[0] == 0] = -1.0
+
+    out_ds = gdal.Open(output_img)
+    out_arr = out_ds.ReadAsArray()
+    out_ds = None
+    assert numpy.array_equal(out_arr, ref_arr)
 
 
 def test_combine_binary_masks(tmp_path):
@@ -657,7 +877,111 @@ def test_combine_binary_masks(tmp_path):
 
 # TODO rsgislib.imageutils.export_single_merged_img_band
 # TODO rsgislib.imageutils.order_img_using_prop_valid_pxls
-# TODO rsgislib.imageutils.gen_timeseries_fill_composite_img
+
+
+@pytest.mark.skipif(ON_MACOS, reason="skipping MacOS due to KEA/HDF5 issues")
+def test_gen_timeseries_fill_composite_img(tmp_path):
+    import numpy
+    from osgeo import gdal
+    import rsgislib
+    import rsgislib.imageutils
+
+    rng = numpy.random.default_rng(31)
+    n_rows = 19
+    n_cols = 23
+    # Listed out of date order; 2019 is filled, first from 2018 then 2016.
+    years = [2016, 2019, 2018]
+    comp_arrs = dict()
+    ref_arrs = dict()
+    comp_info = []
+    for year in years:
+        comp_arrs[year] = rng.random((2, n_rows, n_cols)).astype(numpy.float32) * 100
+        ref_arrs[year] = rng.integers(0, 4, size=(n_rows, n_cols)).astype(numpy.int32)
+        ref_arrs[year][rng.random((n_rows, n_cols)) < 0.4] = 0
+        comp_img = os.path.join(tmp_path, "comp_{}.tif".format(year))
+        _create_composite_test_img(comp_img, comp_arrs[year], gdal.GDT_Float32)
+        ref_img = os.path.join(tmp_path, "comp_ref_{}.kea".format(year))
+        _create_composite_test_img(
+            ref_img,
+            ref_arrs[year][numpy.newaxis],
+            gdal.GDT_Int32,
+            gdalformat="KEA",
+            rat_img_names=[""] + ["scn_{}_{}".format(year, i) for i in range(1, 4)],
+        )
+        comp_info.append(
+            rsgislib.imageutils.RSGISTimeseriesFillInfo(
+                year=year,
+                day=0,
+                compImg=comp_img,
+                imgRef=ref_img,
+                outRef=(year == 2019),
+            )
+        )
+
+    vld_arr = (rng.random((1, n_rows, n_cols)) < 0.9).astype(numpy.uint8)
+    vld_img = os.path.join(tmp_path, "vld_img.tif")
+    _create_composite_test_img(vld_img, vld_arr, gdal.GDT_Byte)
+
+    out_ref_fill_img = os.path.join(tmp_path, "out_ref_fill.kea")
+    out_comp_img = os.path.join(tmp_path, "out_comp.tif")
+    out_comp_ref_img = os.path.join(tmp_path, "out_comp_ref.kea")
+    rsgislib.imageutils.gen_timeseries_fill_composite_img(
+        comp_info,
+        vld_img,
+        out_ref_fill_img,
+        out_comp_img,
+        out_comp_ref_img,
+        "GTIFF",
+        rsgislib.TYPE_32FLOAT,
+    )
+
+    # The fill reference is the index of the date (1 being the date filled)
+    # sorted by the distance from the date filled, plus 1.
+    to_fill = (vld_arr[0] == 1) & (ref_arrs[2019] == 0)
+    ref_fill_arr = numpy.zeros((n_rows, n_cols), dtype=numpy.int32)
+    ref_fill_arr[to_fill & (ref_arrs[2016] > 0)] = 3
+    ref_fill_arr[to_fill & (ref_arrs[2018] > 0)] = 2
+    assert numpy.any(ref_fill_arr == 2) and numpy.any(ref_fill_arr == 3)
+
+    ref_comp_arr = comp_arrs[2019].copy()
+    ref_comp_arr[:, ref_fill_arr == 2] = comp_arrs[2018][:, ref_fill_arr == 2]
+    ref_comp_arr[:, ref_fill_arr == 3] = comp_arrs[2016][:, ref_fill_arr == 3]
+
+    out_ds = gdal.Open(out_ref_fill_img)
+    out_ref_fill_arr = out_ds.ReadAsArray()
+    out_ds = None
+    assert numpy.array_equal(out_ref_fill_arr, ref_fill_arr)
+
+    out_ds = gdal.Open(out_comp_img)
+    out_comp_arr = out_ds.ReadAsArray()
+    out_ds = None
+    assert numpy.array_equal(out_comp_arr, ref_comp_arr)
+
+    # The output reference image refers to the scenes through its FileName column.
+    out_ds = gdal.Open(out_comp_ref_img)
+    out_comp_ref_arr = out_ds.ReadAsArray()
+    out_rat = out_ds.GetRasterBand(1).GetDefaultRAT()
+    file_name_col = [
+        out_rat.GetNameOfCol(i) for i in range(out_rat.GetColumnCount())
+    ].index("FileName")
+    out_file_names = [
+        out_rat.GetValueAsString(i, file_name_col) for i in range(out_rat.GetRowCount())
+    ]
+    out_ds = None
+    fill_years = {2: 2018, 3: 2016}
+    vld_ref_2019 = (vld_arr[0] == 1) & (ref_arrs[2019] > 0)
+    for row in range(n_rows):
+        for col in range(n_cols):
+            out_ref_val = out_comp_ref_arr[row, col]
+            if vld_ref_2019[row, col]:
+                assert out_ref_val == ref_arrs[2019][row, col]
+            elif ref_fill_arr[row, col] > 0:
+                fill_year = fill_years[ref_fill_arr[row, col]]
+                assert out_file_names[out_ref_val] == "scn_{}_{}".format(
+                    fill_year, ref_arrs[fill_year][row, col]
+                )
+            else:
+                assert out_ref_val == 0
 
 
 def test_create_tiles(tmp_path):
@@ -2,6 +2,7 @@ import os
 from shutil import copy2
 import sys
 import pytest
+import rsgislib
 
 os_pltform = sys.platform
 
@@ -9,6 +10,12 @@ ON_MACOS = False
 if os_pltform == "darwin":
     ON_MACOS = True
 
+H5PY_NOT_AVAIL = False
+try:
+    import h5py
+except ImportError:
+    H5PY_NOT_AVAIL = True
+
 DATA_DIR = os.path.join(os.path.dirname(os.path.abspath(__file__)), "data")
 RASTERGIS_DATA_DIR = os.path.join(DATA_DIR, "rastergis")
 CLASSIFICATION_DATA_DIR = os.path.join(DATA_DIR, "classification")
@@ -89,7 +96,8 @@ def test_get_rat_columns_info():
     assert correct_info
 
 @pytest.mark.skipif(ON_MACOS, reason="skipping MacOS due to KEA/HDF5 issues")
-def test_populate_rat_with_stats(tmp_path):
+@pytest.mark.parametrize("n_threads", [1, 4])
+def test_populate_rat_with_stats(tmp_path, n_threads):
     import rsgislib.rastergis
     import numpy
 
@@ -141,7 +149,9 @@ def test_populate_rat_with_stats(tmp_path):
         )
     )
 
-    rsgislib.rastergis.populate_rat_with_stats(input_img, clumps_img, band_stats)
+    rsgislib.rastergis.populate_rat_with_stats(
+        input_img, clumps_img, band_stats, n_threads=n_threads
+    )
 
     ref_clumps_img = os.path.join(
         RASTERGIS_DATA_DIR, "sen2_20210527_aber_clumps_attref.kea"
@@ -167,7 +177,12 @@ def test_populate_rat_with_stats(tmp_path):
         if calcd_vals.shape[0] != ref_vals.shape[0]:
             vars_eq_vals = False
             break
-        if numpy.sum(calcd_vals) != numpy.sum(ref_vals):
+        if "StdDev" in var:
+            # Single pass (Welford) rather than two pass, so allow for rounding.
+            if not numpy.isclose(numpy.sum(calcd_vals), numpy.sum(ref_vals), rtol=1e-9):
+                vars_eq_vals = False
+                break
+        elif numpy.sum(calcd_vals) != numpy.sum(ref_vals):
             vars_eq_vals = False
             break
 
@@ -304,6 +319,71 @@ def test_find_neighbours(tmp_path):
     rsgislib.rastergis.find_neighbours(clumps_img, 1)
 
 
+def _find_ref_clump_neighbours(clumps_img, n_clumps):
+    import numpy
+    from osgeo import gdal
+
+    img_ds = gdal.Open(clumps_img)
+    clumps_arr = img_ds.GetRasterBand(1).ReadAsArray().astype(numpy.int64)
+    img_ds = None
+
+    # Pairs of 4-connected pixels with different clumps, ignoring clump 0.
+    nbr_pairs = list()
+    for clumps_a, clumps_b in [
+        (clumps_arr[:, :-1], clumps_arr[:, 1:]),
+        (clumps_arr[:-1, :], clumps_arr[1:, :]),
+    ]:
+        msk = (clumps_a != clumps_b) & (clumps_a != 0) & (clumps_b != 0)
+        nbr_pairs.append(numpy.stack([clumps_a[msk], clumps_b[msk]], axis=1))
+    nbr_pairs = numpy.concatenate(nbr_pairs)
+    nbr_pairs = numpy.unique(
+        numpy.concatenate([nbr_pairs, nbr_pairs[:, ::-1]]), axis=0
+    )
+
+    neighbours = [list() for i in range(n_clumps)]
+    for clump_a, clump_b in nbr_pairs.tolist():
+        neighbours[clump_a].append(clump_b)
+    return neighbours
+
+
+@pytest.mark.skipif(
+    (ON_MACOS or H5PY_NOT_AVAIL),
+    reason="skipping MacOS due to KEA/HDF5 issues or h5py dependency not available",
+)
+def test_find_neighbours_threads(tmp_path):
+    import numpy
+    import rsgislib.rastergis
+
+    input_ref_img = os.path.join(DATA_DIR, "sen2_20210527_aber_clumps.kea")
+    clumps_1t_img = os.path.join(tmp_path, "sen2_20210527_aber_clumps_1t.kea")
+    copy2(input_ref_img, clumps_1t_img)
+    clumps_4t_img = os.path.join(tmp_path, "sen2_20210527_aber_clumps_4t.kea")
+    copy2(input_ref_img, clumps_4t_img)
+
+    rsgislib.rastergis.find_neighbours(clumps_1t_img, 1, n_threads=1)
+    rsgislib.rastergis.find_neighbours(clumps_4t_img, 1, n_threads=4)
+
+    n_nbrs_1t = rsgislib.rastergis.get_column_data(clumps_1t_img, "NumNeighbours")
+    n_nbrs_4t = rsgislib.rastergis.get_column_data(clumps_4t_img, "NumNeighbours")
+    assert n_nbrs_1t[0] == 0
+    assert numpy.sum(n_nbrs_1t) > 0
+    assert numpy.array_equal(n_nbrs_1t, n_nbrs_4t)
+
+    # The neighbour lists are sorted, so should be identical between the number
+    # of threads and to the neighbours found from the clump pixels.
+    nbrs_1t = rsgislib.rastergis.read_rat_neighbours(clumps_1t_img)
+    nbrs_4t = rsgislib.rastergis.read_rat_neighbours(clumps_4t_img)
+    ref_nbrs = _find_ref_clump_neighbours(input_ref_img, n_nbrs_1t.shape[0])
+    assert len(nbrs_1t) == len(ref_nbrs)
+    assert len(nbrs_4t) == len(ref_nbrs)
+    for clump_nbrs_1t, clump_nbrs_4t, clump_ref_nbrs, n_nbrs in zip(
+        nbrs_1t, nbrs_4t, ref_nbrs, n_nbrs_1t
+    ):
+        assert list(clump_nbrs_1t) == clump_ref_nbrs
+        assert list(clump_nbrs_4t) == clump_ref_nbrs
+        assert n_nbrs == len(clump_ref_nbrs)
+
+
 # TODO rsgislib.rastergis.populate_rat_with_cat_proportions
 
 @pytest.mark.skipif(ON_MACOS, reason="skipping MacOS due to KEA/HDF5 issues")
@@ -330,6 +410,135 @@ def test_populate_rat_with_percentiles(tmp_path):
         input_img, clumps_img, 1, band_percents
     )
 
+def _read_rastergis_test_band(img_file, img_band=1):
+    from osgeo import gdal
+
+    img_ds = gdal.Open(img_file)
+    band_arr = img_ds.GetRasterBand(img_band).ReadAsArray()
+    no_data_val = img_ds.GetRasterBand(img_band).GetNoDataValue()
+    img_ds = None
+    return band_arr, no_data_val
+
+
+def _get_clump_pxl_vals(clumps_arr, vals_arr, vld_msk):
+    # Split the valid pixel values into an array for each clump ID.
+    import numpy
+
+    clump_ids = clumps_arr[vld_msk & (clumps_arr > 0)].astype(numpy.int64)
+    clump_vals = vals_arr[vld_msk & (clumps_arr > 0)]
+    sort_idxs = numpy.argsort(clump_ids, kind="stable")
+    clump_ids = clump_ids[sort_idxs]
+    clump_vals = clump_vals[sort_idxs]
+    uniq_ids, start_idxs = numpy.unique(clump_ids, return_index=True)
+    return dict(zip(uniq_ids, numpy.split(clump_vals, start_idxs[1:])))
+
+
+@pytest.mark.skipif(ON_MACOS, reason="skipping MacOS due to KEA/HDF5 issues")
+def test_populate_rat_with_percentiles_numpy(tmp_path):
+    import numpy
+    import rsgislib.rastergis
+
+    input_ref_img = os.path.join(DATA_DIR, "sen2_20210527_aber_clumps.kea")
+    clumps_img = os.path.join(tmp_path, "sen2_20210527_aber_clumps.kea")
+    copy2(input_ref_img, clumps_img)
+
+    input_img = os.path.join(DATA_DIR, "sen2_20210527_aber.tif")
+    n_hist_bins = 200
+    percentiles = [5.0, 25.0, 50.0, 75.0, 100.0]
+
+    band_percents = []
+    for percentile in percentiles:
+        band_percents.append(
+            rsgislib.rastergis.BandAttPercentiles(
+                percentile=percentile, field_name="B1Per{}".format(int(percentile))
+            )
+        )
+    rsgislib.rastergis.populate_rat_with_percentiles(
+        input_img, clumps_img, 1, band_percents, n_hist_bins=n_hist_bins
+    )
+
+    clumps_arr, _ = _read_rastergis_test_band(clumps_img)
+    vals_arr, no_data_val = _read_rastergis_test_band(input_img)
+    vals_arr = vals_arr.astype(numpy.float64)
+    vld_msk = numpy.isfinite(vals_arr)
+    if no_data_val is not None:
+        vld_msk = vld_msk & (vals_arr != no_data_val)
+
+    # The histogram bins as defined by populate_rat_with_percentiles; each
+    # percentile is the centre of the bin holding the floor(n * p / 100)th value.
+    img_min = numpy.min(vals_arr[vld_msk])
+    img_max = numpy.max(vals_arr[vld_msk])
+    bin_width = ((img_max - img_min) + 1) / float(n_hist_bins)
+    bin_bounds = (img_min - bin_width) + (numpy.arange(n_hist_bins) * bin_width)
+    clump_pxl_vals = _get_clump_pxl_vals(clumps_arr, vals_arr, vld_msk)
+    hist_vals = rsgislib.rastergis.get_column_data(clumps_img, "Histogram")
+
+    for percentile in percentiles:
+        rat_vals = rsgislib.rastergis.get_column_data(
+            clumps_img, "B1Per{}".format(int(percentile))
+        )
+        ref_vals = numpy.zeros_like(rat_vals)
+        for clump_id in range(1, ref_vals.shape[0]):
+            if hist_vals[clump_id] == 0:
+                continue
+            clump_vals = clump_pxl_vals.get(clump_id, numpy.zeros(0))
+            bin_counts = numpy.bincount(
+                numpy.searchsorted(bin_bounds, clump_vals, side="right") - 1,
+                minlength=n_hist_bins,
+            )
+            assert numpy.sum(bin_counts) == clump_vals.shape[0]
+            # The percentile is a float32 in populate_rat_with_percentiles.
+            per_frac = numpy.float32(percentile) / numpy.float32(100)
+            per_count = numpy.floor(clump_vals.shape[0] * numpy.float64(per_frac))
+            per_bin = 0
+            if per_count > 0:
+                per_bin = numpy.argmax(numpy.cumsum(bin_counts) >= per_count)
+            ref_vals[clump_id] = bin_bounds[per_bin] + (bin_width / 2)
+
+            # The bin centre is within half a bin of a value within the clump.
+            if per_count > 0:
+                sorted_vals = numpy.sort(clump_vals)
+                per_val = sorted_vals[int(per_count) - 1]
+                assert abs(ref_vals[clump_id] - per_val) <= (bin_width / 2)
+        numpy.testing.assert_allclose(rat_vals, ref_vals, rtol=0, atol=1e-9)
+
+
+@pytest.mark.skipif(ON_MACOS, reason="skipping MacOS due to KEA/HDF5 issues")
+def test_populate_rat_with_mode_numpy(tmp_path):
+    import numpy
+    import rsgislib.rastergis
+
+    input_ref_img = os.path.join(DATA_DIR, "sen2_20210527_aber_clumps.kea")
+    clumps_img = os.path.join(tmp_path, "sen2_20210527_aber_clumps.kea")
+    copy2(input_ref_img, clumps_img)
+
+    in_cls_img = os.path.join(DATA_DIR, "sen2_20210527_aber_cls.tif")
+    rsgislib.rastergis.populate_rat_with_mode(
+        in_cls_img,
+        clumps_img,
+        out_cols_name="cls_val",
+        use_no_data=True,
+        no_data_val=0,
+        out_no_data=0,
+        mode_band=1,
+        rat_band=1,
+    )
+
+    clumps_arr, _ = _read_rastergis_test_band(clumps_img)
+    cls_arr, _ = _read_rastergis_test_band(in_cls_img)
+    cls_arr = cls_arr.astype(numpy.int64)
+    clump_pxl_vals = _get_clump_pxl_vals(clumps_arr, cls_arr, cls_arr != 0)
+
+    # The counts of each value are exact, so the mode (ties to the smallest
+    # value) matches numpy; clumps without any values are given no data (0).
+    rat_vals = rsgislib.rastergis.get_column_data(clumps_img, "cls_val")
+    ref_vals = numpy.zeros_like(rat_vals)
+    for clump_id, clump_vals in clump_pxl_vals.items():
+        uniq_vals, val_counts = numpy.unique(clump_vals, return_counts=True)
+        ref_vals[clump_id] = uniq_vals[numpy.argmax(val_counts)]
+    assert numpy.array_equal(rat_vals, ref_vals)
+
+
 @pytest.mark.skipif(ON_MACOS, reason="skipping MacOS due to KEA/HDF5 issues")
 def test_populate_rat_with_meanlit_stats(tmp_path):
     import rsgislib.rastergis
@@ -568,10 +777,116 @@ def test_get_global_class_stats(tmp_path):
     )
 
 
+def _create_knn_test_clumps(clumps_img, n_cols, n_rows):
+    # A clumps image where every pixel is its own clump (1 to n_cols x n_rows).
+    import numpy
+    from osgeo import gdal
+    import rsgislib.rastergis
+
+    clumps_arr = numpy.arange(1, (n_cols * n_rows) + 1, dtype=numpy.uint32)
+    driver = gdal.GetDriverByName("KEA")
+    img_ds = driver.Create(clumps_img, n_cols, n_rows, 1, gdal.GDT_UInt32)
+    img_ds.SetGeoTransform((0.0, 1.0, 0.0, float(n_rows), 0.0, -1.0))
+    img_ds.GetRasterBand(1).WriteArray(clumps_arr.reshape((n_rows, n_cols)))
+    img_ds = None
+    rsgislib.rastergis.pop_rat_img_stats(
+        clumps_img, add_clr_tab=False, calc_pyramids=False, ignore_zero=True
+    )
+
+
+def _calc_ref_rat_knn(feats, vals, train_msk, k_feat, dist_knn, dist_thres, sum_type):
+    # Brute force KNN with the distances of rsgislib.math.RSGISDistMetrics; the
+    # neighbours are ordered by distance with ties in the training order.
+    import numpy
+    import rsgislib
+
+    train_feats = feats[train_msk]
+    train_vals = vals[train_msk]
+    n_feats = feats.shape[1]
+    inv_covar = numpy.linalg.inv(numpy.cov(train_feats, rowvar=False))
+    out_vals = numpy.full(feats.shape[0], numpy.nan)
+    for row in range(feats.shape[0]):
+        diffs = train_feats - feats[row]
+        if dist_knn == rsgislib.DIST_EUCLIDEAN:
+            dists = numpy.sqrt(numpy.sum(diffs**2, axis=1) / n_feats)
+        elif dist_knn == rsgislib.DIST_MANHATTEN:
+            dists = numpy.sqrt(numpy.sum(numpy.abs(diffs), axis=1) / n_feats)
+        else:
+            dists = numpy.sqrt(numpy.einsum("ij,jk,ik->i", diffs, inv_covar, diffs))
+        nn_idxs = numpy.nonzero(dists < dist_thres)[0]
+        nn_idxs = nn_idxs[numpy.argsort(dists[nn_idxs], kind="stable")][:k_feat]
+        if nn_idxs.shape[0] == 0:
+            continue
+        if sum_type == rsgislib.SUMTYPE_MEAN:
+            out_vals[row] = numpy.mean(train_vals[nn_idxs])
+        else:
+            out_vals[row] = numpy.max(train_vals[nn_idxs])
+    return out_vals
+
+
+@pytest.mark.skipif(ON_MACOS, reason="skipping MacOS due to KEA/HDF5 issues")
+@pytest.mark.parametrize(
+    "dist_knn, dist_thres",
+    [
+        (rsgislib.DIST_EUCLIDEAN, 100000),
+        (rsgislib.DIST_EUCLIDEAN, 0.08),
+        (rsgislib.DIST_MANHATTEN, 100000),
+        (rsgislib.DIST_MANHATTEN, 0.25),
+        (rsgislib.DIST_MAHALANOBIS, 100000),
+        (rsgislib.DIST_MAHALANOBIS, 0.6),
+    ],
+)
+@pytest.mark.parametrize("sum_type", [rsgislib.SUMTYPE_MEAN, rsgislib.SUMTYPE_MAX])
+def test_apply_rat_knn_brute_force_threads(tmp_path, dist_knn, dist_thres, sum_type):
+    import numpy
+    import rsgislib.rastergis
+
+    clumps_img = os.path.join(tmp_path, "knn_clumps.kea")
+    _create_knn_test_clumps(clumps_img, 30, 20)
+    n_rows = rsgislib.rastergis.get_rat_length(clumps_img)
+
+    rng = numpy.random.default_rng(11)
+    feats = rng.uniform(0.0, 1.0, (n_rows, 3))
+    feats[:, 2] = (feats[:, 2] * 0.5) + (feats[:, 0] * 0.5)
+    vals = rng.uniform(0.0, 100.0, n_rows)
+    train_msk = rng.uniform(0.0, 1.0, n_rows) < 0.3
+    feat_cols = ["feat1", "feat2", "feat3"]
+    for i, feat_col in enumerate(feat_cols):
+        rsgislib.rastergis.set_column_data(clumps_img, feat_col, feats[:, i])
+    rsgislib.rastergis.set_column_data(clumps_img, "val", vals)
+    rsgislib.rastergis.set_column_data(
+        clumps_img, "train", train_msk.astype(numpy.int32)
+    )
+
+    k_feat = 5
+    out_cols = []
+    for n_threads in [1, 4]:
+        out_col = "knn_val_{}t".format(n_threads)
+        rsgislib.rastergis.apply_rat_knn(
+            clumps_img,
+            "val",
+            out_col,
+            "train",
+            None,
+            feat_cols,
+            k_feat=k_feat,
+            dist_knn=dist_knn,
+            summerise_knn=sum_type,
+            dist_thres=dist_thres,
+            n_threads=n_threads,
+        )
+        out_cols.append(rsgislib.rastergis.get_column_data(clumps_img, out_col))
+
+    ref_vals = _calc_ref_rat_knn(
+        feats, vals, train_msk, k_feat, dist_knn, dist_thres, sum_type
+    )
+    numpy.testing.assert_array_equal(out_cols[0], out_cols[1])
+    numpy.testing.assert_allclose(out_cols[0], ref_vals, rtol=1e-9)
+
+
 # TODO rsgislib.rastergis.str_class_majority
 # TODO rsgislib.rastergis.histo_sampling
 # TODO rsgislib.rastergis.class_split_fit_hist_gausian_mixture_model
-# TODO rsgislib.rastergis.apply_rat_knn
 # TODO rsgislib.rastergis.get_global_class_stats
 # TODO rsgislib.rastergis.fit_hist_gausian_mixture_model
 # TODO rsgislib.rastergis.calc_1d_jm_distance
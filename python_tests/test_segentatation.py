@@ -30,6 +30,148 @@ def test_clump(tmp_path):
     assert os.path.exists(clumps_img)
 
 
+def _create_clump_test_img(img_file, n_cols, n_rows):
+    import numpy
+    from osgeo import gdal
+
+    rng = numpy.random.default_rng(7)
+    img_arr = rng.integers(0, 4, size=(n_rows, n_cols)).astype(numpy.uint32)
+    driver = gdal.GetDriverByName("GTiff")
+    img_ds = driver.Create(img_file, n_cols, n_rows, 1, gdal.GDT_UInt32)
+    img_ds.SetGeoTransform((0.0, 1.0, 0.0, float(n_rows), 0.0, -1.0))
+    img_ds.GetRasterBand(1).WriteArray(img_arr)
+    img_ds = None
+    return img_arr
+
+
+def _flood_fill_clumps(img_arr, no_data_val, use_8_conn):
+    # Flood fill started at each unlabelled pixel in scan order, as the
+    # original clumping implementation.
+    import numpy
+
+    n_rows, n_cols = img_arr.shape
+    clumps_arr = numpy.zeros_like(img_arr, dtype=numpy.uint32)
+    if use_8_conn:
+        nbr_offs = [(-1, -1), (-1, 0), (-1, 1), (0, -1), (0, 1), (1, -1), (1, 0), (1, 1)]
+    else:
+        nbr_offs = [(-1, 0), (0, -1), (0, 1), (1, 0)]
+    n_clumps = 0
+    for row in range(n_rows):
+        for col in range(n_cols):
+            if (img_arr[row, col] == no_data_val) or (clumps_arr[row, col] != 0):
+                continue
+            n_clumps += 1
+            clumps_arr[row, col] = n_clumps
+            pxls = [(row, col)]
+            while pxls:
+                p_row, p_col = pxls.pop()
+                for d_row, d_col in nbr_offs:
+                    n_row = p_row + d_row
+                    n_col = p_col + d_col
+                    if (
+                        (0 <= n_row < n_rows)
+                        and (0 <= n_col < n_cols)
+                        and (clumps_arr[n_row, n_col] == 0)
+                        and (img_arr[n_row, n_col] == img_arr[row, col])
+                    ):
+                        clumps_arr[n_row, n_col] = n_clumps
+                        pxls.append((n_row, n_col))
+    return clumps_arr, n_clumps
+
+
+@pytest.mark.skipif(ON_MACOS, reason="skipping MacOS due to KEA/HDF5 issues")
+@pytest.mark.parametrize("use_8_conn", [False, True])
+def test_clump_vs_flood_fill(tmp_path, use_8_conn):
+    import numpy
+    from osgeo import gdal
+    import rsgislib.segmentation
+
+    input_img = os.path.join(tmp_path, "clump_test_img.tif")
+    img_arr = _create_clump_test_img(input_img, 37, 29)
+    ref_clumps_arr, ref_n_clumps = _flood_fill_clumps(img_arr, 0, use_8_conn)
+
+    clumps_img = os.path.join(tmp_path, "out_img.kea")
+    rsgislib.segmentation.clump(
+        input_img,
+        clumps_img,
+        gdalformat="KEA",
+        in_memory=False,
+        no_data_val=0,
+        add_to_rat=False,
+        use_8_conn=use_8_conn,
+    )
+    clumps_ds = gdal.Open(clumps_img)
+    clumps_arr = clumps_ds.GetRasterBand(1).ReadAsArray()
+    clumps_ds = None
+
+    assert int(clumps_arr.max()) == ref_n_clumps
+    assert numpy.array_equal(clumps_arr, ref_clumps_arr)
+
+
+def _create_clump_seam_test_img(img_file, n_cols, n_rows):
+    # Blocks of values with some noise, plus a 'U' whose arms only join below
+    # the first strip seams and a diagonal line only connected with 8-conn.
+    import numpy
+    from osgeo import gdal
+
+    rng = numpy.random.default_rng(11)
+    blks_arr = rng.integers(0, 4, size=((n_rows // 5) + 1, (n_cols // 7) + 1))
+    img_arr = numpy.repeat(numpy.repeat(blks_arr, 5, axis=0), 7, axis=1)
+    img_arr = img_arr[:n_rows, :n_cols].astype(numpy.uint32)
+    noise_msk = rng.random((n_rows, n_cols)) < 0.05
+    img_arr[noise_msk] = rng.integers(0, 4, size=int(noise_msk.sum()))
+    img_arr[10:151, 2] = 5
+    img_arr[10:151, 12] = 5
+    img_arr[150, 2:13] = 5
+    for row in range(30, 126):
+        img_arr[row, row - 10] = 6
+
+    driver = gdal.GetDriverByName("GTiff")
+    img_ds = driver.Create(img_file, n_cols, n_rows, 1, gdal.GDT_UInt32)
+    img_ds.SetGeoTransform((0.0, 1.0, 0.0, float(n_rows), 0.0, -1.0))
+    img_ds.GetRasterBand(1).WriteArray(img_arr)
+    img_ds = None
+    return img_arr
+
+
+@pytest.mark.skipif(ON_MACOS, reason="skipping MacOS due to KEA/HDF5 issues")
+@pytest.mark.parametrize("use_8_conn", [False, True])
+def test_clump_threads(tmp_path, use_8_conn):
+    import numpy
+    from osgeo import gdal
+    import rsgislib.rastergis
+    import rsgislib.segmentation
+
+    # 300 rows spans several 64 row strips and chunks (of 64 x n_threads rows)
+    # so the labels are merged across both strip and chunk seams.
+    input_img = os.path.join(tmp_path, "clump_test_img.tif")
+    img_arr = _create_clump_seam_test_img(input_img, 120, 300)
+    ref_clumps_arr, ref_n_clumps = _flood_fill_clumps(img_arr, 0, use_8_conn)
+    ref_pxl_vals = numpy.zeros(ref_n_clumps + 1, dtype=numpy.uint32)
+    ref_pxl_vals[ref_clumps_arr] = img_arr
+
+    for n_threads in [1, 2, 3, 4]:
+        clumps_img = os.path.join(tmp_path, f"out_img_{n_threads}.kea")
+        rsgislib.segmentation.clump(
+            input_img,
+            clumps_img,
+            gdalformat="KEA",
+            in_memory=False,
+            no_data_val=0,
+            add_to_rat=True,
+            use_8_conn=use_8_conn,
+            n_threads=n_threads,
+        )
+        clumps_ds = gdal.Open(clumps_img)
+        clumps_arr = clumps_ds.GetRasterBand(1).ReadAsArray()
+        clumps_ds = None
+        pxl_vals = rsgislib.rastergis.get_column_data(clumps_img, "PixelVal")
+
+        assert int(clumps_arr.max()) == ref_n_clumps
+        assert numpy.array_equal(clumps_arr, ref_clumps_arr)
+        assert numpy.array_equal(pxl_vals[1:], ref_pxl_vals[1:])
+
+
 # TODO rsgislib.segmentation.label_pixels_from_cluster_centres
 # TODO rsgislib.segmentation.relabel_clumps
 # TODO rsgislib.segmentation.eliminate_single_pixels
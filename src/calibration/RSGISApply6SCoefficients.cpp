@@ -81,7 +81,7 @@ namespace rsgis{namespace calib{
         {            
             for(unsigned int i = 0; i < this->numValues; ++i)
             {
-                if(imageBands[i] > numBands)
+                if(imageBands[i] >= numBands)
                 {
                     std::cout << "Image band: " << imageBands[i] << std::endl;
                     throw rsgis::img::RSGISImageCalcException("Image band is not within image.");
@@ -110,6 +110,84 @@ namespace rsgis{namespace calib{
         
     }
     
+    void RSGISApply6SCoefficientsSingleParam::calcImageValueBlock(float **blockData, int numBands, int width, int height, double **output)
+    {
+        if(numValues != this->numOutBands)
+        {
+            throw rsgis::img::RSGISImageCalcException("The number of input image bands needs to be equal to the number of output image bands.");
+        }
+        
+        if(numBands != numValues)
+        {
+            throw rsgis::img::RSGISImageCalcException("The number of input values needs to be equal to the number of input image bands.");
+        }
+        
+        size_t numPxls = ((size_t)width) * ((size_t)height);
+        
+        // A pixel is no data if all the input bands are equal to the no data value.
+        std::vector<char> nodata(numPxls, 0);
+        if(this->useNoDataVal)
+        {
+            std::fill(nodata.begin(), nodata.end(), 1);
+            for(int i = 0; i < numBands; ++i)
+            {
+                float *inBandVals = blockData[i];
+                for(size_t j = 0; j < numPxls; ++j)
+                {
+                    if(inBandVals[j] != this->noDataVal)
+                    {
+                        nodata[j] = 0;
+                    }
+                }
+            }
+        }
+        
+        double tmpVal = 0;
+        for(unsigned int i = 0; i < this->numValues; ++i)
+        {
+            if(imageBands[i] >= numBands)
+            {
+                std::cout << "Image band: " << imageBands[i] << std::endl;
+                throw rsgis::img::RSGISImageCalcException("Image band is not within image.");
+            }
+            
+            float *inBandVals = blockData[imageBands[i]];
+            double *outBandVals = output[i];
+            for(size_t j = 0; j < numPxls; ++j)
+            {
+                if(nodata[j])
+                {
+                    outBandVals[j] = 0;
+                    continue;
+                }
+                
+                tmpVal=aX[i]*inBandVals[j]-bX[i];
+                outBandVals[j] = (tmpVal/(1.0+cX[i]*tmpVal))*this->scaleFactor;
+                
+                if(this->useNoDataVal & (this->noDataVal == 0.0))
+                {
+                    if(outBandVals[j] < 1)
+                    {
+                        outBandVals[j] = 1.0;
+                    }
+                    else
+                    {
+                        outBandVals[j] = outBandVals[j] + 1.0;
+                    }
+                }
+                if(outBandVals[j] > this->scaleFactor)
+                {
+                    outBandVals[j] = this->scaleFactor;
+                }
+            }
+        }
+    }
+    
+    rsgis::img::RSGISCalcImageValue* RSGISApply6SCoefficientsSingleParam::clone()
+    {
+        return new RSGISApply6SCoefficientsSingleParam(this->imageBands, this->aX, this->bX, this->cX, this->numValues, this->noDataVal, this->useNoDataVal, this->scaleFactor);
+    }
+    
     RSGISApply6SCoefficientsSingleParam::~RSGISApply6SCoefficientsSingleParam()
     {
         
@@ -305,6 +383,157 @@ namespace rsgis{namespace calib{
         this->scaleFactor = scaleFactor;
         this->noDataVal = noDataVal;
         this->useNoDataVal = useNoDataVal;
+        this->numValues = 0;
+        
+        if(lut->size() == 0)
+        {
+            throw rsgis::img::RSGISImageCalcException("The elevation LUT is empty.");
+        }
+        
+        // Order the elevation levels, where an elevation is repeated the first is used.
+        std::vector<unsigned int> elevOrder;
+        for(unsigned int i = 0; i < lut->size(); ++i)
+        {
+            elevOrder.push_back(i);
+        }
+        std::stable_sort(elevOrder.begin(), elevOrder.end(), [lut](unsigned int a, unsigned int b){return lut->at(a).elev < lut->at(b).elev;});
+        
+        bool first = true;
+        size_t numEntries = 0;
+        for(std::vector<unsigned int>::iterator iterElev = elevOrder.begin(); iterElev != elevOrder.end(); ++iterElev)
+        {
+            LUT6SBaseElevAOT *elevLUT = &lut->at(*iterElev);
+            if((this->elevAxis.levels.size() > 0) && (elevLUT->elev == this->elevAxis.levels.back()))
+            {
+                continue;
+            }
+            if(elevLUT->aotLUT.size() == 0)
+            {
+                throw rsgis::img::RSGISImageCalcException("The AOT LUT is empty.");
+            }
+            this->elevAxis.levels.push_back(elevLUT->elev);
+            this->elevLUTOffsets.push_back(numEntries);
+            
+            std::vector<unsigned int> aotOrder;
+            for(unsigned int i = 0; i < elevLUT->aotLUT.size(); ++i)
+            {
+                aotOrder.push_back(i);
+            }
+            std::stable_sort(aotOrder.begin(), aotOrder.end(), [elevLUT](unsigned int a, unsigned int b){return elevLUT->aotLUT.at(a).aot < elevLUT->aotLUT.at(b).aot;});
+            
+            LUTAxis aotAxis;
+            for(std::vector<unsigned int>::iterator iterAOT = aotOrder.begin(); iterAOT != aotOrder.end(); ++iterAOT)
+            {
+                LUT6SAOT *aotLUT = &elevLUT->aotLUT.at(*iterAOT);
+                if((aotAxis.levels.size() > 0) && (aotLUT->aot == aotAxis.levels.back()))
+                {
+                    continue;
+                }
+                
+                if(first)
+                {
+                    this->numValues = aotLUT->numValues;
+                    this->imageBands.assign(aotLUT->imageBands, aotLUT->imageBands + aotLUT->numValues);
+                    first = false;
+                }
+                else if((aotLUT->numValues != this->numValues) || !std::equal(this->imageBands.begin(), this->imageBands.end(), aotLUT->imageBands))
+                {
+                    throw rsgis::img::RSGISImageCalcException("All the LUT entries must have coefficients for the same image bands.");
+                }
+                
+                aotAxis.levels.push_back(aotLUT->aot);
+                this->aX.insert(this->aX.end(), aotLUT->aX, aotLUT->aX + aotLUT->numValues);
+                this->bX.insert(this->bX.end(), aotLUT->bX, aotLUT->bX + aotLUT->numValues);
+                this->cX.insert(this->cX.end(), aotLUT->cX, aotLUT->cX + aotLUT->numValues);
+                ++numEntries;
+            }
+            this->createLUTAxis(&aotAxis);
+            this->aotAxes.push_back(aotAxis);
+        }
+        this->createLUTAxis(&this->elevAxis);
+    }
+    
+    void RSGISApply6SCoefficientsElevAOTLUTParam::createLUTAxis(LUTAxis *axis)
+    {
+        axis->first = axis->levels.front();
+        axis->step = 0;
+        axis->regular = false;
+        if(axis->levels.size() > 1)
+        {
+            axis->step = (axis->levels.back() - axis->first) / (axis->levels.size()-1);
+            axis->regular = true;
+            for(unsigned int i = 1; i < axis->levels.size(); ++i)
+            {
+                if(fabs(axis->levels[i] - (axis->first + (i * axis->step))) > (axis->step * 1e-3))
+                {
+                    axis->regular = false;
+                    break;
+                }
+            }
+        }
+    }
+    
+    void RSGISApply6SCoefficientsElevAOTLUTParam::findAxisPosition(const LUTAxis &axis, float val, unsigned int *idx1, unsigned int *idx2, double *weight2)
+    {
+        unsigned int numLevels = axis.levels.size();
+        if((numLevels == 1) || !(val > axis.first))
+        {
+            // Also catches NaN values.
+            *idx1 = 0;
+            *idx2 = 0;
+            *weight2 = 0;
+            return;
+        }
+        if(val >= axis.levels.back())
+        {
+            *idx1 = numLevels-1;
+            *idx2 = numLevels-1;
+            *weight2 = 0;
+            return;
+        }
+        
+        unsigned int idx = 0;
+        if(axis.regular)
+        {
+            idx = std::min<unsigned int>((val - axis.first) / axis.step, numLevels-2);
+            // Correct for any rounding in the level values.
+            if((val < axis.levels[idx]) && (idx > 0))
+            {
+                --idx;
+            }
+            else if((val >= axis.levels[idx+1]) && (idx < numLevels-2))
+            {
+                ++idx;
+            }
+        }
+        else
+        {
+            idx = (std::upper_bound(axis.levels.begin(), axis.levels.end(), val) - axis.levels.begin()) - 1;
+        }
+        
+        *idx1 = idx;
+        *idx2 = idx+1;
+        *weight2 = (val - axis.levels[idx]) / (axis.levels[idx+1] - axis.levels[idx]);
+    }
+    
+    void RSGISApply6SCoefficientsElevAOTLUTParam::findLUTPosition(float elevVal, float aotVal, size_t *lutIdxs, double *lutWeights)
+    {
+        unsigned int elevIdx[2];
+        double elevWeight = 0;
+        this->findAxisPosition(this->elevAxis, elevVal, &elevIdx[0], &elevIdx[1], &elevWeight);
+        
+        unsigned int aotIdx1 = 0;
+        unsigned int aotIdx2 = 0;
+        double aotWeight = 0;
+        for(unsigned int e = 0; e < 2; ++e)
+        {
+            this->findAxisPosition(this->aotAxes[elevIdx[e]], aotVal, &aotIdx1, &aotIdx2, &aotWeight);
+            double weight = (e == 0)?(1-elevWeight):elevWeight;
+            lutIdxs[(e*2)] = this->elevLUTOffsets[elevIdx[e]] + aotIdx1;
+            lutIdxs[(e*2)+1] = this->elevLUTOffsets[elevIdx[e]] + aotIdx2;
+            lutWeights[(e*2)] = weight * (1-aotWeight);
+            lutWeights[(e*2)+1] = weight * aotWeight;
+        }
     }
     
     void RSGISApply6SCoefficientsElevAOTLUTParam::calcImageValue(float *bandValues, int numBands, double *output) 
@@ -346,95 +575,137 @@ namespace rsgis{namespace calib{
         }
         else
         {
-            LUT6SBaseElevAOT elevLUTVal;
-            unsigned int elevLUTIdx = 0;
-            float dist = 0.0;
-            float minDist = 0.0;
-                        
-            for(unsigned int i = 0; i < lut->size(); ++i)
+            size_t lutIdxs[4];
+            double lutWeights[4];
+            this->findLUTPosition(elevVal, aotVal, lutIdxs, lutWeights);
+            
+            for(unsigned int i = 0; i < this->numValues; ++i)
             {
-                dist = (lut->at(i).elev - elevVal) * (lut->at(i).elev - elevVal);
-                if(i == 0)
+                if(this->imageBands[i] >= numBands)
                 {
-                    minDist = dist;
-                    elevLUTIdx = i;
+                    std::cout << "Image band: " << this->imageBands[i] << std::endl;
+                    throw rsgis::img::RSGISImageCalcException("Image band is not within image.");
                 }
-                else if(dist < minDist)
+                
+                output[i] = 0;
+                for(unsigned int n = 0; n < 4; ++n)
                 {
-                    minDist = dist;
-                    elevLUTIdx = i;
+                    size_t coeffIdx = (lutIdxs[n]*this->numValues)+i;
+                    tmpVal=this->aX[coeffIdx]*bandValues[this->imageBands[i]]-this->bX[coeffIdx];
+                    output[i] += lutWeights[n] * ((tmpVal/(1.0+this->cX[coeffIdx]*tmpVal))*this->scaleFactor);
                 }
-            }
-            
-            if(elevLUTIdx >= lut->size())
-            {
-                std::cerr << "elevVal = " << elevVal << std::endl;
-                std::cerr << "elevLUTIdx = " << elevLUTIdx << std::endl;
-                std::cerr << "lut->size() = " << lut->size() << std::endl;
-                
-                throw rsgis::img::RSGISImageCalcException("Elevation value is not within the LUT.");
-            }
-            
-            elevLUTVal = lut->at(elevLUTIdx);
-            
-            LUT6SAOT aotLUTVal;
-            unsigned int aotLUTIdx = 0;
-            
-            for(unsigned int i = 0; i < elevLUTVal.aotLUT.size(); ++i)
-            {
-                dist = (elevLUTVal.aotLUT.at(i).aot - aotVal) * (elevLUTVal.aotLUT.at(i).aot - aotVal);
-                if(i == 0)
+
+                if(this->useNoDataVal & (this->noDataVal == 0.0))
                 {
-                    minDist = dist;
-                    aotLUTIdx = i;
+                    if(output[i] < 1)
+                    {
+                        output[i] = 1.0;
+                    }
+                    else
+                    {
+                        output[i] = output[i] + 1.0;
+                    }
                 }
-                else if(dist < minDist)
+                if(output[i] > this->scaleFactor)
                 {
-                    minDist = dist;
-                    aotLUTIdx = i;
+                    output[i] = this->scaleFactor;
                 }
             }
-                        
-            if(aotLUTIdx >= elevLUTVal.aotLUT.size())
+        }
+        
+    }
+    
+    void RSGISApply6SCoefficientsElevAOTLUTParam::calcImageValueBlock(float **blockData, int numBands, int width, int height, double **output)
+    {
+        if(numBands-2 != this->numOutBands)
+        {
+            throw rsgis::img::RSGISImageCalcException("The number of input image bands needs to be equal to the number of output image bands.");
+        }
+        
+        size_t numPxls = ((size_t)width) * ((size_t)height);
+        
+        // A pixel is no data if all the input bands (other than elevation and AOT) are equal to the no data value.
+        std::vector<char> nodata(numPxls, 0);
+        if(this->useNoDataVal)
+        {
+            std::fill(nodata.begin(), nodata.end(), 1);
+            for(int i = 2; i < numBands; ++i)
             {
-                std::cerr << "aotVal = " << aotVal << std::endl;
-                std::cerr << "aotLUTIdx = " << aotLUTIdx << std::endl;
-                std::cerr << "elevLUTVal.aotLUT.size() = " << elevLUTVal.aotLUT.size() << std::endl;
-                
-                throw rsgis::img::RSGISImageCalcException("AOT value is not within the LUT.");
+                float *inBandVals = blockData[i];
+                for(size_t j = 0; j < numPxls; ++j)
+                {
+                    if(inBandVals[j] != this->noDataVal)
+                    {
+                        nodata[j] = 0;
+                    }
+                }
+            }
+        }
+        
+        // Find the LUT position of each pixel once for all the bands.
+        std::vector<size_t> lutIdxs(numPxls*4);
+        std::vector<double> lutWeights(numPxls*4);
+        float *elevVals = blockData[0];
+        float *aotVals = blockData[1];
+        for(size_t j = 0; j < numPxls; ++j)
+        {
+            if(!nodata[j])
+            {
+                this->findLUTPosition(elevVals[j], aotVals[j], &lutIdxs[j*4], &lutWeights[j*4]);
+            }
+        }
+        
+        double tmpVal = 0;
+        double outVal = 0;
+        for(unsigned int i = 0; i < this->numValues; ++i)
+        {
+            if(this->imageBands[i] >= numBands)
+            {
+                std::cout << "Image band: " << this->imageBands[i] << std::endl;
+                throw rsgis::img::RSGISImageCalcException("Image band is not within image.");
             }
             
-            aotLUTVal = elevLUTVal.aotLUT.at(aotLUTIdx);
-            
-            for(unsigned int i = 0; i < aotLUTVal.numValues; ++i)
+            float *inBandVals = blockData[this->imageBands[i]];
+            double *outBandVals = output[i];
+            for(size_t j = 0; j < numPxls; ++j)
             {
-                if(aotLUTVal.imageBands[i] > numBands)
+                if(nodata[j])
                 {
-                    std::cout << "Image band: " << aotLUTVal.imageBands[i] << std::endl;
-                    throw rsgis::img::RSGISImageCalcException("Image band is not within image.");
+                    outBandVals[j] = 0;
+                    continue;
+                }
+                
+                outVal = 0;
+                for(unsigned int n = 0; n < 4; ++n)
+                {
+                    size_t coeffIdx = (lutIdxs[(j*4)+n]*this->numValues)+i;
+                    tmpVal=this->aX[coeffIdx]*inBandVals[j]-this->bX[coeffIdx];
+                    outVal += lutWeights[(j*4)+n] * ((tmpVal/(1.0+this->cX[coeffIdx]*tmpVal))*this->scaleFactor);
                 }
                 
-                tmpVal=aotLUTVal.aX[i]*bandValues[aotLUTVal.imageBands[i]]-aotLUTVal.bX[i];
-                output[i] = (tmpVal/(1.0+aotLUTVal.cX[i]*tmpVal))*this->scaleFactor;
-
                 if(this->useNoDataVal & (this->noDataVal == 0.0))
                 {
-                    if(output[i] < 1)
+                    if(outVal < 1)
                     {
-                        output[i] = 1.0;
+                        outVal = 1.0;
                     }
                     else
                     {
-                        output[i] = output[i] + 1.0;
+                        outVal = outVal + 1.0;
                     }
                 }
-                if(output[i] > this->scaleFactor)
+                if(outVal > this->scaleFactor)
                 {
-                    output[i] = this->scaleFactor;
+                    outVal = this->scaleFactor;
                 }
+                outBandVals[j] = outVal;
             }
         }
-        
+    }
+    
+    rsgis::img::RSGISCalcImageValue* RSGISApply6SCoefficientsElevAOTLUTParam::clone()
+    {
+        return new RSGISApply6SCoefficientsElevAOTLUTParam(this->numOutBands, this->lut, this->noDataVal, this->useNoDataVal, this->scaleFactor);
     }
     
     RSGISApply6SCoefficientsElevAOTLUTParam::~RSGISApply6SCoefficientsElevAOTLUTParam()
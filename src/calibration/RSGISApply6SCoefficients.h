@@ -29,6 +29,9 @@
 
 #include <iostream>
 #include <string>
+#include <vector>
+#include <algorithm>
+#include <cmath>
 
 #include "gdal_priv.h"
 
@@ -90,6 +93,8 @@ namespace rsgis{namespace calib{
     public: 
         RSGISApply6SCoefficientsSingleParam(unsigned int *imageBands, float *aX, float *bX, float *cX, int numValues, float noDataVal = 0.0, bool useNoDataVal=false, float scaleFactor = 1.0);
         void calcImageValue(float *bandValues, int numBands, double *output);
+        void calcImageValueBlock(float **blockData, int numBands, int width, int height, double **output);
+        rsgis::img::RSGISCalcImageValue* clone();
         ~RSGISApply6SCoefficientsSingleParam();
     protected:
         unsigned int *imageBands;
@@ -120,14 +125,44 @@ namespace rsgis{namespace calib{
     };
     
     
+    /**
+     * Applies 6S coefficients from a LUT of elevation and AOT, where the first input
+     * band is the elevation and the second the AOT. On construction the coefficients
+     * are copied into a single array ordered by elevation then AOT, with the AOT
+     * levels of each elevation held separately. The LUT position of a pixel is found
+     * directly where the levels are evenly spaced (otherwise by a binary search) and
+     * the reflectance is bilinearly interpolated between the surrounding elevation and
+     * AOT levels. Values outside the LUT are clamped to the nearest level.
+     */
     class DllExport RSGISApply6SCoefficientsElevAOTLUTParam : public rsgis::img::RSGISCalcImageValue
     {
     public:
         RSGISApply6SCoefficientsElevAOTLUTParam(unsigned int numOutBands, std::vector<LUT6SBaseElevAOT> *lut, float noDataVal = 0.0, bool useNoDataVal=false, float scaleFactor = 1.0);
         void calcImageValue(float *bandValues, int numBands, double *output);
+        void calcImageValueBlock(float **blockData, int numBands, int width, int height, double **output);
+        rsgis::img::RSGISCalcImageValue* clone();
         ~RSGISApply6SCoefficientsElevAOTLUTParam();
     protected:
+        struct LUTAxis
+        {
+            std::vector<float> levels;
+            bool regular;
+            float first;
+            float step;
+        };
+        void createLUTAxis(LUTAxis *axis);
+        void findAxisPosition(const LUTAxis &axis, float val, unsigned int *idx1, unsigned int *idx2, double *weight2);
+        /** Finds the four LUT entries around the elevation and AOT value and their bilinear weights. */
+        void findLUTPosition(float elevVal, float aotVal, size_t *lutIdxs, double *lutWeights);
         std::vector<LUT6SBaseElevAOT> *lut;
+        LUTAxis elevAxis;
+        std::vector<LUTAxis> aotAxes;
+        std::vector<size_t> elevLUTOffsets;
+        unsigned int numValues;
+        std::vector<unsigned int> imageBands;
+        std::vector<float> aX;
+        std::vector<float> bX;
+        std::vector<float> cX;
         float scaleFactor;
         float noDataVal;
         bool useNoDataVal;
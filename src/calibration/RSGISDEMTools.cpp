@@ -687,6 +687,258 @@ namespace rsgis{namespace calib{
     
     
     
+    RSGISDEMCastShadows::RSGISDEMCastShadows(GDALDataset *inputImage, unsigned int band, float sunZenith, float sunAzimuth, float maxElevHeight)
+    {
+        if((band == 0) | (band > inputImage->GetRasterCount()))
+        {
+            throw rsgis::img::RSGISImageCalcException("Specified image band is not within the image.");
+        }
+        
+        this->width = inputImage->GetRasterXSize();
+        this->height = inputImage->GetRasterYSize();
+        this->maxElevHeight = maxElevHeight;
+        
+        double *transform = new double[6];
+        inputImage->GetGeoTransform(transform);
+        
+        this->xMin = transform[0];
+        this->xMax = transform[0] + width*transform[1];
+        this->yMax = transform[3];
+        this->yMin = transform[3] + height*transform[5];
+        
+        this->ewRes = transform[1];
+        this->nsRes = transform[5];
+        if(this->nsRes < 0)
+        {
+            this->nsRes *= -1;
+        }
+        delete[] transform;
+        
+        // Ray steps - the same as RSGISExtractImagePixelsOnLine::getImagePixelValues
+        const double degreesToRadians = M_PI / 180.0;
+        double sunAzTrans = 360-sunAzimuth;
+        sunAzTrans = sunAzTrans + 90;
+        if(sunAzTrans > 360)
+        {
+            sunAzTrans = sunAzTrans-360;
+        }
+        float azimuthRad = sunAzTrans * degreesToRadians;
+        float zenithRad = sunZenith * degreesToRadians;
+        
+        double stepRange = this->ewRes;
+        if(this->nsRes < stepRange)
+        {
+            stepRange = this->nsRes;
+        }
+        this->xStep = (stepRange * sin(zenithRad) * cos(azimuthRad))/3;
+        this->yStep = (stepRange * sin(zenithRad) * sin(azimuthRad))/3;
+        this->zStep = (stepRange * cos(zenithRad))/3;
+        
+        // Distance along the sun azimuth and the change in the ray height with distance.
+        double horizStep = sqrt((xStep * xStep) + (yStep * yStep));
+        this->sCol = 0;
+        this->sRow = 0;
+        this->cotZen = 0;
+        this->keyMargin = 0;
+        if(horizStep > 0)
+        {
+            this->sCol = (this->ewRes * xStep) / horizStep;
+            this->sRow = (-this->nsRes * yStep) / horizStep;
+            this->cotZen = zStep / horizStep;
+            // The ray is sampled anywhere within a pixel so the distance has an
+            // uncertainty of up to half a pixel diagonal.
+            this->keyMargin = (0.5 * sqrt((this->ewRes * this->ewRes) + (this->nsRes * this->nsRes)) * fabs(cotZen)) + 1e-3;
+        }
+        
+        size_t numPxls = ((size_t)width) * ((size_t)height);
+        this->demData.resize(numPxls);
+        this->horizon.resize(numPxls);
+        
+        GDALRasterBand *demBand = inputImage->GetRasterBand(band);
+        CPLErr err = demBand->RasterIO(GF_Read, 0, 0, width, height, demData.data(), width, height, GDT_Float32, 0, 0);
+        if(err != CE_None)
+        {
+            throw rsgis::img::RSGISImageCalcException("Could not read the DEM into memory.");
+        }
+        
+        this->calcHorizonSweep();
+    }
+    
+    void RSGISDEMCastShadows::calcHorizonSweep()
+    {
+        size_t numPxls = ((size_t)width) * ((size_t)height);
+        const float noHorizon = -std::numeric_limits<float>::infinity();
+        if(((xStep == 0) & (yStep == 0)) | (numPxls == 0))
+        {
+            // The ray never leaves the pixel so nothing can be in shadow.
+            for(size_t i = 0; i < numPxls; ++i)
+            {
+                horizon[i] = noHorizon;
+            }
+            return;
+        }
+        
+        // The ray in pixel coordinates (rows increase to the south).
+        double vCol = xStep / ewRes;
+        double vRow = -yStep / nsRes;
+        
+        // Sweep along the axis the ray moves furthest along (the major axis), such that
+        // each step of a line moves one pixel on the major axis and at most one on the
+        // minor axis. The line through minor position j at major position 0 visits
+        // (i, j + round(i * m)), so each pixel is on exactly one line. From a pixel on
+        // line b the ray can only pass through the pixels of lines b-3 to b+3 (1 from
+        // the ray crossing a pixel, 1 from where the ray entered the pixel and 1 from
+        // the rounding of the lines) at the same or later major positions.
+        bool colsMajor = fabs(vCol) >= fabs(vRow);
+        size_t nMajor = colsMajor?width:height;
+        size_t nMinor = colsMajor?height:width;
+        double vMajor = colsMajor?vCol:vRow;
+        double m = (colsMajor?vRow:vCol) / vMajor;
+        const long lineWin = 3;
+        
+        long minOff = std::min(0L, std::lround((nMajor-1) * m));
+        long maxOff = std::max(0L, std::lround((nMajor-1) * m));
+        size_t nLines = nMinor + (maxOff - minOff);
+        
+        std::vector<double> lineHorizon(nLines, -std::numeric_limits<double>::infinity());
+        std::vector<double> majorKeys(nMinor);
+        
+        for(size_t n = 0; n < nMajor; ++n)
+        {
+            // Start from the side of the image facing the sun.
+            size_t i = (vMajor > 0)?(nMajor-1-n):n;
+            long off = std::lround(i * m);
+            
+            for(size_t j = 0; j < nMinor; ++j)
+            {
+                size_t col = colsMajor?i:j;
+                size_t row = colsMajor?j:i;
+                majorKeys[j] = this->calcHorizonKey(col, row);
+            }
+            
+            for(size_t j = 0; j < nMinor; ++j)
+            {
+                long line = ((long)j) - off + maxOff;
+                double maxKey = -std::numeric_limits<double>::infinity();
+                for(long l = std::max(0L, line-lineWin); l <= std::min(((long)nLines)-1, line+lineWin); ++l)
+                {
+                    if(lineHorizon[l] > maxKey)
+                    {
+                        maxKey = lineHorizon[l];
+                    }
+                }
+                // The other pixels at the same major position.
+                for(long k = std::max(0L, ((long)j)-lineWin); k <= std::min(((long)nMinor)-1, ((long)j)+lineWin); ++k)
+                {
+                    if((k != ((long)j)) && (majorKeys[k] > maxKey))
+                    {
+                        maxKey = majorKeys[k];
+                    }
+                }
+                
+                // Round up so the stored horizon is never below the true value.
+                float maxKeyF = maxKey;
+                if(maxKeyF < maxKey)
+                {
+                    maxKeyF = nextafterf(maxKeyF, std::numeric_limits<float>::infinity());
+                }
+                size_t col = colsMajor?i:j;
+                size_t row = colsMajor?j:i;
+                horizon[(row*width)+col] = maxKeyF;
+            }
+            
+            for(size_t j = 0; j < nMinor; ++j)
+            {
+                long line = ((long)j) - off + maxOff;
+                if(majorKeys[j] > lineHorizon[line])
+                {
+                    lineHorizon[line] = majorKeys[j];
+                }
+            }
+        }
+    }
+    
+    bool RSGISDEMCastShadows::isPointInShadow(double x, double y, double z)
+    {
+        double xDiff = (x - xMin)/ewRes;
+        double yDiff = (yMax - y)/nsRes;
+        if((xDiff < 0) | (yDiff < 0))
+        {
+            throw rsgis::img::RSGISImageCalcException("Point is not within the image.");
+        }
+        
+        size_t xPxl = xDiff;
+        size_t yPxl = yDiff;
+        
+        // The ray can only be blocked by a pixel with a key above the key of the ray.
+        bool useHorizon = (xPxl < width) && (yPxl < height);
+        double rayKeyThres = 0;
+        if(useHorizon)
+        {
+            double rayKey = z - (((xPxl * sCol) + (yPxl * sRow)) * cotZen);
+            rayKeyThres = rayKey - keyMargin - (1e-9 * fabs(rayKey));
+            if(!(horizon[(yPxl*width)+xPxl] > rayKeyThres))
+            {
+                return false;
+            }
+        }
+        
+        size_t xPxlPrev = xPxl;
+        size_t yPxlPrev = yPxl;
+        
+        double xVal = x;
+        double yVal = y;
+        double zVal = z;
+        while(true)
+        {
+            xVal += xStep;
+            yVal += yStep;
+            zVal += zStep;
+            
+            // Reached edge of image?
+            if((xVal < xMin) | (xVal > xMax) | (yVal > yMax) | (yVal < yMin))
+            {
+                break;
+            }
+            
+            xPxl = (xVal - xMin)/ewRes;
+            yPxl = (yMax - yVal)/nsRes;
+            
+            if((xPxl != xPxlPrev) | (yPxl != yPxlPrev))
+            {
+                if((xPxl < width) && (yPxl < height))
+                {
+                    size_t idx = (yPxl*width)+xPxl;
+                    if(zVal < demData[idx])
+                    {
+                        return true;
+                    }
+                    // Nothing further along the ray is high enough to block it.
+                    if(useHorizon && !(horizon[idx] > rayKeyThres))
+                    {
+                        break;
+                    }
+                }
+            }
+            
+            xPxlPrev = xPxl;
+            yPxlPrev = yPxl;
+            
+            if(zVal > maxElevHeight)
+            {
+                break;
+            }
+        }
+        return false;
+    }
+    
+    RSGISDEMCastShadows::~RSGISDEMCastShadows()
+    {
+        
+    }
+    
+    
+    
     RSGISCalcShadowBinaryMask::RSGISCalcShadowBinaryMask(GDALDataset *inputImage, unsigned int band, float ewRes, float nsRes, float sunZenith, float sunAzimuth, float maxElevHeight, double noDataVal) : rsgis::img::RSGISCalcImageValue(1)
     {
         this->band = band;
@@ -697,16 +949,11 @@ namespace rsgis{namespace calib{
         this->inputImage = inputImage;
         this->maxElevHeight = maxElevHeight;
         
-        this->demWidth = inputImage->GetRasterXSize() * ewRes;
-        this->demHeight = inputImage->GetRasterYSize() * nsRes;
-        
-        this->sunRange = sqrt((demWidth * demWidth) + (demHeight * demHeight))*2;
-        
         this->noDataVal = noDataVal;
         this->degreesToRadians = M_PI / 180.0;
         this->radiansToDegrees = 180.0 / M_PI;
 
-        extractPixels = new rsgis::img::RSGISExtractImagePixelsOnLine();
+        castShadows = new RSGISDEMCastShadows(inputImage, band+1, sunZenith, sunAzimuth, maxElevHeight);
     }
 		
     void RSGISCalcShadowBinaryMask::calcImageValue(float ***dataBlock, int numBands, int winSize, double *output, OGREnvelope extent)
@@ -847,45 +1094,10 @@ namespace rsgis{namespace calib{
                         double y = extent.MinY + (extent.MaxY - extent.MinY)/2;
                         double z = dataBlock[band][1][1];
                         
-                        
-                        double sunAzTrans = 360-this->sunAzimuth;
-                        sunAzTrans = sunAzTrans + 90;
-                        if(sunAzTrans > 360)
-                        {
-                            sunAzTrans = sunAzTrans-360;
-                        }
-                        
-                        double sunZenRad = sunZenith * degreesToRadians;
-                        double sunAzRad = sunAzTrans * degreesToRadians;
-                        
-                        // Location of the sun.
-                        //double sunX = x + (sunRange * sin(sunZenRad) * cos(sunAzRad));
-                        //double sunY = y + (sunRange * sin(sunZenRad) * sin(sunAzRad));
-                        //double sunZ = z + (sunRange * cos(sunZenRad));
-                        
-                        // Create Ray Line
-                        OGRPoint *pxlPt = new OGRPoint(x, y, z);
-                        std::vector<rsgis::img::ImagePixelValuePt*> *imagePxlPts = extractPixels->getImagePixelValues(inputImage, band+1, pxlPt, sunAzRad, sunZenRad, maxElevHeight);
-                        delete pxlPt;
-                        
-                        // Check whether pixel intersects with ray.
-                        for(std::vector<rsgis::img::ImagePixelValuePt*>::iterator iterPxls = imagePxlPts->begin(); iterPxls != imagePxlPts->end(); ++iterPxls)
-                        {
-                            if((*iterPxls)->pt->getZ() < (*iterPxls)->value)
-                            {
-                                output[0] = 1;
-                                break;
-                            }
-                        }
-                        
-                        // Clean up memory..
-                        for(std::vector<rsgis::img::ImagePixelValuePt*>::iterator iterPxls = imagePxlPts->begin(); iterPxls != imagePxlPts->end(); )
+                        if(castShadows->isPointInShadow(x, y, z))
                         {
-                            delete (*iterPxls)->pt;
-                            delete (*iterPxls);
-                            iterPxls = imagePxlPts->erase(iterPxls);
+                            output[0] = 1;
                         }
-                        delete imagePxlPts;
                     }
                 }
                 else
@@ -906,7 +1118,7 @@ namespace rsgis{namespace calib{
     
     RSGISCalcShadowBinaryMask::~RSGISCalcShadowBinaryMask()
     {
-        delete extractPixels;
+        delete castShadows;
     }
     
     
@@ -26,6 +26,8 @@
 
 #include <iostream>
 #include <string>
+#include <vector>
+#include <limits>
 #include <cmath>
 
 #include "gdal_priv.h"
@@ -171,6 +173,57 @@ namespace rsgis{namespace calib{
 
 
 
+    /**
+     * Finds whether a ray from a point on the DEM towards the sun is blocked by the
+     * terrain (cast shadow). The DEM band is read into memory and the ray is traced
+     * with the same steps and samples as RSGISExtractImagePixelsOnLine, so the result
+     * is the same, but without allocating or reading a pixel at a time.
+     *
+     * Before tracing, the DEM is swept along lines parallel to the sun azimuth,
+     * starting from the side facing the sun, keeping a running horizon for each line
+     * (the maximum of height - distance * cot(zenith)). The horizon of the lines the
+     * ray can pass through is stored for each pixel, so a ray which cannot be blocked
+     * is not traced and a ray is only traced until it has passed the terrain which
+     * could block it. The sweep is O(1) per pixel.
+     *
+     * The zenith and azimuth could equally be the view angles to find the pixels
+     * which are hidden from the sensor.
+     */
+    class DllExport RSGISDEMCastShadows
+    {
+    public:
+        RSGISDEMCastShadows(GDALDataset *inputImage, unsigned int band, float sunZenith, float sunAzimuth, float maxElevHeight);
+        /** The point (x, y) should be the centre of a pixel and z its elevation. */
+        bool isPointInShadow(double x, double y, double z);
+        ~RSGISDEMCastShadows();
+    protected:
+        void calcHorizonSweep();
+        /** The height of a pixel less the height gained by a ray from the origin to the pixel. */
+        inline double calcHorizonKey(size_t col, size_t row)
+        {
+            return demData[(row*width)+col] - (((col * sCol) + (row * sRow)) * cotZen);
+        };
+        unsigned int width;
+        unsigned int height;
+        double xMin;
+        double xMax;
+        double yMin;
+        double yMax;
+        double ewRes;
+        double nsRes;
+        double xStep;
+        double yStep;
+        double zStep;
+        double sCol;
+        double sRow;
+        double cotZen;
+        double keyMargin;
+        float maxElevHeight;
+        std::vector<float> demData;
+        std::vector<float> horizon;
+    };
+
+
     class DllExport RSGISCalcShadowBinaryMask : public rsgis::img::RSGISCalcImageValue
 	{
 	public: 
@@ -183,15 +236,12 @@ namespace rsgis{namespace calib{
         float nsRes;
         float sunZenith;
         float sunAzimuth;
-        double sunRange;
-        double demWidth;
-        double demHeight;
         float maxElevHeight;
         GDALDataset *inputImage;
         double noDataVal;
         double degreesToRadians;
         double radiansToDegrees;
-        rsgis::img::RSGISExtractImagePixelsOnLine *extractPixels;
+        RSGISDEMCastShadows *castShadows;
 	};
 
 
@@ -0,0 +1,547 @@
+/*
+ *  RSGISHydroDEMFillPriorityFlood.cpp
+ *  RSGIS_LIB
+ *
+ *  Created by Pete Bunting on 17/10/2026.
+ *  Copyright 2026 RSGISLib. All rights reserved.
+ *  This file is part of RSGISLib.
+ *
+ *  RSGISLib is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  RSGISLib is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with RSGISLib.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "RSGISHydroDEMFillPriorityFlood.h"
+
+namespace rsgis{namespace calib{
+
+    RSGISHydroDEMFillPriorityFlood::RSGISHydroDEMFillPriorityFlood(bool epsilon)
+    {
+        this->epsilon = epsilon;
+    }
+
+    void RSGISHydroDEMFillPriorityFlood::performFill(GDALDataset *inDEMImgDS, GDALDataset *inValidImgDS, GDALDataset *outImgDS, unsigned int tileSize)
+    {
+        try
+        {
+            if(inDEMImgDS->GetRasterCount() != 1)
+            {
+                throw rsgis::img::RSGISImageCalcException("The image to be filled should only have 1 image band.");
+            }
+
+            long imgWidth = inDEMImgDS->GetRasterXSize();
+            long imgHeight = inDEMImgDS->GetRasterYSize();
+            if((outImgDS->GetRasterXSize() != imgWidth) || (outImgDS->GetRasterYSize() != imgHeight))
+            {
+                throw rsgis::img::RSGISImageCalcException("The output image must be the same size as the input image.");
+            }
+            GDALRasterBand *validBand = NULL;
+            if(inValidImgDS != NULL)
+            {
+                if((inValidImgDS->GetRasterXSize() != imgWidth) || (inValidImgDS->GetRasterYSize() != imgHeight))
+                {
+                    throw rsgis::img::RSGISImageCalcException("The valid area image must be the same size as the input image.");
+                }
+                validBand = inValidImgDS->GetRasterBand(1);
+            }
+            GDALRasterBand *demBand = inDEMImgDS->GetRasterBand(1);
+            GDALRasterBand *outBand = outImgDS->GetRasterBand(1);
+
+            int useNoDataInt = false;
+            float noDataVal = demBand->GetNoDataValue(&useNoDataInt);
+            bool useNoData = useNoDataInt;
+
+            std::vector<float> dem;
+            std::vector<unsigned char> valid;
+            std::vector<unsigned char> drain;
+
+            if(tileSize == 0)
+            {
+                std::cout << "Fill DEM in memory.\n";
+                this->readTile(demBand, validBand, useNoData, noDataVal, 0, 0, imgWidth, imgHeight, &dem, &valid, &drain);
+                this->floodRegion(dem.data(), valid.data(), imgWidth, imgHeight, drain.data(), false, NULL, NULL, NULL);
+                if(outBand->RasterIO(GF_Write, 0, 0, imgWidth, imgHeight, dem.data(), imgWidth, imgHeight, GDT_Float32, 0, 0) != CE_None)
+                {
+                    throw rsgis::img::RSGISImageCalcException("Could not write the output image.");
+                }
+                return;
+            }
+
+            if(this->epsilon)
+            {
+                throw rsgis::img::RSGISImageCalcException("The epsilon fill cannot be used in tiled mode.");
+            }
+            if(tileSize < 3)
+            {
+                throw rsgis::img::RSGISImageCalcException("The tile size must be at least 3 pixels.");
+            }
+
+            long nXTiles = (imgWidth + tileSize - 1) / tileSize;
+            long nYTiles = (imgHeight + tileSize - 1) / tileSize;
+            std::vector<PFTilePerimeter> tiles(nXTiles * nYTiles);
+            std::vector<uint32_t> labels;
+            std::unordered_map<uint64_t, float> spillEdges;
+            std::vector<float> drainElevs;
+
+            // The spill graph between labels, where label 0 is the outlet of the DEM.
+            std::vector<uint32_t> edgeLabelA;
+            std::vector<uint32_t> edgeLabelB;
+            std::vector<float> edgeElevs;
+            uint64_t numGraphLabels = 1;
+
+            // Pass 1: fill each tile independently and label the regions draining to its perimeter.
+            std::cout << "Fill and label the DEM tiles:\n";
+            rsgis_tqdm pbar1;
+            for(long ty = 0; ty < nYTiles; ++ty)
+            {
+                for(long tx = 0; tx < nXTiles; ++tx)
+                {
+                    pbar1.progress((ty * nXTiles) + tx, tiles.size());
+                    PFTilePerimeter *tile = &tiles[(ty * nXTiles) + tx];
+                    tile->xOff = tx * tileSize;
+                    tile->yOff = ty * tileSize;
+                    tile->width = std::min((long)tileSize, imgWidth - tile->xOff);
+                    tile->height = std::min((long)tileSize, imgHeight - tile->yOff);
+
+                    this->readTile(demBand, validBand, useNoData, noDataVal, tile->xOff, tile->yOff, tile->width, tile->height, &dem, &valid, &drain);
+                    labels.resize(dem.size());
+                    spillEdges.clear();
+                    uint32_t numLabels = this->floodRegion(dem.data(), valid.data(), tile->width, tile->height, drain.data(), true, labels.data(), &spillEdges, &drainElevs);
+                    if((numGraphLabels + numLabels) > std::numeric_limits<uint32_t>::max())
+                    {
+                        throw rsgis::img::RSGISImageCalcException("There are too many labelled regions, use a larger tile size.");
+                    }
+                    tile->labelOff = numGraphLabels - 1;
+                    numGraphLabels += numLabels;
+
+                    for(std::unordered_map<uint64_t, float>::iterator iterEdge = spillEdges.begin(); iterEdge != spillEdges.end(); ++iterEdge)
+                    {
+                        edgeLabelA.push_back(tile->labelOff + ((*iterEdge).first >> 32));
+                        edgeLabelB.push_back(tile->labelOff + ((*iterEdge).first & 0xFFFFFFFF));
+                        edgeElevs.push_back((*iterEdge).second);
+                    }
+                    for(uint32_t l = 1; l <= numLabels; ++l)
+                    {
+                        if(drainElevs[l] < std::numeric_limits<float>::infinity())
+                        {
+                            edgeLabelA.push_back(tile->labelOff + l);
+                            edgeLabelB.push_back(0);
+                            edgeElevs.push_back(drainElevs[l]);
+                        }
+                    }
+
+                    // Keep the labels and filled elevations of the tile perimeter.
+                    long perimPxlIdx[4][2] = {{0, 1}, {(tile->height - 1) * tile->width, 1}, {0, tile->width}, {tile->width - 1, tile->width}};
+                    for(int side = 0; side < 4; ++side)
+                    {
+                        long sideLen = (side < 2)?tile->width:tile->height;
+                        tile->labels[side].resize(sideLen);
+                        tile->elevs[side].resize(sideLen);
+                        for(long i = 0; i < sideLen; ++i)
+                        {
+                            size_t idx = perimPxlIdx[side][0] + (i * perimPxlIdx[side][1]);
+                            tile->labels[side][i] = labels[idx];
+                            tile->elevs[side][i] = dem[idx];
+                        }
+                    }
+                }
+            }
+            pbar1.finish();
+
+            // Add the spill elevations between the perimeter pixels of neighbouring tiles.
+            const long nDX[8] = {-1, 0, 1, -1, 1, -1, 0, 1};
+            const long nDY[8] = {-1, -1, -1, 0, 0, 1, 1, 1};
+            for(size_t t = 0; t < tiles.size(); ++t)
+            {
+                PFTilePerimeter *tile = &tiles[t];
+                for(long y = tile->yOff; y < (tile->yOff + tile->height); ++y)
+                {
+                    long xStep = ((y == tile->yOff) || (y == (tile->yOff + tile->height - 1)))?1:std::max(tile->width - 1, 1L);
+                    for(long x = tile->xOff; x < (tile->xOff + tile->width); x += xStep)
+                    {
+                        uint32_t label = 0;
+                        float elev = 0;
+                        this->getPerimeter(tile, x, y, &label, &elev);
+                        if(label == 0)
+                        {
+                            continue;
+                        }
+                        for(int k = 0; k < 8; ++k)
+                        {
+                            long nx = x + nDX[k];
+                            long ny = y + nDY[k];
+                            if((nx < 0) || (ny < 0) || (nx >= imgWidth) || (ny >= imgHeight))
+                            {
+                                continue;
+                            }
+                            size_t nTile = ((ny / tileSize) * nXTiles) + (nx / tileSize);
+                            if(nTile <= t)
+                            {
+                                // Each pair of tiles is only considered once.
+                                continue;
+                            }
+                            uint32_t nLabel = 0;
+                            float nElev = 0;
+                            this->getPerimeter(&tiles[nTile], nx, ny, &nLabel, &nElev);
+                            if(nLabel != 0)
+                            {
+                                edgeLabelA.push_back(label);
+                                edgeLabelB.push_back(nLabel);
+                                edgeElevs.push_back(std::max(elev, nElev));
+                            }
+                        }
+                    }
+                }
+            }
+
+            // Pass 2: find the elevation each label must be filled to (the minimum over
+            // all paths to the outlet of the maximum spill elevation along the path).
+            std::cout << "Solve the spill graph with " << numGraphLabels << " labels and " << edgeElevs.size() << " edges.\n";
+            std::vector<size_t> adjOffs(numGraphLabels + 1, 0);
+            for(size_t e = 0; e < edgeElevs.size(); ++e)
+            {
+                ++adjOffs[edgeLabelA[e] + 1];
+                ++adjOffs[edgeLabelB[e] + 1];
+            }
+            for(uint64_t l = 0; l < numGraphLabels; ++l)
+            {
+                adjOffs[l + 1] += adjOffs[l];
+            }
+            std::vector<uint32_t> adjLabels(adjOffs[numGraphLabels]);
+            std::vector<float> adjElevs(adjOffs[numGraphLabels]);
+            std::vector<size_t> adjFill(adjOffs.begin(), adjOffs.end() - 1);
+            for(size_t e = 0; e < edgeElevs.size(); ++e)
+            {
+                adjLabels[adjFill[edgeLabelA[e]]] = edgeLabelB[e];
+                adjElevs[adjFill[edgeLabelA[e]]++] = edgeElevs[e];
+                adjLabels[adjFill[edgeLabelB[e]]] = edgeLabelA[e];
+                adjElevs[adjFill[edgeLabelB[e]]++] = edgeElevs[e];
+            }
+            std::vector<uint32_t>().swap(edgeLabelA);
+            std::vector<uint32_t>().swap(edgeLabelB);
+            std::vector<float>().swap(edgeElevs);
+            std::vector<size_t>().swap(adjFill);
+
+            std::vector<float> labelFillElevs(numGraphLabels, std::numeric_limits<float>::infinity());
+            std::priority_queue<std::pair<float, uint32_t>, std::vector<std::pair<float, uint32_t> >, std::greater<std::pair<float, uint32_t> > > labelQ;
+            labelFillElevs[0] = -std::numeric_limits<float>::infinity();
+            labelQ.push(std::pair<float, uint32_t>(labelFillElevs[0], 0));
+            while(!labelQ.empty())
+            {
+                std::pair<float, uint32_t> cLabel = labelQ.top();
+                labelQ.pop();
+                if(cLabel.first > labelFillElevs[cLabel.second])
+                {
+                    continue;
+                }
+                for(size_t a = adjOffs[cLabel.second]; a < adjOffs[cLabel.second + 1]; ++a)
+                {
+                    float fillElev = std::max(cLabel.first, adjElevs[a]);
+                    if(fillElev < labelFillElevs[adjLabels[a]])
+                    {
+                        labelFillElevs[adjLabels[a]] = fillElev;
+                        labelQ.push(std::pair<float, uint32_t>(fillElev, adjLabels[a]));
+                    }
+                }
+            }
+            std::vector<size_t>().swap(adjOffs);
+            std::vector<uint32_t>().swap(adjLabels);
+            std::vector<float>().swap(adjElevs);
+
+            // Pass 3: fill each tile again and raise each label to its fill elevation.
+            std::cout << "Fill and write the DEM tiles:\n";
+            rsgis_tqdm pbar3;
+            for(size_t t = 0; t < tiles.size(); ++t)
+            {
+                pbar3.progress(t, tiles.size());
+                PFTilePerimeter *tile = &tiles[t];
+                this->readTile(demBand, validBand, useNoData, noDataVal, tile->xOff, tile->yOff, tile->width, tile->height, &dem, &valid, &drain);
+                labels.resize(dem.size());
+                spillEdges.clear();
+                this->floodRegion(dem.data(), valid.data(), tile->width, tile->height, drain.data(), true, labels.data(), &spillEdges, &drainElevs);
+                for(size_t i = 0; i < dem.size(); ++i)
+                {
+                    if(labels[i] != 0)
+                    {
+                        float fillElev = labelFillElevs[tile->labelOff + labels[i]];
+                        if((fillElev > dem[i]) && (fillElev < std::numeric_limits<float>::infinity()))
+                        {
+                            dem[i] = fillElev;
+                        }
+                    }
+                }
+                if(outBand->RasterIO(GF_Write, tile->xOff, tile->yOff, tile->width, tile->height, dem.data(), tile->width, tile->height, GDT_Float32, 0, 0) != CE_None)
+                {
+                    throw rsgis::img::RSGISImageCalcException("Could not write the output image.");
+                }
+            }
+            pbar3.finish();
+        }
+        catch (rsgis::img::RSGISImageCalcException &e)
+        {
+            throw e;
+        }
+        catch (rsgis::RSGISException &e)
+        {
+            throw rsgis::img::RSGISImageCalcException(e.what());
+        }
+        catch (std::exception &e)
+        {
+            throw rsgis::img::RSGISImageCalcException(e.what());
+        }
+    }
+
+    void RSGISHydroDEMFillPriorityFlood::readTile(GDALRasterBand *demBand, GDALRasterBand *validBand, bool useNoData, float noDataVal, long xOff, long yOff, long width, long height, std::vector<float> *dem, std::vector<unsigned char> *valid, std::vector<unsigned char> *drain)
+    {
+        long imgWidth = demBand->GetXSize();
+        long imgHeight = demBand->GetYSize();
+
+        // Read the tile with a one pixel border so pixels draining into invalid
+        // pixels in the neighbouring tiles can be identified.
+        long bXOff = std::max(xOff - 1, 0L);
+        long bYOff = std::max(yOff - 1, 0L);
+        long bWidth = std::min(xOff + width + 1, imgWidth) - bXOff;
+        long bHeight = std::min(yOff + height + 1, imgHeight) - bYOff;
+        size_t numBPxls = ((size_t)bWidth) * bHeight;
+
+        std::vector<float> bDEM(numBPxls);
+        std::vector<unsigned char> bValid(numBPxls, 1);
+        if(demBand->RasterIO(GF_Read, bXOff, bYOff, bWidth, bHeight, bDEM.data(), bWidth, bHeight, GDT_Float32, 0, 0) != CE_None)
+        {
+            throw rsgis::img::RSGISImageCalcException("Could not read the input DEM.");
+        }
+        if(validBand != NULL)
+        {
+            std::vector<float> bValidVals(numBPxls);
+            if(validBand->RasterIO(GF_Read, bXOff, bYOff, bWidth, bHeight, bValidVals.data(), bWidth, bHeight, GDT_Float32, 0, 0) != CE_None)
+            {
+                throw rsgis::img::RSGISImageCalcException("Could not read the valid area image.");
+            }
+            for(size_t i = 0; i < numBPxls; ++i)
+            {
+                bValid[i] = (bValidVals[i] == 1);
+            }
+        }
+        for(size_t i = 0; i < numBPxls; ++i)
+        {
+            if(std::isnan(bDEM[i]) || (useNoData && (bDEM[i] == noDataVal)))
+            {
+                bValid[i] = 0;
+            }
+        }
+
+        size_t numPxls = ((size_t)width) * height;
+        dem->resize(numPxls);
+        valid->resize(numPxls);
+        drain->resize(numPxls);
+        for(long y = 0; y < height; ++y)
+        {
+            long gy = yOff + y;
+            for(long x = 0; x < width; ++x)
+            {
+                long gx = xOff + x;
+                size_t bIdx = (((size_t)(gy - bYOff)) * bWidth) + (gx - bXOff);
+                size_t idx = (((size_t)y) * width) + x;
+                (*dem)[idx] = bDEM[bIdx];
+                (*valid)[idx] = bValid[bIdx];
+
+                bool drainPxl = false;
+                if(bValid[bIdx])
+                {
+                    if((gx == 0) || (gy == 0) || (gx == (imgWidth - 1)) || (gy == (imgHeight - 1)))
+                    {
+                        drainPxl = true;
+                    }
+                    else
+                    {
+                        for(long ny = gy - 1; (ny <= (gy + 1)) && !drainPxl; ++ny)
+                        {
+                            for(long nx = gx - 1; nx <= (gx + 1); ++nx)
+                            {
+                                if(!bValid[(((size_t)(ny - bYOff)) * bWidth) + (nx - bXOff)])
+                                {
+                                    drainPxl = true;
+                                    break;
+                                }
+                            }
+                        }
+                    }
+                }
+                (*drain)[idx] = drainPxl;
+            }
+        }
+    }
+
+    uint32_t RSGISHydroDEMFillPriorityFlood::floodRegion(float *dem, const unsigned char *valid, long width, long height, const unsigned char *drain, bool seedPerimeter, uint32_t *labels, std::unordered_map<uint64_t, float> *spillEdges, std::vector<float> *drainElevs)
+    {
+        const long nDX[8] = {-1, 0, 1, -1, 1, -1, 0, 1};
+        const long nDY[8] = {-1, -1, -1, 0, 0, 1, 1, 1};
+        const float maxElev = std::numeric_limits<float>::infinity();
+        size_t numPxls = ((size_t)width) * height;
+        uint32_t numLabels = 0;
+
+        std::vector<unsigned char> closed(numPxls, 0);
+        std::priority_queue<std::pair<float, size_t>, std::vector<std::pair<float, size_t> >, std::greater<std::pair<float, size_t> > > openQ;
+        std::vector<size_t> pitQ;
+        size_t pitHead = 0;
+        if(labels != NULL)
+        {
+            std::fill(labels, labels + numPxls, 0);
+            drainElevs->assign(1, maxElev);
+        }
+
+        for(long y = 0; y < height; ++y)
+        {
+            for(long x = 0; x < width; ++x)
+            {
+                size_t idx = (((size_t)y) * width) + x;
+                if(valid[idx] && (drain[idx] || (seedPerimeter && ((x == 0) || (y == 0) || (x == (width - 1)) || (y == (height - 1))))))
+                {
+                    closed[idx] = 1;
+                    openQ.push(std::pair<float, size_t>(dem[idx], idx));
+                }
+            }
+        }
+
+        size_t cIdx = 0;
+        while((pitHead < pitQ.size()) || !openQ.empty())
+        {
+            // Pixels in depressions (the pit queue) are processed before the priority
+            // queue, except with epsilon where an equal pixel in the priority queue is
+            // taken first so flats are raised from their lowest outlet.
+            if((pitHead < pitQ.size()) && !(this->epsilon && !openQ.empty() && (openQ.top().first == dem[pitQ[pitHead]])))
+            {
+                cIdx = pitQ[pitHead++];
+                if(pitHead == pitQ.size())
+                {
+                    pitQ.clear();
+                    pitHead = 0;
+                }
+            }
+            else
+            {
+                cIdx = openQ.top().second;
+                openQ.pop();
+            }
+            long cX = cIdx % width;
+            long cY = cIdx / width;
+            float cElev = dem[cIdx];
+
+            if(labels != NULL)
+            {
+                if(labels[cIdx] == 0)
+                {
+                    labels[cIdx] = ++numLabels;
+                    drainElevs->push_back(maxElev);
+                }
+                if(drain[cIdx] && (cElev < (*drainElevs)[labels[cIdx]]))
+                {
+                    (*drainElevs)[labels[cIdx]] = cElev;
+                }
+            }
+
+            for(int k = 0; k < 8; ++k)
+            {
+                long nX = cX + nDX[k];
+                long nY = cY + nDY[k];
+                if((nX < 0) || (nY < 0) || (nX >= width) || (nY >= height))
+                {
+                    continue;
+                }
+                size_t nIdx = (((size_t)nY) * width) + nX;
+                if(!valid[nIdx])
+                {
+                    continue;
+                }
+                if(closed[nIdx])
+                {
+                    if((labels != NULL) && (labels[nIdx] != 0) && (labels[nIdx] != labels[cIdx]))
+                    {
+                        uint64_t key = (labels[nIdx] < labels[cIdx])?((((uint64_t)labels[nIdx]) << 32) | labels[cIdx]):((((uint64_t)labels[cIdx]) << 32) | labels[nIdx]);
+                        float spillElev = std::max(cElev, dem[nIdx]);
+                        std::unordered_map<uint64_t, float>::iterator iterEdge = spillEdges->find(key);
+                        if(iterEdge == spillEdges->end())
+                        {
+                            spillEdges->insert(std::pair<uint64_t, float>(key, spillElev));
+                        }
+                        else if(spillElev < (*iterEdge).second)
+                        {
+                            (*iterEdge).second = spillElev;
+                        }
+                    }
+                    continue;
+                }
+
+                closed[nIdx] = 1;
+                if(labels != NULL)
+                {
+                    labels[nIdx] = labels[cIdx];
+                }
+                if(dem[nIdx] <= cElev)
+                {
+                    dem[nIdx] = this->epsilon?std::nextafter(cElev, maxElev):cElev;
+                    pitQ.push_back(nIdx);
+                }
+                else
+                {
+                    openQ.push(std::pair<float, size_t>(dem[nIdx], nIdx));
+                }
+            }
+        }
+
+        return numLabels;
+    }
+
+    void RSGISHydroDEMFillPriorityFlood::getPerimeter(PFTilePerimeter *tile, long x, long y, uint32_t *label, float *elev)
+    {
+        long tX = x - tile->xOff;
+        long tY = y - tile->yOff;
+        int side = 0;
+        long i = tX;
+        if(tY == 0)
+        {
+            side = 0;
+        }
+        else if(tY == (tile->height - 1))
+        {
+            side = 1;
+        }
+        else if(tX == 0)
+        {
+            side = 2;
+            i = tY;
+        }
+        else if(tX == (tile->width - 1))
+        {
+            side = 3;
+            i = tY;
+        }
+        else
+        {
+            throw rsgis::img::RSGISImageCalcException("Pixel is not on the perimeter of the tile.");
+        }
+
+        *label = tile->labels[side][i];
+        if(*label != 0)
+        {
+            *label += tile->labelOff;
+        }
+        *elev = tile->elevs[side][i];
+    }
+
+    RSGISHydroDEMFillPriorityFlood::~RSGISHydroDEMFillPriorityFlood()
+    {
+
+    }
+
+}}
@@ -0,0 +1,129 @@
+/*
+ *  RSGISHydroDEMFillPriorityFlood.h
+ *  RSGIS_LIB
+ *
+ *  Created by Pete Bunting on 17/10/2026.
+ *  Copyright 2026 RSGISLib. All rights reserved.
+ *  This file is part of RSGISLib.
+ *
+ *  RSGISLib is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  RSGISLib is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with RSGISLib.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ *  Implementation of the Priority-Flood algorithm for filling depressions in
+ *  a DEM, with the tiled variant for DEMs which do not fit in memory.
+ *
+ *  Barnes, R., Lehman, C., and Mulla, D. (2014). Priority-flood: An optimal
+ *  depression-filling and watershed-labeling algorithm for digital elevation
+ *  models. Computers & Geosciences. 62. 117-127.
+ *
+ *  Barnes, R. (2016). Parallel priority-flood depression filling for trillion
+ *  cell digital elevation models on desktops or clusters. Computers &
+ *  Geosciences. 96. 56-68.
+ *
+ */
+
+#ifndef RSGISHydroDEMFillPriorityFlood_h
+#define RSGISHydroDEMFillPriorityFlood_h
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <queue>
+#include <unordered_map>
+#include <limits>
+#include <algorithm>
+#include <cmath>
+#include <stdint.h>
+
+#include "gdal_priv.h"
+
+#include "common/rsgis-tqdm.h"
+
+#include "img/RSGISImageCalcException.h"
+#include "img/RSGISImageUtils.h"
+
+// mark all exported classes/functions with DllExport to have
+// them exported by Visual Studio
+#undef DllExport
+#ifdef _MSC_VER
+    #ifdef rsgis_calib_EXPORTS
+        #define DllExport   __declspec( dllexport )
+    #else
+        #define DllExport   __declspec( dllimport )
+    #endif
+#else
+    #define DllExport
+#endif
+
+namespace rsgis{namespace calib{
+
+    /**
+     * Fills the depressions in a DEM so every valid pixel can drain to the edge of
+     * the image or to an invalid (no data or masked) pixel, using 8 connectivity.
+     *
+     * Pixels are processed from a priority queue (a binary heap over a flat array)
+     * ordered by elevation, with pixels within a depression or on a flat processed
+     * from a plain FIFO queue. If epsilon is true each filled pixel is raised by the
+     * smallest float increment above the pixel it was reached from, so flats have a
+     * gradient and drain; otherwise filled regions are flat.
+     *
+     * If tileSize is 0 the whole DEM is filled in memory. Otherwise the DEM is
+     * processed in tiles over three passes: each tile is filled independently with
+     * its perimeter treated as draining and the regions draining to each perimeter
+     * pixel labelled; the spill elevations between the labelled regions (within and
+     * between tiles) are then used to find the elevation to which each region must
+     * be filled; finally each tile is filled again and raised to that elevation.
+     * Only the perimeter of each tile and the spill graph are held between passes.
+     * The epsilon variant is only available in memory.
+     */
+    class DllExport RSGISHydroDEMFillPriorityFlood
+    {
+    public:
+        RSGISHydroDEMFillPriorityFlood(bool epsilon=false);
+        /**
+         * Fill the DEM (band 1 of inDEMImgDS), writing the result to band 1 of outImgDS.
+         * inValidImgDS is optional (NULL), where provided only pixels with a value of 1
+         * are filled. Pixels which are no data in the DEM are not filled. Invalid pixels
+         * are output with the input DEM value.
+         */
+        void performFill(GDALDataset *inDEMImgDS, GDALDataset *inValidImgDS, GDALDataset *outImgDS, unsigned int tileSize=0);
+        ~RSGISHydroDEMFillPriorityFlood();
+    protected:
+        struct PFTilePerimeter
+        {
+            long xOff;
+            long yOff;
+            long width;
+            long height;
+            uint32_t labelOff;
+            std::vector<uint32_t> labels[4];
+            std::vector<float> elevs[4];
+        };
+        void readTile(GDALRasterBand *demBand, GDALRasterBand *validBand, bool useNoData, float noDataVal, long xOff, long yOff, long width, long height, std::vector<float> *dem, std::vector<unsigned char> *valid, std::vector<unsigned char> *drain);
+        /**
+         * Fill the region in place. Valid pixels which are draining, or on the perimeter
+         * of the region if seedPerimeter is true, are the seeds. If labels is not NULL
+         * each pixel is labelled (from 1) with the seed it was filled from, the minimum
+         * spill elevation between each pair of labels (keyed as (a << 32) | b with a < b)
+         * is added to spillEdges and the minimum elevation of the draining pixels of each
+         * label to drainElevs (indexed by label). Returns the number of labels.
+         */
+        uint32_t floodRegion(float *dem, const unsigned char *valid, long width, long height, const unsigned char *drain, bool seedPerimeter, uint32_t *labels, std::unordered_map<uint64_t, float> *spillEdges, std::vector<float> *drainElevs);
+        void getPerimeter(PFTilePerimeter *tile, long x, long y, uint32_t *label, float *elev);
+        bool epsilon;
+    };
+
+}}
+
+#endif
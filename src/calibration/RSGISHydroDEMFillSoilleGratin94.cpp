@@ -37,7 +37,7 @@ namespace rsgis{namespace calib{
             int numBands = inDEMImgDS->GetRasterCount();
             if(numBands != 1)
             {
-                rsgis::img::RSGISImageCalcException("The image to be filled should only have 1 image band.");
+                throw rsgis::img::RSGISImageCalcException("The image to be filled should only have 1 image band.");
             }
             
             
@@ -49,7 +49,8 @@ namespace rsgis{namespace calib{
             rsgis::img::RSGISImageUtils imgUtils;
             if(!imgUtils.doImageSpatAndExtMatch(datasets, 3))
             {
-                rsgis::img::RSGISImageCalcException("The images provided do not all have the same size and/or spaital header. The input image (e.g., DEM) and valid area image must be excatly the same.");
+                delete[] datasets;
+                throw rsgis::img::RSGISImageCalcException("The images provided do not all have the same size and/or spaital header. The input image (e.g., DEM) and valid area image must be excatly the same.");
             }
             delete[] datasets;
             
@@ -97,27 +98,89 @@ namespace rsgis{namespace calib{
                 noDataVal = 0.0;
             }
             
-            // Create the hierarchical queue.
-            pxQ = new std::list<Q2DPxl>*[numLevels];
-            for(long n = 0; n < numLevels; ++n)
+            // Read the DEM and valid mask into memory.
+            long width = inDEMImgDS->GetRasterXSize();
+            long height = inDEMImgDS->GetRasterYSize();
+            size_t numPxls = ((size_t)width) * height;
+            std::vector<float> validVals(numPxls);
+            std::vector<float> demVals(numPxls);
+            std::vector<float> outVals(numPxls);
+            if(inValidImgDS->GetRasterBand(1)->RasterIO(GF_Read, 0, 0, width, height, validVals.data(), width, height, GDT_Float32, 0, 0) != CE_None)
             {
-                pxQ[n] = new std::list<Q2DPxl>();
+                throw rsgis::img::RSGISImageCalcException("Could not read the valid data image.");
+            }
+            if(inDEMImgDS->GetRasterBand(1)->RasterIO(GF_Read, 0, 0, width, height, demVals.data(), width, height, GDT_Float32, 0, 0) != CE_None)
+            {
+                throw rsgis::img::RSGISImageCalcException("Could not read the input image.");
             }
             
+            // Create the hierarchical queue.
+            pxQ.assign(numLevels, std::vector<size_t>());
             
-            // Initialise the output image.
+            // Initialise the output image; pixels outside the valid region but
+            // neighbouring it are the boundary from which the fill starts.
             std::cout << "Initalise the Output Image and find boundary pixels.\n";
-            RSGISInitOutputImageSoilleGratin94 initOutImg = RSGISInitOutputImageSoilleGratin94(noDataVal, maxVal, borderVal, pxQ[0]);
-            rsgis::img::RSGISCalcImage calcImage = rsgis::img::RSGISCalcImage(&initOutImg);
-            calcImage.calcImageWindowData(&inValidImgDS, 1, outImgDS, 3, true);
+            for(long y = 0; y < height; ++y)
+            {
+                for(long x = 0; x < width; ++x)
+                {
+                    size_t idx = (((size_t)y) * width) + x;
+                    if(validVals[idx] == 1)
+                    {
+                        outVals[idx] = maxVal;
+                        continue;
+                    }
+                    
+                    bool boundary = false;
+                    for(long ny = std::max(y-1, 0L); (ny <= std::min(y+1, height-1)) && !boundary; ++ny)
+                    {
+                        for(long nx = std::max(x-1, 0L); nx <= std::min(x+1, width-1); ++nx)
+                        {
+                            if(validVals[(((size_t)ny) * width) + nx] == 1)
+                            {
+                                boundary = true;
+                                break;
+                            }
+                        }
+                    }
+                    
+                    if(boundary)
+                    {
+                        outVals[idx] = borderVal;
+                        pxQ[0].push_back(idx);
+                    }
+                    else
+                    {
+                        outVals[idx] = noDataVal;
+                    }
+                }
+            }
             
-            if(pxQ[0]->size() == 0)
+            if(pxQ[0].size() == 0)
             {
-                this->getImagesEdgesToInitFill(outImgDS->GetRasterBand(1), borderVal, pxQ[0]);
-                //throw rsgis::img::RSGISImageCalcException("The were no edge pixels with the valid mask.");
+                // Use the edges of the image as the boundary.
+                for(long x = 0; x < width; ++x)
+                {
+                    pxQ[0].push_back(x);
+                }
+                for(long x = 0; x < width; ++x)
+                {
+                    pxQ[0].push_back((((size_t)(height-1)) * width) + x);
+                }
+                for(long y = 0; y < height; ++y)
+                {
+                    pxQ[0].push_back(((size_t)y) * width);
+                }
+                for(long y = 0; y < height; ++y)
+                {
+                    pxQ[0].push_back((((size_t)y) * width) + (width-1));
+                }
+                for(std::vector<size_t>::iterator iterPxl = pxQ[0].begin(); iterPxl != pxQ[0].end(); ++iterPxl)
+                {
+                    outVals[*iterPxl] = borderVal;
+                }
             }
             
-            Q2DPxl pxl;
             long hcrt = minVal;
             long imgVal = 0;
             long img2Val = 0;
@@ -126,41 +189,52 @@ namespace rsgis{namespace calib{
             for(long n = 0; n < numLevels; ++n)
             {
                 pbar.progress(n, numLevels);
-
-                while(!this->qEmpty(hcrt))
+                
+                // Pixels pushed to the current level while it is being processed are
+                // appended to it, so the level is processed in FIFO order.
+                std::vector<size_t> &levelQ = pxQ[n];
+                for(size_t i = 0; i < levelQ.size(); ++i)
                 {
-                    pxl = this->qPopFront(hcrt);
-
-                    // Get Neightbours
-                    std::list<Q2DPxl> *nPxls = this->getNeighbours(pxl, inValidImgDS->GetRasterBand(1));
-                    for(std::list<Q2DPxl>::iterator iterNPxls = nPxls->begin(); iterNPxls != nPxls->end(); ++iterNPxls)
+                    size_t pxlIdx = levelQ[i];
+                    long pxlX = pxlIdx % width;
+                    long pxlY = pxlIdx / width;
+                    
+                    for(long ny = std::max(pxlY-1, 0L); ny <= std::min(pxlY+1, height-1); ++ny)
                     {
-                        imgVal = this->getPxlVal((*iterNPxls), inDEMImgDS->GetRasterBand(1));
-                        img2Val = this->getPxlVal((*iterNPxls), outImgDS->GetRasterBand(1));
-
-                        if(img2Val == maxVal)
+                        for(long nx = std::max(pxlX-1, 0L); nx <= std::min(pxlX+1, width-1); ++nx)
                         {
-                            img2Val = this->rtnMax(hcrt, imgVal);
-                            this->setPxlVal((*iterNPxls), img2Val, outImgDS->GetRasterBand(1));
-                            if(img2Val < maxVal)
+                            size_t nIdx = (((size_t)ny) * width) + nx;
+                            if((nIdx == pxlIdx) || (validVals[nIdx] != 1))
                             {
-                                this->qPushBack(img2Val, (*iterNPxls));
+                                continue;
+                            }
+                            
+                            imgVal = (long)demVals[nIdx];
+                            img2Val = (long)outVals[nIdx];
+                            
+                            if(img2Val == maxVal)
+                            {
+                                img2Val = std::max(hcrt, imgVal);
+                                outVals[nIdx] = img2Val;
+                                if(img2Val < maxVal)
+                                {
+                                    this->qPushBack(img2Val, nIdx);
+                                }
                             }
                         }
                     }
-                    delete nPxls;
-                    
                 }
+                std::vector<size_t>().swap(levelQ);
                 
                 ++hcrt;
             }
             pbar.finish();
+            pxQ.clear();
             
-            for(long n = 0; n < numLevels; ++n)
+            if(outImgDS->GetRasterBand(1)->RasterIO(GF_Write, 0, 0, width, height, outVals.data(), width, height, GDT_Float32, 0, 0) != CE_None)
             {
-                delete pxQ[n];
+                throw rsgis::img::RSGISImageCalcException("Could not write the output image.");
             }
-            delete[] pxQ;            
         }
         catch (rsgis::img::RSGISImageCalcException &e)
         {
@@ -176,157 +250,10 @@ namespace rsgis{namespace calib{
         }
     }
     
-    bool RSGISHydroDEMFillSoilleGratin94::qEmpty(long hcrt)
-    {
-        long qIdx = hcrt - this->minVal;
-        bool empty = pxQ[qIdx]->empty();
-        return empty;
-    }
-    
-    Q2DPxl RSGISHydroDEMFillSoilleGratin94::qPopFront(long hcrt)
+    void RSGISHydroDEMFillSoilleGratin94::qPushBack(long hcrt, size_t pxlIdx)
     {
         long qIdx = hcrt - this->minVal;
-        Q2DPxl pxl = pxQ[qIdx]->front();
-        pxQ[qIdx]->pop_front();
-        return pxl;
-    }
-    
-    void RSGISHydroDEMFillSoilleGratin94::qPushBack(long hcrt, Q2DPxl pxl)
-    {
-        long qIdx = hcrt - this->minVal;
-        pxQ[qIdx]->push_back(pxl);
-    }
-    
-    std::list<Q2DPxl>* RSGISHydroDEMFillSoilleGratin94::getNeighbours(Q2DPxl pxl, GDALRasterBand *inValidImg) 
-    {
-        std::list<Q2DPxl> *nPxls = new std::list<Q2DPxl>();
-        
-        long width = inValidImg->GetXSize();
-        long height = inValidImg->GetYSize();
-        
-        long minXPxl = pxl.x - 1;
-        long maxXPxl = pxl.x + 1;
-        long minYPxl = pxl.y - 1;
-        long maxYPxl = pxl.y + 1;
-        
-        if(minXPxl < 0)
-        {
-            minXPxl = 0;
-        }
-        if(minYPxl < 0)
-        {
-            minYPxl = 0;
-        }
-        if(maxXPxl >= width)
-        {
-            maxXPxl = width-1;
-        }
-        if(maxYPxl >= height)
-        {
-            maxYPxl = height-1;
-        }
-
-        int nWidth = (maxXPxl - minXPxl)+1;
-        int nHeight = (maxYPxl - minYPxl)+1;
-        
-        float dataVal = 0;
-        long cPxlX = 0;
-        long cPxlY = minYPxl;
-        for(int i = 0; i < nHeight; ++i)
-        {
-            cPxlX = minXPxl;
-            for(int j = 0; j < nWidth; ++j)
-            {
-                if(!((cPxlX == pxl.x) & (cPxlY == pxl.y)))
-                {
-                    inValidImg->RasterIO(GF_Read, cPxlX, cPxlY, 1, 1, &dataVal, 1, 1, GDT_Float32, 0, 0);
-
-                    if(dataVal == 1)
-                    {
-                        nPxls->push_back(Q2DPxl(cPxlX, cPxlY));
-                    }
-                }
-                ++cPxlX;
-            }
-            ++cPxlY;
-        }
-        
-        return nPxls;
-    }
-    
-    long RSGISHydroDEMFillSoilleGratin94::getPxlVal(Q2DPxl pxl, GDALRasterBand *imgData)
-    {
-        float outVal = 0;
-        imgData->RasterIO(GF_Read, pxl.x, pxl.y, 1, 1, &outVal, 1, 1, GDT_Float32, 0, 0);
-        return (long)outVal;
-    }
-    
-    void RSGISHydroDEMFillSoilleGratin94::setPxlVal(Q2DPxl pxl, long val, GDALRasterBand *imgData)
-    {
-        float outVal = val;
-        imgData->RasterIO(GF_Write, pxl.x, pxl.y, 1, 1, &outVal, 1, 1, GDT_Float32, 0, 0);
-    }
-    
-    long RSGISHydroDEMFillSoilleGratin94::rtnMax(long val1, long val2)
-    {
-        long outVal = val1;
-        if(val2 > val1)
-        {
-            outVal = val2;
-        }
-        return outVal;
-    }
-    
-    void RSGISHydroDEMFillSoilleGratin94::getImagesEdgesToInitFill(GDALRasterBand *imgData, double borderVal, std::list<Q2DPxl> *pxQ)
-    {
-        try
-        {
-            unsigned int xSize = imgData->GetXSize();
-            unsigned int ySize = imgData->GetYSize();
-            
-            //std::cout << "[" << xSize << ", " << ySize << "]\n";
-            
-            for(unsigned int x = 0; x < xSize; ++x)
-            {
-                Q2DPxl q2Pxl = Q2DPxl(x, 0);
-                this->setPxlVal(q2Pxl, borderVal, imgData);
-                pxQ->push_back(q2Pxl);
-            }
-            
-            for(unsigned int x = 0; x < xSize; ++x)
-            {
-                Q2DPxl q2Pxl = Q2DPxl(x, (ySize-1));
-                this->setPxlVal(q2Pxl, borderVal, imgData);
-                pxQ->push_back(q2Pxl);
-            }
-            
-            for(unsigned int y = 0; y < ySize; ++y)
-            {
-                Q2DPxl q2Pxl = Q2DPxl(0, y);
-                this->setPxlVal(q2Pxl, borderVal, imgData);
-                pxQ->push_back(q2Pxl);
-            }
-            
-            for(unsigned int y = 0; y < ySize; ++y)
-            {
-                Q2DPxl q2Pxl = Q2DPxl((xSize-1), y);
-                this->setPxlVal(q2Pxl, borderVal, imgData);
-                pxQ->push_back(q2Pxl);
-            }
-
-        }
-        catch (rsgis::img::RSGISImageCalcException &e)
-        {
-            throw e;
-        }
-        catch (rsgis::RSGISException &e)
-        {
-            throw rsgis::img::RSGISImageCalcException(e.what());
-        }
-        catch (std::exception &e)
-        {
-            throw rsgis::img::RSGISImageCalcException(e.what());
-        }
+        pxQ[qIdx].push_back(pxlIdx);
     }
     
     RSGISHydroDEMFillSoilleGratin94::~RSGISHydroDEMFillSoilleGratin94()
@@ -334,64 +261,6 @@ namespace rsgis{namespace calib{
         
     }
     
-
-    RSGISInitOutputImageSoilleGratin94::RSGISInitOutputImageSoilleGratin94(double noDataVal, double dataVal, double borderVal, std::list<Q2DPxl> *pxQ): rsgis::img::RSGISCalcImageValue(1)
-    {
-        this->noDataVal = noDataVal;
-        this->dataVal = dataVal;
-        this->borderVal = borderVal;
-        this->pxQ = pxQ;
-    }
-    
-    void RSGISInitOutputImageSoilleGratin94::calcImageValue(float ***dataBlock, int numBands, int winSize, double *output, OGREnvelope extent)
-    {
-        if(winSize != 3)
-        {
-            throw rsgis::img::RSGISImageCalcException("Window Size must be 3.");
-        }
-        
-        int hWinSize = (winSize-1)/2;
-        
-        if(dataBlock[0][hWinSize][hWinSize] == 1)
-        {
-            output[0] = dataVal;
-        }
-        else
-        {
-            bool boundary = false;
-            for(int i = 0; i < winSize; ++i)
-            {
-                for(int j = 0; j < winSize; ++j)
-                {
-                    if(dataBlock[0][i][j] == 1)
-                    {
-                        boundary = true;
-                        break;
-                    }
-                }
-                if(boundary)
-                {
-                    break;
-                }
-            }
-            
-            if(boundary)
-            {
-                output[0] = borderVal;
-                this->pxQ->push_back(Q2DPxl(extent.MaxX, extent.MaxY));
-            }
-            else
-            {
-                output[0] = noDataVal;
-            }
-        }
-    }
-    
-    RSGISInitOutputImageSoilleGratin94::~RSGISInitOutputImageSoilleGratin94()
-    {
-        
-    }
-    
 }}
 
 
@@ -34,6 +34,7 @@
 
 #include <iostream>
 #include <string>
+#include <vector>
 #include <cmath>
 
 #include "gdal_priv.h"
@@ -65,24 +66,12 @@
 
 namespace rsgis{namespace calib{
     
-    
-    struct Q2DPxl
-    {
-        Q2DPxl()
-        {
-            this->x = 0;
-            this->y = 0;
-        };
-        Q2DPxl(long x, long y)
-        {
-            this->x = x;
-            this->y = y;
-        };
-        long x;
-        long y;
-    };
-    
-    
+    /**
+     * The DEM, valid mask and output are held in memory and the hierarchical queue
+     * is a flat array of pixel indexes for each level, which is processed as a FIFO.
+     * For DEMs which do not fit in memory use RSGISHydroDEMFillPriorityFlood in
+     * tiled mode.
+     */
     class DllExport RSGISHydroDEMFillSoilleGratin94
     {
     public:
@@ -90,33 +79,12 @@ namespace rsgis{namespace calib{
         void performSoilleGratin94Fill(GDALDataset *inDEMImgDS, GDALDataset *inValidImgDS, GDALDataset *outImgDS, bool calcBorderVal, long borderVal=0);
         ~RSGISHydroDEMFillSoilleGratin94();
     protected:
-        bool qEmpty(long hcrt);
-        Q2DPxl qPopFront(long hcrt);
-        void qPushBack(long hcrt, Q2DPxl pxl);
-        std::list<Q2DPxl>* getNeighbours(Q2DPxl pxl, GDALRasterBand *inValidImg);
-        long getPxlVal(Q2DPxl pxl, GDALRasterBand *imgData);
-        void setPxlVal(Q2DPxl pxl, long val, GDALRasterBand *imgData);
-        long rtnMax(long val1, long val2);
-        void getImagesEdgesToInitFill(GDALRasterBand *imgData, double borderVal, std::list<Q2DPxl> *pxQ);
-        std::list<Q2DPxl> **pxQ;
+        void qPushBack(long hcrt, size_t pxlIdx);
+        std::vector< std::vector<size_t> > pxQ;
         long minVal;
         long maxVal;
         long numLevels;
     };
-  
-    
-    class DllExport RSGISInitOutputImageSoilleGratin94 : public rsgis::img::RSGISCalcImageValue
-    {
-    public:
-        RSGISInitOutputImageSoilleGratin94(double noDataVal, double dataVal, double borderVal, std::list<Q2DPxl> *pxQ);
-        void calcImageValue(float ***dataBlock, int numBands, int winSize, double *output, OGREnvelope extent);
-        ~RSGISInitOutputImageSoilleGratin94();
-    protected:
-        double noDataVal;
-        double dataVal;
-        double borderVal;
-        std::list<Q2DPxl> *pxQ;
-    };
     
 }}
 
@@ -828,7 +828,7 @@ namespace rsgis{namespace classifier{
     }
     
     
-    void RSGISGenAccuracyPoints::generateStratifiedRandomPointsVecOutUsePxlLst(GDALDataset *inputImage, OGRLayer *outputSHPLayer, std::string imgClassCol, std::string vecClassImgCol, std::string vecClassRefCol, unsigned int numPts, unsigned int seed)
+    void RSGISGenAccuracyPoints::generateStratifiedRandomPointsVecOutUsePxlLst(GDALDataset *inputImage, OGRLayer *outputSHPLayer, std::string imgClassCol, std::string vecClassImgCol, std::string vecClassRefCol, unsigned int numPts, unsigned int seed, unsigned int numThreads)
     {
         try
         {
@@ -846,63 +846,34 @@ namespace rsgis{namespace classifier{
             
             auto *classNames = new std::vector<std::string>();
             std::map<unsigned int, unsigned int> pxlValLUT;
-            bool foundClassName = false;
-            unsigned int clsID = 0;
             for(size_t i = 0; i < histogram->size(); ++i)
             {
                 imgClassColVals->at(i) = boost::trim_all_copy(imgClassColVals->at(i));
                 if((histogram->at(i) > 0) & (imgClassColVals->at(i) != ""))
                 {
                     std::cout << i << ") Class " << imgClassColVals->at(i) << " has " << histogram->at(i) << " pixels.\n";
-
-                    pxlValLUT[i] = clsID;
-                    ++clsID;
-
-                    if(classNames->empty())
+                    
+                    auto iterClass = std::find(classNames->begin(), classNames->end(), imgClassColVals->at(i));
+                    pxlValLUT[i] = iterClass - classNames->begin();
+                    if(iterClass == classNames->end())
                     {
                         classNames->push_back(imgClassColVals->at(i));
                     }
-                    else
-                    {
-                        foundClassName = false;
-                        for(auto iterClass = classNames->begin(); iterClass != classNames->end(); ++iterClass)
-                        {
-                            if(*iterClass == imgClassColVals->at(i))
-                            {
-                                foundClassName = true;
-                                break;
-                            }
-                        }
-                        
-                        if(!foundClassName)
-                        {
-                            classNames->push_back(imgClassColVals->at(i));
-                        }
-                    }
                 }
             }
+            delete imgClassColVals;
+            delete histogram;
 
             unsigned long numClasses = classNames->size();
-            auto **classPxlLst = new std::vector<std::pair<double, double> >*[numClasses];
-            unsigned int idx = 0;
-            for(auto iterClasses = classNames->begin(); iterClasses != classNames->end(); ++iterClasses)
-            {
-                classPxlLst[idx] = new std::vector<std::pair<double, double> >();
-                ++idx;
-            }
+            std::vector<RSGISClassPxlReservoir> classReservoirs(numClasses, RSGISClassPxlReservoir(numPts));
+            this->sampleClassPixels(inputImage, pxlValLUT, classReservoirs, seed, numThreads);
             
-            rsgis::img::RSGISCalcImageValue *exClassPxlLocs = new RSGISExtractClassPxllocs(classPxlLst, numClasses, pxlValLUT);
-            rsgis::img::RSGISCalcImage calcImg = rsgis::img::RSGISCalcImage(exClassPxlLocs);
-            calcImg.calcImageExtent(&inputImage, 1, 0);
-            delete exClassPxlLocs;
-            
-            bool **usedPxl = new bool*[numClasses];
             for(unsigned long i = 0; i < numClasses; ++i)
             {
-                usedPxl[i] = new bool[classPxlLst[i]->size()];
-                for(unsigned long j = 0; j < classPxlLst[i]->size(); ++j)
+                if(classReservoirs.at(i).getNumPxls() < numPts)
                 {
-                    usedPxl[i][j] = false;
+                    rsgis::utils::RSGISTextUtils txtUtils;
+                    throw rsgis::RSGISImageException("All pixels (n="+txtUtils.sizettostring(classReservoirs.at(i).getNumPxls())+") for class \""+classNames->at(i)+"\" have been sampled within the image");
                 }
             }
             
@@ -933,52 +904,14 @@ namespace rsgis{namespace classifier{
             int imgClassColIdx = featDefn->GetFieldIndex(vecClassImgCol.c_str());
             int refClassColIdx = featDefn->GetFieldIndex(vecClassRefCol.c_str());
             int processedColIdx = featDefn->GetFieldIndex("Processed");
-            unsigned long pxlIdx = 0;
-            bool foundPxl = false;
-            unsigned long findPxlIterCount = 0;
-            unsigned long checkPt = 0;
-            bool usedAllPxls = false;
             for(unsigned long i = 0; i < numClasses; ++i)
             {
                 std::cout << "Processing Class \"" << classNames->at(i) << "\"\n";
-                srand(seed);
-                checkPt = classPxlLst[i]->size();
-                for(unsigned long j = 0; j < numPts; ++j)
+                std::vector<RSGISAccPtSample> samples = classReservoirs.at(i).getSamples();
+                for(auto iterSmpl = samples.begin(); iterSmpl != samples.end(); ++iterSmpl)
                 {
-                    foundPxl = false;
-                    while(!foundPxl)
-                    {
-                        pxlIdx = rand() % classPxlLst[i]->size();
-                        if(!usedPxl[i][pxlIdx])
-                        {
-                            foundPxl = true;
-                            usedPxl[i][pxlIdx] = true;
-                        }
-                        else if(findPxlIterCount > checkPt)
-                        {
-                            usedAllPxls = true;
-                            for(unsigned long n = 0; n < classPxlLst[i]->size(); ++n)
-                            {
-                                if(!usedPxl[i][n])
-                                {
-                                    usedAllPxls = false;
-                                    break;
-                                }
-                            }
-                            
-                            if(usedAllPxls)
-                            {
-                                rsgis::utils::RSGISTextUtils txtUtils;
-                                throw rsgis::RSGISImageException("All pixels (n="+txtUtils.sizettostring(classPxlLst[i]->size())+") for class \""+classNames->at(i)+"\" have been sampled within the image");
-                            }
-                            checkPt = checkPt + classPxlLst[i]->size();
-                        }
-                        
-                        ++findPxlIterCount;
-                    }
-                    
                     OGRFeature *poFeature = new OGRFeature(featDefn);
-                    OGRPoint *pt = new OGRPoint(classPxlLst[i]->at(pxlIdx).first, classPxlLst[i]->at(pxlIdx).second, 0.0);
+                    OGRPoint *pt = new OGRPoint((*iterSmpl).eastings, (*iterSmpl).northings, 0.0);
                     poFeature->SetGeometryDirectly(pt);
                     
                     poFeature->SetField(imgClassColIdx, classNames->at(i).c_str());
@@ -990,11 +923,6 @@ namespace rsgis{namespace classifier{
             }
             
             delete classNames;
-            for(idx = 0; idx < numClasses; ++idx)
-            {
-                delete classPxlLst[idx];
-            }
-            delete[] classPxlLst;
         }
         catch(rsgis::RSGISImageException &e)
         {
@@ -1008,7 +936,7 @@ namespace rsgis{namespace classifier{
 
 
 
-    void RSGISGenAccuracyPoints::generateStratifiedRandomPointsVecOutUsePxlLstPropPts(GDALDataset *inputImage, OGRLayer *outputSHPLayer, std::string imgClassCol, std::string vecClassImgCol, std::string vecClassRefCol, unsigned int numPts, unsigned int minNumPts, unsigned int seed)
+    void RSGISGenAccuracyPoints::generateStratifiedRandomPointsVecOutUsePxlLstPropPts(GDALDataset *inputImage, OGRLayer *outputSHPLayer, std::string imgClassCol, std::string vecClassImgCol, std::string vecClassRefCol, unsigned int numPts, unsigned int minNumPts, unsigned int seed, unsigned int numThreads)
     {
         try
         {
@@ -1026,8 +954,6 @@ namespace rsgis{namespace classifier{
 
             auto *classNames = new std::vector<std::string>();
             std::map<unsigned int, unsigned int> pxlValLUT;
-            bool foundClassName = false;
-            unsigned int clsID = 0;
             for(size_t i = 0; i < histogram->size(); ++i)
             {
                 imgClassColVals->at(i) = boost::trim_all_copy(imgClassColVals->at(i));
@@ -1035,60 +961,26 @@ namespace rsgis{namespace classifier{
                 {
                     std::cout << i << ") Class " << imgClassColVals->at(i) << " has " << histogram->at(i) << " pixels.\n";
 
-                    pxlValLUT[i] = clsID;
-                    ++clsID;
-
-                    if(classNames->empty())
+                    auto iterClass = std::find(classNames->begin(), classNames->end(), imgClassColVals->at(i));
+                    pxlValLUT[i] = iterClass - classNames->begin();
+                    if(iterClass == classNames->end())
                     {
                         classNames->push_back(imgClassColVals->at(i));
                     }
-                    else
-                    {
-                        foundClassName = false;
-                        for(auto iterClass = classNames->begin(); iterClass != classNames->end(); ++iterClass)
-                        {
-                            if(*iterClass == imgClassColVals->at(i))
-                            {
-                                foundClassName = true;
-                                break;
-                            }
-                        }
-
-                        if(!foundClassName)
-                        {
-                            classNames->push_back(imgClassColVals->at(i));
-                        }
-                    }
                 }
             }
+            delete imgClassColVals;
+            delete histogram;
 
+            // The number of samples for a class is at most the larger of numPts and minNumPts
+            // so reservoirs of that size are sampled and then cut down to the number required.
             unsigned long numClasses = classNames->size();
-            auto **classPxlLst = new std::vector<std::pair<double, double> >*[numClasses];
-            unsigned int idx = 0;
-            for(auto iterClasses = classNames->begin(); iterClasses != classNames->end(); ++iterClasses)
-            {
-                classPxlLst[idx] = new std::vector<std::pair<double, double> >();
-                ++idx;
-            }
-
-            rsgis::img::RSGISCalcImageValue *exClassPxlLocs = new RSGISExtractClassPxllocs(classPxlLst, numClasses, pxlValLUT);
-            rsgis::img::RSGISCalcImage calcImg = rsgis::img::RSGISCalcImage(exClassPxlLocs);
-            calcImg.calcImageExtent(&inputImage, 1, 0);
-            delete exClassPxlLocs;
-
-            bool **usedPxl = new bool*[numClasses];
-            for(unsigned long i = 0; i < numClasses; ++i)
-            {
-                usedPxl[i] = new bool[classPxlLst[i]->size()];
-                for(unsigned long j = 0; j < classPxlLst[i]->size(); ++j)
-                {
-                    usedPxl[i][j] = false;
-                }
-            }
+            std::vector<RSGISClassPxlReservoir> classReservoirs(numClasses, RSGISClassPxlReservoir(std::max(numPts, minNumPts)));
+            this->sampleClassPixels(inputImage, pxlValLUT, classReservoirs, seed, numThreads);
 
             double totNumPxls = 0;
             for(unsigned long i = 0; i < numClasses; ++i) {
-                totNumPxls += classPxlLst[i]->size();
+                totNumPxls += classReservoirs.at(i).getNumPxls();
             }
             std::cout << "Total number of pixels is " << totNumPxls << std::endl;
 
@@ -1119,67 +1011,32 @@ namespace rsgis{namespace classifier{
             int imgClassColIdx = featDefn->GetFieldIndex(vecClassImgCol.c_str());
             int refClassColIdx = featDefn->GetFieldIndex(vecClassRefCol.c_str());
             int processedColIdx = featDefn->GetFieldIndex("Processed");
-            unsigned long pxlIdx = 0;
-            bool foundPxl = false;
-            unsigned long findPxlIterCount = 0;
-            unsigned long checkPt = 0;
-            bool usedAllPxls = false;
+            unsigned long numClassPxls = 0;
             float propOfScn = 0.0;
             unsigned long nSmplPts = 0;
             unsigned int totNSmpls = 0;
             for(unsigned long i = 0; i < numClasses; ++i)
             {
                 std::cout << "Processing Class \"" << classNames->at(i) << "\"\n";
-                srand(seed);
-                checkPt = classPxlLst[i]->size();
-                propOfScn = checkPt/totNumPxls;
+                numClassPxls = classReservoirs.at(i).getNumPxls();
+                propOfScn = numClassPxls/totNumPxls;
                 nSmplPts = floor((propOfScn * numPts)+0.5);
                 if (nSmplPts < minNumPts)
                 {
                     nSmplPts = minNumPts;
                 }
-                if (nSmplPts > checkPt)
+                if (nSmplPts > numClassPxls)
                 {
-                    nSmplPts = checkPt;
+                    nSmplPts = numClassPxls;
                 }
                 std::cout << "\t" << nSmplPts << " samples will be selected\n";
                 totNSmpls += nSmplPts;
+                
+                std::vector<RSGISAccPtSample> samples = classReservoirs.at(i).getSamples();
                 for(unsigned long j = 0; j < nSmplPts; ++j)
                 {
-                    foundPxl = false;
-                    while(!foundPxl)
-                    {
-                        pxlIdx = rand() % classPxlLst[i]->size();
-                        if(!usedPxl[i][pxlIdx])
-                        {
-                            foundPxl = true;
-                            usedPxl[i][pxlIdx] = true;
-                        }
-                        else if(findPxlIterCount > checkPt)
-                        {
-                            usedAllPxls = true;
-                            for(unsigned long n = 0; n < classPxlLst[i]->size(); ++n)
-                            {
-                                if(!usedPxl[i][n])
-                                {
-                                    usedAllPxls = false;
-                                    break;
-                                }
-                            }
-
-                            if(usedAllPxls)
-                            {
-                                rsgis::utils::RSGISTextUtils txtUtils;
-                                throw rsgis::RSGISImageException("All pixels (n="+txtUtils.sizettostring(classPxlLst[i]->size())+") for class \""+classNames->at(i)+"\" have been sampled within the image");
-                            }
-                            checkPt = checkPt + classPxlLst[i]->size();
-                        }
-
-                        ++findPxlIterCount;
-                    }
-
                     OGRFeature *poFeature = new OGRFeature(featDefn);
-                    OGRPoint *pt = new OGRPoint(classPxlLst[i]->at(pxlIdx).first, classPxlLst[i]->at(pxlIdx).second, 0.0);
+                    OGRPoint *pt = new OGRPoint(samples.at(j).eastings, samples.at(j).northings, 0.0);
                     poFeature->SetGeometryDirectly(pt);
 
                     poFeature->SetField(imgClassColIdx, classNames->at(i).c_str());
@@ -1192,11 +1049,6 @@ namespace rsgis{namespace classifier{
 
             std::cout << "Total number of samples: " << totNSmpls << std::endl;
             delete classNames;
-            for(idx = 0; idx < numClasses; ++idx)
-            {
-                delete classPxlLst[idx];
-            }
-            delete[] classPxlLst;
         }
         catch(rsgis::RSGISImageException &e)
         {
@@ -1510,6 +1362,147 @@ namespace rsgis{namespace classifier{
         return classes;
     }
     
+    void RSGISGenAccuracyPoints::sampleClassPixels(GDALDataset *inputImage, std::map<unsigned int, unsigned int> &pxlValLUT, std::vector<RSGISClassPxlReservoir> &classReservoirs, unsigned int seed, unsigned int numThreads)
+    {
+        if(numThreads == 0)
+        {
+            numThreads = 1;
+        }
+        
+        // Flat look up table from the pixel value to the class reservoir.
+        const unsigned int noClass = std::numeric_limits<unsigned int>::max();
+        std::vector<unsigned int> clsLUT;
+        if(!pxlValLUT.empty())
+        {
+            clsLUT.resize(pxlValLUT.rbegin()->first+1, noClass);
+        }
+        for(auto iterLUT = pxlValLUT.begin(); iterLUT != pxlValLUT.end(); ++iterLUT)
+        {
+            if(iterLUT->second < classReservoirs.size())
+            {
+                clsLUT[iterLUT->first] = iterLUT->second;
+            }
+        }
+        
+        double *trans = new double[6];
+        inputImage->GetGeoTransform(trans);
+        double tlX = trans[0];
+        double tlY = trans[3];
+        double xRes = trans[1];
+        double yRes = trans[5];
+        delete[] trans;
+        
+        GDALRasterBand *imgBand = inputImage->GetRasterBand(1);
+        size_t xSize = inputImage->GetRasterXSize();
+        size_t ySize = inputImage->GetRasterYSize();
+        int xBlockSize = 0;
+        int yBlockSize = 0;
+        imgBand->GetBlockSize(&xBlockSize, &yBlockSize);
+        if(yBlockSize < 1)
+        {
+            yBlockSize = 1;
+        }
+        // Read whole image blocks, around 1 million pixels at a time.
+        size_t nRowsChunk = yBlockSize * std::max<size_t>(1, (1024*1024)/(xSize*yBlockSize));
+        std::vector<unsigned int> chunkData(xSize*nRowsChunk);
+        
+        // The key of a pixel is a hash (splitmix64, which is a bijection) of the
+        // seeded pixel index so every pixel has a different key.
+        uint64_t seedOff = ((uint64_t)seed) * 0x9E3779B97F4A7C15ULL;
+        auto pxlKey = [seedOff](uint64_t pxlIdx)
+        {
+            uint64_t z = pxlIdx + seedOff;
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+            return z ^ (z >> 31);
+        };
+        
+        // Each thread fills its own reservoirs, which are merged at the end.
+        std::vector<std::vector<RSGISClassPxlReservoir> > threadReservoirs(numThreads, classReservoirs);
+        
+        size_t nChunks = (ySize + nRowsChunk - 1) / nRowsChunk;
+        rsgis_tqdm pbar;
+        for(size_t c = 0; c < nChunks; ++c)
+        {
+            pbar.progress(c, nChunks);
+            size_t rowStart = c * nRowsChunk;
+            size_t nRows = std::min(nRowsChunk, ySize - rowStart);
+            if(imgBand->RasterIO(GF_Read, 0, rowStart, xSize, nRows, chunkData.data(), xSize, nRows, GDT_UInt32, 0, 0) != CE_None)
+            {
+                throw rsgis::RSGISImageException("Could not read the image data.");
+            }
+            
+            auto sampleRows = [&](unsigned int t, size_t rowBegin, size_t rowEnd)
+            {
+                std::vector<RSGISClassPxlReservoir> &reservoirs = threadReservoirs[t];
+                for(size_t j = rowBegin; j < rowEnd; ++j)
+                {
+                    double northings = tlY + ((rowStart + j + 0.5) * yRes);
+                    for(size_t i = 0; i < xSize; ++i)
+                    {
+                        unsigned int pxlVal = chunkData[(j*xSize)+i];
+                        if((pxlVal > 0) && (pxlVal < clsLUT.size()) && (clsLUT[pxlVal] != noClass))
+                        {
+                            uint64_t pxlIdx = ((rowStart + j) * xSize) + i;
+                            reservoirs[clsLUT[pxlVal]].addPixel(pxlKey(pxlIdx), tlX + ((i + 0.5) * xRes), northings);
+                        }
+                    }
+                }
+            };
+            
+            unsigned int numThreadsUsed = std::min<size_t>(numThreads, nRows);
+            if(numThreadsUsed <= 1)
+            {
+                sampleRows(0, 0, nRows);
+            }
+            else
+            {
+                std::atomic<size_t> nextRow(0);
+                std::vector<std::exception_ptr> threadErrors(numThreadsUsed, nullptr);
+                std::vector<std::thread> threads;
+                threads.reserve(numThreadsUsed);
+                for(unsigned int t = 0; t < numThreadsUsed; ++t)
+                {
+                    threads.push_back(std::thread([&, t]()
+                    {
+                        try
+                        {
+                            size_t j = 0;
+                            while((j = nextRow++) < nRows)
+                            {
+                                sampleRows(t, j, j+1);
+                            }
+                        }
+                        catch(...)
+                        {
+                            threadErrors[t] = std::current_exception();
+                        }
+                    }));
+                }
+                for(std::vector<std::thread>::iterator iterThreads = threads.begin(); iterThreads != threads.end(); ++iterThreads)
+                {
+                    (*iterThreads).join();
+                }
+                for(std::vector<std::exception_ptr>::iterator iterErrs = threadErrors.begin(); iterErrs != threadErrors.end(); ++iterErrs)
+                {
+                    if(*iterErrs)
+                    {
+                        std::rethrow_exception(*iterErrs);
+                    }
+                }
+            }
+        }
+        pbar.finish();
+        
+        for(unsigned int t = 0; t < numThreads; ++t)
+        {
+            for(size_t n = 0; n < classReservoirs.size(); ++n)
+            {
+                classReservoirs[n].merge(threadReservoirs[t][n]);
+            }
+        }
+    }
+    
     RSGISGenAccuracyPoints::~RSGISGenAccuracyPoints()
     {
         
@@ -1517,44 +1510,53 @@ namespace rsgis{namespace classifier{
     
     
     
-    RSGISExtractClassPxllocs::RSGISExtractClassPxllocs(std::vector<std::pair<double, double> > **classPxlLst, unsigned long numClasses, std::map<unsigned int, unsigned int> pxlValLUT):rsgis::img::RSGISCalcImageValue(0)
+    RSGISClassPxlReservoir::RSGISClassPxlReservoir(size_t numPts)
     {
-        this->classPxlLst = classPxlLst;
-        this->numClasses = numClasses;
-        this->pxlValLUT = pxlValLUT;
+        this->numPts = numPts;
+        this->numPxls = 0;
     }
     
-    void RSGISExtractClassPxllocs::calcImageValue(long *intBandValues, unsigned int numIntVals, float *floatBandValues, unsigned int numfloatVals, OGREnvelope extent)
+    void RSGISClassPxlReservoir::addPixel(uint64_t key, double eastings, double northings)
     {
-        if((numIntVals != 1) & (numfloatVals != 0))
-        {
-            throw rsgis::img::RSGISImageCalcException("Only expecting a single integer input image band.");
-        }
-        
-        if(intBandValues[0] > 0)
+        ++this->numPxls;
+        RSGISAccPtSample sample;
+        sample.key = key;
+        sample.eastings = eastings;
+        sample.northings = northings;
+        this->addSample(sample);
+    }
+    
+    void RSGISClassPxlReservoir::merge(const RSGISClassPxlReservoir &other)
+    {
+        this->numPxls += other.numPxls;
+        for(auto iterSmpl = other.samples.begin(); iterSmpl != other.samples.end(); ++iterSmpl)
         {
-            if(this->pxlValLUT.count(intBandValues[0]) > 0)
-            {
-                unsigned int clsID = this->pxlValLUT[intBandValues[0]];
-                if (clsID <= this->numClasses)
-                {
-                    double x = extent.MinX + ((extent.MaxX - extent.MinX) / 2);
-                    double y = extent.MinY + ((extent.MaxY - extent.MinY) / 2);
-                    this->classPxlLst[clsID]->push_back(std::pair<double, double>(x, y));
-                }
-            }
+            this->addSample(*iterSmpl);
         }
     }
-
-    RSGISExtractClassPxllocs::~RSGISExtractClassPxllocs()
+    
+    std::vector<RSGISAccPtSample> RSGISClassPxlReservoir::getSamples() const
     {
-        
+        std::vector<RSGISAccPtSample> sorted = this->samples;
+        std::sort(sorted.begin(), sorted.end(), compareAccPtSampleKey);
+        return sorted;
+    }
+    
+    void RSGISClassPxlReservoir::addSample(const RSGISAccPtSample &sample)
+    {
+        // The samples are a max heap on the key so the largest key is replaced.
+        if(this->samples.size() < this->numPts)
+        {
+            this->samples.push_back(sample);
+            std::push_heap(this->samples.begin(), this->samples.end(), compareAccPtSampleKey);
+        }
+        else if((this->numPts > 0) && (sample.key < this->samples.front().key))
+        {
+            std::pop_heap(this->samples.begin(), this->samples.end(), compareAccPtSampleKey);
+            this->samples.back() = sample;
+            std::push_heap(this->samples.begin(), this->samples.end(), compareAccPtSampleKey);
+        }
     }
     
 }}
 
-
-
-
-
-
@@ -30,6 +30,12 @@
 #include <vector>
 #include <map>
 #include <utility>
+#include <algorithm>
+#include <thread>
+#include <atomic>
+#include <exception>
+#include <cstdint>
+#include <limits>
 
 #include "gdal_priv.h"
 #include "gdal_rat.h"
@@ -101,6 +107,44 @@ namespace rsgis{namespace classifier{
         }
     };
     
+    struct DllExport RSGISAccPtSample
+    {
+        uint64_t key;
+        double eastings;
+        double northings;
+    };
+    
+    inline bool compareAccPtSampleKey(const RSGISAccPtSample &first, const RSGISAccPtSample &second)
+    {
+        return first.key < second.key;
+    };
+    
+    /**
+     * A reservoir holding the (up to) numPts pixels of a class with the smallest
+     * random keys, which is a uniform random sample of the pixels of the class.
+     * The key of a pixel is a hash of the seed and the pixel index, so the sample
+     * does not depend on the order the pixels are added and the reservoirs for
+     * different blocks of an image can be merged. Taking the first n samples of
+     * getSamples() gives a random sample of n <= numPts pixels.
+     */
+    class DllExport RSGISClassPxlReservoir
+    {
+    public:
+        RSGISClassPxlReservoir(size_t numPts);
+        void addPixel(uint64_t key, double eastings, double northings);
+        void merge(const RSGISClassPxlReservoir &other);
+        /** The samples sorted by key. */
+        std::vector<RSGISAccPtSample> getSamples() const;
+        /** The number of pixels added, including those not held in the reservoir. */
+        size_t getNumPxls() const {return numPxls;};
+        ~RSGISClassPxlReservoir(){};
+    protected:
+        void addSample(const RSGISAccPtSample &sample);
+        size_t numPts;
+        size_t numPxls;
+        std::vector<RSGISAccPtSample> samples;
+    };
+    
 	class DllExport RSGISGenAccuracyPoints
     {
     public:
@@ -110,8 +154,8 @@ namespace rsgis{namespace classifier{
         
         void generateRandomPointsVecOut(GDALDataset *inputImage, OGRLayer *outputSHPLayer, std::string imgClassCol, std::string vecClassImgCol, std::string vecClassRefCol, unsigned int numPts, unsigned int seed);
         void generateStratifiedRandomPointsVecOut(GDALDataset *inputImage, OGRLayer *outputSHPLayer, std::string imgClassCol, std::string vecClassImgCol, std::string vecClassRefCol, unsigned int numPts, unsigned int seed);
-        void generateStratifiedRandomPointsVecOutUsePxlLst(GDALDataset *inputImage, OGRLayer *outputSHPLayer, std::string imgClassCol, std::string vecClassImgCol, std::string vecClassRefCol, unsigned int numPts, unsigned int seed);
-        void generateStratifiedRandomPointsVecOutUsePxlLstPropPts(GDALDataset *inputImage, OGRLayer *outputSHPLayer, std::string imgClassCol, std::string vecClassImgCol, std::string vecClassRefCol, unsigned int numPts, unsigned int minNumPts, unsigned int seed);
+        void generateStratifiedRandomPointsVecOutUsePxlLst(GDALDataset *inputImage, OGRLayer *outputSHPLayer, std::string imgClassCol, std::string vecClassImgCol, std::string vecClassRefCol, unsigned int numPts, unsigned int seed, unsigned int numThreads=1);
+        void generateStratifiedRandomPointsVecOutUsePxlLstPropPts(GDALDataset *inputImage, OGRLayer *outputSHPLayer, std::string imgClassCol, std::string vecClassImgCol, std::string vecClassRefCol, unsigned int numPts, unsigned int minNumPts, unsigned int seed, unsigned int numThreads=1);
         void popClassInfo2Vec(GDALDataset *inputImage, OGRLayer *outputSHPLayer, std::string imgClassCol, std::string vecClassImgCol, std::string vecClassRefCol, bool addRefCol, std::string vecProcessCol, bool addProcessCol);
         
         ~RSGISGenAccuracyPoints();
@@ -119,20 +163,10 @@ namespace rsgis{namespace classifier{
         float findPixelVal(GDALDataset *image, unsigned int band, double eastings, double northings, double tlX, double tlY, double xRes, double yRes, unsigned int xSize, unsigned int ySize);
         std::string findClassVal(GDALDataset *image, unsigned int band, GDALRasterAttributeTable *attTable, unsigned int classNameColIdx, unsigned int xPxl, unsigned int yPxl);
         std::list<std::string>* findUniqueClasses(GDALRasterAttributeTable *attTable, unsigned int classNameColIdx, int histoColIdx);
+        /** Reads the class image a block of rows at a time, adding each pixel to the reservoir of its class (pxlValLUT maps pixel values to reservoirs). */
+        void sampleClassPixels(GDALDataset *inputImage, std::map<unsigned int, unsigned int> &pxlValLUT, std::vector<RSGISClassPxlReservoir> &classReservoirs, unsigned int seed, unsigned int numThreads);
     };
     
-    class DllExport RSGISExtractClassPxllocs : public rsgis::img::RSGISCalcImageValue
-    {
-    public:
-        RSGISExtractClassPxllocs(std::vector<std::pair<double, double> > **classPxlLst, unsigned long numClasses, std::map<unsigned int, unsigned int> pxlValLUT);
-        void calcImageValue(long *intBandValues, unsigned int numIntVals, float *floatBandValues, unsigned int numfloatVals, OGREnvelope extent);
-        ~RSGISExtractClassPxllocs();
-    private:
-        std::vector<std::pair<double, double> > **classPxlLst;
-        unsigned long numClasses;
-        std::map<unsigned int, unsigned int> pxlValLUT;
-    };
-		
 }}
 
 #endif
@@ -211,7 +211,7 @@ namespace rsgis{ namespace cmds {
     }
 
     
-    void executeGenerateStratifiedRandomAccuracyPts(std::string classImage, std::string outputVecFile, std::string outputVecLyr, std::string outVecFormat, std::string classImgCol, std::string classImgVecCol, std::string classRefVecCol, unsigned int numPtsPerClass, unsigned int seed, bool del_exist_vec, bool usePxlLst)
+    void executeGenerateStratifiedRandomAccuracyPts(std::string classImage, std::string outputVecFile, std::string outputVecLyr, std::string outVecFormat, std::string classImgCol, std::string classImgVecCol, std::string classRefVecCol, unsigned int numPtsPerClass, unsigned int seed, bool del_exist_vec, bool usePxlLst, unsigned int numThreads)
     {
         try
         {
@@ -296,7 +296,7 @@ namespace rsgis{ namespace cmds {
             }
             else
             {
-                genAccPts.generateStratifiedRandomPointsVecOutUsePxlLst(imgDataset, outputVecLyrObj, classImgCol, classImgVecCol, classRefVecCol, numPtsPerClass, seed);
+                genAccPts.generateStratifiedRandomPointsVecOutUsePxlLst(imgDataset, outputVecLyrObj, classImgCol, classImgVecCol, classRefVecCol, numPtsPerClass, seed, numThreads);
             }
             
             GDALClose(imgDataset);
@@ -312,7 +312,7 @@ namespace rsgis{ namespace cmds {
         }
     }
 
-        void executeGenerateStratifiedPropRandomAccuracyPts(std::string classImage, std::string outputVecFile, std::string outputVecLyr, std::string outVecFormat, std::string classImgCol, std::string classImgVecCol, std::string classRefVecCol, unsigned int numPts, unsigned int minNumPts, unsigned int seed, bool del_exist_vec)
+        void executeGenerateStratifiedPropRandomAccuracyPts(std::string classImage, std::string outputVecFile, std::string outputVecLyr, std::string outVecFormat, std::string classImgCol, std::string classImgVecCol, std::string classRefVecCol, unsigned int numPts, unsigned int minNumPts, unsigned int seed, bool del_exist_vec, unsigned int numThreads)
         {
             try
             {
@@ -391,7 +391,7 @@ namespace rsgis{ namespace cmds {
                 }
 
                 rsgis::classifier::RSGISGenAccuracyPoints genAccPts;
-                genAccPts.generateStratifiedRandomPointsVecOutUsePxlLstPropPts(imgDataset, outputVecLyrObj, classImgCol, classImgVecCol, classRefVecCol, numPts, minNumPts, seed);
+                genAccPts.generateStratifiedRandomPointsVecOutUsePxlLstPropPts(imgDataset, outputVecLyrObj, classImgCol, classImgVecCol, classRefVecCol, numPts, minNumPts, seed, numThreads);
 
                 GDALClose(imgDataset);
                 GDALClose(outputVecDS);
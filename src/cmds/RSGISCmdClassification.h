@@ -56,10 +56,10 @@ namespace rsgis{ namespace cmds {
     DllExport void executeGenerateRandomAccuracyPts(std::string classImage, std::string outputVecFile, std::string outputVecLyr, std::string outVecFormat, std::string classImgCol, std::string classImgVecCol, std::string classRefVecCol, unsigned int numPts, unsigned int seed, bool del_exist_vec);
     
     /** A function to generate stratified random points which can be used to assess the accuracy of a map */
-    DllExport void executeGenerateStratifiedRandomAccuracyPts(std::string classImage, std::string outputVecFile, std::string outputVecLyr, std::string outVecFormat, std::string classImgCol, std::string classImgVecCol, std::string classRefVecCol, unsigned int numPtsPerClass, unsigned int seed, bool del_exist_vec, bool usePxlLst);
+    DllExport void executeGenerateStratifiedRandomAccuracyPts(std::string classImage, std::string outputVecFile, std::string outputVecLyr, std::string outVecFormat, std::string classImgCol, std::string classImgVecCol, std::string classRefVecCol, unsigned int numPtsPerClass, unsigned int seed, bool del_exist_vec, bool usePxlLst, unsigned int numThreads=1);
 
     /** A function to generate stratified random points which can be used to assess the accuracy of a map */
-    DllExport void executeGenerateStratifiedPropRandomAccuracyPts(std::string classImage, std::string outputVecFile, std::string outputVecLyr, std::string outVecFormat, std::string classImgCol, std::string classImgVecCol, std::string classRefVecCol, unsigned int numPts, unsigned int minNumPts, unsigned int seed, bool del_exist_vec);
+    DllExport void executeGenerateStratifiedPropRandomAccuracyPts(std::string classImage, std::string outputVecFile, std::string outputVecLyr, std::string outVecFormat, std::string classImgCol, std::string classImgVecCol, std::string classRefVecCol, unsigned int numPts, unsigned int minNumPts, unsigned int seed, bool del_exist_vec, unsigned int numThreads=1);
 
     /** A function to populate a set of points with the class information to assess the accuracy of a map */
     DllExport void executePopClassInfoAccuracyPts(std::string classImage, std::string vecFile, std::string vecLyr, std::string classImgCol, std::string classImgVecCol, std::string classRefVecCol="", bool addRefCol=false, std::string processVecCol="", bool addProcessCol=false);
@@ -25,6 +25,7 @@
 
 #include "calibration/RSGISDEMTools.h"
 #include "calibration/RSGISHydroDEMFillSoilleGratin94.h"
+#include "calibration/RSGISHydroDEMFillPriorityFlood.h"
 
 namespace rsgis{ namespace cmds {
     
@@ -640,6 +641,54 @@ namespace rsgis{ namespace cmds {
         }
     }
     
+    void executeDEMFillPriorityFlood(std::string inImage, std::string validDataImg, std::string outputImage, std::string outImageFormat, bool epsilon, unsigned int tileSize)
+    {
+        try
+        {
+            GDALAllRegister();
+            
+            std::cout << "Open " << inImage << std::endl;
+            auto *inImgDS = (GDALDataset *) GDALOpen(inImage.c_str(), GA_ReadOnly);
+            if(inImgDS == NULL)
+            {
+                std::string message = std::string("Could not open image ") + inImage;
+                throw rsgis::RSGISImageException(message.c_str());
+            }
+            GDALDataset *inValidImgDS = NULL;
+            if(validDataImg != "")
+            {
+                std::cout << "Open " << validDataImg << std::endl;
+                inValidImgDS = (GDALDataset *) GDALOpen(validDataImg.c_str(), GA_ReadOnly);
+                if(inValidImgDS == NULL)
+                {
+                    std::string message = std::string("Could not open image ") + validDataImg;
+                    throw rsgis::RSGISImageException(message.c_str());
+                }
+            }
+            
+            rsgis::img::RSGISImageUtils imgUtils;
+            GDALDataset *outImgDS = imgUtils.createCopy(inImgDS, 1, outputImage, outImageFormat, GDT_Float32);
+            
+            rsgis::calib::RSGISHydroDEMFillPriorityFlood fillDEMInst(epsilon);
+            fillDEMInst.performFill(inImgDS, inValidImgDS, outImgDS, tileSize);
+            
+            GDALClose(inImgDS);
+            if(inValidImgDS != NULL)
+            {
+                GDALClose(inValidImgDS);
+            }
+            GDALClose(outImgDS);
+        }
+        catch(rsgis::RSGISException &e)
+        {
+            throw RSGISCmdException(e.what());
+        }
+        catch(std::exception &e)
+        {
+            throw RSGISCmdException(e.what());
+        }
+    }
+    
     void executePlaneFitDetreadDEM(std::string demImage, std::string outputImage, std::string outImageFormat, int winSize)
     {
         try
@@ -76,6 +76,8 @@ namespace rsgis{ namespace cmds {
     DllExport void executeDTMAspectMedianFilter(std::string demImage, std::string aspectImage, std::string outputImage, float aspectRange, int winHSize, std::string outImageFormat);
     /** A function to fill a DEM using the Soille and Gratin 1994 algorthm */
     DllExport void executeDEMFillSoilleGratin1994(std::string inImage, std::string validDataImg, std::string outputImage, std::string outImageFormat);
+    /** A function to fill a DEM using the Priority-Flood algorithm (Barnes et al., 2014), validDataImg is optional (empty string) and if tileSize > 0 the DEM is processed in tiles (Barnes, 2016) */
+    DllExport void executeDEMFillPriorityFlood(std::string inImage, std::string validDataImg, std::string outputImage, std::string outImageFormat, bool epsilon=false, unsigned int tileSize=0);
     /** A function which detreads an elevation model using local plane fitting */
     DllExport void executePlaneFitDetreadDEM(std::string demImage, std::string outputImage, std::string outImageFormat, int winSize);
 }}
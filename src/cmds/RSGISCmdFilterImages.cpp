@@ -296,6 +296,25 @@ namespace rsgis
                                 );
                         filterBank->addFilter(filter);
                     }
+                    else if ((*iterFilter)->type == "Percentile")
+                    {
+                        if (((*iterFilter)->percentile < 0) || ((*iterFilter)->percentile > 100))
+                        {
+                            throw RSGISCmdException(
+                                "The percentile must be between 0 and 100."
+                            );
+                        }
+                        rsgis::filter::RSGISImageFilter *filter = new
+                                rsgis::filter::RSGISPercentileFilter(
+                                    0,
+                                    (*iterFilter)->size,
+                                    (*iterFilter)->fileEnding,
+                                    demNoDataValAvail,
+                                    demNoDataVal,
+                                    (*iterFilter)->percentile
+                                );
+                        filterBank->addFilter(filter);
+                    }
                     else if ((*iterFilter)->type == "Range")
                     {
                         rsgis::filter::RSGISImageFilter *filter = new
@@ -59,6 +59,7 @@ namespace rsgis
             float stddevX;
             float stddevY;
             float angle;
+            float percentile;
         };
 
         /** Function to apply filters to an image */
@@ -71,7 +71,7 @@
 
 namespace rsgis{ namespace cmds {
 
-    void executeBandMaths(VariableStruct *variables, unsigned int numVars, std::string outputImage, std::string mathsExpression, std::string gdalFormat, RSGISLibDataType outDataType, bool useExpAsbandName, bool editOutputImg)
+    void executeBandMaths(VariableStruct *variables, unsigned int numVars, std::string outputImage, std::string mathsExpression, std::string gdalFormat, RSGISLibDataType outDataType, bool useExpAsbandName, bool editOutputImg, unsigned int numThreads, bool useBulkEval)
     {
         GDALAllRegister();
         GDALDataset **datasets = NULL;
@@ -180,8 +180,8 @@ namespace rsgis{ namespace cmds {
                 }
             }
 
-            bandmaths = new rsgis::img::RSGISBandMath(1, processVaribles, numVars, muParser);
-            calcImage = new rsgis::img::RSGISCalcImage(bandmaths, "", true);
+            bandmaths = new rsgis::img::RSGISBandMath(1, processVaribles, numVars, muParser, useBulkEval);
+            calcImage = new rsgis::img::RSGISCalcImage(bandmaths, "", true, numThreads);
             if(editOutputImg)
             {
                 calcImage->calcImagePartialOutput(datasets, total_n_imgs, outDataset);
@@ -236,7 +236,7 @@ namespace rsgis{ namespace cmds {
         }
     }
 
-    void executeImageMaths(std::string inputImage, std::string outputImage, std::string mathsExpression, std::string imageFormat, RSGISLibDataType outDataType, bool useExpAsbandName, bool editOutputImg)
+    void executeImageMaths(std::string inputImage, std::string outputImage, std::string mathsExpression, std::string imageFormat, RSGISLibDataType outDataType, bool useExpAsbandName, bool editOutputImg, unsigned int numThreads)
     {
         GDALAllRegister();
         GDALDataset **datasets = NULL;
@@ -295,7 +295,7 @@ namespace rsgis{ namespace cmds {
 
             imageMaths = new rsgis::img::RSGISImageMaths(numRasterBands, muParser);
 
-            calcImage = new rsgis::img::RSGISCalcImage(imageMaths, "", true);
+            calcImage = new rsgis::img::RSGISCalcImage(imageMaths, "", true, numThreads);
             
             if(editOutputImg)
             {
@@ -343,7 +343,7 @@ namespace rsgis{ namespace cmds {
     }
                 
                 
-    void executeImageBandMaths(std::string inputImage, std::string outputImage, std::string mathsExpression, std::string imageFormat, RSGISLibDataType outDataType, bool useExpAsbandName, bool editOutputImg)
+    void executeImageBandMaths(std::string inputImage, std::string outputImage, std::string mathsExpression, std::string imageFormat, RSGISLibDataType outDataType, bool useExpAsbandName, bool editOutputImg, unsigned int numThreads)
     {
         GDALAllRegister();
         GDALDataset **datasets = NULL;
@@ -410,7 +410,7 @@ namespace rsgis{ namespace cmds {
             
             imageMaths = new rsgis::img::RSGISImageBandMaths(muParser, numRasterBands, bNames);
             
-            calcImage = new rsgis::img::RSGISCalcImage(imageMaths, "", true);
+            calcImage = new rsgis::img::RSGISCalcImage(imageMaths, "", true, numThreads);
             
             if(editOutputImg)
             {
@@ -457,7 +457,7 @@ namespace rsgis{ namespace cmds {
         }
     }
 
-    void executeKMeansClustering(std::string inputImage, std::string outputMatrixFile, unsigned int numClusters, unsigned int maxNumIterations, unsigned int subSample, bool ignoreZeros, float degreeOfChange, RSGISInitClustererMethods initClusterMethod)
+    void executeKMeansClustering(std::string inputImage, std::string outputMatrixFile, unsigned int numClusters, unsigned int maxNumIterations, unsigned int subSample, bool ignoreZeros, float degreeOfChange, RSGISInitClustererMethods initClusterMethod, unsigned int numThreads)
     {
         
         std::cout << "inputImage = " << inputImage << std::endl;
@@ -510,7 +510,7 @@ namespace rsgis{ namespace cmds {
             }
 
             rsgis::img::RSGISImageClustering imgClustering;
-            imgClustering.findKMeansCentres(dataset, outputMatrixFile, numClusters, maxNumIterations, subSample, ignoreZeros, degreeOfChange, initMethod);
+            imgClustering.findKMeansCentres(dataset, outputMatrixFile, numClusters, maxNumIterations, subSample, ignoreZeros, degreeOfChange, initMethod, numThreads);
 
             GDALClose(dataset);
         }
@@ -524,7 +524,7 @@ namespace rsgis{ namespace cmds {
         }
     }
 
-    void executeISODataClustering(std::string inputImage, std::string outputMatrixFile, unsigned int numClusters, unsigned int maxNumIterations, unsigned int subSample, bool ignoreZeros, float degreeOfChange, RSGISInitClustererMethods initClusterMethod, float minDistBetweenClusters, unsigned int minNumFeatures, float maxStdDev, unsigned int minNumClusters, unsigned int startIteration, unsigned int endIteration)
+    void executeISODataClustering(std::string inputImage, std::string outputMatrixFile, unsigned int numClusters, unsigned int maxNumIterations, unsigned int subSample, bool ignoreZeros, float degreeOfChange, RSGISInitClustererMethods initClusterMethod, float minDistBetweenClusters, unsigned int minNumFeatures, float maxStdDev, unsigned int minNumClusters, unsigned int startIteration, unsigned int endIteration, unsigned int numThreads)
     {
         try
         {
@@ -564,7 +564,7 @@ namespace rsgis{ namespace cmds {
             }
 
             rsgis::img::RSGISImageClustering imgClustering;
-            imgClustering.findISODataCentres(dataset, outputMatrixFile, numClusters, maxNumIterations, subSample, ignoreZeros, degreeOfChange, initMethod, minDistBetweenClusters, minNumFeatures, maxStdDev, minNumClusters, startIteration, endIteration);
+            imgClustering.findISODataCentres(dataset, outputMatrixFile, numClusters, maxNumIterations, subSample, ignoreZeros, degreeOfChange, initMethod, minDistBetweenClusters, minNumFeatures, maxStdDev, minNumClusters, startIteration, endIteration, numThreads);
 
             GDALClose(dataset);
         }
@@ -711,7 +711,7 @@ namespace rsgis{ namespace cmds {
         }
     }
 
-    void executeImagePixelColumnSummary(std::string inputImage, std::string outputImage, rsgis::cmds::RSGISCmdStatsSummary summaryStats, std::string gdalFormat, RSGISLibDataType outDataType, float noDataValue, bool useNoDataValue)
+    void executeImagePixelColumnSummary(std::string inputImage, std::string outputImage, rsgis::cmds::RSGISCmdStatsSummary summaryStats, std::string gdalFormat, RSGISLibDataType outDataType, float noDataValue, bool useNoDataValue, unsigned int numThreads)
     {
         try
         {
@@ -803,11 +803,12 @@ namespace rsgis{ namespace cmds {
 
             rsgis::img::RSGISImagePixelSummaries *pxlSummary = new rsgis::img::RSGISImagePixelSummaries(numOutBands, mathSummaryStats, noDataValue, useNoDataValue);
 
-            rsgis::img::RSGISCalcImage calcImage = rsgis::img::RSGISCalcImage(pxlSummary, "", true);
+            rsgis::img::RSGISCalcImage calcImage = rsgis::img::RSGISCalcImage(pxlSummary, "", true, numThreads);
             calcImage.calcImage(&imgDataset, 1, outputImage, true, bandNames, gdalFormat, RSGIS_to_GDAL_Type(outDataType));
 
             delete[] bandNames;
             delete pxlSummary;
+            delete mathSummaryStats;
             GDALClose(imgDataset);
         }
         catch(rsgis::RSGISException &e)
@@ -1679,11 +1680,25 @@ namespace rsgis{ namespace cmds {
     std::vector<double> executeBandPercentile(std::string inputImage, float percentile, float noDataValue, bool noDataValueSpecified)
     {
         std::vector<double> outVals;
+        std::vector< std::vector<double> > bandPercentiles = executeBandPercentiles(inputImage, std::vector<float>(1, percentile), noDataValue, noDataValueSpecified);
+        for(unsigned int i = 0; i < bandPercentiles.size(); ++i)
+        {
+            outVals.push_back(bandPercentiles[i][0]);
+        }
+        return outVals;
+    }
+    
+    std::vector< std::vector<double> > executeBandPercentiles(std::string inputImage, std::vector<float> percentiles, float noDataValue, bool noDataValueSpecified)
+    {
+        std::vector< std::vector<double> > outVals;
         try
         {
-            if((percentile < 0) | (percentile > 1))
+            for(std::vector<float>::iterator iterPercentile = percentiles.begin(); iterPercentile != percentiles.end(); ++iterPercentile)
             {
-                throw RSGISException("Percentile value must be between 0 - 1.");
+                if(((*iterPercentile) < 0) | ((*iterPercentile) > 1))
+                {
+                    throw RSGISException("Percentile value must be between 0 - 1.");
+                }
             }
             
             GDALAllRegister();
@@ -1694,17 +1709,8 @@ namespace rsgis{ namespace cmds {
                 throw rsgis::RSGISImageException(message.c_str());
             }
 
-            rsgis::math::RSGISMatrices matrixUtils;
             rsgis::img::RSGISImagePercentiles calcPercentiles;
-
-            rsgis::math::Matrix *bandPercentiles = calcPercentiles.getPercentilesForAllBands(imageDataset, percentile, noDataValue, noDataValueSpecified);
-            
-            for(unsigned int i = 0; i < bandPercentiles->n; ++i)
-            {
-                outVals.push_back(bandPercentiles->matrix[i]);
-            }
-            
-            matrixUtils.freeMatrix(bandPercentiles);
+            outVals = calcPercentiles.getPercentilesForAllBands(imageDataset, percentiles, noDataValue, noDataValueSpecified);
 
             GDALClose(imageDataset);
         }
@@ -2604,7 +2610,7 @@ namespace rsgis{ namespace cmds {
         }
     }
                 
-    void executeGetImgIdxForStat(std::vector<std::string> inputImgs, std::string outputImg, std::string gdalFormat, float noDataVal, RSGISCmdsSummariseStats sumStat) 
+    void executeGetImgIdxForStat(std::vector<std::string> inputImgs, std::string outputImg, std::string gdalFormat, float noDataVal, RSGISCmdsSummariseStats sumStat, unsigned int numThreads) 
     {
         try
         {
@@ -2653,7 +2659,7 @@ namespace rsgis{ namespace cmds {
             
             
             rsgis::img::RSGISCalcImgStackIdxForStat calcImgStatIdxs = rsgis::img::RSGISCalcImgStackIdxForStat(noDataVal, sumType);
-            rsgis::img::RSGISCalcImage calcImage = rsgis::img::RSGISCalcImage(&calcImgStatIdxs, "", true);
+            rsgis::img::RSGISCalcImage calcImage = rsgis::img::RSGISCalcImage(&calcImgStatIdxs, "", true, numThreads);
             calcImage.calcImage(datasets, nImgs, outputImg, false, NULL, gdalFormat, GDT_UInt16);
             
             for(unsigned int i = 0; i < nImgs; ++i)
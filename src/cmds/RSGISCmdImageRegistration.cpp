@@ -181,7 +181,7 @@ namespace rsgis{ namespace cmds {
     void excecuteBasicRegistration(std::string inputReferenceImage, std::string inputFloatingmage, int gcpGap,
                                                   float metricThreshold, int windowSize, int searchArea, float stdDevRefThreshold,
                                                   float stdDevFloatThreshold, int subPixelResolution, unsigned int metricTypeInt,
-                                                  unsigned int outputType, std::string outputGCPFile) 
+                                                  unsigned int outputType, std::string outputGCPFile, unsigned int numThreads)
     {
         
         try
@@ -228,7 +228,7 @@ namespace rsgis{ namespace cmds {
             
             rsgis::reg::RSGISImageRegistration *regImgs = new rsgis::reg::RSGISBasicImageRegistration(inRefDataset, inFloatDataset, gcpGap, metricThreshold,
                                                                                                       windowSize, searchArea, similarityMetric, stdDevRefThreshold,
-                                                                                                      stdDevFloatThreshold, subPixelResolution);
+                                                                                                      stdDevFloatThreshold, subPixelResolution, numThreads);
             
             regImgs->runCompleteRegistration();
             
@@ -269,7 +269,7 @@ namespace rsgis{ namespace cmds {
                                                   float metricThreshold, int windowSize, int searchArea, float stdDevRefThreshold,
                                                   float stdDevFloatThreshold, int subPixelResolution, int distanceThreshold,
                                                   int maxNumIterations, float moveChangeThreshold, float pSmoothness, unsigned int metricTypeInt,
-                                                  unsigned int outputType, std::string outputGCPFile) 
+                                                  unsigned int outputType, std::string outputGCPFile, unsigned int numThreads)
     {
                 
         try
@@ -319,7 +319,7 @@ namespace rsgis{ namespace cmds {
                                                                                                                    searchArea, similarityMetric, stdDevRefThreshold,
                                                                                                                    stdDevFloatThreshold, subPixelResolution,
                                                                                                                    distanceThreshold, maxNumIterations,
-                                                                                                                   moveChangeThreshold, pSmoothness);
+                                                                                                                   moveChangeThreshold, pSmoothness, numThreads);
             
             regImgs->runCompleteRegistration();
             
@@ -357,6 +357,106 @@ namespace rsgis{ namespace cmds {
     }
 
     
+    std::vector<std::vector<float> > executeCalcTiePointSimilaritySurface(std::string inputReferenceImage, std::string inputFloatingmage,
+                                                                          double eastings, double northings, int windowSize, int searchArea,
+                                                                          unsigned int metricTypeInt)
+    {
+        std::vector<std::vector<float> > surface;
+        try
+        {
+            if((windowSize < 1) || (searchArea < 1))
+            {
+                throw rsgis::cmds::RSGISCmdException("The window size and search area must be at least 1.");
+            }
+            
+            GDALAllRegister();
+            GDALDataset *inRefDataset = nullptr;
+            GDALDataset *inFloatDataset = nullptr;
+            
+            inRefDataset = (GDALDataset *) GDALOpenShared(inputReferenceImage.c_str(), GA_ReadOnly);
+            if(inRefDataset == nullptr)
+            {
+                std::string message = std::string("Could not open image ") + inputReferenceImage;
+                throw rsgis::RSGISException(message.c_str());
+            }
+            
+            inFloatDataset = (GDALDataset *) GDALOpenShared(inputFloatingmage.c_str(), GA_ReadOnly);
+            if(inFloatDataset == nullptr)
+            {
+                GDALClose(inRefDataset);
+                std::string message = std::string("Could not open image ") + inputFloatingmage;
+                throw rsgis::RSGISException(message.c_str());
+            }
+            
+            rsgis::reg::RSGISImageSimilarityMetric *similarityMetric = nullptr;
+            if(metricTypeInt == 1) // euclidean
+            {
+                similarityMetric = new rsgis::reg::RSGISEuclideanSimilarityMetric();
+            }
+            else if(metricTypeInt == 2) // sqdiff
+            {
+                similarityMetric = new rsgis::reg::RSGISSquaredDifferenceSimilarityMetric();
+            }
+            else if(metricTypeInt == 3) // manhatten
+            {
+                similarityMetric = new rsgis::reg::RSGISManhattanSimilarityMetric();
+            }
+            else if(metricTypeInt == 4) // correlation
+            {
+                similarityMetric = new rsgis::reg::RSGISCorrelationSimilarityMetric();
+            }
+            else
+            {
+                GDALClose(inRefDataset);
+                GDALClose(inFloatDataset);
+                throw rsgis::cmds::RSGISCmdException("Metric not recognised!");
+            }
+            
+            unsigned int numSearchPoints = (searchArea*2)+1;
+            surface = std::vector<std::vector<float> >(numSearchPoints, std::vector<float>(numSearchPoints));
+            std::vector<float*> surfaceRows(numSearchPoints);
+            for(unsigned int i = 0; i < numSearchPoints; ++i)
+            {
+                surfaceRows[i] = surface[i].data();
+            }
+            
+            rsgis::reg::RSGISImageRegistration *regImgs = new rsgis::reg::RSGISBasicImageRegistration(inRefDataset, inFloatDataset, 1, 0,
+                                                                                                      windowSize, searchArea, similarityMetric, 0,
+                                                                                                      0, 1, 1);
+            try
+            {
+                regImgs->calcTiePointSimilaritySurface(eastings, northings, windowSize, searchArea, similarityMetric, surfaceRows.data());
+            }
+            catch(...)
+            {
+                delete similarityMetric;
+                delete regImgs;
+                GDALClose(inRefDataset);
+                GDALClose(inFloatDataset);
+                throw;
+            }
+            
+            delete similarityMetric;
+            delete regImgs;
+            
+            GDALClose(inRefDataset);
+            GDALClose(inFloatDataset);
+        }
+        catch(RSGISCmdException& e)
+        {
+            throw;
+        }
+        catch(RSGISException& e)
+        {
+            throw RSGISCmdException(e.what());
+        }
+        catch(std::exception& e)
+        {
+            throw RSGISCmdException(e.what());
+        }
+        return surface;
+    }
+    
     void excecuteAddGCPsGDAL(std::string inputImage, std::string inputGCPs, std::string outputImage, std::string gdalFormat, RSGISLibDataType outDataType) 
     {
         try
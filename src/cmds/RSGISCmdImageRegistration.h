@@ -57,14 +57,19 @@ namespace rsgis{ namespace cmds {
     DllExport void excecuteBasicRegistration(std::string inputReferenceImage, std::string inputFloatingmage, int gcpGap,
                                    float metricThreshold, int windowSize, int searchArea, float stdDevRefThreshold,
                                    float stdDevFloatThreshold, int subPixelResolution, unsigned int metricTypeInt,
-                                   unsigned int outputType, std::string outputGCPFile);
+                                   unsigned int outputType, std::string outputGCPFile, unsigned int numThreads=1);
     
     /** Single connected layer image registration */
     DllExport void excecuteSingleLayerConnectedRegistration(std::string inputReferenceImage, std::string inputFloatingmage, int gcpGap,
                                                   float metricThreshold, int windowSize, int searchArea, float stdDevRefThreshold,
                                                   float stdDevFloatThreshold, int subPixelResolution, int distanceThreshold,
                                                   int maxNumIterations, float moveChangeThreshold, float pSmoothness, unsigned int metricTypeInt,
-                                                  unsigned int outputType, std::string outputGCPFile);
+                                                  unsigned int outputType, std::string outputGCPFile, unsigned int numThreads=1);
+
+    /** Calculate the similarity metric surface used to locate a tie point (rows are y shifts, columns x shifts) */
+    DllExport std::vector<std::vector<float> > executeCalcTiePointSimilaritySurface(std::string inputReferenceImage, std::string inputFloatingmage,
+                                                                                    double eastings, double northings, int windowSize, int searchArea,
+                                                                                    unsigned int metricTypeInt);
 
     /** Add tie points to GCP */
     DllExport void excecuteAddGCPsGDAL(std::string inputImage, std::string inputGCPs, std::string outputImage, std::string gdalFormat, RSGISLibDataType outDataType);
@@ -864,14 +864,14 @@ namespace rsgis{ namespace cmds {
         }
     }
 
-    void executeImageMosaic(std::string *inputImages, int numDS, std::string outputImage, float background, float skipVal, unsigned int skipBand, unsigned int overlapBehaviour, std::string format, RSGISLibDataType outDataType) 
+    void executeImageMosaic(std::string *inputImages, int numDS, std::string outputImage, float background, float skipVal, unsigned int skipBand, unsigned int overlapBehaviour, std::string format, RSGISLibDataType outDataType, unsigned int numThreads)
     {
         GDALAllRegister();
         try
         {
             rsgis::img::RSGISImageMosaic mosaic;
             // Projection hardcoded to from image (to simplify interface)
-            mosaic.mosaicSkipVals(inputImages, numDS, outputImage, background, skipVal, true, "", skipBand, overlapBehaviour, format, RSGIS_to_GDAL_Type(outDataType));
+            mosaic.mosaicSkipVals(inputImages, numDS, outputImage, background, skipVal, true, "", skipBand, overlapBehaviour, format, RSGIS_to_GDAL_Type(outDataType), numThreads);
         }
         catch (RSGISImageException& e)
         {
@@ -1674,7 +1674,7 @@ namespace rsgis{ namespace cmds {
         }
     }
 
-    void executeStackStats(std::string inputImage, std::string outputImage, std::string calcStat, bool allBands, unsigned int numBands, std::string imageFormat, RSGISLibDataType outDataType) 
+    void executeStackStats(std::string inputImage, std::string outputImage, std::string calcStat, bool allBands, unsigned int numBands, std::string imageFormat, RSGISLibDataType outDataType, unsigned int numThreads) 
     {
         try
         {
@@ -1718,7 +1718,7 @@ namespace rsgis{ namespace cmds {
             else{throw RSGISCmdException("Statistic not recognized, options are: mean, min, max, range.");}
 
             rsgis::img::RSGISImageComposite *compositeImage = new rsgis::img::RSGISImageComposite(numOutputBands, numBands, outCompStat);
-            calcImage = new rsgis::img::RSGISCalcImage(compositeImage, "", true);
+            calcImage = new rsgis::img::RSGISCalcImage(compositeImage, "", true, numThreads);
             calcImage->calcImage(datasets, 1, outputImage, false, NULL, imageFormat, RSGIS_to_GDAL_Type(outDataType));
 
             // Tidy up
@@ -2346,10 +2346,27 @@ namespace rsgis{ namespace cmds {
                 ++imgIdx;
             }
             
-            rsgis::img::RSGISMaxNDVIImageComposite imgCompPxlCalc = rsgis::img::RSGISMaxNDVIImageComposite(numImgBands, redBand, nirBand, inputImages.size());
+            if((redBand == 0) || (redBand > numImgBands) || (nirBand == 0) || (nirBand > numImgBands))
+            {
+                for(int i = 0; i < inputImages.size(); ++i)
+                {
+                    GDALClose(datasets[i]);
+                }
+                delete[] datasets;
+                throw RSGISImageException("The red and NIR bands must be within the input images.");
+            }
+            
+            // Only the red and NIR bands are read to select the scene for each pixel.
+            std::vector<std::pair<unsigned int, unsigned int> > selectBands;
+            for(unsigned int i = 0; i < inputImages.size(); ++i)
+            {
+                selectBands.push_back(std::pair<unsigned int, unsigned int>(i, redBand));
+                selectBands.push_back(std::pair<unsigned int, unsigned int>(i, nirBand));
+            }
             
-            rsgis::img::RSGISCalcImage calcImg = rsgis::img::RSGISCalcImage(&imgCompPxlCalc, "", true);
-            calcImg.calcImage(datasets, inputImages.size(), outputImage, false, NULL, gdalFormat, RSGIS_to_GDAL_Type(outDataType));
+            rsgis::img::RSGISMaxNDVICompositeSelector maxNDVISelector = rsgis::img::RSGISMaxNDVICompositeSelector();
+            rsgis::img::RSGISSelectionIndexComposite createComposite = rsgis::img::RSGISSelectionIndexComposite(&maxNDVISelector, 0.0);
+            createComposite.createComposite(datasets, inputImages.size(), selectBands, 0, outputImage, gdalFormat, RSGIS_to_GDAL_Type(outDataType));
             
             // Tidy up
             for(int i = 0; i < inputImages.size(); ++i)
@@ -2429,10 +2446,12 @@ namespace rsgis{ namespace cmds {
                 ++imgIdx;
             }
             
-            rsgis::img::RSGISRefImgImageComposite imgCompPxlCalc = rsgis::img::RSGISRefImgImageComposite(numImgBands, inputImages.size(), outNoDataVal);
+            std::vector<std::pair<unsigned int, unsigned int> > selectBands;
+            selectBands.push_back(std::pair<unsigned int, unsigned int>(0, 1));
             
-            rsgis::img::RSGISCalcImage calcImg = rsgis::img::RSGISCalcImage(&imgCompPxlCalc, "", true);
-            calcImg.calcImage(datasets, 1, inputImages.size(), outputImage, false, NULL, gdalFormat, RSGIS_to_GDAL_Type(outDataType));
+            rsgis::img::RSGISRefImgCompositeSelector refImgSelector = rsgis::img::RSGISRefImgCompositeSelector(inputImages.size());
+            rsgis::img::RSGISSelectionIndexComposite createComposite = rsgis::img::RSGISSelectionIndexComposite(&refImgSelector, outNoDataVal);
+            createComposite.createComposite(datasets, totNumImgs, selectBands, 1, outputImage, gdalFormat, RSGIS_to_GDAL_Type(outDataType));
             
             // Tidy up
             for(int i = 0; i < totNumImgs; ++i)
@@ -2656,9 +2675,12 @@ namespace rsgis{ namespace cmds {
                 ++imgIdxAll;
             }
             
-            rsgis::img::RSGISTimeseriesFillImgImageComposite imgFillCompCalc = rsgis::img::RSGISTimeseriesFillImgImageComposite(compInfoVec, imgIdxLUT, totNumImgs, nBands);
-            calcImg = rsgis::img::RSGISCalcImage(&imgFillCompCalc, "", true);
-            calcImg.calcImage(datasets, 1, (imgIdx-1), outCompImg, false, NULL, gdalFormat, RSGIS_to_GDAL_Type(outDataType));
+            std::vector<std::pair<unsigned int, unsigned int> > selectBands;
+            selectBands.push_back(std::pair<unsigned int, unsigned int>(0, 1));
+            
+            rsgis::img::RSGISTimeseriesFillCompositeSelector fillSelector = rsgis::img::RSGISTimeseriesFillCompositeSelector(imgIdxLUT, totNumImgs);
+            rsgis::img::RSGISSelectionIndexComposite createComposite = rsgis::img::RSGISSelectionIndexComposite(&fillSelector, 0.0);
+            createComposite.createComposite(datasets, imgIdx, selectBands, 1, outCompImg, gdalFormat, RSGIS_to_GDAL_Type(outDataType));
             delete[] imgIdxLUT;
             // Tidy up
             for(int i = 0; i < imgIdx; ++i)
@@ -2689,7 +2711,6 @@ namespace rsgis{ namespace cmds {
             }
             
             imgIdx = imgIdx + 1;
-            imgIdxAll = 1;
             for(std::vector<rsgis::img::RSGISCompositeInfo*>::iterator iterInfo = compInfoVec.begin(); iterInfo != compInfoVec.end(); ++iterInfo)
             {
                 if((*iterInfo)->usedInComp)
@@ -2713,11 +2734,6 @@ namespace rsgis{ namespace cmds {
                     }
                     ++imgIdx;
                 }
-                else
-                {
-                    imgIdxLUT[imgIdxAll] = 0;
-                }
-                ++imgIdxAll;
             }
             
             rsgis::img::RSGISTimeseriesFillFinalRefImgImageComposite imgFillFinalRefCompCalc = rsgis::img::RSGISTimeseriesFillFinalRefImgImageComposite(compInfoVec, ratImgLst);
@@ -240,7 +240,7 @@ namespace rsgis{ namespace cmds {
         }
     }
 
-    void executePopulateRATWithStats(std::string inputImage, std::string clumpsImage, std::vector<rsgis::cmds::RSGISBandAttStatsCmds*> *bandStatsCmds, unsigned int ratBand)
+    void executePopulateRATWithStats(std::string inputImage, std::string clumpsImage, std::vector<rsgis::cmds::RSGISBandAttStatsCmds*> *bandStatsCmds, unsigned int ratBand, unsigned int numThreads)
     {
         try
         {
@@ -282,7 +282,7 @@ namespace rsgis{ namespace cmds {
             }
 
             rsgis::rastergis::RSGISPopRATWithStats clumpStats;
-            clumpStats.populateRATWithBasicStats(clumpsDataset, imageDataset, bandStats, ratBand);
+            clumpStats.populateRATWithBasicStats(clumpsDataset, imageDataset, bandStats, ratBand, numThreads);
 
             for(std::vector<rsgis::rastergis::RSGISBandAttStats*>::iterator iterBand = bandStats->begin(); iterBand != bandStats->end(); ++iterBand)
             {
@@ -582,7 +582,7 @@ namespace rsgis{ namespace cmds {
 
     }
 */
-    void executeApplyKNN(std::string inClumpsImage, unsigned int ratBand, std::string inExtrapField, std::string outExtrapField, std::string trainRegionsField, std::string applyRegionsField, bool useApplyField, std::vector<std::string> fields, unsigned int kFeatures, rsgisKNNDistCmd distKNNCmd, float distThreshold, rsgisKNNSummeriseCmd summeriseKNNCmd) 
+    void executeApplyKNN(std::string inClumpsImage, unsigned int ratBand, std::string inExtrapField, std::string outExtrapField, std::string trainRegionsField, std::string applyRegionsField, bool useApplyField, std::vector<std::string> fields, unsigned int kFeatures, rsgisKNNDistCmd distKNNCmd, float distThreshold, rsgisKNNSummeriseCmd summeriseKNNCmd, unsigned int numThreads) 
     {
         GDALAllRegister();
         GDALDataset *clumpsDataset;
@@ -654,7 +654,7 @@ namespace rsgis{ namespace cmds {
             
             std::cout << "Applying KNN\n";
             rsgis::rastergis::RSGISApplyRATKNN applyKNN;
-            applyKNN.applyKNNExtrapolation(clumpsDataset, inExtrapField, outExtrapField, trainRegionsField, applyRegionsField, useApplyField, fields, kFeatures, distKNN, distThreshold, summeriseKNN, ratBand);
+            applyKNN.applyKNNExtrapolation(clumpsDataset, inExtrapField, outExtrapField, trainRegionsField, applyRegionsField, useApplyField, fields, kFeatures, distKNN, distThreshold, summeriseKNN, ratBand, numThreads);
             std::cout << "Completed KNN\n";
             
             GDALClose(clumpsDataset);
@@ -972,7 +972,7 @@ namespace rsgis{ namespace cmds {
         }
     }
 */
-    void executeFindNeighbours(std::string inputImage, unsigned int ratBand)
+    void executeFindNeighbours(std::string inputImage, unsigned int ratBand, unsigned int numThreads)
     {
         GDALAllRegister();
         GDALDataset *inputDataset;
@@ -987,7 +987,7 @@ namespace rsgis{ namespace cmds {
             }
 
             rsgis::rastergis::RSGISFindClumpNeighbours findNeighboursObj;
-            findNeighboursObj.findNeighboursKEAImageCalc(inputDataset, ratBand);
+            findNeighboursObj.findNeighboursKEAImageCalc(inputDataset, ratBand, numThreads);
 
             GDALClose(inputDataset);
         }
@@ -199,7 +199,7 @@ namespace rsgis{ namespace cmds {
     DllExport void executeSpatialLocationExtent(std::string inputImage, unsigned int ratBand, std::string minXColX, std::string minXColY, std::string maxXColX, std::string maxXColY, std::string minYColX, std::string minYColY, std::string maxYColX, std::string maxYColY);
 
     /** Function for populating an attribute table from an image */
-    DllExport void executePopulateRATWithStats(std::string inputImage, std::string clumpsImage, std::vector<rsgis::cmds::RSGISBandAttStatsCmds*> *bandStatsCmds, unsigned int ratBand);
+    DllExport void executePopulateRATWithStats(std::string inputImage, std::string clumpsImage, std::vector<rsgis::cmds::RSGISBandAttStatsCmds*> *bandStatsCmds, unsigned int ratBand, unsigned int numThreads=1);
 
     /** Function for populating an attribute table with a percentile of the pixel values */
     DllExport void executePopulateRATWithPercentiles(std::string inputImage, std::string clumpsImage, unsigned int band, std::vector<rsgis::cmds::RSGISBandAttPercentilesCmds*> *bandPercentilesCmds, unsigned int ratBand, unsigned int numHistBins);
@@ -226,7 +226,7 @@ namespace rsgis{ namespace cmds {
     //DllExport void executeFindSpecClose(std::string inputImage, std::string distanceField, std::string spatialDistField, std::string outputField, float specDistThreshold, float distThreshold);
 
     /** Function to extrapolate values on segments using KNN, use mode for classification */
-    DllExport void executeApplyKNN(std::string inClumpsImage, unsigned int ratBand, std::string inExtrapField, std::string outExtrapField, std::string trainRegionsField, std::string applyRegionsField, bool useApplyField, std::vector<std::string> fields, unsigned int kFeatures, rsgisKNNDistCmd distKNNCmd, float distThreshold, rsgisKNNSummeriseCmd summeriseKNNCmd);
+    DllExport void executeApplyKNN(std::string inClumpsImage, unsigned int ratBand, std::string inExtrapField, std::string outExtrapField, std::string trainRegionsField, std::string applyRegionsField, bool useApplyField, std::vector<std::string> fields, unsigned int kFeatures, rsgisKNNDistCmd distKNNCmd, float distThreshold, rsgisKNNSummeriseCmd summeriseKNNCmd, unsigned int numThreads=1);
 
     /** Function to export columns from a GDAL RAT to ascii */
     DllExport void executeExport2Ascii(std::string inputImage, std::string outputFile, std::vector<std::string> fields, int ratBand=1);
@@ -259,7 +259,7 @@ namespace rsgis{ namespace cmds {
     //DllExport void executeClassMask(std::string inputImage, std::string classField, std::string className, std::string outputFile, std::string imageFormat, RSGISLibDataType dataType);
 
     /** Function to find the clump neighbours */
-    DllExport void executeFindNeighbours(std::string inputImage, unsigned int ratBand);
+    DllExport void executeFindNeighbours(std::string inputImage, unsigned int ratBand, unsigned int numThreads=1);
 
     /** Function to identify the pixels on the boundary of the clumps */
     DllExport void executeFindBoundaryPixels(std::string inputImage, unsigned int ratBand, std::string outputFile, std::string imageFormat);
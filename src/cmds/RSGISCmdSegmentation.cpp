@@ -134,7 +134,7 @@ namespace rsgis{ namespace cmds {
         }
     }
     
-    void executeClump(std::string inputImage, std::string outputImage, std::string imageFormat, bool processInMemory, bool noDataValProvided, float noDataVal, bool addRatPxlVals) 
+    void executeClump(std::string inputImage, std::string outputImage, std::string imageFormat, bool processInMemory, bool noDataValProvided, float noDataVal, bool addRatPxlVals, bool use8Conn, unsigned int numThreads) 
     {        
         try
         {
@@ -173,7 +173,7 @@ namespace rsgis{ namespace cmds {
             
             std::cout << "Performing Clump\n";
             rsgis::segment::RSGISClumpPxls clumpImg;
-            clumpImg.performClump(catagoryDataset, resultDataset, noDataValProvided, noDataVal, clumpPxlVals);
+            clumpImg.performClump(catagoryDataset, resultDataset, noDataValProvided, noDataVal, clumpPxlVals, use8Conn, numThreads);
             
             if(processInMemory)
             {
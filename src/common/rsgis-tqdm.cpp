@@ -12,12 +12,23 @@
 
 namespace rsgis {
 
+    // Progress bars may be updated from several threads (e.g., when commands are
+    // run from a Python thread pool) so each update is written as a single line
+    // while holding this lock.
+    static std::mutex rsgis_tqdm_output_mutex;
+
+    static bool rsgis_tqdm_env_set(const char *name)
+    {
+        const char *val = getenv(name);
+        return (val != NULL) && (val[0] != '\0');
+    }
+
     rsgis_tqdm::rsgis_tqdm()
     {
         this->t_first = std::chrono::system_clock::now();
         this->t_old = std::chrono::system_clock::now();
-        this->in_screen = (system("test $STY") == 0);
-        this->in_tmux = (system("test $TMUX") == 0);
+        this->in_screen = rsgis_tqdm_env_set("STY");
+        this->in_tmux = rsgis_tqdm_env_set("TMUX");
         this->is_tty = isatty(1);
         this->bars = {" ", "▏", "▎", "▍", "▌", "▋", "▊", "▉", "█"};
         if (in_screen)
@@ -89,6 +100,7 @@ namespace rsgis {
     void rsgis_tqdm::finish()
     {
         this->progress(total_,total_);
+        std::lock_guard<std::mutex> lock(rsgis_tqdm_output_mutex);
         printf("\n");
         fflush(stdout);
     }
@@ -147,7 +159,9 @@ namespace rsgis {
             double fills = ((double)curr / tot * width);
             int ifills = (int)fills;
 
-            printf("\015 ");
+            // Build the whole line so it is written in one go.
+            std::string line = "\015 ";
+            char buf[256];
             if (use_colors)
             {
                 if (color_transition)
@@ -155,20 +169,22 @@ namespace rsgis {
                     // red (hue=0) to green (hue=1/3)
                     int r = 255, g = 255, b = 255;
                     hsv_to_rgb(0.0+0.01*pct/3,0.65,1.0, r,g,b);
-                    printf("\033[38;2;%d;%d;%dm ", r, g, b);
+                    snprintf(buf, sizeof(buf), "\033[38;2;%d;%d;%dm ", r, g, b);
+                    line += buf;
                 }
                 else
                 {
-                    printf("\033[32m ");
+                    line += "\033[32m ";
                 }
             }
-            for (int i = 0; i < ifills; i++) std::cout << bars[8];
-            if (!in_screen && (curr != tot)) printf("%s",bars[(int)(8.0*(fills-ifills))]);
-            for (int i = 0; i < width-ifills-1; i++) std::cout << bars[0];
-            printf("%s ", right_pad.c_str());
-            if (use_colors) printf("\033[1m\033[31m");
-            printf("%4.1f%% ", pct);
-            if (use_colors) printf("\033[34m");
+            for (int i = 0; i < ifills; i++) line += bars[8];
+            if (!in_screen && (curr != tot)) line += bars[(int)(8.0*(fills-ifills))];
+            for (int i = 0; i < width-ifills-1; i++) line += bars[0];
+            line += right_pad + " ";
+            if (use_colors) line += "\033[1m\033[31m";
+            snprintf(buf, sizeof(buf), "%4.1f%% ", pct);
+            line += buf;
+            if (use_colors) line += "\033[34m";
 
             std::string unit = "Hz";
             double div = 1.;
@@ -180,10 +196,13 @@ namespace rsgis {
             {
                 unit = "kHz"; div = 1.0e3;
             }
-            printf("[%4d/%4d | %3.1f %s | %.0fs<%.0fs] ", curr,tot,  avgrate/div, unit.c_str(), dt_tot, peta);
-            printf("%s ", label.c_str());
-            if (use_colors) printf("\033[0m\033[32m\033[0m\015 ");
+            snprintf(buf, sizeof(buf), "[%4d/%4d | %3.1f %s | %.0fs<%.0fs] ", curr,tot,  avgrate/div, unit.c_str(), dt_tot, peta);
+            line += buf;
+            line += label + " ";
+            if (use_colors) line += "\033[0m\033[32m\033[0m\015 ";
 
+            std::lock_guard<std::mutex> lock(rsgis_tqdm_output_mutex);
+            fwrite(line.data(), 1, line.size(), stdout);
             if( ( tot - curr ) > period ) fflush(stdout);
 
         }
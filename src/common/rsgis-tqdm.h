@@ -31,6 +31,8 @@
 #include <vector>
 #include <cmath>
 #include <algorithm>
+#include <mutex>
+#include <cstdio>
 #ifdef __linux__
     #include <sys/ioctl.h>
 #endif
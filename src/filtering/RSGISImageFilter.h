@@ -59,7 +59,7 @@ namespace rsgis{namespace filter{
 		{
 		public: 
 			RSGISImageFilter(int numberOutBands, int size, std::string filenameEnding);
-			void runFilter(GDALDataset **datasets, int numDS, std::string outputImage, std::string gdalFormat, GDALDataType outDataType);
+			virtual void runFilter(GDALDataset **datasets, int numDS, std::string outputImage, std::string gdalFormat, GDALDataType outDataType);
 			virtual rsgis::img::RSGISCalcImage* getCalcImage();
 			virtual void calcImageValue(float ***dataBlock, int numBands, int winSize, double *output)  = 0;
 			virtual bool calcImageValueCondition(float ***dataBlock, int numBands, int winSize, double *output)  = 0;
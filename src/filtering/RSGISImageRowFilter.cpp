@@ -0,0 +1,344 @@
+/*
+ *  RSGISImageRowFilter.cpp
+ *  RSGIS_LIB
+ *
+ *  Created by Pete Bunting on 17/10/2026.
+ *  Copyright 2026 RSGISLib.
+ *
+ *  RSGISLib is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  RSGISLib is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with RSGISLib.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "RSGISImageRowFilter.h"
+
+namespace rsgis
+{
+    namespace filter
+    {
+        RSGISImageRowFilter::RSGISImageRowFilter(
+            int numberOutBands, int size, std::string filenameEnding
+        ) : RSGISImageFilter(numberOutBands, size, filenameEnding)
+        {}
+
+        void RSGISImageRowFilter::runFilter(
+            GDALDataset **datasets, int numDS, std::string outputImage,
+            std::string gdalFormat, GDALDataType outDataType
+        )
+        {
+            GDALAllRegister();
+            rsgis::img::RSGISImageUtils imgUtils;
+            double *gdalTranslation = new double[6];
+            int **dsOffsets = new int *[numDS];
+            for (int i = 0; i < numDS; i++)
+            {
+                dsOffsets[i] = new int[2];
+            }
+            int **bandOffsets = NULL;
+            int width = 0;
+            int height = 0;
+            int numInBands = 0;
+            int xBlockSize = 0;
+            int yBlockSize = 0;
+
+            float ***rowBuffer = NULL;
+            float **winRows = NULL;
+            double *outputRow = NULL;
+
+            GDALDataset *outputImageDS = NULL;
+            GDALRasterBand **inputRasterBands = NULL;
+            GDALRasterBand **outputRasterBands = NULL;
+
+            try
+            {
+                if (this->size % 2 == 0)
+                {
+                    throw rsgis::img::RSGISImageCalcException(
+                        "Window size needs to be an odd number (min = 3)."
+                    );
+                }
+                else if (this->size < 3)
+                {
+                    throw rsgis::img::RSGISImageCalcException(
+                        "Window size needs to be 3 or greater and an odd number."
+                    );
+                }
+                int windowMid = this->size / 2;
+                int paddedWidth = 0;
+
+                imgUtils.getImageOverlap(
+                    datasets, numDS, dsOffsets, &width, &height, gdalTranslation,
+                    &xBlockSize, &yBlockSize
+                );
+                paddedWidth = width + (this->size - 1);
+
+                for (int i = 0; i < numDS; i++)
+                {
+                    numInBands += datasets[i]->GetRasterCount();
+                }
+
+                if (this->numOutBands != numInBands)
+                {
+                    throw rsgis::img::RSGISImageCalcException(
+                        "The number of output bands must match the number of input bands."
+                    );
+                }
+
+                GDALDriver *gdalDriver = GetGDALDriverManager()->GetDriverByName(
+                    gdalFormat.c_str()
+                );
+                if (gdalDriver == NULL)
+                {
+                    throw rsgis::RSGISImageException("Driver does not exists..");
+                }
+                char **papszOptions = imgUtils.getGDALCreationOptionsForFormat(gdalFormat);
+                outputImageDS = gdalDriver->Create(
+                    outputImage.c_str(), width, height, this->numOutBands, outDataType,
+                    papszOptions
+                );
+                if (outputImageDS == NULL)
+                {
+                    throw rsgis::RSGISImageException(
+                        "Output image could not be created. Check filepath."
+                    );
+                }
+                outputImageDS->SetGeoTransform(gdalTranslation);
+                outputImageDS->SetProjection(datasets[0]->GetProjectionRef());
+
+                bandOffsets = new int *[numInBands];
+                inputRasterBands = new GDALRasterBand *[numInBands];
+                int counter = 0;
+                for (int i = 0; i < numDS; i++)
+                {
+                    for (int j = 0; j < datasets[i]->GetRasterCount(); j++)
+                    {
+                        inputRasterBands[counter] = datasets[i]->GetRasterBand(j + 1);
+                        bandOffsets[counter] = new int[2];
+                        bandOffsets[counter][0] = dsOffsets[i][0];
+                        bandOffsets[counter][1] = dsOffsets[i][1];
+                        counter++;
+                    }
+                }
+
+                outputRasterBands = new GDALRasterBand *[this->numOutBands];
+                for (int i = 0; i < this->numOutBands; i++)
+                {
+                    outputRasterBands[i] = outputImageDS->GetRasterBand(i + 1);
+                }
+
+                // Ring buffer of window rows for each band; the padding columns
+                // are zeroed once here and never written to again.
+                rowBuffer = new float **[numInBands];
+                for (int n = 0; n < numInBands; n++)
+                {
+                    rowBuffer[n] = new float *[this->size];
+                    for (int j = 0; j < this->size; j++)
+                    {
+                        rowBuffer[n][j] = new float[paddedWidth];
+                        for (int k = 0; k < paddedWidth; k++)
+                        {
+                            rowBuffer[n][j][k] = 0;
+                        }
+                    }
+                }
+                winRows = new float *[this->size];
+                outputRow = new double[width];
+                this->initRowFilter(numInBands, width);
+
+                // Fill the rows above the centre row of the first output row.
+                for (int r = -windowMid; r < windowMid; r++)
+                {
+                    int slot = (r + this->size) % this->size;
+                    for (int n = 0; n < numInBands; n++)
+                    {
+                        if (r >= 0 && r < height)
+                        {
+                            inputRasterBands[n]->RasterIO(
+                                GF_Read, bandOffsets[n][0], bandOffsets[n][1] + r, width, 1,
+                                &rowBuffer[n][slot][windowMid], width, 1, GDT_Float32, 0, 0
+                            );
+                        }
+                        else
+                        {
+                            for (int k = 0; k < width; k++)
+                            {
+                                rowBuffer[n][slot][windowMid + k] = 0;
+                            }
+                        }
+                    }
+                }
+
+                rsgis_tqdm pbar;
+                for (int y = 0; y < height; y++)
+                {
+                    // Read the bottom row of the window into the slot freed by
+                    // the row which has just left the top of the window.
+                    int r = y + windowMid;
+                    int slot = r % this->size;
+                    for (int n = 0; n < numInBands; n++)
+                    {
+                        if (r < height)
+                        {
+                            inputRasterBands[n]->RasterIO(
+                                GF_Read, bandOffsets[n][0], bandOffsets[n][1] + r, width, 1,
+                                &rowBuffer[n][slot][windowMid], width, 1, GDT_Float32, 0, 0
+                            );
+                        }
+                        else
+                        {
+                            for (int k = 0; k < width; k++)
+                            {
+                                rowBuffer[n][slot][windowMid + k] = 0;
+                            }
+                        }
+                    }
+
+                    for (int n = 0; n < numInBands; n++)
+                    {
+                        for (int j = 0; j < this->size; j++)
+                        {
+                            winRows[j] = rowBuffer[n][(y - windowMid + j + this->size) % this->size];
+                        }
+                        this->calcRowValues(winRows, width, n, outputRow);
+                        outputRasterBands[n]->RasterIO(
+                            GF_Write, 0, y, width, 1, outputRow, width, 1, GDT_Float64, 0, 0
+                        );
+                    }
+                    pbar.progress(y, height);
+                }
+                pbar.finish();
+            }
+            catch (rsgis::RSGISException &e)
+            {
+                if (outputImageDS != NULL)
+                {
+                    GDALClose(outputImageDS);
+                    outputImageDS = NULL;
+                }
+                if (rowBuffer != NULL)
+                {
+                    for (int n = 0; n < numInBands; n++)
+                    {
+                        for (int j = 0; j < this->size; j++)
+                        {
+                            delete[] rowBuffer[n][j];
+                        }
+                        delete[] rowBuffer[n];
+                    }
+                    delete[] rowBuffer;
+                    rowBuffer = NULL;
+                }
+                if (winRows != NULL)
+                {
+                    delete[] winRows;
+                    winRows = NULL;
+                }
+                if (outputRow != NULL)
+                {
+                    delete[] outputRow;
+                    outputRow = NULL;
+                }
+                if (bandOffsets != NULL)
+                {
+                    for (int i = 0; i < numInBands; i++)
+                    {
+                        delete[] bandOffsets[i];
+                    }
+                    delete[] bandOffsets;
+                    bandOffsets = NULL;
+                }
+                for (int i = 0; i < numDS; i++)
+                {
+                    delete[] dsOffsets[i];
+                }
+                delete[] dsOffsets;
+                delete[] gdalTranslation;
+                if (inputRasterBands != NULL)
+                {
+                    delete[] inputRasterBands;
+                }
+                if (outputRasterBands != NULL)
+                {
+                    delete[] outputRasterBands;
+                }
+                throw;
+            }
+
+            GDALClose(outputImageDS);
+            for (int n = 0; n < numInBands; n++)
+            {
+                for (int j = 0; j < this->size; j++)
+                {
+                    delete[] rowBuffer[n][j];
+                }
+                delete[] rowBuffer[n];
+            }
+            delete[] rowBuffer;
+            delete[] winRows;
+            delete[] outputRow;
+            for (int i = 0; i < numInBands; i++)
+            {
+                delete[] bandOffsets[i];
+            }
+            delete[] bandOffsets;
+            for (int i = 0; i < numDS; i++)
+            {
+                delete[] dsOffsets[i];
+            }
+            delete[] dsOffsets;
+            delete[] gdalTranslation;
+            delete[] inputRasterBands;
+            delete[] outputRasterBands;
+        }
+
+        void RSGISImageRowFilter::rankWindowRows(
+            float **winRows, int width, bool useNoDataVal, float noDataVal,
+            std::vector<float> *vals, std::vector<int> *ranks
+        )
+        {
+            size_t paddedWidth = width + (this->size - 1);
+            vals->clear();
+            ranks->assign(paddedWidth * this->size, -1);
+            for (int j = 0; j < this->size; j++)
+            {
+                for (size_t k = 0; k < paddedWidth; k++)
+                {
+                    float val = winRows[j][k];
+                    if (!(std::isnan(val) || (useNoDataVal && (val == noDataVal))))
+                    {
+                        vals->push_back(val);
+                    }
+                }
+            }
+            std::sort(vals->begin(), vals->end());
+            vals->erase(std::unique(vals->begin(), vals->end()), vals->end());
+
+            for (int j = 0; j < this->size; j++)
+            {
+                for (size_t k = 0; k < paddedWidth; k++)
+                {
+                    float val = winRows[j][k];
+                    if (!(std::isnan(val) || (useNoDataVal && (val == noDataVal))))
+                    {
+                        (*ranks)[(j * paddedWidth) + k] = std::lower_bound(
+                            vals->begin(), vals->end(), val
+                        ) - vals->begin();
+                    }
+                }
+            }
+        }
+
+        RSGISImageRowFilter::~RSGISImageRowFilter()
+        {}
+    }
+}
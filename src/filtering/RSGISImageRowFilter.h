@@ -0,0 +1,111 @@
+/*
+ *  RSGISImageRowFilter.h
+ *  RSGIS_LIB
+ *
+ *  Created by Pete Bunting on 17/10/2026.
+ *  Copyright 2026 RSGISLib.
+ *
+ *  RSGISLib is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  RSGISLib is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with RSGISLib.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef RSGISImageRowFilter_H
+#define RSGISImageRowFilter_H
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <cmath>
+
+#include "gdal_priv.h"
+
+#include "common/RSGISImageException.h"
+#include "common/rsgis-tqdm.h"
+
+#include "filtering/RSGISImageFilterException.h"
+#include "filtering/RSGISImageFilter.h"
+#include "img/RSGISImageCalcException.h"
+#include "img/RSGISImageUtils.h"
+
+// mark all exported classes/functions with DllExport to have
+// them exported by Visual Studio
+#undef DllExport
+#ifdef _MSC_VER
+    #ifdef rsgis_filter_EXPORTS
+        #define DllExport   __declspec( dllexport )
+    #else
+        #define DllExport   __declspec( dllimport )
+    #endif
+#else
+    #define DllExport
+#endif
+
+namespace rsgis
+{
+    namespace filter
+    {
+        /**
+         * A base class for window filters which process a whole output row of a
+         * band at once rather than one window at a time. The input is held as a
+         * ring buffer of 'size' rows per band, each padded with (size-1)/2 zeros
+         * either side (matching RSGISCalcImage::calcImageWindowData), so a filter
+         * can update its state incrementally as the window slides along the row.
+         *
+         * Each output band is computed from the matching input band, so the
+         * number of output bands must equal the number of input bands.
+         */
+        class DllExport RSGISImageRowFilter : public RSGISImageFilter
+        {
+        public:
+            RSGISImageRowFilter(int numberOutBands, int size, std::string filenameEnding);
+
+            virtual void runFilter(
+                GDALDataset **datasets, int numDS, std::string outputImage,
+                std::string gdalFormat, GDALDataType outDataType
+            );
+
+            /**
+             * Calculate an output row for a band. winRows[j] is window row j
+             * (top to bottom) and the window for output pixel x covers columns
+             * x to x+size-1 of each window row.
+             */
+            virtual void calcRowValues(
+                float **winRows, int width, int band, double *output
+            ) = 0;
+
+            /**
+             * Called by runFilter before the first row is processed so filters
+             * which keep state between rows can (re)initialise it.
+             */
+            virtual void initRowFilter(int numBands, int width)
+            {};
+
+            virtual ~RSGISImageRowFilter();
+
+        protected:
+            /**
+             * Ranks the values of the window rows. On return vals holds the sorted
+             * unique valid values and ranks[(j*paddedWidth)+k] holds the index
+             * within vals of winRows[j][k] or -1 if the value is no data or NaN.
+             */
+            void rankWindowRows(
+                float **winRows, int width, bool useNoDataVal, float noDataVal,
+                std::vector<float> *vals, std::vector<int> *ranks
+            );
+        };
+    }
+}
+
+#endif
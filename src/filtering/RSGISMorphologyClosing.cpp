@@ -34,55 +34,9 @@ namespace rsgis{namespace filter{
     {
         try 
         {
-            if(matrixOperator->n != matrixOperator->m)
-            {
-                throw rsgis::img::RSGISImageCalcException("Morphological operator must be a square matrix.");
-            }
-            
-            rsgis::img::RSGISImageUtils imgUtils;
-            GDALDataset *outDataset = NULL;
-            GDALDataset *tmpDataset = NULL;
-            GDALDataset **tmpGDALDataArray = new GDALDataset*[1];
-            
-            outDataset = imgUtils.createCopy(dataset, outputImage, format, outDataType);
-            imgUtils.zerosFloatGDALDataset(outDataset);
-            
-            if(useMemory)
-            {
-                tmpDataset = imgUtils.createCopy(dataset, tempImage, "MEM", outDataType);
-            }
-            else
-            {
-                tmpDataset = imgUtils.createCopy(dataset, tempImage, format, outDataType);
-            }
-            imgUtils.zerosFloatGDALDataset(tmpDataset);
-            
-            
-            rsgis::img::RSGISCalcImageValue *imgErode = new RSGISMorphologyErode(dataset->GetRasterCount(), matrixOperator);
-            rsgis::img::RSGISCalcImage calcImageErode(imgErode);
-            rsgis::img::RSGISCalcImageValue *imgDilate = new RSGISMorphologyDilate(dataset->GetRasterCount(), matrixOperator);
-            rsgis::img::RSGISCalcImage calcImageDilate(imgDilate);
-            
-            tmpGDALDataArray[0] = dataset;
-            for(unsigned int i = 0; i < numIterations; ++i)
-            {
-                if(i > 0)
-                {
-                    tmpGDALDataArray[0] = outDataset;
-                }
-                
-                calcImageDilate.calcImageWindowData(tmpGDALDataArray, 1, tmpDataset, matrixOperator->n);
-                tmpGDALDataArray[0] = tmpDataset;
-                calcImageErode.calcImageWindowData(tmpGDALDataArray, 1, outDataset, matrixOperator->n);
-            }
-            
-            delete imgErode;
-            delete imgDilate;
-            
-            delete[] tmpGDALDataArray;
-            
-            GDALClose(outDataset);
-            GDALClose(tmpDataset);
+            // The operation is applied in memory so the temporary image is no longer used.
+            RSGISMorphologyVHGW morphObj(matrixOperator);
+            morphObj.applyToImage(dataset, outputImage, rsgis_morph_closing, numIterations, false, format, outDataType);
         } 
         catch (rsgis::img::RSGISImageCalcException &e) 
         {
@@ -31,51 +31,14 @@ namespace rsgis{namespace filter{
 
 	void RSGISImageMorphologyDilate::dilateImage(GDALDataset **datasets, std::string outputImage,rsgis::math::Matrix *matrixOperator, std::string format, GDALDataType outDataType)
 	{
-        if(matrixOperator->n != matrixOperator->m)
-        {
-            throw rsgis::img::RSGISImageCalcException("Morphological operator must be a square matrix.");
-        }
-        
-		int numBands = datasets[0]->GetRasterCount();
-		RSGISMorphologyDilate *dilateImage = new RSGISMorphologyDilate(numBands, matrixOperator);
-		rsgis::img::RSGISCalcImage calcImg = rsgis::img::RSGISCalcImage(dilateImage, "", true);
-        try
-        {
-            calcImg.calcImageWindowData(datasets, 1, outputImage, matrixOperator->n, format, outDataType);
-        }
-        catch(rsgis::img::RSGISImageCalcException &e)
-        {
-            throw e;
-        }
-        catch(rsgis::img::RSGISImageBandException &e)
-        {
-            throw e;
-        }
-        delete dilateImage;
+        RSGISMorphologyVHGW morphObj(matrixOperator);
+        morphObj.applyToImage(datasets[0], outputImage, rsgis_morph_dilate, 1, false, format, outDataType);
 	}
     
     void RSGISImageMorphologyDilate::dilateImageAll(GDALDataset **datasets, std::string outputImage,rsgis::math::Matrix*matrixOperator, std::string format, GDALDataType outDataType)
 	{
-        if(matrixOperator->n != matrixOperator->m)
-        {
-            throw rsgis::img::RSGISImageCalcException("Morphological operator must be a square matrix.");
-        }
-        
-		RSGISMorphologyDilateAll *dilateImage = new RSGISMorphologyDilateAll(1, matrixOperator);
-		rsgis::img::RSGISCalcImage calcImg = rsgis::img::RSGISCalcImage(dilateImage, "", true);
-        try
-        {
-            calcImg.calcImageWindowData(datasets, 1, outputImage, matrixOperator->n, format, outDataType);
-        }
-        catch(rsgis::img::RSGISImageCalcException &e)
-        {
-            throw e;
-        }
-        catch(rsgis::img::RSGISImageBandException &e)
-        {
-            throw e;
-        }
-        delete dilateImage;
+        RSGISMorphologyVHGW morphObj(matrixOperator);
+        morphObj.applyToImage(datasets[0], outputImage, rsgis_morph_dilate, 1, true, format, outDataType);
 	}
 
 	RSGISMorphologyDilate::RSGISMorphologyDilate(int numberOutBands,rsgis::math::Matrix*matrixOperator) : rsgis::img::RSGISCalcImageValue(numberOutBands)
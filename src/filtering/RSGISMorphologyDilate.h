@@ -33,6 +33,8 @@
 
 #include "math/RSGISMatrices.h"
 
+#include "filtering/RSGISMorphologyVHGW.h"
+
 // mark all exported classes/functions with DllExport to have
 // them exported by Visual Studio
 #undef DllExport
@@ -31,51 +31,14 @@ namespace rsgis{namespace filter{
 
 	void RSGISImageMorphologyErode::erodeImage(GDALDataset **datasets, std::string outputImage, rsgis::math::Matrix *matrixOperator, std::string format, GDALDataType outDataType)
 	{
-        if(matrixOperator->n != matrixOperator->m)
-        {
-            throw rsgis::img::RSGISImageCalcException("Morphological operator must be a square matrix.");
-        }
-        
-		int numBands = datasets[0]->GetRasterCount();
-		RSGISMorphologyErode *erodeImage = new RSGISMorphologyErode(numBands, matrixOperator);
-		rsgis::img::RSGISCalcImage calcImg = rsgis::img::RSGISCalcImage(erodeImage, "", true);
-        try 
-        {
-            calcImg.calcImageWindowData(datasets, 1, outputImage, matrixOperator->n, format, outDataType);
-        }
-        catch(rsgis::img::RSGISImageCalcException &e)
-        {
-            throw e;
-        }
-        catch(rsgis::img::RSGISImageBandException &e)
-        {
-            throw e;
-        }
-        delete erodeImage;
+        RSGISMorphologyVHGW morphObj(matrixOperator);
+        morphObj.applyToImage(datasets[0], outputImage, rsgis_morph_erode, 1, false, format, outDataType);
 	}
     
     void RSGISImageMorphologyErode::erodeImageAll(GDALDataset **datasets, std::string outputImage, rsgis::math::Matrix *matrixOperator, std::string format, GDALDataType outDataType)
 	{
-        if(matrixOperator->n != matrixOperator->m)
-        {
-            throw rsgis::img::RSGISImageCalcException("Morphological operator must be a square matrix.");
-        }
-        
-		RSGISMorphologyErodeAll *erodeImage = new RSGISMorphologyErodeAll(1, matrixOperator);
-		rsgis::img::RSGISCalcImage calcImg = rsgis::img::RSGISCalcImage(erodeImage, "", true);
-        try 
-        {
-            calcImg.calcImageWindowData(datasets, 1, outputImage, matrixOperator->n, format, outDataType);
-        }
-        catch(rsgis::img::RSGISImageCalcException &e)
-        {
-            throw e;
-        }
-        catch(rsgis::img::RSGISImageBandException &e)
-        {
-            throw e;
-        }
-        delete erodeImage;
+        RSGISMorphologyVHGW morphObj(matrixOperator);
+        morphObj.applyToImage(datasets[0], outputImage, rsgis_morph_erode, 1, true, format, outDataType);
 	}
 
 	RSGISMorphologyErode::RSGISMorphologyErode(int numberOutBands, rsgis::math::Matrix *matrixOperator) : rsgis::img::RSGISCalcImageValue(numberOutBands)
@@ -31,51 +31,14 @@ namespace rsgis{namespace filter{
     
 	void RSGISImageMorphologyGradient::calcGradientImage(GDALDataset **datasets, std::string outputImage, rsgis::math::Matrix *matrixOperator, std::string format, GDALDataType outDataType)
 	{
-        if(matrixOperator->n != matrixOperator->m)
-        {
-            throw rsgis::img::RSGISImageCalcException("Morphological operator must be a square matrix.");
-        }
-        
-		int numBands = datasets[0]->GetRasterCount();
-		RSGISMorphologyGradient *gradImage = new RSGISMorphologyGradient(numBands, matrixOperator);
-		rsgis::img::RSGISCalcImage calcImg = rsgis::img::RSGISCalcImage(gradImage, "", true); // creates the calc that we are going to do
-        try
-        {
-            calcImg.calcImageWindowData(datasets, 1, outputImage, matrixOperator->n, format, outDataType);
-        }
-        catch(rsgis::img::RSGISImageCalcException &e)
-        {
-            throw e;
-        }
-        catch(rsgis::img::RSGISImageBandException &e)
-        {
-            throw e;
-        }
-        delete gradImage;
+        RSGISMorphologyVHGW morphObj(matrixOperator);
+        morphObj.applyToImage(datasets[0], outputImage, rsgis_morph_gradient, 1, false, format, outDataType);
 	}
     
     void RSGISImageMorphologyGradient::calcGradientImageAll(GDALDataset **datasets, std::string outputImage, rsgis::math::Matrix *matrixOperator, std::string format, GDALDataType outDataType)
 	{
-        if(matrixOperator->n != matrixOperator->m)
-        {
-            throw rsgis::img::RSGISImageCalcException("Morphological operator must be a square matrix.");
-        }
-        
-		RSGISMorphologyGradientAll *gradImage = new RSGISMorphologyGradientAll(1, matrixOperator);
-		rsgis::img::RSGISCalcImage calcImg = rsgis::img::RSGISCalcImage(gradImage, "", true);
-        try
-        {
-            calcImg.calcImageWindowData(datasets, 1, outputImage, matrixOperator->n, format, outDataType);
-        }
-        catch(rsgis::img::RSGISImageCalcException &e)
-        {
-            throw e;
-        }
-        catch(rsgis::img::RSGISImageBandException &e)
-        {
-            throw e;
-        }
-        delete gradImage;
+        RSGISMorphologyVHGW morphObj(matrixOperator);
+        morphObj.applyToImage(datasets[0], outputImage, rsgis_morph_gradient, 1, true, format, outDataType);
 	}
     
 	RSGISMorphologyGradient::RSGISMorphologyGradient(int numberOutBands, rsgis::math::Matrix *matrixOperator) : rsgis::img::RSGISCalcImageValue(numberOutBands)
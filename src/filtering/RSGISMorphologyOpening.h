@@ -34,6 +34,7 @@
 
 #include "filtering/RSGISMorphologyErode.h"
 #include "filtering/RSGISMorphologyDilate.h"
+#include "filtering/RSGISMorphologyVHGW.h"
 
 #include "math/RSGISMatrices.h"
 
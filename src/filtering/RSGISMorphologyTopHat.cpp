@@ -33,55 +33,9 @@ namespace rsgis{namespace filter{
     {
         try 
         {
-            if(matrixOperator->n != matrixOperator->m)
-            {
-                throw rsgis::img::RSGISImageCalcException("Morphological operator must be a square matrix.");
-            }
-            
-            rsgis::img::RSGISImageUtils imgUtils;
-            GDALDataset *outDataset = nullptr;
-            GDALDataset *tmpDataset = nullptr;
-            GDALDataset **tmpGDALDataArray = new GDALDataset*[2];
-            
-            outDataset = imgUtils.createCopy(dataset, outputImage, format, outDataType);
-            imgUtils.zerosFloatGDALDataset(outDataset);
-            
-            if(useMemory)
-            {
-                tmpDataset = imgUtils.createCopy(dataset, tempImage, "MEM", outDataType);
-            }
-            else
-            {
-                tmpDataset = imgUtils.createCopy(dataset, tempImage, format, outDataType);
-            }
-            imgUtils.zerosFloatGDALDataset(tmpDataset);
-            
-            
-            rsgis::img::RSGISCalcImageValue *imgErode = new RSGISMorphologyErode(dataset->GetRasterCount(), matrixOperator);
-            rsgis::img::RSGISCalcImage calcImageErode(imgErode);
-            rsgis::img::RSGISCalcImageValue *imgDilate = new RSGISMorphologyDilate(dataset->GetRasterCount(), matrixOperator);
-            rsgis::img::RSGISCalcImage calcImageDilate(imgDilate);
-            rsgis::img::RSGISCalcImageValue *imgDiff = new RSGISMorphologyImageDiff(dataset->GetRasterCount());
-            rsgis::img::RSGISCalcImage calcImageDiff(imgDiff);
-            
-            tmpGDALDataArray[0] = dataset;
-            calcImageDilate.calcImageWindowData(tmpGDALDataArray, 1, outDataset, matrixOperator->n);
-            tmpGDALDataArray[0] = outDataset;
-            calcImageErode.calcImageWindowData(tmpGDALDataArray, 1, tmpDataset, matrixOperator->n);
-            
-            // tmp - input
-            tmpGDALDataArray[0] = tmpDataset;
-            tmpGDALDataArray[1] = dataset;
-            calcImageDiff.calcImage(tmpGDALDataArray, 2, outDataset);
-            
-            delete imgErode;
-            delete imgDilate;
-            delete imgDiff;
-            
-            delete[] tmpGDALDataArray;
-            
-            GDALClose(outDataset);
-            GDALClose(tmpDataset);
+            // The operation is applied in memory so the temporary image is no longer used.
+            RSGISMorphologyVHGW morphObj(matrixOperator);
+            morphObj.applyToImage(dataset, outputImage, rsgis_morph_blacktophat, 1, false, format, outDataType);
         } 
         catch (rsgis::img::RSGISImageCalcException &e) 
         {
@@ -102,55 +56,9 @@ namespace rsgis{namespace filter{
     {
         try 
         {
-            if(matrixOperator->n != matrixOperator->m)
-            {
-                throw rsgis::img::RSGISImageCalcException("Morphological operator must be a square matrix.");
-            }
-            
-            rsgis::img::RSGISImageUtils imgUtils;
-            GDALDataset *outDataset = NULL;
-            GDALDataset *tmpDataset = NULL;
-            GDALDataset **tmpGDALDataArray = new GDALDataset*[2];
-            
-            outDataset = imgUtils.createCopy(dataset, outputImage, format, outDataType);
-            imgUtils.zerosFloatGDALDataset(outDataset);
-            
-            if(useMemory)
-            {
-                tmpDataset = imgUtils.createCopy(dataset, tempImage, "MEM", outDataType);
-            }
-            else
-            {
-                tmpDataset = imgUtils.createCopy(dataset, tempImage, format, outDataType);
-            }
-            imgUtils.zerosFloatGDALDataset(tmpDataset);
-            
-            
-            rsgis::img::RSGISCalcImageValue *imgErode = new RSGISMorphologyErode(dataset->GetRasterCount(), matrixOperator);
-            rsgis::img::RSGISCalcImage calcImageErode(imgErode);
-            rsgis::img::RSGISCalcImageValue *imgDilate = new RSGISMorphologyDilate(dataset->GetRasterCount(), matrixOperator);
-            rsgis::img::RSGISCalcImage calcImageDilate(imgDilate);
-            rsgis::img::RSGISCalcImageValue *imgDiff = new RSGISMorphologyImageDiff(dataset->GetRasterCount());
-            rsgis::img::RSGISCalcImage calcImageDiff(imgDiff);
-            
-            tmpGDALDataArray[0] = dataset;
-            calcImageErode.calcImageWindowData(tmpGDALDataArray, 1, outDataset, matrixOperator->n);
-            tmpGDALDataArray[0] = outDataset;
-            calcImageDilate.calcImageWindowData(tmpGDALDataArray, 1, tmpDataset, matrixOperator->n);
-            
-            // input - tmp
-            tmpGDALDataArray[0] = dataset;
-            tmpGDALDataArray[1] = tmpDataset;
-            calcImageDiff.calcImage(tmpGDALDataArray, 2, outDataset);
-            
-            delete imgErode;
-            delete imgDilate;
-            delete imgDiff;
-            
-            delete[] tmpGDALDataArray;
-            
-            GDALClose(outDataset);
-            GDALClose(tmpDataset);
+            // The operation is applied in memory so the temporary image is no longer used.
+            RSGISMorphologyVHGW morphObj(matrixOperator);
+            morphObj.applyToImage(dataset, outputImage, rsgis_morph_whitetophat, 1, false, format, outDataType);
         } 
         catch (rsgis::img::RSGISImageCalcException &e) 
         {
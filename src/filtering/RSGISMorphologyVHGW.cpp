@@ -0,0 +1,461 @@
+/*
+ *  RSGISMorphologyVHGW.cpp
+ *  RSGIS_LIB
+ *
+ *  Created by Pete Bunting on 17/10/2026.
+ *  Copyright 2026 RSGISLib.
+ *
+ *  RSGISLib is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  RSGISLib is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with RSGISLib.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "RSGISMorphologyVHGW.h"
+
+namespace rsgis{namespace filter{
+
+    RSGISMorphologyVHGW::RSGISMorphologyVHGW(rsgis::math::Matrix *matrixOperator)
+    {
+        if(matrixOperator->n != matrixOperator->m)
+        {
+            throw rsgis::img::RSGISImageCalcException("Morphological operator must be a square matrix.");
+        }
+        if((matrixOperator->n % 2) == 0)
+        {
+            throw rsgis::img::RSGISImageCalcException("Morphological operator size needs to be an odd number.");
+        }
+        this->winSize = matrixOperator->n;
+        this->winMid = this->winSize / 2;
+
+        // Find the bounding box of the operator elements.
+        int minRow = this->winSize;
+        int maxRow = -1;
+        int minCol = this->winSize;
+        int maxCol = -1;
+        unsigned long numElements = 0;
+        for(int i = 0; i < this->winSize; ++i)
+        {
+            for(int j = 0; j < this->winSize; ++j)
+            {
+                if(matrixOperator->matrix[(i*this->winSize)+j] > 0)
+                {
+                    minRow = std::min(minRow, i);
+                    maxRow = std::max(maxRow, i);
+                    minCol = std::min(minCol, j);
+                    maxCol = std::max(maxCol, j);
+                    ++numElements;
+                }
+            }
+        }
+        if(numElements == 0)
+        {
+            throw rsgis::img::RSGISImageCalcException("Morphological operator does not have any elements set.");
+        }
+
+        // If the bounding box is full then the operator is a rectangle and separable.
+        this->rectRow = minRow - this->winMid;
+        this->rectCol = minCol - this->winMid;
+        this->rectNRows = (maxRow - minRow) + 1;
+        this->rectNCols = (maxCol - minCol) + 1;
+        this->separable = (numElements == ((unsigned long)this->rectNRows * this->rectNCols));
+
+        // Otherwise decompose into the horizontal runs of each row.
+        for(int i = 0; i < this->winSize; ++i)
+        {
+            int runStart = -1;
+            for(int j = 0; j <= this->winSize; ++j)
+            {
+                bool inOp = (j < this->winSize) && (matrixOperator->matrix[(i*this->winSize)+j] > 0);
+                if(inOp && (runStart < 0))
+                {
+                    runStart = j;
+                }
+                else if((!inOp) && (runStart >= 0))
+                {
+                    this->runRows.push_back(i - this->winMid);
+                    this->runCols.push_back(runStart - this->winMid);
+                    this->runLens.push_back(j - runStart);
+                    runStart = -1;
+                }
+            }
+        }
+    }
+
+    void RSGISMorphologyVHGW::dilate(float *inData, float *outData, unsigned int width, unsigned int height)
+    {
+        this->calcMinMax(inData, outData, width, height, true);
+    }
+
+    void RSGISMorphologyVHGW::erode(float *inData, float *outData, unsigned int width, unsigned int height)
+    {
+        this->calcMinMax(inData, outData, width, height, false);
+    }
+
+    void RSGISMorphologyVHGW::calcLineMinMax(float *line, size_t lineLen, unsigned int winLen, bool calcMax, float *outLine)
+    {
+        // outLine[i] is the min/max of line[i] to line[i+winLen-1]. The line is split
+        // into blocks of winLen; g holds the running min/max from the start of each
+        // block and h from the end, so each window is max(h[i], g[i+winLen-1]).
+        if(lineLen < winLen)
+        {
+            return;
+        }
+        float *g = this->gBuf.data();
+        float *h = this->hBuf.data();
+        for(size_t blockStart = 0; blockStart < lineLen; blockStart += winLen)
+        {
+            size_t blockEnd = std::min(blockStart + winLen, lineLen) - 1;
+            g[blockStart] = line[blockStart];
+            h[blockEnd] = line[blockEnd];
+            if(calcMax)
+            {
+                for(size_t i = blockStart + 1; i <= blockEnd; ++i)
+                {
+                    g[i] = std::max(g[i-1], line[i]);
+                }
+                for(size_t i = blockEnd; i > blockStart; --i)
+                {
+                    h[i-1] = std::max(h[i], line[i-1]);
+                }
+            }
+            else
+            {
+                for(size_t i = blockStart + 1; i <= blockEnd; ++i)
+                {
+                    g[i] = std::min(g[i-1], line[i]);
+                }
+                for(size_t i = blockEnd; i > blockStart; --i)
+                {
+                    h[i-1] = std::min(h[i], line[i-1]);
+                }
+            }
+        }
+
+        size_t numOut = (lineLen - winLen) + 1;
+        if(calcMax)
+        {
+            for(size_t i = 0; i < numOut; ++i)
+            {
+                outLine[i] = std::max(h[i], g[i+winLen-1]);
+            }
+        }
+        else
+        {
+            for(size_t i = 0; i < numOut; ++i)
+            {
+                outLine[i] = std::min(h[i], g[i+winLen-1]);
+            }
+        }
+    }
+
+    void RSGISMorphologyVHGW::calcMinMax(float *inData, float *outData, unsigned int width, unsigned int height, bool calcMax)
+    {
+        size_t maxLineLen = std::max(width, height) + (2 * this->winMid);
+        this->gBuf.resize(maxLineLen);
+        this->hBuf.resize(maxLineLen);
+        this->lineBuf.assign(maxLineLen, 0.0);
+        this->lineOutBuf.resize(maxLineLen);
+        float *line = this->lineBuf.data();
+        float *lineOut = this->lineOutBuf.data();
+        size_t paddedWidth = width + (2 * this->winMid);
+        size_t paddedHeight = height + (2 * this->winMid);
+
+        if(this->separable)
+        {
+            this->passBuf.resize(((size_t)width) * height);
+            float *passData = this->passBuf.data();
+
+            // Horizontal pass; the padding either side of the line stays zero.
+            for(size_t y = 0; y < height; ++y)
+            {
+                std::copy(&inData[y*width], &inData[(y+1)*width], &line[this->winMid]);
+                this->calcLineMinMax(line, paddedWidth, this->rectNCols, calcMax, lineOut);
+                std::copy(&lineOut[this->rectCol + this->winMid], &lineOut[this->rectCol + this->winMid + width], &passData[y*width]);
+            }
+            for(size_t i = 0; i < maxLineLen; ++i)
+            {
+                line[i] = 0;
+            }
+
+            // Vertical pass, copying each column into the line buffer.
+            for(size_t x = 0; x < width; ++x)
+            {
+                for(size_t y = 0; y < height; ++y)
+                {
+                    line[y + this->winMid] = passData[(y*width)+x];
+                }
+                this->calcLineMinMax(line, paddedHeight, this->rectNRows, calcMax, lineOut);
+                for(size_t y = 0; y < height; ++y)
+                {
+                    outData[(y*width)+x] = lineOut[y + this->rectRow + this->winMid];
+                }
+            }
+        }
+        else
+        {
+            for(long y = 0; y < height; ++y)
+            {
+                float *outRow = &outData[y*width];
+                for(size_t r = 0; r < this->runRows.size(); ++r)
+                {
+                    long inRow = y + this->runRows[r];
+                    if((inRow < 0) || (inRow >= height))
+                    {
+                        // The whole run is in the zero padding.
+                        for(size_t x = 0; x < width; ++x)
+                        {
+                            lineOut[x + this->runCols[r] + this->winMid] = 0;
+                        }
+                    }
+                    else
+                    {
+                        std::copy(&inData[inRow*width], &inData[(inRow+1)*width], &line[this->winMid]);
+                        this->calcLineMinMax(line, paddedWidth, this->runLens[r], calcMax, lineOut);
+                    }
+
+                    float *runVals = &lineOut[this->runCols[r] + this->winMid];
+                    if(r == 0)
+                    {
+                        std::copy(runVals, runVals + width, outRow);
+                    }
+                    else if(calcMax)
+                    {
+                        for(size_t x = 0; x < width; ++x)
+                        {
+                            outRow[x] = std::max(outRow[x], runVals[x]);
+                        }
+                    }
+                    else
+                    {
+                        for(size_t x = 0; x < width; ++x)
+                        {
+                            outRow[x] = std::min(outRow[x], runVals[x]);
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    void RSGISMorphologyVHGW::applyMorphOperation(float *inData, float *outData, float *tmpData, unsigned int width, unsigned int height, RSGISMorphologyOperation morphOp, unsigned int numIterations)
+    {
+        size_t numPxls = ((size_t)width) * height;
+        if(numIterations == 0)
+        {
+            numIterations = 1;
+        }
+
+        if(morphOp == rsgis_morph_dilate)
+        {
+            this->dilate(inData, outData, width, height);
+        }
+        else if(morphOp == rsgis_morph_erode)
+        {
+            this->erode(inData, outData, width, height);
+        }
+        else if(morphOp == rsgis_morph_gradient)
+        {
+            this->dilate(inData, outData, width, height);
+            this->erode(inData, tmpData, width, height);
+            for(size_t i = 0; i < numPxls; ++i)
+            {
+                outData[i] = outData[i] - tmpData[i];
+            }
+        }
+        else if((morphOp == rsgis_morph_opening) || (morphOp == rsgis_morph_whitetophat))
+        {
+            unsigned int nIters = (morphOp == rsgis_morph_opening)?numIterations:1;
+            std::copy(inData, inData + numPxls, outData);
+            for(unsigned int n = 0; n < nIters; ++n)
+            {
+                this->erode(outData, tmpData, width, height);
+                this->dilate(tmpData, outData, width, height);
+            }
+            if(morphOp == rsgis_morph_whitetophat)
+            {
+                // Input - opening
+                for(size_t i = 0; i < numPxls; ++i)
+                {
+                    outData[i] = inData[i] - outData[i];
+                }
+            }
+        }
+        else if((morphOp == rsgis_morph_closing) || (morphOp == rsgis_morph_blacktophat))
+        {
+            unsigned int nIters = (morphOp == rsgis_morph_closing)?numIterations:1;
+            std::copy(inData, inData + numPxls, outData);
+            for(unsigned int n = 0; n < nIters; ++n)
+            {
+                this->dilate(outData, tmpData, width, height);
+                this->erode(tmpData, outData, width, height);
+            }
+            if(morphOp == rsgis_morph_blacktophat)
+            {
+                // Closing - input
+                for(size_t i = 0; i < numPxls; ++i)
+                {
+                    outData[i] = outData[i] - inData[i];
+                }
+            }
+        }
+        else
+        {
+            throw rsgis::img::RSGISImageCalcException("Morphological operation was not recognised.");
+        }
+    }
+
+    void RSGISMorphologyVHGW::applyToImage(GDALDataset *dataset, std::string outputImage, RSGISMorphologyOperation morphOp, unsigned int numIterations, bool allBands, std::string format, GDALDataType outDataType)
+    {
+        if(allBands && (morphOp != rsgis_morph_dilate) && (morphOp != rsgis_morph_erode) && (morphOp != rsgis_morph_gradient))
+        {
+            throw rsgis::img::RSGISImageCalcException("Combining all bands is only supported for dilation, erosion and gradient.");
+        }
+
+        rsgis::img::RSGISImageUtils imgUtils;
+        unsigned int width = dataset->GetRasterXSize();
+        unsigned int height = dataset->GetRasterYSize();
+        unsigned int numInBands = dataset->GetRasterCount();
+        unsigned int numOutBands = allBands?1:numInBands;
+
+        // The image is processed in strips of rows. Each erosion/dilation pass only
+        // depends on the rows within winMid of the output row so a strip is read with
+        // a halo of winMid rows for each pass, outside of which the result is not used.
+        // At the top and bottom of the image the halo is clipped so the rows outside
+        // the image are zero, as when processing the whole image.
+        unsigned int numPasses = 1;
+        if((morphOp == rsgis_morph_opening) || (morphOp == rsgis_morph_closing))
+        {
+            numPasses = 2 * std::max(numIterations, 1u);
+        }
+        else if((morphOp == rsgis_morph_whitetophat) || (morphOp == rsgis_morph_blacktophat))
+        {
+            numPasses = 2;
+        }
+        unsigned int halo = numPasses * this->winMid;
+        unsigned int stripHeight = std::max((unsigned int)(RSGIS_MORPH_STRIP_PXLS / std::max(width, 1u)), 1u);
+        stripHeight = std::min(std::max(stripHeight, halo), height);
+        unsigned int maxReadHeight = std::min(stripHeight + (2 * halo), height);
+        size_t numBufPxls = ((size_t)width) * maxReadHeight;
+        unsigned int numStrips = (height + stripHeight - 1) / stripHeight;
+
+        GDALDataset *outDataset = imgUtils.createCopy(dataset, numOutBands, outputImage, format, outDataType);
+        try
+        {
+            std::vector<float> inBuf(numBufPxls);
+            std::vector<float> outBuf(numBufPxls);
+            std::vector<float> tmpBuf(numBufPxls);
+            std::vector<float> bandBuf(allBands?numBufPxls:0);
+            float *inData = inBuf.data();
+            float *outData = outBuf.data();
+            float *tmpData = tmpBuf.data();
+            float *bandData = bandBuf.data();
+
+            rsgis_tqdm pbar;
+            for(unsigned int s = 0; s < numStrips; ++s)
+            {
+                unsigned int yStart = s * stripHeight;
+                unsigned int yEnd = std::min(yStart + stripHeight, height);
+                unsigned int readStart = (yStart > halo)?(yStart - halo):0;
+                unsigned int readHeight = std::min(yEnd + halo, height) - readStart;
+                size_t numPxls = ((size_t)width) * readHeight;
+                float *outRows = &outData[((size_t)(yStart - readStart)) * width];
+
+                if(allBands)
+                {
+                    // Reduce the bands to the per-pixel max (dilation) or min (erosion);
+                    // the gradient needs both.
+                    float *minData = (morphOp == rsgis_morph_gradient)?tmpData:NULL;
+                    for(unsigned int n = 0; n < numInBands; ++n)
+                    {
+                        float *readData = (n == 0)?inData:bandData;
+                        if(dataset->GetRasterBand(n+1)->RasterIO(GF_Read, 0, readStart, width, readHeight, readData, width, readHeight, GDT_Float32, 0, 0) != CE_None)
+                        {
+                            throw rsgis::img::RSGISImageCalcException("Could not read image band.");
+                        }
+                        if(n == 0)
+                        {
+                            if(minData != NULL)
+                            {
+                                std::copy(inData, inData + numPxls, minData);
+                            }
+                            continue;
+                        }
+                        for(size_t i = 0; i < numPxls; ++i)
+                        {
+                            if(morphOp == rsgis_morph_erode)
+                            {
+                                inData[i] = std::min(inData[i], bandData[i]);
+                            }
+                            else
+                            {
+                                inData[i] = std::max(inData[i], bandData[i]);
+                            }
+                            if(minData != NULL)
+                            {
+                                minData[i] = std::min(minData[i], bandData[i]);
+                            }
+                        }
+                    }
+
+                    if(morphOp == rsgis_morph_gradient)
+                    {
+                        this->erode(minData, bandData, width, readHeight);
+                        this->dilate(inData, outData, width, readHeight);
+                        for(size_t i = 0; i < numPxls; ++i)
+                        {
+                            outData[i] = outData[i] - bandData[i];
+                        }
+                    }
+                    else
+                    {
+                        this->applyMorphOperation(inData, outData, tmpData, width, readHeight, morphOp, numIterations);
+                    }
+                    if(outDataset->GetRasterBand(1)->RasterIO(GF_Write, 0, yStart, width, (yEnd - yStart), outRows, width, (yEnd - yStart), GDT_Float32, 0, 0) != CE_None)
+                    {
+                        throw rsgis::img::RSGISImageCalcException("Could not write image band.");
+                    }
+                }
+                else
+                {
+                    for(unsigned int n = 0; n < numInBands; ++n)
+                    {
+                        if(dataset->GetRasterBand(n+1)->RasterIO(GF_Read, 0, readStart, width, readHeight, inData, width, readHeight, GDT_Float32, 0, 0) != CE_None)
+                        {
+                            throw rsgis::img::RSGISImageCalcException("Could not read image band.");
+                        }
+                        this->applyMorphOperation(inData, outData, tmpData, width, readHeight, morphOp, numIterations);
+                        if(outDataset->GetRasterBand(n+1)->RasterIO(GF_Write, 0, yStart, width, (yEnd - yStart), outRows, width, (yEnd - yStart), GDT_Float32, 0, 0) != CE_None)
+                        {
+                            throw rsgis::img::RSGISImageCalcException("Could not write image band.");
+                        }
+                    }
+                }
+                pbar.progress(s, numStrips);
+            }
+            pbar.finish();
+        }
+        catch(...)
+        {
+            GDALClose(outDataset);
+            throw;
+        }
+
+        GDALClose(outDataset);
+    }
+
+    RSGISMorphologyVHGW::~RSGISMorphologyVHGW()
+    {
+
+    }
+
+}}
@@ -24,7 +24,7 @@
 
 namespace rsgis{namespace filter{
 
-    RSGISNormVarPowerFilter::RSGISNormVarPowerFilter(int numberOutBands, int size, std::string filenameEnding) : RSGISImageFilter(numberOutBands, size, filenameEnding){}
+    RSGISNormVarPowerFilter::RSGISNormVarPowerFilter(int numberOutBands, int size, std::string filenameEnding) : RSGISWindowSumsFilter(numberOutBands, size, filenameEnding){}
 
     void RSGISNormVarPowerFilter::calcImageValue(float ***dataBlock, int numBands, int winSize, double *output) 
 	{
@@ -80,8 +80,46 @@ namespace rsgis{namespace filter{
         }
 	}
 
+    unsigned int RSGISNormVarPowerFilter::getNumSumTerms()
+    {
+        return 2;
+    }
 
-    RSGISNormVarAmplitudeFilter::RSGISNormVarAmplitudeFilter(int numberOutBands, int size, std::string filenameEnding) : RSGISImageFilter(numberOutBands, size, filenameEnding){}
+    bool RSGISNormVarPowerFilter::calcSumTerms(float val, double *terms)
+    {
+        if((val == 0) || (boost::math::isnan)(val))
+        {
+            return false;
+        }
+        terms[0] = val - this->termsOffset;
+        terms[1] = terms[0]*terms[0];
+        return true;
+    }
+
+    double RSGISNormVarPowerFilter::calcTermsOffset(float val)
+    {
+        return val;
+    }
+
+    double RSGISNormVarPowerFilter::calcSumsValue(unsigned long numVals, double *sums, float centreVal)
+    {
+        // Skip if no data at the centre of the window to preserve scene edges
+        // and check there were at least three data values.
+        if((centreVal == 0) || (boost::math::isnan)(centreVal) || (numVals <= 3))
+        {
+            return 0;
+        }
+        // E[x^2]/E[x]^2 - 1 is the variance over the squared mean, which is
+        // calculated from the sums about the offset.
+        double offMean = sums[0] / numVals;
+        double iMean = this->termsOffset + offMean;
+        double variance = (sums[1] / numVals) - (offMean*offMean);
+        if(variance < 0){variance = 0;}
+        return variance / (iMean*iMean);
+    }
+
+
+    RSGISNormVarAmplitudeFilter::RSGISNormVarAmplitudeFilter(int numberOutBands, int size, std::string filenameEnding) : RSGISWindowSumsFilter(numberOutBands, size, filenameEnding){}
 
     void RSGISNormVarAmplitudeFilter::calcImageValue(float ***dataBlock, int numBands, int winSize, double *output) 
 	{
@@ -136,8 +174,46 @@ namespace rsgis{namespace filter{
         }
 	}
 
+    unsigned int RSGISNormVarAmplitudeFilter::getNumSumTerms()
+    {
+        return 2;
+    }
+
+    bool RSGISNormVarAmplitudeFilter::calcSumTerms(float val, double *terms)
+    {
+        if((val == 0) || (boost::math::isnan)(val))
+        {
+            return false;
+        }
+        terms[0] = sqrt(val) - this->termsOffset;
+        terms[1] = terms[0]*terms[0];
+        return true;
+    }
+
+    double RSGISNormVarAmplitudeFilter::calcTermsOffset(float val)
+    {
+        return sqrt(val);
+    }
+
+    double RSGISNormVarAmplitudeFilter::calcSumsValue(unsigned long numVals, double *sums, float centreVal)
+    {
+        // Skip if no data at the centre of the window to preserve scene edges
+        // and check there were at least three data values.
+        if((centreVal == 0) || (boost::math::isnan)(centreVal) || (numVals <= 3))
+        {
+            return 0;
+        }
+        // E[x^2]/E[x]^2 - 1 is the variance over the squared mean, which is
+        // calculated from the sums about the offset.
+        double offMean = sums[0] / numVals;
+        double iMean = this->termsOffset + offMean;
+        double variance = (sums[1] / numVals) - (offMean*offMean);
+        if(variance < 0){variance = 0;}
+        return variance / (iMean*iMean);
+    }
+
 
-    RSGISNormVarLnPowerFilter::RSGISNormVarLnPowerFilter(int numberOutBands, int size, std::string filenameEnding) : RSGISImageFilter(numberOutBands, size, filenameEnding){}
+    RSGISNormVarLnPowerFilter::RSGISNormVarLnPowerFilter(int numberOutBands, int size, std::string filenameEnding) : RSGISWindowSumsFilter(numberOutBands, size, filenameEnding){}
 
     void RSGISNormVarLnPowerFilter::calcImageValue(float ***dataBlock, int numBands, int winSize, double *output) 
 	{
@@ -192,7 +268,46 @@ namespace rsgis{namespace filter{
         }
 	}
 
-    RSGISNormLnFilter::RSGISNormLnFilter(int numberOutBands, int size, std::string filenameEnding) : RSGISImageFilter(numberOutBands, size, filenameEnding){}
+    unsigned int RSGISNormVarLnPowerFilter::getNumSumTerms()
+    {
+        return 2;
+    }
+
+    bool RSGISNormVarLnPowerFilter::calcSumTerms(float val, double *terms)
+    {
+        if((val == 0) || (boost::math::isnan)(val))
+        {
+            return false;
+        }
+        terms[0] = log(val) - this->termsOffset;
+        terms[1] = terms[0]*terms[0];
+        return true;
+    }
+
+    double RSGISNormVarLnPowerFilter::calcTermsOffset(float val)
+    {
+        return log(val);
+    }
+
+    double RSGISNormVarLnPowerFilter::calcSumsValue(unsigned long numVals, double *sums, float centreVal)
+    {
+        // Skip if no data at the centre of the window to preserve scene edges
+        // and check there were at least three data values.
+        if((centreVal == 0) || (boost::math::isnan)(centreVal) || (numVals <= 3))
+        {
+            return 0;
+        }
+        // E[x^2]/E[x]^2 - 1 is the variance over the squared mean, which is
+        // calculated from the sums about the offset.
+        double offMean = sums[0] / numVals;
+        double iMean = this->termsOffset + offMean;
+        double variance = (sums[1] / numVals) - (offMean*offMean);
+        if(variance < 0){variance = 0;}
+        return variance / (iMean*iMean);
+    }
+
+
+    RSGISNormLnFilter::RSGISNormLnFilter(int numberOutBands, int size, std::string filenameEnding) : RSGISWindowSumsFilter(numberOutBands, size, filenameEnding){}
 
     void RSGISNormLnFilter::calcImageValue(float ***dataBlock, int numBands, int winSize, double *output) 
 	{
@@ -247,7 +362,37 @@ namespace rsgis{namespace filter{
         }
 	}
 
-    RSGISTextureVar::RSGISTextureVar(int numberOutBands, int size, std::string filenameEnding) : RSGISImageFilter(numberOutBands, size, filenameEnding){}
+    unsigned int RSGISNormLnFilter::getNumSumTerms()
+    {
+        return 2;
+    }
+
+    bool RSGISNormLnFilter::calcSumTerms(float val, double *terms)
+    {
+        if((val == 0) || (boost::math::isnan)(val))
+        {
+            return false;
+        }
+        terms[0] = val;
+        terms[1] = log(val);
+        return true;
+    }
+
+    double RSGISNormLnFilter::calcSumsValue(unsigned long numVals, double *sums, float centreVal)
+    {
+        // Skip if no data at the centre of the window to preserve scene edges
+        // and check there were at least three data values.
+        if((centreVal == 0) || (boost::math::isnan)(centreVal) || (numVals <= 3))
+        {
+            return 0;
+        }
+        double iMeanLn = log(sums[0] / numVals);
+        double iLnMean = sums[1] / numVals;
+        return iLnMean - iMeanLn;
+    }
+
+
+    RSGISTextureVar::RSGISTextureVar(int numberOutBands, int size, std::string filenameEnding) : RSGISWindowSumsFilter(numberOutBands, size, filenameEnding){}
 
     void RSGISTextureVar::calcImageValue(float ***dataBlock, int numBands, int winSize, double *output) 
 	{
@@ -314,4 +459,41 @@ namespace rsgis{namespace filter{
         }
 	}
 
+    unsigned int RSGISTextureVar::getNumSumTerms()
+    {
+        return 2;
+    }
+
+    bool RSGISTextureVar::calcSumTerms(float val, double *terms)
+    {
+        if((val == 0) || (boost::math::isnan)(val))
+        {
+            return false;
+        }
+        terms[0] = val - this->termsOffset;
+        terms[1] = terms[0]*terms[0];
+        return true;
+    }
+
+    double RSGISTextureVar::calcTermsOffset(float val)
+    {
+        return val;
+    }
+
+    double RSGISTextureVar::calcSumsValue(unsigned long numVals, double *sums, float centreVal)
+    {
+        // Skip if no data at the centre of the window to preserve scene edges
+        // and check there were at least three data values.
+        if((centreVal == 0) || (boost::math::isnan)(centreVal) || (numVals <= 3))
+        {
+            return 0;
+        }
+        double offMean = sums[0] / numVals;
+        double iMean = this->termsOffset + offMean;
+        double variance = (sums[1] / numVals) - (offMean*offMean);
+        if(variance < 0){variance = 0;}
+        double stDev = sqrt(variance);
+        return (pow((stDev / iMean),2)-(1/numVals))/(1+(1/numVals));
+    }
+
 }}
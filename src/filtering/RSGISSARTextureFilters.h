@@ -31,6 +31,7 @@
 #include "img/RSGISImageCalcException.h"
 #include "img/RSGISCalcImageValue.h"
 #include "filtering/RSGISImageFilter.h"
+#include "filtering/RSGISWindowSumsFilter.h"
 
 #include <boost/math/special_functions/fpclassify.hpp>
 
@@ -51,7 +52,7 @@ namespace rsgis
 {
     namespace filter
     {
-        class DllExport RSGISNormVarPowerFilter : public RSGISImageFilter
+        class DllExport RSGISNormVarPowerFilter : public RSGISWindowSumsFilter
         {
             /**
 
@@ -86,9 +87,20 @@ namespace rsgis
 
             ~RSGISNormVarPowerFilter()
             {};
+
+        protected:
+            virtual unsigned int getNumSumTerms();
+
+            virtual bool calcSumTerms(float val, double *terms);
+
+            virtual double calcTermsOffset(float val);
+
+            virtual double calcSumsValue(
+                unsigned long numVals, double *sums, float centreVal
+            );
         };
 
-        class DllExport RSGISNormVarAmplitudeFilter : public RSGISImageFilter
+        class DllExport RSGISNormVarAmplitudeFilter : public RSGISWindowSumsFilter
         {
             /**
 
@@ -124,9 +136,20 @@ namespace rsgis
 
             ~RSGISNormVarAmplitudeFilter()
             {};
+
+        protected:
+            virtual unsigned int getNumSumTerms();
+
+            virtual bool calcSumTerms(float val, double *terms);
+
+            virtual double calcTermsOffset(float val);
+
+            virtual double calcSumsValue(
+                unsigned long numVals, double *sums, float centreVal
+            );
         };
 
-        class DllExport RSGISNormVarLnPowerFilter : public RSGISImageFilter
+        class DllExport RSGISNormVarLnPowerFilter : public RSGISWindowSumsFilter
         {
             /**
 
@@ -162,9 +185,20 @@ namespace rsgis
 
             ~RSGISNormVarLnPowerFilter()
             {};
+
+        protected:
+            virtual unsigned int getNumSumTerms();
+
+            virtual bool calcSumTerms(float val, double *terms);
+
+            virtual double calcTermsOffset(float val);
+
+            virtual double calcSumsValue(
+                unsigned long numVals, double *sums, float centreVal
+            );
         };
 
-        class DllExport RSGISNormLnFilter : public RSGISImageFilter
+        class DllExport RSGISNormLnFilter : public RSGISWindowSumsFilter
         {
             /**
 
@@ -198,9 +232,18 @@ namespace rsgis
 
             ~RSGISNormLnFilter()
             {};
+
+        protected:
+            virtual unsigned int getNumSumTerms();
+
+            virtual bool calcSumTerms(float val, double *terms);
+
+            virtual double calcSumsValue(
+                unsigned long numVals, double *sums, float centreVal
+            );
         };
 
-        class DllExport RSGISTextureVar : public RSGISImageFilter
+        class DllExport RSGISTextureVar : public RSGISWindowSumsFilter
         {
             /**
              Texture variance
@@ -236,6 +279,17 @@ namespace rsgis
 
             ~RSGISTextureVar()
             {};
+
+        protected:
+            virtual unsigned int getNumSumTerms();
+
+            virtual bool calcSumTerms(float val, double *terms);
+
+            virtual double calcTermsOffset(float val);
+
+            virtual double calcSumsValue(
+                unsigned long numVals, double *sums, float centreVal
+            );
         };
     }
 }
@@ -29,7 +29,7 @@ namespace rsgis
         RSGISMeanFilter::RSGISMeanFilter(
             int numberOutBands, int size, std::string filenameEnding, bool useNoDataVal,
             float noDataVal
-        ) : RSGISImageFilter(numberOutBands, size, filenameEnding)
+        ) : RSGISWindowSumsFilter(numberOutBands, size, filenameEnding)
         {
             this->useNoDataVal = useNoDataVal;
             this->noDataVal = noDataVal;
@@ -50,12 +50,17 @@ namespace rsgis
             for (int i = 0; i < numBands; i++)
             {
                 outputValue = 0;
+                numberElements = 0;
                 for (int j = 0; j < this->size; j++)
                 {
                     for (int k = 0; k < this->size; k++)
                     {
                         use_pxl_val = true;
-                        if (this->useNoDataVal && dataBlock[i][j][k] == this->noDataVal)
+                        if (!std::isfinite(dataBlock[i][j][k]))
+                        {
+                            use_pxl_val = false;
+                        }
+                        else if (this->useNoDataVal && dataBlock[i][j][k] == this->noDataVal)
                         {
                             use_pxl_val = false;
                         }
@@ -89,18 +94,144 @@ namespace rsgis
             std::cout << "No Image to output\n";
         }
 
+        unsigned int RSGISMeanFilter::getNumSumTerms()
+        {
+            return 1;
+        }
+
+        bool RSGISMeanFilter::calcSumTerms(float val, double *terms)
+        {
+            if (this->useNoDataVal && (val == this->noDataVal))
+            {
+                return false;
+            }
+            terms[0] = val;
+            return true;
+        }
+
+        double RSGISMeanFilter::calcSumsValue(
+            unsigned long numVals, double *sums, float centreVal
+        )
+        {
+            if (numVals == 0)
+            {
+                return this->noDataVal;
+            }
+            return sums[0] / numVals;
+        }
+
         RSGISMeanFilter::~RSGISMeanFilter()
         {}
 
-        RSGISMedianFilter::RSGISMedianFilter(
+        RSGISOrderStatFilter::RSGISOrderStatFilter(
             int numberOutBands, int size, std::string filenameEnding, bool useNoDataVal,
             float noDataVal
-        ) : RSGISImageFilter(numberOutBands, size, filenameEnding)
+        ) : RSGISImageRowFilter(numberOutBands, size, filenameEnding)
         {
             this->useNoDataVal = useNoDataVal;
             this->noDataVal = noDataVal;
         }
 
+        void RSGISOrderStatFilter::calcRowValues(
+            float **winRows, int width, int band, double *output
+        )
+        {
+            size_t paddedWidth = width + (this->size - 1);
+            this->rankWindowRows(
+                winRows, width, this->useNoDataVal, this->noDataVal, &this->rowVals,
+                &this->rowRanks
+            );
+            size_t nRanks = this->rowVals.size();
+            if (nRanks == 0)
+            {
+                for (int x = 0; x < width; x++)
+                {
+                    output[x] = this->noDataVal;
+                }
+                return;
+            }
+
+            // Fenwick tree (1 based) of the number of window pixels with each rank.
+            this->rankCounts.assign(nRanks + 1, 0);
+            size_t topStep = 1;
+            while ((topStep << 1) <= nRanks)
+            {
+                topStep = topStep << 1;
+            }
+
+            size_t nVals = 0;
+            for (int x = (1 - this->size); x < width; x++)
+            {
+                // Add the column entering the right of the window.
+                size_t addCol = x + (this->size - 1);
+                for (int j = 0; j < this->size; j++)
+                {
+                    int rank = this->rowRanks[(j * paddedWidth) + addCol];
+                    if (rank >= 0)
+                    {
+                        for (size_t i = rank + 1; i <= nRanks; i += (i & (~i + 1)))
+                        {
+                            ++this->rankCounts[i];
+                        }
+                        ++nVals;
+                    }
+                }
+                if (x < 0)
+                {
+                    continue;
+                }
+
+                if (nVals == 0)
+                {
+                    output[x] = this->noDataVal;
+                }
+                else
+                {
+                    // Descend the tree to find the smallest rank whose cumulative
+                    // count is greater than the required index.
+                    size_t remain = this->getOrderStatIdx(nVals) + 1;
+                    size_t pos = 0;
+                    for (size_t step = topStep; step > 0; step = step >> 1)
+                    {
+                        if (((pos + step) <= nRanks) && (this->rankCounts[pos + step] < remain))
+                        {
+                            pos += step;
+                            remain -= this->rankCounts[pos];
+                        }
+                    }
+                    output[x] = this->rowVals[pos];
+                }
+
+                // Remove the column leaving the left of the window.
+                for (int j = 0; j < this->size; j++)
+                {
+                    int rank = this->rowRanks[(j * paddedWidth) + x];
+                    if (rank >= 0)
+                    {
+                        for (size_t i = rank + 1; i <= nRanks; i += (i & (~i + 1)))
+                        {
+                            --this->rankCounts[i];
+                        }
+                        --nVals;
+                    }
+                }
+            }
+        }
+
+        RSGISOrderStatFilter::~RSGISOrderStatFilter()
+        {}
+
+        RSGISMedianFilter::RSGISMedianFilter(
+            int numberOutBands, int size, std::string filenameEnding, bool useNoDataVal,
+            float noDataVal
+        ) : RSGISOrderStatFilter(numberOutBands, size, filenameEnding, useNoDataVal, noDataVal)
+        {}
+
+        size_t RSGISMedianFilter::getOrderStatIdx(size_t nVals)
+        {
+            return nVals / 2;
+        }
+
         void RSGISMedianFilter::calcImageValue(
             float ***dataBlock, int numBands, int winSize, double *output
         )
@@ -112,7 +243,6 @@ namespace rsgis
 
             bool use_pxl_val = true;
             int numberElements = winSize * winSize;
-            int median = floor(((float) numberElements) / 2.0);
             std::vector<float> sortedList;
             sortedList.reserve(numberElements);
 
@@ -123,7 +253,11 @@ namespace rsgis
                     for (int k = 0; k < size; k++)
                     {
                         use_pxl_val = true;
-                        if (this->useNoDataVal && dataBlock[i][j][k] == this->noDataVal)
+                        if (std::isnan(dataBlock[i][j][k]))
+                        {
+                            use_pxl_val = false;
+                        }
+                        else if (this->useNoDataVal && dataBlock[i][j][k] == this->noDataVal)
                         {
                             use_pxl_val = false;
                         }
@@ -136,7 +270,7 @@ namespace rsgis
                 if (sortedList.size() > 0)
                 {
                     std::sort(sortedList.begin(), sortedList.end());
-                    output[i] = sortedList[median];
+                    output[i] = sortedList[this->getOrderStatIdx(sortedList.size())];
                     sortedList.clear();
                 }
                 else
@@ -161,13 +295,98 @@ namespace rsgis
         RSGISMedianFilter::~RSGISMedianFilter()
         {}
 
+        RSGISPercentileFilter::RSGISPercentileFilter(
+            int numberOutBands, int size, std::string filenameEnding, bool useNoDataVal,
+            float noDataVal, float percentile
+        ) : RSGISOrderStatFilter(numberOutBands, size, filenameEnding, useNoDataVal, noDataVal)
+        {
+            this->percentile = percentile;
+        }
+
+        size_t RSGISPercentileFilter::getOrderStatIdx(size_t nVals)
+        {
+            double rank = ceil((this->percentile / 100.0) * nVals);
+            if (rank < 1)
+            {
+                return 0;
+            }
+            else if (rank > nVals)
+            {
+                return nVals - 1;
+            }
+            return ((size_t) rank) - 1;
+        }
+
+        void RSGISPercentileFilter::calcImageValue(
+            float ***dataBlock, int numBands, int winSize, double *output
+        )
+        {
+            if (this->size != winSize)
+            {
+                throw rsgis::img::RSGISImageCalcException("Window sizes are different");
+            }
+
+            bool use_pxl_val = true;
+            std::vector<float> sortedList;
+            sortedList.reserve(winSize * winSize);
+
+            for (int i = 0; i < numBands; i++)
+            {
+                for (int j = 0; j < size; j++)
+                {
+                    for (int k = 0; k < size; k++)
+                    {
+                        use_pxl_val = true;
+                        if (std::isnan(dataBlock[i][j][k]))
+                        {
+                            use_pxl_val = false;
+                        }
+                        else if (this->useNoDataVal && dataBlock[i][j][k] == this->noDataVal)
+                        {
+                            use_pxl_val = false;
+                        }
+                        if (use_pxl_val)
+                        {
+                            sortedList.push_back(dataBlock[i][j][k]);
+                        }
+                    }
+                }
+                if (sortedList.size() > 0)
+                {
+                    std::sort(sortedList.begin(), sortedList.end());
+                    output[i] = sortedList[this->getOrderStatIdx(sortedList.size())];
+                    sortedList.clear();
+                }
+                else
+                {
+                    output[i] = this->noDataVal;
+                }
+            }
+        }
+
+        bool RSGISPercentileFilter::calcImageValueCondition(
+            float ***dataBlock, int numBands, int winSize, double *output
+        )
+        {
+            throw rsgis::img::RSGISImageCalcException("Not implemented yet");
+        }
+
+        void RSGISPercentileFilter::exportAsImage(std::string filename)
+        {
+            std::cout << "No Image to output\n";
+        }
+
+        RSGISPercentileFilter::~RSGISPercentileFilter()
+        {}
+
         RSGISModeFilter::RSGISModeFilter(
             int numberOutBands, int size, std::string filenameEnding, bool useNoDataVal,
             float noDataVal
-        ) : RSGISImageFilter(numberOutBands, size, filenameEnding)
+        ) : RSGISImageRowFilter(numberOutBands, size, filenameEnding)
         {
             this->useNoDataVal = useNoDataVal;
             this->noDataVal = noDataVal;
+            this->modeLeafOff = 0;
         }
 
         void RSGISModeFilter::calcImageValue(
@@ -180,9 +399,8 @@ namespace rsgis
             }
 
             bool use_pxl_val = true;
-
-            rsgis::datastruct::SortedGenericList<float> *sortedList = new
-                    rsgis::datastruct::SortedGenericList<float>();
+            std::vector<float> sortedList;
+            sortedList.reserve(winSize * winSize);
 
             for (int i = 0; i < numBands; i++)
             {
@@ -191,28 +409,48 @@ namespace rsgis
                     for (int k = 0; k < size; k++)
                     {
                         use_pxl_val = true;
-                        if (this->useNoDataVal && dataBlock[i][j][k] == this->noDataVal)
+                        if (std::isnan(dataBlock[i][j][k]))
+                        {
+                            use_pxl_val = false;
+                        }
+                        else if (this->useNoDataVal && dataBlock[i][j][k] == this->noDataVal)
                         {
                             use_pxl_val = false;
                         }
                         if (use_pxl_val)
                         {
-                            sortedList->add(&dataBlock[i][j][k]);
+                            sortedList.push_back(dataBlock[i][j][k]);
                         }
                     }
                 }
-                if (sortedList->getSize() > 0)
+                if (sortedList.size() > 0)
                 {
-                    output[i] = *sortedList->getMostCommonValue();
-                    sortedList->clearList();
+                    // Find the longest run in the sorted values; the first
+                    // (i.e., smallest) value wins a tie.
+                    std::sort(sortedList.begin(), sortedList.end());
+                    float modeVal = sortedList[0];
+                    size_t modeCount = 0;
+                    size_t runStart = 0;
+                    for (size_t n = 1; n <= sortedList.size(); n++)
+                    {
+                        if ((n == sortedList.size()) || (sortedList[n] != sortedList[runStart]))
+                        {
+                            if ((n - runStart) > modeCount)
+                            {
+                                modeCount = n - runStart;
+                                modeVal = sortedList[runStart];
+                            }
+                            runStart = n;
+                        }
+                    }
+                    output[i] = modeVal;
+                    sortedList.clear();
                 }
                 else
                 {
                     output[i] = this->noDataVal;
                 }
             }
-
-            delete sortedList;
         }
 
         bool RSGISModeFilter::calcImageValueCondition(
@@ -222,6 +460,105 @@ namespace rsgis
             throw rsgis::img::RSGISImageCalcException("Not implemented yet");
         }
 
+        void RSGISModeFilter::updateModeCount(size_t rank, int change)
+        {
+            size_t node = this->modeLeafOff + rank;
+            this->modeCounts[node] += change;
+            node = node >> 1;
+            while (node > 0)
+            {
+                size_t left = node << 1;
+                size_t right = left + 1;
+                // Prefer the left (lower ranked) child on a tie.
+                if (this->modeCounts[left] >= this->modeCounts[right])
+                {
+                    this->modeCounts[node] = this->modeCounts[left];
+                    this->modeIdxs[node] = this->modeIdxs[left];
+                }
+                else
+                {
+                    this->modeCounts[node] = this->modeCounts[right];
+                    this->modeIdxs[node] = this->modeIdxs[right];
+                }
+                node = node >> 1;
+            }
+        }
+
+        void RSGISModeFilter::calcRowValues(
+            float **winRows, int width, int band, double *output
+        )
+        {
+            size_t paddedWidth = width + (this->size - 1);
+            this->rankWindowRows(
+                winRows, width, this->useNoDataVal, this->noDataVal, &this->rowVals,
+                &this->rowRanks
+            );
+            size_t nRanks = this->rowVals.size();
+            if (nRanks == 0)
+            {
+                for (int x = 0; x < width; x++)
+                {
+                    output[x] = this->noDataVal;
+                }
+                return;
+            }
+
+            // Segment tree where each node holds the maximum count and the rank
+            // of that count within its range. Leaves start at modeLeafOff.
+            this->modeLeafOff = 1;
+            while (this->modeLeafOff < nRanks)
+            {
+                this->modeLeafOff = this->modeLeafOff << 1;
+            }
+            this->modeCounts.assign(this->modeLeafOff * 2, 0);
+            this->modeIdxs.assign(this->modeLeafOff * 2, 0);
+            for (size_t i = 0; i < this->modeLeafOff; i++)
+            {
+                this->modeIdxs[this->modeLeafOff + i] = i;
+            }
+            for (size_t node = this->modeLeafOff - 1; node > 0; node--)
+            {
+                this->modeIdxs[node] = this->modeIdxs[node << 1];
+            }
+
+            for (int x = (1 - this->size); x < width; x++)
+            {
+                // Add the column entering the right of the window.
+                size_t addCol = x + (this->size - 1);
+                for (int j = 0; j < this->size; j++)
+                {
+                    int rank = this->rowRanks[(j * paddedWidth) + addCol];
+                    if (rank >= 0)
+                    {
+                        this->updateModeCount(rank, 1);
+                    }
+                }
+                if (x < 0)
+                {
+                    continue;
+                }
+
+                if (this->modeCounts[1] == 0)
+                {
+                    output[x] = this->noDataVal;
+                }
+                else
+                {
+                    output[x] = this->rowVals[this->modeIdxs[1]];
+                }
+
+                // Remove the column leaving the left of the window.
+                for (int j = 0; j < this->size; j++)
+                {
+                    int rank = this->rowRanks[(j * paddedWidth) + x];
+                    if (rank >= 0)
+                    {
+                        this->updateModeCount(rank, -1);
+                    }
+                }
+            }
+        }
+
         void RSGISModeFilter::exportAsImage(std::string filename)
         {
             std::cout << "No Image to output\n";
@@ -319,7 +656,7 @@ namespace rsgis
         RSGISStdDevFilter::RSGISStdDevFilter(
             int numberOutBands, int size, std::string filenameEnding, bool useNoDataVal,
             float noDataVal
-        ) : RSGISImageFilter(numberOutBands, size, filenameEnding)
+        ) : RSGISWindowSumsFilter(numberOutBands, size, filenameEnding)
         {
             this->useNoDataVal = useNoDataVal;
             this->noDataVal = noDataVal;
@@ -342,6 +679,7 @@ namespace rsgis
             for (int i = 0; i < numBands; i++)
             {
                 outputValue = 0;
+                numberElements = 0;
                 squSum = 0;
 
                 for (int j = 0; j < this->size; j++)
@@ -349,7 +687,11 @@ namespace rsgis
                     for (int k = 0; k < this->size; k++)
                     {
                         use_pxl_val = true;
-                        if (this->useNoDataVal && dataBlock[i][j][k] == this->noDataVal)
+                        if (!std::isfinite(dataBlock[i][j][k]))
+                        {
+                            use_pxl_val = false;
+                        }
+                        else if (this->useNoDataVal && dataBlock[i][j][k] == this->noDataVal)
                         {
                             use_pxl_val = false;
                         }
@@ -370,7 +712,11 @@ namespace rsgis
                         for (int k = 0; k < this->size; k++)
                         {
                             use_pxl_val = true;
-                            if (this->useNoDataVal && dataBlock[i][j][k] == this->
+                            if (!std::isfinite(dataBlock[i][j][k]))
+                            {
+                                use_pxl_val = false;
+                            }
+                            else if (this->useNoDataVal && dataBlock[i][j][k] == this->
                                 noDataVal)
                             {
                                 use_pxl_val = false;
@@ -405,13 +751,51 @@ namespace rsgis
             std::cout << "No Image to output\n";
         }
 
+        unsigned int RSGISStdDevFilter::getNumSumTerms()
+        {
+            return 2;
+        }
+
+        bool RSGISStdDevFilter::calcSumTerms(float val, double *terms)
+        {
+            if (this->useNoDataVal && (val == this->noDataVal))
+            {
+                return false;
+            }
+            terms[0] = val - this->termsOffset;
+            terms[1] = terms[0] * terms[0];
+            return true;
+        }
+
+        double RSGISStdDevFilter::calcTermsOffset(float val)
+        {
+            return val;
+        }
+
+        double RSGISStdDevFilter::calcSumsValue(
+            unsigned long numVals, double *sums, float centreVal
+        )
+        {
+            if (numVals == 0)
+            {
+                return this->noDataVal;
+            }
+            double offMean = sums[0] / numVals;
+            double variance = (sums[1] / numVals) - (offMean * offMean);
+            if (variance < 0)
+            {
+                variance = 0;
+            }
+            return sqrt(variance);
+        }
+
         RSGISStdDevFilter::~RSGISStdDevFilter()
         {}
 
         RSGISCoeffOfVarFilter::RSGISCoeffOfVarFilter(
             int numberOutBands, int size, std::string filenameEnding, bool useNoDataVal,
             float noDataVal
-        ) : RSGISImageFilter(numberOutBands, size, filenameEnding)
+        ) : RSGISWindowSumsFilter(numberOutBands, size, filenameEnding)
         {
             this->useNoDataVal = useNoDataVal;
             this->noDataVal = noDataVal;
@@ -434,6 +818,7 @@ namespace rsgis
             for (int i = 0; i < numBands; i++)
             {
                 outputValue = 0;
+                numberElements = 0;
                 squSum = 0;
 
                 for (int j = 0; j < this->size; j++)
@@ -441,7 +826,11 @@ namespace rsgis
                     for (int k = 0; k < this->size; k++)
                     {
                         use_pxl_val = true;
-                        if (this->useNoDataVal && dataBlock[i][j][k] == this->noDataVal)
+                        if (!std::isfinite(dataBlock[i][j][k]))
+                        {
+                            use_pxl_val = false;
+                        }
+                        else if (this->useNoDataVal && dataBlock[i][j][k] == this->noDataVal)
                         {
                             use_pxl_val = false;
                         }
@@ -462,7 +851,11 @@ namespace rsgis
                         for (int k = 0; k < this->size; k++)
                         {
                             use_pxl_val = true;
-                            if (this->useNoDataVal && dataBlock[i][j][k] == this->
+                            if (!std::isfinite(dataBlock[i][j][k]))
+                            {
+                                use_pxl_val = false;
+                            }
+                            else if (this->useNoDataVal && dataBlock[i][j][k] == this->
                                 noDataVal)
                             {
                                 use_pxl_val = false;
@@ -497,6 +890,45 @@ namespace rsgis
             std::cout << "No Image to output\n";
         }
 
+        unsigned int RSGISCoeffOfVarFilter::getNumSumTerms()
+        {
+            return 2;
+        }
+
+        bool RSGISCoeffOfVarFilter::calcSumTerms(float val, double *terms)
+        {
+            if (this->useNoDataVal && (val == this->noDataVal))
+            {
+                return false;
+            }
+            terms[0] = val - this->termsOffset;
+            terms[1] = terms[0] * terms[0];
+            return true;
+        }
+
+        double RSGISCoeffOfVarFilter::calcTermsOffset(float val)
+        {
+            return val;
+        }
+
+        double RSGISCoeffOfVarFilter::calcSumsValue(
+            unsigned long numVals, double *sums, float centreVal
+        )
+        {
+            if (numVals == 0)
+            {
+                return this->noDataVal;
+            }
+            double offMean = sums[0] / numVals;
+            double mean = this->termsOffset + offMean;
+            double variance = (sums[1] / numVals) - (offMean * offMean);
+            if (variance < 0)
+            {
+                variance = 0;
+            }
+            return sqrt(variance) / mean;
+        }
+
         RSGISCoeffOfVarFilter::~RSGISCoeffOfVarFilter()
         {}
 
@@ -660,7 +1092,7 @@ namespace rsgis
         RSGISTotalFilter::RSGISTotalFilter(
             int numberOutBands, int size, std::string filenameEnding, bool useNoDataVal,
             float noDataVal
-        ) : RSGISImageFilter(numberOutBands, size, filenameEnding)
+        ) : RSGISWindowSumsFilter(numberOutBands, size, filenameEnding)
         {
             this->useNoDataVal = useNoDataVal;
             this->noDataVal = noDataVal;
@@ -688,7 +1120,11 @@ namespace rsgis
                     for (int k = 0; k < this->size; k++)
                     {
                         use_pxl_val = true;
-                        if (this->useNoDataVal && dataBlock[i][j][k] == this->noDataVal)
+                        if (!std::isfinite(dataBlock[i][j][k]))
+                        {
+                            use_pxl_val = false;
+                        }
+                        else if (this->useNoDataVal && dataBlock[i][j][k] == this->noDataVal)
                         {
                             use_pxl_val = false;
                         }
@@ -722,6 +1158,32 @@ namespace rsgis
             std::cout << "No Image to output\n";
         }
 
+        unsigned int RSGISTotalFilter::getNumSumTerms()
+        {
+            return 1;
+        }
+
+        bool RSGISTotalFilter::calcSumTerms(float val, double *terms)
+        {
+            if (this->useNoDataVal && (val == this->noDataVal))
+            {
+                return false;
+            }
+            terms[0] = val;
+            return true;
+        }
+
+        double RSGISTotalFilter::calcSumsValue(
+            unsigned long numVals, double *sums, float centreVal
+        )
+        {
+            if (numVals == 0)
+            {
+                return this->noDataVal;
+            }
+            return sums[0];
+        }
+
         RSGISTotalFilter::~RSGISTotalFilter()
         {}
 
@@ -26,6 +26,7 @@
 #include <iostream>
 #include <vector>
 #include <algorithm>
+#include <cmath>
 
 #include "common/RSGISImageException.h"
 
@@ -33,6 +34,8 @@
 #include "img/RSGISImageCalcException.h"
 #include "img/RSGISCalcImageValue.h"
 #include "filtering/RSGISImageFilter.h"
+#include "filtering/RSGISImageRowFilter.h"
+#include "filtering/RSGISWindowSumsFilter.h"
 
 #include "datastruct/SortedGenericList.cpp"
 
@@ -53,7 +56,7 @@ namespace rsgis
 {
     namespace filter
     {
-        class DllExport RSGISMeanFilter : public RSGISImageFilter
+        class DllExport RSGISMeanFilter : public RSGISWindowSumsFilter
         {
         public:
             RSGISMeanFilter(
@@ -74,11 +77,51 @@ namespace rsgis
             ~RSGISMeanFilter();
 
         protected:
+            virtual unsigned int getNumSumTerms();
+
+            virtual bool calcSumTerms(float val, double *terms);
+
+            virtual double calcSumsValue(
+                unsigned long numVals, double *sums, float centreVal
+            );
+
             bool useNoDataVal;
             float noDataVal;
         };
 
-        class DllExport RSGISMedianFilter : public RSGISImageFilter
+        /**
+         * Base class for filters which return an order statistic (i.e., the k-th
+         * smallest valid value) of the window. Each output row is processed by
+         * ranking the valid values within the window rows and sliding a Fenwick
+         * tree of rank counts along the row, so moving the window one pixel costs
+         * O(size log n) rather than a full sort of the window.
+         */
+        class DllExport RSGISOrderStatFilter : public RSGISImageRowFilter
+        {
+        public:
+            RSGISOrderStatFilter(
+                int numberOutBands, int size, std::string filenameEnding,
+                bool useNoDataVal, float noDataVal
+            );
+
+            virtual void calcRowValues(
+                float **winRows, int width, int band, double *output
+            );
+
+            virtual ~RSGISOrderStatFilter();
+
+        protected:
+            /** Returns the (zero based) index of the required value within nVals sorted values. */
+            virtual size_t getOrderStatIdx(size_t nVals) = 0;
+
+            bool useNoDataVal;
+            float noDataVal;
+            std::vector<float> rowVals;
+            std::vector<int> rowRanks;
+            std::vector<unsigned int> rankCounts;
+        };
+
+        class DllExport RSGISMedianFilter : public RSGISOrderStatFilter
         {
         public:
             RSGISMedianFilter(
@@ -99,11 +142,45 @@ namespace rsgis
             ~RSGISMedianFilter();
 
         protected:
-            bool useNoDataVal;
-            float noDataVal;
+            virtual size_t getOrderStatIdx(size_t nVals);
+        };
+
+        /**
+         * Percentile filter using the nearest-rank definition, i.e., the value
+         * at index ceil((percentile/100) * n) - 1 of the n sorted valid values.
+         */
+        class DllExport RSGISPercentileFilter : public RSGISOrderStatFilter
+        {
+        public:
+            RSGISPercentileFilter(
+                int numberOutBands, int size, std::string filenameEnding,
+                bool useNoDataVal, float noDataVal, float percentile
+            );
+
+            virtual void calcImageValue(
+                float ***dataBlock, int numBands, int winSize, double *output
+            );
+
+            virtual bool calcImageValueCondition(
+                float ***dataBlock, int numBands, int winSize, double *output
+            );
+
+            virtual void exportAsImage(std::string filename);
+
+            ~RSGISPercentileFilter();
+
+        protected:
+            virtual size_t getOrderStatIdx(size_t nVals);
+
+            float percentile;
         };
 
-        class DllExport RSGISModeFilter : public RSGISImageFilter
+        /**
+         * Mode filter. Where more than one value shares the highest count the
+         * smallest of those values is returned. Rows are processed with a
+         * segment tree over the ranked values holding the maximum count.
+         */
+        class DllExport RSGISModeFilter : public RSGISImageRowFilter
         {
         public:
             RSGISModeFilter(
@@ -119,13 +196,24 @@ namespace rsgis
                 float ***dataBlock, int numBands, int winSize, double *output
             );
 
+            virtual void calcRowValues(
+                float **winRows, int width, int band, double *output
+            );
+
             virtual void exportAsImage(std::string filename);
 
             ~RSGISModeFilter();
 
         protected:
+            void updateModeCount(size_t rank, int change);
+
             bool useNoDataVal;
             float noDataVal;
+            std::vector<float> rowVals;
+            std::vector<int> rowRanks;
+            std::vector<unsigned int> modeCounts;
+            std::vector<unsigned int> modeIdxs;
+            size_t modeLeafOff;
         };
 
         class DllExport RSGISRangeFilter : public RSGISImageFilter
@@ -153,7 +241,7 @@ namespace rsgis
             float noDataVal;
         };
 
-        class DllExport RSGISStdDevFilter : public RSGISImageFilter
+        class DllExport RSGISStdDevFilter : public RSGISWindowSumsFilter
         {
         public:
             RSGISStdDevFilter(
@@ -174,11 +262,21 @@ namespace rsgis
             ~RSGISStdDevFilter();
 
         protected:
+            virtual unsigned int getNumSumTerms();
+
+            virtual bool calcSumTerms(float val, double *terms);
+
+            virtual double calcTermsOffset(float val);
+
+            virtual double calcSumsValue(
+                unsigned long numVals, double *sums, float centreVal
+            );
+
             bool useNoDataVal;
             float noDataVal;
         };
 
-        class DllExport RSGISCoeffOfVarFilter : public RSGISImageFilter
+        class DllExport RSGISCoeffOfVarFilter : public RSGISWindowSumsFilter
         {
             /**
 
@@ -205,6 +303,16 @@ namespace rsgis
             ~RSGISCoeffOfVarFilter();
 
         protected:
+            virtual unsigned int getNumSumTerms();
+
+            virtual bool calcSumTerms(float val, double *terms);
+
+            virtual double calcTermsOffset(float val);
+
+            virtual double calcSumsValue(
+                unsigned long numVals, double *sums, float centreVal
+            );
+
             bool useNoDataVal;
             float noDataVal;
         };
@@ -259,7 +367,7 @@ namespace rsgis
             float noDataVal;
         };
 
-        class DllExport RSGISTotalFilter : public RSGISImageFilter
+        class DllExport RSGISTotalFilter : public RSGISWindowSumsFilter
         {
         public:
             RSGISTotalFilter(
@@ -280,6 +388,14 @@ namespace rsgis
             ~RSGISTotalFilter();
 
         protected:
+            virtual unsigned int getNumSumTerms();
+
+            virtual bool calcSumTerms(float val, double *terms);
+
+            virtual double calcSumsValue(
+                unsigned long numVals, double *sums, float centreVal
+            );
+
             bool useNoDataVal;
             float noDataVal;
         };
@@ -0,0 +1,231 @@
+/*
+ *  RSGISWindowSumsFilter.cpp
+ *  RSGIS_LIB
+ *
+ *  Created by Pete Bunting on 17/10/2026.
+ *  Copyright 2026 RSGISLib.
+ *
+ *  RSGISLib is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  RSGISLib is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with RSGISLib.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "RSGISWindowSumsFilter.h"
+
+namespace rsgis
+{
+    namespace filter
+    {
+        RSGISWindowSumsFilter::RSGISWindowSumsFilter(
+            int numberOutBands, int size, std::string filenameEnding
+        ) : RSGISImageRowFilter(numberOutBands, size, filenameEnding)
+        {
+            this->numTerms = 0;
+            this->termsOffset = 0;
+        }
+
+        void RSGISWindowSumsFilter::initRowFilter(int numBands, int width)
+        {
+            // Term 0 is the count of valid pixels.
+            this->numTerms = this->getNumSumTerms() + 1;
+            size_t paddedWidth = width + (this->size - 1);
+            this->termRows.assign(
+                numBands, std::vector<double>(this->size * paddedWidth * this->numTerms, 0)
+            );
+            this->colSums.assign(
+                numBands, std::vector<double>(paddedWidth * this->numTerms, 0)
+            );
+            this->rowCounts.assign(numBands, 0);
+            this->winSums.assign(this->numTerms, 0);
+            this->bandOffsets.assign(numBands, 0);
+            this->bandOffsetSet.assign(numBands, false);
+            this->termsOffset = 0;
+        }
+
+        double RSGISWindowSumsFilter::calcTermsOffset(float val)
+        {
+            return 0;
+        }
+
+        bool RSGISWindowSumsFilter::findBandOffset(float *inRow, int width, int band)
+        {
+            // Only the image pixels are checked, not the zero padding columns.
+            int windowMid = this->size / 2;
+            this->termsOffset = 0;
+            double *terms = this->winSums.data();
+            for (int x = 0; x < width; x++)
+            {
+                float val = inRow[x + windowMid];
+                if (this->calcSumTerms(val, terms))
+                {
+                    bool allFinite = true;
+                    for (unsigned int t = 0; t < (this->numTerms - 1); t++)
+                    {
+                        if (!std::isfinite(terms[t]))
+                        {
+                            allFinite = false;
+                        }
+                    }
+                    if (allFinite)
+                    {
+                        this->bandOffsets[band] = this->calcTermsOffset(val);
+                        this->bandOffsetSet[band] = true;
+                        return true;
+                    }
+                }
+            }
+            return false;
+        }
+
+        void RSGISWindowSumsFilter::calcTermsRow(
+            float *inRow, size_t paddedWidth, int band, double *termsRow
+        )
+        {
+            this->termsOffset = this->bandOffsets[band];
+
+            for (size_t k = 0; k < paddedWidth; k++)
+            {
+                double *terms = &termsRow[k * this->numTerms];
+                if (this->calcSumTerms(inRow[k], &terms[1]))
+                {
+                    terms[0] = 1;
+                    for (unsigned int t = 1; t < this->numTerms; t++)
+                    {
+                        if (!std::isfinite(terms[t]))
+                        {
+                            terms[0] = 0;
+                        }
+                    }
+                }
+                else
+                {
+                    terms[0] = 0;
+                }
+
+                if (terms[0] == 0)
+                {
+                    for (unsigned int t = 1; t < this->numTerms; t++)
+                    {
+                        terms[t] = 0;
+                    }
+                }
+            }
+        }
+
+        void RSGISWindowSumsFilter::calcRowValues(
+            float **winRows, int width, int band, double *output
+        )
+        {
+            if (this->numTerms == 0)
+            {
+                throw RSGISImageFilterException(
+                    "initRowFilter must be called before calcRowValues."
+                );
+            }
+            size_t paddedWidth = width + (this->size - 1);
+            size_t rowLen = paddedWidth * this->numTerms;
+            int windowMid = this->size / 2;
+            double *termRows = this->termRows[band].data();
+            double *colSums = this->colSums[band].data();
+            unsigned long rowIdx = this->rowCounts[band] % this->size;
+
+            bool offsetFound = false;
+            if (!this->bandOffsetSet[band])
+            {
+                // The offset is taken from the first valid image pixel of the
+                // band, checking the rows which are new to the window and are
+                // within the image (the rows above the image are padding).
+                int firstRow = this->size - 1;
+                if (this->rowCounts[band] == 0)
+                {
+                    firstRow = windowMid;
+                }
+                for (int j = firstRow; (j < this->size) && (!offsetFound); j++)
+                {
+                    offsetFound = this->findBandOffset(winRows[j], width, band);
+                }
+            }
+
+            if ((rowIdx == 0) || offsetFound)
+            {
+                // Recalculate the column sums from all the window rows, which
+                // is also needed when the offset has changed. The window row j
+                // is held in the ring buffer slot (j + rowIdx) % size.
+                for (size_t k = 0; k < rowLen; k++)
+                {
+                    colSums[k] = 0;
+                }
+                for (int j = 0; j < this->size; j++)
+                {
+                    double *termsRow = &termRows[((j + rowIdx) % this->size) * rowLen];
+                    this->calcTermsRow(winRows[j], paddedWidth, band, termsRow);
+                    for (size_t k = 0; k < rowLen; k++)
+                    {
+                        colSums[k] += termsRow[k];
+                    }
+                }
+            }
+            else
+            {
+                // Replace the row which has left the top of the window with
+                // the row which has entered at the bottom.
+                double *termsRow = &termRows[(rowIdx - 1) * rowLen];
+                for (size_t k = 0; k < rowLen; k++)
+                {
+                    colSums[k] -= termsRow[k];
+                }
+                this->calcTermsRow(winRows[this->size - 1], paddedWidth, band, termsRow);
+                for (size_t k = 0; k < rowLen; k++)
+                {
+                    colSums[k] += termsRow[k];
+                }
+            }
+            ++this->rowCounts[band];
+
+            double *sums = this->winSums.data();
+            for (int x = 0; x < width; x++)
+            {
+                if ((x % this->size) == 0)
+                {
+                    for (unsigned int t = 0; t < this->numTerms; t++)
+                    {
+                        sums[t] = 0;
+                    }
+                    for (int c = x; c < (x + this->size); c++)
+                    {
+                        for (unsigned int t = 0; t < this->numTerms; t++)
+                        {
+                            sums[t] += colSums[(c * this->numTerms) + t];
+                        }
+                    }
+                }
+                else
+                {
+                    size_t addOff = (x + this->size - 1) * this->numTerms;
+                    size_t remOff = (x - 1) * this->numTerms;
+                    for (unsigned int t = 0; t < this->numTerms; t++)
+                    {
+                        sums[t] += colSums[addOff + t] - colSums[remOff + t];
+                    }
+                }
+
+                output[x] = this->calcSumsValue(
+                    (unsigned long) (sums[0] + 0.5), &sums[1], winRows[windowMid][x + windowMid]
+                );
+            }
+        }
+
+        RSGISWindowSumsFilter::~RSGISWindowSumsFilter()
+        {}
+    }
+}
@@ -0,0 +1,129 @@
+/*
+ *  RSGISWindowSumsFilter.h
+ *  RSGIS_LIB
+ *
+ *  Created by Pete Bunting on 17/10/2026.
+ *  Copyright 2026 RSGISLib.
+ *
+ *  RSGISLib is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  RSGISLib is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with RSGISLib.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef RSGISWindowSumsFilter_H
+#define RSGISWindowSumsFilter_H
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "filtering/RSGISImageRowFilter.h"
+
+// mark all exported classes/functions with DllExport to have
+// them exported by Visual Studio
+#undef DllExport
+#ifdef _MSC_VER
+    #ifdef rsgis_filter_EXPORTS
+        #define DllExport   __declspec( dllexport )
+    #else
+        #define DllExport   __declspec( dllimport )
+    #endif
+#else
+    #define DllExport
+#endif
+
+namespace rsgis
+{
+    namespace filter
+    {
+        /**
+         * Base class for filters which can be calculated from sums over the
+         * window (e.g., the count, sum and sum of squares). Each pixel is
+         * converted into a set of terms, which are accumulated into running
+         * column sums down the image and running window sums along each row,
+         * so the cost per pixel does not depend on the window size. Pixels
+         * for which calcSumTerms returns false (i.e., no data) are counted
+         * separately so are excluded from the sums.
+         *
+         * The column and window sums are recalculated from scratch every
+         * 'size' rows and columns respectively, which stops rounding error
+         * accumulating without changing the amortised cost.
+         *
+         * Filters which sum powers of a value (e.g., the variance from the sum
+         * and sum of squares) can return an offset from calcTermsOffset and
+         * subtract termsOffset when calculating their terms. The offset is
+         * taken from the first valid image pixel (i.e., not the zero padding)
+         * of each band, so the terms are
+         * centred near zero and the moments do not suffer the cancellation of
+         * E[x^2] - E[x]^2 when the mean is large relative to the spread.
+         */
+        class DllExport RSGISWindowSumsFilter : public RSGISImageRowFilter
+        {
+        public:
+            RSGISWindowSumsFilter(int numberOutBands, int size, std::string filenameEnding);
+
+            virtual void initRowFilter(int numBands, int width);
+
+            virtual void calcRowValues(
+                float **winRows, int width, int band, double *output
+            );
+
+            virtual ~RSGISWindowSumsFilter();
+
+        protected:
+            /** The number of terms returned by calcSumTerms. */
+            virtual unsigned int getNumSumTerms() = 0;
+
+            /**
+             * Calculate the terms to be summed for a pixel value, returning
+             * false if the pixel should not be included in the window sums.
+             */
+            virtual bool calcSumTerms(float val, double *terms) = 0;
+
+            /**
+             * Calculate the output value from the number of valid pixels in the
+             * window, the window sums of each term and the window centre value.
+             */
+            virtual double calcSumsValue(
+                unsigned long numVals, double *sums, float centreVal
+            ) = 0;
+
+            /**
+             * The offset used for the terms of a band given its first valid
+             * pixel value. The default is 0 (i.e., no offset).
+             */
+            virtual double calcTermsOffset(float val);
+
+            /**
+             * Set the offset of the band from the first valid image pixel
+             * within a window row, returning false if there is none.
+             */
+            bool findBandOffset(float *inRow, int width, int band);
+
+            void calcTermsRow(
+                float *inRow, size_t paddedWidth, int band, double *termsRow
+            );
+
+            unsigned int numTerms;
+            std::vector< std::vector<double> > termRows;
+            std::vector< std::vector<double> > colSums;
+            std::vector<unsigned long> rowCounts;
+            std::vector<double> winSums;
+            std::vector<double> bandOffsets;
+            std::vector<bool> bandOffsetSet;
+            double termsOffset;
+        };
+    }
+}
+
+#endif
@@ -24,7 +24,7 @@
 
 namespace rsgis{namespace img{
 
-	RSGISBandMath::RSGISBandMath(int numberOutBands, VariableBands **variables, int numVariables, mu::Parser *muParser) : RSGISCalcImageValue(numberOutBands)
+	RSGISBandMath::RSGISBandMath(int numberOutBands, VariableBands **variables, int numVariables, mu::Parser *muParser, bool useBulkEval) : RSGISCalcImageValue(numberOutBands)
 	{
 		this->variables = variables;
 		this->numVariables = numVariables;
@@ -35,7 +35,11 @@ namespace rsgis{namespace img{
 		{
 			muParser->DefineVar(_T(variables[i]->name.c_str()), &inVals[i]);
 		}
-		
+		this->clonedParser = NULL;
+		this->useBulkEval = useBulkEval;
+		this->bulkVals = NULL;
+		this->bulkValsSize = 0;
+		this->bulkVarsBound = false;
 	}
 
 	void RSGISBandMath::calcImageValue(float *bandValues, int numBands, double *output) 
@@ -47,6 +51,10 @@ namespace rsgis{namespace img{
 		
 		try 
 		{
+			if(bulkVarsBound)
+			{
+				this->bindPxlVars();
+			}
 			for(int i = 0; i < numVariables; ++i)
 			{
 				inVals[i] = bandValues[variables[i]->band];
@@ -63,16 +71,107 @@ namespace rsgis{namespace img{
 		}
 	}
 
+	void RSGISBandMath::calcImageValueBlock(float **blockData, int numBands, int width, int height, double **output)
+	{
+		if(!this->useBulkEval)
+		{
+			RSGISCalcImageValue::calcImageValueBlock(blockData, numBands, width, height, output);
+			return;
+		}
+		
+		if(numOutBands != 1)
+		{
+			throw RSGISImageCalcException("Incorrect number of output Image bands (should be equal to 1).");
+		}
+		
+		size_t numPxls = ((size_t)width) * ((size_t)height);
+		if(numPxls == 0)
+		{
+			return;
+		}
+		
+		try
+		{
+			this->bindBulkVars(numPxls);
+			for(int i = 0; i < numVariables; ++i)
+			{
+				float *inBandVals = blockData[variables[i]->band];
+				mu::value_type *varVals = &bulkVals[i*bulkValsSize];
+				for(size_t j = 0; j < numPxls; ++j)
+				{
+					varVals[j] = inBandVals[j];
+				}
+			}
+			muParser->Eval(output[0], (int)numPxls);
+		}
+		catch (mu::ParserError &e)
+		{
+			std::string message = std::string("ERROR: ") + std::string(e.GetMsg()) + std::string(":\t \'") + std::string(e.GetExpr()) + std::string("\'");
+			throw RSGISImageCalcException(message);
+		}
+	}
+	
+	void RSGISBandMath::bindBulkVars(size_t numPxls)
+	{
+		// muParser reads bulk variable values from (variable pointer + pixel index)
+		// so each variable needs a contiguous array of at least numPxls values.
+		if(numPxls > bulkValsSize)
+		{
+			if(bulkVals != NULL)
+			{
+				delete[] bulkVals;
+			}
+			bulkVals = new mu::value_type[((size_t)numVariables)*numPxls];
+			bulkValsSize = numPxls;
+			bulkVarsBound = false;
+		}
+		
+		if(!bulkVarsBound)
+		{
+			for(int i = 0; i < numVariables; ++i)
+			{
+				muParser->DefineVar(_T(variables[i]->name.c_str()), &bulkVals[i*bulkValsSize]);
+			}
+			bulkVarsBound = true;
+		}
+	}
+	
+	void RSGISBandMath::bindPxlVars()
+	{
+		for(int i = 0; i < numVariables; ++i)
+		{
+			muParser->DefineVar(_T(variables[i]->name.c_str()), &inVals[i]);
+		}
+		bulkVarsBound = false;
+	}
+
+	RSGISCalcImageValue* RSGISBandMath::clone()
+	{
+		// The parser copy is re-bound to the variables of the new object in its constructor.
+		mu::Parser *parserCopy = new mu::Parser(*this->muParser);
+		RSGISBandMath *bandMathClone = new RSGISBandMath(this->numOutBands, this->variables, this->numVariables, parserCopy, this->useBulkEval);
+		bandMathClone->clonedParser = parserCopy;
+		return bandMathClone;
+	}
+
 	RSGISBandMath::~RSGISBandMath()
 	{
         delete[] inVals;
+        if(bulkVals != NULL)
+        {
+            delete[] bulkVals;
+        }
+        if(clonedParser != NULL)
+        {
+            delete clonedParser;
+        }
 	}
     
     
     
     
     
-    RSGISCalcPropExpTruePxls::RSGISCalcPropExpTruePxls(VariableBands **variables, int numVariables, mu::Parser *muParser, bool useMask):RSGISCalcImageValue(0)
+    RSGISCalcPropExpTruePxls::RSGISCalcPropExpTruePxls(VariableBands **variables, int numVariables, mu::Parser *muParser, bool useMask, bool useBulkEval):RSGISCalcImageValue(0)
     {
         this->variables = variables;
         this->numVariables = numVariables;
@@ -87,6 +186,12 @@ namespace rsgis{namespace img{
         
         this->truePxlCount = 0.0;
         this->totalPxlCount = 0.0;
+        
+        this->useBulkEval = useBulkEval;
+        this->bulkVals = NULL;
+        this->bulkResults = NULL;
+        this->bulkValsSize = 0;
+        this->bulkVarsBound = false;
     }
 
     void RSGISCalcPropExpTruePxls::calcImageValue(float *bandValues, int numBands) 
@@ -95,6 +200,10 @@ namespace rsgis{namespace img{
         {
             if((!this->useMask) | (this->useMask & (bandValues[0] == 1)))
             {
+                if(bulkVarsBound)
+                {
+                    this->bindPxlVars();
+                }
                 for(int i = 0; i < numVariables; ++i)
                 {
                     inVals[i] = bandValues[variables[i]->band];
@@ -117,6 +226,92 @@ namespace rsgis{namespace img{
         }
     }
     
+    void RSGISCalcPropExpTruePxls::calcImageValueBlock(float **blockData, int numBands, int width, int height)
+    {
+        if(!this->useBulkEval)
+        {
+            RSGISCalcImageValue::calcImageValueBlock(blockData, numBands, width, height);
+            return;
+        }
+        
+        size_t numPxls = ((size_t)width) * ((size_t)height);
+        if(numPxls == 0)
+        {
+            return;
+        }
+        
+        try
+        {
+            this->bindBulkVars(numPxls);
+            
+            // Only pixels within the mask are copied into the variable arrays.
+            size_t numValidPxls = 0;
+            for(size_t j = 0; j < numPxls; ++j)
+            {
+                if((!this->useMask) | (this->useMask & (blockData[0][j] == 1)))
+                {
+                    for(int i = 0; i < numVariables; ++i)
+                    {
+                        bulkVals[(i*bulkValsSize)+numValidPxls] = blockData[variables[i]->band][j];
+                    }
+                    ++numValidPxls;
+                }
+            }
+            
+            if(numValidPxls > 0)
+            {
+                muParser->Eval(bulkResults, (int)numValidPxls);
+                for(size_t j = 0; j < numValidPxls; ++j)
+                {
+                    if(1 == floor(bulkResults[j]))
+                    {
+                        this->truePxlCount = this->truePxlCount + 1.0;
+                    }
+                }
+                this->totalPxlCount = this->totalPxlCount + numValidPxls;
+            }
+        }
+        catch (mu::ParserError &e)
+        {
+            std::string message = std::string("ERROR: ") + std::string(e.GetMsg()) + std::string(":\t \'") + std::string(e.GetExpr()) + std::string("\'");
+            throw RSGISImageCalcException(message);
+        }
+    }
+    
+    void RSGISCalcPropExpTruePxls::bindBulkVars(size_t numPxls)
+    {
+        if(numPxls > bulkValsSize)
+        {
+            if(bulkVals != NULL)
+            {
+                delete[] bulkVals;
+                delete[] bulkResults;
+            }
+            bulkVals = new mu::value_type[((size_t)numVariables)*numPxls];
+            bulkResults = new mu::value_type[numPxls];
+            bulkValsSize = numPxls;
+            bulkVarsBound = false;
+        }
+        
+        if(!bulkVarsBound)
+        {
+            for(int i = 0; i < numVariables; ++i)
+            {
+                muParser->DefineVar(_T(variables[i]->name.c_str()), &bulkVals[i*bulkValsSize]);
+            }
+            bulkVarsBound = true;
+        }
+    }
+    
+    void RSGISCalcPropExpTruePxls::bindPxlVars()
+    {
+        for(int i = 0; i < numVariables; ++i)
+        {
+            muParser->DefineVar(_T(variables[i]->name.c_str()), &inVals[i]);
+        }
+        bulkVarsBound = false;
+    }
+    
     float RSGISCalcPropExpTruePxls::getPropPxlVal()
     {
         return this->truePxlCount / this->totalPxlCount;
@@ -125,6 +320,11 @@ namespace rsgis{namespace img{
     RSGISCalcPropExpTruePxls::~RSGISCalcPropExpTruePxls()
     {
         delete[] inVals;
+        if(bulkVals != NULL)
+        {
+            delete[] bulkVals;
+            delete[] bulkResults;
+        }
     }
 
     
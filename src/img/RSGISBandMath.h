@@ -59,30 +59,51 @@ namespace rsgis{namespace img{
 	class DllExport RSGISBandMath : public RSGISCalcImageValue
 		{
 		public: 
-			RSGISBandMath(int numberOutBands, VariableBands **variables, int numVariables, mu::Parser *muParser);
+			/**
+			 * If useBulkEval is true then blocks of pixels are evaluated with a single call
+			 * to the muParser bulk mode Eval(results, n), rather than calling Eval() per pixel.
+			 */
+			RSGISBandMath(int numberOutBands, VariableBands **variables, int numVariables, mu::Parser *muParser, bool useBulkEval=true);
 			void calcImageValue(float *bandValues, int numBands, double *output);
+			void calcImageValueBlock(float **blockData, int numBands, int width, int height, double **output);
+			RSGISCalcImageValue* clone();
 			~RSGISBandMath();
 		private:
+			void bindBulkVars(size_t numPxls);
+			void bindPxlVars();
 			VariableBands **variables;
 			int numVariables;
             mu::Parser *muParser;
             mu::value_type *inVals;
+            mu::Parser *clonedParser;
+            bool useBulkEval;
+            mu::value_type *bulkVals;
+            size_t bulkValsSize;
+            bool bulkVarsBound;
 		};
     
     
     class DllExport RSGISCalcPropExpTruePxls : public RSGISCalcImageValue
     {
     public:
-        RSGISCalcPropExpTruePxls(VariableBands **variables, int numVariables, mu::Parser *muParser, bool useMask);
+        RSGISCalcPropExpTruePxls(VariableBands **variables, int numVariables, mu::Parser *muParser, bool useMask, bool useBulkEval=true);
         void calcImageValue(float *bandValues, int numBands);
+        void calcImageValueBlock(float **blockData, int numBands, int width, int height);
         float getPropPxlVal();
         ~RSGISCalcPropExpTruePxls();
     private:
+        void bindBulkVars(size_t numPxls);
+        void bindPxlVars();
         VariableBands **variables;
         int numVariables;
         mu::Parser *muParser;
         mu::value_type *inVals;
         bool useMask;
+        bool useBulkEval;
+        mu::value_type *bulkVals;
+        mu::value_type *bulkResults;
+        size_t bulkValsSize;
+        bool bulkVarsBound;
         double truePxlCount;
         double totalPxlCount;
     };
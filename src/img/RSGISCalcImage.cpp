@@ -24,12 +24,17 @@
 
 namespace rsgis{namespace img{
 	
-	RSGISCalcImage::RSGISCalcImage(RSGISCalcImageValue *valueCalc, std::string proj, bool useImageProj)
+	RSGISCalcImage::RSGISCalcImage(RSGISCalcImageValue *valueCalc, std::string proj, bool useImageProj, unsigned int numThreads)
 	{
 		this->calc = valueCalc;
 		this->numOutBands = valueCalc->getNumOutBands();
 		this->proj = proj;
 		this->useImageProj = useImageProj;
+		this->numThreads = numThreads;
+		if(this->numThreads == 0)
+		{
+			this->numThreads = 1;
+		}
 	}
     
     
@@ -52,8 +57,6 @@ namespace rsgis{namespace img{
 		
 		float **inputData = NULL;
 		double **outputData = NULL;
-		float *inDataColumn = NULL;
-		double *outDataColumn = NULL;
 		
 		GDALDataset *outputImageDS = NULL;
 		GDALRasterBand **inputRasterBands = NULL;
@@ -131,20 +134,24 @@ namespace rsgis{namespace img{
                 yBlockSize = outYBlockSize;
             }
             
+            if(this->getNumCalcThreads() > 1)
+            {
+                // Read enough rows for each thread to process a block of rows.
+                yBlockSize = yBlockSize * this->getNumCalcThreads();
+            }
+            
 			// Allocate memory
 			inputData = new float*[numInBands];
 			for(int i = 0; i < numInBands; i++)
 			{
 				inputData[i] = (float *) CPLMalloc(sizeof(float)*(width*yBlockSize));
 			}
-			inDataColumn = new float[numInBands];
             
 			outputData = new double*[this->numOutBands];
 			for(int i = 0; i < this->numOutBands; i++)
 			{
 				outputData[i] = (double *) CPLMalloc(sizeof(double)*(width*yBlockSize));
 			}
-			outDataColumn = new double[this->numOutBands];
                       
             int nYBlocks = floor(((double)height) / ((double)yBlockSize));
             int remainRows = height - (nYBlocks * yBlockSize);
@@ -160,26 +167,7 @@ namespace rsgis{namespace img{
 					inputRasterBands[n]->RasterIO(GF_Read, bandOffsets[n][0], rowOffset, width, yBlockSize, inputData[n], width, yBlockSize, GDT_Float32, 0, 0);
 				}
                 
-                for(int m = 0; m < yBlockSize; ++m)
-                {
-                    pbar.progress((i*yBlockSize)+m, height);
-                                        
-                    for(int j = 0; j < width; j++)
-                    {
-                        for(int n = 0; n < numInBands; n++)
-                        {
-                            inDataColumn[n] = inputData[n][(m*width)+j];
-                        }
-                        
-                        this->calc->calcImageValue(inDataColumn, numInBands, outDataColumn);
-                        
-                        for(int n = 0; n < this->numOutBands; n++)
-                        {
-                            outputData[n][(m*width)+j] = outDataColumn[n];
-                        }
-                        
-                    }
-                }
+                this->calcImageValueBlock(inputData, numInBands, outputData, width, yBlockSize, &pbar, i*yBlockSize, height);
 				
 				for(int n = 0; n < this->numOutBands; n++)
 				{
@@ -196,26 +184,7 @@ namespace rsgis{namespace img{
 					inputRasterBands[n]->RasterIO(GF_Read, bandOffsets[n][0], rowOffset, width, remainRows, inputData[n], width, remainRows, GDT_Float32, 0, 0);
 				}
                                 
-                for(int m = 0; m < remainRows; ++m)
-                {
-                    pbar.progress((nYBlocks*yBlockSize)+m, height);
-                    
-                    for(int j = 0; j < width; j++)
-                    {
-                        for(int n = 0; n < numInBands; n++)
-                        {
-                            inDataColumn[n] = inputData[n][(m*width)+j];
-                        }
-                        
-                        this->calc->calcImageValue(inDataColumn, numInBands, outDataColumn);
-                        
-                        for(int n = 0; n < this->numOutBands; n++)
-                        {
-                            outputData[n][(m*width)+j] = outDataColumn[n];
-                        }
-                        
-                    }
-                }
+                this->calcImageValueBlock(inputData, numInBands, outputData, width, remainRows, &pbar, nYBlocks*yBlockSize, height);
 				
 				for(int n = 0; n < this->numOutBands; n++)
 				{
@@ -280,16 +249,6 @@ namespace rsgis{namespace img{
 				delete[] outputData;
 			}
 			
-			if(inDataColumn != NULL)
-			{
-				delete[] inDataColumn;
-			}
-			
-			if(outDataColumn != NULL)
-			{
-				delete[] outDataColumn;
-			}
-			
 			if(inputRasterBands != NULL)
 			{
 				delete[] inputRasterBands;
@@ -356,16 +315,6 @@ namespace rsgis{namespace img{
 				delete[] outputData;
 			}
 			
-			if(inDataColumn != NULL)
-			{
-				delete[] inDataColumn;
-			}
-			
-			if(outDataColumn != NULL)
-			{
-				delete[] outDataColumn;
-			}
-			
 			if(inputRasterBands != NULL)
 			{
 				delete[] inputRasterBands;
@@ -433,16 +382,6 @@ namespace rsgis{namespace img{
 			delete[] outputData;
 		}
 		
-		if(inDataColumn != NULL)
-		{
-			delete[] inDataColumn;
-		}
-		
-		if(outDataColumn != NULL)
-		{
-			delete[] outDataColumn;
-		}
-		
 		if(inputRasterBands != NULL)
 		{
 			delete[] inputRasterBands;
@@ -934,8 +873,6 @@ namespace rsgis{namespace img{
 		
 		float **inputData = NULL;
 		double **outputData = NULL;
-		float *inDataColumn = NULL;
-		double *outDataColumn = NULL;
         int xBlockSize = 0;
         int yBlockSize = 0;
 		
@@ -1000,20 +937,24 @@ namespace rsgis{namespace img{
                 yBlockSize = outYBlockSize;
             }
             
+            if(this->getNumCalcThreads() > 1)
+            {
+                // Read enough rows for each thread to process a block of rows.
+                yBlockSize = yBlockSize * this->getNumCalcThreads();
+            }
+            
 			// Allocate memory
 			inputData = new float*[numInBands];
 			for(int i = 0; i < numInBands; i++)
 			{
 				inputData[i] = (float *) CPLMalloc(sizeof(float)*width*yBlockSize);
 			}
-			inDataColumn = new float[numInBands];
             
 			outputData = new double*[this->numOutBands];
 			for(int i = 0; i < this->numOutBands; i++)
 			{
 				outputData[i] = (double *) CPLMalloc(sizeof(double)*width*yBlockSize);
 			}
-			outDataColumn = new double[this->numOutBands];
             
 			int nYBlocks = height / yBlockSize;
             int remainRows = height - (nYBlocks * yBlockSize);
@@ -1029,26 +970,7 @@ namespace rsgis{namespace img{
 					inputRasterBands[n]->RasterIO(GF_Read, bandOffsets[n][0], rowOffset, width, yBlockSize, inputData[n], width, yBlockSize, GDT_Float32, 0, 0);
 				}
                 
-                for(int m = 0; m < yBlockSize; ++m)
-                {
-                    pbar.progress((i*yBlockSize)+m, height);
-                    
-                    for(int j = 0; j < width; j++)
-                    {
-                        for(int n = 0; n < numInBands; n++)
-                        {
-                            inDataColumn[n] = inputData[n][(m*width)+j];
-                        }
-                        
-                        this->calc->calcImageValue(inDataColumn, numInBands, outDataColumn);
-                        
-                        for(int n = 0; n < this->numOutBands; n++)
-                        {
-                            outputData[n][(m*width)+j] = outDataColumn[n];
-                        }
-                        
-                    }
-                }
+                this->calcImageValueBlock(inputData, numInBands, outputData, width, yBlockSize, &pbar, i*yBlockSize, height);
 				
 				for(int n = 0; n < this->numOutBands; n++)
 				{
@@ -1065,26 +987,7 @@ namespace rsgis{namespace img{
 					inputRasterBands[n]->RasterIO(GF_Read, bandOffsets[n][0], rowOffset, width, remainRows, inputData[n], width, remainRows, GDT_Float32, 0, 0);
 				}
                 
-                for(int m = 0; m < remainRows; ++m)
-                {
-                    pbar.progress((nYBlocks*yBlockSize)+m, height);
-                    
-                    for(int j = 0; j < width; j++)
-                    {
-                        for(int n = 0; n < numInBands; n++)
-                        {
-                            inDataColumn[n] = inputData[n][(m*width)+j];
-                        }
-                        
-                        this->calc->calcImageValue(inDataColumn, numInBands, outDataColumn);
-                        
-                        for(int n = 0; n < this->numOutBands; n++)
-                        {
-                            outputData[n][(m*width)+j] = outDataColumn[n];
-                        }
-                        
-                    }
-                }
+                this->calcImageValueBlock(inputData, numInBands, outputData, width, remainRows, &pbar, nYBlocks*yBlockSize, height);
 				
 				for(int n = 0; n < this->numOutBands; n++)
 				{
@@ -1149,16 +1052,6 @@ namespace rsgis{namespace img{
 				delete[] outputData;
 			}
 			
-			if(inDataColumn != NULL)
-			{
-				delete[] inDataColumn;
-			}
-			
-			if(outDataColumn != NULL)
-			{
-				delete[] outDataColumn;
-			}
-			
 			if(inputRasterBands != NULL)
 			{
 				delete[] inputRasterBands;
@@ -1225,16 +1118,6 @@ namespace rsgis{namespace img{
 				delete[] outputData;
 			}
 			
-			if(inDataColumn != NULL)
-			{
-				delete[] inDataColumn;
-			}
-			
-			if(outDataColumn != NULL)
-			{
-				delete[] outDataColumn;
-			}
-			
 			if(inputRasterBands != NULL)
 			{
 				delete[] inputRasterBands;
@@ -1300,16 +1183,6 @@ namespace rsgis{namespace img{
 			delete[] outputData;
 		}
 		
-		if(inDataColumn != NULL)
-		{
-			delete[] inDataColumn;
-		}
-		
-		if(outDataColumn != NULL)
-		{
-			delete[] outDataColumn;
-		}
-		
 		if(inputRasterBands != NULL)
 		{
 			delete[] inputRasterBands;
@@ -1338,8 +1211,6 @@ namespace rsgis{namespace img{
         
         float **inputData = NULL;
         double **outputData = NULL;
-        float *inDataColumn = NULL;
-        double *outDataColumn = NULL;
         int xBlockSize = 0;
         int yBlockSize = 0;
         
@@ -1402,20 +1273,24 @@ namespace rsgis{namespace img{
                 yBlockSize = outYBlockSize;
             }
             
+            if(this->getNumCalcThreads() > 1)
+            {
+                // Read enough rows for each thread to process a block of rows.
+                yBlockSize = yBlockSize * this->getNumCalcThreads();
+            }
+            
             // Allocate memory
             inputData = new float*[numInBands];
             for(int i = 0; i < numInBands; i++)
             {
                 inputData[i] = (float *) CPLMalloc(sizeof(float)*width*yBlockSize);
             }
-            inDataColumn = new float[numInBands];
             
             outputData = new double*[this->numOutBands];
             for(int i = 0; i < this->numOutBands; i++)
             {
                 outputData[i] = (double *) CPLMalloc(sizeof(double)*width*yBlockSize);
             }
-            outDataColumn = new double[this->numOutBands];
             
             int nYBlocks = height / yBlockSize;
             int remainRows = height - (nYBlocks * yBlockSize);
@@ -1431,26 +1306,7 @@ namespace rsgis{namespace img{
                     inputRasterBands[n]->RasterIO(GF_Read, bandOffsets[n][0], rowOffset, width, yBlockSize, inputData[n], width, yBlockSize, GDT_Float32, 0, 0);
                 }
                 
-                for(int m = 0; m < yBlockSize; ++m)
-                {
-                    pbar.progress((i*yBlockSize)+m, height);
-                    
-                    for(int j = 0; j < width; j++)
-                    {
-                        for(int n = 0; n < numInBands; n++)
-                        {
-                            inDataColumn[n] = inputData[n][(m*width)+j];
-                        }
-                        
-                        this->calc->calcImageValue(inDataColumn, numInBands, outDataColumn);
-                        
-                        for(int n = 0; n < this->numOutBands; n++)
-                        {
-                            outputData[n][(m*width)+j] = outDataColumn[n];
-                        }
-                        
-                    }
-                }
+                this->calcImageValueBlock(inputData, numInBands, outputData, width, yBlockSize, &pbar, i*yBlockSize, height);
                 
                 for(int n = 0; n < this->numOutBands; n++)
                 {
@@ -1467,26 +1323,7 @@ namespace rsgis{namespace img{
                     inputRasterBands[n]->RasterIO(GF_Read, bandOffsets[n][0], rowOffset, width, remainRows, inputData[n], width, remainRows, GDT_Float32, 0, 0);
                 }
                 
-                for(int m = 0; m < remainRows; ++m)
-                {
-                    pbar.progress((nYBlocks*yBlockSize)+m, height);
-                    
-                    for(int j = 0; j < width; j++)
-                    {
-                        for(int n = 0; n < numInBands; n++)
-                        {
-                            inDataColumn[n] = inputData[n][(m*width)+j];
-                        }
-                        
-                        this->calc->calcImageValue(inDataColumn, numInBands, outDataColumn);
-                        
-                        for(int n = 0; n < this->numOutBands; n++)
-                        {
-                            outputData[n][(m*width)+j] = outDataColumn[n];
-                        }
-                        
-                    }
-                }
+                this->calcImageValueBlock(inputData, numInBands, outputData, width, remainRows, &pbar, nYBlocks*yBlockSize, height);
                 
                 for(int n = 0; n < this->numOutBands; n++)
                 {
@@ -1551,16 +1388,6 @@ namespace rsgis{namespace img{
                 delete[] outputData;
             }
             
-            if(inDataColumn != NULL)
-            {
-                delete[] inDataColumn;
-            }
-            
-            if(outDataColumn != NULL)
-            {
-                delete[] outDataColumn;
-            }
-            
             if(inputRasterBands != NULL)
             {
                 delete[] inputRasterBands;
@@ -1627,16 +1454,6 @@ namespace rsgis{namespace img{
                 delete[] outputData;
             }
             
-            if(inDataColumn != NULL)
-            {
-                delete[] inDataColumn;
-            }
-            
-            if(outDataColumn != NULL)
-            {
-                delete[] outDataColumn;
-            }
-            
             if(inputRasterBands != NULL)
             {
                 delete[] inputRasterBands;
@@ -1702,16 +1519,6 @@ namespace rsgis{namespace img{
             delete[] outputData;
         }
         
-        if(inDataColumn != NULL)
-        {
-            delete[] inDataColumn;
-        }
-        
-        if(outDataColumn != NULL)
-        {
-            delete[] outDataColumn;
-        }
-        
         if(inputRasterBands != NULL)
         {
             delete[] inputRasterBands;
@@ -3952,7 +3759,6 @@ namespace rsgis{namespace img{
 		int numInBands = 0;
 		
 		float **inputData = NULL;
-		float *inDataColumn = NULL;
         int xBlockSize = 0;
         int yBlockSize = 0;
 		
@@ -3991,7 +3797,6 @@ namespace rsgis{namespace img{
 			{
 				inputData[i] = (float *) CPLMalloc(sizeof(float)*width*yBlockSize);
 			}
-			inDataColumn = new float[numInBands];
             
             int nYBlocks = height / yBlockSize;
             int remainRows = height - (nYBlocks * yBlockSize);
@@ -4007,20 +3812,8 @@ namespace rsgis{namespace img{
 					inputRasterBands[n]->RasterIO(GF_Read, bandOffsets[n][0], rowOffset, width, yBlockSize, inputData[n], width, yBlockSize, GDT_Float32, 0, 0);
 				}
                 
-                for(int m = 0; m < yBlockSize; ++m)
-                {
-                    pbar.progress((i*yBlockSize)+m, height);
-                    
-                    for(int j = 0; j < width; j++)
-                    {
-                        for(int n = 0; n < numInBands; n++)
-                        {
-                            inDataColumn[n] = inputData[n][(m*width)+j];
-                        }
-                        
-                        this->calc->calcImageValue(inDataColumn, numInBands);
-                    }
-                }
+                pbar.progress((i*yBlockSize), height);
+                this->calc->calcImageValueBlock(inputData, numInBands, width, yBlockSize);
 			}
             
             if(remainRows > 0)
@@ -4031,20 +3824,8 @@ namespace rsgis{namespace img{
 					inputRasterBands[n]->RasterIO(GF_Read, bandOffsets[n][0], rowOffset, width, remainRows, inputData[n], width, remainRows, GDT_Float32, 0, 0);
 				}
                 
-                for(int m = 0; m < remainRows; ++m)
-                {
-                    pbar.progress((nYBlocks*yBlockSize)+m, height);
-                    
-                    for(int j = 0; j < width; j++)
-                    {
-                        for(int n = 0; n < numInBands; n++)
-                        {
-                            inDataColumn[n] = inputData[n][(m*width)+j];
-                        }
-                        
-                        this->calc->calcImageValue(inDataColumn, numInBands);
-                    }
-                }
+                pbar.progress((nYBlocks*yBlockSize), height);
+                this->calc->calcImageValueBlock(inputData, numInBands, width, remainRows);
             }
 			pbar.finish();
 		}
@@ -4090,10 +3871,6 @@ namespace rsgis{namespace img{
 				}
 				delete[] inputData;
 			}		
-			if(inDataColumn != NULL)
-			{
-				delete[] inDataColumn;
-			}
 			if(inputRasterBands != NULL)
 			{
 				delete[] inputRasterBands;
@@ -4142,10 +3919,6 @@ namespace rsgis{namespace img{
 				}
 				delete[] inputData;
 			}		
-			if(inDataColumn != NULL)
-			{
-				delete[] inDataColumn;
-			}
 			if(inputRasterBands != NULL)
 			{
 				delete[] inputRasterBands;
@@ -4193,10 +3966,6 @@ namespace rsgis{namespace img{
 			}
 			delete[] inputData;
 		}		
-		if(inDataColumn != NULL)
-		{
-			delete[] inDataColumn;
-		}
 		if(inputRasterBands != NULL)
 		{
 			delete[] inputRasterBands;
@@ -4465,8 +4234,6 @@ namespace rsgis{namespace img{
 		
 		float **inputData = NULL;
 		double **outputData = NULL;
-		float *inDataColumn = NULL;
-		double *outDataColumn = NULL;
 		
 		GDALDataset *outputImageDS = NULL;
 		GDALRasterBand **inputRasterBands = NULL;
@@ -4544,20 +4311,24 @@ namespace rsgis{namespace img{
                 yBlockSize = outYBlockSize;
             }
             
+            if(this->getNumCalcThreads() > 1)
+            {
+                // Read enough rows for each thread to process a block of rows.
+                yBlockSize = yBlockSize * this->getNumCalcThreads();
+            }
+            
 			// Allocate memory
 			inputData = new float*[numInBands];
 			for(int i = 0; i < numInBands; i++)
 			{
 				inputData[i] = (float *) CPLMalloc(sizeof(float)*(width*yBlockSize));
 			}
-			inDataColumn = new float[numInBands];
             
 			outputData = new double*[this->numOutBands];
 			for(int i = 0; i < this->numOutBands; i++)
 			{
 				outputData[i] = (double *) CPLMalloc(sizeof(double)*(width*yBlockSize));
 			}
-			outDataColumn = new double[this->numOutBands];
             
             int nYBlocks = floor(((double)height) / ((double)yBlockSize));
             int remainRows = height - (nYBlocks * yBlockSize);
@@ -4573,26 +4344,7 @@ namespace rsgis{namespace img{
 					inputRasterBands[n]->RasterIO(GF_Read, bandOffsets[n][0], rowOffset, width, yBlockSize, inputData[n], width, yBlockSize, GDT_Float32, 0, 0);
 				}
                 
-                for(int m = 0; m < yBlockSize; ++m)
-                {
-                    pbar.progress((i*yBlockSize)+m, height);
-                    
-                    for(int j = 0; j < width; j++)
-                    {
-                        for(int n = 0; n < numInBands; n++)
-                        {
-                            inDataColumn[n] = inputData[n][(m*width)+j];
-                        }
-                        
-                        this->calc->calcImageValue(inDataColumn, numInBands, outDataColumn);
-                        
-                        for(int n = 0; n < this->numOutBands; n++)
-                        {
-                            outputData[n][(m*width)+j] = outDataColumn[n];
-                        }
-                        
-                    }
-                }
+                this->calcImageValueBlock(inputData, numInBands, outputData, width, yBlockSize, &pbar, i*yBlockSize, height);
 				
 				for(int n = 0; n < this->numOutBands; n++)
 				{
@@ -4609,26 +4361,7 @@ namespace rsgis{namespace img{
 					inputRasterBands[n]->RasterIO(GF_Read, bandOffsets[n][0], rowOffset, width, remainRows, inputData[n], width, remainRows, GDT_Float32, 0, 0);
 				}
                 
-                for(int m = 0; m < remainRows; ++m)
-                {
-                    pbar.progress((nYBlocks*yBlockSize)+m, height);
-                    
-                    for(int j = 0; j < width; j++)
-                    {
-                        for(int n = 0; n < numInBands; n++)
-                        {
-                            inDataColumn[n] = inputData[n][(m*width)+j];
-                        }
-                        
-                        this->calc->calcImageValue(inDataColumn, numInBands, outDataColumn);
-                        
-                        for(int n = 0; n < this->numOutBands; n++)
-                        {
-                            outputData[n][(m*width)+j] = outDataColumn[n];
-                        }
-                        
-                    }
-                }
+                this->calcImageValueBlock(inputData, numInBands, outputData, width, remainRows, &pbar, nYBlocks*yBlockSize, height);
 				
 				for(int n = 0; n < this->numOutBands; n++)
 				{
@@ -4693,16 +4426,6 @@ namespace rsgis{namespace img{
 				delete[] outputData;
 			}
 			
-			if(inDataColumn != NULL)
-			{
-				delete[] inDataColumn;
-			}
-			
-			if(outDataColumn != NULL)
-			{
-				delete[] outDataColumn;
-			}
-			
 			if(inputRasterBands != NULL)
 			{
 				delete[] inputRasterBands;
@@ -4769,16 +4492,6 @@ namespace rsgis{namespace img{
 				delete[] outputData;
 			}
 			
-			if(inDataColumn != NULL)
-			{
-				delete[] inDataColumn;
-			}
-			
-			if(outDataColumn != NULL)
-			{
-				delete[] outDataColumn;
-			}
-			
 			if(inputRasterBands != NULL)
 			{
 				delete[] inputRasterBands;
@@ -4846,16 +4559,6 @@ namespace rsgis{namespace img{
 			delete[] outputData;
 		}
 		
-		if(inDataColumn != NULL)
-		{
-			delete[] inDataColumn;
-		}
-		
-		if(outDataColumn != NULL)
-		{
-			delete[] outDataColumn;
-		}
-		
 		if(inputRasterBands != NULL)
 		{
 			delete[] inputRasterBands;
@@ -12367,6 +12070,14 @@ namespace rsgis{namespace img{
 			outDataColumn = new double[this->numOutBands];
 			
 			rsgis_tqdm pbar;
+			// Find the pixels within the polygon using the scanline rasteriser where the method allows.
+			RSGISPolygonScanline *polyScanline = NULL;
+			if(RSGISPolygonScanline::isMethodSupported(pixelPolyOption))
+			{
+				polyScanline = new RSGISPolygonScanline(pixelPolyOption);
+				polyScanline->rasterise(poly, gdalTranslation[0], gdalTranslation[3], pxlWidth, pxlHeight, width, height);
+			}
+
             // Loop images to process data
 			for(int i = 0; i < height; i++)
 			{				
@@ -12384,7 +12095,21 @@ namespace rsgis{namespace img{
 						inDataColumn[n] = inputData[n][j];
 					}
 
-					if (pixelPolyOption == polyContainsPixelCenter) 
+                    if (polyScanline != NULL)
+                    {
+                        if(polyScanline->isPixelIn(i, j))
+                        {
+                            this->calc->calcImageValue(inDataColumn, numInBands, outDataColumn);
+                        }
+                        else
+                        {
+                            for (int n = 0; n < this->numOutBands; n++)
+                            {
+                                outDataColumn[n] = nodata;
+                            }
+                        }
+                    }
+					else if (pixelPolyOption == polyContainsPixelCenter)
                     {
                         double x_pt = pxlTLX + (pxlWidth / 2);
                         double y_pt = pxlTLY - (pxlHeight / 2);
@@ -12504,6 +12229,7 @@ namespace rsgis{namespace img{
 					outputRasterBands[n]->RasterIO(GF_Write, 0, i, width, 1, outputData[n], width, 1, GDT_Float64, 0, 0);
 				}
 			}
+			delete polyScanline;
 			pbar.finish();
 		}
 		catch(RSGISImageCalcException& e)
@@ -12843,6 +12569,14 @@ namespace rsgis{namespace img{
 			{
 				std::cout << "\rStarted " << std::flush;
 			}			
+			// Find the pixels within the polygon using the scanline rasteriser where the method allows.
+			RSGISPolygonScanline *polyScanline = NULL;
+			if(RSGISPolygonScanline::isMethodSupported(pixelPolyOption))
+			{
+				polyScanline = new RSGISPolygonScanline(pixelPolyOption);
+				polyScanline->rasterise(poly, gdalTranslation[0], gdalTranslation[3], pxlWidth, pxlHeight, width, height);
+			}
+
 			// Loop images to process data
 			for(int i = 0; i < height; i++)
 			{				
@@ -12868,7 +12602,21 @@ namespace rsgis{namespace img{
 						inDataColumn[n] = inputData[n][j];
 					}
 
-                    if (pixelPolyOption == polyContainsPixelCenter)
+                    if (polyScanline != NULL)
+                    {
+                        if(polyScanline->isPixelIn(i, j))
+                        {
+                            this->calc->calcImageValue(inDataColumn, numInBands, outDataColumn);
+                        }
+                        else
+                        {
+                            for (int n = 0; n < this->numOutBands; n++)
+                            {
+                                outDataColumn[n] = outputData[n][j];
+                            }
+                        }
+                    }
+                    else if (pixelPolyOption == polyContainsPixelCenter)
                     {
                         double x_pt = pxlTLX + (pxlWidth / 2);
                         double y_pt = pxlTLY - (pxlHeight / 2);
@@ -12989,6 +12737,7 @@ namespace rsgis{namespace img{
 					outputRasterBands[n]->RasterIO(GF_Write, bandOffsets[n][0], (bandOffsets[n][1]+i), width, 1, outputData[n], width, 1, GDT_Float64, 0, 0);
 				}
 			}
+			delete polyScanline;
 			if (height > 100) 
 			{
 				std::cout << "Complete\r" << std::flush;
@@ -13223,7 +12972,7 @@ namespace rsgis{namespace img{
 	}
     
     /* calcImageWithinPolygon - Does not use an output image */
-	void RSGISCalcImage::calcImageWithinPolygonExtent(GDALDataset **datasets, int numDS, OGREnvelope *env, OGRPolygon *poly, pixelInPolyOption pixelPolyOption)
+	void RSGISCalcImage::calcImageWithinPolygonExtent(GDALDataset **datasets, int numDS, OGREnvelope *env, OGRGeometry *poly, pixelInPolyOption pixelPolyOption)
 	{
 		GDALAllRegister();
 		RSGISImageUtils imgUtils;
@@ -13278,7 +13027,7 @@ namespace rsgis{namespace img{
 				buffer = true;
 				bufferedEnvelope = new OGREnvelope();
                 bufferedEnvelope->MinX = env->MinX - pxlWidth / 2;
-                bufferedEnvelope->MinX = env->MaxX + pxlWidth / 2;
+                bufferedEnvelope->MaxX = env->MaxX + pxlWidth / 2;
                 bufferedEnvelope->MinY = env->MinY - pxlHeight / 2;
                 bufferedEnvelope->MaxY = env->MaxY + pxlHeight / 2;
 			}
@@ -13336,6 +13085,14 @@ namespace rsgis{namespace img{
 			}
 			inDataColumn = new float[numInBands];
             
+			// Find the pixels within the polygon using the scanline rasteriser where the method allows.
+			RSGISPolygonScanline *polyScanline = NULL;
+			if(RSGISPolygonScanline::isMethodSupported(pixelPolyOption))
+			{
+				polyScanline = new RSGISPolygonScanline(pixelPolyOption);
+				polyScanline->rasterise(poly, gdalTranslation[0], gdalTranslation[3], pxlWidth, pxlHeight, width, height);
+			}
+
 			// Loop images to process data
 			for(int i = 0; i < height; i++)
 			{				
@@ -13356,7 +13113,14 @@ namespace rsgis{namespace img{
                     extent.MinY = (pxlTLY-pxlHeight);
                     extent.MaxY = pxlTLY;
 
-                    if (pixelPolyOption == polyContainsPixelCenter)
+                    if (polyScanline != NULL)
+                    {
+                        if(polyScanline->isPixelIn(i, j))
+                        {
+                            this->calc->calcImageValue(inDataColumn, numInBands, extent);
+                        }
+                    }
+                    else if (pixelPolyOption == polyContainsPixelCenter)
                     {
                         double x_pt = pxlTLX + (pxlWidth / 2);
                         double y_pt = pxlTLY - (pxlHeight / 2);
@@ -13444,6 +13208,7 @@ namespace rsgis{namespace img{
 				pxlTLY -= pxlHeight;
 				pxlTLX = gdalTranslation[0];
 			}
+			delete polyScanline;
 		}
 		catch(RSGISImageCalcException& e)
 		{
@@ -13662,7 +13427,7 @@ namespace rsgis{namespace img{
                 buffer = true;
                 bufferedEnvelope = new OGREnvelope();
                 bufferedEnvelope->MinX = env->MinX - pxlWidth / 2;
-                bufferedEnvelope->MinX = env->MaxX + pxlWidth / 2;
+                bufferedEnvelope->MaxX = env->MaxX + pxlWidth / 2;
                 bufferedEnvelope->MinY = env->MinY - pxlHeight / 2;
                 bufferedEnvelope->MaxY = env->MaxY + pxlHeight / 2;
             }
@@ -13731,6 +13496,14 @@ namespace rsgis{namespace img{
                 readSuccess = inputRasterBands[n]->RasterIO(GF_Read, bandOffsets[n][0], (bandOffsets[n][1]), width, height, inputData[n], width, height, GDT_Float32, 0, 0);
             }
 
+            // Find the pixels within the polygon using the scanline rasteriser where the method allows.
+            RSGISPolygonScanline *polyScanline = NULL;
+            if(RSGISPolygonScanline::isMethodSupported(pixelPolyOption))
+            {
+                polyScanline = new RSGISPolygonScanline(pixelPolyOption);
+                polyScanline->rasterise(poly, gdalTranslation[0], gdalTranslation[3], pxlWidth, pxlHeight, width, height);
+            }
+
             // Loop images to process data
             for(int i = 0; i < height; i++)
             {
@@ -13746,7 +13519,14 @@ namespace rsgis{namespace img{
                     extent.MinY = (pxlTLY-pxlHeight);
                     extent.MaxY = pxlTLY;
 
-                    if (pixelPolyOption == polyContainsPixelCenter)
+                    if (polyScanline != NULL)
+                    {
+                        if(polyScanline->isPixelIn(i, j))
+                        {
+                            this->calc->calcImageValue(inDataColumn, numInBands, extent);
+                        }
+                    }
+                    else if (pixelPolyOption == polyContainsPixelCenter)
                     {
                         double x_pt = pxlTLX + (pxlWidth / 2);
                         double y_pt = pxlTLY - (pxlHeight / 2);
@@ -13834,6 +13614,7 @@ namespace rsgis{namespace img{
                 pxlTLY -= pxlHeight;
                 pxlTLX = gdalTranslation[0];
             }
+            delete polyScanline;
         }
         catch(RSGISImageCalcException& e)
         {
@@ -14544,9 +14325,133 @@ namespace rsgis{namespace img{
         }
     }
     
+    unsigned int RSGISCalcImage::getNumCalcThreads()
+    {
+        if(this->numThreads < 2)
+        {
+            return 1;
+        }
+        
+        if(this->threadCalcs.empty())
+        {
+            // The first thread uses the calc object provided by the user,
+            // the remaining threads each get their own copy.
+            this->threadCalcs.push_back(this->calc);
+            for(unsigned int i = 1; i < this->numThreads; ++i)
+            {
+                RSGISCalcImageValue *threadCalc = this->calc->clone();
+                if(threadCalc == NULL)
+                {
+                    std::cout << "The calculation does not support multiple threads so a single thread will be used." << std::endl;
+                    break;
+                }
+                this->threadCalcs.push_back(threadCalc);
+            }
+        }
+        return this->threadCalcs.size();
+    }
+    
+    void RSGISCalcImage::calcImageValueRows(RSGISCalcImageValue *rowsCalc, float **inputData, int numInBands, double **outputData, int width, int startRow, int endRow)
+    {
+        // Point at the first row to be processed so the rows are passed to the
+        // calc object as a single contiguous block for each band.
+        float **rowsInputData = new float*[numInBands];
+        for(int n = 0; n < numInBands; n++)
+        {
+            rowsInputData[n] = inputData[n] + (((size_t)startRow) * width);
+        }
+        double **rowsOutputData = new double*[this->numOutBands];
+        for(int n = 0; n < this->numOutBands; n++)
+        {
+            rowsOutputData[n] = outputData[n] + (((size_t)startRow) * width);
+        }
+        
+        try
+        {
+            rowsCalc->calcImageValueBlock(rowsInputData, numInBands, width, (endRow-startRow), rowsOutputData);
+        }
+        catch(...)
+        {
+            delete[] rowsInputData;
+            delete[] rowsOutputData;
+            throw;
+        }
+        
+        delete[] rowsInputData;
+        delete[] rowsOutputData;
+    }
+    
+    void RSGISCalcImage::calcImageValueBlock(float **inputData, int numInBands, double **outputData, int width, int nRows, rsgis_tqdm *pbar, int pbarRowOffset, int pbarTotal)
+    {
+        unsigned int nCalcThreads = this->getNumCalcThreads();
+        if(nCalcThreads > ((unsigned int)nRows))
+        {
+            nCalcThreads = nRows;
+        }
+        
+        if(pbar != NULL)
+        {
+            pbar->progress(pbarRowOffset, pbarTotal);
+        }
+        
+        if(nCalcThreads < 2)
+        {
+            this->calcImageValueRows(this->calc, inputData, numInBands, outputData, width, 0, nRows);
+        }
+        else
+        {
+            // Split the rows of the block into contiguous ranges, one per thread.
+            // Each pixel is calculated independently so the output is identical
+            // to that produced by a single thread.
+            std::vector<std::thread> calcThreads;
+            std::vector<std::exception_ptr> threadErrors(nCalcThreads);
+            int rowsPerThread = nRows / nCalcThreads;
+            int remainRows = nRows - (rowsPerThread * nCalcThreads);
+            int startRow = 0;
+            for(unsigned int t = 0; t < nCalcThreads; ++t)
+            {
+                int endRow = startRow + rowsPerThread;
+                if(t < ((unsigned int)remainRows))
+                {
+                    ++endRow;
+                }
+                RSGISCalcImageValue *threadCalc = this->threadCalcs.at(t);
+                std::exception_ptr *threadError = &threadErrors.at(t);
+                calcThreads.push_back(std::thread([this, threadCalc, threadError, inputData, numInBands, outputData, width, startRow, endRow]()
+                {
+                    try
+                    {
+                        this->calcImageValueRows(threadCalc, inputData, numInBands, outputData, width, startRow, endRow);
+                    }
+                    catch(...)
+                    {
+                        *threadError = std::current_exception();
+                    }
+                }));
+                startRow = endRow;
+            }
+            
+            for(std::vector<std::thread>::iterator iterThreads = calcThreads.begin(); iterThreads != calcThreads.end(); ++iterThreads)
+            {
+                (*iterThreads).join();
+            }
+            
+            for(std::vector<std::exception_ptr>::iterator iterErrs = threadErrors.begin(); iterErrs != threadErrors.end(); ++iterErrs)
+            {
+                if((*iterErrs) != NULL)
+                {
+                    std::rethrow_exception(*iterErrs);
+                }
+            }
+        }
+    }
+    
 	RSGISCalcImage::~RSGISCalcImage()
 	{
-		
+		for(size_t i = 1; i < this->threadCalcs.size(); ++i)
+		{
+			delete this->threadCalcs.at(i);
+		}
 	}
     
     
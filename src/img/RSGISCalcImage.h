@@ -25,12 +25,16 @@
 
 #include <iostream>
 #include <string>
+#include <vector>
+#include <thread>
+#include <exception>
 
 #include "gdal_priv.h"
 
 #include "common/rsgis-tqdm.h"
 
 #include "img/RSGISPixelInPoly.h"
+#include "img/RSGISPolygonScanline.h"
 #include "img/RSGISImageCalcException.h"
 #include "img/RSGISCalcImageValue.h"
 #include "img/RSGISImageUtils.h"
@@ -57,7 +61,13 @@ namespace rsgis
 		class DllExport RSGISCalcImage
 			{
 			public:
-				RSGISCalcImage(RSGISCalcImageValue *valueCalc, std::string proj="", bool useImageProj=true);
+				/**
+				 * numThreads is the number of threads used to calculate the pixel values
+				 * within each block of rows. The image is only processed with multiple
+				 * threads if the RSGISCalcImageValue object supports clone(). Reading and
+				 * writing of the image data is always performed on the calling thread.
+				 */
+				RSGISCalcImage(RSGISCalcImageValue *valueCalc, std::string proj="", bool useImageProj=true, unsigned int numThreads=1);
 				void calcImage(GDALDataset **datasets, int numDS, std::string outputImage, bool setOutNames = false, std::string *bandNames = NULL, std::string gdalFormat="KEA", GDALDataType gdalDataType=GDT_Float32);
                 void calcImage(GDALDataset **datasets, int numDS, std::string outputImage, std::string outputRefIntImage, std::string gdalFormat="KEA", GDALDataType gdalDataType=GDT_Float32);
 				void calcImage(GDALDataset **datasets, int numDS, GDALDataset *outputImageDS);
@@ -83,16 +93,21 @@ namespace rsgis
                 void calcImageWindowDataExtent(GDALDataset **datasets, int numDS, std::string outputImage, int windowSize, std::string gdalFormat="KEA", GDALDataType gdalDataType=GDT_Float32);
 				void calcImageWithinPolygon(GDALDataset **datasets, int numDS, std::string outputImage, OGREnvelope *env, OGRPolygon *poly, float nodata, pixelInPolyOption pixelPolyOption, std::string gdalFormat="KEA",  GDALDataType gdalDataType=GDT_Float32);
 				void calcImageWithinPolygon(GDALDataset **datasets, int numDS, OGREnvelope *env, OGRPolygon *poly, pixelInPolyOption pixelPolyOption);
-                void calcImageWithinPolygonExtent(GDALDataset **datasets, int numDS, OGREnvelope *env, OGRPolygon *poly, pixelInPolyOption pixelPolyOption);
+                void calcImageWithinPolygonExtent(GDALDataset **datasets, int numDS, OGREnvelope *env, OGRGeometry *poly, pixelInPolyOption pixelPolyOption);
                 void calcImageWithinPolygonExtentInMem(GDALDataset **datasets, int numDS, OGREnvelope *env, OGRPolygon *poly, pixelInPolyOption pixelPolyOption);
 				void calcImageWithinRasterPolygon(GDALDataset **datasets, int numDS, OGREnvelope *env, long fid);
                 void calcImageBorderPixels(GDALDataset *dataset, bool returnInt);
                 virtual ~RSGISCalcImage();
 			private:
+				unsigned int getNumCalcThreads();
+				void calcImageValueRows(RSGISCalcImageValue *rowsCalc, float **inputData, int numInBands, double **outputData, int width, int startRow, int endRow);
+				void calcImageValueBlock(float **inputData, int numInBands, double **outputData, int width, int nRows, rsgis_tqdm *pbar, int pbarRowOffset, int pbarTotal);
 				RSGISCalcImageValue *calc;
 				int numOutBands;
 				std::string proj;
 				bool useImageProj;
+				unsigned int numThreads;
+				std::vector<RSGISCalcImageValue*> threadCalcs;
 			};
         
         
@@ -587,7 +587,7 @@ namespace rsgis{namespace img{
                 buffer = true;
                 bufferedEnvelope = new OGREnvelope();
                 bufferedEnvelope->MinX = env->MinX - pxlWidth / 2;
-                bufferedEnvelope->MinX = env->MaxX + pxlWidth / 2;
+                bufferedEnvelope->MaxX = env->MaxX + pxlWidth / 2;
                 bufferedEnvelope->MinY = env->MinY - pxlHeight / 2;
                 bufferedEnvelope->MaxY = env->MaxY + pxlHeight / 2;
             }
@@ -647,6 +647,14 @@ namespace rsgis{namespace img{
 			{
 				std::cout << "\rStarted.." << std::flush;
 			}
+			// Find the pixels within the polygon using the scanline rasteriser where the method allows.
+			RSGISPolygonScanline *polyScanline = NULL;
+			if(RSGISPolygonScanline::isMethodSupported(pixelPolyOption))
+			{
+				polyScanline = new RSGISPolygonScanline(pixelPolyOption);
+				polyScanline->rasterise(poly, gdalTranslation[0], gdalTranslation[3], pxlWidth, pxlHeight, width, height);
+			}
+
 			// Loop images to process data
 			for(int i = 0; i < height; i++)
 			{
@@ -675,7 +683,14 @@ namespace rsgis{namespace img{
 
                     OGRPoint *pxlCentre = new OGRPoint(x_pt, y_pt);
 
-                    if (pixelPolyOption == polyContainsPixelCenter)
+                    if (polyScanline != NULL)
+                    {
+                        if(polyScanline->isPixelIn(i, j))
+                        {
+                            this->valueCalc->calcImageValue(inDataColumnA, 1, numInBands, poly, pxlCentre);
+                        }
+                    }
+                    else if (pixelPolyOption == polyContainsPixelCenter)
                     {
                         if(poly->Contains(pxlCentre)) // If polygon contains pixel center
                         {
@@ -764,6 +779,7 @@ namespace rsgis{namespace img{
 				std::cout << "Complete\r" << std::flush;
 				std::cout << "\r                                                                                    \r" << std::flush;
 			}
+			delete polyScanline;
 			if(output)
 			{	
 				double *tempOutVal;
@@ -886,7 +902,7 @@ namespace rsgis{namespace img{
                 buffer = true;
                 bufferedEnvelope = new OGREnvelope();
                 bufferedEnvelope->MinX = env->MinX - pixelXRes / 2;
-                bufferedEnvelope->MinX = env->MaxX + pixelXRes / 2;
+                bufferedEnvelope->MaxX = env->MaxX + pixelXRes / 2;
                 bufferedEnvelope->MinY = env->MinY - pixelYRes / 2;
                 bufferedEnvelope->MaxY = env->MaxY + pixelYRes / 2;
             }
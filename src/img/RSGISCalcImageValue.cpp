@@ -38,6 +38,62 @@ namespace rsgis{namespace img{
 	{
 		numOutBands = bands;
 	}
+	
+	void RSGISCalcImageValue::calcImageValueBlock(float **blockData, int numBands, int width, int height, double **output)
+	{
+		size_t numPxls = ((size_t)width) * ((size_t)height);
+		float *inDataColumn = new float[numBands];
+		double *outDataColumn = new double[this->numOutBands];
+		try
+		{
+			for(size_t i = 0; i < numPxls; ++i)
+			{
+				for(int n = 0; n < numBands; ++n)
+				{
+					inDataColumn[n] = blockData[n][i];
+				}
+				
+				this->calcImageValue(inDataColumn, numBands, outDataColumn);
+				
+				for(int n = 0; n < this->numOutBands; ++n)
+				{
+					output[n][i] = outDataColumn[n];
+				}
+			}
+		}
+		catch(...)
+		{
+			delete[] inDataColumn;
+			delete[] outDataColumn;
+			throw;
+		}
+		delete[] inDataColumn;
+		delete[] outDataColumn;
+	}
+	
+	void RSGISCalcImageValue::calcImageValueBlock(float **blockData, int numBands, int width, int height)
+	{
+		size_t numPxls = ((size_t)width) * ((size_t)height);
+		float *inDataColumn = new float[numBands];
+		try
+		{
+			for(size_t i = 0; i < numPxls; ++i)
+			{
+				for(int n = 0; n < numBands; ++n)
+				{
+					inDataColumn[n] = blockData[n][i];
+				}
+				
+				this->calcImageValue(inDataColumn, numBands);
+			}
+		}
+		catch(...)
+		{
+			delete[] inDataColumn;
+			throw;
+		}
+		delete[] inDataColumn;
+	}
 
     
     
@@ -64,6 +64,28 @@ namespace rsgis{namespace img{
              */
             virtual void calcImageValue(float ***dataBlock, int numBands, int winSize, double *output, OGREnvelope extent) {throw RSGISImageCalcException("Not Implemented - RSGISCalcImageValue Base Class");};
             virtual bool calcImageValueCondition(float ***dataBlock, int numBands, int winSize, double *output) {throw RSGISImageCalcException("Not Implemented - RSGISCalcImageValue Base Class");};
+            /**
+             * Calculate the output values for a block of pixels. blockData and output
+             * contain one array per band, each with width x height values stored row
+             * by row. The default implementation calls calcImageValue(float*, int, double*)
+             * for each pixel in turn; override where the calculation can be applied to
+             * a whole band in a single loop.
+             */
+            virtual void calcImageValueBlock(float **blockData, int numBands, int width, int height, double **output);
+            /**
+             * As above but for calculators which do not produce an output image
+             * (e.g., those accumulating statistics).
+             */
+            virtual void calcImageValueBlock(float **blockData, int numBands, int width, int height);
+            /**
+             * Create an independent copy of this object which can be used to
+             * calculate pixel values on another thread at the same time as this
+             * instance. Only implement where each output pixel is a function of
+             * the input pixel alone (i.e., no state is accumulated across pixels).
+             * The default returns NULL, which means RSGISCalcImage will process
+             * the image on a single thread.
+             */
+            virtual RSGISCalcImageValue* clone() {return NULL;};
             virtual int getNumOutBands();
             virtual void setNumOutBands(int bands);
             virtual ~RSGISCalcImageValue(){};
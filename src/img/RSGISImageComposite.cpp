@@ -30,6 +30,13 @@ RSGISImageComposite::RSGISImageComposite(int numberOutBands, unsigned int nCompo
     this->numberOutBands = numberOutBands;
     this->nCompositeBands = nCompositeBands;
     this->outStat = outStat;
+    
+    rsgis::math::RSGISMathsUtils mathUtils;
+    mathUtils.initStatsSummary(&this->stats);
+    this->stats.calcMode = false;
+    this->stats.calcMin = (outStat == compositeMin) || (outStat == compositeRange);
+    this->stats.calcMax = (outStat == compositeMax) || (outStat == compositeRange);
+    this->stats.calcMean = (outStat == compositeMean);
 }
 
 void RSGISImageComposite::calcImageValue(float *bandValues, int numBands, double *output) 
@@ -37,152 +44,373 @@ void RSGISImageComposite::calcImageValue(float *bandValues, int numBands, double
     for(int i = 0; i < this->numberOutBands; ++i)
     {
         unsigned int startBand = this->nCompositeBands * i;
-        float minVal = 0;
-        float maxVal = 0;
-        float sum = 0;
-        unsigned int realNCompositeBands = 0; // Count composite bands, if not exactly devisable
+        int realNCompositeBands = 0; // Count composite bands, if not exactly devisable
+        if(startBand < numBands)
+        {
+            realNCompositeBands = std::min(this->nCompositeBands, numBands - startBand);
+        }
         
         // Calculate stats from input bands
-        for(unsigned int j = 0; j < this->nCompositeBands; ++j)
+        this->pxlStats.calcStats(&bandValues[startBand], realNCompositeBands, false, 0, &this->stats);
+        
+        // Add stats to output image
+        if (this->outStat == compositeMean) {output[i] = this->stats.mean;}
+        else if (this->outStat == compositeMin) {output[i] = this->stats.min;}
+        else if (this->outStat == compositeMax) {output[i] = this->stats.max;}
+        else if (this->outStat == compositeRange) {output[i] = this->stats.max - this->stats.min;}
+    }    
+}
+
+RSGISCalcImageValue* RSGISImageComposite::clone()
+{
+    return new RSGISImageComposite(this->numberOutBands, this->nCompositeBands, this->outStat);
+}
+    
+    void RSGISMaxNDVICompositeSelector::calcSelectionIndex(double **selectData, unsigned int numSelectBands, size_t numPxls, int *selectIdx)
+    {
+        unsigned int numInImgs = numSelectBands / 2;
+        float redVal = 0.0;
+        float nirVal = 0.0;
+        float ndviVal = 0.0;
+        float maxNDVI = 0.0;
+        int maxImgIdx = 0;
+        bool first = true;
+        for(size_t n = 0; n < numPxls; ++n)
         {
-            if((startBand + j) < numBands)
+            maxNDVI = 0.0;
+            maxImgIdx = 0;
+            first = true;
+            for(unsigned int i = 0; i < numInImgs; ++i)
             {
-                ++realNCompositeBands;
-                float pixelVal = bandValues[startBand + j];
-                sum = sum + pixelVal;
-                if (j == 0) // If first band, set min and max to pixel values
+                // Values are cast to float to match reading the bands as GDT_Float32.
+                redVal = selectData[(i*2)][n];
+                nirVal = selectData[(i*2)+1][n];
+                if((nirVal != 0) & (redVal != 0))
                 {
-                    minVal = pixelVal;
-                    maxVal = pixelVal;
-                }
-                else 
-                {
-                    if(pixelVal < minVal){minVal = pixelVal;}
-                    if(pixelVal > maxVal){maxVal = pixelVal;}
+                    ndviVal = (nirVal - redVal) / (nirVal + redVal);
+                    if(first)
+                    {
+                        maxNDVI = ndviVal;
+                        maxImgIdx = i;
+                        first = false;
+                    }
+                    else if(ndviVal > maxNDVI)
+                    {
+                        maxNDVI = ndviVal;
+                        maxImgIdx = i;
+                    }
                 }
-
             }
-            
+            // Where no scene has a valid NDVI the first scene is used, which is
+            // all zeros where every input band is zero.
+            selectIdx[n] = maxImgIdx;
+        }
+    }
+    
+    
+    RSGISRefImgCompositeSelector::RSGISRefImgCompositeSelector(unsigned int numInImgs)
+    {
+        this->numInImgs = numInImgs;
+    }
+    
+    void RSGISRefImgCompositeSelector::calcSelectionIndex(double **selectData, unsigned int numSelectBands, size_t numPxls, int *selectIdx)
+    {
+        if(numSelectBands != 1)
+        {
+            throw RSGISImageCalcException("There should only be a single reference band.");
         }
         
-        // Add stats to output image
-        if (this->outStat == compositeMean)
+        long refVal = 0;
+        for(size_t n = 0; n < numPxls; ++n)
         {
-            if(sum != 0)
+            refVal = static_cast<long>(selectData[0][n]);
+            if(refVal == 0)
+            {
+                selectIdx[n] = -1;
+            }
+            else if(refVal > 0)
             {
-                 output[i] = sum / realNCompositeBands;
+                if((refVal-1) < this->numInImgs)
+                {
+                    selectIdx[n] = refVal-1;
+                }
+                else
+                {
+                    std::cerr << "Reference pixel = " << refVal << std::endl;
+                    throw RSGISImageCalcException("Reference image is not within the stack.");
+                }
             }
-            else 
+            else
             {
-                output[i] = 0;
+                std::cerr << "Reference pixel = " << refVal << std::endl;
+                throw RSGISImageCalcException("Reference pixel values cannot be negative");
             }
         }
-        else if (this->outStat == compositeMin) {output[i] = minVal;}
-        else if (this->outStat == compositeMax) {output[i] = maxVal;}
-        else if (this->outStat == compositeRange) {output[i] = maxVal - minVal;}
-        
-    }    
-}
+    }
     
-    RSGISMaxNDVIImageComposite::RSGISMaxNDVIImageComposite(int numberOutBands, unsigned int redBand, unsigned int nirBand, unsigned int numInImgs) : RSGISCalcImageValue(numberOutBands)
+    
+    RSGISTimeseriesFillCompositeSelector::RSGISTimeseriesFillCompositeSelector(unsigned int *imgIdxLUT, unsigned int nLUT)
     {
-        this->redBand = redBand-1;
-        this->nirBand = nirBand-1;
-        this->numInImgs = numInImgs;
+        this->imgIdxLUT = imgIdxLUT;
+        this->nLUT = nLUT;
     }
     
-    void RSGISMaxNDVIImageComposite::calcImageValue(float *bandValues, int numBands, double *output) 
+    void RSGISTimeseriesFillCompositeSelector::calcSelectionIndex(double **selectData, unsigned int numSelectBands, size_t numPxls, int *selectIdx)
     {
-        bool noData = true;
-        for(int i = 0; i < numBands; ++i)
+        if(numSelectBands != 1)
         {
-            if(bandValues[i] != 0.0)
-            {
-                noData = false;
-            }
+            throw RSGISImageCalcException("There should only be a single integer band.");
         }
         
-        if(noData)
-        {
-            for(int i = 0; i < this->getNumOutBands(); ++i)
-            {
-                output[i] = 0.0;
-            }
-        }
-        else
+        long refVal = 0;
+        unsigned int imgIdx = 0;
+        for(size_t n = 0; n < numPxls; ++n)
         {
-            int nImgBands = this->getNumOutBands();
-            float maxNDVI = 0.0;
-            int maxImgIdx = 0;
-            
-            float ndviVal = 0.0;
-            bool first = true;
-            for(int i = 0; i < numInImgs; ++i)
+            refVal = static_cast<long>(selectData[0][n]);
+            if(refVal > 0)
             {
-                if((bandValues[(nImgBands*i)+this->nirBand] != 0) & (bandValues[(nImgBands*i)+this->redBand] != 0))
+                if((refVal >= this->nLUT) || (this->imgIdxLUT[refVal] >= this->nLUT))
                 {
-                    ndviVal = (bandValues[(nImgBands*i)+this->nirBand]-bandValues[(nImgBands*i)+this->redBand])/(bandValues[(nImgBands*i)+this->nirBand]+bandValues[(nImgBands*i)+this->redBand]);
-                    if(first)
-                    {
-                        maxNDVI = ndviVal;
-                        maxImgIdx = i;
-                        first = true;
-                    }
-                    else if(ndviVal > maxNDVI)
-                    {
-                        maxNDVI = ndviVal;
-                        maxImgIdx = i;
-                    }
+                    throw RSGISImageCalcException("LUT has incorrect valid.");
+                }
+                imgIdx = this->imgIdxLUT[refVal];
+                if(imgIdx > 0)
+                {
+                    imgIdx = imgIdx - 1;
                 }
+                selectIdx[n] = imgIdx;
             }
-            
-            int outImgBandIdx = maxImgIdx * this->getNumOutBands();
-            for(int i = 0; i < this->getNumOutBands(); ++i)
+            else
             {
-                output[i] = bandValues[outImgBandIdx++];
+                selectIdx[n] = 0;
             }
-            
         }
-        
     }
     
     
-    RSGISRefImgImageComposite::RSGISRefImgImageComposite(int numberOutBands, unsigned int numInImgs, float outNoDataVal) : RSGISCalcImageValue(numberOutBands)
+    RSGISSelectionIndexComposite::RSGISSelectionIndexComposite(RSGISCompositeSelector *selector, float outNoDataVal)
     {
-        this->numInImgs = numInImgs;
+        this->selector = selector;
         this->outNoDataVal = outNoDataVal;
     }
     
-    void RSGISRefImgImageComposite::calcImageValue(long *intBandValues, unsigned int numIntVals, float *floatBandValues, unsigned int numfloatVals, double *output) 
+    void RSGISSelectionIndexComposite::createComposite(GDALDataset **datasets, unsigned int numDS, std::vector<std::pair<unsigned int, unsigned int> > selectBands, unsigned int sceneStartIdx, std::string outputImage, std::string gdalFormat, GDALDataType gdalDataType)
     {
-        if(intBandValues[0] == 0)
+        if(sceneStartIdx >= numDS)
+        {
+            throw RSGISImageCalcException("There are no scenes to composite.");
+        }
+        if(selectBands.empty())
+        {
+            throw RSGISImageCalcException("At least one selection band is required.");
+        }
+        
+        unsigned int numScenes = numDS - sceneStartIdx;
+        unsigned int numOutBands = datasets[sceneStartIdx]->GetRasterCount();
+        for(unsigned int i = sceneStartIdx; i < numDS; ++i)
+        {
+            if(datasets[i]->GetRasterCount() != numOutBands)
+            {
+                throw RSGISImageCalcException("Input images have different number of image bands.");
+            }
+        }
+        for(std::vector<std::pair<unsigned int, unsigned int> >::iterator iterBand = selectBands.begin(); iterBand != selectBands.end(); ++iterBand)
         {
-            for(int i = 0; i < this->getNumOutBands(); ++i)
+            if((*iterBand).first >= numDS)
             {
-                output[i] = this->outNoDataVal;
+                throw RSGISImageCalcException("Selection band dataset is not within the list of datasets.");
             }
+            if(((*iterBand).second == 0) || ((*iterBand).second > datasets[(*iterBand).first]->GetRasterCount()))
+            {
+                throw RSGISImageCalcException("Selection band is not within the dataset.");
+            }
+        }
+        unsigned int numSelectBands = selectBands.size();
+        
+        RSGISImageUtils imgUtils;
+        double *gdalTranslation = new double[6];
+        int **dsOffsets = new int*[numDS];
+        for(unsigned int i = 0; i < numDS; ++i)
+        {
+            dsOffsets[i] = new int[2];
         }
-        else if(intBandValues[0] > 0)
+        GDALDataset *outputImageDS = NULL;
+        
+        try
         {
-            if((intBandValues[0]-1) < this->numInImgs)
+            int width = 0;
+            int height = 0;
+            int xBlockSize = 0;
+            int yBlockSize = 0;
+            imgUtils.getImageOverlap(datasets, numDS, dsOffsets, &width, &height, gdalTranslation, &xBlockSize, &yBlockSize);
+            
+            GDALDriver *gdalDriver = GetGDALDriverManager()->GetDriverByName(gdalFormat.c_str());
+            if(gdalDriver == NULL)
             {
-                int outImgBandIdx = (intBandValues[0]-1) * this->getNumOutBands();
-                for(int i = 0; i < this->getNumOutBands(); ++i)
+                throw RSGISImageBandException("Requested GDAL driver does not exists..");
+            }
+            char **papszOptions = imgUtils.getGDALCreationOptionsForFormat(gdalFormat);
+            std::cout << "New image width = " << width << " height = " << height << " bands = " << numOutBands << std::endl;
+            
+            outputImageDS = gdalDriver->Create(outputImage.c_str(), width, height, numOutBands, gdalDataType, papszOptions);
+            if(outputImageDS == NULL)
+            {
+                throw RSGISImageBandException("Output image could not be created. Check filepath.");
+            }
+            outputImageDS->SetGeoTransform(gdalTranslation);
+            outputImageDS->SetProjection(datasets[0]->GetProjectionRef());
+            
+            int outXBlockSize = 0;
+            int outYBlockSize = 0;
+            outputImageDS->GetRasterBand(1)->GetBlockSize(&outXBlockSize, &outYBlockSize);
+            if(outYBlockSize > yBlockSize)
+            {
+                yBlockSize = outYBlockSize;
+            }
+            if(yBlockSize < 1)
+            {
+                yBlockSize = 1;
+            }
+            
+            size_t nBlockPxls = ((size_t)width) * ((size_t)yBlockSize);
+            std::vector<std::vector<double> > selectData(numSelectBands, std::vector<double>(nBlockPxls));
+            std::vector<double*> selectDataPtrs(numSelectBands);
+            for(unsigned int n = 0; n < numSelectBands; ++n)
+            {
+                selectDataPtrs[n] = selectData[n].data();
+            }
+            std::vector<int> selectIdx(nBlockPxls);
+            std::vector<std::vector<float> > outputData(numOutBands, std::vector<float>(nBlockPxls));
+            std::vector<float> sceneData(nBlockPxls);
+            std::vector<size_t> sceneCounts(numScenes);
+            
+            int nYBlocks = (height + yBlockSize - 1) / yBlockSize;
+            rsgis_tqdm pbar;
+            for(int i = 0; i < nYBlocks; ++i)
+            {
+                pbar.progress(i, nYBlocks);
+                int rowOffset = yBlockSize * i;
+                int nRows = std::min(yBlockSize, height - rowOffset);
+                size_t nPxls = ((size_t)width) * ((size_t)nRows);
+                
+                // Pass 1: calculate the scene to be used for each pixel from the selection bands.
+                for(unsigned int n = 0; n < numSelectBands; ++n)
+                {
+                    unsigned int dsIdx = selectBands[n].first;
+                    if(datasets[dsIdx]->GetRasterBand(selectBands[n].second)->RasterIO(GF_Read, dsOffsets[dsIdx][0], dsOffsets[dsIdx][1]+rowOffset, width, nRows, selectDataPtrs[n], width, nRows, GDT_Float64, 0, 0) != CE_None)
+                    {
+                        throw RSGISImageCalcException("Could not read a selection band.");
+                    }
+                }
+                this->selector->calcSelectionIndex(selectDataPtrs.data(), numSelectBands, nPxls, selectIdx.data());
+                
+                std::fill(sceneCounts.begin(), sceneCounts.end(), 0);
+                size_t nNoDataPxls = 0;
+                for(size_t p = 0; p < nPxls; ++p)
+                {
+                    if(selectIdx[p] < 0)
+                    {
+                        ++nNoDataPxls;
+                    }
+                    else if(selectIdx[p] >= ((int)numScenes))
+                    {
+                        throw RSGISImageCalcException("Selected scene is not within the list of scenes.");
+                    }
+                    else
+                    {
+                        ++sceneCounts[selectIdx[p]];
+                    }
+                }
+                
+                // Pass 2: gather the output values from the selected scenes only.
+                int singleScene = -1;
+                for(unsigned int s = 0; s < numScenes; ++s)
                 {
-                    output[i] = floatBandValues[outImgBandIdx++];
+                    if(sceneCounts[s] == nPxls)
+                    {
+                        singleScene = s;
+                        break;
+                    }
+                }
+                
+                if(singleScene >= 0)
+                {
+                    unsigned int dsIdx = sceneStartIdx + singleScene;
+                    for(unsigned int b = 0; b < numOutBands; ++b)
+                    {
+                        if(datasets[dsIdx]->GetRasterBand(b+1)->RasterIO(GF_Read, dsOffsets[dsIdx][0], dsOffsets[dsIdx][1]+rowOffset, width, nRows, outputData[b].data(), width, nRows, GDT_Float32, 0, 0) != CE_None)
+                        {
+                            throw RSGISImageCalcException("Could not read a band of the selected scene.");
+                        }
+                    }
+                }
+                else
+                {
+                    if(nNoDataPxls > 0)
+                    {
+                        for(unsigned int b = 0; b < numOutBands; ++b)
+                        {
+                            std::fill(outputData[b].begin(), outputData[b].begin()+nPxls, this->outNoDataVal);
+                        }
+                    }
+                    
+                    for(unsigned int s = 0; s < numScenes; ++s)
+                    {
+                        if(sceneCounts[s] == 0)
+                        {
+                            continue;
+                        }
+                        unsigned int dsIdx = sceneStartIdx + s;
+                        for(unsigned int b = 0; b < numOutBands; ++b)
+                        {
+                            if(datasets[dsIdx]->GetRasterBand(b+1)->RasterIO(GF_Read, dsOffsets[dsIdx][0], dsOffsets[dsIdx][1]+rowOffset, width, nRows, sceneData.data(), width, nRows, GDT_Float32, 0, 0) != CE_None)
+                            {
+                                throw RSGISImageCalcException("Could not read a band of a selected scene.");
+                            }
+                            float *outBandData = outputData[b].data();
+                            for(size_t p = 0; p < nPxls; ++p)
+                            {
+                                if(selectIdx[p] == ((int)s))
+                                {
+                                    outBandData[p] = sceneData[p];
+                                }
+                            }
+                        }
+                    }
+                }
+                
+                for(unsigned int b = 0; b < numOutBands; ++b)
+                {
+                    if(outputImageDS->GetRasterBand(b+1)->RasterIO(GF_Write, 0, rowOffset, width, nRows, outputData[b].data(), width, nRows, GDT_Float32, 0, 0) != CE_None)
+                    {
+                        throw RSGISImageCalcException("Could not write to the output image.");
+                    }
                 }
             }
-            else
+            pbar.finish();
+        }
+        catch(std::exception &e)
+        {
+            if(outputImageDS != NULL)
+            {
+                GDALClose(outputImageDS);
+            }
+            for(unsigned int i = 0; i < numDS; ++i)
             {
-                std::cerr << "Reference pixel = " << intBandValues[0] << std::endl;
-                throw RSGISImageCalcException("Reference image is not within the stack.");
+                delete[] dsOffsets[i];
             }
+            delete[] dsOffsets;
+            delete[] gdalTranslation;
+            throw;
         }
-        else
+        
+        GDALClose(outputImageDS);
+        for(unsigned int i = 0; i < numDS; ++i)
         {
-            std::cerr << "Reference pixel = " << intBandValues[0] << std::endl;
-            throw RSGISImageCalcException("Reference pixel values cannot be negative");
+            delete[] dsOffsets[i];
         }
+        delete[] dsOffsets;
+        delete[] gdalTranslation;
     }
     
     
@@ -248,69 +476,6 @@ void RSGISImageComposite::calcImageValue(float *bandValues, int numBands, double
     
     
     
-    RSGISTimeseriesFillImgImageComposite::RSGISTimeseriesFillImgImageComposite(std::vector<rsgis::img::RSGISCompositeInfo*> compInfoVec, unsigned int *imgIdxLUT, unsigned int nLUT, unsigned int nBands) : RSGISCalcImageValue(nBands)
-    {
-        this->compInfoVec = compInfoVec;
-        this->imgIdxLUT = imgIdxLUT;
-        this->nLUT = nLUT;
-        int fillBandIdx = 1;
-        for(std::vector<rsgis::img::RSGISCompositeInfo*>::iterator iterInfo = compInfoVec.begin(); iterInfo != compInfoVec.end(); ++iterInfo)
-        {
-            if((*iterInfo)->outRef)
-            {
-                break;
-            }
-            ++fillBandIdx;
-        }
-        
-        if(fillBandIdx != 1)
-        {
-            std::cout << "this->fillBandIdx = " << fillBandIdx << std::endl;
-            throw RSGISImageCalcException("The image being filled should be the first in the list");
-        }
-    }
-    
-    void RSGISTimeseriesFillImgImageComposite::calcImageValue(long *intBandValues, unsigned int numIntVals, float *floatBandValues, unsigned int numfloatVals, double *output) 
-    {
-        if(numIntVals != 1)
-        {
-            throw RSGISImageCalcException("There should only be a single integer band.");
-        }
-        if((numfloatVals % this->getNumOutBands()) != 0)
-        {
-            throw RSGISImageCalcException("The number of float bands should be divisable by the number of output bands");
-        }
-        
-        if(intBandValues[0] > 0)
-        {
-            unsigned int imgIdx = 0;
-            imgIdx = this->imgIdxLUT[(intBandValues[0])];
-            if((imgIdx >= this->nLUT))
-            {
-                throw RSGISImageCalcException("LUT has incorrect valid.");
-            }
-            if(imgIdx > 0)
-            {
-                imgIdx = imgIdx - 1;
-            }
-            
-            int offset = (this->getNumOutBands() * imgIdx);
-            
-            for(unsigned int i = 0; i < this->getNumOutBands(); ++i)
-            {
-                output[i] = floatBandValues[offset+i];
-            }
-        }
-        else
-        {
-            for(unsigned int i = 0; i < this->getNumOutBands(); ++i)
-            {
-                output[i] = floatBandValues[i];
-            }
-        }
-    }
-    
-    
     RSGISTimeseriesFillFinalRefImgImageComposite::RSGISTimeseriesFillFinalRefImgImageComposite(std::vector<rsgis::img::RSGISCompositeInfo*> compInfoVec, std::map<std::string, unsigned int> *ratImgLst) : RSGISCalcImageValue(1)
     {
         this->compInfoVec = compInfoVec;
@@ -23,6 +23,12 @@
 
 #include <cmath>
 #include <set>
+#include <vector>
+#include <string>
+#include <utility>
+#include <algorithm>
+
+#include "gdal_priv.h"
 
 #include "common/RSGISException.h"
 #include "common/RSGISImageException.h"
@@ -30,6 +36,10 @@
 
 #include "img/RSGISCalcImage.h"
 #include "img/RSGISCalcImageValue.h"
+#include "img/RSGISImageUtils.h"
+#include "img/RSGISImageStatistics.h"
+
+#include "common/rsgis-tqdm.h"
 
 // mark all exported classes/functions with DllExport to have
 // them exported by Visual Studio
@@ -140,36 +150,94 @@ namespace rsgis { namespace img {
 	public: 
 		RSGISImageComposite(int numberOutBands, unsigned int nCompositeBands, compositeStat outStat = compositeMean);
 		void calcImageValue(float *bandValues, int numBands, double *output);
+		RSGISCalcImageValue* clone();
 		~RSGISImageComposite(){};
 	private:
         int numberOutBands;
         unsigned int nCompositeBands;
         compositeStat outStat;
+        rsgis::math::RSGISStatsSummary stats;
+        RSGISPixelColumnStats pxlStats;
 	};
     
     
     
-    class DllExport RSGISMaxNDVIImageComposite : public RSGISCalcImageValue
+    /**
+     * Calculates, for each pixel, the index of the scene to be used
+     * within a composite from the selection bands which have been read
+     * for the block. An index of -1 means no scene was selected and the
+     * output no data value will be used.
+     */
+    class DllExport RSGISCompositeSelector
     {
     public:
-        RSGISMaxNDVIImageComposite(int numberOutBands, unsigned int redBand, unsigned int nirBand, unsigned int numInImgs);
-        void calcImageValue(float *bandValues, int numBands, double *output);
-        ~RSGISMaxNDVIImageComposite(){};
-    private:
-        unsigned int redBand;
-        unsigned int nirBand;
-        unsigned int numInImgs;
+        RSGISCompositeSelector(){};
+        virtual void calcSelectionIndex(double **selectData, unsigned int numSelectBands, size_t numPxls, int *selectIdx) = 0;
+        virtual ~RSGISCompositeSelector(){};
     };
     
+    /**
+     * Selects the scene with the maximum NDVI. The selection bands are
+     * expected to be ordered red then NIR for each scene in turn.
+     */
+    class DllExport RSGISMaxNDVICompositeSelector : public RSGISCompositeSelector
+    {
+    public:
+        RSGISMaxNDVICompositeSelector(){};
+        void calcSelectionIndex(double **selectData, unsigned int numSelectBands, size_t numPxls, int *selectIdx);
+        ~RSGISMaxNDVICompositeSelector(){};
+    };
     
-    class DllExport RSGISRefImgImageComposite : public RSGISCalcImageValue
+    /**
+     * Selects the scene referenced by a reference image where a pixel value
+     * of 1 is the first scene and 0 is no data.
+     */
+    class DllExport RSGISRefImgCompositeSelector : public RSGISCompositeSelector
     {
     public:
-        RSGISRefImgImageComposite(int numberOutBands, unsigned int numInImgs, float outNoDataVal);
-        void calcImageValue(long *intBandValues, unsigned int numIntVals, float *floatBandValues, unsigned int numfloatVals, double *output);
-        ~RSGISRefImgImageComposite(){};
-    private:
+        RSGISRefImgCompositeSelector(unsigned int numInImgs);
+        void calcSelectionIndex(double **selectData, unsigned int numSelectBands, size_t numPxls, int *selectIdx);
+        ~RSGISRefImgCompositeSelector(){};
+    protected:
         unsigned int numInImgs;
+    };
+    
+    /**
+     * Selects the scene for a time series fill composite, where the fill
+     * reference image values are mapped to the opened composite images
+     * through imgIdxLUT. Pixels which are not filled use the first scene.
+     */
+    class DllExport RSGISTimeseriesFillCompositeSelector : public RSGISCompositeSelector
+    {
+    public:
+        RSGISTimeseriesFillCompositeSelector(unsigned int *imgIdxLUT, unsigned int nLUT);
+        void calcSelectionIndex(double **selectData, unsigned int numSelectBands, size_t numPxls, int *selectIdx);
+        ~RSGISTimeseriesFillCompositeSelector(){};
+    protected:
+        unsigned int *imgIdxLUT;
+        unsigned int nLUT;
+    };
+    
+    /**
+     * Creates a composite in two passes over each block. The selection bands
+     * are read and used to calculate the scene to be used for each pixel;
+     * only the scenes which are selected within the block are then read to
+     * gather the output spectra. A block taken from a single scene is read
+     * straight into the output buffer.
+     */
+    class DllExport RSGISSelectionIndexComposite
+    {
+    public:
+        RSGISSelectionIndexComposite(RSGISCompositeSelector *selector, float outNoDataVal);
+        /**
+         * datasets[sceneStartIdx..numDS) are the scenes being composited and
+         * selectBands lists the (dataset index, band (starting at 1)) pairs
+         * passed to the selector in order.
+         */
+        void createComposite(GDALDataset **datasets, unsigned int numDS, std::vector<std::pair<unsigned int, unsigned int> > selectBands, unsigned int sceneStartIdx, std::string outputImage, std::string gdalFormat, GDALDataType gdalDataType);
+        ~RSGISSelectionIndexComposite(){};
+    protected:
+        RSGISCompositeSelector *selector;
         float outNoDataVal;
     };
     
@@ -188,18 +256,6 @@ namespace rsgis { namespace img {
         int refImgInitPxlVal;
     };
     
-    class DllExport RSGISTimeseriesFillImgImageComposite : public RSGISCalcImageValue
-    {
-    public:
-        RSGISTimeseriesFillImgImageComposite(std::vector<rsgis::img::RSGISCompositeInfo*> compInfoVec, unsigned int *imgIdxLUT, unsigned int nLUT, unsigned int nBands);
-        void calcImageValue(long *intBandValues, unsigned int numIntVals, float *floatBandValues, unsigned int numfloatVals, double *output);
-        ~RSGISTimeseriesFillImgImageComposite(){};
-    private:
-        std::vector<rsgis::img::RSGISCompositeInfo*> compInfoVec;
-        unsigned int *imgIdxLUT;
-        unsigned int nLUT;
-    };
-    
     class DllExport RSGISTimeseriesFillFinalRefImgImageComposite : public RSGISCalcImageValue
     {
     public:
@@ -25,13 +25,17 @@
 
 namespace rsgis{namespace img{
 	
-	RSGISImageMaths::RSGISImageMaths(int numberOutBands, mu::Parser *muParser) : RSGISCalcImageValue(numberOutBands)
+	RSGISImageMaths::RSGISImageMaths(int numberOutBands, mu::Parser *muParser, bool useBulkEval) : RSGISCalcImageValue(numberOutBands)
 	{
 		
 		this->muParser = muParser;
 		inVal = 0;
 		muParser->DefineVar(_T("b1"), &inVal);
-		
+		this->clonedParser = NULL;
+		this->useBulkEval = useBulkEval;
+		this->bulkVals = NULL;
+		this->bulkValsSize = 0;
+		this->bulkVarsBound = false;
 	}
 	
 	void RSGISImageMaths::calcImageValue(float *bandValues, int numBands, double *output) 
@@ -43,6 +47,11 @@ namespace rsgis{namespace img{
 		
 		try 
 		{
+            if(bulkVarsBound)
+            {
+                muParser->DefineVar(_T("b1"), &inVal);
+                bulkVarsBound = false;
+            }
             mu::value_type result = 0;
 			for(int i = 0; i < numBands; ++i)
 			{
@@ -60,12 +69,82 @@ namespace rsgis{namespace img{
 	}
 
 	
-	RSGISImageMaths::~RSGISImageMaths()
+	void RSGISImageMaths::calcImageValueBlock(float **blockData, int numBands, int width, int height, double **output)
 	{
+		if(!this->useBulkEval)
+		{
+			RSGISCalcImageValue::calcImageValueBlock(blockData, numBands, width, height, output);
+			return;
+		}
 		
+		if(numOutBands != numBands)
+		{
+			throw RSGISImageCalcException("The number of output image bands must be equal to the number of input bands.");
+		}
+		
+		size_t numPxls = ((size_t)width) * ((size_t)height);
+		if(numPxls == 0)
+		{
+			return;
+		}
+		
+		try
+		{
+			if(numPxls > bulkValsSize)
+			{
+				if(bulkVals != NULL)
+				{
+					delete[] bulkVals;
+				}
+				bulkVals = new mu::value_type[numPxls];
+				bulkValsSize = numPxls;
+				bulkVarsBound = false;
+			}
+			if(!bulkVarsBound)
+			{
+				muParser->DefineVar(_T("b1"), bulkVals);
+				bulkVarsBound = true;
+			}
+			
+			// The expression is applied to each band in turn with a single bulk evaluation.
+			for(int i = 0; i < numBands; ++i)
+			{
+				float *inBandVals = blockData[i];
+				for(size_t j = 0; j < numPxls; ++j)
+				{
+					bulkVals[j] = inBandVals[j];
+				}
+				muParser->Eval(output[i], (int)numPxls);
+			}
+		}
+		catch (mu::ParserError &e)
+		{
+			std::string message = std::string("ERROR: ") + std::string(e.GetMsg()) + std::string(":\t \'") + std::string(e.GetExpr()) + std::string("\'");
+			throw RSGISImageCalcException(message);
+		}
+	}
+	
+	RSGISCalcImageValue* RSGISImageMaths::clone()
+	{
+		mu::Parser *parserCopy = new mu::Parser(*this->muParser);
+		RSGISImageMaths *imgMathsClone = new RSGISImageMaths(this->numOutBands, parserCopy, this->useBulkEval);
+		imgMathsClone->clonedParser = parserCopy;
+		return imgMathsClone;
+	}
+	
+	RSGISImageMaths::~RSGISImageMaths()
+	{
+		if(bulkVals != NULL)
+		{
+			delete[] bulkVals;
+		}
+		if(clonedParser != NULL)
+		{
+			delete clonedParser;
+		}
 	}
         
-    RSGISImageBandMaths::RSGISImageBandMaths(mu::Parser *muParser, int numBandVars, std::vector<std::string> bNames) : RSGISCalcImageValue(1)
+    RSGISImageBandMaths::RSGISImageBandMaths(mu::Parser *muParser, int numBandVars, std::vector<std::string> bNames, bool useBulkEval) : RSGISCalcImageValue(1)
     {
         this->numBandVars = numBandVars;
         this->muParser = muParser;
@@ -79,13 +158,21 @@ namespace rsgis{namespace img{
         {
             muParser->DefineVar(_T(bNames.at(i).c_str()), &inVals[i]);
         }
-        
+        this->clonedParser = NULL;
+        this->useBulkEval = useBulkEval;
+        this->bulkVals = NULL;
+        this->bulkValsSize = 0;
+        this->bulkVarsBound = false;
     }
     
     void RSGISImageBandMaths::calcImageValue(float *bandValues, int numBands, double *output) 
     {
         try
         {
+            if(bulkVarsBound)
+            {
+                this->bindPxlVars();
+            }
             for(int i = 0; i < numBands; ++i)
             {
                 inVals[i] = bandValues[i];
@@ -101,9 +188,100 @@ namespace rsgis{namespace img{
         }
     }
     
-    RSGISImageBandMaths::~RSGISImageBandMaths()
+    void RSGISImageBandMaths::calcImageValueBlock(float **blockData, int numBands, int width, int height, double **output)
     {
+        if(!this->useBulkEval)
+        {
+            RSGISCalcImageValue::calcImageValueBlock(blockData, numBands, width, height, output);
+            return;
+        }
         
+        if(numBands > numBandVars)
+        {
+            throw RSGISImageCalcException("The number of image bands is greater than the number of band variables.");
+        }
+        
+        size_t numPxls = ((size_t)width) * ((size_t)height);
+        if(numPxls == 0)
+        {
+            return;
+        }
+        
+        try
+        {
+            this->bindBulkVars(numPxls);
+            for(int i = 0; i < numBands; ++i)
+            {
+                float *inBandVals = blockData[i];
+                mu::value_type *varVals = &bulkVals[i*bulkValsSize];
+                for(size_t j = 0; j < numPxls; ++j)
+                {
+                    varVals[j] = inBandVals[j];
+                }
+            }
+            muParser->Eval(output[0], (int)numPxls);
+        }
+        catch (mu::ParserError &e)
+        {
+            std::string message = std::string("ERROR: ") + std::string(e.GetMsg()) + std::string(":\t \'") + std::string(e.GetExpr()) + std::string("\'");
+            throw RSGISImageCalcException(message);
+        }
+    }
+    
+    void RSGISImageBandMaths::bindBulkVars(size_t numPxls)
+    {
+        // muParser reads bulk variable values from (variable pointer + pixel index)
+        // so each variable needs a contiguous array of at least numPxls values.
+        if(numPxls > bulkValsSize)
+        {
+            if(bulkVals != NULL)
+            {
+                delete[] bulkVals;
+            }
+            // Zero so variables without an image band match the per-pixel path.
+            bulkVals = new mu::value_type[((size_t)numBandVars)*numPxls]();
+            bulkValsSize = numPxls;
+            bulkVarsBound = false;
+        }
+        
+        if(!bulkVarsBound)
+        {
+            for(int i = 0; i < numBandVars; ++i)
+            {
+                muParser->DefineVar(_T(bNames.at(i).c_str()), &bulkVals[i*bulkValsSize]);
+            }
+            bulkVarsBound = true;
+        }
+    }
+    
+    void RSGISImageBandMaths::bindPxlVars()
+    {
+        for(int i = 0; i < numBandVars; ++i)
+        {
+            muParser->DefineVar(_T(bNames.at(i).c_str()), &inVals[i]);
+        }
+        bulkVarsBound = false;
+    }
+    
+    RSGISCalcImageValue* RSGISImageBandMaths::clone()
+    {
+        mu::Parser *parserCopy = new mu::Parser(*this->muParser);
+        RSGISImageBandMaths *imgBandMathsClone = new RSGISImageBandMaths(parserCopy, this->numBandVars, this->bNames, this->useBulkEval);
+        imgBandMathsClone->clonedParser = parserCopy;
+        return imgBandMathsClone;
+    }
+    
+    RSGISImageBandMaths::~RSGISImageBandMaths()
+    {
+        delete[] inVals;
+        if(bulkVals != NULL)
+        {
+            delete[] bulkVals;
+        }
+        if(clonedParser != NULL)
+        {
+            delete clonedParser;
+        }
     }
     
     
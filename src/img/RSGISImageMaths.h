@@ -54,25 +54,41 @@ namespace rsgis{namespace img{
 	class DllExport RSGISImageMaths : public RSGISCalcImageValue
 	{
 	public: 
-		RSGISImageMaths(int numberOutBands, mu::Parser *muParser);
+		RSGISImageMaths(int numberOutBands, mu::Parser *muParser, bool useBulkEval=true);
 		void calcImageValue(float *bandValues, int numBands, double *output);
+        void calcImageValueBlock(float **blockData, int numBands, int width, int height, double **output);
+        RSGISCalcImageValue* clone();
         ~RSGISImageMaths();
 	private:
         mu::Parser *muParser;
         mu::value_type inVal;
+        mu::Parser *clonedParser;
+        bool useBulkEval;
+        mu::value_type *bulkVals;
+        size_t bulkValsSize;
+        bool bulkVarsBound;
 	};
     
     class DllExport RSGISImageBandMaths : public RSGISCalcImageValue
     {
     public:
-        RSGISImageBandMaths(mu::Parser *muParser, int numBandVars, std::vector<std::string> bNames);
+        RSGISImageBandMaths(mu::Parser *muParser, int numBandVars, std::vector<std::string> bNames, bool useBulkEval=true);
         void calcImageValue(float *bandValues, int numBands, double *output);
+        void calcImageValueBlock(float **blockData, int numBands, int width, int height, double **output);
+        RSGISCalcImageValue* clone();
         ~RSGISImageBandMaths();
     private:
+        void bindBulkVars(size_t numPxls);
+        void bindPxlVars();
         mu::Parser *muParser;
         int numBandVars;
         mu::value_type *inVals;
         std::vector<std::string> bNames;
+        mu::Parser *clonedParser;
+        bool useBulkEval;
+        mu::value_type *bulkVals;
+        size_t bulkValsSize;
+        bool bulkVarsBound;
     };
     
     class DllExport RSGISAllBandsEqualTo : public RSGISCalcImageValue
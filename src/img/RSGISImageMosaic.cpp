@@ -250,7 +250,7 @@ namespace rsgis{namespace img{
 		GDALClose(outputDataset);
 	}
 
-	void RSGISImageMosaic::mosaicSkipVals(std::string *inputImages, int numDS, std::string outputImage, float background, float skipVal, bool projFromImage, std::string proj, unsigned int skipBand, unsigned int overlapBehaviour, std::string format, GDALDataType imgDataType)
+	void RSGISImageMosaic::mosaicSkipVals(std::string *inputImages, int numDS, std::string outputImage, float background, float skipVal, bool projFromImage, std::string proj, unsigned int skipBand, unsigned int overlapBehaviour, std::string format, GDALDataType imgDataType, unsigned int numThreads)
 	{
 		RSGISImageUtils imgUtils;
 		rsgis::math::RSGISMathsUtils mathsUtils;
@@ -260,24 +260,17 @@ namespace rsgis{namespace img{
         GDALRasterBand *imgBand = NULL;
 		int width;
 		int height;
-		double *transformation = new double[6];
-		double *imgTransform = new double[6];
+		std::vector<double> transformation(6);
+		std::vector<double> imgTransform(6);
 		int numberBands = 0;
-		int tileXSize = 0;
-		int tileYSize = 0;
-		double xDiff = 0;
-		double yDiff = 0;
-		int xStart = 0;
-		int yStart = 0;
 		std::string projection = proj;
 		GDALDataset *outputDataset = NULL;
-		GDALRasterBand **inputRasterBands = NULL;
-		GDALRasterBand **outputRasterBands = NULL;
-		float **inputData = NULL;
-		float **outputData = NULL;
-		bool pixelsChanged;
 
         std::vector<std::string> bandnames;
+        std::vector<double> imgTLXs(numDS);
+        std::vector<double> imgTLYs(numDS);
+        std::vector<long> imgXSizes(numDS);
+        std::vector<long> imgYSizes(numDS);
 
 		try
 		{
@@ -311,316 +304,237 @@ namespace rsgis{namespace img{
                                     + inputImages[i] + " has " + mathsUtils.doubletostring(dataset->GetRasterCount()) );
 					}
 				}
+                dataset->GetGeoTransform(imgTransform.data());
+                imgTLXs[i] = imgTransform[0];
+                imgTLYs[i] = imgTransform[3];
+                imgXSizes[i] = dataset->GetRasterXSize();
+                imgYSizes[i] = dataset->GetRasterYSize();
                 GDALClose(dataset);
 			}
+            if(skipBand >= ((unsigned int)numberBands))
+            {
+                throw RSGISImageBandException("The skip band is not within the input images.");
+            }
+            if(numThreads == 0)
+            {
+                numThreads = 1;
+            }
 
-			imgUtils.getImagesExtent(inputImages, numDS, &width, &height, transformation);
+			imgUtils.getImagesExtent(inputImages, numDS, &width, &height, transformation.data());
 
             // Create blank image
 			std::cout << "Create new image [" << width << "," << height << "] with projection: \n" << projection << std::endl;
 
-			outputDataset = imgUtils.createBlankImage(outputImage, transformation, width, height, numberBands, projection, background, bandnames, format, imgDataType);
+			outputDataset = imgUtils.createBlankImage(outputImage, transformation.data(), width, height, numberBands, projection, background, bandnames, format, imgDataType);
 
-			// COPY IMAGE DATA INTO THE BLANK IMAGE
+            // The blank image holds the background as stored in the output data type.
+            float outBackground = background;
+            std::vector<GByte> quantBuffer;
+            this->quantiseToDataType(&outBackground, 1, imgDataType, quantBuffer);
 
             //Get Image Output Bands
-            outputRasterBands = new GDALRasterBand*[numberBands];
+            std::vector<GDALRasterBand*> outputRasterBands(numberBands);
             for(int i = 0; i < numberBands; i++)
             {
                 outputRasterBands[i] = outputDataset->GetRasterBand(i+1);
             }
 
+            // The output is processed in tiles which are a multiple of the image block size
+            // so each output block is only written once.
             int xBlockSize = 0;
             int yBlockSize = 0;
             outputRasterBands[0]->GetBlockSize (&xBlockSize, &yBlockSize);
-
-			std::cout << "Started (total " << numDS << ") ." << std::flush;
-
-            for(int ds = 0; ds < numDS; ds++)
-			{
-				std::cout << "." << ds+1 << "." << std::flush;
-
-                dataset = (GDALDataset *) GDALOpenShared(inputImages[ds].c_str(), GA_ReadOnly);
-                if(dataset == NULL)
-                {
-                    std::string message = std::string("Could not open image ") + inputImages[ds];
-                    throw RSGISImageException(message.c_str());
-                }
-
-                inputRasterBands = new GDALRasterBand*[numberBands];
-                for(int i = 0; i < numberBands; i++)
-                {
-                    inputRasterBands[i] = dataset->GetRasterBand(i+1);
-                }
-
-				dataset->GetGeoTransform(imgTransform);
-				tileXSize = dataset->GetRasterXSize();
-				tileYSize = dataset->GetRasterYSize();
-
-				xDiff = imgTransform[0] - transformation[0];
-				yDiff = transformation[3] - imgTransform[3];
-
-				xStart = floor((xDiff/transformation[1])+0.5);
-				yStart = floor((yDiff/transformation[1])+0.5);
-
-                // Allocate memory
-                inputData = new float*[numberBands];
-                outputData = new float*[numberBands];
-                for(int i = 0; i < numberBands; i++)
-                {
-                    inputData[i] = (float *) CPLMalloc(sizeof(float)*(tileXSize*yBlockSize));
-                    outputData[i] = (float *) CPLMalloc(sizeof(float)*(tileXSize*yBlockSize));
-                }
-
-                int nYBlocks = tileYSize / yBlockSize;
-                int remainRows = tileYSize - (nYBlocks * yBlockSize);
-                int rowOffset = 0;
-
-                for(int i = 0; i < nYBlocks; i++)
-                {
-                    // Read input and output data
-                    for(int n = 0; n < numberBands; n++)
-                    {
-                        rowOffset = yBlockSize * i;
-                        // Read input data
-                        inputRasterBands[n]->RasterIO(GF_Read, 0, rowOffset, tileXSize, yBlockSize, inputData[n], tileXSize, yBlockSize, GDT_Float32, 0, 0);
-                        // Read output data
-                        outputRasterBands[n]->RasterIO(GF_Read, xStart, (yStart + rowOffset), tileXSize, yBlockSize, outputData[n], tileXSize, yBlockSize, GDT_Float32, 0, 0);
-                    }
-
-                    pixelsChanged = false; // Keep track if there are changes that need writing out.
-
-                    for(int m = 0; m < yBlockSize; ++m)
+            const long targetTileSize = 1024;
+            long tileXSize = (xBlockSize < targetTileSize)?((targetTileSize / xBlockSize) * xBlockSize):targetTileSize;
+            long tileYSize = (yBlockSize < targetTileSize)?((targetTileSize / yBlockSize) * yBlockSize):targetTileSize;
+            tileXSize = std::min(tileXSize, (long)width);
+            tileYSize = std::min(tileYSize, (long)height);
+            long nXTiles = (width + tileXSize - 1) / tileXSize;
+            long nYTiles = (height + tileYSize - 1) / tileYSize;
+            size_t numTiles = nXTiles * nYTiles;
+
+            // R-tree of the input image footprints (in output pixel coordinates) to find
+            // the images contributing to each output tile.
+            std::vector<RSGISMosaicFootprint> footprints;
+            for(int i = 0; i < numDS; i++)
+            {
+                long xStart = floor(((imgTLXs[i] - transformation[0])/transformation[1])+0.5);
+                long yStart = floor(((transformation[3] - imgTLYs[i])/transformation[1])+0.5);
+                RSGISMosaicPxlBox pxlBox(RSGISMosaicPxlPt(xStart, yStart), RSGISMosaicPxlPt(xStart + imgXSizes[i] - 1, yStart + imgYSizes[i] - 1));
+                footprints.push_back(RSGISMosaicFootprint(pxlBox, i));
+            }
+            boost::geometry::index::rtree<RSGISMosaicFootprint, boost::geometry::index::quadratic<16> > footprintIdx(footprints.begin(), footprints.end());
+
+			std::cout << "Mosaic " << numDS << " images in " << numTiles << " tiles.\n";
+            rsgis_tqdm pbar;
+            std::atomic<size_t> nextTile(0);
+            size_t numTilesDone = 0;
+            std::mutex writeMutex;
+            std::vector<std::exception_ptr> threadErrors(numThreads);
+            std::vector<std::thread> threads;
+            for(unsigned int t = 0; t < numThreads; ++t)
+            {
+                threads.push_back(std::thread([&, t]()
+                {
+                    // Each thread uses its own dataset handles, which are kept open
+                    // between tiles; the least recently used is closed if there are
+                    // more than RSGIS_MOSAIC_MAX_OPEN_IMGS open.
+                    std::vector<GDALDataset*> inDatasets(numDS, NULL);
+                    std::vector<size_t> inDatasetsLastUsed(numDS, 0);
+                    std::vector<int> openDatasets;
+                    try
                     {
-                        for(int j = 0; j < tileXSize; j++)
+                        size_t tileBandLen = tileXSize * tileYSize;
+                        std::vector<float> outputData(tileBandLen * numberBands);
+                        std::vector<float> inputData(tileBandLen * numberBands);
+                        std::vector<GByte> threadQuantBuffer;
+                        std::vector<RSGISMosaicFootprint> tileImgs;
+                        size_t numThreadTiles = 0;
+                        for(size_t tile = nextTile++; tile < numTiles; tile = nextTile++)
                         {
-                            // Check for skip value
-                            if(inputData[skipBand][(m*tileXSize)+j] != skipVal)
+                            ++numThreadTiles;
+                            long tileXOff = (tile % nXTiles) * tileXSize;
+                            long tileYOff = (tile / nXTiles) * tileYSize;
+                            long tileWidth = std::min(tileXSize, width - tileXOff);
+                            long tileHeight = std::min(tileYSize, height - tileYOff);
+                            std::fill(outputData.begin(), outputData.end(), outBackground);
+
+                            // The images are added in the order they were provided.
+                            tileImgs.clear();
+                            RSGISMosaicPxlBox tileBox(RSGISMosaicPxlPt(tileXOff, tileYOff), RSGISMosaicPxlPt(tileXOff + tileWidth - 1, tileYOff + tileHeight - 1));
+                            footprintIdx.query(boost::geometry::index::intersects(tileBox), std::back_inserter(tileImgs));
+                            std::sort(tileImgs.begin(), tileImgs.end(), [](const RSGISMosaicFootprint &a, const RSGISMosaicFootprint &b){ return a.second < b.second; });
+
+                            for(std::vector<RSGISMosaicFootprint>::iterator iterImg = tileImgs.begin(); iterImg != tileImgs.end(); ++iterImg)
                             {
-                                // Check if behaviour is defined for overlap and not the first image
-                                if( (overlapBehaviour > 0) && (ds > 0) )
+                                int ds = (*iterImg).second;
+                                long xStart = (*iterImg).first.min_corner().get<0>();
+                                long yStart = (*iterImg).first.min_corner().get<1>();
+                                long xOff = std::max(tileXOff, xStart);
+                                long yOff = std::max(tileYOff, yStart);
+                                long xEnd = std::min(tileXOff + tileWidth, xStart + imgXSizes[ds]);
+                                long yEnd = std::min(tileYOff + tileHeight, yStart + imgYSizes[ds]);
+                                long winWidth = xEnd - xOff;
+                                long winHeight = yEnd - yOff;
+                                if((winWidth <= 0) || (winHeight <= 0))
                                 {
-                                    // Check if pixel is background value (no data has been written yet)
-                                    if( outputData[skipBand][(m*tileXSize)+j] == background )
-                                    {
-                                        for(int n = 0; n < numberBands; n++)
-                                        {
-                                            outputData[n][(m*tileXSize)+j] = inputData[n][(m*tileXSize)+j];
-                                        }
-                                        pixelsChanged = true;
-                                    }
-                                    // If data has been written - check if new value is less (min overlap behaviour)
-                                    else if( (overlapBehaviour == 1) &&  (inputData[skipBand][(m*tileXSize)+j] < outputData[skipBand][(m*tileXSize)+j]) )
+                                    continue;
+                                }
+
+                                if(inDatasets[ds] == NULL)
+                                {
+                                    if(openDatasets.size() >= RSGIS_MOSAIC_MAX_OPEN_IMGS)
                                     {
-                                        for(int n = 0; n < numberBands; n++)
-                                        {
-                                            outputData[n][(m*tileXSize)+j] = inputData[n][(m*tileXSize)+j];
-                                        }
-                                        pixelsChanged = true;
+                                        std::vector<int>::iterator iterLRU = std::min_element(openDatasets.begin(), openDatasets.end(), [&](int a, int b){ return inDatasetsLastUsed[a] < inDatasetsLastUsed[b]; });
+                                        GDALClose(inDatasets[*iterLRU]);
+                                        inDatasets[*iterLRU] = NULL;
+                                        openDatasets.erase(iterLRU);
                                     }
-                                    // If data has been written - check if new value is greater (max overlap behaviour)
-                                    else if( (overlapBehaviour == 2) &&  (inputData[skipBand][(m*tileXSize)+j] > outputData[skipBand][(m*tileXSize)+j]) )
+                                    inDatasets[ds] = (GDALDataset *) GDALOpen(inputImages[ds].c_str(), GA_ReadOnly);
+                                    if(inDatasets[ds] == NULL)
                                     {
-                                        for(int n = 0; n < numberBands; n++)
-                                        {
-                                            outputData[n][(m*tileXSize)+j] = inputData[n][(m*tileXSize)+j];
-                                        }
-                                        pixelsChanged = true;
+                                        std::string message = std::string("Could not open image ") + inputImages[ds];
+                                        throw RSGISImageException(message.c_str());
                                     }
+                                    openDatasets.push_back(ds);
                                 }
-                                // If no overlap behaviour defined, write out,
-                                else
+                                inDatasetsLastUsed[ds] = numThreadTiles;
+                                for(int n = 0; n < numberBands; n++)
                                 {
-                                    for(int n = 0; n < numberBands; n++)
+                                    if(inDatasets[ds]->GetRasterBand(n+1)->RasterIO(GF_Read, xOff - xStart, yOff - yStart, winWidth, winHeight, &inputData[n * tileBandLen], winWidth, winHeight, GDT_Float32, 0, 0) != CE_None)
                                     {
-                                        outputData[n][(m*tileXSize)+j] = inputData[n][(m*tileXSize)+j];
+                                        std::string message = std::string("Could not read image ") + inputImages[ds];
+                                        throw RSGISImageException(message.c_str());
                                     }
-                                    pixelsChanged = true;
                                 }
 
-
-                            }
-                        }
-                    }
-
-                    // Write out data to mosaic
-                    if(pixelsChanged)
-                    {
-                        for(int n = 0; n < numberBands; n++)
-                        {
-                            outputRasterBands[n]->RasterIO(GF_Write, xStart, (yStart + rowOffset), tileXSize, yBlockSize, outputData[n], tileXSize, yBlockSize, GDT_Float32, 0, 0);
-                        }
-                    }
-
-                }
-
-                if(remainRows > 0)
-                {
-                    for(int n = 0; n < numberBands; n++)
-                    {
-                        rowOffset = yBlockSize * nYBlocks;
-                        // Read input data
-                        inputRasterBands[n]->RasterIO(GF_Read, 0, rowOffset, tileXSize, remainRows, inputData[n], tileXSize, remainRows, GDT_Float32, 0, 0);
-                        // Read output data
-                        outputRasterBands[n]->RasterIO(GF_Read, xStart, (yStart + rowOffset), tileXSize, remainRows, outputData[n], tileXSize, remainRows, GDT_Float32, 0, 0);
-                    }
-
-                    pixelsChanged = false; // Keep track if there are changes that need writing out.
-
-                    for(int m = 0; m < remainRows; ++m)
-                    {
-                        for(int j = 0; j < tileXSize; j++)
-                        {
-                            // Check for skip value
-                            if(inputData[skipBand][(m*tileXSize)+j] != skipVal)
-                            {
-                                // Check if behaviour is defined for overlap and not the first image
-                                if( (overlapBehaviour > 0) && (ds > 0) )
+                                const float *inSkipData = &inputData[skipBand * tileBandLen];
+                                const float *outSkipData = &outputData[skipBand * tileBandLen];
+                                for(long m = 0; m < winHeight; ++m)
                                 {
-                                    // Check if pixel is background value (no data has been written yet)
-                                    if( outputData[skipBand][(m*tileXSize)+j] == background )
+                                    for(long j = 0; j < winWidth; ++j)
                                     {
-                                        for(int n = 0; n < numberBands; n++)
+                                        size_t inIdx = (m * winWidth) + j;
+                                        size_t outIdx = ((yOff - tileYOff + m) * tileWidth) + (xOff - tileXOff + j);
+                                        // Check for skip value
+                                        if(inSkipData[inIdx] == skipVal)
                                         {
-                                            outputData[n][(m*tileXSize)+j] = inputData[n][(m*tileXSize)+j];
+                                            continue;
                                         }
-                                        pixelsChanged = true;
-                                    }
-                                    // If data has been written - check if new value is less (min overlap behaviour)
-                                    else if( (overlapBehaviour == 1) &&  (inputData[skipBand][(m*tileXSize)+j] < outputData[skipBand][(m*tileXSize)+j]) )
-                                    {
-                                        for(int n = 0; n < numberBands; n++)
+                                        bool copyPxl = true;
+                                        // Check if behaviour is defined for overlap and not the first image
+                                        if((overlapBehaviour > 0) && (ds > 0) && (outSkipData[outIdx] != background))
                                         {
-                                            outputData[n][(m*tileXSize)+j] = inputData[n][(m*tileXSize)+j];
+                                            // Data has been written - check if new value is less (min) or greater (max)
+                                            copyPxl = ((overlapBehaviour == 1) && (inSkipData[inIdx] < outSkipData[outIdx])) ||
+                                                      ((overlapBehaviour == 2) && (inSkipData[inIdx] > outSkipData[outIdx]));
                                         }
-                                        pixelsChanged = true;
-                                    }
-                                    // If data has been written - check if new value is greater (max overlap behaviour)
-                                    else if( (overlapBehaviour == 2) &&  (inputData[skipBand][(m*tileXSize)+j] > outputData[skipBand][(m*tileXSize)+j]) )
-                                    {
-                                        for(int n = 0; n < numberBands; n++)
+                                        if(copyPxl)
                                         {
-                                            outputData[n][(m*tileXSize)+j] = inputData[n][(m*tileXSize)+j];
+                                            for(int n = 0; n < numberBands; n++)
+                                            {
+                                                outputData[(n * tileBandLen) + outIdx] = inputData[(n * tileBandLen) + inIdx];
+                                            }
                                         }
-                                        pixelsChanged = true;
                                     }
                                 }
-                                // If no overlap behaviour defined, write out,
-                                else
+
+                                // Later images are compared with the values as stored in the output image.
+                                for(int n = 0; n < numberBands; n++)
                                 {
-                                    for(int n = 0; n < numberBands; n++)
+                                    for(long m = 0; m < winHeight; ++m)
                                     {
-                                        outputData[n][(m*tileXSize)+j] = inputData[n][(m*tileXSize)+j];
+                                        size_t outIdx = ((yOff - tileYOff + m) * tileWidth) + (xOff - tileXOff);
+                                        this->quantiseToDataType(&outputData[(n * tileBandLen) + outIdx], winWidth, imgDataType, threadQuantBuffer);
                                     }
-                                    pixelsChanged = true;
                                 }
-
-
                             }
-                        }
-                    }
 
-                    // Write out data
-                    if(pixelsChanged)
-                    {
-                        for(int n = 0; n < numberBands; n++)
-                        {
-                            outputRasterBands[n]->RasterIO(GF_Write, xStart, (yStart + rowOffset), tileXSize, remainRows, outputData[n], tileXSize, remainRows, GDT_Float32, 0, 0);
+                            std::lock_guard<std::mutex> writeLock(writeMutex);
+                            for(int n = 0; n < numberBands; n++)
+                            {
+                                if(outputRasterBands[n]->RasterIO(GF_Write, tileXOff, tileYOff, tileWidth, tileHeight, &outputData[n * tileBandLen], tileWidth, tileHeight, GDT_Float32, 0, 0) != CE_None)
+                                {
+                                    throw RSGISImageException("Could not write to the output image.");
+                                }
+                            }
+                            pbar.progress(numTilesDone++, numTiles);
                         }
                     }
-
-                }
-
-                // Tidy up
-                if(inputData != NULL)
-                {
-                    for(int i = 0; i < numberBands; i++)
+                    catch(...)
                     {
-                        if(inputData[i] != NULL)
-                        {
-                            delete[] inputData[i];
-                        }
+                        threadErrors[t] = std::current_exception();
+                        // Stop the other threads taking new tiles.
+                        nextTile = numTiles;
                     }
-                    delete[] inputData;
-                }
-                if(outputData != NULL)
-                {
-                    for(int i = 0; i < numberBands; i++)
+                    for(std::vector<int>::iterator iterDS = openDatasets.begin(); iterDS != openDatasets.end(); ++iterDS)
                     {
-                        if(outputData[i] != NULL)
-                        {
-                            delete[] outputData[i];
-                        }
+                        GDALClose(inDatasets[*iterDS]);
                     }
-                    delete[] outputData;
-                }
-                if(inputRasterBands != NULL)
-                {
-                    delete[] inputRasterBands;
-                }
-
-                GDALClose(dataset);
-			}
-			std::cout << ".complete\n";
-
-		}
-		catch(RSGISImageBandException &e)
-		{
-            if(inputData != NULL)
+                }));
+            }
+            for(std::vector<std::thread>::iterator iterThreads = threads.begin(); iterThreads != threads.end(); ++iterThreads)
             {
-                for(int i = 0; i < numberBands; i++)
-                {
-                    if(inputData[i] != NULL)
-                    {
-                        delete[] inputData[i];
-                    }
-                }
-                delete[] inputData;
+                (*iterThreads).join();
             }
-            if(outputData != NULL)
+            pbar.finish();
+            for(std::vector<std::exception_ptr>::iterator iterErr = threadErrors.begin(); iterErr != threadErrors.end(); ++iterErr)
             {
-                for(int i = 0; i < numberBands; i++)
+                if(*iterErr)
                 {
-                    if(outputData[i] != NULL)
-                    {
-                        delete[] outputData[i];
-                    }
+                    std::rethrow_exception(*iterErr);
                 }
-                delete[] outputData;
-            }
-            if(inputRasterBands != NULL)
-            {
-                delete[] inputRasterBands;
             }
-            if(outputRasterBands != NULL)
+		}
+		catch(...)
+		{
+            if(outputDataset != NULL)
             {
-                delete[] outputRasterBands;
+                GDALClose(outputDataset);
             }
-			if(transformation != NULL)
-			{
-				delete[] transformation;
-			}
-			if(imgTransform != NULL)
-			{
-				delete[] imgTransform;
-			}
-			throw e;
+			throw;
 		}
 
-        // Tidy
-        if(outputRasterBands != NULL)
-        {
-            delete[] outputRasterBands;
-        }
-
-		if(transformation != NULL)
-		{
-			delete[] transformation;
-		}
-		if(imgTransform != NULL)
-		{
-			delete[] imgTransform;
-		}
 		GDALClose(outputDataset);
 	}
 
@@ -1811,6 +1725,19 @@ namespace rsgis{namespace img{
         }
     }
 
+    void RSGISImageMosaic::quantiseToDataType(float *data, size_t numVals, GDALDataType dataType, std::vector<GByte> &buffer)
+    {
+        if((dataType == GDT_Float32) || (dataType == GDT_Float64) || (numVals == 0))
+        {
+            return;
+        }
+        // Uses the same conversion (rounding and clamping) as GDAL when writing the image.
+        int typeSize = GDALGetDataTypeSizeBytes(dataType);
+        buffer.resize(numVals * typeSize);
+        GDALCopyWords(data, GDT_Float32, sizeof(float), buffer.data(), dataType, typeSize, (int)numVals);
+        GDALCopyWords(buffer.data(), dataType, typeSize, data, GDT_Float32, sizeof(float), (int)numVals);
+    }
+
 	RSGISImageMosaic::~RSGISImageMosaic()
 	{
 
@@ -30,6 +30,15 @@
 
 #include <iostream>
 #include <string>
+#include <vector>
+#include <algorithm>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <exception>
+
+#include <boost/geometry.hpp>
+#include <boost/geometry/index/rtree.hpp>
 
 #include "libkea/KEAImageIO.h"
 
@@ -40,6 +49,8 @@
 #include "img/RSGISImageUtils.h"
 #include "img/RSGISCalcImage.h"
 
+#define RSGIS_MOSAIC_MAX_OPEN_IMGS 64 // Maximum number of input images each mosaic thread keeps open.
+
 // mark all exported classes/functions with DllExport to have
 // them exported by Visual Studio
 #undef DllExport
@@ -64,6 +75,11 @@ namespace rsgis{namespace img{
         double validPxlFunc;
     };
     
+    /** The pixel footprint of an input image within the mosaic and its index within the list of input images */
+    typedef boost::geometry::model::point<long, 2, boost::geometry::cs::cartesian> RSGISMosaicPxlPt;
+    typedef boost::geometry::model::box<RSGISMosaicPxlPt> RSGISMosaicPxlBox;
+    typedef std::pair<RSGISMosaicPxlBox, int> RSGISMosaicFootprint;
+    
     inline bool compare_ImageValidPxlCounts (const RSGISImageValidDataMetric& first, const RSGISImageValidDataMetric& second)
     {
         return ( first.validPxlFunc < second.validPxlFunc );
@@ -76,18 +92,29 @@ namespace rsgis{namespace img{
       1 - overwrite mosaic if new pixel value is smaller (min)
       2 - overwrite mosaic if new pixel value is larger (max)
      
+     mosaicSkipVals iterates over tiles of the output image, using an R-tree of the
+     input image footprints to find the images which contribute to each tile. Each
+     tile is read from those images, merged in the order the images were provided
+     and written once; tiles are processed in parallel using numThreads. Each thread
+     keeps the most recently used input images open. The merged values are rounded
+     to the output data type so the overlap comparisons are made with the values
+     which would be read back from the output image.
+     
      */
     {
     public:
         RSGISImageMosaic();
         void mosaic(std::string *inputImages, int numDS, std::string outputImage, float background, bool projFromImage, std::string proj, std::string format="ENVI", GDALDataType imgDataType=GDT_Float32);
-        void mosaicSkipVals(std::string *inputImages, int numDS, std::string outputImage, float background, float skipVal, bool projFromImage, std::string proj, unsigned int skipBand = 0, unsigned int overlapBehaviour = 0, std::string format="KEA", GDALDataType imgDataType=GDT_Float32);
+        void mosaicSkipVals(std::string *inputImages, int numDS, std::string outputImage, float background, float skipVal, bool projFromImage, std::string proj, unsigned int skipBand = 0, unsigned int overlapBehaviour = 0, std::string format="KEA", GDALDataType imgDataType=GDT_Float32, unsigned int numThreads=1);
         void mosaicSkipThresh(std::string *inputImages, int numDS, std::string outputImage, float background, float skipLowerThresh, float skipUpperThresh, bool projFromImage, std::string proj, unsigned int threshBand = 0, unsigned int overlapBehaviour = 0, std::string format="KEA", GDALDataType imgDataType=GDT_Float32);
         void includeDatasets(GDALDataset *baseImage, std::string *inputImages, int numDS, std::vector<int> bands, bool bandsDefined);
         void includeDatasetsSkipVals(GDALDataset *baseImage, std::string *inputImages, int numDS, std::vector<int> bands, bool bandsDefined, float skipVal);
         void includeDatasetsIgnoreOverlap(GDALDataset *baseImage, std::string *inputImages, int numDS, int numOverlapPxls);
         void orderInImagesValidData(std::vector<std::string> images, std::vector<std::string> *orderedImages, float noDataValue);
         ~RSGISImageMosaic();
+    protected:
+        /** Round the values to those which can be stored in the output data type, as a write and read back of the output image would. */
+        void quantiseToDataType(float *data, size_t numVals, GDALDataType dataType, std::vector<GByte> &buffer);
     };
     
     class DllExport RSGISCountValidPixels : public RSGISCalcImageValue
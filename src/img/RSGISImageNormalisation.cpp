@@ -138,6 +138,42 @@ namespace rsgis{namespace img{
 		}
 	}
 
+	void RSGISNormaliseImage::calcImageValueBlock(float **blockData, int numBands, int width, int height, double **output)
+	{
+		size_t numPxls = ((size_t)width) * ((size_t)height);
+		double inDiff = 0;
+		double norm2min = 0;
+		double outDiff = 0;
+		for(int i = 0; i < numBands; i++)
+		{
+			float *inBandVals = blockData[i];
+			double *outBandVals = output[i];
+			inDiff = imageMax[i] - imageMin[i];
+			outDiff = outMax[i] - outMin[i];
+			for(size_t j = 0; j < numPxls; j++)
+			{
+				if(inBandVals[j] < imageMin[i])
+				{
+					outBandVals[j] = outMin[i];
+				}
+				else if(inBandVals[j] > imageMax[i])
+				{
+					outBandVals[j] = outMax[i];
+				}
+				else 
+				{
+					norm2min = inBandVals[j] - imageMin[i];
+					outBandVals[j] = ((norm2min/inDiff)*outDiff)+outMin[i];
+				}
+			}
+		}
+	}
+	
+	RSGISCalcImageValue* RSGISNormaliseImage::clone()
+	{
+		return new RSGISNormaliseImage(this->numOutBands, this->imageMax, this->imageMin, this->outMax, this->outMin);
+	}
+
 	RSGISNormaliseImage::~RSGISNormaliseImage()
 	{
 		
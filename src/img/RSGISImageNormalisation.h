@@ -62,6 +62,8 @@ namespace rsgis{namespace img{
 		public: 
 			RSGISNormaliseImage(int numberOutBands, double *imageMaxIn, double *imageMinIn, double *outMaxIn, double *outMinIn);
 			void calcImageValue(float *bandValues, int numBands, double *output);
+			void calcImageValueBlock(float **blockData, int numBands, int width, int height, double **output);
+			RSGISCalcImageValue* clone();
 			~RSGISNormaliseImage();
 		protected:
 			double *imageMax;
@@ -953,19 +953,130 @@ namespace rsgis{namespace img{
         
     }
     
-    rsgis::math::Matrix* RSGISImagePercentiles::getPercentilesForAllBands(GDALDataset* dataset, float percentile, float noDataVal, bool noDataDefined)
+    void RSGISImagePercentiles::calcBandPercentiles(GDALDataset *dataset, std::vector<unsigned int> bands, std::vector<float> percentiles, float noDataVal, bool noDataDefined, std::vector< std::vector<double> > *outPercentiles)
     {
-        rsgis::math::RSGISMatrices matrixUtils;
-        rsgis::math::Matrix *outPercentiles = NULL;
         try
         {
-            unsigned numImageBands = dataset->GetRasterCount();
-            outPercentiles = matrixUtils.createMatrix(numImageBands, 1);
-            for(unsigned int n = 0; n < numImageBands; ++n)
+            const size_t numBins = 65536;
+            unsigned int numBands = bands.size();
+            unsigned int numPercentiles = percentiles.size();
+            for(unsigned int b = 0; b < numBands; ++b)
+            {
+                if((bands[b] == 0) || (bands[b] > (unsigned int)dataset->GetRasterCount()))
+                {
+                    throw RSGISImageCalcException("Band is not within the image (band numbering starts at 1).");
+                }
+            }
+            for(unsigned int p = 0; p < numPercentiles; ++p)
+            {
+                if(!((percentiles[p] >= 0) && (percentiles[p] <= 1)))
+                {
+                    throw RSGISImageCalcException("Percentile value must be between 0 - 1.");
+                }
+            }
+            outPercentiles->assign(numBands, std::vector<double>(numPercentiles, 0.0));
+            if((numBands == 0) || (numPercentiles == 0))
             {
-                std::cout << "\tCalculating Percentile " << percentile << " of band " << n+1 << std::flush;
-                outPercentiles->matrix[n] = this->getPercentile(dataset, n+1, percentile, noDataVal, noDataDefined);
-                std::cout << " = " << outPercentiles->matrix[n] << std::endl;
+                return;
+            }
+            
+            // Pass 1: histogram of the upper 16 bits of the keys.
+            std::vector< std::vector< std::vector<uint64_t> > > hists(numBands, std::vector< std::vector<uint64_t> >(1, std::vector<uint64_t>(numBins, 0)));
+            this->calcKeyHistograms(dataset, bands, noDataVal, noDataDefined, NULL, &hists);
+            
+            // For each percentile find the ranks required (as gsl_stats_quantile_from_sorted_data)
+            // and the upper bin in which each rank falls.
+            std::vector<uint64_t> numVals(numBands, 0);
+            std::vector< std::vector<uint64_t> > ranks(numBands);
+            std::vector< std::vector<double> > deltas(numBands);
+            std::vector< std::vector<uint32_t> > rankBins(numBands);
+            std::vector< std::vector<uint64_t> > rankInBins(numBands);
+            std::vector< std::vector<int> > binTargets(numBands, std::vector<int>(numBins, -1));
+            std::vector< std::vector< std::vector<uint64_t> > > loHists(numBands);
+            for(unsigned int b = 0; b < numBands; ++b)
+            {
+                uint64_t *hiHist = hists[b][0].data();
+                for(size_t i = 0; i < numBins; ++i)
+                {
+                    numVals[b] += hiHist[i];
+                }
+                if(numVals[b] == 0)
+                {
+                    continue;
+                }
+                
+                for(unsigned int p = 0; p < numPercentiles; ++p)
+                {
+                    double index = ((double)percentiles[p]) * (numVals[b] - 1);
+                    uint64_t lhs = (uint64_t)index;
+                    double delta = index - lhs;
+                    ranks[b].push_back(lhs);
+                    deltas[b].push_back(delta);
+                    if((lhs < (numVals[b] - 1)) && (delta > 0))
+                    {
+                        ranks[b].push_back(lhs + 1);
+                    }
+                    else
+                    {
+                        ranks[b].push_back(lhs);
+                    }
+                }
+                
+                for(size_t r = 0; r < ranks[b].size(); ++r)
+                {
+                    uint64_t cumCount = 0;
+                    size_t bin = 0;
+                    while((cumCount + hiHist[bin]) <= ranks[b][r])
+                    {
+                        cumCount += hiHist[bin];
+                        ++bin;
+                    }
+                    rankBins[b].push_back(bin);
+                    rankInBins[b].push_back(ranks[b][r] - cumCount);
+                    if(binTargets[b][bin] < 0)
+                    {
+                        binTargets[b][bin] = loHists[b].size();
+                        loHists[b].push_back(std::vector<uint64_t>(numBins, 0));
+                    }
+                }
+                std::vector< std::vector<uint64_t> >().swap(hists[b]);
+            }
+            
+            // Pass 2: histograms of the lower 16 bits of the keys within the upper bins.
+            this->calcKeyHistograms(dataset, bands, noDataVal, noDataDefined, &binTargets, &loHists);
+            
+            for(unsigned int b = 0; b < numBands; ++b)
+            {
+                if(numVals[b] == 0)
+                {
+                    continue;
+                }
+                std::vector<double> rankVals;
+                for(size_t r = 0; r < ranks[b].size(); ++r)
+                {
+                    uint64_t *loHist = loHists[b][binTargets[b][rankBins[b][r]]].data();
+                    uint64_t cumCount = 0;
+                    size_t bin = 0;
+                    while((cumCount + loHist[bin]) <= rankInBins[b][r])
+                    {
+                        cumCount += loHist[bin];
+                        ++bin;
+                    }
+                    rankVals.push_back(this->calcKeyFloat((rankBins[b][r] << 16) | ((uint32_t)bin)));
+                }
+                for(unsigned int p = 0; p < numPercentiles; ++p)
+                {
+                    double lhsVal = rankVals[p*2];
+                    double rhsVal = rankVals[(p*2)+1];
+                    if(ranks[b][(p*2)+1] == ranks[b][p*2])
+                    {
+                        (*outPercentiles)[b][p] = lhsVal;
+                    }
+                    else
+                    {
+                        (*outPercentiles)[b][p] = ((1 - deltas[b][p]) * lhsVal) + (deltas[b][p] * rhsVal);
+                    }
+                }
             }
         }
         catch (rsgis::RSGISImageException &e)
@@ -980,20 +1091,101 @@ namespace rsgis{namespace img{
         {
             throw rsgis::RSGISImageException(e.what());
         }
+    }
+    
+    void RSGISImagePercentiles::calcKeyHistograms(GDALDataset *dataset, std::vector<unsigned int> &bands, float noDataVal, bool noDataDefined, std::vector< std::vector<int> > *binTargets, std::vector< std::vector< std::vector<uint64_t> > > *hists)
+    {
+        unsigned int numBands = bands.size();
+        unsigned int width = dataset->GetRasterXSize();
+        unsigned int height = dataset->GetRasterYSize();
+        int blockSizeX = 0;
+        int blockSizeY = 0;
+        dataset->GetRasterBand(bands[0])->GetBlockSize(&blockSizeX, &blockSizeY);
+        if(blockSizeY < 1)
+        {
+            blockSizeY = 1;
+        }
+        float *imgData = new float[((size_t)width)*blockSizeY];
         
+        rsgis_tqdm pbar;
+        for(unsigned int yOff = 0; yOff < height; yOff += blockSizeY)
+        {
+            pbar.progress(yOff, height);
+            unsigned int nRows = std::min((unsigned int)blockSizeY, height - yOff);
+            size_t bufSize = ((size_t)width)*nRows;
+            for(unsigned int b = 0; b < numBands; ++b)
+            {
+                if(dataset->GetRasterBand(bands[b])->RasterIO(GF_Read, 0, yOff, width, nRows, imgData, width, nRows, GDT_Float32, 0, 0) != CE_None)
+                {
+                    delete[] imgData;
+                    throw RSGISImageCalcException("Could not read image band.");
+                }
+                
+                if(binTargets == NULL)
+                {
+                    uint64_t *hiHist = (*hists)[b][0].data();
+                    for(size_t i = 0; i < bufSize; ++i)
+                    {
+                        float val = imgData[i];
+                        if(!(std::isnan(val) || (noDataDefined && (val == noDataVal))))
+                        {
+                            ++hiHist[this->calcFloatKey(val) >> 16];
+                        }
+                    }
+                }
+                else
+                {
+                    int *targets = (*binTargets)[b].data();
+                    std::vector< std::vector<uint64_t> > &loHists = (*hists)[b];
+                    if(loHists.empty())
+                    {
+                        continue;
+                    }
+                    for(size_t i = 0; i < bufSize; ++i)
+                    {
+                        float val = imgData[i];
+                        if(!(std::isnan(val) || (noDataDefined && (val == noDataVal))))
+                        {
+                            uint32_t key = this->calcFloatKey(val);
+                            int target = targets[key >> 16];
+                            if(target >= 0)
+                            {
+                                ++loHists[target][key & 0xFFFF];
+                            }
+                        }
+                    }
+                }
+            }
+        }
+        pbar.finish();
+        delete[] imgData;
+    }
+    
+    std::vector< std::vector<double> > RSGISImagePercentiles::getPercentilesForAllBands(GDALDataset* dataset, std::vector<float> percentiles, float noDataVal, bool noDataDefined)
+    {
+        std::vector<unsigned int> bands;
+        for(int n = 0; n < dataset->GetRasterCount(); ++n)
+        {
+            bands.push_back(n+1);
+        }
+        std::vector< std::vector<double> > outPercentiles;
+        this->calcBandPercentiles(dataset, bands, percentiles, noDataVal, noDataDefined, &outPercentiles);
         return outPercentiles;
     }
     
-    double RSGISImagePercentiles::getPercentile(GDALDataset *dataset, unsigned int band, float percentile, float noDataVal, bool noDataDefined)
+    rsgis::math::Matrix* RSGISImagePercentiles::getPercentilesForAllBands(GDALDataset* dataset, float percentile, float noDataVal, bool noDataDefined)
     {
-        double percentileVal = 0.0;
+        rsgis::math::RSGISMatrices matrixUtils;
+        rsgis::math::Matrix *outPercentiles = NULL;
         try
         {
-            RSGISImageUtils imageUtils;
-            std::vector<double> *dataVals = imageUtils.getImageBandValues(dataset, band, noDataDefined, noDataVal);
-            std::sort(dataVals->begin(), dataVals->end());            
-            percentileVal = gsl_stats_quantile_from_sorted_data(&(*dataVals)[0], 1, dataVals->size(), percentile);
-            delete dataVals;
+            std::vector< std::vector<double> > bandPercentiles = this->getPercentilesForAllBands(dataset, std::vector<float>(1, percentile), noDataVal, noDataDefined);
+            unsigned numImageBands = bandPercentiles.size();
+            outPercentiles = matrixUtils.createMatrix(numImageBands, 1);
+            for(unsigned int n = 0; n < numImageBands; ++n)
+            {
+                outPercentiles->matrix[n] = bandPercentiles[n][0];
+            }
         }
         catch (rsgis::RSGISImageException &e)
         {
@@ -1008,7 +1200,14 @@ namespace rsgis{namespace img{
             throw rsgis::RSGISImageException(e.what());
         }
         
-        return percentileVal;
+        return outPercentiles;
+    }
+    
+    double RSGISImagePercentiles::getPercentile(GDALDataset *dataset, unsigned int band, float percentile, float noDataVal, bool noDataDefined)
+    {
+        std::vector< std::vector<double> > outPercentiles;
+        this->calcBandPercentiles(dataset, std::vector<unsigned int>(1, band), std::vector<float>(1, percentile), noDataVal, noDataDefined, &outPercentiles);
+        return outPercentiles[0][0];
     }
     
     double RSGISImagePercentiles::getPercentile(GDALDataset *dataset, unsigned int band, GDALDataset *maskDS, int maskVal, float percentile, float noDataVal, bool noDataDefined)
@@ -1112,65 +1311,237 @@ namespace rsgis{namespace img{
     
     
 
-    RSGISImagePixelSummaries::RSGISImagePixelSummaries(unsigned int numOutBands, rsgis::math::RSGISStatsSummary *statsSummary, float noDataValue, bool useNoDataValue) : RSGISCalcImageValue(numOutBands)
+    void RSGISPixelColumnStats::calcStats(float *bandValues, int numBands, bool useNoDataValue, float noDataValue, rsgis::math::RSGISStatsSummary *stats)
     {
-        this->statsSummary = statsSummary;
-        this->noDataValue = noDataValue;
-        this->useNoDataValue = useNoDataValue;
+        if(this->vals.size() < ((size_t)numBands))
+        {
+            this->vals.resize(numBands);
+        }
+        
+        double minVal = 0.0;
+        double maxVal = 0.0;
+        double sumVal = 0.0;
+        double meanVal = 0.0;
+        double sumSqDiff = 0.0;
+        double delta = 0.0;
+        size_t nVals = 0;
+        for(int i = 0; i < numBands; ++i)
+        {
+            if(useNoDataValue && (bandValues[i] == noDataValue))
+            {
+                continue;
+            }
+            double val = bandValues[i];
+            this->vals[nVals++] = val;
+            if(nVals == 1)
+            {
+                minVal = val;
+                maxVal = val;
+            }
+            else if(val < minVal)
+            {
+                minVal = val;
+            }
+            else if(val > maxVal)
+            {
+                maxVal = val;
+            }
+            sumVal += val;
+            // Welford's update for the mean and sum of squared differences.
+            delta = val - meanVal;
+            meanVal += delta / nVals;
+            sumSqDiff += delta * (val - meanVal);
+        }
+        
+        stats->min = 0;
+        stats->max = 0;
+        stats->mean = 0;
+        stats->sum = 0;
+        stats->stdDev = 0;
+        stats->variance = 0;
+        stats->median = 0;
+        stats->mode = 0;
+        if(nVals == 0)
+        {
+            return;
+        }
+        
+        // As gsl_stats_sd, the sample standard deviation is used (NaN for a single value).
+        double variance = sumSqDiff / ((double)(nVals - 1));
+        if(stats->calcMin)
+        {
+            stats->min = minVal;
+        }
+        if(stats->calcMax)
+        {
+            stats->max = maxVal;
+        }
+        if(stats->calcMean)
+        {
+            stats->mean = meanVal;
+        }
+        if(stats->calcSum)
+        {
+            stats->sum = sumVal;
+        }
+        if(stats->calcStdDev)
+        {
+            stats->stdDev = sqrt(variance);
+        }
+        if(stats->calcVariance)
+        {
+            stats->variance = variance;
+        }
+        if(stats->calcMode)
+        {
+            stats->mode = this->calcMode(nVals);
+        }
+        if(stats->calcMedian)
+        {
+            size_t midIdx = nVals / 2;
+            std::vector<double>::iterator midIter = this->vals.begin() + midIdx;
+            std::nth_element(this->vals.begin(), midIter, this->vals.begin() + nVals);
+            if((nVals % 2) == 1)
+            {
+                stats->median = *midIter;
+            }
+            else
+            {
+                double lowerVal = *std::max_element(this->vals.begin(), midIter);
+                stats->median = (lowerVal + (*midIter)) / 2.0;
+            }
+        }
     }
     
-    void RSGISImagePixelSummaries::calcImageValue(float *bandValues, int numBands, double *output) 
+    double RSGISPixelColumnStats::calcMode(size_t nVals)
     {
-        std::vector<double> *dataVals = new std::vector<double>();
-        for(int i = 0; i < numBands; ++i)
+        // Only the finite values are used, rounded down to an integer. These are
+        // kept as doubles so values outside the range of a long are not cast.
+        if(this->modeVals.size() < nVals)
+        {
+            this->modeVals.resize(nVals);
+        }
+        size_t nModeVals = 0;
+        double minBin = 0.0;
+        double maxBin = 0.0;
+        for(size_t i = 0; i < nVals; ++i)
         {
-            if(this->useNoDataValue & (bandValues[i] == this->noDataValue))
+            if(!std::isfinite(this->vals[i]))
             {
-                // ignore value.
+                continue;
             }
-            else
+            double binVal = floor(this->vals[i]);
+            this->modeVals[nModeVals++] = binVal;
+            if((nModeVals == 1) || (binVal < minBin))
+            {
+                minBin = binVal;
+            }
+            if((nModeVals == 1) || (binVal > maxBin))
             {
-                dataVals->push_back(bandValues[i]);
+                maxBin = binVal;
             }
         }
-        std::sort(dataVals->begin(), dataVals->end());
         
-        rsgis::math::RSGISMathsUtils mathUtils;
-        mathUtils.initStatsSummaryValues(this->statsSummary);
-        mathUtils.generateStats(dataVals, statsSummary);
+        if(nModeVals == 0)
+        {
+            return std::numeric_limits<double>::quiet_NaN();
+        }
+        if(minBin == maxBin)
+        {
+            return minBin;
+        }
+        
+        double modeVal = minBin;
+        size_t modeFreq = 0;
+        // The range is calculated as a double so it cannot overflow (it may be inf).
+        double numBinsRange = (maxBin - minBin) + 1;
+        if(numBinsRange <= ((nModeVals * 4) + 256))
+        {
+            // Small range of values so count them directly.
+            size_t numBins = numBinsRange;
+            this->modeBins.assign(numBins, 0);
+            for(size_t i = 0; i < nModeVals; ++i)
+            {
+                ++this->modeBins[(size_t)(this->modeVals[i] - minBin)];
+            }
+            for(size_t i = 0; i < numBins; ++i)
+            {
+                if(this->modeBins[i] > modeFreq)
+                {
+                    modeFreq = this->modeBins[i];
+                    modeVal = minBin + i;
+                }
+            }
+        }
+        else
+        {
+            // Sparse values across a wide range so sort and count runs rather
+            // than allocating a bin for every integer within the range.
+            std::sort(this->modeVals.begin(), this->modeVals.begin() + nModeVals);
+            size_t runStart = 0;
+            for(size_t i = 1; i <= nModeVals; ++i)
+            {
+                if((i == nModeVals) || (this->modeVals[i] != this->modeVals[runStart]))
+                {
+                    if((i - runStart) > modeFreq)
+                    {
+                        modeFreq = i - runStart;
+                        modeVal = this->modeVals[runStart];
+                    }
+                    runStart = i;
+                }
+            }
+        }
+        return modeVal;
+    }
+    
+    
+    RSGISImagePixelSummaries::RSGISImagePixelSummaries(unsigned int numOutBands, rsgis::math::RSGISStatsSummary *statsSummary, float noDataValue, bool useNoDataValue) : RSGISCalcImageValue(numOutBands)
+    {
+        this->statsSummary = *statsSummary;
+        this->noDataValue = noDataValue;
+        this->useNoDataValue = useNoDataValue;
+    }
+    
+    void RSGISImagePixelSummaries::calcImageValue(float *bandValues, int numBands, double *output) 
+    {
+        this->pxlStats.calcStats(bandValues, numBands, this->useNoDataValue, this->noDataValue, &this->statsSummary);
         
         unsigned int outIdx = 0;
 
-        if(statsSummary->calcMin)
+        if(statsSummary.calcMin)
         {
-            output[outIdx++] = statsSummary->min;
+            output[outIdx++] = statsSummary.min;
         }
-        if(statsSummary->calcMax)
+        if(statsSummary.calcMax)
         {
-            output[outIdx++] = statsSummary->max;
+            output[outIdx++] = statsSummary.max;
         }
-        if(statsSummary->calcMean)
+        if(statsSummary.calcMean)
         {
-            output[outIdx++] = statsSummary->mean;
+            output[outIdx++] = statsSummary.mean;
         }
-        if(statsSummary->calcMedian)
+        if(statsSummary.calcMedian)
         {
-            output[outIdx++] = statsSummary->median;
+            output[outIdx++] = statsSummary.median;
         }
-        if(statsSummary->calcMode)
+        if(statsSummary.calcMode)
         {
-            output[outIdx++] = statsSummary->mode;
+            output[outIdx++] = statsSummary.mode;
         }
-        if(statsSummary->calcSum)
+        if(statsSummary.calcSum)
         {
-            output[outIdx++] = statsSummary->sum;
+            output[outIdx++] = statsSummary.sum;
         }
-        if(statsSummary->calcStdDev)
+        if(statsSummary.calcStdDev)
         {
-            output[outIdx++] = statsSummary->stdDev;
+            output[outIdx++] = statsSummary.stdDev;
         }
-
-        delete dataVals;
+    }
+    
+    RSGISCalcImageValue* RSGISImagePixelSummaries::clone()
+    {
+        return new RSGISImagePixelSummaries(this->numOutBands, &this->statsSummary, this->noDataValue, this->useNoDataValue);
     }
     
     RSGISImagePixelSummaries::~RSGISImagePixelSummaries()
@@ -1587,15 +1958,10 @@ namespace rsgis{namespace img{
         this->noDataVal = noDataVal;
         this->sumStat = sumStat;
         
-        if(this->sumStat == rsgis::math::sumtype_median)
-        {
-            this->mathUtils = new rsgis::math::RSGISMathsUtils();
-            this->statsSumObj = new rsgis::math::RSGISStatsSummary();
-            this->mathUtils->initStatsSummary(statsSumObj);
-            this->data = new std::vector<double>();
-            this->statsSumObj->calcMedian = true;
-        }
-        
+        rsgis::math::RSGISMathsUtils mathUtils;
+        mathUtils.initStatsSummary(&this->statsSumObj);
+        this->statsSumObj.calcMode = false;
+        this->statsSumObj.calcMedian = true;
     }
 
     void RSGISCalcImgStackIdxForStat::calcImageValue(float *bandValues, int numBands, double *output) 
@@ -1657,22 +2023,13 @@ namespace rsgis{namespace img{
         }
         else if(this->sumStat == rsgis::math::sumtype_median)
         {
-            this->mathUtils->initStatsSummaryValues(this->statsSumObj);
-            data->clear();
-            for(int i = 0; i < numBands; ++i)
-            {
-                if(bandValues[i] != this->noDataVal)
-                {
-                    data->push_back(bandValues[i]);
-                }
-            }
-            this->mathUtils->generateStats(data, statsSumObj);
+            this->pxlStats.calcStats(bandValues, numBands, true, this->noDataVal, &this->statsSumObj);
             
             bool foundIdx = false;
             unsigned int idx = 0;
             for(int i = 0; i < numBands; ++i)
             {
-                if((bandValues[i] != this->noDataVal) && (bandValues[i] == statsSumObj->median))
+                if((bandValues[i] != this->noDataVal) && (bandValues[i] == statsSumObj.median))
                 {
                     foundIdx = true;
                     idx = i;
@@ -1691,14 +2048,14 @@ namespace rsgis{namespace img{
         }
     }
     
+    RSGISCalcImageValue* RSGISCalcImgStackIdxForStat::clone()
+    {
+        return new RSGISCalcImgStackIdxForStat(this->noDataVal, this->sumStat);
+    }
+    
     RSGISCalcImgStackIdxForStat::~RSGISCalcImgStackIdxForStat()
     {
-        if(this->sumStat == rsgis::math::sumtype_median)
-        {
-            delete this->mathUtils;
-            delete this->statsSumObj;
-            delete this->data;
-        }
+        
     }
     
     
@@ -25,10 +25,17 @@
 
 #include <iostream>
 #include <string>
+#include <vector>
 #include <cmath>
+#include <limits>
+#include <cstring>
+#include <algorithm>
+#include <stdint.h>
 
 #include "gdal_priv.h"
 
+#include "common/rsgis-tqdm.h"
+
 #include "img/RSGISImageCalcException.h"
 #include "img/RSGISCalcImageValue.h"
 #include "img/RSGISImageUtils.h"
@@ -189,15 +196,54 @@ namespace rsgis{namespace img{
         
     };
     
+    /**
+     * Calculates image band percentiles without holding the band values in memory.
+     * The pixel values (as floats) are mapped to order preserving 32 bit keys. The
+     * first pass over the image builds a histogram of the upper 16 bits of the keys
+     * for each band, which identifies the bin holding each of the required ranks. A
+     * second pass builds a histogram of the lower 16 bits for only those bins, which
+     * gives the exact value at each rank. All the requested bands and percentiles are
+     * calculated from the same two passes. Percentiles are interpolated between ranks
+     * in the same way as gsl_stats_quantile_from_sorted_data.
+     */
     class DllExport RSGISImagePercentiles
     {
     public:
         RSGISImagePercentiles();
+        /**
+         * Calculate the percentiles (0 - 1) for the bands (numbered from 1) of the
+         * input image. outPercentiles is returned as [band][percentile]. Pixels which
+         * are NaN or equal to the no data value (if defined) are ignored; if a band
+         * has no valid pixels its percentiles are 0.
+         */
+        void calcBandPercentiles(GDALDataset *dataset, std::vector<unsigned int> bands, std::vector<float> percentiles, float noDataVal, bool noDataDefined, std::vector< std::vector<double> > *outPercentiles);
+        std::vector< std::vector<double> > getPercentilesForAllBands(GDALDataset* dataset, std::vector<float> percentiles, float noDataVal, bool noDataDefined);
         rsgis::math::Matrix* getPercentilesForAllBands(GDALDataset* dataset, float percentile, float noDataVal, bool noDataDefined);
         double getPercentile(GDALDataset *dataset, unsigned int band, float percentile, float noDataVal, bool noDataDefined);
         double getPercentile(GDALDataset *dataset, unsigned int band, GDALDataset *maskDS, int maskVal, float percentile, float noDataVal, bool noDataDefined);
         double getPercentile(GDALDataset *dataset, unsigned int band, GDALDataset *maskDS, int maskVal, float percentile, float noDataVal, bool noDataDefined, OGREnvelope *env, bool quiet=false);
         ~RSGISImagePercentiles();
+    protected:
+        /**
+         * Read the bands and populate the key histograms. If binTargets is NULL then
+         * hists[b][0] is the histogram of the upper 16 bits of the keys, otherwise
+         * binTargets[b][upper] gives the index (or -1) of the histogram in hists[b]
+         * for the lower 16 bits of the keys within that upper bin.
+         */
+        void calcKeyHistograms(GDALDataset *dataset, std::vector<unsigned int> &bands, float noDataVal, bool noDataDefined, std::vector< std::vector<int> > *binTargets, std::vector< std::vector< std::vector<uint64_t> > > *hists);
+        inline uint32_t calcFloatKey(float val)
+        {
+            uint32_t bits = 0;
+            std::memcpy(&bits, &val, sizeof(float));
+            return (bits & 0x80000000u) ? ~bits : (bits | 0x80000000u);
+        };
+        inline float calcKeyFloat(uint32_t key)
+        {
+            uint32_t bits = (key & 0x80000000u) ? (key & 0x7FFFFFFFu) : ~key;
+            float val = 0;
+            std::memcpy(&val, &bits, sizeof(float));
+            return val;
+        };
     };
     
     
@@ -225,14 +271,39 @@ namespace rsgis{namespace img{
     };
     
     
+    /**
+     * Calculates the summary statistics for the values of a single pixel
+     * across a set of image bands. The min, max, mean, sum, standard
+     * deviation and variance are calculated in a single pass, the median
+     * with std::nth_element and the mode (of the finite values rounded down
+     * to an integer) by counting within the range of values, or by sorting
+     * where the range is large. The buffers are kept
+     * between calls, so one instance should be used per thread. The values
+     * calculated match RSGISMathsUtils::generateStats.
+     */
+    class DllExport RSGISPixelColumnStats
+    {
+    public:
+        RSGISPixelColumnStats(){};
+        void calcStats(float *bandValues, int numBands, bool useNoDataValue, float noDataValue, rsgis::math::RSGISStatsSummary *stats);
+        ~RSGISPixelColumnStats(){};
+    protected:
+        double calcMode(size_t nVals);
+        std::vector<double> vals;
+        std::vector<double> modeVals;
+        std::vector<size_t> modeBins;
+    };
+    
     class DllExport RSGISImagePixelSummaries: public RSGISCalcImageValue
     {
     public:
         RSGISImagePixelSummaries(unsigned int numOutBands, rsgis::math::RSGISStatsSummary *statsSummary, float noDataValue=0, bool useNoDataValue=false);
         void calcImageValue(float *bandValues, int numBands, double *output);
+        RSGISCalcImageValue* clone();
         ~RSGISImagePixelSummaries();
     protected:
-        rsgis::math::RSGISStatsSummary *statsSummary;
+        rsgis::math::RSGISStatsSummary statsSummary;
+        RSGISPixelColumnStats pxlStats;
         float noDataValue;
         bool useNoDataValue;
     };
@@ -315,13 +386,13 @@ namespace rsgis{namespace img{
     public:
         RSGISCalcImgStackIdxForStat(float noDataVal, rsgis::math::rsgissummarytype sumStat);
         void calcImageValue(float *bandValues, int numBands, double *output);
+        RSGISCalcImageValue* clone();
         ~RSGISCalcImgStackIdxForStat();
     protected:
         float noDataVal;
         rsgis::math::rsgissummarytype sumStat;
-        rsgis::math::RSGISMathsUtils *mathUtils;
-        rsgis::math::RSGISStatsSummary *statsSumObj;
-        std::vector<double> *data;
+        rsgis::math::RSGISStatsSummary statsSumObj;
+        RSGISPixelColumnStats pxlStats;
     };
     
     
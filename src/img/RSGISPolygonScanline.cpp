@@ -0,0 +1,499 @@
+/*
+ *  RSGISPolygonScanline.cpp
+ *  RSGIS_LIB
+ *
+ *  Created by Pete Bunting on 17/10/2026.
+ *  Copyright 2026 RSGISLib.
+ *
+ *  RSGISLib is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  RSGISLib is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with RSGISLib.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "RSGISPolygonScanline.h"
+
+namespace rsgis{namespace img {
+
+    RSGISPolygonScanline::RSGISPolygonScanline(pixelInPolyOption method)
+    {
+        if(!RSGISPolygonScanline::isMethodSupported(method))
+        {
+            throw RSGISImageCalcException("The pixel in polygon method is not supported by the scanline rasteriser.");
+        }
+        this->method = method;
+        this->width = 0;
+        this->height = 0;
+        this->polyArea = 0;
+    }
+
+    bool RSGISPolygonScanline::isMethodSupported(pixelInPolyOption method)
+    {
+        return (method == polyContainsPixelCenter) || (method == polyContainsPixel) || (method == polyOverlapsPixel) ||
+               (method == polyOverlapsOrContainsPixel) || (method == pixelContainsPoly) || (method == pixelAreaInPoly) ||
+               (method == envelope);
+    }
+
+    void RSGISPolygonScanline::rasterise(OGRGeometry *geom, double tlX, double tlY, double pxlWidth, double pxlHeight, int width, int height)
+    {
+        this->width = width;
+        this->height = height;
+        this->polyArea = 0;
+        this->edges.clear();
+        this->coverage.clear();
+        this->rowSpans.assign(height, std::vector<RSGISPixelSpan>());
+        if((width <= 0) || (height <= 0))
+        {
+            return;
+        }
+
+        OGRwkbGeometryType geomType = wkbFlatten(geom->getGeometryType());
+        if(geomType == wkbPolygon)
+        {
+            this->addPolygon((OGRPolygon*)geom, tlX, tlY, pxlWidth, pxlHeight);
+        }
+        else if(geomType == wkbMultiPolygon)
+        {
+            OGRMultiPolygon *multiPoly = (OGRMultiPolygon*)geom;
+            for(int i = 0; i < multiPoly->getNumGeometries(); ++i)
+            {
+                this->addPolygon((OGRPolygon*)multiPoly->getGeometryRef(i), tlX, tlY, pxlWidth, pxlHeight);
+            }
+        }
+        else
+        {
+            throw RSGISImageCalcException("The geometry must be a polygon or multi-polygon.");
+        }
+
+        if(this->method == envelope)
+        {
+            RSGISPixelSpan span;
+            span.xStart = 0;
+            span.xEnd = width;
+            for(int row = 0; row < height; ++row)
+            {
+                this->rowSpans[row].push_back(span);
+            }
+        }
+        else if(this->method == polyContainsPixelCenter)
+        {
+            this->calcCentreSpans();
+        }
+        else
+        {
+            this->calcCoverage();
+            this->calcCoverageSpans();
+        }
+    }
+
+    const std::vector<RSGISPixelSpan>* RSGISPolygonScanline::getRowSpans(int row)
+    {
+        return &this->rowSpans[row];
+    }
+
+    bool RSGISPolygonScanline::isPixelIn(int row, int col)
+    {
+        const std::vector<RSGISPixelSpan> &spans = this->rowSpans[row];
+        // Find the last span starting at or before col.
+        size_t low = 0;
+        size_t high = spans.size();
+        while(low < high)
+        {
+            size_t mid = (low + high) / 2;
+            if(spans[mid].xStart <= col)
+            {
+                low = mid + 1;
+            }
+            else
+            {
+                high = mid;
+            }
+        }
+        return (low > 0) && (col < spans[low-1].xEnd);
+    }
+
+    void RSGISPolygonScanline::addPolygon(OGRPolygon *poly, double tlX, double tlY, double pxlWidth, double pxlHeight)
+    {
+        if((poly == NULL) || (poly->getExteriorRing() == NULL))
+        {
+            return;
+        }
+        this->addRing(poly->getExteriorRing(), false, tlX, tlY, pxlWidth, pxlHeight);
+        for(int i = 0; i < poly->getNumInteriorRings(); ++i)
+        {
+            this->addRing(poly->getInteriorRing(i), true, tlX, tlY, pxlWidth, pxlHeight);
+        }
+    }
+
+    void RSGISPolygonScanline::addRing(const OGRLinearRing *ring, bool hole, double tlX, double tlY, double pxlWidth, double pxlHeight)
+    {
+        int numPts = ring->getNumPoints();
+        if(numPts < 3)
+        {
+            return;
+        }
+
+        // Convert to pixel coordinates (y increasing down the image).
+        std::vector<double> xPts(numPts);
+        std::vector<double> yPts(numPts);
+        for(int i = 0; i < numPts; ++i)
+        {
+            xPts[i] = (ring->getX(i) - tlX) / pxlWidth;
+            yPts[i] = (tlY - ring->getY(i)) / pxlHeight;
+        }
+
+        double ringArea = 0;
+        for(int i = 0; i < numPts; ++i)
+        {
+            int n = (i + 1) % numPts;
+            ringArea += (xPts[i] * yPts[n]) - (xPts[n] * yPts[i]);
+        }
+        ringArea = ringArea / 2;
+        if(ringArea == 0)
+        {
+            return;
+        }
+
+        // Orientate the edges so exterior rings have a winding of +1 and holes -1.
+        double winding = (ringArea > 0)?1:-1;
+        if(hole)
+        {
+            winding = winding * -1;
+            this->polyArea -= std::fabs(ringArea);
+        }
+        else
+        {
+            this->polyArea += std::fabs(ringArea);
+        }
+
+        for(int i = 0; i < numPts; ++i)
+        {
+            int n = (i + 1) % numPts;
+            if((xPts[i] == xPts[n]) && (yPts[i] == yPts[n]))
+            {
+                continue;
+            }
+            PolyEdge edge;
+            edge.x0 = xPts[i];
+            edge.y0 = yPts[i];
+            edge.x1 = xPts[n];
+            edge.y1 = yPts[n];
+            edge.winding = winding;
+            this->edges.push_back(edge);
+        }
+    }
+
+    void RSGISPolygonScanline::calcCentreSpans()
+    {
+        // Edge table: each edge is added to the row of the first pixel centre line it
+        // crosses. An edge crosses the centre line yc if y0 <= yc < y1 (or y1 <= yc < y0)
+        // so a vertex on a centre line is only counted once.
+        std::vector< std::vector<size_t> > edgeTable(this->height);
+        for(size_t e = 0; e < this->edges.size(); ++e)
+        {
+            double yMin = std::min(this->edges[e].y0, this->edges[e].y1);
+            double yMax = std::max(this->edges[e].y0, this->edges[e].y1);
+            long rowStart = std::max((long)std::ceil(yMin - 0.5), 0L);
+            long rowEnd = std::min((long)std::ceil(yMax - 0.5), (long)this->height);
+            if(rowStart < rowEnd)
+            {
+                edgeTable[rowStart].push_back(e);
+            }
+        }
+
+        // Pixel centres on the boundary are not contained by the polygon (as for
+        // OGRGeometry::Contains) but the half-open rule above would include those on
+        // horizontal edges and the lower vertices of holes, so they are removed.
+        std::vector< std::vector<int> > boundaryCols(this->height);
+        for(size_t e = 0; e < this->edges.size(); ++e)
+        {
+            const PolyEdge &edge = this->edges[e];
+            double yMin = std::min(edge.y0, edge.y1);
+            double yMax = std::max(edge.y0, edge.y1);
+            long rowStart = std::max((long)std::ceil(yMin - 0.5), 0L);
+            long rowEnd = std::min((long)std::floor(yMax - 0.5), (long)this->height - 1);
+            for(long row = rowStart; row <= rowEnd; ++row)
+            {
+                double yc = row + 0.5;
+                if(edge.y0 == edge.y1)
+                {
+                    long colStart = std::max((long)std::ceil(std::min(edge.x0, edge.x1) - 0.5), 0L);
+                    long colEnd = std::min((long)std::floor(std::max(edge.x0, edge.x1) - 0.5), (long)this->width - 1);
+                    for(long col = colStart; col <= colEnd; ++col)
+                    {
+                        boundaryCols[row].push_back(col);
+                    }
+                }
+                else
+                {
+                    double xc = edge.x0 + ((yc - edge.y0) * (edge.x1 - edge.x0) / (edge.y1 - edge.y0));
+                    double col = xc - 0.5;
+                    if((col == std::floor(col)) && (col >= 0) && (col < this->width))
+                    {
+                        boundaryCols[row].push_back((int)col);
+                    }
+                }
+            }
+        }
+
+        std::vector<size_t> activeEdges;
+        std::vector< std::pair<double, double> > crossings;
+        for(int row = 0; row < this->height; ++row)
+        {
+            double yc = row + 0.5;
+            size_t numActive = 0;
+            for(size_t a = 0; a < activeEdges.size(); ++a)
+            {
+                const PolyEdge &edge = this->edges[activeEdges[a]];
+                if(std::max(edge.y0, edge.y1) > yc)
+                {
+                    activeEdges[numActive++] = activeEdges[a];
+                }
+            }
+            activeEdges.resize(numActive);
+            activeEdges.insert(activeEdges.end(), edgeTable[row].begin(), edgeTable[row].end());
+
+            crossings.clear();
+            for(size_t a = 0; a < activeEdges.size(); ++a)
+            {
+                const PolyEdge &edge = this->edges[activeEdges[a]];
+                double xc = edge.x0 + ((yc - edge.y0) * (edge.x1 - edge.x0) / (edge.y1 - edge.y0));
+                crossings.push_back(std::pair<double, double>(xc, (edge.y1 > edge.y0)?edge.winding:-edge.winding));
+            }
+            std::sort(crossings.begin(), crossings.end());
+            std::sort(boundaryCols[row].begin(), boundaryCols[row].end());
+
+            double wind = 0;
+            double spanStartX = 0;
+            for(size_t c = 0; c < crossings.size(); ++c)
+            {
+                double prevWind = wind;
+                wind += crossings[c].second;
+                if((prevWind == 0) && (wind != 0))
+                {
+                    spanStartX = crossings[c].first;
+                }
+                else if((prevWind != 0) && (wind == 0))
+                {
+                    // Pixels with centres strictly within (spanStartX, x).
+                    int xStart = std::max((int)std::floor(spanStartX - 0.5) + 1, 0);
+                    int xEnd = std::min((int)std::ceil(crossings[c].first - 0.5), this->width);
+                    for(int col = xStart; col < xEnd; ++col)
+                    {
+                        if(!std::binary_search(boundaryCols[row].begin(), boundaryCols[row].end(), col))
+                        {
+                            this->addPixelToSpans(row, col);
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    void RSGISPolygonScanline::calcCoverage()
+    {
+        // Each row has two extra cells so edges on the right of the grid can be
+        // accumulated without bounds checks.
+        size_t rowLen = this->width + 2;
+        std::vector<double> accBuf(rowLen * this->height, 0);
+        this->coverage.swap(accBuf);
+        for(size_t e = 0; e < this->edges.size(); ++e)
+        {
+            this->accumulateEdge(this->edges[e]);
+        }
+
+        // The coverage of each pixel is the sum of the accumulated areas to its left.
+        for(int row = 0; row < this->height; ++row)
+        {
+            double *accRow = &this->coverage[row * rowLen];
+            double *covRow = &this->coverage[((size_t)row) * this->width];
+            double cumSum = 0;
+            for(int col = 0; col < this->width; ++col)
+            {
+                cumSum += accRow[col];
+                covRow[col] = std::min(std::max(cumSum, 0.0), 1.0);
+            }
+        }
+        this->coverage.resize(((size_t)this->width) * this->height);
+    }
+
+    void RSGISPolygonScanline::accumulateEdge(const PolyEdge &edge)
+    {
+        // Split the edge where it crosses the left and right of the grid. Parts outside
+        // the grid are moved onto the grid edge, which gives the same coverage for the
+        // pixels within the grid.
+        double splitT[4];
+        int numSplits = 0;
+        splitT[numSplits++] = 0;
+        if(edge.x0 != edge.x1)
+        {
+            double t = (0 - edge.x0) / (edge.x1 - edge.x0);
+            if((t > 0) && (t < 1))
+            {
+                splitT[numSplits++] = t;
+            }
+            t = (this->width - edge.x0) / (edge.x1 - edge.x0);
+            if((t > 0) && (t < 1))
+            {
+                splitT[numSplits++] = t;
+            }
+        }
+        splitT[numSplits++] = 1;
+        std::sort(splitT, splitT + numSplits);
+
+        double maxX = this->width;
+        for(int s = 0; s < (numSplits - 1); ++s)
+        {
+            double xA = edge.x0 + (splitT[s] * (edge.x1 - edge.x0));
+            double yA = edge.y0 + (splitT[s] * (edge.y1 - edge.y0));
+            double xB = edge.x0 + (splitT[s+1] * (edge.x1 - edge.x0));
+            double yB = edge.y0 + (splitT[s+1] * (edge.y1 - edge.y0));
+            this->accumulateLine(std::min(std::max(xA, 0.0), maxX), yA, std::min(std::max(xB, 0.0), maxX), yB, edge.winding);
+        }
+    }
+
+    void RSGISPolygonScanline::accumulateLine(double x0, double y0, double x1, double y1, double winding)
+    {
+        if(y0 == y1)
+        {
+            return;
+        }
+        double dir = -winding;
+        if(y0 > y1)
+        {
+            std::swap(x0, x1);
+            std::swap(y0, y1);
+            dir = winding;
+        }
+        double yStart = std::max(y0, 0.0);
+        double yEnd = std::min(y1, (double)this->height);
+        if(yStart >= yEnd)
+        {
+            return;
+        }
+
+        size_t rowLen = this->width + 2;
+        double maxX = this->width;
+        double dxdy = (x1 - x0) / (y1 - y0);
+        double x = x0 + ((yStart - y0) * dxdy);
+        long rowEnd = (long)std::ceil(yEnd);
+        for(long row = (long)std::floor(yStart); row < rowEnd; ++row)
+        {
+            double *acc = &this->coverage[row * rowLen];
+            double dy = std::min((double)(row + 1), yEnd) - std::max((double)row, yStart);
+            double xNext = std::min(std::max(x + (dxdy * dy), 0.0), maxX);
+            double d = dy * dir;
+
+            double xL = std::min(x, xNext);
+            double xR = std::max(x, xNext);
+            double xLFloor = std::floor(xL);
+            long xLIdx = (long)xLFloor;
+            long xRIdx = (long)std::ceil(xR);
+            if(xRIdx <= (xLIdx + 1))
+            {
+                // The line is within a single pixel in this row.
+                double xMidFrac = (0.5 * (x + xNext)) - xLFloor;
+                acc[xLIdx] += d - (d * xMidFrac);
+                acc[xLIdx + 1] += d * xMidFrac;
+            }
+            else
+            {
+                // The line crosses several pixels, the area to the right of the
+                // line within each pixel is a triangle, trapezoids and a triangle.
+                double s = 1.0 / (xR - xL);
+                double xLFrac = xL - xLFloor;
+                double aL = 0.5 * s * (1 - xLFrac) * (1 - xLFrac);
+                double xRFrac = xR - xRIdx + 1;
+                double aR = 0.5 * s * xRFrac * xRFrac;
+                acc[xLIdx] += d * aL;
+                if(xRIdx == (xLIdx + 2))
+                {
+                    acc[xLIdx + 1] += d * (1 - aL - aR);
+                }
+                else
+                {
+                    double a1 = s * (1.5 - xLFrac);
+                    acc[xLIdx + 1] += d * (a1 - aL);
+                    for(long xIdx = xLIdx + 2; xIdx < (xRIdx - 1); ++xIdx)
+                    {
+                        acc[xIdx] += d * s;
+                    }
+                    double a2 = a1 + ((xRIdx - xLIdx - 3) * s);
+                    acc[xRIdx - 1] += d * (1 - a2 - aR);
+                }
+                acc[xRIdx] += d * aR;
+            }
+            x = xNext;
+        }
+    }
+
+    void RSGISPolygonScanline::calcCoverageSpans()
+    {
+        // Coverage is calculated in double precision, allow for rounding errors.
+        const double covTol = 1e-9;
+        for(int row = 0; row < this->height; ++row)
+        {
+            for(int col = 0; col < this->width; ++col)
+            {
+                double cov = this->coverage[(((size_t)row) * this->width) + col];
+                bool pxlIn = false;
+                if(this->method == polyContainsPixel)
+                {
+                    pxlIn = (cov >= (1 - covTol));
+                }
+                else if(this->method == polyOverlapsPixel)
+                {
+                    pxlIn = (cov > covTol) && (cov < (1 - covTol)) && (cov < (this->polyArea * (1 - covTol)));
+                }
+                else if(this->method == polyOverlapsOrContainsPixel)
+                {
+                    pxlIn = (cov >= (1 - covTol)) || ((cov > covTol) && (cov < (this->polyArea * (1 - covTol))));
+                }
+                else if(this->method == pixelContainsPoly)
+                {
+                    pxlIn = (cov > 0) && (cov >= (this->polyArea * (1 - covTol)));
+                }
+                else if(this->method == pixelAreaInPoly)
+                {
+                    pxlIn = (cov > covTol);
+                }
+
+                if(pxlIn)
+                {
+                    this->addPixelToSpans(row, col);
+                }
+            }
+        }
+    }
+
+    void RSGISPolygonScanline::addPixelToSpans(int row, int col)
+    {
+        std::vector<RSGISPixelSpan> &spans = this->rowSpans[row];
+        if((!spans.empty()) && (spans.back().xEnd >= col))
+        {
+            spans.back().xEnd = std::max(spans.back().xEnd, col + 1);
+        }
+        else
+        {
+            RSGISPixelSpan span;
+            span.xStart = col;
+            span.xEnd = col + 1;
+            spans.push_back(span);
+        }
+    }
+
+    RSGISPolygonScanline::~RSGISPolygonScanline()
+    {
+
+    }
+
+}}
@@ -0,0 +1,119 @@
+/*
+ *  RSGISPolygonScanline.h
+ *  RSGIS_LIB
+ *
+ *  Created by Pete Bunting on 17/10/2026.
+ *  Copyright 2026 RSGISLib.
+ *
+ *  RSGISLib is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  RSGISLib is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with RSGISLib.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef RSGISPolygonScanline_H
+#define RSGISPolygonScanline_H
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <cmath>
+
+#include "ogrsf_frmts.h"
+
+#include "img/RSGISImageCalcException.h"
+#include "img/RSGISPixelInPoly.h"
+
+// mark all exported classes/functions with DllExport to have
+// them exported by Visual Studio
+#undef DllExport
+#ifdef _MSC_VER
+    #ifdef rsgis_img_EXPORTS
+        #define DllExport   __declspec( dllexport )
+    #else
+        #define DllExport   __declspec( dllimport )
+    #endif
+#else
+    #define DllExport
+#endif
+
+namespace rsgis{namespace img {
+
+    /** A run of pixels [xStart, xEnd) within a row of the grid. */
+    struct DllExport RSGISPixelSpan
+    {
+        int xStart;
+        int xEnd;
+    };
+
+    /**
+     * Finds the pixels of a grid selected by a polygon (or multi-polygon) using
+     * an edge-table scanline rasteriser rather than testing a polygon for each
+     * pixel with GEOS. The result is a list of pixel spans for each row.
+     *
+     * For polyContainsPixelCenter the crossings of the polygon edges with the
+     * line through the pixel centres of each row are found from the active
+     * edges of the edge table (non-zero winding, so holes are excluded). For
+     * the area based options the exact fraction of each pixel covered by the
+     * polygon is calculated by accumulating the signed area of each edge into
+     * the cells it crosses, and the pixels are selected from the coverage:
+     *
+     * polyContainsPixel - the pixel is fully covered.
+     * polyOverlapsPixel - the pixel is partially covered and does not contain the polygon.
+     * polyOverlapsOrContainsPixel - either of the above.
+     * pixelContainsPoly - the area of the polygon within the pixel is the whole polygon.
+     * pixelAreaInPoly - any of the pixel is covered.
+     * envelope - all the pixels in the grid.
+     *
+     * The grid is defined by its top-left corner, pixel size (positive height)
+     * and number of pixels, as returned by RSGISImageUtils::getImageOverlap.
+     */
+    class DllExport RSGISPolygonScanline
+    {
+    public:
+        RSGISPolygonScanline(pixelInPolyOption method);
+        /** Returns true if the method can be calculated with the scanline rasteriser. */
+        static bool isMethodSupported(pixelInPolyOption method);
+        void rasterise(OGRGeometry *geom, double tlX, double tlY, double pxlWidth, double pxlHeight, int width, int height);
+        const std::vector<RSGISPixelSpan>* getRowSpans(int row);
+        bool isPixelIn(int row, int col);
+        ~RSGISPolygonScanline();
+    protected:
+        struct PolyEdge
+        {
+            double x0;
+            double y0;
+            double x1;
+            double y1;
+            double winding;
+        };
+        void addPolygon(OGRPolygon *poly, double tlX, double tlY, double pxlWidth, double pxlHeight);
+        void addRing(const OGRLinearRing *ring, bool hole, double tlX, double tlY, double pxlWidth, double pxlHeight);
+        void calcCentreSpans();
+        void calcCoverage();
+        void accumulateEdge(const PolyEdge &edge);
+        void accumulateLine(double x0, double y0, double x1, double y1, double winding);
+        void calcCoverageSpans();
+        void addPixelToSpans(int row, int col);
+        pixelInPolyOption method;
+        int width;
+        int height;
+        double polyArea;
+        std::vector<PolyEdge> edges;
+        std::vector<double> coverage;
+        std::vector< std::vector<RSGISPixelSpan> > rowSpans;
+    };
+
+}}
+
+#endif
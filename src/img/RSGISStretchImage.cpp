@@ -149,14 +149,18 @@ namespace rsgis { namespace img {
 	void RSGISStretchImage::executeLinearPercentStretch(float percent) 
 	{
 		GDALDataset **datasets = NULL;
-		RSGISImageStatistics *calcImageStats = NULL;
-		ImageStats **stats = NULL;
 		RSGISCalcImage *calcImg = NULL;
 		RSGISLinearStretchImage *linearStretchImage = NULL;
 		double *imageMax = NULL;
 		double *imageMin = NULL;
 		double *outMax = NULL;
 		double *outMin = NULL;
+		
+		if((percent < 0) || (percent > 50))
+		{
+			throw RSGISImageCalcException("The percent must be between 0 and 50.");
+		}
+		
 		try
 		{
 			int numBands = inputImage->GetRasterCount();
@@ -168,17 +172,13 @@ namespace rsgis { namespace img {
 			outMax = new double[numBands];
 			outMin = new double[numBands];
 			
-			stats = new ImageStats*[numBands];
-			for(int i = 0; i < numBands; i++)
-			{
-				stats[i] = new ImageStats();
-			}
-			calcImageStats = new RSGISImageStatistics();
-			calcImageStats->calcImageStatistics(datasets, 1, stats, numBands, false, this->useNoData, this->inNoData, onePassSD);
-			
-			double onePercent = 0;
-			double onePercentUpper = 0;
-			double onePercentLower = 0;
+            // Stretch between the percent and 100-percent percentiles of each band,
+            // which are all calculated from the same two passes through the image.
+            std::vector<float> percentiles;
+            percentiles.push_back(percent/100);
+            percentiles.push_back(1 - (percent/100));
+            RSGISImagePercentiles calcPercentiles;
+            std::vector< std::vector<double> > bandPercentiles = calcPercentiles.getPercentilesForAllBands(inputImage, percentiles, this->inNoData, this->useNoData);
 			
             std::ofstream outTxtFile;
             if(this->outStats)
@@ -194,13 +194,8 @@ namespace rsgis { namespace img {
             
 			for(int i = 0; i < numBands; i++)
 			{				
-				onePercent = (stats[i]->max - stats[i]->min)/100;
-				
-				onePercentUpper = (stats[i]->max - stats[i]->mean)/50;
-				onePercentLower = (stats[i]->mean - stats[i]->min)/50;
-				
-				imageMin[i] = stats[i]->min + (onePercentLower * percent);
-				imageMax[i] = stats[i]->max - (onePercentUpper * percent);
+				imageMin[i] = bandPercentiles[i][0];
+				imageMax[i] = bandPercentiles[i][1];
 				outMax[i] = this->outMaxVal;
 				outMin[i] = this->outMinVal;
                 
@@ -216,13 +211,6 @@ namespace rsgis { namespace img {
                 outTxtFile.close();
             }
 			
-			for(int i = 0; i < numBands; i++)
-			{
-				delete stats[i];
-			}
-			delete[] stats;
-			delete calcImageStats;
-			
 			linearStretchImage = new RSGISLinearStretchImage(numBands, imageMax, imageMin, outMax, outMin, this->useNoData, this->inNoData, this->outNoData);
 			calcImg = new RSGISCalcImage(linearStretchImage, "", true);
 			calcImg->calcImage(datasets, 1, outputImage, false, NULL, imageFormat, outDataType);
@@ -234,6 +222,12 @@ namespace rsgis { namespace img {
 			{
 				delete[] datasets;
 			}
+			delete[] imageMax;
+			delete[] imageMin;
+			delete[] outMax;
+			delete[] outMin;
+			delete linearStretchImage;
+			delete calcImg;
 			throw e;
 		}
 		catch(RSGISImageBandException &e)
@@ -242,6 +236,26 @@ namespace rsgis { namespace img {
 			{
 				delete[] datasets;
 			}
+			delete[] imageMax;
+			delete[] imageMin;
+			delete[] outMax;
+			delete[] outMin;
+			delete linearStretchImage;
+			delete calcImg;
+			throw RSGISImageCalcException(e.what());
+		}
+		catch(rsgis::RSGISImageException &e)
+		{
+			if(datasets != NULL)
+			{
+				delete[] datasets;
+			}
+			delete[] imageMax;
+			delete[] imageMin;
+			delete[] outMax;
+			delete[] outMin;
+			delete linearStretchImage;
+			delete calcImg;
 			throw RSGISImageCalcException(e.what());
 		}
 		
@@ -1147,6 +1161,68 @@ namespace rsgis { namespace img {
 		}
 	}
 	
+	void RSGISLinearStretchImage::calcImageValueBlock(float **blockData, int numBands, int width, int height, double **output)
+	{
+		size_t numPxls = ((size_t)width) * ((size_t)height);
+		double inDiff = 0;
+		double norm2min = 0;
+		double outDiff = 0;
+        double outVal = 0;
+        double nanOutVal = 0;
+		for(int i = 0; i < numBands; i++)
+		{
+			float *inBandVals = blockData[i];
+			double *outBandVals = output[i];
+			inDiff = imageMax[i] - imageMin[i];
+			outDiff = outMax[i] - outMin[i];
+            nanOutVal = this->useNoData?this->outNoData:outMin[i];
+			for(size_t j = 0; j < numPxls; j++)
+			{
+				if(boost::math::isnan(inBandVals[j]))
+				{
+					outBandVals[j] = nanOutVal;
+				}
+				else if(this->useNoData && (inBandVals[j] == this->inNoData))
+				{
+					outBandVals[j] = this->outNoData;
+				}
+				else if(inBandVals[j] < imageMin[i])
+				{
+					outBandVals[j] = outMin[i];
+				}
+				else if(inBandVals[j] > imageMax[i])
+				{
+					outBandVals[j] = outMax[i];
+				}
+				else
+				{
+					norm2min = inBandVals[j] - imageMin[i];
+					outVal = ((norm2min/inDiff)*outDiff)+outMin[i];
+					if(outVal == this->outNoData)
+					{
+						if(this->outNoData == outMax[i])
+						{
+							outBandVals[j] = outVal - 1;
+						}
+						else
+						{
+							outBandVals[j] = outVal + 1;
+						}
+					}
+					else
+					{
+						outBandVals[j] = outVal;
+					}
+				}
+			}
+		}
+	}
+	
+	RSGISCalcImageValue* RSGISLinearStretchImage::clone()
+	{
+		return new RSGISLinearStretchImage(this->numOutBands, this->imageMax, this->imageMin, this->outMax, this->outMin, this->useNoData, this->inNoData, this->outNoData);
+	}
+	
 	RSGISLinearStretchImage::~RSGISLinearStretchImage()
 	{
 		
@@ -295,6 +295,8 @@ namespace rsgis { namespace img {
 	public:
 		RSGISLinearStretchImage(int numberOutBands, double *imageMaxIn, double *imageMinIn, double *outMaxIn, double *outMinIn, bool useNoData, double inNoData, double outNoData);
 		void calcImageValue(float *bandValues, int numBands, double *output);
+		void calcImageValueBlock(float **blockData, int numBands, int width, int height, double **output);
+		RSGISCalcImageValue* clone();
 		~RSGISLinearStretchImage();
 	protected:
 		double *imageMax;
@@ -580,150 +580,6 @@ namespace rsgis {namespace math{
         return NULL;
     }
         
-    std::vector< std::pair< unsigned int, std::vector<float> > >* RSGISClusterer::createClusterDataInitClusterIDs(std::vector< std::vector<float> > *input, std::vector< RSGISClusterCentre > *clusterCentres)
-    {
-        float dist = 0;
-        float minDist = 0;
-        unsigned int clusterID = 0;
-        
-        std::vector< std::pair< unsigned int, std::vector<float> > > *clusterData = new std::vector< std::pair< unsigned int, std::vector<float> > >();
-        for(std::vector< std::vector<float> >::iterator iterInData = input->begin(); iterInData != input->end(); ++iterInData)
-        {
-            dist = 0;
-            minDist = 0;
-            clusterID = 0;
-            
-            for(unsigned int i = 0; i < clusterCentres->size(); ++i)
-            {
-                dist = 0;
-                for(unsigned int j = 0; j < clusterCentres->at(i).centre.size(); ++j)
-                {
-                    dist += ((*iterInData)[j] - clusterCentres->at(i).centre[j]) * ((*iterInData)[j] - clusterCentres->at(i).centre[j]); 
-                }
-                
-                dist = sqrt(dist);
-                
-                if(i == 0)
-                {
-                    minDist = dist;
-                    clusterID = i;
-                }
-                else if(dist < minDist)
-                {
-                    minDist = dist;
-                    clusterID = i;
-                }
-            }
-            
-            ++clusterCentres->at(clusterID).numPxl;
-            clusterData->push_back(std::pair< unsigned int, std::vector<float> >(clusterID, *iterInData));
-        }
-        
-        return clusterData;
-    }
-    
-    unsigned int RSGISClusterer::reassignClusterIDs( std::vector< std::pair< unsigned int, std::vector<float> > > *clusterData, std::vector< RSGISClusterCentre > *clusterCentres)
-    {
-        unsigned int nChange = 0;
-        float dist = 0;
-        float minDist = 0;
-        unsigned int clusterID = 0;
-        
-        for(std::vector< std::pair< unsigned int, std::vector<float> > >::iterator iterData = clusterData->begin(); iterData != clusterData->end(); ++iterData)
-        {
-            dist = 0;
-            minDist = 0;
-            clusterID = 0;
-            
-            for(unsigned int i = 0; i < clusterCentres->size(); ++i)
-            {
-                dist = 0;
-                for(unsigned int j = 0; j < clusterCentres->at(i).centre.size(); ++j)
-                {
-                    dist += ((*iterData).second[j] - clusterCentres->at(i).centre[j]) * ((*iterData).second[j] - clusterCentres->at(i).centre[j]); 
-                }
-                
-                dist = sqrt(dist);
-                
-                if(i == 0)
-                {
-                    minDist = dist;
-                    clusterID = i;
-                }
-                else if(dist < minDist)
-                {
-                    minDist = dist;
-                    clusterID = i;
-                }
-            }
-            
-            if(clusterID != (*iterData).first)
-            {
-                (*iterData).first = clusterID;
-                ++nChange;
-            }
-        }
-        
-        return nChange;
-    }
-    
-    void RSGISClusterer::recalcClusterCentres( std::vector< std::pair< unsigned int, std::vector<float> > > *clusterData, std::vector< RSGISClusterCentre > *clusterCentres, bool calcStdDev)
-    {
-        for(std::vector< RSGISClusterCentre >::iterator iterClusters = clusterCentres->begin(); iterClusters != clusterCentres->end(); ++iterClusters)
-        {
-            for(unsigned int i = 0; i < (*iterClusters).centre.size(); ++i)
-            {
-                (*iterClusters).centre[i] = 0;
-                (*iterClusters).stdDev[i] = 0;
-            }
-            (*iterClusters).numPxl = 0;
-        }
-        
-        for(std::vector< std::pair< unsigned int, std::vector<float> > >::iterator iterData = clusterData->begin(); iterData != clusterData->end(); ++iterData)
-        {
-            ++clusterCentres->at((*iterData).first).numPxl;
-            for(unsigned int i = 0; i < (*iterData).second.size(); ++i)
-            {
-                clusterCentres->at((*iterData).first).centre[i] += (*iterData).second[i];
-            }
-        }
-
-        for(std::vector< RSGISClusterCentre >::iterator iterClusters = clusterCentres->begin(); iterClusters != clusterCentres->end(); )
-        {
-            if((*iterClusters).numPxl == 0)
-            {
-                iterClusters = clusterCentres->erase(iterClusters);
-            }
-            else
-            {
-                for(unsigned int i = 0; i < (*iterClusters).centre.size(); ++i)
-                {
-                    (*iterClusters).centre[i] = (*iterClusters).centre[i]/(*iterClusters).numPxl;
-                }
-                ++iterClusters;
-            }
-        }
-        
-        if(calcStdDev)
-        {
-            for(std::vector< std::pair< unsigned int, std::vector<float> > >::iterator iterData = clusterData->begin(); iterData != clusterData->end(); ++iterData)
-            {
-                for(unsigned int i = 0; i < (*iterData).second.size(); ++i)
-                {
-                    clusterCentres->at((*iterData).first).stdDev[i] += (clusterCentres->at((*iterData).first).centre[i] - (*iterData).second[i])*(clusterCentres->at((*iterData).first).centre[i] - (*iterData).second[i]);
-                }
-            }
-            
-            for(std::vector< RSGISClusterCentre >::iterator iterClusters = clusterCentres->begin(); iterClusters != clusterCentres->end(); ++iterClusters)
-            {
-                for(unsigned int i = 0; i < (*iterClusters).stdDev.size(); ++i)
-                {
-                    (*iterClusters).stdDev[i] = sqrt((*iterClusters).stdDev[i]/(*iterClusters).numPxl);
-                }
-            }
-        }
-    }
-    
     void RSGISClusterer::assign2ClosestDataPoint(RSGISClusterCentre *cc, std::vector< std::vector<float> > *input, unsigned int numFeatures, std::vector< RSGISClusterCentre > *used)
     {
         bool first = true;
@@ -835,9 +691,320 @@ namespace rsgis {namespace math{
         }
     }
     
+    float* RSGISClusterer::createDataMatrix(std::vector< std::vector<float> > *input, unsigned int numFeatures)
+    {
+        float *data = new float[input->size()*numFeatures];
+        size_t idx = 0;
+        for(std::vector< std::vector<float> >::iterator iterData = input->begin(); iterData != input->end(); ++iterData)
+        {
+            if((*iterData).size() < numFeatures)
+            {
+                delete[] data;
+                throw RSGISClustererException("The input data has fewer values than the number of features.");
+            }
+            for(unsigned int i = 0; i < numFeatures; ++i)
+            {
+                data[idx++] = (*iterData)[i];
+            }
+        }
+        return data;
+    }
+    
+    unsigned int RSGISClusterer::assignClusterIDs(const float *data, size_t numPts, unsigned int numFeatures, std::vector< RSGISClusterCentre > *clusterCentres, unsigned int *clusterIDs, double *upperBounds, double *lowerBounds, std::vector<double> *centreShifts)
+    {
+        unsigned int numClusters = clusterCentres->size();
+        if(numClusters == 0)
+        {
+            throw RSGISClustererException("There are no cluster centres to assign the data to.");
+        }
+        
+        float *centres = new float[numClusters*numFeatures];
+        for(unsigned int k = 0; k < numClusters; ++k)
+        {
+            for(unsigned int i = 0; i < numFeatures; ++i)
+            {
+                centres[(k*numFeatures)+i] = clusterCentres->at(k).centre[i];
+            }
+        }
+        
+        // For each centre, half the distance to the closest other centre, and the
+        // largest and second largest distance the centres have moved.
+        std::vector<double> halfMinCentreDist(numClusters, std::numeric_limits<double>::max());
+        unsigned int maxShiftIdx = 0;
+        double maxShift = 0;
+        double secondMaxShift = 0;
+        if(centreShifts != NULL)
+        {
+            for(unsigned int k = 0; k < numClusters; ++k)
+            {
+                for(unsigned int l = k+1; l < numClusters; ++l)
+                {
+                    double dist = 0;
+                    for(unsigned int i = 0; i < numFeatures; ++i)
+                    {
+                        double diff = centres[(k*numFeatures)+i] - centres[(l*numFeatures)+i];
+                        dist += diff * diff;
+                    }
+                    dist = sqrt(dist)/2;
+                    if(dist < halfMinCentreDist[k])
+                    {
+                        halfMinCentreDist[k] = dist;
+                    }
+                    if(dist < halfMinCentreDist[l])
+                    {
+                        halfMinCentreDist[l] = dist;
+                    }
+                }
+                
+                if(centreShifts->at(k) > maxShift)
+                {
+                    secondMaxShift = maxShift;
+                    maxShift = centreShifts->at(k);
+                    maxShiftIdx = k;
+                }
+                else if(centreShifts->at(k) > secondMaxShift)
+                {
+                    secondMaxShift = centreShifts->at(k);
+                }
+            }
+        }
+        
+        std::vector<unsigned int> nChanges(this->getNumPointBlocks(numPts), 0);
+        this->processPointsInParallel(numPts, [&](size_t block, size_t startPt, size_t endPt)
+        {
+            for(size_t n = startPt; n < endPt; ++n)
+            {
+                const float *pt = &data[n*numFeatures];
+                unsigned int clusterID = clusterIDs[n];
+                
+                if(centreShifts != NULL)
+                {
+                    upperBounds[n] += centreShifts->at(clusterID);
+                    lowerBounds[n] -= (clusterID == maxShiftIdx)?secondMaxShift:maxShift;
+                    
+                    double bound = std::max(halfMinCentreDist[clusterID], lowerBounds[n]);
+                    if(upperBounds[n] <= bound)
+                    {
+                        continue;
+                    }
+                    
+                    // Tighten the upper bound and test again.
+                    double dist = 0;
+                    for(unsigned int i = 0; i < numFeatures; ++i)
+                    {
+                        double diff = pt[i] - centres[(clusterID*numFeatures)+i];
+                        dist += diff * diff;
+                    }
+                    upperBounds[n] = sqrt(dist);
+                    if(upperBounds[n] <= bound)
+                    {
+                        continue;
+                    }
+                }
+                
+                double minDist = std::numeric_limits<double>::max();
+                double secondMinDist = std::numeric_limits<double>::max();
+                unsigned int minIdx = 0;
+                for(unsigned int k = 0; k < numClusters; ++k)
+                {
+                    double dist = 0;
+                    for(unsigned int i = 0; i < numFeatures; ++i)
+                    {
+                        double diff = pt[i] - centres[(k*numFeatures)+i];
+                        dist += diff * diff;
+                    }
+                    dist = sqrt(dist);
+                    
+                    if(dist < minDist)
+                    {
+                        secondMinDist = minDist;
+                        minDist = dist;
+                        minIdx = k;
+                    }
+                    else if(dist < secondMinDist)
+                    {
+                        secondMinDist = dist;
+                    }
+                }
+                
+                upperBounds[n] = minDist;
+                lowerBounds[n] = secondMinDist;
+                if(minIdx != clusterID)
+                {
+                    clusterIDs[n] = minIdx;
+                    ++nChanges[block];
+                }
+            }
+        });
+        
+        delete[] centres;
+        
+        unsigned int nChange = 0;
+        for(std::vector<unsigned int>::iterator iterChanges = nChanges.begin(); iterChanges != nChanges.end(); ++iterChanges)
+        {
+            nChange += (*iterChanges);
+        }
+        return nChange;
+    }
+    
+    void RSGISClusterer::updateClusterCentres(const float *data, size_t numPts, unsigned int numFeatures, unsigned int *clusterIDs, std::vector< RSGISClusterCentre > *clusterCentres, bool calcStdDev, std::vector<double> *centreShifts)
+    {
+        unsigned int numClusters = clusterCentres->size();
+        
+        // The points are summed for each block which are then combined.
+        size_t numBlocks = this->getNumPointBlocks(numPts);
+        std::vector< std::vector<double> > blockSums(numBlocks, std::vector<double>(numClusters*numFeatures, 0.0));
+        std::vector< std::vector<size_t> > blockCounts(numBlocks, std::vector<size_t>(numClusters, 0));
+        this->processPointsInParallel(numPts, [&](size_t block, size_t startPt, size_t endPt)
+        {
+            std::vector<double> &sums = blockSums[block];
+            std::vector<size_t> &counts = blockCounts[block];
+            for(size_t n = startPt; n < endPt; ++n)
+            {
+                unsigned int clusterID = clusterIDs[n];
+                ++counts[clusterID];
+                for(unsigned int i = 0; i < numFeatures; ++i)
+                {
+                    sums[(clusterID*numFeatures)+i] += data[(n*numFeatures)+i];
+                }
+            }
+        });
+        
+        std::vector<double> sums(numClusters*numFeatures, 0.0);
+        std::vector<size_t> counts(numClusters, 0);
+        for(size_t b = 0; b < numBlocks; ++b)
+        {
+            for(unsigned int k = 0; k < numClusters; ++k)
+            {
+                counts[k] += blockCounts[b][k];
+                for(unsigned int i = 0; i < numFeatures; ++i)
+                {
+                    sums[(k*numFeatures)+i] += blockSums[b][(k*numFeatures)+i];
+                }
+            }
+        }
+        
+        // Calculate the new centres, removing any empty clusters.
+        std::vector<unsigned int> newIDs(numClusters, 0);
+        std::vector< RSGISClusterCentre > newCentres;
+        newCentres.reserve(numClusters);
+        centreShifts->clear();
+        for(unsigned int k = 0; k < numClusters; ++k)
+        {
+            if(counts[k] == 0)
+            {
+                continue;
+            }
+            
+            RSGISClusterCentre cCentre;
+            cCentre.numPxl = counts[k];
+            cCentre.centre.resize(numFeatures);
+            cCentre.stdDev.assign(numFeatures, 0);
+            double shift = 0;
+            for(unsigned int i = 0; i < numFeatures; ++i)
+            {
+                cCentre.centre[i] = sums[(k*numFeatures)+i]/counts[k];
+                double diff = cCentre.centre[i] - clusterCentres->at(k).centre[i];
+                shift += diff * diff;
+            }
+            newIDs[k] = newCentres.size();
+            newCentres.push_back(cCentre);
+            centreShifts->push_back(sqrt(shift));
+        }
+        clusterCentres->swap(newCentres);
+        
+        if(clusterCentres->size() != numClusters)
+        {
+            for(size_t n = 0; n < numPts; ++n)
+            {
+                clusterIDs[n] = newIDs[clusterIDs[n]];
+            }
+        }
+        numClusters = clusterCentres->size();
+        
+        if(calcStdDev)
+        {
+            std::vector< std::vector<double> > blockSqDiffs(numBlocks, std::vector<double>(numClusters*numFeatures, 0.0));
+            this->processPointsInParallel(numPts, [&](size_t block, size_t startPt, size_t endPt)
+            {
+                std::vector<double> &sqDiffs = blockSqDiffs[block];
+                for(size_t n = startPt; n < endPt; ++n)
+                {
+                    unsigned int clusterID = clusterIDs[n];
+                    for(unsigned int i = 0; i < numFeatures; ++i)
+                    {
+                        double diff = clusterCentres->at(clusterID).centre[i] - data[(n*numFeatures)+i];
+                        sqDiffs[(clusterID*numFeatures)+i] += diff * diff;
+                    }
+                }
+            });
+            
+            for(unsigned int k = 0; k < numClusters; ++k)
+            {
+                for(unsigned int i = 0; i < numFeatures; ++i)
+                {
+                    double sqDiff = 0;
+                    for(size_t b = 0; b < numBlocks; ++b)
+                    {
+                        sqDiff += blockSqDiffs[b][(k*numFeatures)+i];
+                    }
+                    clusterCentres->at(k).stdDev[i] = sqrt(sqDiff/clusterCentres->at(k).numPxl);
+                }
+            }
+        }
+    }
+    
+    void RSGISClusterer::processPointsInParallel(size_t numPts, const std::function<void(size_t, size_t, size_t)> &func)
+    {
+        size_t numBlocks = this->getNumPointBlocks(numPts);
+        if((this->numThreads == 1) || (numBlocks < 2))
+        {
+            for(size_t b = 0; b < numBlocks; ++b)
+            {
+                func(b, b * pointBlockSize, std::min(numPts, (b+1) * pointBlockSize));
+            }
+            return;
+        }
+        
+        unsigned int numThreadsUsed = std::min<size_t>(this->numThreads, numBlocks);
+        std::atomic<size_t> nextBlock(0);
+        std::vector<std::exception_ptr> threadErrors(numThreadsUsed, nullptr);
+        std::vector<std::thread> threads;
+        threads.reserve(numThreadsUsed);
+        for(unsigned int t = 0; t < numThreadsUsed; ++t)
+        {
+            threads.push_back(std::thread([&, t]()
+            {
+                try
+                {
+                    size_t b = 0;
+                    while((b = nextBlock++) < numBlocks)
+                    {
+                        func(b, b * pointBlockSize, std::min(numPts, (b+1) * pointBlockSize));
+                    }
+                }
+                catch(...)
+                {
+                    threadErrors[t] = std::current_exception();
+                }
+            }));
+        }
+        for(std::vector<std::thread>::iterator iterThreads = threads.begin(); iterThreads != threads.end(); ++iterThreads)
+        {
+            (*iterThreads).join();
+        }
+        for(std::vector<std::exception_ptr>::iterator iterErrs = threadErrors.begin(); iterErrs != threadErrors.end(); ++iterErrs)
+        {
+            if(*iterErrs)
+            {
+                std::rethrow_exception(*iterErrs);
+            }
+        }
+    }
+    
 
 
-    RSGISKMeansClusterer::RSGISKMeansClusterer(InitClustererMethods initCentres)
+    RSGISKMeansClusterer::RSGISKMeansClusterer(InitClustererMethods initCentres, unsigned int numThreads): RSGISClusterer(numThreads)
     {
         this->initCentres = initCentres;
     }
@@ -901,7 +1068,21 @@ namespace rsgis {namespace math{
             delete[] minVals;
             delete[] maxVals;
             
-            std::vector< std::pair< unsigned int, std::vector<float> > > *clusterData = this->createClusterDataInitClusterIDs(input, clusterCentres);
+            size_t numPts = input->size();
+            if(numPts == 0)
+            {
+                throw RSGISClustererException("There is no data to cluster.");
+            }
+            float *data = this->createDataMatrix(input, numFeatures);
+            unsigned int *clusterIDs = new unsigned int[numPts];
+            double *upperBounds = new double[numPts];
+            double *lowerBounds = new double[numPts];
+            std::vector<double> centreShifts;
+            for(size_t n = 0; n < numPts; ++n)
+            {
+                clusterIDs[n] = 0;
+            }
+            this->assignClusterIDs(data, numPts, numFeatures, clusterCentres, clusterIDs, upperBounds, lowerBounds, NULL);
             
             unsigned int nIter = 0;
             unsigned int nChange = 0;
@@ -913,11 +1094,11 @@ namespace rsgis {namespace math{
             {
                 contProcess = false;
                 
-                this->recalcClusterCentres(clusterData, clusterCentres, false);
+                this->updateClusterCentres(data, numPts, numFeatures, clusterIDs, clusterCentres, false, &centreShifts);
                 
-                nChange = this->reassignClusterIDs(clusterData, clusterCentres);
+                nChange = this->assignClusterIDs(data, numPts, numFeatures, clusterCentres, clusterIDs, upperBounds, lowerBounds, &centreShifts);
                 
-                amountOfChange = ((float)nChange)/clusterData->size();
+                amountOfChange = ((float)nChange)/numPts;
                 
                 std::cout << "Iteration " << nIter << " has change " << amountOfChange*100 << " % of data clump IDs (" << clusterCentres->size() << " clusters).\n";
                 
@@ -926,7 +1107,12 @@ namespace rsgis {namespace math{
                     contProcess = true;
                 }
                 ++nIter;
-            }            
+            }
+            
+            delete[] data;
+            delete[] clusterIDs;
+            delete[] upperBounds;
+            delete[] lowerBounds;
         } 
         catch (RSGISClustererException &e) 
         {
@@ -946,7 +1132,7 @@ namespace rsgis {namespace math{
     
     
 
-    RSGISISODataClusterer::RSGISISODataClusterer(InitClustererMethods initCentres, float minDistBetweenClusters, unsigned int minNumFeatures, float maxStdDev, unsigned int minNumClusters, unsigned int startIteration, unsigned int endIteration)
+    RSGISISODataClusterer::RSGISISODataClusterer(InitClustererMethods initCentres, float minDistBetweenClusters, unsigned int minNumFeatures, float maxStdDev, unsigned int minNumClusters, unsigned int startIteration, unsigned int endIteration, unsigned int numThreads): RSGISClusterer(numThreads)
     {
         this->initCentres = initCentres;
         this->minDistBetweenClusters = minDistBetweenClusters;
@@ -1016,7 +1202,21 @@ namespace rsgis {namespace math{
             delete[] minVals;
             delete[] maxVals;
             
-            std::vector< std::pair< unsigned int, std::vector<float> > > *clusterData = this->createClusterDataInitClusterIDs(input, clusterCentres);
+            size_t numPts = input->size();
+            if(numPts == 0)
+            {
+                throw RSGISClustererException("There is no data to cluster.");
+            }
+            float *data = this->createDataMatrix(input, numFeatures);
+            unsigned int *clusterIDs = new unsigned int[numPts];
+            double *upperBounds = new double[numPts];
+            double *lowerBounds = new double[numPts];
+            std::vector<double> centreShifts;
+            for(size_t n = 0; n < numPts; ++n)
+            {
+                clusterIDs[n] = 0;
+            }
+            this->assignClusterIDs(data, numPts, numFeatures, clusterCentres, clusterIDs, upperBounds, lowerBounds, NULL);
             
             unsigned int nIter = 0;
             unsigned int nChange = 0;
@@ -1028,16 +1228,20 @@ namespace rsgis {namespace math{
             {
                 contProcess = false;
                 
-                this->recalcClusterCentres(clusterData, clusterCentres, true);
+                this->updateClusterCentres(data, numPts, numFeatures, clusterIDs, clusterCentres, true, &centreShifts);
                 
                 if((nIter > this->startIteration) & (nIter < this->endIteration))
                 {
                     this->addRemoveClusters(clusterCentres);
-                }                
-                
-                nChange = this->reassignClusterIDs(clusterData, clusterCentres);
+                    // The clusters have been merged and split so the bounds are no longer valid.
+                    nChange = this->assignClusterIDs(data, numPts, numFeatures, clusterCentres, clusterIDs, upperBounds, lowerBounds, NULL);
+                }
+                else
+                {
+                    nChange = this->assignClusterIDs(data, numPts, numFeatures, clusterCentres, clusterIDs, upperBounds, lowerBounds, &centreShifts);
+                }
                 
-                amountOfChange = ((float)nChange)/clusterData->size();
+                amountOfChange = ((float)nChange)/numPts;
                 
                 std::cout << "Iteration " << nIter << " has change " << amountOfChange*100 << " % of data clump IDs for " << clusterCentres->size() << " cluster centres.\n";
                 
@@ -1048,6 +1252,11 @@ namespace rsgis {namespace math{
                 ++nIter;
             }
             
+            delete[] data;
+            delete[] clusterIDs;
+            delete[] upperBounds;
+            delete[] lowerBounds;
+            
             std::cout << clusterCentres->size() << " Clusters were outputed\n";
         } 
         catch (RSGISClustererException &e) 
@@ -26,6 +26,12 @@
 #include <iostream>
 #include <cmath>
 #include <vector>
+#include <limits>
+#include <algorithm>
+#include <thread>
+#include <functional>
+#include <exception>
+#include <atomic>
 
 #include "math/RSGISProbabilityDistributions.h"
 #include "math/RSGISRandomDistro.h"
@@ -56,7 +62,7 @@ namespace rsgis {namespace math{
     class DllExport RSGISClusterer
 	{
 	public:
-		RSGISClusterer(){};
+		RSGISClusterer(unsigned int numThreads=1){this->numThreads = (numThreads == 0)?1:numThreads;};
         virtual std::vector< RSGISClusterCentre >* calcClusterCentres(std::vector< std::vector<float> > *input, unsigned int numFeatures, unsigned int numClusters, unsigned int maxNumIterations, float degreeOfChange) = 0;
         void calcDataRanges(std::vector< std::vector<float> > *input, unsigned int numFeatures, float *min, float *max);
         void calcDataStats(std::vector< std::vector<float> > *input, unsigned int numFeatures, float *min, float *max, float *mean, float *stddev);
@@ -68,13 +74,35 @@ namespace rsgis {namespace math{
         std::vector< RSGISClusterCentre >* initializeClusterCentresDiagonal(std::vector< std::vector<float> > *input, unsigned int numFeatures, float *min, float *max, float *mean, float *stddev, unsigned int numClusters);
         std::vector< RSGISClusterCentre >* initializeClusterCentresKPP(std::vector< std::vector<float> > *input, unsigned int numFeatures, float *min, float *max, unsigned int numClusters);
         
-        std::vector< std::pair< unsigned int, std::vector<float> > >* createClusterDataInitClusterIDs(std::vector< std::vector<float> > *input, std::vector< RSGISClusterCentre > *clusterCentres);
-        unsigned int reassignClusterIDs( std::vector< std::pair< unsigned int, std::vector<float> > > *clusterData, std::vector< RSGISClusterCentre > *clusterCentres);
-        void recalcClusterCentres( std::vector< std::pair< unsigned int, std::vector<float> > > *clusterData, std::vector< RSGISClusterCentre > *clusterCentres, bool calcStdDev);
         void assign2ClosestDataPoint(RSGISClusterCentre *cc, std::vector< std::vector<float> > *input, unsigned int numFeatures, std::vector< RSGISClusterCentre > *used);
         
         ~RSGISClusterer(){};
     protected:
+        /** Copies the input data into a single contiguous row-major array (numPts x numFeatures). */
+        float* createDataMatrix(std::vector< std::vector<float> > *input, unsigned int numFeatures);
+        /**
+         * Assigns each point to the closest cluster centre. If centreShifts is NULL the distance to every
+         * centre is calculated and the bounds are initialised. Otherwise, the centres are assumed to have
+         * moved by centreShifts since the last call and the upper (assigned centre) and lower (second closest
+         * centre) bounds are used, with the triangle inequality, to skip the points which cannot change
+         * cluster (Hamerly, 2010). Returns the number of points which changed cluster.
+         */
+        unsigned int assignClusterIDs(const float *data, size_t numPts, unsigned int numFeatures, std::vector< RSGISClusterCentre > *clusterCentres, unsigned int *clusterIDs, double *upperBounds, double *lowerBounds, std::vector<double> *centreShifts);
+        /**
+         * Recalculates the cluster centres (and optionally the standard deviations) from the assigned points.
+         * Empty clusters are removed and the cluster IDs renumbered. The distance each remaining centre moved
+         * is returned in centreShifts.
+         */
+        void updateClusterCentres(const float *data, size_t numPts, unsigned int numFeatures, unsigned int *clusterIDs, std::vector< RSGISClusterCentre > *clusterCentres, bool calcStdDev, std::vector<double> *centreShifts);
+        /**
+         * Splits the points into blocks of pointBlockSize and calls func(blockIdx, startPt, endPt) for each block
+         * across the threads. Results accumulated per block and combined in block order do not depend on the
+         * number of threads.
+         */
+        void processPointsInParallel(size_t numPts, const std::function<void(size_t, size_t, size_t)> &func);
+        size_t getNumPointBlocks(size_t numPts){return (numPts + pointBlockSize - 1) / pointBlockSize;};
+        static const size_t pointBlockSize = 8192;
+        unsigned int numThreads;
         double calcEucDistance(std::vector<float> d1, std::vector<float> d2)
         {
             unsigned int numVals = d1.size(); 
@@ -110,7 +138,7 @@ namespace rsgis {namespace math{
     class DllExport RSGISKMeansClusterer: public RSGISClusterer
     {
     public:
-		RSGISKMeansClusterer(InitClustererMethods initCentres);
+		RSGISKMeansClusterer(InitClustererMethods initCentres, unsigned int numThreads=1);
         std::vector< RSGISClusterCentre >* calcClusterCentres(std::vector< std::vector<float> > *input, unsigned int numFeatures, unsigned int numClusters, unsigned int maxNumIterations, float degreeOfChange);
 		~RSGISKMeansClusterer();
     private:
@@ -120,7 +148,7 @@ namespace rsgis {namespace math{
     class DllExport RSGISISODataClusterer: public RSGISClusterer
     {
     public:
-		RSGISISODataClusterer(InitClustererMethods initCentres, float minDistBetweenClusters, unsigned int minNumFeatures, float maxStdDev, unsigned int minNumClusters, unsigned int startIteration, unsigned int endIteration);
+		RSGISISODataClusterer(InitClustererMethods initCentres, float minDistBetweenClusters, unsigned int minNumFeatures, float maxStdDev, unsigned int minNumClusters, unsigned int startIteration, unsigned int endIteration, unsigned int numThreads=1);
         std::vector< RSGISClusterCentre >* calcClusterCentres(std::vector< std::vector<float> > *input, unsigned int numFeatures, unsigned int numClusters, unsigned int maxNumIterations, float degreeOfChange);
 		void addRemoveClusters(std::vector< RSGISClusterCentre > *clusterCentres);
         ~RSGISISODataClusterer();
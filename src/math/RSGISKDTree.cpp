@@ -0,0 +1,217 @@
+/*
+ *  RSGISKDTree.cpp
+ *  RSGIS_LIB
+ *
+ *  Created by Pete Bunting on 17/10/2026.
+ *  Copyright 2026 RSGISLib.
+ *
+ *  RSGISLib is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  RSGISLib is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with RSGISLib.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "RSGISKDTree.h"
+
+namespace rsgis{namespace math{
+    
+    RSGISKDTree::RSGISKDTree(const double *pts, size_t numPts, unsigned int numDims, RSGISKDTreeNorm norm, unsigned int leafSize)
+    {
+        if(numDims == 0)
+        {
+            throw RSGISMathException("The kd-tree points must have at least one dimension.");
+        }
+        this->numPts = numPts;
+        this->numDims = numDims;
+        this->norm = norm;
+        this->leafSize = std::max<unsigned int>(leafSize, 1);
+        
+        std::vector<size_t> order(numPts);
+        for(size_t i = 0; i < numPts; ++i)
+        {
+            order[i] = i;
+        }
+        this->ptIdxs.swap(order);
+        this->pts.assign(pts, pts + (numPts * numDims));
+        
+        if(numPts > 0)
+        {
+            this->nodes.reserve(((2 * numPts) / this->leafSize) + 1);
+            this->buildNode(0, numPts);
+        }
+        
+        // Store the points in tree order so each leaf is contiguous.
+        std::vector<double> orderedPts(numPts * numDims);
+        for(size_t i = 0; i < numPts; ++i)
+        {
+            std::copy(&this->pts[this->ptIdxs[i] * numDims], &this->pts[this->ptIdxs[i] * numDims] + numDims, &orderedPts[i * numDims]);
+        }
+        this->pts.swap(orderedPts);
+    }
+    
+    size_t RSGISKDTree::buildNode(size_t start, size_t end)
+    {
+        size_t nodeIdx = this->nodes.size();
+        KDNode node;
+        node.start = start;
+        node.end = end;
+        node.splitDim = 0;
+        node.splitVal = 0;
+        node.left = 0;
+        node.right = 0;
+        this->nodes.push_back(node);
+        
+        if((end - start) <= this->leafSize)
+        {
+            return nodeIdx;
+        }
+        
+        // Split on the dimension with the largest spread.
+        unsigned int splitDim = 0;
+        double maxSpread = -1;
+        for(unsigned int d = 0; d < this->numDims; ++d)
+        {
+            double minVal = this->pts[(this->ptIdxs[start] * this->numDims) + d];
+            double maxVal = minVal;
+            for(size_t i = start + 1; i < end; ++i)
+            {
+                double val = this->pts[(this->ptIdxs[i] * this->numDims) + d];
+                if(val < minVal)
+                {
+                    minVal = val;
+                }
+                else if(val > maxVal)
+                {
+                    maxVal = val;
+                }
+            }
+            if((maxVal - minVal) > maxSpread)
+            {
+                maxSpread = maxVal - minVal;
+                splitDim = d;
+            }
+        }
+        if(maxSpread <= 0)
+        {
+            // All the points are identical.
+            return nodeIdx;
+        }
+        
+        size_t mid = start + ((end - start) / 2);
+        const std::vector<double> &pts = this->pts;
+        unsigned int numDims = this->numDims;
+        std::nth_element(this->ptIdxs.begin() + start, this->ptIdxs.begin() + mid, this->ptIdxs.begin() + end, [&pts, numDims, splitDim](size_t a, size_t b)
+        {
+            return pts[(a * numDims) + splitDim] < pts[(b * numDims) + splitDim];
+        });
+        double splitVal = this->pts[(this->ptIdxs[mid] * this->numDims) + splitDim];
+        
+        size_t left = this->buildNode(start, mid);
+        size_t right = this->buildNode(mid, end);
+        this->nodes[nodeIdx].splitDim = splitDim;
+        this->nodes[nodeIdx].splitVal = splitVal;
+        this->nodes[nodeIdx].left = left;
+        this->nodes[nodeIdx].right = right;
+        return nodeIdx;
+    }
+    
+    void RSGISKDTree::findKNearest(const double *pt, unsigned int k, double maxDist, std::vector<std::pair<double, size_t> > *neighbours) const
+    {
+        neighbours->clear();
+        if((k == 0) || (this->numPts == 0))
+        {
+            return;
+        }
+        neighbours->reserve(k + 1);
+        this->searchNode(0, pt, k, maxDist, neighbours);
+        std::sort_heap(neighbours->begin(), neighbours->end());
+    }
+    
+    void RSGISKDTree::searchNode(size_t nodeIdx, const double *pt, unsigned int k, double maxDist, std::vector<std::pair<double, size_t> > *heap) const
+    {
+        const KDNode &node = this->nodes[nodeIdx];
+        if(node.left == 0)
+        {
+            for(size_t i = node.start; i < node.end; ++i)
+            {
+                double dist = this->calcDist(pt, i);
+                if(dist < maxDist)
+                {
+                    std::pair<double, size_t> neighbour(dist, this->ptIdxs[i]);
+                    if(heap->size() < k)
+                    {
+                        heap->push_back(neighbour);
+                        std::push_heap(heap->begin(), heap->end());
+                    }
+                    else if(neighbour < heap->front())
+                    {
+                        std::pop_heap(heap->begin(), heap->end());
+                        heap->back() = neighbour;
+                        std::push_heap(heap->begin(), heap->end());
+                    }
+                }
+            }
+            return;
+        }
+        
+        double diff = pt[node.splitDim] - node.splitVal;
+        size_t nearIdx = (diff < 0)?node.left:node.right;
+        size_t farIdx = (diff < 0)?node.right:node.left;
+        this->searchNode(nearIdx, pt, k, maxDist, heap);
+        
+        // Any point on the far side of the split is at least the distance to the
+        // splitting plane away; equal distances are searched as a point with a
+        // smaller index could be there.
+        double planeDist = this->calcPlaneDist(diff);
+        if((planeDist < maxDist) && ((heap->size() < k) || (planeDist <= heap->front().first)))
+        {
+            this->searchNode(farIdx, pt, k, maxDist, heap);
+        }
+    }
+    
+    double RSGISKDTree::calcDist(const double *pt, size_t ptIdx) const
+    {
+        const double *treePt = &this->pts[ptIdx * this->numDims];
+        double dist = 0;
+        if(this->norm == rsgis_kdtree_l2sq)
+        {
+            for(unsigned int d = 0; d < this->numDims; ++d)
+            {
+                double diff = pt[d] - treePt[d];
+                dist += diff * diff;
+            }
+        }
+        else
+        {
+            for(unsigned int d = 0; d < this->numDims; ++d)
+            {
+                dist += fabs(pt[d] - treePt[d]);
+            }
+        }
+        return dist;
+    }
+    
+    double RSGISKDTree::calcPlaneDist(double diff) const
+    {
+        if(this->norm == rsgis_kdtree_l2sq)
+        {
+            return diff * diff;
+        }
+        return fabs(diff);
+    }
+    
+    RSGISKDTree::~RSGISKDTree()
+    {
+        
+    }
+    
+}}
@@ -0,0 +1,109 @@
+/*
+ *  RSGISKDTree.h
+ *  RSGIS_LIB
+ *
+ *  Created by Pete Bunting on 17/10/2026.
+ *  Copyright 2026 RSGISLib.
+ *
+ *  RSGISLib is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  RSGISLib is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with RSGISLib.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef RSGISKDTree_H
+#define RSGISKDTree_H
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <cmath>
+
+#include "math/RSGISMathException.h"
+
+// mark all exported classes/functions with DllExport to have
+// them exported by Visual Studio
+#undef DllExport
+#ifdef _MSC_VER
+    #ifdef rsgis_maths_EXPORTS
+        #define DllExport   __declspec( dllexport )
+    #else
+        #define DllExport   __declspec( dllimport )
+    #endif
+#else
+    #define DllExport
+#endif
+
+namespace rsgis{namespace math{
+    
+    enum RSGISKDTreeNorm
+    {
+        rsgis_kdtree_l1, // Sum of the absolute differences.
+        rsgis_kdtree_l2sq // Sum of the squared differences.
+    };
+    
+    /**
+     * A kd-tree over a set of points, which is built once and can then be
+     * queried for the k nearest neighbours of a point concurrently from
+     * multiple threads (queries do not modify the tree).
+     *
+     * The distances returned are in the units of the norm (i.e., the squared
+     * Euclidean distance for rsgis_kdtree_l2sq). Neighbours are ordered by
+     * distance and then by point index, so the result is the same as sorting
+     * all the points by (distance, index) and taking the first k.
+     */
+    class DllExport RSGISKDTree
+    {
+    public:
+        /**
+         * The points are copied from pts, which holds numPts points each with
+         * numDims values (i.e., pts[(i*numDims)+d]).
+         */
+        RSGISKDTree(const double *pts, size_t numPts, unsigned int numDims, RSGISKDTreeNorm norm, unsigned int leafSize=16);
+        /**
+         * Find the k nearest points to pt which are at a distance less than
+         * maxDist, returned as (distance, point index) pairs in nearest first
+         * order (fewer than k are returned if there are not enough points
+         * within maxDist).
+         */
+        void findKNearest(const double *pt, unsigned int k, double maxDist, std::vector<std::pair<double, size_t> > *neighbours) const;
+        size_t getNumPts() const {return this->numPts;};
+        unsigned int getNumDims() const {return this->numDims;};
+        ~RSGISKDTree();
+    protected:
+        struct KDNode
+        {
+            size_t start;
+            size_t end;
+            unsigned int splitDim;
+            double splitVal;
+            size_t left;
+            size_t right;
+        };
+        size_t buildNode(size_t start, size_t end);
+        void searchNode(size_t nodeIdx, const double *pt, unsigned int k, double maxDist, std::vector<std::pair<double, size_t> > *heap) const;
+        double calcDist(const double *pt, size_t ptIdx) const;
+        double calcPlaneDist(double diff) const;
+        
+        size_t numPts;
+        unsigned int numDims;
+        RSGISKDTreeNorm norm;
+        unsigned int leafSize;
+        std::vector<double> pts;
+        std::vector<size_t> ptIdxs;
+        std::vector<KDNode> nodes;
+    };
+    
+}}
+
+#endif
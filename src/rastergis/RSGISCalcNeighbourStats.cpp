@@ -30,6 +30,39 @@ namespace rsgis{namespace rastergis{
     }
     
     void RSGISCalcNeighbourStats::populateStatsDiff2Neighbours(GDALDataset *inputClumps, RSGISFieldAttStats fieldStats, bool useAbsDiff, unsigned int ratBand)
+    {
+        try
+        {
+            if(ratBand == 0)
+            {
+                throw rsgis::RSGISAttributeTableException("RAT Band must be greater than zero.");
+            }
+            if(ratBand > inputClumps->GetRasterCount())
+            {
+                throw rsgis::RSGISAttributeTableException("RAT Band is larger than the number of bands within the image.");
+            }
+            
+            RSGISRasterAttUtils attUtils;
+            RSGISClumpNeighbourGraph neighbourGraph;
+            attUtils.getRATNeighbourGraph(inputClumps, ratBand, &neighbourGraph);
+            
+            this->populateStatsDiff2Neighbours(inputClumps, fieldStats, useAbsDiff, ratBand, &neighbourGraph);
+        }
+        catch(RSGISAttributeTableException &e)
+        {
+            throw e;
+        }
+        catch(RSGISException &e)
+        {
+            throw RSGISAttributeTableException(e.what());
+        }
+        catch(std::exception &e)
+        {
+            throw RSGISAttributeTableException(e.what());
+        }
+    }
+    
+    void RSGISCalcNeighbourStats::populateStatsDiff2Neighbours(GDALDataset *inputClumps, RSGISFieldAttStats fieldStats, bool useAbsDiff, unsigned int ratBand, const RSGISClumpNeighbourGraph *neighbourGraph)
     {
         try
         {
@@ -60,16 +93,8 @@ namespace rsgis{namespace rastergis{
             
             fieldStats.fieldIdx = attUtils.findColumnIndex(rat, fieldStats.field);
             
-            std::vector<std::vector<size_t>* > *neighbours = attUtils.getRATNeighbours(inputClumps, ratBand);
-            
-            if(numRows != neighbours->size())
+            if(numRows != neighbourGraph->numClumps)
             {
-                for(auto iterNeigh = neighbours->begin(); iterNeigh != neighbours->end(); ++iterNeigh)
-                {
-                    delete *iterNeigh;
-                }
-                delete neighbours;
-                
                 throw rsgis::RSGISAttributeTableException("RAT size is different to the number of neighbours retrieved.");
             }
             
@@ -78,11 +103,6 @@ namespace rsgis{namespace rastergis{
             
             if(colLen != numRows)
             {
-                for(auto iterNeigh = neighbours->begin(); iterNeigh != neighbours->end(); ++iterNeigh)
-                {
-                    delete *iterNeigh;
-                }
-                delete neighbours;
                 delete[] dataVals;
                 throw rsgis::RSGISAttributeTableException("The column does not have enough values ");
             }
@@ -124,15 +144,14 @@ namespace rsgis{namespace rastergis{
             for(size_t i  = 0; i <  numRows; ++i)
             {
                 diffClumpVals->clear();
-                std::vector<size_t> *clumpNeigh = neighbours->at(i);
-                diffClumpVals->reserve(clumpNeigh->size());
+                diffClumpVals->reserve(neighbourGraph->getNumNeighbours(i));
                 stats2Calc->min = 0.0;
                 stats2Calc->max = 0.0;
                 stats2Calc->mean = 0.0;
                 stats2Calc->stdDev = 0.0;
                 stats2Calc->sum = 0.0;
 
-                for(std::vector<size_t>::iterator iterNeigh = clumpNeigh->begin(); iterNeigh != clumpNeigh->end(); ++iterNeigh)
+                for(const size_t *iterNeigh = neighbourGraph->neighboursBegin(i); iterNeigh != neighbourGraph->neighboursEnd(i); ++iterNeigh)
                 {
                     if(useAbsDiff)
                     {
@@ -194,13 +213,7 @@ namespace rsgis{namespace rastergis{
             }
             delete stats2Calc;
             delete diffClumpVals;
-
-            for(auto iterNeigh = neighbours->begin(); iterNeigh != neighbours->end(); ++iterNeigh)
-            {
-                delete *iterNeigh;
-            }
-            delete neighbours;
-            
+            delete[] dataVals;
         }
         catch(RSGISAttributeTableException &e)
         {
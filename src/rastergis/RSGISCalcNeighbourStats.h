@@ -35,6 +35,7 @@
 #include "math/RSGISMathsUtils.h"
 
 #include "rastergis/RSGISRasterAttUtils.h"
+#include "rastergis/RSGISClumpNeighbourGraph.h"
 
 #include <boost/numeric/conversion/cast.hpp>
 #include <boost/lexical_cast.hpp>
@@ -81,6 +82,7 @@ namespace rsgis{namespace rastergis{
     public:
         RSGISCalcNeighbourStats();
         void populateStatsDiff2Neighbours(GDALDataset *inputClumps, RSGISFieldAttStats fieldStats, bool useAbsDiff, unsigned int ratBand);
+        void populateStatsDiff2Neighbours(GDALDataset *inputClumps, RSGISFieldAttStats fieldStats, bool useAbsDiff, unsigned int ratBand, const RSGISClumpNeighbourGraph *neighbourGraph);
         ~RSGISCalcNeighbourStats();
     };
     
@@ -0,0 +1,66 @@
+/*
+ *  RSGISClumpNeighbourGraph.h
+ *  RSGIS_LIB
+ *
+ *  Created by Pete Bunting on 17/10/2026.
+ *  Copyright 2026 RSGISLib.
+ *
+ *  RSGISLib is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  RSGISLib is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with RSGISLib.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef RSGISClumpNeighbourGraph_H
+#define RSGISClumpNeighbourGraph_H
+
+#include <vector>
+#include <cstddef>
+
+namespace rsgis{namespace rastergis{
+
+    /**
+     * Clump adjacency stored in compressed sparse row form. The neighbours of
+     * clump i (the RAT row / pixel value) are nbrIdxs[nbrOffsets[i]] to
+     * nbrIdxs[nbrOffsets[i+1]-1], sorted in ascending order. Clump 0 (no data)
+     * never has any neighbours.
+     */
+    struct RSGISClumpNeighbourGraph
+    {
+        size_t numClumps;
+        std::vector<size_t> nbrOffsets;
+        std::vector<size_t> nbrIdxs;
+
+        RSGISClumpNeighbourGraph(): numClumps(0), nbrOffsets(1, 0), nbrIdxs()
+        {
+
+        }
+
+        size_t getNumNeighbours(size_t clumpIdx) const
+        {
+            return nbrOffsets[clumpIdx+1] - nbrOffsets[clumpIdx];
+        }
+
+        const size_t* neighboursBegin(size_t clumpIdx) const
+        {
+            return nbrIdxs.data() + nbrOffsets[clumpIdx];
+        }
+
+        const size_t* neighboursEnd(size_t clumpIdx) const
+        {
+            return nbrIdxs.data() + nbrOffsets[clumpIdx+1];
+        }
+    };
+
+}}
+
+#endif
@@ -29,195 +29,239 @@ namespace rsgis{namespace rastergis{
         
     }
     
-    std::vector<std::list<size_t>* >* RSGISFindClumpNeighbours::findNeighbours(GDALDataset *clumpImage, unsigned int ratBand) 
+    void RSGISFindClumpNeighbours::findNeighbours(GDALDataset *clumpImage, unsigned int ratBand, size_t numClumps, RSGISClumpNeighbourGraph *neighbourGraph, unsigned int numThreads)
     {
-        std::vector<std::list<size_t>* > *neighbours = new std::vector<std::list<size_t>* >();
         try
         {
-            
+            if(neighbourGraph == NULL)
+            {
+                throw rsgis::img::RSGISImageCalcException("The neighbour graph to be populated is NULL.");
+            }
+            if((ratBand == 0) || (ratBand > clumpImage->GetRasterCount()))
+            {
+                throw rsgis::img::RSGISImageCalcException("The RAT band specified is not within the clumps image.");
+            }
+            if(numThreads == 0)
+            {
+                numThreads = 1;
+            }
+
             unsigned int width = clumpImage->GetRasterXSize();
             unsigned int height = clumpImage->GetRasterYSize();
             GDALRasterBand *imgBand = clumpImage->GetRasterBand(ratBand);
-            
-            unsigned int *clumpIdxs = new unsigned int[width];
-            unsigned long maxClumpIdx = 0;
-            
+
+            int xBlockSize = 0;
+            int yBlockSize = 0;
+            imgBand->GetBlockSize(&xBlockSize, &yBlockSize);
+            unsigned int threadRows = std::max(yBlockSize, 64);
+            unsigned int chunkRows = threadRows * numThreads;
+
+            // Run threadFunc(t) for t in [0, numThreads) and rethrow the first error.
+            auto runThreads = [numThreads](const std::function<void(unsigned int)> &threadFunc)
+            {
+                std::vector<std::exception_ptr> threadErrors(numThreads);
+                std::vector<std::thread> threads;
+                for(unsigned int t = 0; t < numThreads; ++t)
+                {
+                    threads.push_back(std::thread([&threadFunc, &threadErrors, t]()
+                    {
+                        try
+                        {
+                            threadFunc(t);
+                        }
+                        catch(...)
+                        {
+                            threadErrors[t] = std::current_exception();
+                        }
+                    }));
+                }
+                for(std::vector<std::thread>::iterator iterThreads = threads.begin(); iterThreads != threads.end(); ++iterThreads)
+                {
+                    (*iterThreads).join();
+                }
+                for(unsigned int t = 0; t < numThreads; ++t)
+                {
+                    if(threadErrors[t])
+                    {
+                        std::rethrow_exception(threadErrors[t]);
+                    }
+                }
+            };
+
+            // Each edge is stored once as (smaller ID << 32) | larger ID. The chunk
+            // buffer has an extra row so edges with the row below the chunk are found.
+            std::vector<unsigned int> chunkData(((size_t)width)*(chunkRows+1));
+            std::vector< std::vector<uint64_t> > threadEdges(numThreads);
+            std::vector<size_t> threadCompactSize(numThreads, 0);
+            std::vector<unsigned int> threadMaxID(numThreads, 0);
+            std::vector< std::vector<uint64_t> > threadRecentEdges(numThreads, std::vector<uint64_t>(RSGIS_NBR_RECENT_EDGES, UINT64_MAX));
+
             rsgis_tqdm pbar;
-            for(unsigned int i = 0; i < height; ++i)
+            for(unsigned int cRow = 0; cRow < height; cRow += chunkRows)
             {
-                pbar.progress(i, height);
-                imgBand->RasterIO(GF_Read, 0, i, width, 1, clumpIdxs, width, 1, GDT_UInt32, 0, 0);
-                for(unsigned int j = 0; j < width; ++j)
+                pbar.progress(cRow, height);
+                unsigned int nRows = std::min(chunkRows, height-cRow);
+                unsigned int nReadRows = ((cRow+nRows) < height)?(nRows+1):nRows;
+                imgBand->RasterIO(GF_Read, 0, cRow, width, nReadRows, chunkData.data(), width, nReadRows, GDT_UInt32, 0, 0);
+
+                auto findEdges = [&](unsigned int t)
                 {
-                    if((i == 0) & (j == 0))
+                    std::vector<uint64_t> &edges = threadEdges[t];
+                    std::vector<uint64_t> &recentEdges = threadRecentEdges[t];
+                    unsigned int maxID = threadMaxID[t];
+                    unsigned int sRow = std::min(t*threadRows, nRows);
+                    unsigned int eRow = std::min(sRow+threadRows, nRows);
+
+                    // A small direct mapped cache of recent edges removes most of the
+                    // repeats found along the length of a shared boundary.
+                    auto addEdge = [&edges, &recentEdges](unsigned int a, unsigned int b)
                     {
-                        maxClumpIdx = clumpIdxs[j];
+                        uint64_t edge = (a < b)?((((uint64_t)a) << 32) | b):((((uint64_t)b) << 32) | a);
+                        uint64_t &cached = recentEdges[(edge * 0x9E3779B97F4A7C15ULL) >> (64 - RSGIS_NBR_RECENT_EDGES_BITS)];
+                        if(cached != edge)
+                        {
+                            cached = edge;
+                            edges.push_back(edge);
+                        }
+                    };
+
+                    for(unsigned int r = sRow; r < eRow; ++r)
+                    {
+                        const unsigned int *rowVals = &chunkData[((size_t)r)*width];
+                        const unsigned int *belowVals = ((r+1) < nReadRows)?(rowVals+width):NULL;
+                        for(unsigned int c = 0; c < width; ++c)
+                        {
+                            unsigned int a = rowVals[c];
+                            if(a == 0)
+                            {
+                                continue;
+                            }
+                            if(a > maxID)
+                            {
+                                maxID = a;
+                            }
+                            if(((c+1) < width) && (rowVals[c+1] != 0) && (rowVals[c+1] != a))
+                            {
+                                addEdge(a, rowVals[c+1]);
+                            }
+                            if((belowVals != NULL) && (belowVals[c] != 0) && (belowVals[c] != a))
+                            {
+                                addEdge(a, belowVals[c]);
+                            }
+                        }
                     }
-                    else if(clumpIdxs[j] > maxClumpIdx)
+                    threadMaxID[t] = maxID;
+
+                    // Compact once the list has doubled so memory stays close to the number of unique edges.
+                    if((edges.size() - threadCompactSize[t]) > std::max<size_t>(threadCompactSize[t], RSGIS_NBR_MIN_COMPACT))
                     {
-                        maxClumpIdx = clumpIdxs[j];
+                        std::sort(edges.begin(), edges.end());
+                        edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
+                        threadCompactSize[t] = edges.size();
                     }
+                };
+
+                if(numThreads == 1)
+                {
+                    findEdges(0);
+                }
+                else
+                {
+                    runThreads(findEdges);
                 }
             }
             pbar.finish();
-            delete[] clumpIdxs;
-            
-            std::cout << "Number of clumps = " << maxClumpIdx << std::endl;
-            
-            neighbours->reserve(maxClumpIdx);
-            
-            for(unsigned long i = 0; i < maxClumpIdx; ++i)
+
+            unsigned int maxID = *std::max_element(threadMaxID.begin(), threadMaxID.end());
+            if((maxID != 0) && (maxID >= numClumps))
             {
-                neighbours->push_back(new std::list<size_t>());
+                throw rsgis::img::RSGISImageCalcException("Clump ID " + std::to_string(maxID) + " is outside the attribute table (" + std::to_string(numClumps) + " rows).");
             }
-            
-            int windowSize = 3;
-            
-            unsigned int **inputData = new unsigned int*[3];
-			for(int i = 0; i < windowSize; i++)
+
+            // Sort and remove duplicates from each thread's edges.
+            auto sortEdges = [&threadEdges](unsigned int t)
             {
-                inputData[i] = new unsigned int[width];
-                for(int j = 0; j < width; j++)
-                {
-                    inputData[i][j] = 0;
-                }
+                std::vector<uint64_t> &edges = threadEdges[t];
+                std::sort(edges.begin(), edges.end());
+                edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
+            };
+
+            // Merge the edges for a range of smaller clump IDs from every thread.
+            uint64_t numRangeIDs = ((uint64_t)maxID)+1;
+            std::vector< std::vector<uint64_t> > rangeEdges(numThreads);
+            auto mergeEdges = [&](unsigned int t)
+            {
+                uint64_t rangeStart = ((uint64_t)(numRangeIDs*t/numThreads)) << 32;
+                uint64_t rangeEnd = ((uint64_t)(numRangeIDs*(t+1)/numThreads)) << 32;
+                bool lastRange = ((t+1) == numThreads);
+                std::vector<uint64_t> &edges = rangeEdges[t];
+                for(unsigned int n = 0; n < numThreads; ++n)
+                {
+                    std::vector<uint64_t>::const_iterator iterStart = std::lower_bound(threadEdges[n].begin(), threadEdges[n].end(), rangeStart);
+                    std::vector<uint64_t>::const_iterator iterEnd = lastRange?threadEdges[n].end():std::lower_bound(threadEdges[n].begin(), threadEdges[n].end(), rangeEnd);
+                    edges.insert(edges.end(), iterStart, iterEnd);
+                }
+                std::sort(edges.begin(), edges.end());
+                edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
+            };
+
+            if(numThreads == 1)
+            {
+                sortEdges(0);
+                rangeEdges[0].swap(threadEdges[0]);
             }
-            
-            unsigned int **dataBlock = new unsigned int*[windowSize];
-            for(int i = 0; i < windowSize; i++)
+            else
             {
-                dataBlock[i] = new unsigned int[windowSize];
+                runThreads(sortEdges);
+                runThreads(mergeEdges);
             }
-            
-            unsigned long clumpID = 0;
-            
-			pbar.reset();
-			// Loop images to process data
-			for(int i = 0; i < height; i++)
-			{				
-				pbar.progress(i, height);
-				                
-				for(int m = 0; m < windowSize; m++)
-				{
-					if(m == 0)
-					{
-						if(i == 0)
-						{
-							for(int k = 0; k < width; k++)
-                            {
-                                inputData[m][k] = 0;
-                            }
-						}
-						else
-						{
-							imgBand->RasterIO(GF_Read, 0, i-1, width, 1, inputData[m], width, 1, GDT_UInt32, 0, 0);
-						}
-					}
-					else if(m == 2)
-					{
-						if((i + 1) >= height)
-						{
-							for(int k = 0; k < width; k++)
-                            {
-                                inputData[m][k] = 0;
-                            }
-						}
-						else
-						{
-							imgBand->RasterIO(GF_Read, 0, i+1, width, 1, inputData[m], width, 1, GDT_UInt32, 0, 0);
-						}
-					}
-					else
-					{
-						imgBand->RasterIO(GF_Read, 0, i, width, 1, inputData[m], width, 1, GDT_UInt32, 0, 0);
-					}
-				}
-				
-				for(int j = 0; j < width; j++)
-				{
-					for(int m = 0; m < windowSize; m++)
-					{
-						for(int k = 0; k < windowSize; k++)
-						{
-                            
-							if(k == 0)
-							{
-								if(j == 0)
-								{
-									dataBlock[m][k] = 0;
-								}
-								else
-								{
-									dataBlock[m][k] = inputData[m][(j-1)];
-								}
-							}
-							else if(k == 2)
-							{
-								if((j + 1) >= width)
-								{
-									dataBlock[m][k] = 0;
-								}
-								else
-								{
-                                    dataBlock[m][k] = inputData[m][(j+1)];
-								}
-							}
-							else
-							{
-								dataBlock[m][k] = inputData[m][j];
-							}
-						}
-					}
-					
-					
-                    // Process Window.
-                    clumpID = dataBlock[1][1];
-                    if(clumpID > 0)
-                    {
-                        if((dataBlock[0][1] > 0) & (dataBlock[0][1] != clumpID))
-                        {
-                            neighbours->at(clumpID-1)->push_back(dataBlock[0][1]-1);
-                        }
-                        if((dataBlock[1][0] > 0) & (dataBlock[1][0] != clumpID))
-                        {
-                            neighbours->at(clumpID-1)->push_back(dataBlock[1][0]-1);
-                        }
-                        if((dataBlock[1][2] > 0) & (dataBlock[1][2] != clumpID))
-                        {
-                            neighbours->at(clumpID-1)->push_back(dataBlock[1][2]-1);
-                        }
-                        if((dataBlock[2][1] > 0) & (dataBlock[2][1] != clumpID))
-                        {
-                            neighbours->at(clumpID-1)->push_back(dataBlock[2][1]-1);
-                        }
-                    }
-				}
-			}
-			pbar.finish();
-            
-			for(int i = 0; i < windowSize; i++)
+            std::vector< std::vector<uint64_t> >().swap(threadEdges);
+
+            // Build the CSR adjacency; as edges are visited in sorted order each list is sorted.
+            neighbourGraph->numClumps = numClumps;
+            neighbourGraph->nbrOffsets.assign(numClumps+1, 0);
+            std::vector<size_t> &nbrOffsets = neighbourGraph->nbrOffsets;
+            for(std::vector< std::vector<uint64_t> >::iterator iterRange = rangeEdges.begin(); iterRange != rangeEdges.end(); ++iterRange)
             {
-                delete[] dataBlock[i];
-                delete[] inputData[i];
+                for(std::vector<uint64_t>::iterator iterEdge = (*iterRange).begin(); iterEdge != (*iterRange).end(); ++iterEdge)
+                {
+                    ++nbrOffsets[((*iterEdge) >> 32)+1];
+                    ++nbrOffsets[((*iterEdge) & 0xFFFFFFFFULL)+1];
+                }
             }
-            delete[] dataBlock;
-            delete[] inputData;
-            
-            for(unsigned long i = 0; i < maxClumpIdx; ++i)
+            for(size_t i = 0; i < numClumps; ++i)
             {
-                neighbours->at(i)->sort();
-                neighbours->at(i)->unique();
+                nbrOffsets[i+1] += nbrOffsets[i];
+            }
+
+            neighbourGraph->nbrIdxs.assign(nbrOffsets[numClumps], 0);
+            std::vector<size_t> fillIdxs(nbrOffsets.begin(), nbrOffsets.end()-1);
+            for(std::vector< std::vector<uint64_t> >::iterator iterRange = rangeEdges.begin(); iterRange != rangeEdges.end(); ++iterRange)
+            {
+                for(std::vector<uint64_t>::iterator iterEdge = (*iterRange).begin(); iterEdge != (*iterRange).end(); ++iterEdge)
+                {
+                    size_t a = (*iterEdge) >> 32;
+                    size_t b = (*iterEdge) & 0xFFFFFFFFULL;
+                    neighbourGraph->nbrIdxs[fillIdxs[a]++] = b;
+                    neighbourGraph->nbrIdxs[fillIdxs[b]++] = a;
+                }
             }
         }
         catch(rsgis::img::RSGISImageCalcException &e)
         {
             throw e;
         }
-        
-        return neighbours;
+        catch(rsgis::RSGISException &e)
+        {
+            throw rsgis::img::RSGISImageCalcException(e.what());
+        }
+        catch(std::exception &e)
+        {
+            throw rsgis::img::RSGISImageCalcException(e.what());
+        }
     }
-    
-    void RSGISFindClumpNeighbours::findNeighboursKEAImageCalc(GDALDataset *clumpImage, unsigned int ratBand) 
+
+    void RSGISFindClumpNeighbours::findNeighboursKEAImageCalc(GDALDataset *clumpImage, unsigned int ratBand, unsigned int numThreads, RSGISClumpNeighbourGraph *neighbourGraph)
     {
         try
         {
@@ -228,7 +272,7 @@ namespace rsgis{namespace rastergis{
                 try
                 {
                     keaImgIO = static_cast<kealib::KEAImageIO*>(internalData);
-                    
+
                     if((keaImgIO == NULL) | (keaImgIO == 0))
                     {
                         throw rsgis::img::RSGISImageCalcException("Could not get hold of the internal KEA Image IO Object - was ");
@@ -251,45 +295,65 @@ namespace rsgis{namespace rastergis{
             {
                 throw rsgis::img::RSGISImageCalcException("Internal data on GDAL Dataset was NULL - check input file is KEA.");
             }
-            
+
             kealib::KEAAttributeTable *keaAtt = keaImgIO->getAttributeTable(kealib::kea_att_file, ratBand);
             size_t numRows = keaAtt->getSize();
-            
-            std::vector<std::vector<size_t>* > *neighbours = new std::vector<std::vector<size_t>* >();
-            neighbours->reserve(numRows);
-            for(size_t i = 0; i < numRows; ++i)
+
+            RSGISClumpNeighbourGraph localGraph;
+            if(neighbourGraph == NULL)
             {
-                neighbours->push_back(new std::vector<size_t>());
+                neighbourGraph = &localGraph;
             }
-            
-            
-            rsgis::img::RSGISCalcImageValue *findNeighbours = new RSGISFindNeighboursCalcImage(numRows, neighbours, ratBand);
-            rsgis::img::RSGISCalcImage imgCalc = rsgis::img::RSGISCalcImage(findNeighbours);
-            
-            imgCalc.calcImageWindowData(&clumpImage, 1, 3);
-            
+            this->findNeighbours(clumpImage, ratBand, numRows, neighbourGraph, numThreads);
+
             if(!keaAtt->hasField("NumNeighbours"))
             {
                 keaAtt->addAttIntField("NumNeighbours", 0, "");
             }
             size_t numNeighboursIdx = keaAtt->getFieldIndex("NumNeighbours");
-            
-            keaAtt->setNeighbours(0, neighbours->size(), neighbours);
-            
-            int64_t *numNeighbours = new int64_t[neighbours->size()];
-            unsigned int i = 0;
-            for(std::vector<std::vector<size_t>* >::iterator iterClumps = neighbours->begin(); iterClumps != neighbours->end(); ++iterClumps)
+
+            // Write the table in blocks so only a block of per-row vectors exists at once.
+            std::vector<std::vector<size_t>* > blockNeighbours;
+            std::vector<int64_t> numNeighbours;
+            try
             {
-                numNeighbours[i++] = (*iterClumps)->size();
+                for(size_t startRow = 0; startRow < numRows; startRow += RAT_BLOCK_LENGTH)
+                {
+                    size_t nRows = std::min<size_t>(RAT_BLOCK_LENGTH, numRows-startRow);
+                    while(blockNeighbours.size() > nRows)
+                    {
+                        delete blockNeighbours.back();
+                        blockNeighbours.pop_back();
+                    }
+                    while(blockNeighbours.size() < nRows)
+                    {
+                        blockNeighbours.push_back(new std::vector<size_t>());
+                    }
+                    numNeighbours.resize(nRows);
+
+                    for(size_t i = 0; i < nRows; ++i)
+                    {
+                        blockNeighbours[i]->assign(neighbourGraph->neighboursBegin(startRow+i), neighbourGraph->neighboursEnd(startRow+i));
+                        numNeighbours[i] = neighbourGraph->getNumNeighbours(startRow+i);
+                    }
+
+                    keaAtt->setNeighbours(startRow, nRows, &blockNeighbours);
+                    keaAtt->setIntFields(startRow, nRows, numNeighboursIdx, numNeighbours.data());
+                }
             }
-            
-            keaAtt->setIntFields(0, neighbours->size(), numNeighboursIdx, numNeighbours);
-            
-            for(std::vector<std::vector<size_t>* >::iterator iterClumps = neighbours->begin(); iterClumps != neighbours->end(); ++iterClumps)
+            catch(...)
+            {
+                for(std::vector<std::vector<size_t>* >::iterator iterClumps = blockNeighbours.begin(); iterClumps != blockNeighbours.end(); ++iterClumps)
+                {
+                    delete *iterClumps;
+                }
+                throw;
+            }
+
+            for(std::vector<std::vector<size_t>* >::iterator iterClumps = blockNeighbours.begin(); iterClumps != blockNeighbours.end(); ++iterClumps)
             {
                 delete *iterClumps;
             }
-            delete neighbours;
         }
         catch (rsgis::img::RSGISImageCalcException &e)
         {
@@ -318,267 +382,6 @@ namespace rsgis{namespace rastergis{
         
     }
     
-    
-    
-    
-    RSGISFindNeighboursCalcImage::RSGISFindNeighboursCalcImage(size_t numRows, std::vector<std::vector<size_t>* > *neighbours, unsigned int ratBand) : rsgis::img::RSGISCalcImageValue(0)
-    {
-        this->numRows = numRows;
-        this->neighbours = neighbours;
-        this->ratBand = ratBand;
-    }
-    
-    void RSGISFindNeighboursCalcImage::calcImageValue(float ***dataBlock, int numBands, int winSize, double *output) 
-    {
-        try
-        {
-            int winHsize = ((winSize-1)/2);
-            
-            if(dataBlock[ratBand-1][winHsize][winHsize] > 0)
-            {
-                size_t fid = 0;
-                try
-                {
-                    fid = boost::lexical_cast<size_t>(dataBlock[ratBand-1][winHsize][winHsize]);
-                }
-                catch(boost::numeric::negative_overflow& e)
-                {
-                    std::cout << "dataBlock[" << ratBand-1 << "][winHsize][winHsize] = " << dataBlock[ratBand-1][winHsize][winHsize] << std::endl;
-                    throw rsgis::img::RSGISImageCalcException(e.what());
-                }
-                catch(boost::numeric::positive_overflow& e)
-                {
-                    std::cout << "dataBlock[" << ratBand-1 << "][winHsize][winHsize] = " << dataBlock[ratBand-1][winHsize][winHsize] << std::endl;
-                    throw rsgis::img::RSGISImageCalcException(e.what());
-                }
-                catch(boost::numeric::bad_numeric_cast& e)
-                {
-                    std::cout << "dataBlock[" << ratBand-1 << "][winHsize][winHsize] = " << dataBlock[ratBand-1][winHsize][winHsize] << std::endl;
-                    throw rsgis::img::RSGISImageCalcException(e.what());
-                }
-
-                
-                
-                
-                
-                size_t fidLeft = 0;
-                try
-                {
-                    fidLeft = boost::lexical_cast<size_t>(dataBlock[ratBand-1][winHsize][winHsize-1]);
-                }
-                catch(boost::numeric::negative_overflow& e)
-                {
-                    std::cout << "dataBlock[" << ratBand-1 << "][winHsize][winHsize-1] = " << dataBlock[ratBand-1][winHsize][winHsize-1] << std::endl;
-                    throw rsgis::img::RSGISImageCalcException(e.what());
-                }
-                catch(boost::numeric::positive_overflow& e)
-                {
-                    std::cout << "dataBlock[" << ratBand-1 << "][winHsize][winHsize-1] = " << dataBlock[ratBand-1][winHsize][winHsize-1] << std::endl;
-                    throw rsgis::img::RSGISImageCalcException(e.what());
-                }
-                catch(boost::numeric::bad_numeric_cast& e)
-                {
-                    std::cout << "dataBlock[" << ratBand-1 << "][winHsize][winHsize-1] = " << dataBlock[ratBand-1][winHsize][winHsize-1] << std::endl;
-                    throw rsgis::img::RSGISImageCalcException(e.what());
-                }
-                
-                if((fidLeft != 0) && (fidLeft != fid))
-                {
-                    if(neighbours->at(fid)->size() == 0)
-                    {
-                        neighbours->at(fid)->push_back(fidLeft);
-                    }
-                    else
-                    {
-                        bool found = false;
-                        for(std::vector<size_t>::iterator iterVal = neighbours->at(fid)->begin(); iterVal != neighbours->at(fid)->end(); ++iterVal)
-                        {
-                            if((*iterVal) == fidLeft)
-                            {
-                                found = true;
-                                break;
-                            }
-                        }
-                        
-                        if(!found)
-                        {
-                            neighbours->at(fid)->push_back(fidLeft);
-                        }
-                    }
-                }
-                
-                
-                
-                
-                
-                size_t fidUp = 0;
-                try
-                {
-                    fidUp = boost::lexical_cast<size_t>(dataBlock[ratBand-1][winHsize+1][winHsize]);
-                }
-                catch(boost::numeric::negative_overflow& e)
-                {
-                    std::cout << "dataBlock[" << ratBand-1 << "][winHsize+1][winHsize] = " << dataBlock[ratBand-1][winHsize+1][winHsize] << std::endl;
-                    throw rsgis::img::RSGISImageCalcException(e.what());
-                }
-                catch(boost::numeric::positive_overflow& e)
-                {
-                    std::cout << "dataBlock[" << ratBand-1 << "][winHsize+1][winHsize] = " << dataBlock[ratBand-1][winHsize+1][winHsize] << std::endl;
-                    throw rsgis::img::RSGISImageCalcException(e.what());
-                }
-                catch(boost::numeric::bad_numeric_cast& e)
-                {
-                    std::cout << "dataBlock[" << ratBand-1 << "][winHsize+1][winHsize] = " << dataBlock[ratBand-1][winHsize+1][winHsize] << std::endl;
-                    throw rsgis::img::RSGISImageCalcException(e.what());
-                }
-                
-                if((fidUp != 0) && (fidUp != fid))
-                {
-                    if(neighbours->at(fid)->size() == 0)
-                    {
-                        neighbours->at(fid)->push_back(fidUp);
-                    }
-                    else
-                    {
-                        bool found = false;
-                        for(std::vector<size_t>::iterator iterVal = neighbours->at(fid)->begin(); iterVal != neighbours->at(fid)->end(); ++iterVal)
-                        {
-                            if((*iterVal) == fidUp)
-                            {
-                                found = true;
-                                break;
-                            }
-                        }
-                        
-                        if(!found)
-                        {
-                            neighbours->at(fid)->push_back(fidUp);
-                        }
-                    }
-                }
-                
-                
-                
-                
-                size_t fidRight = 0;
-                try
-                {
-                    fidRight = boost::lexical_cast<size_t>(dataBlock[ratBand-1][winHsize][winHsize+1]);
-                }
-                catch(boost::numeric::negative_overflow& e)
-                {
-                    std::cout << "dataBlock[" << ratBand-1 << "][winHsize][winHsize+1] = " << dataBlock[ratBand-1][winHsize][winHsize+1] << std::endl;
-                    throw rsgis::img::RSGISImageCalcException(e.what());
-                }
-                catch(boost::numeric::positive_overflow& e)
-                {
-                    std::cout << "dataBlock[" << ratBand-1 << "][winHsize][winHsize+1] = " << dataBlock[ratBand-1][winHsize][winHsize+1] << std::endl;
-                    throw rsgis::img::RSGISImageCalcException(e.what());
-                }
-                catch(boost::numeric::bad_numeric_cast& e)
-                {
-                    std::cout << "dataBlock[" << ratBand-1 << "][winHsize][winHsize+1] = " << dataBlock[ratBand-1][winHsize][winHsize+1] << std::endl;
-                    throw rsgis::img::RSGISImageCalcException(e.what());
-                }
-                
-                if((fidRight != 0) && (fidRight != fid))
-                {
-                    if(neighbours->at(fid)->size() == 0)
-                    {
-                        neighbours->at(fid)->push_back(fidRight);
-                    }
-                    else
-                    {
-                        bool found = false;
-                        for(std::vector<size_t>::iterator iterVal = neighbours->at(fid)->begin(); iterVal != neighbours->at(fid)->end(); ++iterVal)
-                        {
-                            if((*iterVal) == fidRight)
-                            {
-                                found = true;
-                                break;
-                            }
-                        }
-                        
-                        if(!found)
-                        {
-                            neighbours->at(fid)->push_back(fidRight);
-                        }
-                    }
-                }
-                
-                
-                
-                
-                size_t fidDown = 0;
-                try
-                {
-                    fidDown = boost::lexical_cast<size_t>(dataBlock[ratBand-1][winHsize-1][winHsize]);
-                }
-                catch(boost::numeric::negative_overflow& e)
-                {
-                    std::cout << "dataBlock[" << ratBand-1 << "][winHsize-1][winHsize] = " << dataBlock[ratBand-1][winHsize-1][winHsize] << std::endl;
-                    throw rsgis::img::RSGISImageCalcException(e.what());
-                }
-                catch(boost::numeric::positive_overflow& e)
-                {
-                    std::cout << "dataBlock[" << ratBand-1 << "][winHsize-1][winHsize] = " << dataBlock[ratBand-1][winHsize-1][winHsize] << std::endl;
-                    throw rsgis::img::RSGISImageCalcException(e.what());
-                }
-                catch(boost::numeric::bad_numeric_cast& e)
-                {
-                    std::cout << "dataBlock[" << ratBand-1 << "][winHsize-1][winHsize] = " << dataBlock[ratBand-1][winHsize-1][winHsize] << std::endl;
-                    throw rsgis::img::RSGISImageCalcException(e.what());
-                }
-                
-                if((fidDown != 0) && (fidDown != fid))
-                {
-                    if(neighbours->at(fid)->size() == 0)
-                    {
-                        neighbours->at(fid)->push_back(fidDown);
-                    }
-                    else
-                    {
-                        bool found = false;
-                        for(std::vector<size_t>::iterator iterVal = neighbours->at(fid)->begin(); iterVal != neighbours->at(fid)->end(); ++iterVal)
-                        {
-                            if((*iterVal) == fidDown)
-                            {
-                                found = true;
-                                break;
-                            }
-                        }
-                        
-                        if(!found)
-                        {
-                            neighbours->at(fid)->push_back(fidDown);
-                        }
-                    }
-                }
-            }
-        }
-        catch(rsgis::img::RSGISImageCalcException &e)
-        {
-            throw e;
-        }
-        catch(rsgis::RSGISException &e)
-        {
-            throw rsgis::img::RSGISImageCalcException(e.what());
-        }
-        catch(std::exception &e)
-        {
-            throw rsgis::img::RSGISImageCalcException(e.what());
-        }
-    }
-    
-    RSGISFindNeighboursCalcImage::~RSGISFindNeighboursCalcImage()
-    {
-        
-    }
-    
-    
-    
-    
-    
     RSGISIdentifyBoundaryPixels::RSGISIdentifyBoundaryPixels(unsigned int ratBand) : rsgis::img::RSGISCalcImageValue(1)
     {
         this->ratBand = ratBand;
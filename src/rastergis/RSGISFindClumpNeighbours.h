@@ -30,6 +30,10 @@
 #include <list>
 #include <vector>
 #include <algorithm>
+#include <functional>
+#include <thread>
+#include <exception>
+#include <cstdint>
 
 #include "img/RSGISImageCalcException.h"
 #include "img/RSGISCalcImageValue.h"
@@ -40,6 +44,7 @@
 #include "common/rsgis-tqdm.h"
 
 #include "rastergis/RSGISRasterAttUtils.h"
+#include "rastergis/RSGISClumpNeighbourGraph.h"
 
 #include "gdal_priv.h"
 #include "ogrsf_frmts.h"
@@ -58,32 +63,32 @@
     #define DllExport
 #endif
 
+#define RSGIS_NBR_RECENT_EDGES_BITS 12 // Size (log2) of the per thread cache of recently found edges.
+#define RSGIS_NBR_RECENT_EDGES (1 << RSGIS_NBR_RECENT_EDGES_BITS)
+#define RSGIS_NBR_MIN_COMPACT 1048576 // Minimum number of new edges before a thread's edge list is compacted.
+
 namespace rsgis{namespace rastergis{
     
     class DllExport RSGISFindClumpNeighbours
     {
     public:
         RSGISFindClumpNeighbours();
-        std::vector<std::list<size_t>* >* findNeighbours(GDALDataset *clumpImage, unsigned int ratBand);
-        void findNeighboursKEAImageCalc(GDALDataset *clumpImage, unsigned int ratBand);
+        /**
+         * Find the 4-connected neighbours of each clump (pixel value, 0 ignored) within ratBand,
+         * populating neighbourGraph with numClumps rows. An exception is thrown if a pixel value
+         * is not less than numClumps.
+         */
+        void findNeighbours(GDALDataset *clumpImage, unsigned int ratBand, size_t numClumps, RSGISClumpNeighbourGraph *neighbourGraph, unsigned int numThreads=1);
+        /**
+         * Find the clump neighbours and write them to the KEA neighbours table along with a
+         * 'NumNeighbours' column. If neighbourGraph is not NULL it is populated with the graph.
+         */
+        void findNeighboursKEAImageCalc(GDALDataset *clumpImage, unsigned int ratBand, unsigned int numThreads=1, RSGISClumpNeighbourGraph *neighbourGraph=NULL);
         ~RSGISFindClumpNeighbours();
     };
     
     
     
-    class DllExport RSGISFindNeighboursCalcImage : public rsgis::img::RSGISCalcImageValue
-	{
-	public:
-		RSGISFindNeighboursCalcImage(size_t numRows, std::vector<std::vector<size_t>* > *neighbours, unsigned int ratBand);
-		void calcImageValue(float ***dataBlock, int numBands, int winSize, double *output);
-		~RSGISFindNeighboursCalcImage();
-    private:
-        size_t numRows;
-        std::vector<std::vector<size_t>* > *neighbours;
-        unsigned int ratBand;
-	};
-    
-    
     class DllExport RSGISIdentifyBoundaryPixels : public rsgis::img::RSGISCalcImageValue
 	{
 	public:
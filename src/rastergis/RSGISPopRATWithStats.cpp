@@ -31,7 +31,7 @@ namespace rsgis{namespace rastergis{
         
     }
     
-    void RSGISPopRATWithStats::populateRATWithBasicStats(GDALDataset *inputClumps, GDALDataset *inputValsImage, std::vector<RSGISBandAttStats*> *bandStats, unsigned int ratBand)
+    void RSGISPopRATWithStats::populateRATWithBasicStats(GDALDataset *inputClumps, GDALDataset *inputValsImage, std::vector<RSGISBandAttStats*> *bandStats, unsigned int ratBand, unsigned int numThreads)
     {
         try
         {
@@ -43,6 +43,10 @@ namespace rsgis{namespace rastergis{
             {
                 throw rsgis::RSGISAttributeTableException("RAT Band is larger than the number of bands within the image.");
             }
+            if(numThreads < 1)
+            {
+                numThreads = 1;
+            }
             RSGISRasterAttUtils attUtils;
             GDALRasterAttributeTable *rat = inputClumps->GetRasterBand(ratBand)->GetDefaultRAT();
             size_t numRows = rat->GetRowCount();
@@ -51,369 +55,239 @@ namespace rsgis{namespace rastergis{
             long maxClumpID = 0;
             attUtils.getImageBandMinMax(inputClumps, ratBand, &minClumpID, &maxClumpID);
             
-            if(maxClumpID > numRows)
+            if(maxClumpID >= numRows)
             {
-                numRows = boost::lexical_cast<size_t>(maxClumpID);
+                numRows = boost::lexical_cast<size_t>(maxClumpID) + 1;
                 rat->SetRowCount(numRows);
             }
             
-            // Check whether a standard deviation is to be created (requires second iteration of image).
+            // Each image band is read and accumulated once, however many fields use it.
+            unsigned int numValsBands = inputValsImage->GetRasterCount();
+            std::vector<unsigned int> imgBands;
+            std::vector<unsigned int> statsBandIdxs;
             bool calcMins = false;
             bool calcMaxs = false;
             bool calcMeans = false;
             bool calcStdDevs = false;
             bool calcSums = false;
-            
-            size_t numFeats2Calc = 0;
-            size_t numStdDevs2Calc = 0;
             for(std::vector<rsgis::rastergis::RSGISBandAttStats*>::iterator iterBands = bandStats->begin(); iterBands != bandStats->end(); ++iterBands)
             {
-                if(((*iterBands)->calcStdDev) & (!(*iterBands)->calcMean))
+                if(((*iterBands)->band == 0) || ((*iterBands)->band > numValsBands))
                 {
-                    throw rsgis::RSGISAttributeTableException("If the standard deviation is required to be calculated then the mean must also be calculated.");
+                    throw rsgis::RSGISAttributeTableException("Band specified is not within the values image.");
+                }
+                std::vector<unsigned int>::iterator iterImgBand = std::find(imgBands.begin(), imgBands.end(), (*iterBands)->band);
+                statsBandIdxs.push_back(iterImgBand - imgBands.begin());
+                if(iterImgBand == imgBands.end())
+                {
+                    imgBands.push_back((*iterBands)->band);
                 }
 
                 if((*iterBands)->calcMin)
                 {
                     (*iterBands)->minFieldIdx = attUtils.findColumnIndexOrCreate(rat, (*iterBands)->minField, GFT_Real);
                     calcMins = true;
-                    (*iterBands)->minLocalIdx = numFeats2Calc++;
                 }
                 if((*iterBands)->calcMax)
                 {
                     (*iterBands)->maxFieldIdx = attUtils.findColumnIndexOrCreate(rat, (*iterBands)->maxField, GFT_Real);
                     calcMaxs = true;
-                    (*iterBands)->maxLocalIdx = numFeats2Calc++;
                 }
                 if((*iterBands)->calcMean)
                 {
                     (*iterBands)->meanFieldIdx = attUtils.findColumnIndexOrCreate(rat, (*iterBands)->meanField, GFT_Real);
                     calcMeans = true;
-                    (*iterBands)->meanLocalIdx = numFeats2Calc++;
                 }
                 if((*iterBands)->calcStdDev)
                 {
                     (*iterBands)->stdDevFieldIdx = attUtils.findColumnIndexOrCreate(rat, (*iterBands)->stdDevField, GFT_Real);
                     calcStdDevs = true;
-                    (*iterBands)->stdDevLocalIdx = numStdDevs2Calc++;
                 }
                 if((*iterBands)->calcSum)
                 {
                     (*iterBands)->sumFieldIdx = attUtils.findColumnIndexOrCreate(rat, (*iterBands)->sumField, GFT_Real);
                     calcSums = true;
-                    (*iterBands)->sumLocalIdx = numFeats2Calc++;
                 }
             }
+            unsigned int numImgBands = imgBands.size();
             
-            unsigned int histoIdx = attUtils.findColumnIndex(rat, "Histogram");
-            
-            bool *firstVal = new bool[numRows];
-            for(int i = 0; i < numRows; ++i)
+            std::vector<double> noDataVals(numImgBands);
+            bool *useNoDataVals = new bool[numImgBands];
+            for(unsigned int i = 0; i < numImgBands; ++i)
             {
-                firstVal[i] = true;
+                int useNoDataValInt = 0;
+                noDataVals[i] = inputValsImage->GetRasterBand(imgBands[i])->GetNoDataValue(&useNoDataValInt);
+                useNoDataVals[i] = (bool)useNoDataValInt;
             }
             
             GDALDataset **datasets = new GDALDataset*[2];
             datasets[0] = inputClumps;
             datasets[1] = inputValsImage;
-
-            int n_bands = inputValsImage->GetRasterCount();
-            double *no_data_vals = new double[n_bands];
-            bool *use_no_data_vals = new bool[n_bands];
-            int use_no_data_val_int = 0;
-            for(unsigned int i = 0; i < n_bands; ++i)
+            int **dsOffsets = new int*[2];
+            dsOffsets[0] = new int[2];
+            dsOffsets[1] = new int[2];
+            double *gdalTranslation = new double[6];
+            int width = 0;
+            int height = 0;
+            rsgis::img::RSGISImageUtils imgUtils;
+            imgUtils.getImageOverlap(datasets, 2, dsOffsets, &width, &height, gdalTranslation);
+            delete[] gdalTranslation;
+            
+            GDALRasterBand *clumpBand = inputClumps->GetRasterBand(ratBand);
+            std::vector<GDALRasterBand*> valsBands(numImgBands);
+            for(unsigned int i = 0; i < numImgBands; ++i)
             {
-                use_no_data_vals[i] = false;
-                use_no_data_val_int = false;
-                GDALRasterBand *image_band = inputValsImage->GetRasterBand(i+1);
-                no_data_vals[i] = image_band->GetNoDataValue(&use_no_data_val_int);
-                use_no_data_vals[i] = (bool)use_no_data_val_int;
+                valsBands[i] = inputValsImage->GetRasterBand(imgBands[i]);
             }
-
-            double **statsData = new double*[numRows];
-            for(unsigned int i = 0; i < numRows; ++i)
+            
+            /*
+             * The image is read in chunks of rows (GDAL is only called from this thread)
+             * and each chunk is divided into strips of rows which are accumulated
+             * concurrently, the nth strip of each chunk into the nth thread's accumulator.
+             * The thread accumulators are merged once the whole image has been read.
+             */
+            const unsigned int stripRows = 64;
+            unsigned int chunkRows = stripRows * numThreads;
+            size_t chunkPxls = ((size_t)width) * chunkRows;
+            std::vector<unsigned int> clumpChunk(chunkPxls);
+            std::vector<float> valsChunk(chunkPxls * numImgBands);
+            
+            std::vector<RSGISClumpStatsAccum> threadStats(numThreads);
+            for(unsigned int t = 0; t < numThreads; ++t)
             {
-                statsData[i] = new double[numFeats2Calc];
-                for(unsigned int j = 0; j < numFeats2Calc; ++j)
+                threadStats[t].init(numRows, numImgBands);
+            }
+            std::vector<std::exception_ptr> stripErrors(numThreads);
+            std::vector<std::thread> threads;
+            
+            rsgis_tqdm pbar;
+            for(unsigned int cRow = 0; cRow < height; cRow += chunkRows)
+            {
+                pbar.progress(cRow, height);
+                unsigned int nRows = std::min(chunkRows, height-cRow);
+                clumpBand->RasterIO(GF_Read, dsOffsets[0][0], dsOffsets[0][1]+cRow, width, nRows, clumpChunk.data(), width, nRows, GDT_UInt32, 0, 0);
+                for(unsigned int n = 0; n < numImgBands; ++n)
                 {
-                    statsData[i][j] = 0.0;
+                    valsBands[n]->RasterIO(GF_Read, dsOffsets[1][0], dsOffsets[1][1]+cRow, width, nRows, &valsChunk[n*chunkPxls], width, nRows, GDT_Float32, 0, 0);
+                }
+                
+                unsigned int numStrips = ((nRows-1)/stripRows)+1;
+                if(numStrips == 1)
+                {
+                    this->accumClumpStatsRows(clumpChunk.data(), valsChunk.data(), ((size_t)width)*nRows, chunkPxls, noDataVals.data(), useNoDataVals, &threadStats[0]);
+                    continue;
+                }
+                
+                threads.clear();
+                for(unsigned int t = 0; t < numStrips; ++t)
+                {
+                    threads.push_back(std::thread([&, t]()
+                    {
+                        try
+                        {
+                            size_t sPxl = ((size_t)t)*stripRows*width;
+                            size_t ePxl = std::min(((size_t)(t+1))*stripRows, (size_t)nRows)*width;
+                            this->accumClumpStatsRows(&clumpChunk[sPxl], &valsChunk[sPxl], ePxl-sPxl, chunkPxls, noDataVals.data(), useNoDataVals, &threadStats[t]);
+                        }
+                        catch(...)
+                        {
+                            stripErrors[t] = std::current_exception();
+                        }
+                    }));
+                }
+                for(std::vector<std::thread>::iterator iterThreads = threads.begin(); iterThreads != threads.end(); ++iterThreads)
+                {
+                    (*iterThreads).join();
+                }
+                for(unsigned int t = 0; t < numStrips; ++t)
+                {
+                    if(stripErrors[t])
+                    {
+                        std::rethrow_exception(stripErrors[t]);
+                    }
                 }
             }
+            pbar.finish();
+            std::vector<unsigned int>().swap(clumpChunk);
+            std::vector<float>().swap(valsChunk);
             
-            RSGISCalcClusterPxlValueStats *calcImgValStats = new RSGISCalcClusterPxlValueStats(statsData, bandStats, firstVal, ratBand, no_data_vals, use_no_data_vals);
-            rsgis::img::RSGISCalcImage calcImageStats(calcImgValStats);
-            calcImageStats.calcImage(datasets, 1, 1);
-            delete calcImgValStats;
+            RSGISClumpStatsAccum *clumpStats = &threadStats[0];
+            for(unsigned int t = 1; t < numThreads; ++t)
+            {
+                clumpStats->merge(&threadStats[t]);
+                threadStats[t].clear();
+            }
             
             std::cout << "Writing Stats (";
             if(calcMins){std::cout << "Min, ";}
             if(calcMaxs){std::cout << "Max, ";}
             if(calcMeans){std::cout << "Mean, ";}
+            if(calcStdDevs){std::cout << "StdDev, ";}
             if(calcSums){std::cout << "Sum";}
             std::cout << ") to Output RAT\n";
             
-            size_t numBlocks = floor((double)numRows/(double)RAT_BLOCK_LENGTH);
-            size_t rowsRemain = numRows - (numBlocks * RAT_BLOCK_LENGTH);
-            
+            // Clumps without any valid pixels are given a value of zero.
             double *dataBlock = new double[RAT_BLOCK_LENGTH];
-            double *histDataBlock = new double[RAT_BLOCK_LENGTH];
-            size_t startRow = 0;
-            size_t rowID = 0;
-            for(size_t i = 0; i < numBlocks; ++i)
+            for(size_t startRow = 0; startRow < numRows; startRow += RAT_BLOCK_LENGTH)
             {
-                rat->ValuesIO(GF_Read, histoIdx, startRow, RAT_BLOCK_LENGTH, histDataBlock);
-                for(std::vector<rsgis::rastergis::RSGISBandAttStats*>::iterator iterBands = bandStats->begin(); iterBands != bandStats->end(); ++iterBands)
+                size_t nBlockRows = std::min((size_t)RAT_BLOCK_LENGTH, numRows-startRow);
+                for(size_t i = 0; i < bandStats->size(); ++i)
                 {
-                    if((*iterBands)->calcMin)
-                    {
-                        rowID = startRow;
-                        for(size_t j = 0; j < RAT_BLOCK_LENGTH; ++j)
-                        {
-                            if(histDataBlock[j] > 0)
-                            {
-                                dataBlock[j] = statsData[rowID][(*iterBands)->minLocalIdx];
-                            }
-                            else
-                            {
-                                dataBlock[j] = 0.0;
-                            }
-                            ++rowID;
-                        }
-                        rat->ValuesIO(GF_Write, (*iterBands)->minFieldIdx, startRow, RAT_BLOCK_LENGTH, dataBlock);
-                    }
+                    RSGISBandAttStats *bandStat = bandStats->at(i);
+                    size_t idx = (startRow * numImgBands) + statsBandIdxs[i];
                     
-                    if((*iterBands)->calcMax)
+                    if(bandStat->calcMin)
                     {
-                        rowID = startRow;
-                        for(size_t j = 0; j < RAT_BLOCK_LENGTH; ++j)
+                        for(size_t j = 0, k = idx; j < nBlockRows; ++j, k += numImgBands)
                         {
-                            if(histDataBlock[j] > 0)
-                            {
-                                dataBlock[j] = statsData[rowID][(*iterBands)->maxLocalIdx];
-                            }
-                            else
-                            {
-                                dataBlock[j] = 0.0;
-                            }
-                            ++rowID;
+                            dataBlock[j] = (clumpStats->count[k] > 0)?clumpStats->minVal[k]:0.0;
                         }
-                        rat->ValuesIO(GF_Write, (*iterBands)->maxFieldIdx, startRow, RAT_BLOCK_LENGTH, dataBlock);
+                        rat->ValuesIO(GF_Write, bandStat->minFieldIdx, startRow, nBlockRows, dataBlock);
                     }
                     
-                    if((*iterBands)->calcMean)
+                    if(bandStat->calcMax)
                     {
-                        rowID = startRow;
-                        for(size_t j = 0; j < RAT_BLOCK_LENGTH; ++j)
+                        for(size_t j = 0, k = idx; j < nBlockRows; ++j, k += numImgBands)
                         {
-                            if(histDataBlock[j] > 0)
-                            {
-                                statsData[rowID][(*iterBands)->meanLocalIdx] = statsData[rowID][(*iterBands)->meanLocalIdx] / histDataBlock[j];
-                                dataBlock[j] = statsData[rowID][(*iterBands)->meanLocalIdx];
-                            }
-                            else
-                            {
-                                dataBlock[j] = 0.0;
-                            }
-                            ++rowID;
+                            dataBlock[j] = (clumpStats->count[k] > 0)?clumpStats->maxVal[k]:0.0;
                         }
-                        rat->ValuesIO(GF_Write, (*iterBands)->meanFieldIdx, startRow, RAT_BLOCK_LENGTH, dataBlock);
+                        rat->ValuesIO(GF_Write, bandStat->maxFieldIdx, startRow, nBlockRows, dataBlock);
                     }
                     
-                    if((*iterBands)->calcSum)
+                    if(bandStat->calcMean)
                     {
-                        rowID = startRow;
-                        for(size_t j = 0; j < RAT_BLOCK_LENGTH; ++j)
+                        for(size_t j = 0, k = idx; j < nBlockRows; ++j, k += numImgBands)
                         {
-                            if(histDataBlock[j] > 0)
-                            {
-                                dataBlock[j] = statsData[rowID][(*iterBands)->sumLocalIdx];
-                            }
-                            else
-                            {
-                                dataBlock[j] = 0.0;
-                            }
-                            ++rowID;
+                            dataBlock[j] = (clumpStats->count[k] > 0)?(clumpStats->sum[k] / clumpStats->count[k]):0.0;
                         }
-                        rat->ValuesIO(GF_Write, (*iterBands)->sumFieldIdx, startRow, RAT_BLOCK_LENGTH, dataBlock);
-                    }
-                }
-                startRow += RAT_BLOCK_LENGTH;
-            }
-            if(rowsRemain > 0)
-            {
-                rat->ValuesIO(GF_Read, histoIdx, startRow, rowsRemain, histDataBlock);
-                for(std::vector<rsgis::rastergis::RSGISBandAttStats*>::iterator iterBands = bandStats->begin(); iterBands != bandStats->end(); ++iterBands)
-                {
-                    if((*iterBands)->calcMin)
-                    {
-                        rowID = startRow;
-                        for(size_t j = 0; j < rowsRemain; ++j)
-                        {
-                            if(histDataBlock[j] > 0)
-                            {
-                                dataBlock[j] = statsData[rowID][(*iterBands)->minLocalIdx];
-                            }
-                            else
-                            {
-                                dataBlock[j] = 0.0;
-                            }
-                            ++rowID;
-                        }
-                        rat->ValuesIO(GF_Write, (*iterBands)->minFieldIdx, startRow, rowsRemain, dataBlock);
+                        rat->ValuesIO(GF_Write, bandStat->meanFieldIdx, startRow, nBlockRows, dataBlock);
                     }
                     
-                    if((*iterBands)->calcMax)
+                    if(bandStat->calcStdDev)
                     {
-                        rowID = startRow;
-                        for(size_t j = 0; j < rowsRemain; ++j)
+                        for(size_t j = 0, k = idx; j < nBlockRows; ++j, k += numImgBands)
                         {
-                            if(histDataBlock[j] > 0)
-                            {
-                                dataBlock[j] = statsData[rowID][(*iterBands)->maxLocalIdx];
-                            }
-                            else
-                            {
-                                dataBlock[j] = 0.0;
-                            }
-                            ++rowID;
+                            dataBlock[j] = (clumpStats->count[k] > 0)?sqrt(clumpStats->sumSqDiff[k] / clumpStats->count[k]):0.0;
                         }
-                        rat->ValuesIO(GF_Write, (*iterBands)->maxFieldIdx, startRow, rowsRemain, dataBlock);
+                        rat->ValuesIO(GF_Write, bandStat->stdDevFieldIdx, startRow, nBlockRows, dataBlock);
                     }
                     
-                    if((*iterBands)->calcMean)
-                    {
-                        rowID = startRow;
-                        for(size_t j = 0; j < rowsRemain; ++j)
-                        {
-                            if(histDataBlock[j] > 0)
-                            {
-                                statsData[rowID][(*iterBands)->meanLocalIdx] = statsData[rowID][(*iterBands)->meanLocalIdx] / histDataBlock[j];
-                                dataBlock[j] = statsData[rowID][(*iterBands)->meanLocalIdx];
-                            }
-                            else
-                            {
-                                dataBlock[j] = 0.0;
-                            }
-                            ++rowID;
-                        }
-                        rat->ValuesIO(GF_Write, (*iterBands)->meanFieldIdx, startRow, rowsRemain, dataBlock);
-                    }
-                    
-                    if((*iterBands)->calcSum)
-                    {
-                        rowID = startRow;
-                        for(size_t j = 0; j < rowsRemain; ++j)
-                        {
-                            if(histDataBlock[j] > 0)
-                            {
-                                dataBlock[j] = statsData[rowID][(*iterBands)->sumLocalIdx];
-                            }
-                            else
-                            {
-                                dataBlock[j] = 0.0;
-                            }
-                            ++rowID;
-                        }
-                        rat->ValuesIO(GF_Write, (*iterBands)->sumFieldIdx, startRow, rowsRemain, dataBlock);
-                    }
-                }
-            }
-            
-            if(calcStdDevs)
-            {
-                for(int i = 0; i < numRows; ++i)
-                {
-                    firstVal[i] = true;
-                }
-
-                // Get Image Values
-                double **stdDevData = new double*[numRows];
-                for(unsigned int i = 0; i < numRows; ++i)
-                {
-                    stdDevData[i] = new double[numStdDevs2Calc];
-                    for(unsigned int j = 0; j < numStdDevs2Calc; ++j)
-                    {
-                        stdDevData[i][j] = 0.0;
-                    }
-                }
-                RSGISCalcClusterPxlValueStdDev *calcImgValStdDev = new RSGISCalcClusterPxlValueStdDev(stdDevData, statsData, bandStats, firstVal, ratBand, no_data_vals, use_no_data_vals);
-                rsgis::img::RSGISCalcImage calcImageStdDev(calcImgValStdDev);
-                calcImageStdDev.calcImage(datasets, 1, 1);
-                delete calcImgValStdDev;
-
-                std::cout << "Writing Standard Deviation Stats to Output RAT\n";
-                startRow = 0;
-                for(size_t i = 0; i < numBlocks; ++i)
-                {
-                    rat->ValuesIO(GF_Read, histoIdx, startRow, RAT_BLOCK_LENGTH, histDataBlock);
-                    for(std::vector<rsgis::rastergis::RSGISBandAttStats*>::iterator iterBands = bandStats->begin(); iterBands != bandStats->end(); ++iterBands)
+                    if(bandStat->calcSum)
                     {
-                        if((*iterBands)->calcStdDev)
+                        for(size_t j = 0, k = idx; j < nBlockRows; ++j, k += numImgBands)
                         {
-                            rowID = startRow;
-                            for(size_t j = 0; j < RAT_BLOCK_LENGTH; ++j)
-                            {
-                                if(histDataBlock[j] > 0)
-                                {
-                                    stdDevData[rowID][(*iterBands)->stdDevLocalIdx] = sqrt(stdDevData[rowID][(*iterBands)->stdDevLocalIdx] / histDataBlock[j]);
-                                    dataBlock[j] = stdDevData[rowID][(*iterBands)->stdDevLocalIdx];
-                                }
-                                else
-                                {
-                                    dataBlock[j] = 0.0;
-                                }
-                                ++rowID;
-                            }
-                            rat->ValuesIO(GF_Write, (*iterBands)->stdDevFieldIdx, startRow, RAT_BLOCK_LENGTH, dataBlock);
+                            dataBlock[j] = (clumpStats->count[k] > 0)?clumpStats->sum[k]:0.0;
                         }
-                        
+                        rat->ValuesIO(GF_Write, bandStat->sumFieldIdx, startRow, nBlockRows, dataBlock);
                     }
-                    startRow += RAT_BLOCK_LENGTH;
-                }
-                if(rowsRemain > 0)
-                {
-                    rat->ValuesIO(GF_Read, histoIdx, startRow, rowsRemain, histDataBlock);
-                    for(std::vector<rsgis::rastergis::RSGISBandAttStats*>::iterator iterBands = bandStats->begin(); iterBands != bandStats->end(); ++iterBands)
-                    {
-                        if((*iterBands)->calcStdDev)
-                        {
-                            rowID = startRow;
-                            for(size_t j = 0; j < rowsRemain; ++j)
-                            {
-                                if(histDataBlock[j] > 0)
-                                {
-                                    stdDevData[rowID][(*iterBands)->stdDevLocalIdx] = sqrt(stdDevData[rowID][(*iterBands)->stdDevLocalIdx] / histDataBlock[j]);
-                                    dataBlock[j] = stdDevData[rowID][(*iterBands)->stdDevLocalIdx];
-                                }
-                                else
-                                {
-                                    dataBlock[j] = 0.0;
-                                }
-                                ++rowID;
-                            }
-                            rat->ValuesIO(GF_Write, (*iterBands)->stdDevFieldIdx, startRow, rowsRemain, dataBlock);
-                        }
-                    }
-                }
-                
-                for(unsigned int i = 0; i < numRows; ++i)
-                {
-                    delete[] stdDevData[i];
                 }
-                delete[] stdDevData;
-            }
-            
-            for(unsigned int i = 0; i < numRows; ++i)
-            {
-                delete[] statsData[i];
             }
-            delete[] statsData;
-            delete[] firstVal;
-            delete[] no_data_vals;
-            delete[] use_no_data_vals;
             
             delete[] dataBlock;
-            delete[] histDataBlock;
+            delete[] useNoDataVals;
+            delete[] dsOffsets[0];
+            delete[] dsOffsets[1];
+            delete[] dsOffsets;
             delete[] datasets;
         }
         catch(RSGISAttributeTableException &e)
@@ -430,6 +304,72 @@ namespace rsgis{namespace rastergis{
         }
     }
     
+    void RSGISPopRATWithStats::accumClumpStatsRows(unsigned int *clumpVals, float *bandVals, size_t numPxls, size_t bandStride, double *noDataVals, bool *useNoDataVals, RSGISClumpStatsAccum *accum)
+    {
+        unsigned int numBands = accum->numBands;
+        for(size_t i = 0; i < numPxls; ++i)
+        {
+            size_t fid = clumpVals[i];
+            if(fid == 0)
+            {
+                continue;
+            }
+            if(fid >= accum->numClumps)
+            {
+                throw rsgis::RSGISAttributeTableException("Clump ID is larger than the number of rows in the attribute table.");
+            }
+            size_t idx = fid * numBands;
+            for(unsigned int n = 0; n < numBands; ++n)
+            {
+                float val = bandVals[(n*bandStride)+i];
+                if((boost::math::isfinite)(val) && !(useNoDataVals[n] && (noDataVals[n] == val)))
+                {
+                    accum->addValue(idx+n, val);
+                }
+            }
+        }
+    }
+    
+    void RSGISClumpStatsAccum::merge(RSGISClumpStatsAccum *other)
+    {
+        if((other->numClumps != this->numClumps) || (other->numBands != this->numBands))
+        {
+            throw rsgis::RSGISAttributeTableException("Clump statistics accumulators must be the same size to be merged.");
+        }
+        size_t numVals = this->numClumps * this->numBands;
+        for(size_t i = 0; i < numVals; ++i)
+        {
+            unsigned long nB = other->count[i];
+            if(nB == 0)
+            {
+                continue;
+            }
+            unsigned long nA = this->count[i];
+            if(nA == 0)
+            {
+                this->count[i] = nB;
+                this->minVal[i] = other->minVal[i];
+                this->maxVal[i] = other->maxVal[i];
+                this->sum[i] = other->sum[i];
+                this->sumSqDiff[i] = other->sumSqDiff[i];
+                continue;
+            }
+            double n = ((double)nA) + nB;
+            double delta = (other->sum[i] / nB) - (this->sum[i] / nA);
+            this->sumSqDiff[i] += other->sumSqDiff[i] + (delta * delta * (((double)nA) * nB / n));
+            this->sum[i] += other->sum[i];
+            this->count[i] = nA + nB;
+            if(other->minVal[i] < this->minVal[i])
+            {
+                this->minVal[i] = other->minVal[i];
+            }
+            if(other->maxVal[i] > this->maxVal[i])
+            {
+                this->maxVal[i] = other->maxVal[i];
+            }
+        }
+    }
+    
     void RSGISPopRATWithStats::populateRATWithPercentileStats(GDALDataset *inputClumps, GDALDataset *inputValsImage, unsigned int band, std::vector<RSGISBandAttPercentiles*> *bandStats, unsigned int ratBand, unsigned int numHistBins)
     {
         try
@@ -460,9 +400,9 @@ namespace rsgis{namespace rastergis{
             long maxClumpID = 0;
             attUtils.getImageBandMinMax(inputClumps, ratBand, &minClumpID, &maxClumpID);
             
-            if(maxClumpID > numRows)
+            if(maxClumpID >= numRows)
             {
-                numRows = boost::lexical_cast<size_t>(maxClumpID);
+                numRows = boost::lexical_cast<size_t>(maxClumpID) + 1;
                 rat->SetRowCount(numRows);
             }
 
@@ -496,85 +436,62 @@ namespace rsgis{namespace rastergis{
             datasets[0] = inputClumps;
             datasets[1] = inputValsImage;
             
-            unsigned int **clumpHistData = new unsigned int*[numRows];
-            for(unsigned int i = 0; i < numRows; ++i)
-            {
-                clumpHistData[i] = new unsigned int[numHistBins];
-                for(unsigned int j = 0; j < numHistBins; ++j)
-                {
-                    clumpHistData[i][j] = 0.0;
-                }
-            }
+            RSGISSparseClumpHistograms *clumpHists = new RSGISSparseClumpHistograms();
             
             int useNoDataVal = false;
             double noDataVal = inputValsImage->GetRasterBand(band)->GetNoDataValue(&useNoDataVal);
             
-            RSGISCalcClusterPxlValueHistograms *calcImgValHists = new RSGISCalcClusterPxlValueHistograms(clumpHistData, binBounds, numHistBins, ratBand, band, noDataVal, useNoDataVal);
+            RSGISCalcClusterPxlValueHistograms *calcImgValHists = new RSGISCalcClusterPxlValueHistograms(clumpHists, binBounds, numHistBins, ratBand, band, noDataVal, useNoDataVal);
             rsgis::img::RSGISCalcImage calcImageStats(calcImgValHists);
             calcImageStats.calcImage(datasets, 1, 1);
             delete calcImgValHists;
+            clumpHists->finalise();
             
             std::cout << "Writing Percentile Values to Output RAT\n";
-            size_t numBlocks = floor((double)numRows/(double)RAT_BLOCK_LENGTH);
-            size_t rowsRemain = numRows - (numBlocks * RAT_BLOCK_LENGTH);
-            
-            rsgis::math::RSGISMathsUtils mathUtils;
             double *dataBlock = new double[RAT_BLOCK_LENGTH];
             double *histDataBlock = new double[RAT_BLOCK_LENGTH];
-            size_t startRow = 0;
-            size_t rowID = 0;
-            for(size_t i = 0; i < numBlocks; ++i)
+            std::vector<size_t> clumpStartIdxs(RAT_BLOCK_LENGTH+1);
+            size_t numEntries = clumpHists->getNumEntries();
+            size_t entryIdx = 0;
+            for(size_t startRow = 0; startRow < numRows; startRow += RAT_BLOCK_LENGTH)
             {
-                rat->ValuesIO(GF_Read, histoIdx, startRow, RAT_BLOCK_LENGTH, histDataBlock);
-                for(std::vector<rsgis::rastergis::RSGISBandAttPercentiles*>::iterator iterFeat = bandStats->begin(); iterFeat != bandStats->end(); ++iterFeat)
+                size_t nBlockRows = std::min((size_t)RAT_BLOCK_LENGTH, numRows-startRow);
+                rat->ValuesIO(GF_Read, histoIdx, startRow, nBlockRows, histDataBlock);
+                
+                // Find the run of histogram entries for each clump within the block.
+                for(size_t j = 0; j < nBlockRows; ++j)
                 {
-                    rowID = startRow;
-                    for(size_t j = 0; j < RAT_BLOCK_LENGTH; ++j)
+                    while((entryIdx < numEntries) && (clumpHists->getClump(entryIdx) < (startRow+j)))
                     {
-                        if(histDataBlock[j] > 0)
-                        {
-                            dataBlock[j] = mathUtils.calcPercentile((*iterFeat)->percentile, binBounds, binWidth, numHistBins, clumpHistData[rowID]); // calc percentile from the histogram...
-                        }
-                        else
-                        {
-                            dataBlock[j] = 0.0;
-                        }
-                        ++rowID;
+                        ++entryIdx;
                     }
-                    rat->ValuesIO(GF_Write, (*iterFeat)->fieldIdx, startRow, RAT_BLOCK_LENGTH, dataBlock);
+                    clumpStartIdxs[j] = entryIdx;
                 }
-                startRow += RAT_BLOCK_LENGTH;
-            }
-            if(rowsRemain > 0)
-            {
-                rat->ValuesIO(GF_Read, histoIdx, startRow, rowsRemain, histDataBlock);
+                while((entryIdx < numEntries) && (clumpHists->getClump(entryIdx) < (startRow+nBlockRows)))
+                {
+                    ++entryIdx;
+                }
+                clumpStartIdxs[nBlockRows] = entryIdx;
+                
                 for(std::vector<rsgis::rastergis::RSGISBandAttPercentiles*>::iterator iterFeat = bandStats->begin(); iterFeat != bandStats->end(); ++iterFeat)
                 {
-                    rowID = startRow;
-                    for(size_t j = 0; j < rowsRemain; ++j)
+                    for(size_t j = 0; j < nBlockRows; ++j)
                     {
                         if(histDataBlock[j] > 0)
                         {
-                            dataBlock[j] = mathUtils.calcPercentile((*iterFeat)->percentile, binBounds, binWidth, numHistBins, clumpHistData[rowID]); // calc percentile from the histogram...
+                            dataBlock[j] = this->calcSparseHistPercentile((*iterFeat)->percentile, binBounds, binWidth, clumpHists, clumpStartIdxs[j], clumpStartIdxs[j+1]);
                         }
                         else
                         {
                             dataBlock[j] = 0.0;
                         }
-                        ++rowID;
                     }
-                    rat->ValuesIO(GF_Write, (*iterFeat)->fieldIdx, startRow, rowsRemain, dataBlock);
+                    rat->ValuesIO(GF_Write, (*iterFeat)->fieldIdx, startRow, nBlockRows, dataBlock);
                 }
             }
             
-            
-            for(unsigned int i = 0; i < numRows; ++i)
-            {
-                delete[] clumpHistData[i];
-            }
-            delete[] clumpHistData;
-            
-            
+            delete clumpHists;
+            delete[] binBounds;
             delete[] dataBlock;
             delete[] histDataBlock;
             delete[] datasets;
@@ -1010,53 +927,14 @@ namespace rsgis{namespace rastergis{
             long maxClumpID = 0;
             attUtils.getImageBandMinMax(inputClumps, ratBand, &minClumpID, &maxClumpID);
             
-            if(maxClumpID > numRows)
+            if(maxClumpID >= numRows)
             {
-                numRows = boost::lexical_cast<size_t>(maxClumpID);
+                numRows = boost::lexical_cast<size_t>(maxClumpID) + 1;
                 rat->SetRowCount(numRows);
             }
             
             unsigned int modeColIdx = attUtils.findColumnIndexOrCreate(rat, outColsName, GFT_Integer);
             
-            long modeMin = 0;
-            long modeMax = 0;
-            
-            RSGISCalcImageMinMaxIntVals *calcImgValStatsMinMax = new RSGISCalcImageMinMaxIntVals(&modeMin, &modeMax, useNoDataVal, noDataVal, modeBand);
-            rsgis::img::RSGISCalcImage calcImageStatsMinMax(calcImgValStatsMinMax);
-            calcImageStatsMinMax.calcImage(&inputValsImage, 1, 0);
-            delete calcImgValStatsMinMax;
-            
-            std::cout << "Min " << modeMin << std::endl;
-            std::cout << "Max " << modeMax << std::endl;
-            
-            unsigned int modeRange = (modeMax - modeMin) + 1;
-            
-            std::cout << "Range " << modeRange << std::endl;
-            
-            unsigned long **clumpHists = new unsigned long*[numRows];
-            for(size_t i = 0; i < numRows; ++i)
-            {
-                clumpHists[i] = new unsigned long[modeRange];
-                for(unsigned int j = 0; j < modeRange; ++j)
-                {
-                    clumpHists[i][j] = 0;
-                }
-            }
-            long *modeBinVals = new long[modeRange];
-            for(unsigned int i = 0; i < modeRange; ++i)
-            {
-                modeBinVals[i] = modeMin + i;
-                if(i == 0)
-                {
-                    std::cout << "[" << modeBinVals[i];
-                }
-                else
-                {
-                    std::cout << ", " << modeBinVals[i];
-                }
-            }
-            std::cout << "]\n";
-            
             GDALDataset **datasets = new GDALDataset*[2];
             datasets[0] = inputClumps;
             datasets[1] = inputValsImage;
@@ -1064,89 +942,71 @@ namespace rsgis{namespace rastergis{
             unsigned int ratBandIdx = ratBand-1;
             unsigned int imgBandIdx = (inputClumps->GetRasterCount()) + (modeBand-1);
             
-            
-            RSGISCalcClusterModeHistograms *calcImgValStatsHist = new RSGISCalcClusterModeHistograms(clumpHists, modeBinVals, modeRange, useNoDataVal, noDataVal, ratBandIdx, imgBandIdx);
+            // The histograms are sparse so the range of the image values does not
+            // need to be found before they are populated.
+            RSGISSparseClumpHistograms *clumpHists = new RSGISSparseClumpHistograms();
+            RSGISCalcClusterModeHistograms *calcImgValStatsHist = new RSGISCalcClusterModeHistograms(clumpHists, useNoDataVal, noDataVal, ratBandIdx, imgBandIdx);
             rsgis::img::RSGISCalcImage calcImageStatsHist(calcImgValStatsHist);
             calcImageStatsHist.calcImage(datasets, 2, 0);
             delete calcImgValStatsHist;
             delete[] datasets;
-            
+            clumpHists->finalise();
+            
+            /*
+             * For each clump find the most frequent value and the next most frequent
+             * value (which is used if the mode is the no data value and that is not to
+             * be outputted). Ties are given to the smallest value. Clumps without any
+             * values are given the no data value.
+             */
             int *outVal = new int[numRows];
-            long maxCount = 0;
-            int maxCat = 0;
-            long maxCountSec = 0;
-            int maxCatSec = 0;
+            size_t numEntries = clumpHists->getNumEntries();
+            size_t entryIdx = 0;
+            unsigned long maxCount = 0;
+            long maxCat = 0;
+            unsigned long maxCountSec = 0;
+            long maxCatSec = 0;
             for(size_t i = 0; i < numRows; ++i)
             {
-                for(unsigned int j = 0; j < modeRange; ++j)
+                while((entryIdx < numEntries) && (clumpHists->getClump(entryIdx) < i))
                 {
-                    if(j == 0)
-                    {
-                        maxCount = clumpHists[i][j];
-                        maxCat = modeBinVals[j];
-                        maxCountSec = 0;
-                        maxCatSec = 0;
-                    }
-                    else if(clumpHists[i][j] > maxCount)
+                    ++entryIdx;
+                }
+                maxCount = 0;
+                maxCat = noDataVal;
+                maxCountSec = 0;
+                maxCatSec = noDataVal;
+                for(; (entryIdx < numEntries) && (clumpHists->getClump(entryIdx) == i); ++entryIdx)
+                {
+                    unsigned long count = clumpHists->getCount(entryIdx);
+                    long val = ((long)clumpHists->getBin(entryIdx)) + ((long)std::numeric_limits<int>::min());
+                    if(count > maxCount)
                     {
                         maxCountSec = maxCount;
                         maxCatSec = maxCat;
-                        
-                        maxCount = clumpHists[i][j];
-                        maxCat = modeBinVals[j];
+                        maxCount = count;
+                        maxCat = val;
                     }
-                    else if(j == 1)
+                    else if(count > maxCountSec)
                     {
-                        maxCountSec = clumpHists[i][j];
-                        maxCatSec = modeBinVals[j];
-                    }
-                    else if(clumpHists[i][j] > maxCountSec)
-                    {
-                        maxCountSec = clumpHists[i][j];
-                        maxCatSec = modeBinVals[j];
+                        maxCountSec = count;
+                        maxCatSec = val;
                     }
                 }
                 
-                if(!useNoDataVal)
+                if((!useNoDataVal) && (!outNoDataVal) && (maxCat == noDataVal) && (maxCountSec > 0))
                 {
-                    if(!outNoDataVal)
-                    {
-                        if(maxCat != noDataVal)
-                        {
-                            outVal[i] = maxCat;
-                        }
-                        else if((maxCat == noDataVal) & (maxCountSec > 0))
-                        {
-                            outVal[i] = maxCatSec;
-                        }
-                        else
-                        {
-                            outVal[i] = noDataVal;
-                        }
-                    }
-                    else
-                    {
-                        outVal[i] = maxCat;
-                    }
+                    outVal[i] = maxCatSec;
                 }
                 else
                 {
                     outVal[i] = maxCat;
                 }
             }
-            
-            
-            
+            delete clumpHists;
             
             std::cout << "Writing Stats to RAT\n";
             rat->ValuesIO(GF_Write, modeColIdx, 0, numRows, outVal);
             
-            
-            for(size_t i = 0; i < numRows; ++i)
-            {
-                delete[] clumpHists[i];;
-            }
-            delete[] clumpHists;
             delete[] outVal;
         }
         catch(RSGISAttributeTableException &e)
@@ -1240,163 +1100,111 @@ namespace rsgis{namespace rastergis{
         }
     }
     
-    RSGISPopRATWithStats::~RSGISPopRATWithStats()
+    double RSGISPopRATWithStats::calcSparseHistPercentile(float percentile, double *binBounds, double binWidth, RSGISSparseClumpHistograms *clumpHists, size_t startIdx, size_t endIdx)
     {
+        // Matches RSGISMathsUtils::calcPercentile for a dense histogram; the value
+        // returned is the centre of the bin, so is within binWidth/2 of the percentile.
+        size_t numVals = 0;
+        for(size_t i = startIdx; i < endIdx; ++i)
+        {
+            numVals += clumpHists->getCount(i);
+        }
         
-    }
-    
-    
-    RSGISCalcClusterPxlValueStats::RSGISCalcClusterPxlValueStats(double **statsData, std::vector<rsgis::rastergis::RSGISBandAttStats*> *bandStats, bool *firstVal, unsigned int ratBand, double *no_data_vals, bool *use_no_data_vals) : rsgis::img::RSGISCalcImageValue(0)
-    {
-        this->statsData = statsData;
-        this->bandStats = bandStats;
-        this->firstVal = firstVal;
-        this->ratBand = ratBand;
-        this->no_data_vals = no_data_vals;
-        this->use_no_data_vals = use_no_data_vals;
-    }
-    
-    void RSGISCalcClusterPxlValueStats::calcImageValue(long *intBandValues, unsigned int numIntVals, float *floatBandValues, unsigned int numfloatVals) 
-    {
-        if(intBandValues[ratBand-1] > 0)
+        size_t percentileValCount = floor(((double)numVals) * (percentile / 100));
+        if(percentileValCount == 0)
         {
-            unsigned long fid = intBandValues[ratBand-1];
-
-            for(std::vector<rsgis::rastergis::RSGISBandAttStats*>::iterator iterBands = bandStats->begin(); iterBands != bandStats->end(); ++iterBands)
-            {
-                if((boost::math::isfinite)(floatBandValues[(*iterBands)->band-1]))
-                {
-                    bool useVal = true;
-                    if(this->use_no_data_vals[(*iterBands)->band-1] && (this->no_data_vals[(*iterBands)->band-1] == floatBandValues[(*iterBands)->band-1]))
-                    {
-                        useVal = false;
-                    }
-                    if(useVal)
-                    {
-                        if((*iterBands)->calcMin)
-                        {
-                            if(firstVal[fid])
-                            {
-                                statsData[fid][(*iterBands)->minLocalIdx] = floatBandValues[(*iterBands)->band-1];
-                            }
-                            else if(floatBandValues[(*iterBands)->band-1] < statsData[fid][(*iterBands)->minLocalIdx])
-                            {
-                                statsData[fid][(*iterBands)->minLocalIdx] = floatBandValues[(*iterBands)->band-1];
-                            }
-                        }
-
-                        if((*iterBands)->calcMax)
-                        {
-                            if(firstVal[fid])
-                            {
-                                statsData[fid][(*iterBands)->maxLocalIdx] = floatBandValues[(*iterBands)->band-1];
-                            }
-                            else if(floatBandValues[(*iterBands)->band-1] > statsData[fid][(*iterBands)->maxLocalIdx])
-                            {
-                                statsData[fid][(*iterBands)->maxLocalIdx] = floatBandValues[(*iterBands)->band-1];
-                            }
-                        }
-
-                        if((*iterBands)->calcMean)
-                        {
-                            if(firstVal[fid])
-                            {
-                                statsData[fid][(*iterBands)->meanLocalIdx] = floatBandValues[(*iterBands)->band-1];
-                            }
-                            else
-                            {
-                                statsData[fid][(*iterBands)->meanLocalIdx] += floatBandValues[(*iterBands)->band-1];
-                            }
-                        }
-
-                        if((*iterBands)->calcSum)
-                        {
-                            if(firstVal[fid])
-                            {
-                                statsData[fid][(*iterBands)->sumLocalIdx] = floatBandValues[(*iterBands)->band-1];
-                            }
-                            else
-                            {
-                                statsData[fid][(*iterBands)->sumLocalIdx] += floatBandValues[(*iterBands)->band-1];
-                            }
-                        }
-                    }
-                }
-            }
-            
-            if(firstVal[fid])
+            return binBounds[0] + binWidth/2;
+        }
+        
+        size_t valCount = 0;
+        for(size_t i = startIdx; i < endIdx; ++i)
+        {
+            valCount += clumpHists->getCount(i);
+            if(valCount >= percentileValCount)
             {
-                firstVal[fid] = false;
+                return binBounds[clumpHists->getBin(i)] + binWidth/2;
             }
         }
+        throw rsgis::RSGISAttributeTableException("Could not find percentile bin.");
     }
     
-    RSGISCalcClusterPxlValueStats::~RSGISCalcClusterPxlValueStats()
+    RSGISPopRATWithStats::~RSGISPopRATWithStats()
     {
         
     }
     
-    RSGISCalcClusterPxlValueStdDev::RSGISCalcClusterPxlValueStdDev(double **stdDevData, double **statsData, std::vector<rsgis::rastergis::RSGISBandAttStats*> *bandStats, bool *firstVal, unsigned int ratBand, double *no_data_vals, bool *use_no_data_vals) : rsgis::img::RSGISCalcImageValue(0)
+    
+    RSGISSparseClumpHistograms::RSGISSparseClumpHistograms(size_t minBufferSize)
     {
-        this->stdDevData = stdDevData;
-        this->statsData = statsData;
-        this->bandStats = bandStats;
-        this->firstVal = firstVal;
-        this->ratBand = ratBand;
-        this->no_data_vals = no_data_vals;
-        this->use_no_data_vals = use_no_data_vals;
+        this->minBufferSize = minBufferSize;
+        this->buffer.reserve(minBufferSize);
     }
     
-    void RSGISCalcClusterPxlValueStdDev::calcImageValue(long *intBandValues, unsigned int numIntVals, float *floatBandValues, unsigned int numfloatVals) 
+    void RSGISSparseClumpHistograms::mergeBuffer()
     {
-        if(intBandValues[ratBand-1] > 0)
+        if(this->buffer.empty())
         {
-            unsigned long fid = intBandValues[ratBand-1];
-            for(std::vector<rsgis::rastergis::RSGISBandAttStats*>::iterator iterBands = bandStats->begin(); iterBands != bandStats->end(); ++iterBands)
+            return;
+        }
+        std::sort(this->buffer.begin(), this->buffer.end());
+        
+        // Merge the sorted buffer (as runs of equal keys) with the existing keys.
+        // The merged arrays are held alongside the existing keys and the buffer
+        // until the swap, which is the peak memory use (see the class docs).
+        std::vector<unsigned long long> mergedKeys;
+        std::vector<unsigned int> mergedCounts;
+        mergedKeys.reserve(this->keys.size() + this->buffer.size());
+        mergedCounts.reserve(this->keys.size() + this->buffer.size());
+        size_t i = 0;
+        size_t j = 0;
+        size_t numKeys = this->keys.size();
+        size_t numBuf = this->buffer.size();
+        while((i < numKeys) || (j < numBuf))
+        {
+            if((j == numBuf) || ((i < numKeys) && (this->keys[i] < this->buffer[j])))
             {
-                if((boost::math::isfinite)(floatBandValues[(*iterBands)->band-1]))
-                {
-                    bool useVal = true;
-                    if(this->use_no_data_vals[(*iterBands)->band-1] && (this->no_data_vals[(*iterBands)->band-1] == floatBandValues[(*iterBands)->band-1]))
-                    {
-                        useVal = false;
-                    }
-                    if(useVal)
-                    {
-                        if((*iterBands)->calcStdDev)
-                        {
-                            double stdDevComp = pow(((double)(floatBandValues[(*iterBands)->band-1] - statsData[fid][(*iterBands)->meanLocalIdx])), 2.0);
-                            if(firstVal[fid])
-                            {
-                                stdDevData[fid][(*iterBands)->stdDevLocalIdx] = stdDevComp;
-                            }
-                            else
-                            {
-                                stdDevData[fid][(*iterBands)->stdDevLocalIdx] += stdDevComp;
-                            }
-                        }
-                    }
-                }
+                mergedKeys.push_back(this->keys[i]);
+                mergedCounts.push_back(this->counts[i]);
+                ++i;
             }
-            
-            if(firstVal[fid])
+            else
             {
-                firstVal[fid] = false;
+                unsigned long long key = this->buffer[j];
+                unsigned int count = 0;
+                if((i < numKeys) && (this->keys[i] == key))
+                {
+                    count = this->counts[i];
+                    ++i;
+                }
+                for(; (j < numBuf) && (this->buffer[j] == key); ++j)
+                {
+                    ++count;
+                }
+                mergedKeys.push_back(key);
+                mergedCounts.push_back(count);
             }
         }
+        this->keys.swap(mergedKeys);
+        this->counts.swap(mergedCounts);
+        this->buffer.clear();
     }
     
-    RSGISCalcClusterPxlValueStdDev::~RSGISCalcClusterPxlValueStdDev()
+    void RSGISSparseClumpHistograms::finalise()
     {
-        
+        this->mergeBuffer();
+        std::vector<unsigned long long>().swap(this->buffer);
+        this->keys.shrink_to_fit();
+        this->counts.shrink_to_fit();
     }
     
+    RSGISSparseClumpHistograms::~RSGISSparseClumpHistograms()
+    {
+        
+    }
     
-    
-    
-    RSGISCalcClusterPxlValueHistograms::RSGISCalcClusterPxlValueHistograms(unsigned int **clumpHistData, double *binBounds, unsigned int numBins, unsigned int ratBand, unsigned int imgBand, double noDataVal, bool useNoDataVal): rsgis::img::RSGISCalcImageValue(0)
+    RSGISCalcClusterPxlValueHistograms::RSGISCalcClusterPxlValueHistograms(RSGISSparseClumpHistograms *clumpHists, double *binBounds, unsigned int numBins, unsigned int ratBand, unsigned int imgBand, double noDataVal, bool useNoDataVal): rsgis::img::RSGISCalcImageValue(0)
     {
-        this->clumpHistData = clumpHistData;
+        this->clumpHists = clumpHists;
         this->binBounds = binBounds;
         this->numBins = numBins;
         this->ratBand = ratBand;
@@ -1420,24 +1228,10 @@ namespace rsgis{namespace rastergis{
                 
                 if(useVal)
                 {
-                    unsigned int binIdx = 0;
-                    bool foundBinIdx = false;
-                    for(unsigned int i = 0; i < numBins; ++i)
-                    {
-                        if((floatBandValues[imgBand-1] >= binBounds[i]) & (floatBandValues[imgBand-1] < binBounds[i+1]))
-                        {
-                            binIdx = i;
-                            foundBinIdx = true;
-                            break;
-                        }
-                        else if((i==numBins-1) & ((floatBandValues[imgBand-1] >= binBounds[i])))
-                        {
-                            binIdx = i;
-                            foundBinIdx = true;
-                            break;
-                        }
-                    }
-                    if(!foundBinIdx)
+                    // Bin i covers [binBounds[i], binBounds[i+1]) apart from the last bin,
+                    // which takes any value >= its lower bound.
+                    double *binUpper = std::upper_bound(binBounds, binBounds+numBins, (double)floatBandValues[imgBand-1]);
+                    if(binUpper == binBounds)
                     {
                         std::cout << std::endl;
                         for(unsigned int i = 0; i < numBins; ++i)
@@ -1449,7 +1243,7 @@ namespace rsgis{namespace rastergis{
                         throw rsgis::img::RSGISImageCalcException("The image pixel value was not found within the histogram range specified - either too big or too small.");
                     }
                     
-                    ++clumpHistData[fid][binIdx];
+                    clumpHists->addValue(fid, (binUpper - binBounds) - 1);
                 }
             }
         }
@@ -1657,11 +1451,9 @@ namespace rsgis{namespace rastergis{
     }
     
     
-    RSGISCalcClusterModeHistograms::RSGISCalcClusterModeHistograms(unsigned long **clumpHists, long *modeBinVals, unsigned int numBins, bool useNoDataVal, long noDataVal, unsigned int ratBandIdx, unsigned int imgBandIdx): rsgis::img::RSGISCalcImageValue(0)
+    RSGISCalcClusterModeHistograms::RSGISCalcClusterModeHistograms(RSGISSparseClumpHistograms *clumpHists, bool useNoDataVal, long noDataVal, unsigned int ratBandIdx, unsigned int imgBandIdx): rsgis::img::RSGISCalcImageValue(0)
     {
         this->clumpHists = clumpHists;
-        this->modeBinVals = modeBinVals;
-        this->numBins = numBins;
         this->ratBandIdx = ratBandIdx;
         this->imgBandIdx = imgBandIdx;
         this->useNoDataVal = useNoDataVal;
@@ -1672,7 +1464,7 @@ namespace rsgis{namespace rastergis{
     {
         if(numIntVals == 0)
         {
-            throw rsgis::img::RSGISImageCalcException("RSGISCalcImageMinMaxIntVals only calcs for int vals, there are none.");
+            throw rsgis::img::RSGISImageCalcException("RSGISCalcClusterModeHistograms only calcs for int vals, there are none.");
         }
         if(intBandValues[ratBandIdx] > 0)
         {
@@ -1684,21 +1476,12 @@ namespace rsgis{namespace rastergis{
             }
             else
             {
-                bool found = false;
-                for(unsigned int i = 0; i < numBins; ++i)
-                {
-                    if(imgVal == modeBinVals[i])
-                    {
-                        ++clumpHists[fid][i];
-                        found = true;
-                        break;
-                    }
-                }
-                if(!found)
+                if((imgVal < std::numeric_limits<int>::min()) || (imgVal > std::numeric_limits<int>::max()))
                 {
                     std::cout << "Image Value = " << imgVal << std::endl;
-                    throw rsgis::img::RSGISImageCalcException("Image value was not within the range of the mode histogram.");
+                    throw rsgis::img::RSGISImageCalcException("Image value is outside of the 32 bit integer range supported by the mode histogram.");
                 }
+                clumpHists->addValue(fid, (unsigned int)(imgVal - ((long)std::numeric_limits<int>::min())));
             }
         }
     }
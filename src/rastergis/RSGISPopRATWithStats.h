@@ -26,17 +26,23 @@
 #include <string>
 #include <vector>
 #include <cmath>
+#include <algorithm>
+#include <limits>
+#include <thread>
+#include <exception>
 
 #include "gdal_priv.h"
 #include "gdal_rat.h"
 
 #include "common/RSGISAttributeTableException.h"
+#include "common/rsgis-tqdm.h"
 
 #include "math/RSGISMathsUtils.h"
 
 #include "rastergis/RSGISRasterAttUtils.h"
 
 #include "img/RSGISImageCalcException.h"
+#include "img/RSGISImageUtils.h"
 #include "img/RSGISCalcImageValue.h"
 #include "img/RSGISCalcImage.h"
 
@@ -116,58 +122,152 @@ namespace rsgis{namespace rastergis{
         unsigned int fieldIdx;
     };
     
+    /**
+     * Per clump accumulators for the basic statistics, stored as a struct of
+     * arrays indexed by (clump ID * numBands) + band. The sum of squared
+     * differences from the mean is updated with Welford's algorithm so the
+     * standard deviation is calculated in the same pass as the other
+     * statistics, and partial accumulators (e.g., one per thread) are
+     * combined with Chan et al.'s pairwise update.
+     */
+    struct DllExport RSGISClumpStatsAccum
+    {
+        size_t numClumps;
+        unsigned int numBands;
+        std::vector<unsigned long> count;
+        std::vector<float> minVal;
+        std::vector<float> maxVal;
+        std::vector<double> sum;
+        std::vector<double> sumSqDiff;
+        
+        void init(size_t numClumps, unsigned int numBands)
+        {
+            this->numClumps = numClumps;
+            this->numBands = numBands;
+            size_t numVals = numClumps * numBands;
+            count.assign(numVals, 0);
+            minVal.assign(numVals, 0);
+            maxVal.assign(numVals, 0);
+            sum.assign(numVals, 0);
+            sumSqDiff.assign(numVals, 0);
+        };
+        
+        inline void addValue(size_t idx, float val)
+        {
+            unsigned long n = ++count[idx];
+            if(n == 1)
+            {
+                minVal[idx] = val;
+                maxVal[idx] = val;
+                sum[idx] = val;
+                sumSqDiff[idx] = 0;
+            }
+            else
+            {
+                if(val < minVal[idx])
+                {
+                    minVal[idx] = val;
+                }
+                if(val > maxVal[idx])
+                {
+                    maxVal[idx] = val;
+                }
+                double prevMean = sum[idx] / (n - 1);
+                sum[idx] += val;
+                sumSqDiff[idx] += (val - prevMean) * (val - (sum[idx] / n));
+            }
+        };
+        
+        void merge(RSGISClumpStatsAccum *other);
+        
+        void clear()
+        {
+            std::vector<unsigned long>().swap(count);
+            std::vector<float>().swap(minVal);
+            std::vector<float>().swap(maxVal);
+            std::vector<double>().swap(sum);
+            std::vector<double>().swap(sumSqDiff);
+        };
+    };
+    
+    /**
+     * Sparse per clump histograms, stored as (clump, bin) keys sorted into runs
+     * with a count for each key, so the memory required grows with the number
+     * of distinct bins observed within each clump rather than the number of
+     * clumps multiplied by the number of bins. Observations are buffered and
+     * periodically sorted and merged into the runs; the buffer is allowed to
+     * grow with the number of keys so the amortised cost per pixel is O(log n).
+     * The counts are exact.
+     *
+     * Memory: the stored keys take 12 bytes each (8 byte key and 4 byte count)
+     * and the buffer holds up to one 8 byte observation per key (and at least
+     * minBufferSize), so up to 20 bytes per key between merges. While
+     * mergeBuffer runs, the merged arrays (reserved for the keys plus the
+     * buffer) are held alongside the existing keys and the buffer, so the peak
+     * is about twice that: up to ~44 bytes per distinct (clump, bin) key with
+     * a full buffer. finalise releases the buffer, leaving 12 bytes per key.
+     */
+    class DllExport RSGISSparseClumpHistograms
+    {
+    public:
+        RSGISSparseClumpHistograms(size_t minBufferSize=1048576);
+        inline void addValue(size_t fid, unsigned int bin)
+        {
+            if(fid > 0xFFFFFFFF)
+            {
+                throw rsgis::RSGISAttributeTableException("Clump ID is too large for the sparse histograms (must fit in 32 bits).");
+            }
+            this->buffer.push_back((((unsigned long long)fid) << 32) | bin);
+            if(this->buffer.size() >= std::max(this->minBufferSize, this->keys.size()))
+            {
+                this->mergeBuffer();
+            }
+        };
+        /** Merge any buffered observations; must be called before reading the histograms. */
+        void finalise();
+        size_t getNumEntries(){return this->keys.size();};
+        size_t getClump(size_t i){return (size_t)(this->keys[i] >> 32);};
+        unsigned int getBin(size_t i){return (unsigned int)(this->keys[i] & 0xFFFFFFFF);};
+        unsigned int getCount(size_t i){return this->counts[i];};
+        ~RSGISSparseClumpHistograms();
+    protected:
+        void mergeBuffer();
+        size_t minBufferSize;
+        std::vector<unsigned long long> buffer;
+        std::vector<unsigned long long> keys;
+        std::vector<unsigned int> counts;
+    };
+    
     class DllExport RSGISPopRATWithStats
     {
     public:
         RSGISPopRATWithStats();
-        void populateRATWithBasicStats(GDALDataset *inputClumps, GDALDataset *inputValsImage, std::vector<RSGISBandAttStats*> *bandStats, unsigned int ratBand);
+        /**
+         * Populate the RAT with the min, max, mean, standard deviation and sum of the
+         * pixel values within each clump, in a single pass of the image. If numThreads
+         * is greater than 1, strips of rows are processed concurrently, each thread
+         * accumulating into its own copy of the per clump statistics (~32 bytes per
+         * clump per band) which are merged at the end.
+         */
+        void populateRATWithBasicStats(GDALDataset *inputClumps, GDALDataset *inputValsImage, std::vector<RSGISBandAttStats*> *bandStats, unsigned int ratBand, unsigned int numThreads=1);
         void populateRATWithPercentileStats(GDALDataset *inputClumps, GDALDataset *inputValsImage, unsigned int band, std::vector<RSGISBandAttPercentiles*> *bandStats, unsigned int ratBand, unsigned int numHistBins);
         void populateRATWithMeanLitStats(GDALDataset *inputClumps, GDALDataset *inputValsImage, GDALDataset *inputMeanLitImage, unsigned int meanLitBand, std::string meanLitCol, std::string pxlCountCol, std::vector<RSGISBandAttStats*> *bandStats, unsigned int ratBand);
         void populateRATWithModeStats(GDALDataset *inputClumps, GDALDataset *inputValsImage, std::string outColsName, bool useNoDataVal, long noDataVal, bool outNoDataVal, unsigned int modeBand, unsigned int ratBand);
         void populateRATWithPopValidPixels(GDALDataset *inputClumps, GDALDataset *inputValsImage, std::string outColsName, double noDataVal, unsigned int ratBand);
         ~RSGISPopRATWithStats();
+    protected:
+        double calcSparseHistPercentile(float percentile, double *binBounds, double binWidth, RSGISSparseClumpHistograms *clumpHists, size_t startIdx, size_t endIdx);
+        void accumClumpStatsRows(unsigned int *clumpVals, float *bandVals, size_t numPxls, size_t bandStride, double *noDataVals, bool *useNoDataVals, RSGISClumpStatsAccum *accum);
     };
     
-    class DllExport RSGISCalcClusterPxlValueStats : public rsgis::img::RSGISCalcImageValue
-	{
-	public:
-		RSGISCalcClusterPxlValueStats(double **statsData, std::vector<rsgis::rastergis::RSGISBandAttStats*> *bandStats, bool *firstVal, unsigned int ratBand, double *no_data_vals, bool *use_no_data_vals);
-        void calcImageValue(long *intBandValues, unsigned int numIntVals, float *floatBandValues, unsigned int numfloatVals);
-		~RSGISCalcClusterPxlValueStats();
-    private:
-        double **statsData;
-        std::vector<rsgis::rastergis::RSGISBandAttStats*> *bandStats;
-        bool *firstVal;
-        unsigned int ratBand;
-        double *no_data_vals;
-        bool *use_no_data_vals;
-    };
-    
-    class DllExport RSGISCalcClusterPxlValueStdDev : public rsgis::img::RSGISCalcImageValue
-	{
-	public:
-		RSGISCalcClusterPxlValueStdDev(double **stdDevData, double **statsData, std::vector<rsgis::rastergis::RSGISBandAttStats*> *bandStats, bool *firstVal, unsigned int ratBand, double *no_data_vals, bool *use_no_data_vals);
-        void calcImageValue(long *intBandValues, unsigned int numIntVals, float *floatBandValues, unsigned int numfloatVals);
-		~RSGISCalcClusterPxlValueStdDev();
-    private:
-        double **stdDevData;
-        double **statsData;
-        std::vector<rsgis::rastergis::RSGISBandAttStats*> *bandStats;
-        bool *firstVal;
-        unsigned int ratBand;
-        double *no_data_vals;
-        bool *use_no_data_vals;
-	};
-    
-    
     class DllExport RSGISCalcClusterPxlValueHistograms : public rsgis::img::RSGISCalcImageValue
 	{
 	public:
-		RSGISCalcClusterPxlValueHistograms(unsigned int **clumpHistData, double *binBounds, unsigned int numBins, unsigned int ratBand, unsigned int imgBand, double noDataVal, bool useNoDataVal);
+		RSGISCalcClusterPxlValueHistograms(RSGISSparseClumpHistograms *clumpHists, double *binBounds, unsigned int numBins, unsigned int ratBand, unsigned int imgBand, double noDataVal, bool useNoDataVal);
         void calcImageValue(long *intBandValues, unsigned int numIntVals, float *floatBandValues, unsigned int numfloatVals);
 		~RSGISCalcClusterPxlValueHistograms();
     private:
-        unsigned int **clumpHistData;
+        RSGISSparseClumpHistograms *clumpHists;
         double *binBounds;
         unsigned int numBins;
         unsigned int ratBand;
@@ -230,13 +330,15 @@ namespace rsgis{namespace rastergis{
     class DllExport RSGISCalcClusterModeHistograms : public rsgis::img::RSGISCalcImageValue
     {
     public:
-        RSGISCalcClusterModeHistograms(unsigned long **clumpHists, long *modeBinVals, unsigned int numBins, bool useNoDataVal, long noDataVal, unsigned int ratBandIdx, unsigned int imgBandIdx);
+        /**
+         * The histogram bins are the pixel values offset by 2^31 (i.e., the values
+         * must be 32 bit integers) so the bin order matches the value order.
+         */
+        RSGISCalcClusterModeHistograms(RSGISSparseClumpHistograms *clumpHists, bool useNoDataVal, long noDataVal, unsigned int ratBandIdx, unsigned int imgBandIdx);
         void calcImageValue(long *intBandValues, unsigned int numIntVals, float *floatBandValues, unsigned int numfloatVals);
         ~RSGISCalcClusterModeHistograms();
     private:
-        unsigned long **clumpHists;
-        long *modeBinVals;
-        unsigned int numBins;
+        RSGISSparseClumpHistograms *clumpHists;
         unsigned int ratBandIdx;
         unsigned int imgBandIdx;
         bool useNoDataVal;
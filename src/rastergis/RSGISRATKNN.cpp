@@ -29,7 +29,7 @@ namespace rsgis{namespace rastergis{
         
     }
     
-    void RSGISApplyRATKNN::applyKNNExtrapolation(GDALDataset *clumpsDS, std::string inExtrapField, std::string outExtrapField, std::string trainRegionsField, std::string applyRegionsField, bool useApplyField, std::vector<std::string> fields, unsigned int kFeatures, rsgis::math::rsgisdistmetrics distKNN, float distThreshold, rsgis::math::rsgissummarytype summeriseKNN, unsigned int ratBand)
+    void RSGISApplyRATKNN::applyKNNExtrapolation(GDALDataset *clumpsDS, std::string inExtrapField, std::string outExtrapField, std::string trainRegionsField, std::string applyRegionsField, bool useApplyField, std::vector<std::string> fields, unsigned int kFeatures, rsgis::math::rsgisdistmetrics distKNN, float distThreshold, rsgis::math::rsgissummarytype summeriseKNN, unsigned int ratBand, unsigned int numThreads)
     {
         try
         {
@@ -136,16 +136,49 @@ namespace rsgis{namespace rastergis{
                 throw RSGISAttributeTableException("Summary method is not supported and/or known.");
             }
             
+            // The kd-tree is built over the features (i.e., excluding the value to be
+            // extrapolated) and the threshold converted to the units of its norm.
+            size_t numFeatVals = numFloatVals - 1;
+            double threshSq = ((double)distThreshold) * distThreshold;
+            if(distThreshold <= 0)
+            {
+                threshSq = 0;
+            }
+            rsgis::math::RSGISKDTree *kdTree = NULL;
+            double kdMaxDist = 0;
+            std::vector<double> whitenMatrix;
+            std::vector<double> trainFeats;
+            if((numFeatVals > 0) && ((distKNN == rsgis::math::rsgis_euclidean) || (distKNN == rsgis::math::rsgis_manhatten) || (distKNN == rsgis::math::rsgis_mahalanobis)))
+            {
+                trainFeats.resize(numTrainFeats * numFeatVals);
+                for(size_t i = 0; i < numTrainFeats; ++i)
+                {
+                    std::copy(&trainData[i][1], &trainData[i][1] + numFeatVals, &trainFeats[i * numFeatVals]);
+                }
+            }
+            
             rsgis::math::RSGISCalcDistMetric *calcDist = NULL;
             if(distKNN == rsgis::math::rsgis_euclidean)
             {
                 calcDist = new rsgis::math::RSGISCalcEuclideanDistMetric();
                 calcDist->init();
+                if(numFeatVals > 0)
+                {
+                    // sqrt(sum(d^2)/n) < t  <=>  sum(d^2) < t^2 n
+                    kdTree = new rsgis::math::RSGISKDTree(trainFeats.data(), numTrainFeats, numFeatVals, rsgis::math::rsgis_kdtree_l2sq);
+                    kdMaxDist = threshSq * numFeatVals;
+                }
             }
             else if(distKNN == rsgis::math::rsgis_manhatten)
             {
                 calcDist = new rsgis::math::RSGISCalcManhattenDistMetric();
                 calcDist->init();
+                if(numFeatVals > 0)
+                {
+                    // sqrt(sum(|d|)/n) < t  <=>  sum(|d|) < t^2 n
+                    kdTree = new rsgis::math::RSGISKDTree(trainFeats.data(), numTrainFeats, numFeatVals, rsgis::math::rsgis_kdtree_l1);
+                    kdMaxDist = threshSq * numFeatVals;
+                }
             }
             else if(distKNN == rsgis::math::rsgis_mahalanobis)
             {
@@ -153,6 +186,30 @@ namespace rsgis{namespace rastergis{
                 double **covarMatrix = mathUtils.calcCovarianceMatrix(trainData, meanVec, numTrainFeats, numFloatVals, 1, numFloatVals);
                 size_t numVals = numFloatVals - 1;
                 delete[] meanVec;
+                if((numVals > 0) && this->calcWhiteningMatrix(covarMatrix, numVals, &whitenMatrix))
+                {
+                    // sqrt(d' C^-1 d) = |L^-1 d| where C = L L'
+                    for(size_t i = 0; i < numTrainFeats; ++i)
+                    {
+                        double *feat = &trainFeats[i * numVals];
+                        for(size_t r = 0; r < numVals; ++r)
+                        {
+                            double val = feat[r];
+                            for(size_t c = 0; c < r; ++c)
+                            {
+                                val -= whitenMatrix[(r * numVals) + c] * feat[c];
+                            }
+                            feat[r] = val / whitenMatrix[(r * numVals) + r];
+                        }
+                    }
+                    kdTree = new rsgis::math::RSGISKDTree(trainFeats.data(), numTrainFeats, numVals, rsgis::math::rsgis_kdtree_l2sq);
+                    kdMaxDist = threshSq;
+                }
+                else
+                {
+                    std::cout << "The covariance matrix is not positive definite so a brute force search will be used.\n";
+                    whitenMatrix.clear();
+                }
                 calcDist = new rsgis::math::RSGISCalcMahalanobisDistMetric(covarMatrix, numVals);
                 calcDist->init();
             }
@@ -174,15 +231,38 @@ namespace rsgis{namespace rastergis{
                 
             // Perform KNN
             std::cout << "Perform KNN\n";
-            inIntColIdx.clear();
-            if(useApplyField)
+            std::vector<double>().swap(trainFeats);
+            if((kdTree == NULL) || (numThreads < 1))
             {
-                inIntColIdx.push_back(applyRegFieldIdx);
+                // The distance metrics are not thread safe.
+                numThreads = 1;
+            }
+            std::vector<rsgis::math::RSGISStatsSummary> threadSumStats(numThreads, *mathSumStats);
+            std::vector<RSGISPerformKNNCalcValues*> threadKNN;
+            for(unsigned int t = 0; t < numThreads; ++t)
+            {
+                threadKNN.push_back(new RSGISPerformKNNCalcValues(trainData, numTrainFeats, numFloatVals, kFeatures, calcDist, distThreshold, &threadSumStats[t]));
+                if(kdTree != NULL)
+                {
+                    threadKNN.back()->setKDTree(kdTree, kdMaxDist, (whitenMatrix.empty()?NULL:whitenMatrix.data()));
+                }
+            }
+            try
+            {
+                this->performKNNBlocks(gdalAtt, inRealColIdx, useApplyField, applyRegFieldIdx, outExtrapFieldIdx, &threadKNN);
+            }
+            catch(RSGISException &e)
+            {
+                for(unsigned int t = 0; t < numThreads; ++t)
+                {
+                    delete threadKNN[t];
+                }
+                throw;
+            }
+            for(unsigned int t = 0; t < numThreads; ++t)
+            {
+                delete threadKNN[t];
             }
-            outRealColIdx.push_back(outExtrapFieldIdx);
-            RSGISPerformKNNCalcValues performKNN = RSGISPerformKNNCalcValues(trainData, numTrainFeats, numFloatVals, kFeatures, calcDist, distThreshold, mathSumStats);
-            ratCalc = RSGISRATCalc(&performKNN);
-            ratCalc.calcRATValues(gdalAtt, inRealColIdx, inIntColIdx, inStrColIdx, outRealColIdx, outIntColIdx, outStrColIdx);
             
             // Deallocate memory
             for(size_t i = 0; i < numTrainFeats; ++i)
@@ -192,6 +272,10 @@ namespace rsgis{namespace rastergis{
             delete[]trainData;
             delete mathSumStats;
             delete calcDist;
+            if(kdTree != NULL)
+            {
+                delete kdTree;
+            }
         }
         catch (RSGISAttributeTableException &e)
         {
@@ -207,6 +291,119 @@ namespace rsgis{namespace rastergis{
         }
     }
     
+    bool RSGISApplyRATKNN::calcWhiteningMatrix(double **covarMatrix, size_t n, std::vector<double> *whitenMatrix)
+    {
+        // Cholesky decomposition of the covariance matrix (C = L L'), with L stored
+        // row-major in whitenMatrix. Returns false if C is not positive definite.
+        whitenMatrix->assign(n * n, 0.0);
+        double *L = whitenMatrix->data();
+        for(size_t r = 0; r < n; ++r)
+        {
+            for(size_t c = 0; c <= r; ++c)
+            {
+                double sum = covarMatrix[r][c];
+                for(size_t k = 0; k < c; ++k)
+                {
+                    sum -= L[(r * n) + k] * L[(c * n) + k];
+                }
+                if(r == c)
+                {
+                    if(!(sum > 0) || !std::isfinite(sum))
+                    {
+                        return false;
+                    }
+                    L[(r * n) + r] = sqrt(sum);
+                }
+                else
+                {
+                    L[(r * n) + c] = sum / L[(c * n) + c];
+                }
+            }
+        }
+        return true;
+    }
+    
+    void RSGISApplyRATKNN::performKNNBlocks(GDALRasterAttributeTable *gdalAtt, std::vector<unsigned int> inRealColIdx, bool useApplyField, unsigned int applyRegFieldIdx, unsigned int outExtrapFieldIdx, std::vector<RSGISPerformKNNCalcValues*> *threadKNN)
+    {
+        size_t numRows = gdalAtt->GetRowCount();
+        unsigned int numInRealCols = inRealColIdx.size();
+        unsigned int numThreads = threadKNN->size();
+        
+        std::vector<double> inRealBlock(((size_t)numInRealCols) * RAT_BLOCK_LENGTH);
+        std::vector<int> applyBlock(RAT_BLOCK_LENGTH, 1);
+        std::vector<double> outBlock(RAT_BLOCK_LENGTH);
+        std::vector<std::exception_ptr> threadErrors(numThreads);
+        std::vector<std::thread> threads;
+        
+        rsgis_tqdm pbar;
+        for(size_t startRow = 0; startRow < numRows; startRow += RAT_BLOCK_LENGTH)
+        {
+            pbar.progress(startRow, numRows);
+            size_t nBlockRows = std::min((size_t)RAT_BLOCK_LENGTH, numRows-startRow);
+            for(unsigned int c = 0; c < numInRealCols; ++c)
+            {
+                gdalAtt->ValuesIO(GF_Read, inRealColIdx[c], startRow, nBlockRows, &inRealBlock[c * RAT_BLOCK_LENGTH]);
+            }
+            if(useApplyField)
+            {
+                gdalAtt->ValuesIO(GF_Read, applyRegFieldIdx, startRow, nBlockRows, applyBlock.data());
+            }
+            
+            // Each thread processes a contiguous range of rows within the block.
+            size_t rowsPerThread = ((nBlockRows - 1) / numThreads) + 1;
+            auto processRows = [&](unsigned int t)
+            {
+                try
+                {
+                    std::vector<double> inRealCols(numInRealCols);
+                    double outVal = 0;
+                    size_t sRow = t * rowsPerThread;
+                    size_t eRow = std::min(sRow + rowsPerThread, nBlockRows);
+                    for(size_t j = sRow; j < eRow; ++j)
+                    {
+                        for(unsigned int c = 0; c < numInRealCols; ++c)
+                        {
+                            inRealCols[c] = inRealBlock[(c * RAT_BLOCK_LENGTH) + j];
+                        }
+                        threadKNN->at(t)->calcRATValue(startRow+j, inRealCols.data(), numInRealCols, &applyBlock[j], (useApplyField?1:0), NULL, 0, &outVal, 1, NULL, 0, NULL, 0);
+                        outBlock[j] = outVal;
+                    }
+                }
+                catch(...)
+                {
+                    threadErrors[t] = std::current_exception();
+                }
+            };
+            
+            if(numThreads == 1)
+            {
+                processRows(0);
+            }
+            else
+            {
+                threads.clear();
+                for(unsigned int t = 0; t < numThreads; ++t)
+                {
+                    threads.push_back(std::thread(processRows, t));
+                }
+                for(std::vector<std::thread>::iterator iterThreads = threads.begin(); iterThreads != threads.end(); ++iterThreads)
+                {
+                    (*iterThreads).join();
+                }
+            }
+            for(unsigned int t = 0; t < numThreads; ++t)
+            {
+                if(threadErrors[t])
+                {
+                    std::rethrow_exception(threadErrors[t]);
+                }
+            }
+            
+            gdalAtt->ValuesIO(GF_Write, outExtrapFieldIdx, startRow, nBlockRows, outBlock.data());
+        }
+        pbar.finish();
+    }
+    
     RSGISApplyRATKNN::~RSGISApplyRATKNN()
     {
         
@@ -292,6 +489,21 @@ namespace rsgis{namespace rastergis{
         this->calcDist = calcDist;
         this->distThreshold = distThreshold;
         this->mathSumStats = mathSumStats;
+        this->kdTree = NULL;
+        this->kdMaxDist = 0;
+        this->whitenMatrix = NULL;
+    }
+    
+    void RSGISPerformKNNCalcValues::setKDTree(const rsgis::math::RSGISKDTree *kdTree, double kdMaxDist, const double *whitenMatrix)
+    {
+        if((kdTree != NULL) && ((kdTree->getNumDims() != (this->m - 1)) || (kdTree->getNumPts() != this->n)))
+        {
+            throw RSGISAttributeTableException("The kd-tree does not match the training data.");
+        }
+        this->kdTree = kdTree;
+        this->kdMaxDist = kdMaxDist;
+        this->whitenMatrix = whitenMatrix;
+        this->queryVals.resize(this->m - 1);
     }
     
     void RSGISPerformKNNCalcValues::calcRATValue(size_t fid, double *inRealCols, unsigned int numInRealCols, int *inIntCols, unsigned int numInIntCols, std::string *inStringCols, unsigned int numInStringCols, double *outRealCols, unsigned int numOutRealCols, int *outIntCols, unsigned int numOutIntCols, std::string *outStringCols, unsigned int numOutStringCols)
@@ -321,6 +533,14 @@ namespace rsgis{namespace rastergis{
                 // Find K NN samples from training data
                 std::list<std::pair<double, double*> > *kVals = new std::list<std::pair<double, double*> >();
                 this->findKVals(kVals, inRealCols);
+                if(kVals->empty())
+                {
+                    // No training samples within the distance threshold; the summary
+                    // would otherwise be left from the previous row of this thread.
+                    outRealCols[0] = std::numeric_limits<double>::quiet_NaN();
+                    delete kVals;
+                    return;
+                }
                 
                 // Derive new value from K NN samples
                 std::vector<double> data;
@@ -391,6 +611,35 @@ namespace rsgis{namespace rastergis{
     {
         try
         {
+            if(this->kdTree != NULL)
+            {
+                size_t numFeatVals = this->m - 1;
+                double *query = this->queryVals.data();
+                if(this->whitenMatrix != NULL)
+                {
+                    for(size_t r = 0; r < numFeatVals; ++r)
+                    {
+                        double val = featVals[r+1];
+                        for(size_t c = 0; c < r; ++c)
+                        {
+                            val -= this->whitenMatrix[(r * numFeatVals) + c] * query[c];
+                        }
+                        query[r] = val / this->whitenMatrix[(r * numFeatVals) + r];
+                    }
+                }
+                else
+                {
+                    std::copy(featVals+1, featVals+this->m, query);
+                }
+                
+                this->kdTree->findKNearest(query, this->kFeatures, this->kdMaxDist, &this->neighbours);
+                for(std::vector<std::pair<double, size_t> >::iterator iterNeighbour = this->neighbours.begin(); iterNeighbour != this->neighbours.end(); ++iterNeighbour)
+                {
+                    kVals->push_back(std::pair<double, double*>((*iterNeighbour).first, this->trainData[(*iterNeighbour).second]));
+                }
+                return;
+            }
+            
             double dist = 0.0;
             for(size_t i = 0; i < this->n; ++i)
             {
@@ -398,20 +647,16 @@ namespace rsgis{namespace rastergis{
 
                 if(dist < this->distThreshold)
                 {
-                    if(kVals->empty())
+                    // Insert after any samples at the same distance, so ties are kept in
+                    // the order of the training data.
+                    std::list<std::pair<double, double*> >::iterator iterFeat = kVals->begin();
+                    while((iterFeat != kVals->end()) && ((*iterFeat).first <= dist))
                     {
-                        kVals->push_back(std::pair<double, double*>(dist, this->trainData[i]));
+                        ++iterFeat;
                     }
-                    else
+                    if((iterFeat != kVals->end()) || (kVals->size() < this->kFeatures))
                     {
-                        for(std::list<std::pair<double, double*> >::iterator iterFeat = kVals->begin(); iterFeat != kVals->end(); ++iterFeat)
-                        {
-                            if(dist < (*iterFeat).first)
-                            {
-                                kVals->insert(iterFeat, std::pair<double, double*>(dist, this->trainData[i]));
-                                break;
-                            }
-                        }
+                        kVals->insert(iterFeat, std::pair<double, double*>(dist, this->trainData[i]));
                         if(kVals->size() > this->kFeatures)
                         {
                             kVals->pop_back();
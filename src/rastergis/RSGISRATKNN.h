@@ -27,6 +27,9 @@
 #include <string>
 #include <vector>
 #include <list>
+#include <limits>
+#include <thread>
+#include <exception>
 
 #include "gdal_priv.h"
 #include "gdal_rat.h"
@@ -39,6 +42,7 @@
 
 #include "math/RSGISMathsUtils.h"
 #include "math/RSGISDistMetrics.h"
+#include "math/RSGISKDTree.h"
 
 // mark all exported classes/functions with DllExport to have
 // them exported by Visual Studio
@@ -55,13 +59,25 @@
 
 namespace rsgis{namespace rastergis{
     
+    class RSGISPerformKNNCalcValues;
     
     class DllExport RSGISApplyRATKNN
     {
     public:
         RSGISApplyRATKNN();
-        void applyKNNExtrapolation(GDALDataset *clumpsDS, std::string inExtrapField, std::string outExtrapField, std::string trainRegionsField, std::string applyRegionsField, bool useApplyField, std::vector<std::string> fields, unsigned int kFeatures=12, rsgis::math::rsgisdistmetrics distKNN=rsgis::math::rsgis_mahalanobis, float distThreshold=100000, rsgis::math::rsgissummarytype summeriseKNN=rsgis::math::sumtype_median, unsigned int ratBand=1);
+        /**
+         * For the Euclidean, Manhattan and Mahalanobis distances the nearest neighbours
+         * are found using a kd-tree built over the training features (the Mahalanobis
+         * distance is the Euclidean distance once the features have been whitened using
+         * the Cholesky factor of the covariance matrix). The rows of the RAT are then
+         * processed in blocks, with the rows of each block split across numThreads
+         * threads. Other distances use a brute force search with a single thread.
+         */
+        void applyKNNExtrapolation(GDALDataset *clumpsDS, std::string inExtrapField, std::string outExtrapField, std::string trainRegionsField, std::string applyRegionsField, bool useApplyField, std::vector<std::string> fields, unsigned int kFeatures=12, rsgis::math::rsgisdistmetrics distKNN=rsgis::math::rsgis_mahalanobis, float distThreshold=100000, rsgis::math::rsgissummarytype summeriseKNN=rsgis::math::sumtype_median, unsigned int ratBand=1, unsigned int numThreads=1);
         ~RSGISApplyRATKNN();
+    protected:
+        bool calcWhiteningMatrix(double **covarMatrix, size_t n, std::vector<double> *whitenMatrix);
+        void performKNNBlocks(GDALRasterAttributeTable *gdalAtt, std::vector<unsigned int> inRealColIdx, bool useApplyField, unsigned int applyRegFieldIdx, unsigned int outExtrapFieldIdx, std::vector<RSGISPerformKNNCalcValues*> *threadKNN);
     };
     
     class DllExport RSGISCountTrainingValues : public RSGISRATCalcValue
@@ -92,10 +108,26 @@ namespace rsgis{namespace rastergis{
     {
     public:
         RSGISPerformKNNCalcValues(double **trainData, size_t n, size_t m, unsigned int kFeatures, rsgis::math::RSGISCalcDistMetric *calcDist, float distThreshold, rsgis::math::RSGISStatsSummary *mathSumStats);
+        /**
+         * Use a kd-tree (built over the training features, in the same order as trainData,
+         * optionally transformed by the lower triangular whitenMatrix) to find the neighbours
+         * rather than a brute force search with calcDist. kdMaxDist is distThreshold in the
+         * units of the kd-tree norm. The tree is only read so can be shared between threads.
+         */
+        void setKDTree(const rsgis::math::RSGISKDTree *kdTree, double kdMaxDist, const double *whitenMatrix=NULL);
         void calcRATValue(size_t fid, double *inRealCols, unsigned int numInRealCols, int *inIntCols, unsigned int numInIntCols, std::string *inStringCols, unsigned int numInStringCols, double *outRealCols, unsigned int numOutRealCols, int *outIntCols, unsigned int numOutIntCols, std::string *outStringCols, unsigned int numOutStringCols);
+        /**
+         * Find the (up to) K training samples nearest to featVals with a distance less than
+         * distThreshold, ordered by distance (ties ordered as the training data).
+         */
         void findKVals(std::list<std::pair<double, double*> > *kVals, double *featVals);
         ~RSGISPerformKNNCalcValues();
     private:
+        const rsgis::math::RSGISKDTree *kdTree;
+        double kdMaxDist;
+        const double *whitenMatrix;
+        std::vector<double> queryVals;
+        std::vector<std::pair<double, size_t> > neighbours;
         double **trainData;
         size_t n;
         size_t m;
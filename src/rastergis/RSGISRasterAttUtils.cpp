@@ -2215,6 +2215,85 @@ namespace rsgis{namespace rastergis{
         return neighbours;
     }
     
+    void RSGISRasterAttUtils::getRATNeighbourGraph(GDALDataset *clumpImage, unsigned int ratBand, RSGISClumpNeighbourGraph *neighbourGraph)
+    {
+        try
+        {
+            kealib::KEAImageIO *keaImgIO;
+            void *internalData = clumpImage->GetInternalHandle("");
+            if(internalData != NULL)
+            {
+                keaImgIO = static_cast<kealib::KEAImageIO*>(internalData);
+                if(keaImgIO == NULL)
+                {
+                    throw RSGISAttributeTableException("Could not get hold of the internal KEA Image IO Object - is input image a KEA file?");
+                }
+            }
+            else
+            {
+                throw RSGISAttributeTableException("Internal data on GDAL Dataset was NULL - check input file is KEA.");
+            }
+            
+            kealib::KEAAttributeTable *keaAtt = keaImgIO->getAttributeTable(kealib::kea_att_file, ratBand);
+            size_t numRows = keaAtt->getSize();
+            
+            neighbourGraph->numClumps = numRows;
+            neighbourGraph->nbrOffsets.clear();
+            neighbourGraph->nbrOffsets.reserve(numRows+1);
+            neighbourGraph->nbrOffsets.push_back(0);
+            neighbourGraph->nbrIdxs.clear();
+            
+            // Read the table in blocks so only a block of per-row vectors exists at once.
+            std::vector<std::vector<size_t>* > blockNeighbours;
+            try
+            {
+                for(size_t startRow = 0; startRow < numRows; startRow += RAT_BLOCK_LENGTH)
+                {
+                    size_t nRows = std::min<size_t>(RAT_BLOCK_LENGTH, numRows-startRow);
+                    keaAtt->getNeighbours(startRow, nRows, &blockNeighbours);
+                    for(std::vector<std::vector<size_t>* >::iterator iterClumps = blockNeighbours.begin(); iterClumps != blockNeighbours.end(); ++iterClumps)
+                    {
+                        // Tables written by older versions do not have sorted neighbour lists.
+                        size_t nbrStart = neighbourGraph->nbrIdxs.size();
+                        neighbourGraph->nbrIdxs.insert(neighbourGraph->nbrIdxs.end(), (*iterClumps)->begin(), (*iterClumps)->end());
+                        std::sort(neighbourGraph->nbrIdxs.begin()+nbrStart, neighbourGraph->nbrIdxs.end());
+                        neighbourGraph->nbrOffsets.push_back(neighbourGraph->nbrIdxs.size());
+                    }
+                    for(std::vector<std::vector<size_t>* >::iterator iterClumps = blockNeighbours.begin(); iterClumps != blockNeighbours.end(); ++iterClumps)
+                    {
+                        delete *iterClumps;
+                    }
+                    blockNeighbours.clear();
+                }
+            }
+            catch(...)
+            {
+                for(std::vector<std::vector<size_t>* >::iterator iterClumps = blockNeighbours.begin(); iterClumps != blockNeighbours.end(); ++iterClumps)
+                {
+                    delete *iterClumps;
+                }
+                throw;
+            }
+            
+            if(neighbourGraph->nbrOffsets.size() != (numRows+1))
+            {
+                throw RSGISAttributeTableException("The number of neighbour lists read is different to the size of the RAT.");
+            }
+        }
+        catch (RSGISAttributeTableException &e)
+        {
+            throw e;
+        }
+        catch (rsgis::RSGISException &e)
+        {
+            throw RSGISAttributeTableException(e.what());
+        }
+        catch (std::exception &e)
+        {
+            throw RSGISAttributeTableException(e.what());
+        }
+    }
+    
     
     void RSGISRasterAttUtils::writeStrColumn(GDALRasterAttributeTable *attTable, std::string colName, std::string *strDataVal, size_t colLen)
     {
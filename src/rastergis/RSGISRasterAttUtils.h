@@ -31,6 +31,7 @@
 #include <map>
 #include <vector>
 #include <cmath>
+#include <algorithm>
 
 #include "gdal_priv.h"
 #include "gdal_rat.h"
@@ -49,6 +50,8 @@
 #include "img/RSGISCalcImageValue.h"
 #include "img/RSGISCalcImage.h"
 
+#include "rastergis/RSGISClumpNeighbourGraph.h"
+
 #include <boost/numeric/conversion/cast.hpp>
 #include <boost/lexical_cast.hpp>
 
@@ -133,6 +136,7 @@ namespace rsgis{namespace rastergis{
         std::vector<int>* readIntColumnAsVec(GDALRasterAttributeTable *attTable, std::string colName);
         std::vector<std::string>* readStrColumnAsVec(GDALRasterAttributeTable *attTable, std::string colName);
         std::vector<std::vector<size_t>* >* getRATNeighbours(GDALDataset *clumpImage, unsigned int ratBand);
+        void getRATNeighbourGraph(GDALDataset *clumpImage, unsigned int ratBand, RSGISClumpNeighbourGraph *neighbourGraph);
         void writeStrColumn(GDALRasterAttributeTable *attTable, std::string colName, std::string *strDataVal, size_t colLen);
         void writeIntColumn(GDALRasterAttributeTable *attTable, std::string colName, int *intDataVal, size_t colLen);
         void writeRealColumn(GDALRasterAttributeTable *attTable, std::string colName, double *realDataVal, size_t colLen);
@@ -26,7 +26,7 @@
 
 namespace rsgis{namespace reg{
 
-	RSGISBasicImageRegistration::RSGISBasicImageRegistration(GDALDataset *reference, GDALDataset *floating, unsigned int gap, float metricThreshold, unsigned int windowSize, unsigned int searchArea, RSGISImageSimilarityMetric *metric, float stdDevRefThreshold, float stdDevFloatThreshold, unsigned int subPixelResolution):RSGISImageRegistration(reference, floating), tiePoints(NULL), gap(1), metricThreshold(0), initExecuted(false), windowSize(0), searchArea(0), metric(NULL), stdDevRefThreshold(0), stdDevFloatThreshold(0), subPixelResolution(0)
+	RSGISBasicImageRegistration::RSGISBasicImageRegistration(GDALDataset *reference, GDALDataset *floating, unsigned int gap, float metricThreshold, unsigned int windowSize, unsigned int searchArea, RSGISImageSimilarityMetric *metric, float stdDevRefThreshold, float stdDevFloatThreshold, unsigned int subPixelResolution, unsigned int numThreads):RSGISImageRegistration(reference, floating), tiePoints(NULL), gap(1), metricThreshold(0), initExecuted(false), windowSize(0), searchArea(0), metric(NULL), stdDevRefThreshold(0), stdDevFloatThreshold(0), subPixelResolution(0), numThreads(1)
 	{
 		tiePoints = new std::list<TiePoint*>();
 		this->gap = gap;
@@ -37,6 +37,7 @@ namespace rsgis{namespace reg{
 		this->stdDevRefThreshold = stdDevRefThreshold;
 		this->stdDevFloatThreshold = stdDevFloatThreshold;
 		this->subPixelResolution = subPixelResolution;
+		this->numThreads = numThreads;
 	}
 		
 	void RSGISBasicImageRegistration::initRegistration()
@@ -120,34 +121,14 @@ namespace rsgis{namespace reg{
 			throw RSGISRegistrationException("The algorithm needs to be initialised before being executed.");
 		}
 		
-		unsigned int counter = 0;
-		unsigned int feedback = 0;
-		unsigned int feedbackVal = 0;
-		bool giveFeedback = false;
-		if(tiePoints->size() > 10)
-		{
-			feedback = tiePoints->size()/10;
-			giveFeedback = true;
-		}
-		
-		std::cout << "Started ." << std::flush;
+		// The tie points are independent so can be found in parallel.
+		std::vector<TiePoint*> tiePtsVec(tiePoints->begin(), tiePoints->end());
+		std::vector<float> distMoved;
+		std::vector<float> xShifts;
+		std::vector<float> yShifts;
 		
-		float xShift = 0;
-		float yShift = 0;
-		
-		std::list<TiePoint*>::iterator iterTiePts;
-		for(iterTiePts = tiePoints->begin(); iterTiePts != tiePoints->end(); ++iterTiePts)
-		{
-			if(giveFeedback && ((counter % feedback) == 0))
-			{
-				std::cout << "." << feedbackVal << "." << std::flush;
-				feedbackVal += 10;
-			}
-			
-			this->findTiePointLocation(*iterTiePts, windowSize, searchArea, metric, metricThreshold, subPixelResolution, &xShift, &yShift);            
-			++counter;
-		}
-		std::cout << ". Complete\n";
+		std::cout << "Finding the location of " << tiePtsVec.size() << " tie points using " << numThreads << " thread(s)\n";
+		this->findTiePointLocations(&tiePtsVec, windowSize, searchArea, metric, true, metricThreshold, subPixelResolution, numThreads, &distMoved, &xShifts, &yShifts);
 	}
 	
 	void RSGISBasicImageRegistration::finaliseRegistration()
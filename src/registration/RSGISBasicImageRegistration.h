@@ -30,6 +30,7 @@
 #include <string>
 #include <cmath>
 #include <list>
+#include <vector>
 
 #include "gdal_priv.h"
 #include "ogrsf_frmts.h"
@@ -59,7 +60,7 @@ namespace rsgis{namespace reg{
 	class DllExport RSGISBasicImageRegistration : public RSGISImageRegistration
 	{
 	public:
-		RSGISBasicImageRegistration(GDALDataset *reference, GDALDataset *floating, unsigned int gap, float metricThreshold, unsigned int windowSize, unsigned int searchArea, RSGISImageSimilarityMetric *metric, float stdDevRefThreshold, float stdDevFloatThreshold, unsigned int subPixelResolution);
+		RSGISBasicImageRegistration(GDALDataset *reference, GDALDataset *floating, unsigned int gap, float metricThreshold, unsigned int windowSize, unsigned int searchArea, RSGISImageSimilarityMetric *metric, float stdDevRefThreshold, float stdDevFloatThreshold, unsigned int subPixelResolution, unsigned int numThreads=1);
 		void initRegistration();
 		void executeRegistration();
 		void finaliseRegistration();
@@ -79,6 +80,7 @@ namespace rsgis{namespace reg{
 		float stdDevRefThreshold;
 		float stdDevFloatThreshold;
 		unsigned int subPixelResolution;
+		unsigned int numThreads;
 	};
 }}
 
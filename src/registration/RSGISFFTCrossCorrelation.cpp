@@ -0,0 +1,169 @@
+/*
+ *  RSGISFFTCrossCorrelation.cpp
+ *  RSGIS_LIB
+ *
+ *  Created by Pete Bunting on 17/10/2026.
+ *  Copyright 2026 RSGISLib. All rights reserved.
+ *
+ * This file is part of RSGISLib.
+ *
+ * RSGISLib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * RSGISLib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with RSGISLib.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "RSGISFFTCrossCorrelation.h"
+
+namespace rsgis{namespace reg{
+
+    void RSGISFFTCrossCorrelation::crossCorrelate(float **tmpl, unsigned int tWidth, unsigned int tHeight, float **search, unsigned int sWidth, unsigned int sHeight, unsigned int numBands, double offset, double *out)
+    {
+        if((tWidth == 0) || (tHeight == 0) || (tWidth > sWidth) || (tHeight > sHeight))
+        {
+            throw RSGISRegistrationException("The template window must be within the search window.");
+        }
+
+        // The search window is not padded beyond the next fast FFT size; as the template
+        // is never moved beyond the search window the circular correlation does not wrap.
+        size_t fftWidth = findFFTSize(sWidth);
+        size_t fftHeight = findFFTSize(sHeight);
+        size_t fftSize = fftWidth * fftHeight;
+
+        gsl_fft_complex_wavetable *wtX = gsl_fft_complex_wavetable_alloc(fftWidth);
+        gsl_fft_complex_workspace *wsX = gsl_fft_complex_workspace_alloc(fftWidth);
+        gsl_fft_complex_wavetable *wtY = gsl_fft_complex_wavetable_alloc(fftHeight);
+        gsl_fft_complex_workspace *wsY = gsl_fft_complex_workspace_alloc(fftHeight);
+
+        // Complex data are packed as (real, imaginary) pairs.
+        std::vector<double> tmplFFT(2*fftSize);
+        std::vector<double> searchFFT(2*fftSize);
+        std::vector<double> crossFFT(2*fftSize, 0.0);
+
+        try
+        {
+            for(unsigned int b = 0; b < numBands; ++b)
+            {
+                std::fill(tmplFFT.begin(), tmplFFT.end(), 0.0);
+                std::fill(searchFFT.begin(), searchFFT.end(), 0.0);
+                for(unsigned int j = 0; j < tHeight; ++j)
+                {
+                    for(unsigned int i = 0; i < tWidth; ++i)
+                    {
+                        tmplFFT[2*((j*fftWidth)+i)] = tmpl[b][(j*tWidth)+i] - offset;
+                    }
+                }
+                for(unsigned int j = 0; j < sHeight; ++j)
+                {
+                    for(unsigned int i = 0; i < sWidth; ++i)
+                    {
+                        searchFFT[2*((j*fftWidth)+i)] = search[b][(j*sWidth)+i] - offset;
+                    }
+                }
+
+                this->fft2D(tmplFFT.data(), fftWidth, fftHeight, wtX, wsX, wtY, wsY, true);
+                this->fft2D(searchFFT.data(), fftWidth, fftHeight, wtX, wsX, wtY, wsY, true);
+
+                // Accumulate conj(T) * S over the bands.
+                for(size_t k = 0; k < fftSize; ++k)
+                {
+                    double tRe = tmplFFT[2*k];
+                    double tIm = tmplFFT[(2*k)+1];
+                    double sRe = searchFFT[2*k];
+                    double sIm = searchFFT[(2*k)+1];
+                    crossFFT[2*k] += (tRe * sRe) + (tIm * sIm);
+                    crossFFT[(2*k)+1] += (tRe * sIm) - (tIm * sRe);
+                }
+            }
+
+            this->fft2D(crossFFT.data(), fftWidth, fftHeight, wtX, wsX, wtY, wsY, false);
+
+            unsigned int outWidth = sWidth - tWidth + 1;
+            unsigned int outHeight = sHeight - tHeight + 1;
+            for(unsigned int v = 0; v < outHeight; ++v)
+            {
+                for(unsigned int u = 0; u < outWidth; ++u)
+                {
+                    out[(v*outWidth)+u] = crossFFT[2*((v*fftWidth)+u)];
+                }
+            }
+        }
+        catch(...)
+        {
+            gsl_fft_complex_wavetable_free(wtX);
+            gsl_fft_complex_workspace_free(wsX);
+            gsl_fft_complex_wavetable_free(wtY);
+            gsl_fft_complex_workspace_free(wsY);
+            throw;
+        }
+
+        gsl_fft_complex_wavetable_free(wtX);
+        gsl_fft_complex_workspace_free(wsX);
+        gsl_fft_complex_wavetable_free(wtY);
+        gsl_fft_complex_workspace_free(wsY);
+    }
+
+    size_t RSGISFFTCrossCorrelation::findFFTSize(size_t n)
+    {
+        size_t size = (n < 1)?1:n;
+        while(true)
+        {
+            size_t m = size;
+            while((m % 2) == 0){m /= 2;}
+            while((m % 3) == 0){m /= 3;}
+            while((m % 5) == 0){m /= 5;}
+            if(m == 1)
+            {
+                return size;
+            }
+            ++size;
+        }
+    }
+
+    void RSGISFFTCrossCorrelation::fft2D(double *data, size_t width, size_t height, gsl_fft_complex_wavetable *wtX, gsl_fft_complex_workspace *wsX, gsl_fft_complex_wavetable *wtY, gsl_fft_complex_workspace *wsY, bool forward)
+    {
+        int status = GSL_SUCCESS;
+        // Transform the rows
+        for(size_t j = 0; j < height; ++j)
+        {
+            if(forward)
+            {
+                status = gsl_fft_complex_forward(&data[2*j*width], 1, width, wtX, wsX);
+            }
+            else
+            {
+                status = gsl_fft_complex_inverse(&data[2*j*width], 1, width, wtX, wsX);
+            }
+            if(status != GSL_SUCCESS)
+            {
+                throw RSGISRegistrationException("The FFT of the image window failed.");
+            }
+        }
+        // Transform the columns
+        for(size_t i = 0; i < width; ++i)
+        {
+            if(forward)
+            {
+                status = gsl_fft_complex_forward(&data[2*i], width, height, wtY, wsY);
+            }
+            else
+            {
+                status = gsl_fft_complex_inverse(&data[2*i], width, height, wtY, wsY);
+            }
+            if(status != GSL_SUCCESS)
+            {
+                throw RSGISRegistrationException("The FFT of the image window failed.");
+            }
+        }
+    }
+
+}}
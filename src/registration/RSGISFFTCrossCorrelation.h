@@ -0,0 +1,79 @@
+/*
+ *  RSGISFFTCrossCorrelation.h
+ *  RSGIS_LIB
+ *
+ *  Created by Pete Bunting on 17/10/2026.
+ *  Copyright 2026 RSGISLib. All rights reserved.
+ *
+ * This file is part of RSGISLib.
+ *
+ * RSGISLib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * RSGISLib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with RSGISLib.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef RSGISFFTCrossCorrelation_H
+#define RSGISFFTCrossCorrelation_H
+
+#include <iostream>
+#include <vector>
+#include <algorithm>
+#include <cmath>
+
+#include "common/RSGISRegistrationException.h"
+
+#include <gsl/gsl_errno.h>
+#include <gsl/gsl_fft_complex.h>
+
+// mark all exported classes/functions with DllExport to have
+// them exported by Visual Studio
+#undef DllExport
+#ifdef _MSC_VER
+    #ifdef rsgis_registration_EXPORTS
+        #define DllExport   __declspec( dllexport )
+    #else
+        #define DllExport   __declspec( dllimport )
+    #endif
+#else
+    #define DllExport
+#endif
+
+namespace rsgis{namespace reg{
+
+    /**
+     * Calculates the cross product of a template window with a search window at
+     * every offset of the template within the search window using the FFT (GSL
+     * mixed radix), summed over the image bands:
+     *
+     * out[v*outWidth+u] = sum_b sum_j sum_i (tmpl[b][j*tWidth+i]-offset) * (search[b][(v+j)*sWidth+(u+i)]-offset)
+     *
+     * for u = 0..(sWidth-tWidth) and v = 0..(sHeight-tHeight), where outWidth = sWidth-tWidth+1.
+     * The offset is subtracted from both windows before the transform to reduce the
+     * rounding error for data with a large mean (e.g., use the template mean).
+     * The band data are in the layout returned by RSGISImageUtils::getImageDataBlock.
+     */
+    class DllExport RSGISFFTCrossCorrelation
+    {
+    public:
+        RSGISFFTCrossCorrelation(){};
+        void crossCorrelate(float **tmpl, unsigned int tWidth, unsigned int tHeight, float **search, unsigned int sWidth, unsigned int sHeight, unsigned int numBands, double offset, double *out);
+        /** Returns the smallest size >= n with only factors of 2, 3 and 5 (fast for the mixed radix FFT). */
+        static size_t findFFTSize(size_t n);
+        ~RSGISFFTCrossCorrelation(){};
+    protected:
+        void fft2D(double *data, size_t width, size_t height, gsl_fft_complex_wavetable *wtX, gsl_fft_complex_workspace *wsX, gsl_fft_complex_wavetable *wtY, gsl_fft_complex_workspace *wsY, bool forward);
+    };
+
+}}
+
+#endif
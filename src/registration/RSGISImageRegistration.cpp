@@ -82,6 +82,13 @@ namespace rsgis{namespace reg{
 			overlap->floatYStart = dsOffsets[1][1];
 			overlap->numRefBands = referenceIMG->GetRasterCount();
 			overlap->numFloatBands = floatingIMG->GetRasterCount();
+            
+            referenceIMG->GetGeoTransform(refImgTransform);
+            refImgSizeX = referenceIMG->GetRasterXSize();
+            refImgSizeY = referenceIMG->GetRasterYSize();
+            floatingIMG->GetGeoTransform(floatImgTransform);
+            floatImgSizeX = floatingIMG->GetRasterXSize();
+            floatImgSizeY = floatingIMG->GetRasterYSize();
 			
 			delete[] overlapTransform;
 			delete[] dsOffsets[0];
@@ -114,7 +121,7 @@ namespace rsgis{namespace reg{
 
 	}
 	
-	float RSGISImageRegistration::findTiePointLocation(TiePoint *tiePt, unsigned int windowSize, unsigned int searchArea, RSGISImageSimilarityMetric *metric, float metricThreshold, unsigned int subPixelResolution, float *moveInX, float *moveInY)
+	float RSGISImageRegistration::findTiePointLocation(TiePoint *tiePt, unsigned int windowSize, unsigned int searchArea, RSGISImageSimilarityMetric *metric, float metricThreshold, unsigned int subPixelResolution, float *moveInX, float *moveInY, GDALDataset *refDataset, GDALDataset *floatDataset)
 	{
 		float distanceMoved = 0;
 		
@@ -123,17 +130,8 @@ namespace rsgis{namespace reg{
 			throw RSGISRegistrationException("The overlap needs to be defined before tie location can be defined.");
 		}
 		
-		rsgis::img::RSGISImageUtils imgUtils;
 		try 
 		{
-			// Setup overlapping region variables.
-			int **dsOffsets = new int*[2];
-			dsOffsets[0] = new int[2];
-			dsOffsets[1] = new int[2];
-			int overlapWidth = 0;
-			int overlapHeight = 0;
-			double *overlapTransform = new double[6];
-			
 			double windowXWidth = (((double)windowSize)*overlap->xRes);
 			double windowYHeight = (((double)windowSize)*overlap->yRes);
 			
@@ -145,9 +143,13 @@ namespace rsgis{namespace reg{
 			
 			unsigned int numSearchPoints = (searchArea*2)+1;
 			float **imageSimilarity = new float*[numSearchPoints];
+			float **remainderX = new float*[numSearchPoints];
+			float **remainderY = new float*[numSearchPoints];
 			for(unsigned int i = 0; i < numSearchPoints; ++i)
 			{
 				imageSimilarity[i] = new float[numSearchPoints];
+				remainderX[i] = new float[numSearchPoints];
+				remainderY[i] = new float[numSearchPoints];
 			}
 			
 			int xShiftStart = searchArea * (-1);
@@ -155,11 +157,6 @@ namespace rsgis{namespace reg{
 			int xShiftEnd = searchArea;
 			int yShiftEnd = searchArea;
 			
-			float **refDataBlock = NULL;
-			float **floatDataBlock = NULL;
-			unsigned int numRefDataVals = 0;
-			unsigned int numFloatDataVals = 0;
-			
 			bool first = true;
 			double currentMetricVal = 0;
 			double metricVal = 0;
@@ -171,90 +168,53 @@ namespace rsgis{namespace reg{
 			unsigned int currentXIdx = 0;
 			unsigned int currentYIdx = 0;
             
-            // Set up variables to hold remainder from image overlap
-            float remainderX = 0;
-            float remainderY = 0;
             // Remainder for heighest metric
             float currentRemainderX = 0;
             float currentRemainderY = 0;
+            
+            // Calculate the metric for every shift of the floating window over the search space
+            this->calcSimilaritySurface(tiePt, env, searchArea, metric, imageSimilarity, remainderX, remainderY, ((refDataset == NULL)?referenceIMG:refDataset), ((floatDataset == NULL)?floatingIMG:floatDataset));
 			
-            // Move floating window over search space
 			for(int yShift = yShiftStart; yShift <= yShiftEnd; ++yShift)
 			{
 				xIdx = 0;
 				for(int xShift = xShiftStart; xShift <= xShiftEnd; ++xShift)
 				{
-					try
+					metricVal = imageSimilarity[yIdx][xIdx];
+					
+					if(!((boost::math::isnan)(metricVal)))
 					{
-						this->getImageOverlapWithFloatShift((((float)xShift)+tiePt->xShift), (((float)yShift)+tiePt->yShift), dsOffsets, &overlapWidth, &overlapHeight, overlapTransform, env, &remainderX, &remainderY);
-						
-						if((overlapWidth > 0) & (overlapHeight > 0))
+						if(first)
 						{
-							numRefDataVals = 0;
-							numFloatDataVals = 0;
-							
-							refDataBlock = imgUtils.getImageDataBlock(referenceIMG, dsOffsets[0], overlapWidth, overlapHeight, &numRefDataVals);
-							floatDataBlock = imgUtils.getImageDataBlock(floatingIMG, dsOffsets[1], overlapWidth, overlapHeight, &numFloatDataVals);
-							
-							if(numRefDataVals != numFloatDataVals)
-							{
-								throw RSGISRegistrationException("The number of data values read from the images does not match.");
-							}
-							
-							metricVal = metric->calcValue(refDataBlock, floatDataBlock, numRefDataVals, overlap->numRefBands);
-							
-							imageSimilarity[yIdx][xIdx] = metricVal;
-							
-							if(!((boost::math::isnan)(metricVal)))
-							{
-								if(first)
-								{
-									currentMetricVal = metricVal;
-									currentShiftX = xShift;
-									currentShiftY = yShift;
-									currentXIdx = xIdx;
-									currentYIdx = yIdx;
-                                    currentRemainderX = remainderX;
-                                    currentRemainderY = remainderY;
-									first = false;
-								}
-								else if(metric->findMin() & (metricVal < currentMetricVal))
-								{
-									currentMetricVal = metricVal;
-									currentShiftX = xShift;
-									currentShiftY = yShift;
-									currentXIdx = xIdx;
-									currentYIdx = yIdx;
-                                    currentRemainderX = remainderX;
-                                    currentRemainderY = remainderY;
-								}
-								else if(!metric->findMin() & (metricVal > currentMetricVal))
-								{
-									currentMetricVal = metricVal;
-									currentShiftX = xShift;
-									currentShiftY = yShift;
-									currentXIdx = xIdx;
-									currentYIdx = yIdx;
-                                    currentRemainderX = remainderX;
-                                    currentRemainderY = remainderY;
-								}
-							}
-							
-							for(unsigned int i = 0; i < overlap->numRefBands; ++i)
-							{
-								delete[] refDataBlock[i];
-								delete[] floatDataBlock[i];
-							}
-							delete[] refDataBlock;
-							delete[] floatDataBlock;
+							currentMetricVal = metricVal;
+							currentShiftX = xShift;
+							currentShiftY = yShift;
+							currentXIdx = xIdx;
+							currentYIdx = yIdx;
+							currentRemainderX = remainderX[yIdx][xIdx];
+							currentRemainderY = remainderY[yIdx][xIdx];
+							first = false;
+						}
+						else if(metric->findMin() & (metricVal < currentMetricVal))
+						{
+							currentMetricVal = metricVal;
+							currentShiftX = xShift;
+							currentShiftY = yShift;
+							currentXIdx = xIdx;
+							currentYIdx = yIdx;
+							currentRemainderX = remainderX[yIdx][xIdx];
+							currentRemainderY = remainderY[yIdx][xIdx];
+						}
+						else if(!metric->findMin() & (metricVal > currentMetricVal))
+						{
+							currentMetricVal = metricVal;
+							currentShiftX = xShift;
+							currentShiftY = yShift;
+							currentXIdx = xIdx;
+							currentYIdx = yIdx;
+							currentRemainderX = remainderX[yIdx][xIdx];
+							currentRemainderY = remainderY[yIdx][xIdx];
 						}
-					}
-					catch (RSGISRegistrationException &e) 
-					{
-						// ignore
-						std::cerr << "Tie Point = [" << tiePt->xRef << "," << tiePt->yRef << "]\n";
-						std::cerr << "Shift = [" << (xShift+tiePt->xShift) << "," << (yShift+tiePt->yShift) << "]\n";
-						std::cerr << "WARNING: " << e.what() << std::endl;
 					}
 					xIdx++;
 				}
@@ -392,10 +352,16 @@ namespace rsgis{namespace reg{
 			}
 			
 			
-			delete[] overlapTransform;
-			delete[] dsOffsets[0];
-			delete[] dsOffsets[1];
-			delete[] dsOffsets;
+			for(unsigned int i = 0; i < numSearchPoints; ++i)
+			{
+				delete[] imageSimilarity[i];
+				delete[] remainderX[i];
+				delete[] remainderY[i];
+			}
+			delete[] imageSimilarity;
+			delete[] remainderX;
+			delete[] remainderY;
+			delete env;
 		}
 		catch (rsgis::img::RSGISImageBandException &e) 
 		{
@@ -409,7 +375,7 @@ namespace rsgis{namespace reg{
 		return distanceMoved;
 	}
     
-    float RSGISImageRegistration::findTiePointLocation(TiePoint *tiePt, unsigned int windowSize, unsigned int searchArea, RSGISImageSimilarityMetric *metric, unsigned int subPixelResolution, float *moveInX, float *moveInY)
+    float RSGISImageRegistration::findTiePointLocation(TiePoint *tiePt, unsigned int windowSize, unsigned int searchArea, RSGISImageSimilarityMetric *metric, unsigned int subPixelResolution, float *moveInX, float *moveInY, GDALDataset *refDataset, GDALDataset *floatDataset)
 	{
 		float distanceMoved = 0;
 		
@@ -418,31 +384,26 @@ namespace rsgis{namespace reg{
 			throw RSGISRegistrationException("The overlap needs to be defined before tie location can be defined.");
 		}
 		
-		rsgis::img::RSGISImageUtils imgUtils;
 		try
 		{
-			// Setup overlapping region variables.
-			int **dsOffsets = new int*[2];
-			dsOffsets[0] = new int[2];
-			dsOffsets[1] = new int[2];
-			int overlapWidth = 0;
-			int overlapHeight = 0;
-			double *overlapTransform = new double[6];
-			
 			double windowXWidth = (((double)windowSize)*overlap->xRes);
 			double windowYHeight = (((double)windowSize)*overlap->yRes);
-
-            OGREnvelope *env = new OGREnvelope();
-            env->MinX = (tiePt->eastings - windowXWidth);
-            env->MaxX = (tiePt->eastings + windowXWidth + overlap->xRes);
-            env->MinY = (tiePt->northings - windowYHeight);
-            env->MaxY = (tiePt->northings + windowYHeight + overlap->yRes);
+			
+			OGREnvelope *env = new OGREnvelope();
+			env->MinX = (tiePt->eastings - windowXWidth);
+			env->MaxX = (tiePt->eastings + windowXWidth + overlap->xRes);
+			env->MinY = (tiePt->northings - windowYHeight);
+			env->MaxY = (tiePt->northings + windowYHeight + overlap->yRes);
 			
 			unsigned int numSearchPoints = (searchArea*2)+1;
 			float **imageSimilarity = new float*[numSearchPoints];
+			float **remainderX = new float*[numSearchPoints];
+			float **remainderY = new float*[numSearchPoints];
 			for(unsigned int i = 0; i < numSearchPoints; ++i)
 			{
 				imageSimilarity[i] = new float[numSearchPoints];
+				remainderX[i] = new float[numSearchPoints];
+				remainderY[i] = new float[numSearchPoints];
 			}
 			
 			int xShiftStart = searchArea * (-1);
@@ -450,11 +411,6 @@ namespace rsgis{namespace reg{
 			int xShiftEnd = searchArea;
 			int yShiftEnd = searchArea;
 			
-			float **refDataBlock = NULL;
-			float **floatDataBlock = NULL;
-			unsigned int numRefDataVals = 0;
-			unsigned int numFloatDataVals = 0;
-			
 			bool first = true;
 			double currentMetricVal = 0;
 			double metricVal = 0;
@@ -466,89 +422,53 @@ namespace rsgis{namespace reg{
 			unsigned int currentXIdx = 0;
 			unsigned int currentYIdx = 0;
             
-            // Set up variables to hold remainder from image overlap
-            float remainderX = 0;
-            float remainderY = 0;
             // Remainder for heighest metric
             float currentRemainderX = 0;
             float currentRemainderY = 0;
+            
+            // Calculate the metric for every shift of the floating window over the search space
+            this->calcSimilaritySurface(tiePt, env, searchArea, metric, imageSimilarity, remainderX, remainderY, ((refDataset == NULL)?referenceIMG:refDataset), ((floatDataset == NULL)?floatingIMG:floatDataset));
 			
 			for(int yShift = yShiftStart; yShift <= yShiftEnd; ++yShift)
 			{
 				xIdx = 0;
 				for(int xShift = xShiftStart; xShift <= xShiftEnd; ++xShift)
 				{
-					try
+					metricVal = imageSimilarity[yIdx][xIdx];
+					
+					if(!((boost::math::isnan)(metricVal)))
 					{
-						this->getImageOverlapWithFloatShift((((float)xShift)+tiePt->xShift), (((float)yShift)+tiePt->yShift), dsOffsets, &overlapWidth, &overlapHeight, overlapTransform, env, &remainderX, &remainderY);
-						
-						if((overlapWidth > 0) & (overlapHeight > 0))
+						if(first)
 						{
-							numRefDataVals = 0;
-							numFloatDataVals = 0;
-							
-							refDataBlock = imgUtils.getImageDataBlock(referenceIMG, dsOffsets[0], overlapWidth, overlapHeight, &numRefDataVals);
-							floatDataBlock = imgUtils.getImageDataBlock(floatingIMG, dsOffsets[1], overlapWidth, overlapHeight, &numFloatDataVals);
-							
-							if(numRefDataVals != numFloatDataVals)
-							{
-								throw RSGISRegistrationException("The number of data values read from the images does not match.");
-							}
-							
-							metricVal = metric->calcValue(refDataBlock, floatDataBlock, numRefDataVals, overlap->numRefBands);
-							
-							imageSimilarity[yIdx][xIdx] = metricVal;
-							
-							if(!((boost::math::isnan)(metricVal)))
-							{
-								if(first)
-								{
-									currentMetricVal = metricVal;
-									currentShiftX = xShift;
-									currentShiftY = yShift;
-									currentXIdx = xIdx;
-									currentYIdx = yIdx;
-                                    currentRemainderX = remainderX;
-                                    currentRemainderY = remainderY;
-									first = false;
-								}
-								else if(metric->findMin() & (metricVal < currentMetricVal))
-								{
-									currentMetricVal = metricVal;
-									currentShiftX = xShift;
-									currentShiftY = yShift;
-									currentXIdx = xIdx;
-									currentYIdx = yIdx;
-                                    currentRemainderX = remainderX;
-                                    currentRemainderY = remainderY;
-								}
-								else if(!metric->findMin() & (metricVal > currentMetricVal))
-								{
-									currentMetricVal = metricVal;
-									currentShiftX = xShift;
-									currentShiftY = yShift;
-									currentXIdx = xIdx;
-									currentYIdx = yIdx;
-                                    currentRemainderX = remainderX;
-                                    currentRemainderY = remainderY;
-								}
-							}
-							
-							for(unsigned int i = 0; i < overlap->numRefBands; ++i)
-							{
-								delete[] refDataBlock[i];
-								delete[] floatDataBlock[i];
-							}
-							delete[] refDataBlock;
-							delete[] floatDataBlock;
+							currentMetricVal = metricVal;
+							currentShiftX = xShift;
+							currentShiftY = yShift;
+							currentXIdx = xIdx;
+							currentYIdx = yIdx;
+							currentRemainderX = remainderX[yIdx][xIdx];
+							currentRemainderY = remainderY[yIdx][xIdx];
+							first = false;
+						}
+						else if(metric->findMin() & (metricVal < currentMetricVal))
+						{
+							currentMetricVal = metricVal;
+							currentShiftX = xShift;
+							currentShiftY = yShift;
+							currentXIdx = xIdx;
+							currentYIdx = yIdx;
+							currentRemainderX = remainderX[yIdx][xIdx];
+							currentRemainderY = remainderY[yIdx][xIdx];
+						}
+						else if(!metric->findMin() & (metricVal > currentMetricVal))
+						{
+							currentMetricVal = metricVal;
+							currentShiftX = xShift;
+							currentShiftY = yShift;
+							currentXIdx = xIdx;
+							currentYIdx = yIdx;
+							currentRemainderX = remainderX[yIdx][xIdx];
+							currentRemainderY = remainderY[yIdx][xIdx];
 						}
-					}
-					catch (RSGISRegistrationException &e)
-					{
-						// ignore
-						std::cerr << "Tie Point = [" << tiePt->xRef << "," << tiePt->yRef << "]\n";
-						std::cerr << "Shift = [" << (xShift+tiePt->xShift) << "," << (yShift+tiePt->yShift) << "]\n";
-						std::cerr << "WARNING: " << e.what() << std::endl;
 					}
 					xIdx++;
 				}
@@ -669,10 +589,16 @@ namespace rsgis{namespace reg{
             tiePt->yShift += finalYShift;
             tiePt->metricVal = currentMetricVal;
 			
-			delete[] overlapTransform;
-			delete[] dsOffsets[0];
-			delete[] dsOffsets[1];
-			delete[] dsOffsets;
+			for(unsigned int i = 0; i < numSearchPoints; ++i)
+			{
+				delete[] imageSimilarity[i];
+				delete[] remainderX[i];
+				delete[] remainderY[i];
+			}
+			delete[] imageSimilarity;
+			delete[] remainderX;
+			delete[] remainderY;
+			delete env;
 		}
 		catch (rsgis::img::RSGISImageBandException &e)
 		{
@@ -686,6 +612,448 @@ namespace rsgis{namespace reg{
 		return distanceMoved;
 	}
 	
+	void RSGISImageRegistration::findTiePointLocations(std::vector<TiePoint*> *tiePts, unsigned int windowSize, unsigned int searchArea, RSGISImageSimilarityMetric *metric, bool useThreshold, float metricThreshold, unsigned int subPixelResolution, unsigned int numThreads, std::vector<float> *distMoved, std::vector<float> *moveInX, std::vector<float> *moveInY)
+	{
+		size_t numTiePts = tiePts->size();
+		distMoved->assign(numTiePts, 0);
+		moveInX->assign(numTiePts, 0);
+		moveInY->assign(numTiePts, 0);
+		if(numTiePts == 0)
+		{
+			return;
+		}
+		if(numThreads < 1)
+		{
+			numThreads = 1;
+		}
+		if(numThreads > numTiePts)
+		{
+			numThreads = numTiePts;
+		}
+		
+		rsgis_tqdm pbar;
+		std::atomic<size_t> nextTiePt(0);
+		size_t numTiePtsDone = 0;
+		std::mutex progressMutex;
+		std::vector<std::exception_ptr> threadErrors(numThreads);
+		std::vector<std::thread> threads;
+		for(unsigned int t = 0; t < numThreads; ++t)
+		{
+			threads.push_back(std::thread([&, t]()
+			{
+				GDALDataset *refDataset = NULL;
+				GDALDataset *floatDataset = NULL;
+				try
+				{
+					// GDAL datasets cannot be read from more than one thread so each thread opens its own.
+					if(numThreads > 1)
+					{
+						refDataset = (GDALDataset *) GDALOpen(referenceIMG->GetDescription(), GA_ReadOnly);
+						if(refDataset == NULL)
+						{
+							std::string message = std::string("Could not open image ") + std::string(referenceIMG->GetDescription());
+							throw RSGISRegistrationException(message.c_str());
+						}
+						floatDataset = (GDALDataset *) GDALOpen(floatingIMG->GetDescription(), GA_ReadOnly);
+						if(floatDataset == NULL)
+						{
+							std::string message = std::string("Could not open image ") + std::string(floatingIMG->GetDescription());
+							throw RSGISRegistrationException(message.c_str());
+						}
+					}
+					
+					// Each result is stored by the index of the tie point, so the output does not depend on the thread which found it.
+					for(size_t i = nextTiePt++; i < numTiePts; i = nextTiePt++)
+					{
+						if(useThreshold)
+						{
+							(*distMoved)[i] = this->findTiePointLocation(tiePts->at(i), windowSize, searchArea, metric, metricThreshold, subPixelResolution, &(*moveInX)[i], &(*moveInY)[i], refDataset, floatDataset);
+						}
+						else
+						{
+							(*distMoved)[i] = this->findTiePointLocation(tiePts->at(i), windowSize, searchArea, metric, subPixelResolution, &(*moveInX)[i], &(*moveInY)[i], refDataset, floatDataset);
+						}
+						
+						std::lock_guard<std::mutex> progressLock(progressMutex);
+						pbar.progress(numTiePtsDone++, numTiePts);
+					}
+				}
+				catch(...)
+				{
+					threadErrors[t] = std::current_exception();
+					// Stop the other threads taking new tie points.
+					nextTiePt = numTiePts;
+				}
+				if(refDataset != NULL)
+				{
+					GDALClose(refDataset);
+				}
+				if(floatDataset != NULL)
+				{
+					GDALClose(floatDataset);
+				}
+			}));
+		}
+		for(std::vector<std::thread>::iterator iterThreads = threads.begin(); iterThreads != threads.end(); ++iterThreads)
+		{
+			(*iterThreads).join();
+		}
+		pbar.finish();
+		for(std::vector<std::exception_ptr>::iterator iterErr = threadErrors.begin(); iterErr != threadErrors.end(); ++iterErr)
+		{
+			if(*iterErr)
+			{
+				std::rethrow_exception(*iterErr);
+			}
+		}
+	}
+	
+	void RSGISImageRegistration::calcSimilaritySurface(TiePoint *tiePt, OGREnvelope *env, unsigned int searchArea, RSGISImageSimilarityMetric *metric, float **imageSimilarity, float **remainderX, float **remainderY, GDALDataset *refDataset, GDALDataset *floatDataset)
+	{
+		/**
+		 * The overlap of the window for each shift is found first, then the whole region of each
+		 * image covering the windows for all the shifts is read once. Where the reference window is
+		 * the same for all shifts (i.e., it is not trimmed by the edge of an image) and contains no
+		 * NaN values, the sums required by the metric are calculated for all the shifts together;
+		 * the cross products with an FFT and the sums of the floating values with summed area tables.
+		 * Otherwise, the metric is calculated for each shift from the cached image data.
+		 */
+		unsigned int numSearchPoints = (searchArea*2)+1;
+		unsigned int numShifts = numSearchPoints * numSearchPoints;
+		unsigned int numBands = overlap->numRefBands;
+		if(overlap->numFloatBands < numBands)
+		{
+			throw RSGISRegistrationException("The floating image must have at least as many bands as the reference image.");
+		}
+		
+		int **dsOffsets = new int*[2];
+		dsOffsets[0] = new int[2];
+		dsOffsets[1] = new int[2];
+		int overlapWidth = 0;
+		int overlapHeight = 0;
+		double *overlapTransform = new double[6];
+		
+		std::vector<bool> validShift(numShifts, false);
+		std::vector<int> refXOff(numShifts, 0);
+		std::vector<int> refYOff(numShifts, 0);
+		std::vector<int> floatXOff(numShifts, 0);
+		std::vector<int> floatYOff(numShifts, 0);
+		std::vector<int> shiftWidth(numShifts, 0);
+		std::vector<int> shiftHeight(numShifts, 0);
+		
+		int refMinX = 0;
+		int refMinY = 0;
+		int refMaxX = 0;
+		int refMaxY = 0;
+		int floatMinX = 0;
+		int floatMinY = 0;
+		int floatMaxX = 0;
+		int floatMaxY = 0;
+		bool first = true;
+		bool sameRefWindow = true;
+		
+		unsigned int idx = 0;
+		for(unsigned int yIdx = 0; yIdx < numSearchPoints; ++yIdx)
+		{
+			int yShift = ((int)yIdx) - ((int)searchArea);
+			for(unsigned int xIdx = 0; xIdx < numSearchPoints; ++xIdx)
+			{
+				int xShift = ((int)xIdx) - ((int)searchArea);
+				idx = (yIdx * numSearchPoints) + xIdx;
+				imageSimilarity[yIdx][xIdx] = std::numeric_limits<float>::quiet_NaN();
+				remainderX[yIdx][xIdx] = 0;
+				remainderY[yIdx][xIdx] = 0;
+				try
+				{
+					this->getImageOverlapWithFloatShift((((float)xShift)+tiePt->xShift), (((float)yShift)+tiePt->yShift), dsOffsets, &overlapWidth, &overlapHeight, overlapTransform, env, &remainderX[yIdx][xIdx], &remainderY[yIdx][xIdx]);
+					
+					if((overlapWidth > 0) & (overlapHeight > 0))
+					{
+						validShift[idx] = true;
+						refXOff[idx] = dsOffsets[0][0];
+						refYOff[idx] = dsOffsets[0][1];
+						floatXOff[idx] = dsOffsets[1][0];
+						floatYOff[idx] = dsOffsets[1][1];
+						shiftWidth[idx] = overlapWidth;
+						shiftHeight[idx] = overlapHeight;
+						
+						if(first)
+						{
+							refMinX = refXOff[idx];
+							refMinY = refYOff[idx];
+							refMaxX = refXOff[idx] + overlapWidth;
+							refMaxY = refYOff[idx] + overlapHeight;
+							floatMinX = floatXOff[idx];
+							floatMinY = floatYOff[idx];
+							floatMaxX = floatXOff[idx] + overlapWidth;
+							floatMaxY = floatYOff[idx] + overlapHeight;
+							first = false;
+						}
+						else
+						{
+							if((refXOff[idx] != refMinX) | (refYOff[idx] != refMinY) | ((refXOff[idx] + overlapWidth) != refMaxX) | ((refYOff[idx] + overlapHeight) != refMaxY))
+							{
+								sameRefWindow = false;
+							}
+							refMinX = std::min(refMinX, refXOff[idx]);
+							refMinY = std::min(refMinY, refYOff[idx]);
+							refMaxX = std::max(refMaxX, refXOff[idx] + overlapWidth);
+							refMaxY = std::max(refMaxY, refYOff[idx] + overlapHeight);
+							floatMinX = std::min(floatMinX, floatXOff[idx]);
+							floatMinY = std::min(floatMinY, floatYOff[idx]);
+							floatMaxX = std::max(floatMaxX, floatXOff[idx] + overlapWidth);
+							floatMaxY = std::max(floatMaxY, floatYOff[idx] + overlapHeight);
+						}
+					}
+				}
+				catch (RSGISRegistrationException &e)
+				{
+					// ignore
+					std::cerr << "Tie Point = [" << tiePt->xRef << "," << tiePt->yRef << "]\n";
+					std::cerr << "Shift = [" << (xShift+tiePt->xShift) << "," << (yShift+tiePt->yShift) << "]\n";
+					std::cerr << "WARNING: " << e.what() << std::endl;
+				}
+			}
+		}
+		
+		delete[] overlapTransform;
+		delete[] dsOffsets[0];
+		delete[] dsOffsets[1];
+		delete[] dsOffsets;
+		
+		if(first)
+		{
+			// None of the shifts overlap the images.
+			return;
+		}
+		
+		// Read the region of each image covering all the shifts.
+		rsgis::img::RSGISImageUtils imgUtils;
+		int refWindowOff[2] = {refMinX, refMinY};
+		int floatWindowOff[2] = {floatMinX, floatMinY};
+		unsigned int refWidth = refMaxX - refMinX;
+		unsigned int refHeight = refMaxY - refMinY;
+		unsigned int floatWidth = floatMaxX - floatMinX;
+		unsigned int floatHeight = floatMaxY - floatMinY;
+		unsigned int numRefDataVals = 0;
+		unsigned int numFloatDataVals = 0;
+		float **refWindow = NULL;
+		float **floatWindow = NULL;
+		
+		try
+		{
+			refWindow = imgUtils.getImageDataBlock(refDataset, refWindowOff, refWidth, refHeight, &numRefDataVals);
+			floatWindow = imgUtils.getImageDataBlock(floatDataset, floatWindowOff, floatWidth, floatHeight, &numFloatDataVals);
+			
+			bool noNaNs = true;
+			for(unsigned int b = 0; (b < numBands) & noNaNs; ++b)
+			{
+				for(unsigned int i = 0; i < numRefDataVals; ++i)
+				{
+					if((boost::math::isnan)(refWindow[b][i]))
+					{
+						noNaNs = false;
+						break;
+					}
+				}
+				for(unsigned int i = 0; (i < numFloatDataVals) & noNaNs; ++i)
+				{
+					if((boost::math::isnan)(floatWindow[b][i]))
+					{
+						noNaNs = false;
+						break;
+					}
+				}
+			}
+			
+			if(sameRefWindow & noNaNs & metric->calcFromSums())
+			{
+				// Subtract the mean of the reference window from both windows to reduce the
+				// rounding error in the sums. The metrics are unchanged by subtracting the same
+				// offset from both windows, so the offset sums are used directly.
+				double offset = 0;
+				for(unsigned int b = 0; b < numBands; ++b)
+				{
+					for(unsigned int i = 0; i < numRefDataVals; ++i)
+					{
+						offset += refWindow[b][i];
+					}
+				}
+				offset = offset / (((double)numRefDataVals) * numBands);
+				
+				double n = ((double)numRefDataVals) * numBands;
+				double sumR = 0;
+				double sumRSq = 0;
+				for(unsigned int b = 0; b < numBands; ++b)
+				{
+					for(unsigned int i = 0; i < numRefDataVals; ++i)
+					{
+						double val = refWindow[b][i] - offset;
+						sumR += val;
+						sumRSq += (val * val);
+					}
+				}
+				
+				// Summed area tables of the (offset) floating values and their squares, over all bands.
+				unsigned int satWidth = floatWidth + 1;
+				std::vector<double> satF(satWidth * (floatHeight + 1), 0.0);
+				std::vector<double> satFSq(satWidth * (floatHeight + 1), 0.0);
+				for(unsigned int y = 0; y < floatHeight; ++y)
+				{
+					double rowSum = 0;
+					double rowSumSq = 0;
+					for(unsigned int x = 0; x < floatWidth; ++x)
+					{
+						for(unsigned int b = 0; b < numBands; ++b)
+						{
+							double val = floatWindow[b][(y * floatWidth) + x] - offset;
+							rowSum += val;
+							rowSumSq += (val * val);
+						}
+						satF[((y + 1) * satWidth) + (x + 1)] = satF[(y * satWidth) + (x + 1)] + rowSum;
+						satFSq[((y + 1) * satWidth) + (x + 1)] = satFSq[(y * satWidth) + (x + 1)] + rowSumSq;
+					}
+				}
+				
+				// Cross products of the reference window with the floating window at every offset.
+				unsigned int crossWidth = floatWidth - refWidth + 1;
+				unsigned int crossHeight = floatHeight - refHeight + 1;
+				std::vector<double> crossRF(crossWidth * crossHeight);
+				RSGISFFTCrossCorrelation fftCrossCorr;
+				fftCrossCorr.crossCorrelate(refWindow, refWidth, refHeight, floatWindow, floatWidth, floatHeight, numBands, offset, crossRF.data());
+				
+				for(unsigned int yIdx = 0; yIdx < numSearchPoints; ++yIdx)
+				{
+					for(unsigned int xIdx = 0; xIdx < numSearchPoints; ++xIdx)
+					{
+						idx = (yIdx * numSearchPoints) + xIdx;
+						if(validShift[idx])
+						{
+							unsigned int u = floatXOff[idx] - floatMinX;
+							unsigned int v = floatYOff[idx] - floatMinY;
+							unsigned int tl = (v * satWidth) + u;
+							unsigned int tr = (v * satWidth) + u + refWidth;
+							unsigned int bl = ((v + refHeight) * satWidth) + u;
+							unsigned int br = ((v + refHeight) * satWidth) + u + refWidth;
+							double sumF = satF[br] - satF[tr] - satF[bl] + satF[tl];
+							double sumFSq = satFSq[br] - satFSq[tr] - satFSq[bl] + satFSq[tl];
+							double sumRF = crossRF[(v * crossWidth) + u];
+							
+							imageSimilarity[yIdx][xIdx] = metric->calcValueFromSums(n, sumR, sumF, sumRSq, sumFSq, sumRF);
+						}
+					}
+				}
+			}
+			else
+			{
+				std::vector<std::vector<float> > refDataVals(numBands, std::vector<float>(numRefDataVals));
+				std::vector<std::vector<float> > floatDataVals(numBands, std::vector<float>(numRefDataVals));
+				std::vector<float*> refDataBlock(numBands);
+				std::vector<float*> floatDataBlock(numBands);
+				for(unsigned int b = 0; b < numBands; ++b)
+				{
+					refDataBlock[b] = refDataVals[b].data();
+					floatDataBlock[b] = floatDataVals[b].data();
+				}
+				
+				for(unsigned int yIdx = 0; yIdx < numSearchPoints; ++yIdx)
+				{
+					for(unsigned int xIdx = 0; xIdx < numSearchPoints; ++xIdx)
+					{
+						idx = (yIdx * numSearchPoints) + xIdx;
+						if(validShift[idx])
+						{
+							unsigned int numDataVals = 0;
+							for(int y = 0; y < shiftHeight[idx]; ++y)
+							{
+								unsigned int refRow = ((refYOff[idx] - refMinY) + y) * refWidth;
+								unsigned int floatRow = ((floatYOff[idx] - floatMinY) + y) * floatWidth;
+								for(int x = 0; x < shiftWidth[idx]; ++x)
+								{
+									for(unsigned int b = 0; b < numBands; ++b)
+									{
+										refDataBlock[b][numDataVals] = refWindow[b][refRow + (refXOff[idx] - refMinX) + x];
+										floatDataBlock[b][numDataVals] = floatWindow[b][floatRow + (floatXOff[idx] - floatMinX) + x];
+									}
+									++numDataVals;
+								}
+							}
+							
+							imageSimilarity[yIdx][xIdx] = metric->calcValue(refDataBlock.data(), floatDataBlock.data(), numDataVals, numBands);
+						}
+					}
+				}
+			}
+		}
+		catch(...)
+		{
+			if(refWindow != NULL)
+			{
+				for(unsigned int b = 0; b < overlap->numRefBands; ++b)
+				{
+					delete[] refWindow[b];
+				}
+				delete[] refWindow;
+			}
+			if(floatWindow != NULL)
+			{
+				for(unsigned int b = 0; b < overlap->numFloatBands; ++b)
+				{
+					delete[] floatWindow[b];
+				}
+				delete[] floatWindow;
+			}
+			throw;
+		}
+		
+		for(unsigned int b = 0; b < overlap->numRefBands; ++b)
+		{
+			delete[] refWindow[b];
+		}
+		for(unsigned int b = 0; b < overlap->numFloatBands; ++b)
+		{
+			delete[] floatWindow[b];
+		}
+		delete[] refWindow;
+		delete[] floatWindow;
+	}
+	
+	void RSGISImageRegistration::calcTiePointSimilaritySurface(double eastings, double northings, unsigned int windowSize, unsigned int searchArea, RSGISImageSimilarityMetric *metric, float **imageSimilarity)
+	{
+		if(!overlapDefined)
+		{
+			this->findOverlap();
+		}
+		
+		TiePoint tiePt = TiePoint();
+		tiePt.eastings = eastings;
+		tiePt.northings = northings;
+		tiePt.xShift = 0;
+		tiePt.yShift = 0;
+		
+		double windowXWidth = (((double)windowSize)*overlap->xRes);
+		double windowYHeight = (((double)windowSize)*overlap->yRes);
+		
+		OGREnvelope env = OGREnvelope();
+		env.MinX = (eastings - windowXWidth);
+		env.MaxX = (eastings + windowXWidth + overlap->xRes);
+		env.MinY = (northings - windowYHeight);
+		env.MaxY = (northings + windowYHeight + overlap->yRes);
+		
+		unsigned int numSearchPoints = (searchArea*2)+1;
+		std::vector<std::vector<float> > remainderXVals(numSearchPoints, std::vector<float>(numSearchPoints));
+		std::vector<std::vector<float> > remainderYVals(numSearchPoints, std::vector<float>(numSearchPoints));
+		std::vector<float*> remainderX(numSearchPoints);
+		std::vector<float*> remainderY(numSearchPoints);
+		for(unsigned int i = 0; i < numSearchPoints; ++i)
+		{
+			remainderX[i] = remainderXVals[i].data();
+			remainderY[i] = remainderYVals[i].data();
+		}
+		
+		this->calcSimilaritySurface(&tiePt, &env, searchArea, metric, imageSimilarity, remainderX.data(), remainderY.data(), referenceIMG, floatingIMG);
+	}
+	
 	float RSGISImageRegistration::findExtreme(bool findMin, gsl_vector *coefficients, unsigned int order, float minRange, float maxRange, unsigned int resolution, float *extremeVal)
 	{
 		double division = ((float)1)/((float)resolution);
@@ -1029,191 +1397,181 @@ namespace rsgis{namespace reg{
 		{
 			throw RSGISRegistrationException("The overlap needs to be defined.");
 		}
-		double *refTransform = new double[6];
-		double *floatTransform = new double[6];
-		try 
+		// Transformations and sizes cached by findOverlap (this is called from the worker threads).
+		double refTransform[6];
+		double floatTransform[6];
+		for(int i = 0; i < 6; ++i)
 		{
-			// Find transformations
-			referenceIMG->GetGeoTransform(refTransform);
-			int refSizeX = referenceIMG->GetRasterXSize();
-			int refSizeY = referenceIMG->GetRasterYSize();
-			
-			floatingIMG->GetGeoTransform(floatTransform);
-			int floatSizeX = floatingIMG->GetRasterXSize();
-			int floatSizeY = floatingIMG->GetRasterYSize();
-			
-			// Apply Shift
-			floatTransform[0] += (((float)xShift)*overlap->xRes);
-			floatTransform[3] -= (((float)yShift)*overlap->yRes);
-			
-			// Define spatial boundary of each image
-			double refTLX = refTransform[0];
-			double refTLY = refTransform[3];
-			double refBRX = refTransform[0] + (refSizeX * overlap->xRes);
-			double refBRY = refTransform[3] - (refSizeY * overlap->xRes);
-			
-			double floatTLX = floatTransform[0];
-			double floatTLY = floatTransform[3];
-			double floatBRX = floatTransform[0] + (floatSizeX * overlap->xRes);
-			double floatBRY = floatTransform[3] - (floatSizeY * overlap->xRes);
-			
-			// Define the overlapping region
-			double tlX = 0;
-			double tlY = 0;
-			double brX = 0;
-			double brY = 0;
-			
-			if(refTLX > floatTLX)
-			{
-				tlX = refTLX;
-			}
-			else
-			{
-				tlX = floatTLX;
-			}
-			
-			if(refTLY < floatTLY)
-			{
-				tlY = refTLY;
-			}
-			else 
-			{
-				tlY = floatTLY;
-			}
-
-			if(refBRX < floatBRX)
-			{
-				brX = refBRX;
-			}
-			else
-			{
-				brX = floatBRX;
-			}
-			
-			if(refBRY > floatBRY)
-			{
-				brY = refBRY;
-			}
-			else
-			{
-				brY = floatBRY;
-			}
-			
-			// Check the images (with shift) overlap
-			if((brX - tlX) <= 0)
-			{
-				throw RSGISRegistrationException("Images do not overlap in the X axis.");
-			}
-			
-			if((tlY - brY) <= 0)
-			{
-				throw RSGISRegistrationException("Images do not overlap in the Y axis.");
-			}
-			
-			// Check whether the overlapping region intersects within the Envelop
-            OGREnvelope overlapEnv = OGREnvelope();
-            overlapEnv.MinX = tlX;
-            overlapEnv.MaxX = brX;
-            overlapEnv.MinY = brY;
-            overlapEnv.MaxY = tlY;
+			refTransform[i] = refImgTransform[i];
+			floatTransform[i] = floatImgTransform[i];
+		}
+		int refSizeX = refImgSizeX;
+		int refSizeY = refImgSizeY;
+		int floatSizeX = floatImgSizeX;
+		int floatSizeY = floatImgSizeY;
+		
+		// Apply Shift
+		floatTransform[0] += (((float)xShift)*overlap->xRes);
+		floatTransform[3] -= (((float)yShift)*overlap->yRes);
+		
+		// Define spatial boundary of each image
+		double refTLX = refTransform[0];
+		double refTLY = refTransform[3];
+		double refBRX = refTransform[0] + (refSizeX * overlap->xRes);
+		double refBRY = refTransform[3] - (refSizeY * overlap->xRes);
+		
+		double floatTLX = floatTransform[0];
+		double floatTLY = floatTransform[3];
+		double floatBRX = floatTransform[0] + (floatSizeX * overlap->xRes);
+		double floatBRY = floatTransform[3] - (floatSizeY * overlap->xRes);
+		
+		// Define the overlapping region
+		double tlX = 0;
+		double tlY = 0;
+		double brX = 0;
+		double brY = 0;
+		
+		if(refTLX > floatTLX)
+		{
+			tlX = refTLX;
+		}
+		else
+		{
+			tlX = floatTLX;
+		}
+		
+		if(refTLY < floatTLY)
+		{
+			tlY = refTLY;
+		}
+		else 
+		{
+			tlY = floatTLY;
+		}
 
-			if(!env->Intersects(overlapEnv))
-			{
-				throw RSGISRegistrationException("The overlapping region of the images does not intersect with the envelop provided");
-			}
-			
-			// Trim to region overlapping with the envelop
-			if(tlX < env->MinX)
-			{
-				tlX = env->MinX;
-			}
-			
-			if(tlY > env->MaxY)
-			{
-				tlY = env->MaxY;
-			}
-			
-			if(brX > env->MaxX)
-			{
-				brX = env->MaxX;
-			}
-			
-			if(brY < env->MinY)
-			{
-				brY = env->MinY;
-			}
+		if(refBRX < floatBRX)
+		{
+			brX = refBRX;
+		}
+		else
+		{
+			brX = floatBRX;
+		}
+		
+		if(refBRY > floatBRY)
+		{
+			brY = refBRY;
+		}
+		else
+		{
+			brY = floatBRY;
+		}
+		
+		// Check the images (with shift) overlap
+		if((brX - tlX) <= 0)
+		{
+			throw RSGISRegistrationException("Images do not overlap in the X axis.");
+		}
+		
+		if((tlY - brY) <= 0)
+		{
+			throw RSGISRegistrationException("Images do not overlap in the Y axis.");
+		}
+		
+		// Check whether the overlapping region intersects within the Envelop
+        OGREnvelope overlapEnv = OGREnvelope();
+        overlapEnv.MinX = tlX;
+        overlapEnv.MaxX = brX;
+        overlapEnv.MinY = brY;
+        overlapEnv.MaxY = tlY;
 
-			
-			// Define output values.
-			gdalTransform[0] = tlX;
-			gdalTransform[1] = overlap->xRes;
-			gdalTransform[2] = overlap->xRot;
-			gdalTransform[3] = tlY;
-			gdalTransform[4] = overlap->yRot;
-			gdalTransform[5] = overlap->yRes;
-			
-			*width = floor(((brX - tlX)/overlap->xRes)+0.5);
-			*height = floor(((tlY - brY)/overlap->yRes)+0.5);
-            
-			double diffX = 0;
-			double diffY = 0;
-			
-			// Define reference offsets
-			diffX = tlX - refTransform[0];
-			diffY = refTransform[3] - tlY;
-            
-            if(!((diffX > -0.0001) & (diffX < 0.0001)))
-            {
-                dsOffsets[0][0] = floor((diffX/overlap->xRes));
-            }
-            else
-            {
-                dsOffsets[0][0] = 0;
-            }
-            
-            if(!((diffY > -0.0001) & (diffY < 0.0001)))
-            {
-                dsOffsets[0][1] = floor((diffY/overlap->yRes));
-            }
-            else
-            {
-                dsOffsets[0][1] = 0;
-            }
-			
-			// Define floating offsets
-			diffX = tlX - floatTransform[0];
-			diffY = floatTransform[3] - tlY;
-            if(!((diffX > -0.0001) & (diffX < 0.0001)))
-            {
-                dsOffsets[1][0] = floor((diffX/overlap->xRes));
-                *remainderX = (diffX/overlap->xRes) - dsOffsets[1][0];
-            }
-            else
-            {
-                dsOffsets[1][0] = 0;
-                *remainderX = 0;
-            }
-            
-            if(!((diffY > -0.0001) & (diffY < 0.0001)))
-            {
-                dsOffsets[1][1] = floor((diffY/overlap->yRes));
-                *remainderY = (diffY/overlap->yRes) - dsOffsets[1][1];
-            }
-            else
-            {
-                dsOffsets[1][1] = 0;
-                *remainderY = 0;
-            }
+		if(!env->Intersects(overlapEnv))
+		{
+			throw RSGISRegistrationException("The overlapping region of the images does not intersect with the envelop provided");
 		}
-		catch(RSGISRegistrationException &e)
+		
+		// Trim to region overlapping with the envelop
+		if(tlX < env->MinX)
 		{
-			delete[] refTransform;
-			delete[] floatTransform;
-			throw e;
+			tlX = env->MinX;
+		}
+		
+		if(tlY > env->MaxY)
+		{
+			tlY = env->MaxY;
+		}
+		
+		if(brX > env->MaxX)
+		{
+			brX = env->MaxX;
+		}
+		
+		if(brY < env->MinY)
+		{
+			brY = env->MinY;
 		}
-		delete[] refTransform;
-		delete[] floatTransform;
 
+		
+		// Define output values.
+		gdalTransform[0] = tlX;
+		gdalTransform[1] = overlap->xRes;
+		gdalTransform[2] = overlap->xRot;
+		gdalTransform[3] = tlY;
+		gdalTransform[4] = overlap->yRot;
+		gdalTransform[5] = overlap->yRes;
+		
+		*width = floor(((brX - tlX)/overlap->xRes)+0.5);
+		*height = floor(((tlY - brY)/overlap->yRes)+0.5);
+        
+		double diffX = 0;
+		double diffY = 0;
+		
+		// Define reference offsets
+		diffX = tlX - refTransform[0];
+		diffY = refTransform[3] - tlY;
+        
+        if(!((diffX > -0.0001) & (diffX < 0.0001)))
+        {
+            dsOffsets[0][0] = floor((diffX/overlap->xRes));
+        }
+        else
+        {
+            dsOffsets[0][0] = 0;
+        }
+        
+        if(!((diffY > -0.0001) & (diffY < 0.0001)))
+        {
+            dsOffsets[0][1] = floor((diffY/overlap->yRes));
+        }
+        else
+        {
+            dsOffsets[0][1] = 0;
+        }
+		
+		// Define floating offsets
+		diffX = tlX - floatTransform[0];
+		diffY = floatTransform[3] - tlY;
+        if(!((diffX > -0.0001) & (diffX < 0.0001)))
+        {
+            dsOffsets[1][0] = floor((diffX/overlap->xRes));
+            *remainderX = (diffX/overlap->xRes) - dsOffsets[1][0];
+        }
+        else
+        {
+            dsOffsets[1][0] = 0;
+            *remainderX = 0;
+        }
+        
+        if(!((diffY > -0.0001) & (diffY < 0.0001)))
+        {
+            dsOffsets[1][1] = floor((diffY/overlap->yRes));
+            *remainderY = (diffY/overlap->yRes) - dsOffsets[1][1];
+        }
+        else
+        {
+            dsOffsets[1][1] = 0;
+            *remainderY = 0;
+        }
 	}
 	
 	void RSGISImageRegistration::removeTiePointsWithLowStdDev(std::list<TiePoint*> *tiePts, unsigned int windowSize, float stdDevRefThreshold, float stdDevFloatThreshold)
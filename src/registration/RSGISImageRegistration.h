@@ -30,13 +30,22 @@
 #include <string>
 #include <cmath>
 #include <list>
+#include <vector>
+#include <limits>
+#include <algorithm>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <exception>
 
 #include "gdal_priv.h"
 #include "ogrsf_frmts.h"
 
+#include "common/rsgis-tqdm.h"
 #include "common/RSGISRegistrationException.h"
 
 #include "registration/RSGISImageSimilarityMetric.h"
+#include "registration/RSGISFFTCrossCorrelation.h"
 
 #include "img/RSGISImageBandException.h"
 #include "img/RSGISImageUtils.h"
@@ -143,12 +152,28 @@ namespace rsgis{namespace reg{
 		virtual void exportTiePointsENVIImage2Image(std::string filepath)=0;
 		virtual void exportTiePointsRSGISImage2Map(std::string filepath)=0;
         virtual void exportTiePointsRSGISMapOffs(std::string filepath)=0;
+        /**
+         * Calculate the metric for every whole pixel shift (-searchArea to searchArea) of the
+         * floating image for the window (windowSize pixels either side) around the point
+         * (eastings, northings), as used to locate a tie point. imageSimilarity must be
+         * (searchArea*2)+1 rows (y shift) by (searchArea*2)+1 columns (x shift); shifts where
+         * the images do not overlap within the window are NaN.
+         */
+        void calcTiePointSimilaritySurface(double eastings, double northings, unsigned int windowSize, unsigned int searchArea, RSGISImageSimilarityMetric *metric, float **imageSimilarity);
 		virtual ~RSGISImageRegistration();
 	protected:
 		void findOverlap();
 		void defineFirstTiePoint(unsigned int *startXOff, unsigned int *startYOff, unsigned int numXPts, unsigned int numYPts, unsigned int gap);
-		float findTiePointLocation(TiePoint *tiePt, unsigned int windowSize, unsigned int searchArea, RSGISImageSimilarityMetric *metric, float metricThreshold, unsigned int subPixelResolution, float *moveInX, float *moveInY);
-        float findTiePointLocation(TiePoint *tiePt, unsigned int windowSize, unsigned int searchArea, RSGISImageSimilarityMetric *metric, unsigned int subPixelResolution, float *moveInX, float *moveInY);
+		float findTiePointLocation(TiePoint *tiePt, unsigned int windowSize, unsigned int searchArea, RSGISImageSimilarityMetric *metric, float metricThreshold, unsigned int subPixelResolution, float *moveInX, float *moveInY, GDALDataset *refDataset=NULL, GDALDataset *floatDataset=NULL);
+        float findTiePointLocation(TiePoint *tiePt, unsigned int windowSize, unsigned int searchArea, RSGISImageSimilarityMetric *metric, unsigned int subPixelResolution, float *moveInX, float *moveInY, GDALDataset *refDataset=NULL, GDALDataset *floatDataset=NULL);
+        /**
+         * Find the location of each of the tie points (as findTiePointLocation, with the metric
+         * threshold if useThreshold is true) using numThreads threads. With more than one thread
+         * each thread opens its own handles on the reference and floating images. The distance
+         * moved and shift of each tie point are returned in the order of tiePts.
+         */
+        void findTiePointLocations(std::vector<TiePoint*> *tiePts, unsigned int windowSize, unsigned int searchArea, RSGISImageSimilarityMetric *metric, bool useThreshold, float metricThreshold, unsigned int subPixelResolution, unsigned int numThreads, std::vector<float> *distMoved, std::vector<float> *moveInX, std::vector<float> *moveInY);
+		void calcSimilaritySurface(TiePoint *tiePt, OGREnvelope *env, unsigned int searchArea, RSGISImageSimilarityMetric *metric, float **imageSimilarity, float **remainderX, float **remainderY, GDALDataset *refDataset, GDALDataset *floatDataset);
 		float findExtreme(bool findMin, gsl_vector *coefficients, unsigned int order, float minRange, float maxRange, unsigned int resolution, float *extremeVal);
         void getImageOverlapFloat(GDALDataset **datasets, int numDS,  float **dsOffsets, int *width, int *height, double *gdalTransform);
 		void getImageOverlapWithFloatShift(float xShift, float yShift, int **dsOffsets, int *width, int *height, double *gdalTransform, OGREnvelope *env, float *remainderX, float *remainderY);
@@ -162,6 +187,13 @@ namespace rsgis{namespace reg{
 		GDALDataset *floatingIMG;
 		OverlapRegion* overlap;
 		bool overlapDefined;
+        /** Cached by findOverlap so the worker threads do not need to query the shared datasets. */
+        double refImgTransform[6];
+        double floatImgTransform[6];
+        int refImgSizeX;
+        int refImgSizeY;
+        int floatImgSizeX;
+        int floatImgSizeY;
 	};
 }}
 
@@ -50,6 +50,19 @@ namespace rsgis{namespace reg{
 	public:
 		virtual float calcValue(float **reference, float **floating, unsigned int numVals, unsigned int numDims)=0;
 		virtual bool findMin()=0;
+		/** Returns true if the metric can be calculated with calcValueFromSums. */
+		virtual bool calcFromSums(){return false;};
+		/**
+		 * Calculate the metric from the number of (reference, floating) value pairs and the sums
+		 * of the reference, floating, squared reference, squared floating and product values,
+		 * allowing a surface of values to be calculated without revisiting the image data.
+		 * The sums may be of values with the same offset subtracted from both images, so the
+		 * metric must not change when both images are offset.
+		 */
+		virtual float calcValueFromSums(double n, double sumR, double sumF, double sumRSq, double sumFSq, double sumRF)
+		{
+			throw rsgis::math::RSGISMathException("The metric cannot be calculated from the sums of the values.");
+		};
 		virtual ~RSGISImageSimilarityMetric(){};
 	};
 
@@ -27,7 +27,7 @@
 
 namespace rsgis{namespace reg{
 	
-	RSGISSingleConnectLayerImageRegistration::RSGISSingleConnectLayerImageRegistration(GDALDataset *reference, GDALDataset *floating, unsigned int gap, float metricThreshold, unsigned int windowSize, unsigned int searchArea, RSGISImageSimilarityMetric *metric, float stdDevRefThreshold, float stdDevFloatThreshold, unsigned int subPixelResolution, float distanceThreshold, unsigned int maxNumIterations, float moveChangeThreshold, float pSmoothness):RSGISImageRegistration(reference, floating), tiePoints(NULL), gap(1), metricThreshold(0), initExecuted(false), windowSize(0), searchArea(0), metric(NULL), stdDevRefThreshold(0), stdDevFloatThreshold(0), subPixelResolution(0), distanceThreshold(0), maxNumIterations(10), moveChangeThreshold(0), pSmoothness(0)
+	RSGISSingleConnectLayerImageRegistration::RSGISSingleConnectLayerImageRegistration(GDALDataset *reference, GDALDataset *floating, unsigned int gap, float metricThreshold, unsigned int windowSize, unsigned int searchArea, RSGISImageSimilarityMetric *metric, float stdDevRefThreshold, float stdDevFloatThreshold, unsigned int subPixelResolution, float distanceThreshold, unsigned int maxNumIterations, float moveChangeThreshold, float pSmoothness, unsigned int numThreads):RSGISImageRegistration(reference, floating), tiePoints(NULL), gap(1), metricThreshold(0), initExecuted(false), windowSize(0), searchArea(0), metric(NULL), stdDevRefThreshold(0), stdDevFloatThreshold(0), subPixelResolution(0), distanceThreshold(0), maxNumIterations(10), moveChangeThreshold(0), pSmoothness(0), numThreads(1)
 	{
 		tiePoints = new std::list<TiePointInSingleLayer*>();
 		this->gap = gap;
@@ -42,6 +42,7 @@ namespace rsgis{namespace reg{
 		this->maxNumIterations = maxNumIterations;
 		this->moveChangeThreshold = moveChangeThreshold;
 		this->pSmoothness = pSmoothness;
+		this->numThreads = numThreads;
 	}
 	
 	void RSGISSingleConnectLayerImageRegistration::initRegistration()
@@ -150,16 +151,6 @@ namespace rsgis{namespace reg{
 			throw RSGISRegistrationException("The algorithm needs to be initialised before being executed.");
 		}
 		
-		unsigned int counter = 0;
-		unsigned int feedback = 0;
-		unsigned int feedbackVal = 0;
-		bool giveFeedback = false;
-		if(tiePoints->size() > 10)
-		{
-			feedback = tiePoints->size()/10;
-			giveFeedback = true;
-		}		
-		
 		float xShift = 0;
 		float yShift = 0;
 		double totalMovement = 0;
@@ -172,28 +163,37 @@ namespace rsgis{namespace reg{
 		bool first = true;
 		float prevAverage = 0;
 		
-		std::list<TiePointInSingleLayer*>::iterator iterTiePts;
 		std::list<TiePoint*>::iterator iterNrTiePts;
-            
+		
+		std::vector<TiePointInSingleLayer*> layerTiePts(tiePoints->begin(), tiePoints->end());
+		std::vector<TiePoint*> tiePtsVec;
+		tiePtsVec.reserve(layerTiePts.size());
+		for(std::vector<TiePointInSingleLayer*>::iterator iterTiePts = layerTiePts.begin(); iterTiePts != layerTiePts.end(); ++iterTiePts)
+		{
+			tiePtsVec.push_back((*iterTiePts)->tiePt);
+		}
+		std::vector<float> distMoved;
+		std::vector<float> xShifts;
+		std::vector<float> yShifts;
         
 		for(unsigned int i = 0; i < maxNumIterations; ++i)
 		{
-			std::cout << "Started (Iteration " << i << ")." << std::flush;
+			std::cout << "Started (Iteration " << i << ")\n";
 			totalMovement = 0;
-			counter = 0;
-			feedbackVal = 0;
-			for(iterTiePts = tiePoints->begin(); iterTiePts != tiePoints->end(); ++iterTiePts)
+			
+			// Within an iteration the tie points are independent so are found in parallel, using the
+			// shifts from the previous iteration, and the neighbours updated afterwards in a fixed order.
+			this->findTiePointLocations(&tiePtsVec, windowSize, searchArea, metric, true, metricThreshold, subPixelResolution, numThreads, &distMoved, &xShifts, &yShifts);
+			
+			for(size_t n = 0; n < layerTiePts.size(); ++n)
 			{
-				if(giveFeedback && ((counter % feedback) == 0))
-				{
-					std::cout << "." << feedbackVal << "." << std::flush;
-					feedbackVal += 10;
-				}
-                totalMovement += this->findTiePointLocation((*iterTiePts)->tiePt, windowSize, searchArea, metric, metricThreshold, subPixelResolution, &xShift, &yShift);
+				totalMovement += distMoved[n];
+				xShift = xShifts[n];
+				yShift = yShifts[n];
 
-                for(iterNrTiePts = (*iterTiePts)->nrTiePts->begin(); iterNrTiePts != (*iterTiePts)->nrTiePts->end(); ++iterNrTiePts)
+                for(iterNrTiePts = layerTiePts[n]->nrTiePts->begin(); iterNrTiePts != layerTiePts[n]->nrTiePts->end(); ++iterNrTiePts)
                 {
-					distance = (*iterTiePts)->tiePt->floatDistance((*iterNrTiePts));
+					distance = layerTiePts[n]->tiePt->floatDistance((*iterNrTiePts));
 					if(distance < 1)
 					{
 						invDist = 1;
@@ -209,10 +209,9 @@ namespace rsgis{namespace reg{
 					(*iterNrTiePts)->xShift += invDist*xShiftDiff;
 					(*iterNrTiePts)->yShift += invDist*yShiftDiff;
 				}
-				++counter;
 			}
 			averageMovement = totalMovement/tiePoints->size();
-			std::cout << ". Complete - Movement = "<< averageMovement << std::endl;
+			std::cout << "Complete - Movement = "<< averageMovement << std::endl;
 			if(first)
 			{
 				prevAverage = averageMovement;
@@ -30,6 +30,7 @@
 #include <string>
 #include <cmath>
 #include <list>
+#include <vector>
 
 #include "gdal_priv.h"
 #include "ogrsf_frmts.h"
@@ -64,7 +65,7 @@ namespace rsgis{namespace reg{
 			std::list<TiePoint*> *nrTiePts;
 		};
 		
-		RSGISSingleConnectLayerImageRegistration(GDALDataset *reference, GDALDataset *floating, unsigned int gap, float metricThreshold, unsigned int windowSize, unsigned int searchArea, RSGISImageSimilarityMetric *metric, float stdDevRefThreshold, float stdDevFloatThreshold, unsigned int subPixelResolution, float distanceThreshold, unsigned int maxNumIterations, float moveChangeThreshold, float pSmoothness);
+		RSGISSingleConnectLayerImageRegistration(GDALDataset *reference, GDALDataset *floating, unsigned int gap, float metricThreshold, unsigned int windowSize, unsigned int searchArea, RSGISImageSimilarityMetric *metric, float stdDevRefThreshold, float stdDevFloatThreshold, unsigned int subPixelResolution, float distanceThreshold, unsigned int maxNumIterations, float moveChangeThreshold, float pSmoothness, unsigned int numThreads=1);
 		void initRegistration();
 		void executeRegistration();
 		void finaliseRegistration();
@@ -88,6 +89,7 @@ namespace rsgis{namespace reg{
 		unsigned int maxNumIterations;
 		float moveChangeThreshold;
 		float pSmoothness;
+		unsigned int numThreads;
 	};
 }}
 
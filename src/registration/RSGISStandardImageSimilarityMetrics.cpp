@@ -47,6 +47,16 @@ namespace rsgis{namespace reg{
 		
 		return sqrt(sqDiff/totalNumVals);
 	}
+
+	float RSGISEuclideanSimilarityMetric::calcValueFromSums(double n, double sumR, double sumF, double sumRSq, double sumFSq, double sumRF)
+	{
+		double sqDiff = sumRSq + sumFSq - (2 * sumRF);
+		if(sqDiff < 0)
+		{
+			sqDiff = 0;
+		}
+		return sqrt(sqDiff/n);
+	}
 	
 	float RSGISSquaredDifferenceSimilarityMetric::calcValue(float **reference, float **floating, unsigned int numVals, unsigned int numDims)
 	{
@@ -68,6 +78,16 @@ namespace rsgis{namespace reg{
 		
 		return sqDiff/totalNumVals;
 	}
+
+	float RSGISSquaredDifferenceSimilarityMetric::calcValueFromSums(double n, double sumR, double sumF, double sumRSq, double sumFSq, double sumRF)
+	{
+		double sqDiff = sumRSq + sumFSq - (2 * sumRF);
+		if(sqDiff < 0)
+		{
+			sqDiff = 0;
+		}
+		return sqDiff/n;
+	}
 	
 	float RSGISManhattanSimilarityMetric::calcValue(float **reference, float **floating, unsigned int numVals, unsigned int numDims)
 	{
@@ -126,6 +146,18 @@ namespace rsgis{namespace reg{
 		return val;
 	}
 
+	float RSGISCorrelationSimilarityMetric::calcValueFromSums(double n, double sumR, double sumF, double sumRSq, double sumFSq, double sumRF)
+	{
+		float val = (((n * sumRF) - (sumR * sumF))/sqrt(((n*sumRSq)-(sumR*sumR))*((n*sumFSq)-(sumF*sumF))));
+        
+        if(val < 0)
+        {
+            val *= -1;
+        }
+		
+		return val;
+	}
+
 
 
 
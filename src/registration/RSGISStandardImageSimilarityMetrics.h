@@ -54,6 +54,8 @@ namespace rsgis{namespace reg{
 		RSGISEuclideanSimilarityMetric(){};
 		float calcValue(float **reference, float **floating, unsigned int numVals, unsigned int numDims);
 		bool findMin(){return true;};
+		bool calcFromSums(){return true;};
+		float calcValueFromSums(double n, double sumR, double sumF, double sumRSq, double sumFSq, double sumRF);
 		~RSGISEuclideanSimilarityMetric(){};
 	};
 
@@ -72,6 +74,8 @@ namespace rsgis{namespace reg{
 		RSGISSquaredDifferenceSimilarityMetric(){};
 		float calcValue(float **reference, float **floating, unsigned int numVals, unsigned int numDims);
 		bool findMin(){return true;};
+		bool calcFromSums(){return true;};
+		float calcValueFromSums(double n, double sumR, double sumF, double sumRSq, double sumFSq, double sumRF);
 		~RSGISSquaredDifferenceSimilarityMetric(){};
 	};
 
@@ -81,6 +85,8 @@ namespace rsgis{namespace reg{
 		RSGISCorrelationSimilarityMetric(){};
 		float calcValue(float **reference, float **floating, unsigned int numVals, unsigned int numDims);
 		bool findMin(){return false;};
+		bool calcFromSums(){return true;};
+		float calcValueFromSums(double n, double sumR, double sumF, double sumRSq, double sumFSq, double sumRF);
 		~RSGISCorrelationSimilarityMetric(){};
 	};
 
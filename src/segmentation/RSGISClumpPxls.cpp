@@ -30,7 +30,7 @@ namespace rsgis{namespace segment{
         
     }
         
-    void RSGISClumpPxls::performClump(GDALDataset *catagories, GDALDataset *clumps, bool noDataValProvided, unsigned int noDataVal, std::vector<unsigned int> *clumpPxlVals) 
+    void RSGISClumpPxls::performClump(GDALDataset *catagories, GDALDataset *clumps, bool noDataValProvided, unsigned int noDataVal, std::vector<unsigned int> *clumpPxlVals, bool use8Conn, unsigned int numThreads) 
     {
         if(catagories->GetRasterXSize() != clumps->GetRasterXSize())
         {
@@ -41,151 +41,35 @@ namespace rsgis{namespace segment{
             throw rsgis::img::RSGISImageCalcException("Heights are not the same");
         }
         
-        rsgis::img::RSGISImageUtils imgUtils;
-        imgUtils.zerosUIntGDALDataset(clumps);
-        
         unsigned int width = catagories->GetRasterXSize();
         unsigned int height = catagories->GetRasterYSize();
         
         GDALRasterBand *catagoryBand = catagories->GetRasterBand(1);
         GDALRasterBand *clumpBand = clumps->GetRasterBand(1);
+        int xOff = 0;
+        int yOff = 0;
         
-        unsigned long clumpIdx = 1;
-        std::vector<rsgis::img::PxlLoc> clumpPxls;
-        std::queue<rsgis::img::PxlLoc> clumpSearchPxls;
-        unsigned int catPxlVal = 0;
-        unsigned int catCPxlVal = 0;
-        
-        unsigned int uiPxlVal = 0;
-        
-        rsgis_tqdm pbar;
-        for(unsigned int i = 0; i < height; ++i)
+        unsigned long numClumps = 0;
+        if(numThreads > 1)
         {
-            pbar.progress(i, height);
-            
-            for(unsigned int j = 0; j < width; ++j)
-            {
-                // Get pixel value from clump image for (j,i)
-                clumpBand->RasterIO(GF_Read, j, i, 1, 1, &uiPxlVal, 1, 1, GDT_UInt32, 0, 0);
-                
-                // if value is zero create new clump
-                if(uiPxlVal == 0) 
-                {
-                    catagoryBand->RasterIO(GF_Read, j, i, 1, 1, &catPxlVal, 1, 1, GDT_UInt32, 0, 0);
-                    if((!noDataValProvided) | (noDataValProvided & (catPxlVal != noDataVal)))
-                    {     
-                        // Make sure all lists are empty.
-                        clumpPxls.clear();
-                        if(!clumpSearchPxls.empty())
-                        {
-                            while(clumpSearchPxls.size() > 0)
-                            {
-                                clumpSearchPxls.pop();
-                            }
-                        }
-                        
-                        if(clumpPxlVals != NULL)
-                        {
-                            clumpPxlVals->push_back(catPxlVal);
-                        }
-                            
-                        clumpPxls.push_back(rsgis::img::PxlLoc(j, i));
-                        clumpSearchPxls.push(rsgis::img::PxlLoc(j, i));
-                        clumpBand->RasterIO(GF_Write, j, i, 1, 1, &clumpIdx, 1, 1, GDT_UInt32, 0, 0);
-                        
-                        // Add neigbouring pixels to clump.
-                        // If no more pixels to add then stop.
-                        while(clumpSearchPxls.size() > 0)
-                        {
-                            rsgis::img::PxlLoc pxl = clumpSearchPxls.front();
-                            clumpSearchPxls.pop();
-                            
-                            // Above
-                            if(((long)pxl.yPos)-1 >= 0)
-                            {
-                                clumpBand->RasterIO(GF_Read, pxl.xPos, pxl.yPos-1, 1, 1, &uiPxlVal, 1, 1, GDT_UInt32, 0, 0);
-                                if(uiPxlVal == 0)
-                                {
-                                    catagoryBand->RasterIO(GF_Read, pxl.xPos, pxl.yPos-1, 1, 1, &catCPxlVal, 1, 1, GDT_UInt32, 0, 0);
-
-                                    if(catPxlVal == catCPxlVal)
-                                    {
-                                        clumpPxls.push_back(rsgis::img::PxlLoc(pxl.xPos, pxl.yPos-1));
-                                        clumpSearchPxls.push(rsgis::img::PxlLoc(pxl.xPos, pxl.yPos-1));
-                                        clumpBand->RasterIO(GF_Write, pxl.xPos, pxl.yPos-1, 1, 1, &clumpIdx, 1, 1, GDT_UInt32, 0, 0);
-                                    }
-                                }
-                            }
-                            // Below
-                            if((pxl.yPos+1) < height)
-                            {
-                                clumpBand->RasterIO(GF_Read, pxl.xPos, pxl.yPos+1, 1, 1, &uiPxlVal, 1, 1, GDT_UInt32, 0, 0);
-                                if(uiPxlVal == 0)
-                                {
-                                    catagoryBand->RasterIO(GF_Read, pxl.xPos, pxl.yPos+1, 1, 1, &catCPxlVal, 1, 1, GDT_UInt32, 0, 0);
-                                    
-                                    if(catPxlVal == catCPxlVal)
-                                    {
-                                        clumpPxls.push_back(rsgis::img::PxlLoc(pxl.xPos, pxl.yPos+1));
-                                        clumpSearchPxls.push(rsgis::img::PxlLoc(pxl.xPos, pxl.yPos+1));
-                                        clumpBand->RasterIO(GF_Write, pxl.xPos, pxl.yPos+1, 1, 1, &clumpIdx, 1, 1, GDT_UInt32, 0, 0);
-                                    }
-                                }
-                                
-                            }
-                            // Left
-                            if(((long)pxl.xPos)-1 >= 0)
-                            {
-                                clumpBand->RasterIO(GF_Read, pxl.xPos-1, pxl.yPos, 1, 1, &uiPxlVal, 1, 1, GDT_UInt32, 0, 0);
-                                if(uiPxlVal == 0)
-                                {
-                                    catagoryBand->RasterIO(GF_Read, pxl.xPos-1, pxl.yPos, 1, 1, &catCPxlVal, 1, 1, GDT_UInt32, 0, 0);
-                                    
-                                    if(catPxlVal == catCPxlVal)
-                                    {
-                                        clumpPxls.push_back(rsgis::img::PxlLoc(pxl.xPos-1, pxl.yPos));
-                                        clumpSearchPxls.push(rsgis::img::PxlLoc(pxl.xPos-1, pxl.yPos));
-                                        clumpBand->RasterIO(GF_Write, pxl.xPos-1, pxl.yPos, 1, 1, &clumpIdx, 1, 1, GDT_UInt32, 0, 0);
-                                    }
-                                }
-                            }
-                            // Right
-                            if((pxl.xPos+1) < width)
-                            {
-                                clumpBand->RasterIO(GF_Read, pxl.xPos+1, pxl.yPos, 1, 1, &uiPxlVal, 1, 1, GDT_UInt32, 0, 0);
-                                if(uiPxlVal == 0)
-                                {
-                                    catagoryBand->RasterIO(GF_Read, pxl.xPos+1, pxl.yPos, 1, 1, &catCPxlVal, 1, 1, GDT_UInt32, 0, 0);
-                                    
-                                    if(catPxlVal == catCPxlVal)
-                                    {
-                                        clumpPxls.push_back(rsgis::img::PxlLoc(pxl.xPos+1, pxl.yPos));
-                                        clumpSearchPxls.push(rsgis::img::PxlLoc(pxl.xPos+1, pxl.yPos));
-                                        clumpBand->RasterIO(GF_Write, pxl.xPos+1, pxl.yPos, 1, 1, &clumpIdx, 1, 1, GDT_UInt32, 0, 0);
-                                    }
-                                }
-                            }
-                        }
-                        
-                        ++clumpIdx;
-                    }
-                }
-            }
+            numClumps = this->performParallelScanlineClump(&catagoryBand, &xOff, &yOff, 1, clumpBand, width, height, noDataValProvided, noDataVal, use8Conn, clumpPxlVals, numThreads);
         }
-        pbar.finish();
-        std::cout << "(Generated " << clumpIdx-1 << " clumps).\n";
+        else
+        {
+            numClumps = this->performScanlineClump(&catagoryBand, &xOff, &yOff, 1, clumpBand, width, height, noDataValProvided, noDataVal, use8Conn, clumpPxlVals);
+        }
+        std::cout << "(Generated " << numClumps << " clumps).\n";
         if(clumpPxlVals != NULL)
         {
-            if(clumpPxlVals->size() != (clumpIdx-1))
+            if(clumpPxlVals->size() != numClumps)
             {
                 std::cout << "Number of clump pixel values: " << clumpPxlVals->size() << std::endl;
                 throw rsgis::img::RSGISImageCalcException("Number of clump pixel values in list is not equal to the number of clumps.");
             }
         }
-        
     }
     
-    void RSGISClumpPxls::performClumpPosVals(GDALDataset *catagories, GDALDataset *clumps) 
+    void RSGISClumpPxls::performClumpPosVals(GDALDataset *catagories, GDALDataset *clumps, bool use8Conn) 
     {
         if(catagories->GetRasterXSize() != clumps->GetRasterXSize())
         {
@@ -196,137 +80,20 @@ namespace rsgis{namespace segment{
             throw rsgis::img::RSGISImageCalcException("Heights are not the same");
         }
         
-        rsgis::img::RSGISImageUtils imgUtils;
-        imgUtils.zerosUIntGDALDataset(clumps);
-        
         unsigned int width = catagories->GetRasterXSize();
         unsigned int height = catagories->GetRasterYSize();
         
         GDALRasterBand *catagoryBand = catagories->GetRasterBand(1);
         GDALRasterBand *clumpBand = clumps->GetRasterBand(1);
+        int xOff = 0;
+        int yOff = 0;
         
-        unsigned long clumpIdx = 1;
-        std::vector<rsgis::img::PxlLoc> clumpPxls;
-        std::queue<rsgis::img::PxlLoc> clumpSearchPxls;
-        unsigned int catPxlVal = 0;
-        unsigned int catCPxlVal = 0;
-        
-        unsigned int uiPxlVal = 0;
-        
-        rsgis_tqdm pbar;
-        for(unsigned int i = 0; i < height; ++i)
-        {
-            pbar.progress(i, height);
-            
-            for(unsigned int j = 0; j < width; ++j)
-            {
-                // Get pixel value from clump image for (j,i)
-                clumpBand->RasterIO(GF_Read, j, i, 1, 1, &uiPxlVal, 1, 1, GDT_UInt32, 0, 0);
-                
-                // if value is zero create new clump
-                if(uiPxlVal == 0)
-                {
-                    catagoryBand->RasterIO(GF_Read, j, i, 1, 1, &catPxlVal, 1, 1, GDT_UInt32, 0, 0);
-                    if(catPxlVal > 0)
-                    {
-                        // Make sure all lists are empty.
-                        clumpPxls.clear();
-                        if(!clumpSearchPxls.empty())
-                        {
-                            while(clumpSearchPxls.size() > 0)
-                            {
-                                clumpSearchPxls.pop();
-                            }
-                        }
-                        
-                        clumpPxls.push_back(rsgis::img::PxlLoc(j, i));
-                        clumpSearchPxls.push(rsgis::img::PxlLoc(j, i));
-                        clumpBand->RasterIO(GF_Write, j, i, 1, 1, &clumpIdx, 1, 1, GDT_UInt32, 0, 0);
-                        
-                        // Add neigbouring pixels to clump.
-                        // If no more pixels to add then stop.
-                        while(clumpSearchPxls.size() > 0)
-                        {
-                            rsgis::img::PxlLoc pxl = clumpSearchPxls.front();
-                            clumpSearchPxls.pop();
-                            
-                            // Above
-                            if(((long)pxl.yPos)-1 >= 0)
-                            {
-                                clumpBand->RasterIO(GF_Read, pxl.xPos, pxl.yPos-1, 1, 1, &uiPxlVal, 1, 1, GDT_UInt32, 0, 0);
-                                if(uiPxlVal == 0)
-                                {
-                                    catagoryBand->RasterIO(GF_Read, pxl.xPos, pxl.yPos-1, 1, 1, &catCPxlVal, 1, 1, GDT_UInt32, 0, 0);
-                                    
-                                    if(catPxlVal == catCPxlVal)
-                                    {
-                                        clumpPxls.push_back(rsgis::img::PxlLoc(pxl.xPos, pxl.yPos-1));
-                                        clumpSearchPxls.push(rsgis::img::PxlLoc(pxl.xPos, pxl.yPos-1));
-                                        clumpBand->RasterIO(GF_Write, pxl.xPos, pxl.yPos-1, 1, 1, &clumpIdx, 1, 1, GDT_UInt32, 0, 0);
-                                    }
-                                }
-                            }
-                            // Below
-                            if((pxl.yPos+1) < height)
-                            {
-                                clumpBand->RasterIO(GF_Read, pxl.xPos, pxl.yPos+1, 1, 1, &uiPxlVal, 1, 1, GDT_UInt32, 0, 0);
-                                if(uiPxlVal == 0)
-                                {
-                                    catagoryBand->RasterIO(GF_Read, pxl.xPos, pxl.yPos+1, 1, 1, &catCPxlVal, 1, 1, GDT_UInt32, 0, 0);
-                                    
-                                    if(catPxlVal == catCPxlVal)
-                                    {
-                                        clumpPxls.push_back(rsgis::img::PxlLoc(pxl.xPos, pxl.yPos+1));
-                                        clumpSearchPxls.push(rsgis::img::PxlLoc(pxl.xPos, pxl.yPos+1));
-                                        clumpBand->RasterIO(GF_Write, pxl.xPos, pxl.yPos+1, 1, 1, &clumpIdx, 1, 1, GDT_UInt32, 0, 0);
-                                    }
-                                }
-                                
-                            }
-                            // Left
-                            if(((long)pxl.xPos)-1 >= 0)
-                            {
-                                clumpBand->RasterIO(GF_Read, pxl.xPos-1, pxl.yPos, 1, 1, &uiPxlVal, 1, 1, GDT_UInt32, 0, 0);
-                                if(uiPxlVal == 0)
-                                {
-                                    catagoryBand->RasterIO(GF_Read, pxl.xPos-1, pxl.yPos, 1, 1, &catCPxlVal, 1, 1, GDT_UInt32, 0, 0);
-                                    
-                                    if(catPxlVal == catCPxlVal)
-                                    {
-                                        clumpPxls.push_back(rsgis::img::PxlLoc(pxl.xPos-1, pxl.yPos));
-                                        clumpSearchPxls.push(rsgis::img::PxlLoc(pxl.xPos-1, pxl.yPos));
-                                        clumpBand->RasterIO(GF_Write, pxl.xPos-1, pxl.yPos, 1, 1, &clumpIdx, 1, 1, GDT_UInt32, 0, 0);
-                                    }
-                                }
-                            }
-                            // Right
-                            if((pxl.xPos+1) < width)
-                            {
-                                clumpBand->RasterIO(GF_Read, pxl.xPos+1, pxl.yPos, 1, 1, &uiPxlVal, 1, 1, GDT_UInt32, 0, 0);
-                                if(uiPxlVal == 0)
-                                {
-                                    catagoryBand->RasterIO(GF_Read, pxl.xPos+1, pxl.yPos, 1, 1, &catCPxlVal, 1, 1, GDT_UInt32, 0, 0);
-                                    
-                                    if(catPxlVal == catCPxlVal)
-                                    {
-                                        clumpPxls.push_back(rsgis::img::PxlLoc(pxl.xPos+1, pxl.yPos));
-                                        clumpSearchPxls.push(rsgis::img::PxlLoc(pxl.xPos+1, pxl.yPos));
-                                        clumpBand->RasterIO(GF_Write, pxl.xPos+1, pxl.yPos, 1, 1, &clumpIdx, 1, 1, GDT_UInt32, 0, 0);
-                                    }
-                                }
-                            }
-                        }
-                        
-                        ++clumpIdx;
-                    }
-                }
-            }
-        }
-        pbar.finish();
-        std::cout << "(Generated " << clumpIdx-1 << " clumps).\n";
+        // Values are read as unsigned ints so only values > 0 are clumped if 0 is no data.
+        unsigned long numClumps = this->performScanlineClump(&catagoryBand, &xOff, &yOff, 1, clumpBand, width, height, true, 0, use8Conn, NULL);
+        std::cout << "(Generated " << numClumps << " clumps).\n";
     }
     
-    void RSGISClumpPxls::performMultiBandClump(std::vector<GDALDataset*> *catagories, std::string clumpsOutputPath, std::string outFormat, bool noDataValProvided, unsigned int noDataVal, bool addRatPxlVals) 
+    void RSGISClumpPxls::performMultiBandClump(std::vector<GDALDataset*> *catagories, std::string clumpsOutputPath, std::string outFormat, bool noDataValProvided, unsigned int noDataVal, bool addRatPxlVals, bool use8Conn) 
     {
         try
         {
@@ -374,7 +141,6 @@ namespace rsgis{namespace segment{
 			}
 			clumpsDS->SetGeoTransform(gdalTransform);
 			clumpsDS->SetProjection(catagories->at(0)->GetProjectionRef());
-            imgUtils.zerosUIntGDALDataset(clumpsDS);
             
             // Count number of image bands
 			unsigned int numInBands = 0;
@@ -384,7 +150,8 @@ namespace rsgis{namespace segment{
 			}
             
             // Get Image Input Bands
-			int **bandOffsets = new int*[numInBands];
+			int *bandXOffs = new int[numInBands];
+			int *bandYOffs = new int[numInBands];
 			GDALRasterBand **catBands = new GDALRasterBand*[numInBands];
 			int counter = 0;
 			for(int i = 0; i < numDS; i++)
@@ -392,9 +159,8 @@ namespace rsgis{namespace segment{
 				for(int j = 0; j < catagories->at(i)->GetRasterCount(); j++)
 				{
 					catBands[counter] = catagories->at(i)->GetRasterBand(j+1);
-					bandOffsets[counter] = new int[2];
-					bandOffsets[counter][0] = dsOffsets[i][0];
-					bandOffsets[counter][1] = dsOffsets[i][1];
+					bandXOffs[counter] = dsOffsets[i][0];
+					bandYOffs[counter] = dsOffsets[i][1];
 					counter++;
 				}
 			}
@@ -402,162 +168,24 @@ namespace rsgis{namespace segment{
             //Get Image Output Band
 			GDALRasterBand *clumpBand = clumpsDS->GetRasterBand(1);
             clumpBand->SetDescription("Clumps");
-                        
-            unsigned long clumpIdx = 1;
-            std::vector<rsgis::img::PxlLoc> clumpPxls;
-            std::queue<rsgis::img::PxlLoc> clumpSearchPxls;
-            unsigned int *catPxlVals = new unsigned int[numInBands];
-            unsigned int *catCPxlVals = new unsigned int[numInBands];
             
-            unsigned int uiPxlVal = 0;
-            std::vector<int*> outRATVals;
-            
-            rsgis_tqdm pbar;
-            for(unsigned int i = 0; i < height; ++i)
+            std::vector<unsigned int> *clumpPxlVals = NULL;
+            if(addRatPxlVals)
             {
-                pbar.progress(i, height);
-                
-                for(unsigned int j = 0; j < width; ++j)
-                {
-                    // Get pixel value from clump image for (j,i)
-                    clumpBand->RasterIO(GF_Read, j, i, 1, 1, &uiPxlVal, 1, 1, GDT_UInt32, 0, 0);
-                    
-                    // if value is zero create new clump
-                    if(uiPxlVal == 0)
-                    {
-                        for(unsigned int n = 0; n < numInBands; ++n)
-                        {
-                            catBands[n]->RasterIO(GF_Read, bandOffsets[n][0]+j, bandOffsets[n][1]+i, 1, 1, &catPxlVals[n], 1, 1, GDT_UInt32, 0, 0);
-                        }
-                        
-                        if((!noDataValProvided) | (noDataValProvided & (!this->allValueEqual(catPxlVals, numInBands, noDataVal))))
-                        {
-                            // Make sure all lists are empty.
-                            clumpPxls.clear();
-                            if(!clumpSearchPxls.empty())
-                            {
-                                while(clumpSearchPxls.size() > 0)
-                                {
-                                    clumpSearchPxls.pop();
-                                }
-                            }
-                            
-                            if(addRatPxlVals)
-                            {
-                                int *vals = new int[numInBands];
-                                for(unsigned int n = 0; n < numInBands; ++n)
-                                {
-                                    vals[n] = catPxlVals[n];
-                                }
-                                outRATVals.push_back(vals);
-                            }
-                            
-                            clumpPxls.push_back(rsgis::img::PxlLoc(j, i));
-                            clumpSearchPxls.push(rsgis::img::PxlLoc(j, i));
-                            clumpBand->RasterIO(GF_Write, j, i, 1, 1, &clumpIdx, 1, 1, GDT_UInt32, 0, 0);
-                            
-                            // Add neigbouring pixels to clump.
-                            // If no more pixels to add then stop.
-                            while(clumpSearchPxls.size() > 0)
-                            {
-                                rsgis::img::PxlLoc pxl = clumpSearchPxls.front();
-                                clumpSearchPxls.pop();
-                                
-                                // Above
-                                if(((long)pxl.yPos)-1 >= 0)
-                                {
-                                    clumpBand->RasterIO(GF_Read, pxl.xPos, pxl.yPos-1, 1, 1, &uiPxlVal, 1, 1, GDT_UInt32, 0, 0);
-                                    if(uiPxlVal == 0)
-                                    {
-                                        for(unsigned int n = 0; n < numInBands; ++n)
-                                        {
-                                            catBands[n]->RasterIO(GF_Read, bandOffsets[n][0]+pxl.xPos, bandOffsets[n][1]+(pxl.yPos-1), 1, 1, &catCPxlVals[n], 1, 1, GDT_UInt32, 0, 0);
-                                        }
-                                        
-                                        if(this->allValueEqual(catPxlVals, catCPxlVals, numInBands))
-                                        {
-                                            clumpPxls.push_back(rsgis::img::PxlLoc(pxl.xPos, pxl.yPos-1));
-                                            clumpSearchPxls.push(rsgis::img::PxlLoc(pxl.xPos, pxl.yPos-1));
-                                            clumpBand->RasterIO(GF_Write, pxl.xPos, pxl.yPos-1, 1, 1, &clumpIdx, 1, 1, GDT_UInt32, 0, 0);
-                                        }
-                                    }
-                                }
-                                // Below
-                                if((pxl.yPos+1) < height)
-                                {
-                                    clumpBand->RasterIO(GF_Read, pxl.xPos, pxl.yPos+1, 1, 1, &uiPxlVal, 1, 1, GDT_UInt32, 0, 0);
-                                    if(uiPxlVal == 0)
-                                    {
-                                        for(unsigned int n = 0; n < numInBands; ++n)
-                                        {
-                                            catBands[n]->RasterIO(GF_Read, bandOffsets[n][0]+pxl.xPos, bandOffsets[n][1]+(pxl.yPos+1), 1, 1, &catCPxlVals[n], 1, 1, GDT_UInt32, 0, 0);
-                                        }
-                                        
-                                        if(this->allValueEqual(catPxlVals, catCPxlVals, numInBands))
-                                        {
-                                            clumpPxls.push_back(rsgis::img::PxlLoc(pxl.xPos, pxl.yPos+1));
-                                            clumpSearchPxls.push(rsgis::img::PxlLoc(pxl.xPos, pxl.yPos+1));
-                                            clumpBand->RasterIO(GF_Write, pxl.xPos, pxl.yPos+1, 1, 1, &clumpIdx, 1, 1, GDT_UInt32, 0, 0);
-                                        }
-                                    }
-                                    
-                                }
-                                // Left
-                                if(((long)pxl.xPos)-1 >= 0)
-                                {
-                                    clumpBand->RasterIO(GF_Read, pxl.xPos-1, pxl.yPos, 1, 1, &uiPxlVal, 1, 1, GDT_UInt32, 0, 0);
-                                    if(uiPxlVal == 0)
-                                    {
-                                        for(unsigned int n = 0; n < numInBands; ++n)
-                                        {
-                                            catBands[n]->RasterIO(GF_Read, bandOffsets[n][0]+(pxl.xPos-1), bandOffsets[n][1]+pxl.yPos, 1, 1, &catCPxlVals[n], 1, 1, GDT_UInt32, 0, 0);
-                                        }
-                                        
-                                        if(this->allValueEqual(catPxlVals, catCPxlVals, numInBands))
-                                        {
-                                            clumpPxls.push_back(rsgis::img::PxlLoc(pxl.xPos-1, pxl.yPos));
-                                            clumpSearchPxls.push(rsgis::img::PxlLoc(pxl.xPos-1, pxl.yPos));
-                                            clumpBand->RasterIO(GF_Write, pxl.xPos-1, pxl.yPos, 1, 1, &clumpIdx, 1, 1, GDT_UInt32, 0, 0);
-                                        }
-                                    }
-                                }
-                                // Right
-                                if((pxl.xPos+1) < width)
-                                {
-                                    clumpBand->RasterIO(GF_Read, pxl.xPos+1, pxl.yPos, 1, 1, &uiPxlVal, 1, 1, GDT_UInt32, 0, 0);
-                                    if(uiPxlVal == 0)
-                                    {
-                                        for(unsigned int n = 0; n < numInBands; ++n)
-                                        {
-                                            catBands[n]->RasterIO(GF_Read, bandOffsets[n][0]+(pxl.xPos+1), bandOffsets[n][1]+pxl.yPos, 1, 1, &catCPxlVals[n], 1, 1, GDT_UInt32, 0, 0);
-                                        }
-                                        
-                                        if(this->allValueEqual(catPxlVals, catCPxlVals, numInBands))
-                                        {
-                                            clumpPxls.push_back(rsgis::img::PxlLoc(pxl.xPos+1, pxl.yPos));
-                                            clumpSearchPxls.push(rsgis::img::PxlLoc(pxl.xPos+1, pxl.yPos));
-                                            clumpBand->RasterIO(GF_Write, pxl.xPos+1, pxl.yPos, 1, 1, &clumpIdx, 1, 1, GDT_UInt32, 0, 0);
-                                        }
-                                    }
-                                }
-                            }
-                            
-                            ++clumpIdx;
-                        }
-                    }
-                }
+                clumpPxlVals = new std::vector<unsigned int>();
             }
-            pbar.finish();
-            std::cout << "(Generated " << clumpIdx-1 << " clumps).\n";
+            
+            unsigned long numClumps = this->performScanlineClump(catBands, bandXOffs, bandYOffs, numInBands, clumpBand, width, height, noDataValProvided, noDataVal, use8Conn, clumpPxlVals);
+            std::cout << "(Generated " << numClumps << " clumps).\n";
             
             clumpBand->SetMetadataItem("LAYER_TYPE", "thematic");
             if(addRatPxlVals)
             {
                 GDALRasterAttributeTable *rat = clumpBand->GetDefaultRAT();
                 size_t numRows = rat->GetRowCount();
-                if((outRATVals.size()+1) > numRows)
+                if((numClumps+1) > numRows)
                 {
-                    numRows = outRATVals.size()+1;
+                    numRows = numClumps+1;
                     rat->SetRowCount(numRows);
                 }
                 rastergis::RSGISRasterAttUtils attUtils;
@@ -567,35 +195,26 @@ namespace rsgis{namespace segment{
                 {
                     for(size_t j = 0; j < numRows; ++j)
                     {
-                        if(j == 0)
+                        if((j == 0) | (j > numClumps))
                         {
                             ratColVals[j] = 0;
                         }
                         else
                         {
-                            ratColVals[j] = outRATVals.at(j-1)[i];
+                            ratColVals[j] = clumpPxlVals->at(((j-1)*numInBands)+i);
                         }
                     }
                     attUtils.writeIntColumn(rat, "ClumpVal_"+txtUtils.sizettostring(i+1), ratColVals, numRows);
                 }
                 delete[] ratColVals;
-                
-                for(size_t i = 0; i < outRATVals.size(); ++i)
-                {
-                    delete[] outRATVals.at(i);
-                }
+                delete clumpPxlVals;
             }
             
             GDALClose(clumpsDS);
             
-            delete[] catPxlVals;
-            delete[] catCPxlVals;
-            
             delete[] catBands;
-            for(unsigned int i = 0; i < numInBands; ++i)
-            {
-                delete[] bandOffsets[i];
-            }
+            delete[] bandXOffs;
+            delete[] bandYOffs;
             
             delete[] gdalTransform;
             for(unsigned int i = 0; i < numDS; ++i)
@@ -614,6 +233,475 @@ namespace rsgis{namespace segment{
         }
     }
     
+    unsigned long RSGISClumpPxls::performScanlineClump(GDALRasterBand **catBands, int *bandXOffs, int *bandYOffs, unsigned int numInBands, GDALRasterBand *clumpBand, unsigned int width, unsigned int height, bool noDataValProvided, unsigned int noDataVal, bool use8Conn, std::vector<unsigned int> *clumpPxlVals)
+    {
+        /*
+         * Two pass connected component labelling. The first pass reads the input
+         * a row at a time, assigning labels from the (already labelled) row above
+         * and pixel to the left. These row labels are recycled: the union-find table
+         * used to merge them only holds the labels in the previous and current rows
+         * and, once a row is labelled, the labels still present are renumbered from 1
+         * for the next row so the table never grows beyond twice the image width.
+         * Each row label carries the provisional clump it belongs to, which is what is
+         * written to the output. A provisional clump is created at the first pixel of
+         * each new component in scan order and when two components meet the later is
+         * recorded as an alias of the earlier. The second pass rewrites the output with
+         * the final labels, each component being represented by its smallest
+         * provisional clump so the clumps are numbered in the same order as a flood
+         * fill started at each unlabelled pixel in turn.
+         *
+         * The provisional clump look up (plus one value per band for each if the pixel
+         * values are being returned) is the only memory which is not bounded by the
+         * image width. It holds one entry per clump plus one for each extra part of a
+         * clump which is only joined in a later row (e.g., the arms of a 'U'), as these
+         * values have already been written to the output.
+         */
+        std::vector<unsigned int> clumpParents;
+        clumpParents.reserve(((size_t)width)*2);
+        clumpParents.push_back(0);
+        std::vector<unsigned int> provClumpPxlVals;
+        
+        std::vector<unsigned int> rowParents;
+        rowParents.reserve(((size_t)width)*2+1);
+        rowParents.push_back(0);
+        std::vector<unsigned int> rowClumpIdxs;
+        rowClumpIdxs.reserve(((size_t)width)*2+1);
+        rowClumpIdxs.push_back(0);
+        std::vector<unsigned int> nextRowClumpIdxs;
+        nextRowClumpIdxs.reserve(((size_t)width)+1);
+        std::vector<unsigned int> rowLabelRemap;
+        rowLabelRemap.reserve(((size_t)width)*2+1);
+        std::vector<unsigned int> rowPxlVals;
+        
+        std::vector<unsigned int> catRow(((size_t)width)*numInBands);
+        std::vector<unsigned int> catPrevRow(((size_t)width)*numInBands);
+        std::vector<unsigned int> clumpRow(width);
+        std::vector<unsigned int> clumpPrevRow(width);
+        std::vector<unsigned int> outRow(width);
+        std::vector<unsigned int> catPxlVals(numInBands);
+        
+        rsgis_tqdm pbar;
+        for(unsigned int i = 0; i < height; ++i)
+        {
+            pbar.progress(i, height*2);
+            
+            for(unsigned int n = 0; n < numInBands; ++n)
+            {
+                catBands[n]->RasterIO(GF_Read, bandXOffs[n], bandYOffs[n]+i, width, 1, &catRow[((size_t)n)*width], width, 1, GDT_UInt32, 0, 0);
+            }
+            
+            // Labels 1 to numPrevLabels are those carried over from the previous row.
+            unsigned int numPrevLabels = rowParents.size()-1;
+            if(clumpPxlVals != NULL)
+            {
+                rowPxlVals.resize(((size_t)numPrevLabels)*numInBands);
+            }
+            this->labelClumpRow(catRow.data(), ((i > 0)?catPrevRow.data():NULL), clumpRow.data(), clumpPrevRow.data(), width, numInBands, noDataValProvided, noDataVal, use8Conn, rowParents, ((clumpPxlVals != NULL)?&rowPxlVals:NULL), catPxlVals.data());
+            
+            // Parents always have a smaller label so, in ascending order, the root of a
+            // label has its provisional clump before the label itself is visited and
+            // the table is flattened as it goes.
+            size_t numRowLabels = rowParents.size();
+            rowClumpIdxs.resize(numRowLabels, 0);
+            for(size_t k = 1; k < numRowLabels; ++k)
+            {
+                unsigned int rootIdx = rowParents[rowParents[k]];
+                rowParents[k] = rootIdx;
+                if(k <= numPrevLabels)
+                {
+                    if(rootIdx != k)
+                    {
+                        // Two components from the previous rows have been joined.
+                        this->unionClumps(clumpParents, rowClumpIdxs[k], rowClumpIdxs[rootIdx]);
+                    }
+                }
+                else if(rootIdx != k)
+                {
+                    rowClumpIdxs[k] = rowClumpIdxs[rootIdx];
+                }
+                else
+                {
+                    if(clumpParents.size() > std::numeric_limits<unsigned int>::max())
+                    {
+                        throw rsgis::img::RSGISImageCalcException("The number of clumps is too large to be stored in a 32 bit image.");
+                    }
+                    rowClumpIdxs[k] = clumpParents.size();
+                    clumpParents.push_back(rowClumpIdxs[k]);
+                    if(clumpPxlVals != NULL)
+                    {
+                        provClumpPxlVals.insert(provClumpPxlVals.end(), rowPxlVals.begin()+((k-1)*numInBands), rowPxlVals.begin()+(k*numInBands));
+                    }
+                }
+            }
+            
+            // Write the provisional clumps and renumber the labels present in this row
+            // for the next.
+            rowLabelRemap.assign(numRowLabels, 0);
+            nextRowClumpIdxs.assign(1, 0);
+            for(unsigned int j = 0; j < width; ++j)
+            {
+                if(clumpRow[j] == 0)
+                {
+                    outRow[j] = 0;
+                    continue;
+                }
+                unsigned int rootIdx = rowParents[clumpRow[j]];
+                outRow[j] = rowClumpIdxs[rootIdx];
+                if(rowLabelRemap[rootIdx] == 0)
+                {
+                    rowLabelRemap[rootIdx] = nextRowClumpIdxs.size();
+                    nextRowClumpIdxs.push_back(rowClumpIdxs[rootIdx]);
+                }
+                clumpRow[j] = rowLabelRemap[rootIdx];
+            }
+            rowClumpIdxs.swap(nextRowClumpIdxs);
+            rowParents.resize(rowClumpIdxs.size());
+            for(size_t k = 1; k < rowParents.size(); ++k)
+            {
+                rowParents[k] = k;
+            }
+            
+            clumpBand->RasterIO(GF_Write, 0, i, width, 1, outRow.data(), width, 1, GDT_UInt32, 0, 0);
+            
+            catPrevRow.swap(catRow);
+            clumpPrevRow.swap(clumpRow);
+        }
+        
+        unsigned long numClumps = this->resolveClumpLabels(clumpParents, numInBands, ((clumpPxlVals != NULL)?&provClumpPxlVals:NULL), clumpPxlVals);
+        std::vector<unsigned int>().swap(provClumpPxlVals);
+        
+        this->relabelClumpRows(clumpBand, width, height, clumpParents, clumpRow.data(), &pbar, height, height*2);
+        pbar.finish();
+        
+        return numClumps;
+    }
+    
+    unsigned long RSGISClumpPxls::performParallelScanlineClump(GDALRasterBand **catBands, int *bandXOffs, int *bandYOffs, unsigned int numInBands, GDALRasterBand *clumpBand, unsigned int width, unsigned int height, bool noDataValProvided, unsigned int noDataVal, bool use8Conn, std::vector<unsigned int> *clumpPxlVals, unsigned int numThreads)
+    {
+        /*
+         * The image is read in chunks of rows (GDAL is only called from this thread)
+         * and each chunk is divided into strips which are labelled concurrently, each
+         * with its own union-find table. The strip labels are then offset into a global
+         * union-find table, in scan order, and the labels either side of the seams
+         * between strips (and chunks) are merged. The global table is resolved and the
+         * output relabelled as for the single threaded version, so the result is
+         * identical to performScanlineClump.
+         */
+        const unsigned int stripRows = 64;
+        if(numThreads < 1)
+        {
+            numThreads = 1;
+        }
+        size_t rowLen = ((size_t)width)*numInBands;
+        unsigned int chunkRows = stripRows * numThreads;
+        
+        std::vector<unsigned int> catChunk(rowLen*chunkRows);
+        std::vector<unsigned int> clumpChunk(((size_t)width)*chunkRows);
+        std::vector<unsigned int> catPrevRow(rowLen);
+        std::vector<unsigned int> clumpPrevRow(width);
+        std::vector<unsigned int> catPxlVals(numInBands);
+        
+        std::vector<unsigned int> clumpParents;
+        clumpParents.push_back(0);
+        std::vector<unsigned int> provClumpPxlVals;
+        
+        std::vector< std::vector<unsigned int> > stripParents(numThreads);
+        std::vector< std::vector<unsigned int> > stripPxlVals(numThreads);
+        std::vector<unsigned long> stripNumClumps(numThreads);
+        std::vector<std::exception_ptr> stripErrors(numThreads);
+        std::vector<std::thread> threads;
+        
+        rsgis_tqdm pbar;
+        for(unsigned int cRow = 0; cRow < height; cRow += chunkRows)
+        {
+            pbar.progress(cRow, height*2);
+            unsigned int nRows = std::min(chunkRows, height-cRow);
+            for(unsigned int n = 0; n < numInBands; ++n)
+            {
+                catBands[n]->RasterIO(GF_Read, bandXOffs[n], bandYOffs[n]+cRow, width, nRows, &catChunk[((size_t)n)*width], width, nRows, GDT_UInt32, 0, sizeof(unsigned int)*rowLen);
+            }
+            
+            unsigned int numStrips = ((nRows-1)/stripRows)+1;
+            threads.clear();
+            for(unsigned int t = 0; t < numStrips; ++t)
+            {
+                threads.push_back(std::thread([&, t]()
+                {
+                    try
+                    {
+                        unsigned int sRow = t*stripRows;
+                        unsigned int eRow = std::min(sRow+stripRows, nRows);
+                        std::vector<unsigned int> &localParents = stripParents[t];
+                        std::vector<unsigned int> localPxlVals;
+                        std::vector<unsigned int> localCatPxlVals(numInBands);
+                        localParents.clear();
+                        localParents.push_back(0);
+                        stripPxlVals[t].clear();
+                        for(unsigned int r = sRow; r < eRow; ++r)
+                        {
+                            this->labelClumpRow(&catChunk[r*rowLen], ((r > sRow)?&catChunk[(r-1)*rowLen]:NULL), &clumpChunk[((size_t)r)*width], ((r > sRow)?&clumpChunk[((size_t)(r-1))*width]:NULL), width, numInBands, noDataValProvided, noDataVal, use8Conn, localParents, ((clumpPxlVals != NULL)?&localPxlVals:NULL), localCatPxlVals.data());
+                        }
+                        stripNumClumps[t] = this->resolveClumpLabels(localParents, numInBands, ((clumpPxlVals != NULL)?&localPxlVals:NULL), ((clumpPxlVals != NULL)?&stripPxlVals[t]:NULL));
+                        for(size_t k = ((size_t)sRow)*width; k < ((size_t)eRow)*width; ++k)
+                        {
+                            clumpChunk[k] = localParents[clumpChunk[k]];
+                        }
+                    }
+                    catch(...)
+                    {
+                        stripErrors[t] = std::current_exception();
+                    }
+                }));
+            }
+            for(std::vector<std::thread>::iterator iterThreads = threads.begin(); iterThreads != threads.end(); ++iterThreads)
+            {
+                (*iterThreads).join();
+            }
+            for(unsigned int t = 0; t < numStrips; ++t)
+            {
+                if(stripErrors[t])
+                {
+                    std::rethrow_exception(stripErrors[t]);
+                }
+            }
+            
+            for(unsigned int t = 0; t < numStrips; ++t)
+            {
+                unsigned int sRow = t*stripRows;
+                unsigned int eRow = std::min(sRow+stripRows, nRows);
+                size_t clumpOffset = clumpParents.size()-1;
+                if((clumpOffset + stripNumClumps[t]) > std::numeric_limits<unsigned int>::max())
+                {
+                    throw rsgis::img::RSGISImageCalcException("The number of clumps is too large to be stored in a 32 bit image.");
+                }
+                for(size_t k = ((size_t)sRow)*width; k < ((size_t)eRow)*width; ++k)
+                {
+                    if(clumpChunk[k] != 0)
+                    {
+                        clumpChunk[k] += clumpOffset;
+                    }
+                }
+                for(size_t k = 1; k <= stripNumClumps[t]; ++k)
+                {
+                    clumpParents.push_back(clumpOffset+k);
+                }
+                if(clumpPxlVals != NULL)
+                {
+                    provClumpPxlVals.insert(provClumpPxlVals.end(), stripPxlVals[t].begin(), stripPxlVals[t].end());
+                }
+                
+                if(sRow > 0)
+                {
+                    this->mergeClumpRowSeam(&catChunk[sRow*rowLen], &catChunk[(sRow-1)*rowLen], &clumpChunk[((size_t)sRow)*width], &clumpChunk[((size_t)(sRow-1))*width], width, numInBands, use8Conn, clumpParents, catPxlVals.data());
+                }
+                else if(cRow > 0)
+                {
+                    this->mergeClumpRowSeam(&catChunk[0], catPrevRow.data(), &clumpChunk[0], clumpPrevRow.data(), width, numInBands, use8Conn, clumpParents, catPxlVals.data());
+                }
+            }
+            
+            clumpBand->RasterIO(GF_Write, 0, cRow, width, nRows, clumpChunk.data(), width, nRows, GDT_UInt32, 0, 0);
+            
+            std::copy(catChunk.begin()+((nRows-1)*rowLen), catChunk.begin()+(nRows*rowLen), catPrevRow.begin());
+            std::copy(clumpChunk.begin()+(((size_t)(nRows-1))*width), clumpChunk.begin()+(((size_t)nRows)*width), clumpPrevRow.begin());
+        }
+        std::vector<unsigned int>().swap(catChunk);
+        std::vector<unsigned int>().swap(clumpChunk);
+        
+        unsigned long numClumps = this->resolveClumpLabels(clumpParents, numInBands, ((clumpPxlVals != NULL)?&provClumpPxlVals:NULL), clumpPxlVals);
+        std::vector<unsigned int>().swap(provClumpPxlVals);
+        
+        this->relabelClumpRows(clumpBand, width, height, clumpParents, clumpPrevRow.data(), &pbar, height, height*2);
+        pbar.finish();
+        
+        return numClumps;
+    }
+    
+    void RSGISClumpPxls::labelClumpRow(unsigned int *catRow, unsigned int *catPrevRow, unsigned int *clumpRow, unsigned int *clumpPrevRow, unsigned int width, unsigned int numInBands, bool noDataValProvided, unsigned int noDataVal, bool use8Conn, std::vector<unsigned int> &clumpParents, std::vector<unsigned int> *provClumpPxlVals, unsigned int *catPxlVals)
+    {
+        unsigned int nbrClumpIdx = 0;
+        unsigned int clumpIdx = 0;
+        for(unsigned int j = 0; j < width; ++j)
+        {
+            for(unsigned int n = 0; n < numInBands; ++n)
+            {
+                catPxlVals[n] = catRow[(((size_t)n)*width)+j];
+            }
+            
+            if(noDataValProvided && this->allValueEqual(catPxlVals, numInBands, noDataVal))
+            {
+                clumpRow[j] = 0;
+                continue;
+            }
+            
+            clumpIdx = 0;
+            // Left
+            if((j > 0) && (clumpRow[j-1] != 0) && this->catValsEqual(catPxlVals, catRow, width, j-1, numInBands))
+            {
+                clumpIdx = clumpRow[j-1];
+            }
+            if(catPrevRow != NULL)
+            {
+                // Above
+                nbrClumpIdx = clumpPrevRow[j];
+                if((nbrClumpIdx != 0) && this->catValsEqual(catPxlVals, catPrevRow, width, j, numInBands))
+                {
+                    clumpIdx = (clumpIdx == 0)?nbrClumpIdx:this->unionClumps(clumpParents, clumpIdx, nbrClumpIdx);
+                }
+                if(use8Conn)
+                {
+                    // Above Left
+                    if(j > 0)
+                    {
+                        nbrClumpIdx = clumpPrevRow[j-1];
+                        if((nbrClumpIdx != 0) && this->catValsEqual(catPxlVals, catPrevRow, width, j-1, numInBands))
+                        {
+                            clumpIdx = (clumpIdx == 0)?nbrClumpIdx:this->unionClumps(clumpParents, clumpIdx, nbrClumpIdx);
+                        }
+                    }
+                    // Above Right
+                    if((j+1) < width)
+                    {
+                        nbrClumpIdx = clumpPrevRow[j+1];
+                        if((nbrClumpIdx != 0) && this->catValsEqual(catPxlVals, catPrevRow, width, j+1, numInBands))
+                        {
+                            clumpIdx = (clumpIdx == 0)?nbrClumpIdx:this->unionClumps(clumpParents, clumpIdx, nbrClumpIdx);
+                        }
+                    }
+                }
+            }
+            
+            if(clumpIdx == 0)
+            {
+                if(clumpParents.size() > std::numeric_limits<unsigned int>::max())
+                {
+                    throw rsgis::img::RSGISImageCalcException("The number of clumps is too large to be stored in a 32 bit image.");
+                }
+                clumpIdx = clumpParents.size();
+                clumpParents.push_back(clumpIdx);
+                if(provClumpPxlVals != NULL)
+                {
+                    provClumpPxlVals->insert(provClumpPxlVals->end(), catPxlVals, catPxlVals+numInBands);
+                }
+            }
+            clumpRow[j] = clumpIdx;
+        }
+    }
+    
+    void RSGISClumpPxls::mergeClumpRowSeam(unsigned int *catRow, unsigned int *catPrevRow, unsigned int *clumpRow, unsigned int *clumpPrevRow, unsigned int width, unsigned int numInBands, bool use8Conn, std::vector<unsigned int> &clumpParents, unsigned int *catPxlVals)
+    {
+        for(unsigned int j = 0; j < width; ++j)
+        {
+            if(clumpRow[j] == 0)
+            {
+                continue;
+            }
+            for(unsigned int n = 0; n < numInBands; ++n)
+            {
+                catPxlVals[n] = catRow[(((size_t)n)*width)+j];
+            }
+            
+            // Above
+            if((clumpPrevRow[j] != 0) && this->catValsEqual(catPxlVals, catPrevRow, width, j, numInBands))
+            {
+                this->unionClumps(clumpParents, clumpRow[j], clumpPrevRow[j]);
+            }
+            if(use8Conn)
+            {
+                // Above Left
+                if((j > 0) && (clumpPrevRow[j-1] != 0) && this->catValsEqual(catPxlVals, catPrevRow, width, j-1, numInBands))
+                {
+                    this->unionClumps(clumpParents, clumpRow[j], clumpPrevRow[j-1]);
+                }
+                // Above Right
+                if(((j+1) < width) && (clumpPrevRow[j+1] != 0) && this->catValsEqual(catPxlVals, catPrevRow, width, j+1, numInBands))
+                {
+                    this->unionClumps(clumpParents, clumpRow[j], clumpPrevRow[j+1]);
+                }
+            }
+        }
+    }
+    
+    unsigned long RSGISClumpPxls::resolveClumpLabels(std::vector<unsigned int> &clumpParents, unsigned int numInBands, std::vector<unsigned int> *provClumpPxlVals, std::vector<unsigned int> *clumpPxlVals)
+    {
+        // Parents always have a smaller index so a single ascending pass flattens the
+        // table and a second numbers the roots in order, replacing each entry with
+        // its final clump index.
+        unsigned long numClumps = 0;
+        size_t numProvClumps = clumpParents.size();
+        for(size_t k = 1; k < numProvClumps; ++k)
+        {
+            clumpParents[k] = clumpParents[clumpParents[k]];
+        }
+        for(size_t k = 1; k < numProvClumps; ++k)
+        {
+            if(clumpParents[k] == k)
+            {
+                if((provClumpPxlVals != NULL) && (clumpPxlVals != NULL))
+                {
+                    clumpPxlVals->insert(clumpPxlVals->end(), provClumpPxlVals->begin()+((k-1)*numInBands), provClumpPxlVals->begin()+(k*numInBands));
+                }
+                clumpParents[k] = ++numClumps;
+            }
+            else
+            {
+                clumpParents[k] = clumpParents[clumpParents[k]];
+            }
+        }
+        return numClumps;
+    }
+    
+    void RSGISClumpPxls::relabelClumpRows(GDALRasterBand *clumpBand, unsigned int width, unsigned int height, std::vector<unsigned int> &clumpLookUp, unsigned int *clumpRow, rsgis_tqdm *pbar, unsigned int pbarOffset, unsigned int pbarTotal)
+    {
+        for(unsigned int i = 0; i < height; ++i)
+        {
+            pbar->progress(pbarOffset+i, pbarTotal);
+            clumpBand->RasterIO(GF_Read, 0, i, width, 1, clumpRow, width, 1, GDT_UInt32, 0, 0);
+            for(unsigned int j = 0; j < width; ++j)
+            {
+                clumpRow[j] = clumpLookUp[clumpRow[j]];
+            }
+            clumpBand->RasterIO(GF_Write, 0, i, width, 1, clumpRow, width, 1, GDT_UInt32, 0, 0);
+        }
+    }
+    
+    bool RSGISClumpPxls::catValsEqual(unsigned int *vals, unsigned int *rowVals, unsigned int width, unsigned int idx, unsigned int numVals)
+    {
+        for(unsigned int n = 0; n < numVals; ++n)
+        {
+            if(vals[n] != rowVals[(((size_t)n)*width)+idx])
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+    
+    unsigned int RSGISClumpPxls::findClumpRoot(std::vector<unsigned int> &clumpParents, unsigned int clumpIdx)
+    {
+        while(clumpParents[clumpIdx] != clumpIdx)
+        {
+            // Path halving
+            clumpParents[clumpIdx] = clumpParents[clumpParents[clumpIdx]];
+            clumpIdx = clumpParents[clumpIdx];
+        }
+        return clumpIdx;
+    }
+    
+    unsigned int RSGISClumpPxls::unionClumps(std::vector<unsigned int> &clumpParents, unsigned int clumpIdx1, unsigned int clumpIdx2)
+    {
+        unsigned int root1 = this->findClumpRoot(clumpParents, clumpIdx1);
+        unsigned int root2 = this->findClumpRoot(clumpParents, clumpIdx2);
+        // The smaller index is kept as the root.
+        if(root1 < root2)
+        {
+            clumpParents[root2] = root1;
+            return root1;
+        }
+        clumpParents[root1] = root2;
+        return root2;
+    }
+    
     bool RSGISClumpPxls::allValueEqual(unsigned int *vals, unsigned int numVals, unsigned int equalVal)
     {
         for(unsigned int i = 0; i < numVals; ++i)
@@ -27,6 +27,10 @@
 #include <vector>
 #include <queue>
 #include <cmath>
+#include <limits>
+#include <algorithm>
+#include <thread>
+#include <exception>
 
 #include "gdal_priv.h"
 
@@ -61,13 +65,32 @@ namespace rsgis{namespace segment{
     {
     public:
         RSGISClumpPxls();
-        void performClump(GDALDataset *catagories, GDALDataset *clumps, bool noDataValProvided, unsigned int noDataVal, std::vector<unsigned int> *clumpPxlVals=NULL);
-        void performClumpPosVals(GDALDataset *catagories, GDALDataset *clumps);
-        void performMultiBandClump(std::vector<GDALDataset*> *catagories, std::string clumpsOutputPath, std::string outFormat, bool noDataValProvided, unsigned int noDataVal, bool addRatPxlVals=false);
+        /**
+         * If numThreads > 1 then strips of rows are labelled concurrently and merged
+         * across the seams; the output is the same as with a single thread.
+         */
+        void performClump(GDALDataset *catagories, GDALDataset *clumps, bool noDataValProvided, unsigned int noDataVal, std::vector<unsigned int> *clumpPxlVals=NULL, bool use8Conn=false, unsigned int numThreads=1);
+        void performClumpPosVals(GDALDataset *catagories, GDALDataset *clumps, bool use8Conn=false);
+        void performMultiBandClump(std::vector<GDALDataset*> *catagories, std::string clumpsOutputPath, std::string outFormat, bool noDataValProvided, unsigned int noDataVal, bool addRatPxlVals=false, bool use8Conn=false);
         ~RSGISClumpPxls();
     protected:
+        /**
+         * Clump the input bands into clumpBand using a two pass scanline labelling with a
+         * union-find table of provisional labels, reading and writing whole rows. If
+         * clumpPxlVals is not NULL then the numInBands input values of each clump are
+         * appended in clump order. Returns the number of clumps.
+         */
+        unsigned long performScanlineClump(GDALRasterBand **catBands, int *bandXOffs, int *bandYOffs, unsigned int numInBands, GDALRasterBand *clumpBand, unsigned int width, unsigned int height, bool noDataValProvided, unsigned int noDataVal, bool use8Conn, std::vector<unsigned int> *clumpPxlVals);
+        unsigned long performParallelScanlineClump(GDALRasterBand **catBands, int *bandXOffs, int *bandYOffs, unsigned int numInBands, GDALRasterBand *clumpBand, unsigned int width, unsigned int height, bool noDataValProvided, unsigned int noDataVal, bool use8Conn, std::vector<unsigned int> *clumpPxlVals, unsigned int numThreads);
+        void labelClumpRow(unsigned int *catRow, unsigned int *catPrevRow, unsigned int *clumpRow, unsigned int *clumpPrevRow, unsigned int width, unsigned int numInBands, bool noDataValProvided, unsigned int noDataVal, bool use8Conn, std::vector<unsigned int> &clumpParents, std::vector<unsigned int> *provClumpPxlVals, unsigned int *catPxlVals);
+        void mergeClumpRowSeam(unsigned int *catRow, unsigned int *catPrevRow, unsigned int *clumpRow, unsigned int *clumpPrevRow, unsigned int width, unsigned int numInBands, bool use8Conn, std::vector<unsigned int> &clumpParents, unsigned int *catPxlVals);
+        unsigned long resolveClumpLabels(std::vector<unsigned int> &clumpParents, unsigned int numInBands, std::vector<unsigned int> *provClumpPxlVals, std::vector<unsigned int> *clumpPxlVals);
+        void relabelClumpRows(GDALRasterBand *clumpBand, unsigned int width, unsigned int height, std::vector<unsigned int> &clumpLookUp, unsigned int *clumpRow, rsgis_tqdm *pbar, unsigned int pbarOffset, unsigned int pbarTotal);
         inline bool allValueEqual(unsigned int *vals, unsigned int numVals, unsigned int equalVal);
         inline bool allValueEqual(unsigned int *vals1, unsigned int *vals2, unsigned int numVals);
+        inline bool catValsEqual(unsigned int *vals, unsigned int *rowVals, unsigned int width, unsigned int idx, unsigned int numVals);
+        inline unsigned int findClumpRoot(std::vector<unsigned int> &clumpParents, unsigned int clumpIdx);
+        inline unsigned int unionClumps(std::vector<unsigned int> &clumpParents, unsigned int clumpIdx1, unsigned int clumpIdx2);
     };
     
     class DllExport RSGISRelabelClumps
@@ -36,7 +36,8 @@ namespace rsgis{namespace segment{
         {
             std::cout << "Populate Neighbours\n";
             rastergis::RSGISFindClumpNeighbours findNeighboursObj;
-            findNeighboursObj.findNeighboursKEAImageCalc(clumpsImage, 1);
+            rastergis::RSGISClumpNeighbourGraph neighbourGraph;
+            findNeighboursObj.findNeighboursKEAImageCalc(clumpsImage, 1, 1, &neighbourGraph);
             std::cout << "Populated Neighbours\n";
             
             std::cout << "Calculate Stats\n";
@@ -87,17 +88,8 @@ namespace rsgis{namespace segment{
             size_t numRows = rat->GetRowCount();
             std::cout << "Number of clumps is " << numRows << "\n";
             
-            std::cout << "Read in neighbours\n";
-            std::vector<std::vector<size_t>* > *neighbours = attUtils.getRATNeighbours(clumpsImage, 1);
-            
-            if(numRows != neighbours->size())
+            if(numRows != neighbourGraph.numClumps)
             {
-                for(std::vector<std::vector<size_t>* >::iterator iterNeigh = neighbours->begin(); iterNeigh != neighbours->end(); ++iterNeigh)
-                {
-                    delete *iterNeigh;
-                }
-                delete neighbours;
-                
                 throw rsgis::RSGISAttributeTableException("RAT size is different to the number of neighbours retrieved.");
             }
             
@@ -158,9 +150,9 @@ namespace rsgis{namespace segment{
             }
             for(size_t i = 0; i < numRows; ++i)
             {
-                for(size_t j = 0; j < neighbours->at(i)->size(); ++j)
+                for(const size_t *iterNeigh = neighbourGraph.neighboursBegin(i); iterNeigh != neighbourGraph.neighboursEnd(i); ++iterNeigh)
                 {
-                    clumps.at(i)->neighbours.push_back(clumps.at(neighbours->at(i)->at(j)));
+                    clumps.at(i)->neighbours.push_back(clumps.at(*iterNeigh));
                 }
             }
             
@@ -339,7 +331,8 @@ namespace rsgis{namespace segment{
         {
             std::cout << "Populate Neighbours\n";
             rastergis::RSGISFindClumpNeighbours findNeighboursObj;
-            findNeighboursObj.findNeighboursKEAImageCalc(clumpsImage, 1);
+            rastergis::RSGISClumpNeighbourGraph neighbourGraph;
+            findNeighboursObj.findNeighboursKEAImageCalc(clumpsImage, 1, 1, &neighbourGraph);
             std::cout << "Populated Neighbours\n";
             
             rastergis::RSGISRasterAttUtils attUtils;
@@ -349,16 +342,8 @@ namespace rsgis{namespace segment{
             size_t numRows = rat->GetRowCount();
             std::cout << "Number of clumps is " << numRows << "\n";
             
-            std::vector<std::vector<size_t>* > *neighbours = attUtils.getRATNeighbours(clumpsImage, 1);
-            
-            if(numRows != neighbours->size())
+            if(numRows != neighbourGraph.numClumps)
             {
-                for(std::vector<std::vector<size_t>* >::iterator iterNeigh = neighbours->begin(); iterNeigh != neighbours->end(); ++iterNeigh)
-                {
-                    delete *iterNeigh;
-                }
-                delete neighbours;
-                
                 throw rsgis::RSGISAttributeTableException("RAT size is different to the number of neighbours retrieved.");
             }
             
@@ -388,9 +373,9 @@ namespace rsgis{namespace segment{
             }
             for(size_t i = 0; i < numRows; ++i)
             {
-                for(size_t j = 0; j < neighbours->at(i)->size(); ++j)
+                for(const size_t *iterNeigh = neighbourGraph.neighboursBegin(i); iterNeigh != neighbourGraph.neighboursEnd(i); ++iterNeigh)
                 {
-                    clumps.at(i)->neighbours.push_back(clumps.at(neighbours->at(i)->at(j)));
+                    clumps.at(i)->neighbours.push_back(clumps.at(*iterNeigh));
                 }
             }
             
@@ -62,7 +62,6 @@ namespace rsgis{namespace vec{
             }
             
             RSGISVectorUtils vecUtils;
-            OGRPolygon *polygon = NULL;
             OGRGeometry *geometry = NULL;
             OGREnvelope *env = NULL;
             OGRFeature *inFeature = NULL;
@@ -80,8 +79,11 @@ namespace rsgis{namespace vec{
 				geometry = inFeature->GetGeometryRef();
 				if( geometry != NULL && wkbFlatten(geometry->getGeometryType()) == wkbPolygon )
 				{
-					polygon = (OGRPolygon *) geometry;
-					env = vecUtils.getEnvelope(polygon);
+					env = vecUtils.getEnvelope(geometry);
+				}
+				else if( geometry != NULL && wkbFlatten(geometry->getGeometryType()) == wkbMultiPolygon && rsgis::img::RSGISPolygonScanline::isMethodSupported(pixelPolyOption) )
+				{
+					env = vecUtils.getEnvelope(geometry);
 				}
 				else 
 				{
@@ -93,7 +95,7 @@ namespace rsgis{namespace vec{
 				{
                     std::cout << "Env: [" << env->MinX << ", " << env->MaxX << "][" << env->MinY << ", " << env->MaxY << "]\n";
                     
-					extractMeanValues->processFeature(inFeature, polygon, env, fid);
+					extractMeanValues->processFeature(inFeature, geometry, env, fid);
                     
                     for(unsigned int j = 0; j < numImageBands; ++j)
                     {
@@ -139,7 +141,7 @@ namespace rsgis{namespace vec{
         this->pixelPolyOption = pixelPolyOption;
     }
     
-    void RSGISExtractSumPixelValues::processFeature(OGRFeature *feature, OGRPolygon *poly, OGREnvelope *env, long fid)
+    void RSGISExtractSumPixelValues::processFeature(OGRFeature *feature, OGRGeometry *poly, OGREnvelope *env, long fid)
     {
         try
         {
@@ -40,6 +40,7 @@
 #include "img/RSGISCalcImage.h"
 #include "img/RSGISCalcImageValue.h"
 #include "img/RSGISPixelInPoly.h"
+#include "img/RSGISPolygonScanline.h"
 
 // mark all exported classes/functions with DllExport to have
 // them exported by Visual Studio
@@ -82,7 +83,7 @@ namespace rsgis{namespace vec{
     {
     public:
         RSGISExtractSumPixelValues(unsigned int numImageBands, RSGISCalcSumValues *valueCalc, GDALDataset **datasets, int numDS, rsgis::img::pixelInPolyOption pixelPolyOption);
-        void processFeature(OGRFeature *feature, OGRPolygon *poly, OGREnvelope *env, long fid);
+        void processFeature(OGRFeature *feature, OGRGeometry *poly, OGREnvelope *env, long fid);
         ~RSGISExtractSumPixelValues();
     protected:
         unsigned int numImageBands;